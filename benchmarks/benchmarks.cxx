@@ -0,0 +1,321 @@
+/************************************************************************/
+/*                                                                      */
+/*               Copyright 2012 by Ullrich Koethe                       */
+/*                                                                      */
+/*    This file is part of the VIGRA computer vision library.           */
+/*    The VIGRA Website is                                              */
+/*        http://hci.iwr.uni-heidelberg.de/vigra/                       */
+/*    Please direct questions, bug reports, and contributions to        */
+/*        ullrich.koethe@iwr.uni-heidelberg.de    or                    */
+/*        vigra@informatik.uni-hamburg.de                               */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+/* Benchmark suite for the library's hot paths.
+
+   Every benchmark is run once for warm-up (untimed) and then
+   'repetitions' times (default 5, override with the first command line
+   argument). Human-readable results go to stderr, a machine-readable
+   CSV table goes to stdout, so that
+
+       vigra_benchmarks > results.csv
+
+   leaves a file suitable for regression tracking between releases.
+   Throughput is reported in million items per second, where an item is
+   a pixel for the image benchmarks and a sample for the random forest
+   benchmark. All input data is generated deterministically from a
+   fixed random seed, so results are comparable across runs and
+   machines.
+*/
+
+// we need to undefine NDEBUG so that we have TIC, TOC available
+#undef NDEBUG
+
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <cstdlib>
+
+#include <vigra/timing.hxx>
+#include <vigra/basicimage.hxx>
+#include <vigra/multi_array.hxx>
+#include <vigra/convolution.hxx>
+#include <vigra/resizeimage.hxx>
+#include <vigra/labelimage.hxx>
+#include <vigra/watersheds.hxx>
+#include <vigra/distancetransform.hxx>
+#include <vigra/random_forest.hxx>
+#include <vigra/accumulator.hxx>
+#include <vigra/random.hxx>
+
+using namespace vigra;
+
+// checksum of all benchmark outputs -- keeps the optimizer from
+// removing the timed computations
+static double benchmarkSink = 0.0;
+
+template <class FUNCTOR>
+void benchmark(char const * name, double megaItems, FUNCTOR & f, int repetitions)
+{
+    USETICTOC
+
+    f();                                          // warm-up, untimed
+
+    std::vector<double> times((std::size_t)repetitions);
+    for(int r = 0; r < repetitions; ++r)
+    {
+        TIC
+        f();
+        times[(std::size_t)r] = TOCN;
+    }
+    std::sort(times.begin(), times.end());
+
+    double minimum = times.front(),
+           median  = times[times.size() / 2],
+           mean    = 0.0;
+    for(std::size_t k = 0; k < times.size(); ++k)
+        mean += times[k];
+    mean /= times.size();
+    double throughput = megaItems / (minimum / 1000.0);
+
+    std::cerr << name << ": " << minimum << " msec (best-of-" << repetitions
+              << ", median " << median << "), "
+              << throughput << " M items/sec" << std::endl;
+    std::cout << name << "," << megaItems << "," << repetitions << ","
+              << minimum << "," << median << "," << mean << ","
+              << throughput << "\n";
+}
+
+struct SeparableConvolutionBenchmark
+{
+    FImage const & src;
+    FImage & tmp, & dest;
+    Kernel1D<double> const & kernel;
+
+    SeparableConvolutionBenchmark(FImage const & s, FImage & t, FImage & d,
+                                  Kernel1D<double> const & k)
+    : src(s), tmp(t), dest(d), kernel(k)
+    {}
+
+    void operator()()
+    {
+        separableConvolveX(srcImageRange(src), destImage(tmp), kernel1d(kernel));
+        separableConvolveY(srcImageRange(tmp), destImage(dest), kernel1d(kernel));
+        benchmarkSink += dest(0, 0);
+    }
+};
+
+struct ResizeBenchmark
+{
+    FImage const & src;
+    FImage & dest;
+
+    ResizeBenchmark(FImage const & s, FImage & d)
+    : src(s), dest(d)
+    {}
+
+    void operator()()
+    {
+        resizeImageLinearInterpolation(srcImageRange(src), destImageRange(dest));
+        benchmarkSink += dest(0, 0);
+    }
+};
+
+struct LabelImageBenchmark
+{
+    BImage const & src;
+    IImage & labels;
+
+    LabelImageBenchmark(BImage const & s, IImage & l)
+    : src(s), labels(l)
+    {}
+
+    void operator()()
+    {
+        benchmarkSink += labelImage(srcImageRange(src), destImage(labels), true);
+    }
+};
+
+struct WatershedBenchmark
+{
+    FImage const & gradient;
+    IImage & labels;
+
+    WatershedBenchmark(FImage const & g, IImage & l)
+    : gradient(g), labels(l)
+    {}
+
+    void operator()()
+    {
+        benchmarkSink += watershedsUnionFind(srcImageRange(gradient), destImage(labels));
+    }
+};
+
+struct DistanceTransformBenchmark
+{
+    BImage const & src;
+    FImage & dest;
+
+    DistanceTransformBenchmark(BImage const & s, FImage & d)
+    : src(s), dest(d)
+    {}
+
+    void operator()()
+    {
+        distanceTransform(srcImageRange(src), destImage(dest), 0, 2);
+        benchmarkSink += dest(0, 0);
+    }
+};
+
+struct RandomForestPredictBenchmark
+{
+    RandomForest<int> const & rf;
+    MultiArrayView<2, double> features;
+    MultiArrayView<2, int> labels;
+
+    RandomForestPredictBenchmark(RandomForest<int> const & r,
+                                 MultiArrayView<2, double> f,
+                                 MultiArrayView<2, int> l)
+    : rf(r), features(f), labels(l)
+    {}
+
+    void operator()()
+    {
+        rf.predictLabels(features, labels);
+        benchmarkSink += labels(0, 0);
+    }
+};
+
+struct AccumulatorBenchmark
+{
+    typedef acc::AccumulatorChain<float,
+                acc::Select<acc::Mean, acc::Variance,
+                            acc::Minimum, acc::Maximum> > Accumulator;
+
+    MultiArrayView<2, float> data;
+
+    AccumulatorBenchmark(MultiArrayView<2, float> d)
+    : data(d)
+    {}
+
+    void operator()()
+    {
+        Accumulator a;
+        acc::extractFeatures(data.begin(), data.end(), a);
+        benchmarkSink += acc::get<acc::Mean>(a);
+    }
+};
+
+int main(int argc, char ** argv)
+{
+    int repetitions = 5;
+    if(argc > 1)
+        repetitions = std::max(1, atoi(argv[1]));
+
+    int const w = 2000, h = 2000;
+    double const megaPixels = w * h / 1e6;
+
+    // deterministic test data: uniform noise and a smoothed version
+    // of it, whose threshold yields blob-like regions
+    RandomMT19937 random(1);
+    FImage noise(w, h), smoothed(w, h), tmp(w, h);
+    for(int y = 0; y < h; ++y)
+        for(int x = 0; x < w; ++x)
+            noise(x, y) = (float)random.uniform53();
+    gaussianSmoothing(srcImageRange(noise), destImage(smoothed), 4.0);
+
+    BImage binary(w, h);
+    for(int y = 0; y < h; ++y)
+        for(int x = 0; x < w; ++x)
+            binary(x, y) = smoothed(x, y) > 0.5f ? 1 : 0;
+
+    std::cout << "benchmark,mega_items,repetitions,min_msec,median_msec,mean_msec,"
+                 "mitems_per_second\n";
+
+    {
+        Kernel1D<double> gauss;
+        gauss.initGaussian(2.0);
+        FImage dest(w, h);
+        SeparableConvolutionBenchmark f(noise, tmp, dest, gauss);
+        benchmark("separable_convolution_gauss2", megaPixels, f, repetitions);
+    }
+    {
+        int const wd = 2999, hd = 2999;         // upscale by a non-integer factor
+        FImage dest(wd, hd);
+        ResizeBenchmark f(smoothed, dest);
+        benchmark("resize_linear", wd * hd / 1e6, f, repetitions);
+    }
+    {
+        IImage labels(w, h);
+        LabelImageBenchmark f(binary, labels);
+        benchmark("label_image_8", megaPixels, f, repetitions);
+    }
+    {
+        FImage gradient(w, h);
+        gaussianGradientMagnitude(srcImageRange(noise), destImage(gradient), 2.0);
+        IImage labels(w, h);
+        WatershedBenchmark f(gradient, labels);
+        benchmark("watershed_union_find", megaPixels, f, repetitions);
+    }
+    {
+        FImage dest(w, h);
+        DistanceTransformBenchmark f(binary, dest);
+        benchmark("distance_transform_l2", megaPixels, f, repetitions);
+    }
+    {
+        typedef MultiArrayShape<2>::type Shp;
+        int const trainSamples = 2000, predictSamples = 20000, featureCount = 16;
+
+        MultiArray<2, double> trainFeatures(Shp(trainSamples, featureCount)),
+                              predictFeatures(Shp(predictSamples, featureCount));
+        MultiArray<2, int> trainLabels(Shp(trainSamples, 1)),
+                           predictLabels(Shp(predictSamples, 1));
+        for(int ii = 0; ii < trainSamples; ++ii)
+        {
+            trainLabels(ii, 0) = random.uniform53() > 0.5;
+            for(int jj = 0; jj < featureCount; ++jj)
+                trainFeatures(ii, jj) = random.uniform53() + trainLabels(ii, 0);
+        }
+        for(int ii = 0; ii < predictSamples; ++ii)
+            for(int jj = 0; jj < featureCount; ++jj)
+                predictFeatures(ii, jj) = random.uniform53();
+
+        RandomForest<int> rf(RandomForestOptions().tree_count(32));
+        rf.learn(trainFeatures, trainLabels, rf_default(), rf_default(),
+                 rf_default(), random);
+
+        RandomForestPredictBenchmark f(rf, predictFeatures, predictLabels);
+        benchmark("random_forest_predict", predictSamples / 1e6, f, repetitions);
+    }
+    {
+        MultiArrayView<2, float> data(MultiArrayShape<2>::type(w, h), &noise(0, 0));
+        AccumulatorBenchmark f(data);
+        benchmark("accumulator_extraction", megaPixels, f, repetitions);
+    }
+
+    // report the checksum so the compiler cannot discard the results
+    std::cerr << "(checksum: " << benchmarkSink << ")" << std::endl;
+    return 0;
+}
@@ -24,7 +24,7 @@ if(HDF5_INCLUDE_DIR)
     set(HDF5_SUFFICIENT_VERSION FALSE)
     TRY_COMPILE(HDF5_SUFFICIENT_VERSION 
                 ${CMAKE_BINARY_DIR} ${PROJECT_SOURCE_DIR}/config/checkHDF5version.c
-                COMPILE_DEFINITIONS "-DMIN_MAJOR=${HDF5_VERSION_MAJOR} -DMIN_MINOR=${HDF5_VERSION_MINOR}"
+                COMPILE_DEFINITIONS "-DMIN_MAJOR=${HDF5_VERSION_MAJOR};-DMIN_MINOR=${HDF5_VERSION_MINOR}"
                 CMAKE_FLAGS "${HDF5_TRY_COMPILE_INCLUDE_DIR}") 
             
     if(HDF5_SUFFICIENT_VERSION)
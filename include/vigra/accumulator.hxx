@@ -48,12 +48,14 @@
 #include "mathutil.hxx"
 #include "utilities.hxx"
 #include "multi_iterator_coupled.hxx"
+#include "parallel_options.hxx"
 #include "matrix.hxx"
 #include "multi_math.hxx"
 #include "eigensystem.hxx"
 #include "histogram.hxx"
 #include <algorithm>
 #include <iostream>
+#include <cstring>
 
 namespace vigra {
   
@@ -465,6 +467,10 @@ template <class TAG, class A>
 typename LookupTag<TAG, A>::reference
 getAccumulator(A & a);
 
+template <class TAG, class A>
+typename LookupTag<TAG, A>::result_type
+get(A const & a);
+
 template <class TAG, class A>
 typename LookupDependency<TAG, A>::result_type
 getDependency(A const & a);
@@ -1858,7 +1864,83 @@ class AccumulatorChainImpl
                      "AccumulatorChain::updatePassN(): 0 < N < 6 required.");
         }
     }
-  
+
+    /** Update all accumulators working in pass N with a contiguous block of data.
+        The first sample performs the usual pass transition (and, in pass 1, the
+        automatic resize), the remaining samples are consumed in a tight loop
+        without per-sample bookkeeping, so the compiler can unroll and vectorize
+        it. Requirement: 0 < N < 6 and N >= current_pass_ .
+    */
+    void updatePassNBlock(T const * data, std::size_t size, unsigned int N)
+    {
+        if(size == 0)
+            return;
+        updatePassN(*data, N);
+        switch (N)
+        {
+            case 1:
+                for(std::size_t k=1; k<size; ++k)
+                    next_.template pass<1>(data[k]);
+                break;
+            case 2:
+                for(std::size_t k=1; k<size; ++k)
+                    next_.template pass<2>(data[k]);
+                break;
+            case 3:
+                for(std::size_t k=1; k<size; ++k)
+                    next_.template pass<3>(data[k]);
+                break;
+            case 4:
+                for(std::size_t k=1; k<size; ++k)
+                    next_.template pass<4>(data[k]);
+                break;
+            case 5:
+                for(std::size_t k=1; k<size; ++k)
+                    next_.template pass<5>(data[k]);
+                break;
+            default:
+                vigra_precondition(false,
+                     "AccumulatorChain::updatePassNBlock(): 0 < N < 6 required.");
+        }
+    }
+
+    /** Number of bytes of a raw state snapshot (see serialize()).
+    */
+    static std::size_t serializedSize()
+    {
+        return sizeof(unsigned int) + sizeof(InternalBaseType);
+    }
+
+    /** Write a raw snapshot of the accumulator state (all statistics plus the
+        current pass) into the given buffer, which must hold at least
+        serializedSize() bytes. Together with deserialize() this allows
+        long-running jobs to checkpoint intermediate statistics to disk and
+        resume later.
+
+        The snapshot is a plain memory image: it is only valid for chains
+        whose accumulators keep their state in plain data members (true for
+        the standard arithmetic statistics over scalars and TinyVectors, but
+        not for accumulators that allocate dynamic memory, such as histograms
+        with run-time bin count or statistics over run-time sized vectors),
+        and it can only be restored by the same build of the program.
+    */
+    void serialize(char * buffer) const
+    {
+        std::memcpy(buffer, &current_pass_, sizeof(unsigned int));
+        std::memcpy(buffer + sizeof(unsigned int), &next_, sizeof(InternalBaseType));
+    }
+
+    /** Restore the accumulator state from a buffer written by serialize().
+        The chain must have been created with the same statistics selection
+        (and, for dynamic chains, the same activation state) as the one that
+        wrote the snapshot.
+    */
+    void deserialize(char const * buffer)
+    {
+        std::memcpy(&current_pass_, buffer, sizeof(unsigned int));
+        std::memcpy(&next_, buffer + sizeof(unsigned int), sizeof(InternalBaseType));
+    }
+
     /** Return the number of passes required to compute all statistics in the accumulator chain.
     */
     unsigned int passesRequired() const
@@ -2078,6 +2160,273 @@ class DynamicAccumulatorChain
     }
 };
 
+namespace detail {
+
+    // placeholder type for the unused candidate slots of an AccumulatorChainSet;
+    // its member functions are needed so that the dispatch switches compile,
+    // but they are never called
+struct InvalidChainSetEntry
+{
+    void reset() {}
+
+    unsigned int passesRequired() const { return 0; }
+
+    template <class U> void operator()(U const &) {}
+    template <class U> void operator()(U const &, double) {}
+    template <class U> void updatePassN(U const &, unsigned int) {}
+    template <class U> void updatePassN(U const &, double, unsigned int) {}
+};
+
+template <class T, class Selected>
+struct ChainSetEntry
+{
+    typedef AccumulatorChain<T, Selected> type;
+    static const unsigned int size = 1;
+};
+
+template <class T>
+struct ChainSetEntry<T, void>
+{
+    typedef InvalidChainSetEntry type;
+    static const unsigned int size = 0;
+};
+
+} // namespace detail
+
+/** \brief Run-time selection among precompiled static accumulator chains.
+
+    \ref acc::DynamicAccumulatorChain tests for every sample whether each
+    statistic is active, which slows down the update loop considerably
+    relative to the static \ref acc::AccumulatorChain. When the statistics
+    combinations that can occur at run-time are known beforehand (e.g. the
+    feature sets offered by a user interface), this class eliminates the
+    per-statistic tests: every candidate combination is precompiled as a
+    static chain, select() picks one at run-time, and each update performs
+    just a single dispatch on the selected index before running the static
+    chain at full speed.
+
+    The template parameters are as follows:
+    - T: The input type (as in \ref acc::AccumulatorChain)
+    - S1...S5: up to five candidate statistics selections, each wrapped with Select
+
+    select() must be called before the first sample. The member get<TAG>()
+    requires TAG to be present in <em>every</em> candidate selection (after
+    expansion of dependencies); statistics that exist in only some candidates
+    must be accessed via applyToSelected() with a functor whose
+    <tt>operator()</tt> receives the selected static chain. Since the functor
+    is instantiated for every candidate chain, it needs either a generic
+    templated <tt>operator()</tt> that compiles for all of them, or overloads
+    for the individual chain types (Chain1...Chain5).
+
+    Usage:
+    \code
+    typedef double DataType;
+    AccumulatorChainSet<DataType,
+                        Select<Mean, Variance>,
+                        Select<Mean, Variance, Skewness, Kurtosis>,
+                        Select<Mean, Variance, Minimum, Maximum> > a;
+
+    a.select(1);   // run-time choice: Mean, Variance, Skewness, Kurtosis
+    for(...)
+        a(*data);  // one dispatch per sample, then static-chain speed
+    double m = a.get<Mean>();
+    \endcode
+
+    See \ref FeatureAccumulators for more information.
+ */
+template <class T, class S1,
+          class S2 = void, class S3 = void, class S4 = void, class S5 = void>
+class AccumulatorChainSet
+{
+  public:
+    typedef typename detail::ChainSetEntry<T, S1>::type Chain1;
+    typedef typename detail::ChainSetEntry<T, S2>::type Chain2;
+    typedef typename detail::ChainSetEntry<T, S3>::type Chain3;
+    typedef typename detail::ChainSetEntry<T, S4>::type Chain4;
+    typedef typename detail::ChainSetEntry<T, S5>::type Chain5;
+
+    static const unsigned int staticSize = detail::ChainSetEntry<T, S1>::size +
+                                           detail::ChainSetEntry<T, S2>::size +
+                                           detail::ChainSetEntry<T, S3>::size +
+                                           detail::ChainSetEntry<T, S4>::size +
+                                           detail::ChainSetEntry<T, S5>::size;
+
+    AccumulatorChainSet()
+    : selected_(0)
+    {}
+
+    /** Number of precompiled chains in the set.
+    */
+    static unsigned int size()
+    {
+        return staticSize;
+    }
+
+    /** Select the candidate chain with the given index (0...size()-1).
+        Must be called before the first sample (or after reset()).
+    */
+    void select(unsigned int index)
+    {
+        vigra_precondition(index < staticSize,
+            "AccumulatorChainSet::select(): index out of range.");
+        selected_ = index;
+    }
+
+    /** Index of the currently selected chain.
+    */
+    unsigned int selected() const
+    {
+        return selected_;
+    }
+
+    /** Reset the selected chain (e.g. to process new data).
+    */
+    void reset()
+    {
+        switch(selected_)
+        {
+          case 0: chain1_.reset(); break;
+          case 1: chain2_.reset(); break;
+          case 2: chain3_.reset(); break;
+          case 3: chain4_.reset(); break;
+          default: chain5_.reset(); break;
+        }
+    }
+
+    /** Pass data to the selected chain.
+    */
+    void operator()(T const & t)
+    {
+        switch(selected_)
+        {
+          case 0: chain1_(t); break;
+          case 1: chain2_(t); break;
+          case 2: chain3_(t); break;
+          case 3: chain4_(t); break;
+          default: chain5_(t); break;
+        }
+    }
+
+    /** Pass data and weight to the selected chain.
+    */
+    void operator()(T const & t, double weight)
+    {
+        switch(selected_)
+        {
+          case 0: chain1_(t, weight); break;
+          case 1: chain2_(t, weight); break;
+          case 2: chain3_(t, weight); break;
+          case 3: chain4_(t, weight); break;
+          default: chain5_(t, weight); break;
+        }
+    }
+
+    /** Update all accumulators of the selected chain that work in pass N.
+    */
+    void updatePassN(T const & t, unsigned int N)
+    {
+        switch(selected_)
+        {
+          case 0: chain1_.updatePassN(t, N); break;
+          case 1: chain2_.updatePassN(t, N); break;
+          case 2: chain3_.updatePassN(t, N); break;
+          case 3: chain4_.updatePassN(t, N); break;
+          default: chain5_.updatePassN(t, N); break;
+        }
+    }
+
+    /** Update all accumulators of the selected chain that work in pass N (with weight).
+    */
+    void updatePassN(T const & t, double weight, unsigned int N)
+    {
+        switch(selected_)
+        {
+          case 0: chain1_.updatePassN(t, weight, N); break;
+          case 1: chain2_.updatePassN(t, weight, N); break;
+          case 2: chain3_.updatePassN(t, weight, N); break;
+          case 3: chain4_.updatePassN(t, weight, N); break;
+          default: chain5_.updatePassN(t, weight, N); break;
+        }
+    }
+
+    /** Number of passes required to compute the statistics of the selected chain.
+    */
+    unsigned int passesRequired() const
+    {
+        switch(selected_)
+        {
+          case 0: return chain1_.passesRequired();
+          case 1: return chain2_.passesRequired();
+          case 2: return chain3_.passesRequired();
+          case 3: return chain4_.passesRequired();
+          default: return chain5_.passesRequired();
+        }
+    }
+
+    /** Get the result of the statistic 'TAG' from the selected chain.
+        TAG must be contained in every candidate selection.
+    */
+    template <class TAG>
+    typename LookupTag<TAG, Chain1>::value_type get() const
+    {
+        switch(selected_)
+        {
+          case 0: return getImpl<TAG>(chain1_);
+          case 1: return getImpl<TAG>(chain2_);
+          case 2: return getImpl<TAG>(chain3_);
+          case 3: return getImpl<TAG>(chain4_);
+          default: return getImpl<TAG>(chain5_);
+        }
+    }
+
+    /** Apply a functor (with templated <tt>operator()</tt>) to the selected chain.
+    */
+    template <class FUNCTOR>
+    void applyToSelected(FUNCTOR & f) const
+    {
+        switch(selected_)
+        {
+          case 0: applyImpl(f, chain1_); break;
+          case 1: applyImpl(f, chain2_); break;
+          case 2: applyImpl(f, chain3_); break;
+          case 3: applyImpl(f, chain4_); break;
+          default: applyImpl(f, chain5_); break;
+        }
+    }
+
+  private:
+    template <class TAG, class Chain>
+    static typename LookupTag<TAG, Chain1>::value_type getImpl(Chain const & c)
+    {
+        return vigra::acc::get<TAG>(c);
+    }
+
+        // overload for the unused candidate slots (never called)
+    template <class TAG>
+    static typename LookupTag<TAG, Chain1>::value_type getImpl(detail::InvalidChainSetEntry const &)
+    {
+        return typename LookupTag<TAG, Chain1>::value_type();
+    }
+
+    template <class FUNCTOR, class Chain>
+    static void applyImpl(FUNCTOR & f, Chain const & c)
+    {
+        f(c);
+    }
+
+        // overload for the unused candidate slots (never called)
+    template <class FUNCTOR>
+    static void applyImpl(FUNCTOR &, detail::InvalidChainSetEntry const &)
+    {}
+
+    unsigned int selected_;
+    Chain1 chain1_;
+    Chain2 chain2_;
+    Chain3 chain3_;
+    Chain4 chain4_;
+    Chain5 chain5_;
+};
+
 /** \brief Create an array of accumulator chains containing the selected per-region and global statistics and their dependencies.
 
     AccumulatorChainArray is used to compute per-region statistics (as well as global statistics). The statistics are selected at compile-time. An array of accumulator chains (one per region) for region statistics is created and one accumulator chain for global statistics. The region labels always start at 0. Use the Global modifier to compute global statistics (by default per-region statistics are computed). 
@@ -2138,12 +2487,18 @@ class AccumulatorChainArray
         return this->next_.regions_.size();
     }
     
-    /** Merge region i with region j. 
+    /** Merge region j into region i and reset region j. The statistics of
+        the combined region are obtained incrementally in O(number of
+        statistics), independent of the region sizes, so repeated merges
+        (e.g. during agglomerative clustering of superpixels) never require
+        a rescan of the data. Merging a region with itself is a no-op.
     */
     void merge(unsigned i, unsigned j)
     {
         vigra_precondition(i <= maxRegionLabel() && j <= maxRegionLabel(),
             "AccumulatorChainArray::merge(): region labels out of range.");
+        if(i == j)
+            return;
         this->next_.merge(i, j);
     }
     
@@ -2722,6 +3077,229 @@ void extractFeatures(ITERATOR start, ITERATOR end, ACCUMULATOR & a)
             a.updatePassN(*i, k);
 }
 
+/** Overload of \ref extractFeatures() for coupled iterators.
+
+    When all coupled arrays are unstrided (consecutive scan-order positions
+    are consecutive in memory) and the range covers the entire array, each
+    pass runs as a fused 1-D loop: a step costs one unit-stride pointer bump
+    per array (CoupledScanOrderIterator::incrementContiguous()) instead of
+    the per-dimension coordinate bookkeeping of <tt>operator++()</tt>.
+    Coordinates and the scan-order index remain exact, so statistics over
+    coordinates (Coord<...>) get the same values as in the generic loop.
+    Subranges and strided or transposed arrays fall back to the generic loop.
+*/
+template <unsigned int N, class HANDLES, int DIMENSION, class ACCUMULATOR>
+void extractFeatures(CoupledScanOrderIterator<N, HANDLES, DIMENSION> start,
+                     CoupledScanOrderIterator<N, HANDLES, DIMENSION> end,
+                     ACCUMULATOR & a)
+{
+    typedef CoupledScanOrderIterator<N, HANDLES, DIMENSION> Iterator;
+    MultiArrayIndex size = end - start;
+    if(start.scanOrderIndex() == 0 && size == prod(start.shape()) &&
+       start.isUnstrided())
+    {
+        for(unsigned int k=1; k <= a.passesRequired(); ++k)
+        {
+            Iterator i = start;
+            for(MultiArrayIndex j = 0; j < size; ++j, i.incrementContiguous())
+                a.updatePassN(*i, k);
+        }
+    }
+    else
+    {
+        for(unsigned int k=1; k <= a.passesRequired(); ++k)
+            for(Iterator i=start; i < end; ++i)
+                a.updatePassN(*i, k);
+    }
+}
+
+/** Overload of \ref extractFeatures() for contiguous data.
+
+    When the samples reside in a plain array, each pass is forwarded to
+    AccumulatorChain::updatePassNBlock(), which consumes the data in a tight
+    loop without per-sample pass bookkeeping. For basic arithmetic statistics
+    (Count, Sum, Mean, Minimum, Maximum etc.) this loop is simple enough for
+    the compiler to vectorize, so global statistics over large arrays run
+    considerably faster than via the generic iterator loop.
+*/
+template <class T, class ACCUMULATOR>
+void extractFeatures(T const * start, T const * end, ACCUMULATOR & a)
+{
+    for(unsigned int k=1; k <= a.passesRequired(); ++k)
+        a.updatePassNBlock(start, (std::size_t)(end - start), k);
+}
+
+/** Position of a chunked feature extraction (see \ref extractFeaturesChunk()).
+    The default constructor denotes the start of the computation. The struct
+    holds plain integers, so it can trivially be stored alongside a state
+    snapshot created by AccumulatorChain::serialize() when checkpointing a
+    long-running job.
+*/
+struct ChunkedExtractionProgress
+{
+    unsigned int pass, chunk;
+
+    ChunkedExtractionProgress()
+    : pass(1), chunk(0)
+    {}
+};
+
+/** Feed a single chunk of an out-of-core data set into the accumulator
+    chain 'a' and advance 'progress'. Returns true as long as more chunks
+    (or more passes over all chunks) remain to be processed.
+
+    The chunk provider must define a member typedef 'chunk_type' (an
+    iterable type, e.g. a MultiArray or MultiArrayView) and member functions
+    'chunkCount()' and 'chunk(i)', where the latter returns the i-th chunk
+    and may re-read it from external storage (e.g. via HDF5File::readBlock())
+    on every call -- multi-pass statistics visit each chunk once per pass.
+
+    Processing one chunk at a time allows the caller to checkpoint between
+    chunks:
+
+    \code
+    SomeChunkProvider chunks("huge_volume.h5");
+    AccumulatorChain<double, Select<Mean, Variance> > a;
+
+    ChunkedExtractionProgress progress;
+    ArrayVector<char> snapshot(a.serializedSize());
+    while(extractFeaturesChunk(chunks, a, progress))
+    {
+        a.serialize(snapshot.begin());
+        // ... write snapshot and progress to disk ...
+    }
+    \endcode
+
+    To resume after a crash, restore the chain via
+    AccumulatorChain::deserialize(), restore 'progress', and re-enter the
+    loop.
+*/
+template <class CHUNK_PROVIDER, class ACCUMULATOR>
+bool extractFeaturesChunk(CHUNK_PROVIDER & chunks, ACCUMULATOR & a,
+                          ChunkedExtractionProgress & progress)
+{
+    unsigned int passes = a.passesRequired(),
+                 chunk_count = chunks.chunkCount();
+    if(progress.pass > passes || chunk_count == 0)
+        return false;
+    typename CHUNK_PROVIDER::chunk_type const & chunk(chunks.chunk(progress.chunk));
+    typename CHUNK_PROVIDER::chunk_type::const_iterator i = chunk.begin(),
+                                                        end = chunk.end();
+    for(; i != end; ++i)
+        a.updatePassN(*i, progress.pass);
+    if(++progress.chunk == chunk_count)
+    {
+        progress.chunk = 0;
+        ++progress.pass;
+    }
+    return progress.pass <= passes;
+}
+
+/** Collect the statistics of the accumulator chain 'a' from a chunked
+    out-of-core data set in as many passes as necessary. Equivalent to
+    calling \ref extractFeaturesChunk() until it returns false, but without
+    the opportunity to checkpoint in between.
+*/
+template <class CHUNK_PROVIDER, class ACCUMULATOR>
+void extractFeaturesChunked(CHUNK_PROVIDER & chunks, ACCUMULATOR & a)
+{
+    ChunkedExtractionProgress progress;
+    while(extractFeaturesChunk(chunks, a, progress))
+    {}
+}
+
+/** Multi-threaded variant of \ref extractFeatures() for an
+    \ref acc::AccumulatorChainArray.
+
+    The data range is divided into one contiguous partition per thread;
+    every thread collects the statistics of its partition in a private
+    copy of the accumulator chain array (so options such as
+    ignoreLabel() or histogram ranges set on 'a' apply to all threads),
+    and the partial chains are merged into 'a' afterwards. All selected
+    statistics must therefore support merging via the "+=" operator -
+    the same requirement as for merging chains by hand. The merged
+    result is mathematically equivalent to the single-threaded one, but
+    floating-point rounding may differ slightly because the samples are
+    accumulated in a different order.
+
+    Example of use:
+    \code
+    vigra::MultiArray<3, double> data(...);
+    vigra::MultiArray<3, int> labels(...);
+    typedef vigra::CoupledIteratorType<3, double, int>::type Iterator;
+    typedef Iterator::value_type Handle;
+
+    AccumulatorChainArray<Handle,
+        Select<DataArg<1>, LabelArg<2>, Mean, Variance> > a;
+
+    Iterator start = createCoupledIterator(data, labels);
+    Iterator end = start.getEndIterator();
+
+    extractFeatures(start, end, a, ParallelOptions().numThreads(4));
+    \endcode
+    See \ref FeatureAccumulators for more information about feature computation via accumulators.
+*/
+template <class ITERATOR, class T, class Selected, bool dynamic>
+void extractFeatures(ITERATOR start, ITERATOR end,
+                     AccumulatorChainArray<T, Selected, dynamic> & a,
+                     ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    MultiArrayIndex size = end - start;
+    int num_threads = options.getNumThreads();
+    if(num_threads > (int)size)
+        num_threads = (int)size;
+    if(num_threads > 1)
+    {
+        typedef AccumulatorChainArray<T, Selected, dynamic> Chain;
+
+        vigra_precondition(a.maxRegionLabel() == -1,
+            "extractFeatures(): accumulator chain array must not contain "
+            "data when the parallel variant is used.");
+
+        // Determine the number of regions before partitioning: the chain
+        // array scans the entire label array from the handle accompanying
+        // its first sample, so only the first handle of the full range may
+        // ever trigger that scan. A scratch copy performs it once, and the
+        // per-thread chains are pre-sized with the result so that no
+        // mid-range handle reaches the scan.
+        {
+            Chain scratch(a);
+            scratch.updatePassN(*start, 1);
+            a.setMaxRegionLabel((unsigned)scratch.maxRegionLabel());
+        }
+
+        ArrayVector<Chain> chains((unsigned int)num_threads, a);
+        std::string errorMessage;
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(int t = 0; t < num_threads; ++t)
+        {
+            try
+            {
+                ITERATOR s = start + (size * t) / num_threads,
+                         e = start + (size * (t + 1)) / num_threads;
+                extractFeatures(s, e, chains[t]);
+            }
+            catch(std::exception & exc)
+            {
+#pragma omp critical(vigra_extract_features_error)
+                if(errorMessage.empty())
+                    errorMessage = exc.what();
+            }
+        }
+        if(!errorMessage.empty())
+            vigra_fail("extractFeatures(): worker thread failed with:\n"
+                       + errorMessage);
+
+        // all chains were pre-sized to the same maxRegionLabel()
+        for(int t = 0; t < num_threads; ++t)
+            a.merge(chains[t]);
+        return;
+    }
+#endif
+    extractFeatures(start, end, a);
+}
+
 /****************************************************************************/
 /*                                                                          */
 /*                          AccumulatorResultTraits                         */
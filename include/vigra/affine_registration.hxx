@@ -42,6 +42,8 @@
 #include "tinyvector.hxx"
 #include "splineimageview.hxx"
 #include "imagecontainer.hxx"
+#include "resampling_convolution.hxx"
+#include "parallel_options.hxx"
 #include <cmath>
 
 namespace vigra {
@@ -139,20 +141,23 @@ class AffineMotionEstimationOptions
     double burt_filter_strength;
     int highest_level, iterations_per_level;
     bool use_laplacian_pyramid;
-    
+    ParallelOptions parallel_options;
+
     AffineMotionEstimationOptions()
     : burt_filter_strength(0.4),
       highest_level(4),
       iterations_per_level(4),
-      use_laplacian_pyramid(false)
+      use_laplacian_pyramid(false),
+      parallel_options(ParallelOptions().numThreads(1))
     {}
-    
+
     template <int ORDER>
     AffineMotionEstimationOptions(AffineMotionEstimationOptions<ORDER>  const & other)
     : burt_filter_strength(other.burt_filter_strength),
       highest_level(other.highest_level),
       iterations_per_level(other.iterations_per_level),
-      use_laplacian_pyramid(other.use_laplacian_pyramid)
+      use_laplacian_pyramid(other.use_laplacian_pyramid),
+      parallel_options(other.parallel_options)
     {}
     
     template <int NEWORDER>
@@ -194,22 +199,36 @@ class AffineMotionEstimationOptions
         use_laplacian_pyramid = f;
         return *this;
     }
+
+        /** Distribute the per-pixel error and gradient accumulation of
+            every Gauss-Newton iteration over the given number of threads.
+            The default (one thread) reproduces the sequential algorithm
+            exactly.
+        */
+    AffineMotionEstimationOptions & parallelOptions(ParallelOptions const & opt)
+    {
+        parallel_options = opt;
+        return *this;
+    }
 };
 
 namespace detail {
 
 struct TranslationEstimationFunctor
 {
+    enum { Dimension = 2 };
+
     template <class SplineImage, class Image>
-    void operator()(SplineImage const & src, Image const & dest, Matrix<double> & matrix) const
+    void accumulate(SplineImage const & src, Image const & dest,
+                    Matrix<double> const & matrix, int y0, int y1,
+                    Matrix<double> & m, Matrix<double> & r) const
     {
         int w = dest.width();
-        int h = dest.height();
-        
-        Matrix<double> grad(2,1), m(2,2), r(2,1), s(2,1);
+
+        Matrix<double> grad(2,1);
         double dx = matrix(0,0), dy = matrix(1,0);
-        
-        for(int y = 0; y < h; ++y)
+
+        for(int y = y0; y < y1; ++y)
         {
             double sx = matrix(0,1)*y + matrix(0,2);
             double sy = matrix(1,1)*y + matrix(1,2);
@@ -217,37 +236,51 @@ struct TranslationEstimationFunctor
             {
                 if(!src.isInside(sx, sy))
                     continue;
-                  
+
                 grad(0,0) = src.dx(sx, sy);
                 grad(1,0) = src.dy(sx, sy);
                 double diff = dest(x, y) - src(sx, sy);
-                
+
                 m += outer(grad);
                 r -= diff*grad;
             }
         }
-        
-        linearSolve(m, r, s);
-        
+    }
+
+    void update(Matrix<double> const & s, Matrix<double> & matrix) const
+    {
         matrix(0,2) -= s(0,0);
         matrix(1,2) -= s(1,0);
     }
+
+    template <class SplineImage, class Image>
+    void operator()(SplineImage const & src, Image const & dest, Matrix<double> & matrix) const
+    {
+        Matrix<double> m(2,2), r(2,1), s(2,1);
+
+        accumulate(src, dest, matrix, 0, dest.height(), m, r);
+        linearSolve(m, r, s);
+        update(s, matrix);
+    }
 };
 
 struct SimilarityTransformEstimationFunctor
 {
+    enum { Dimension = 4 };
+
     template <class SplineImage, class Image>
-    void operator()(SplineImage const & src, Image const & dest, Matrix<double> & matrix) const
+    void accumulate(SplineImage const & src, Image const & dest,
+                    Matrix<double> const & matrix, int y0, int y1,
+                    Matrix<double> & m, Matrix<double> & r) const
     {
         int w = dest.width();
-        int h = dest.height();
-        
-        Matrix<double> grad(2,1), coord(4, 2), c(4, 1), m(4, 4), r(4,1), s(4,1);
+
+        Matrix<double> grad(2,1), coord(4, 2), c(4, 1);
         coord(0,0) = 1.0;
         coord(1,1) = 1.0;
         double dx = matrix(0,0), dy = matrix(1,0);
-        
-        for(int y = 0; y < h; ++y)
+
+        for(int y = y0; y < y1; ++y)
         {
             double sx = matrix(0,1)*y + matrix(0,2);
             double sy = matrix(1,1)*y + matrix(1,2);
@@ -255,7 +288,7 @@ struct SimilarityTransformEstimationFunctor
             {
                 if(!src.isInside(sx, sy))
                     continue;
-                  
+
                 grad(0,0) = src.dx(sx, sy);
                 grad(1,0) = src.dy(sx, sy);
                 coord(2,0) = (double)x;
@@ -263,15 +296,16 @@ struct SimilarityTransformEstimationFunctor
                 coord(3,0) = -(double)y;
                 coord(2,1) = (double)y;
                 double diff = dest(x, y) - src(sx, sy);
-                
+
                 c = coord * grad;
                 m += outer(c);
                 r -= diff*c;
             }
         }
-        
-        linearSolve(m, r, s);
-        
+    }
+
+    void update(Matrix<double> const & s, Matrix<double> & matrix) const
+    {
         matrix(0,2) -= s(0,0);
         matrix(1,2) -= s(1,0);
         matrix(0,0) -= s(2,0);
@@ -279,22 +313,35 @@ struct SimilarityTransformEstimationFunctor
         matrix(0,1) += s(3,0);
         matrix(1,0) -= s(3,0);
     }
+
+    template <class SplineImage, class Image>
+    void operator()(SplineImage const & src, Image const & dest, Matrix<double> & matrix) const
+    {
+        Matrix<double> m(4, 4), r(4,1), s(4,1);
+
+        accumulate(src, dest, matrix, 0, dest.height(), m, r);
+        linearSolve(m, r, s);
+        update(s, matrix);
+    }
 };
 
 struct AffineTransformEstimationFunctor
 {
+    enum { Dimension = 6 };
+
     template <class SplineImage, class Image>
-    void operator()(SplineImage const & src, Image const & dest, Matrix<double> & matrix) const
+    void accumulate(SplineImage const & src, Image const & dest,
+                    Matrix<double> const & matrix, int y0, int y1,
+                    Matrix<double> & m, Matrix<double> & r) const
     {
         int w = dest.width();
-        int h = dest.height();
-        
-        Matrix<double> grad(2,1), coord(6, 2), c(6, 1), m(6,6), r(6,1), s(6,1);
+
+        Matrix<double> grad(2,1), coord(6, 2), c(6, 1);
         coord(0,0) = 1.0;
         coord(1,1) = 1.0;
         double dx = matrix(0,0), dy = matrix(1,0);
-        
-        for(int y = 0; y < h; ++y)
+
+        for(int y = y0; y < y1; ++y)
         {
             double sx = matrix(0,1)*y + matrix(0,2);
             double sy = matrix(1,1)*y + matrix(1,2);
@@ -302,7 +349,7 @@ struct AffineTransformEstimationFunctor
             {
                 if(!src.isInside(sx, sy))
                     continue;
-                  
+
                 grad(0,0) = src.dx(sx, sy);
                 grad(1,0) = src.dy(sx, sy);
                 coord(2,0) = (double)x;
@@ -310,15 +357,16 @@ struct AffineTransformEstimationFunctor
                 coord(3,0) = (double)y;
                 coord(5,1) = (double)y;
                 double diff = dest(x, y) - src(sx, sy);
-                
+
                 c = coord * grad;
                 m += outer(c);
                 r -= diff*c;
             }
         }
-        
-        linearSolve(m, r, s);
-        
+    }
+
+    void update(Matrix<double> const & s, Matrix<double> & matrix) const
+    {
         matrix(0,2) -= s(0,0);
         matrix(1,2) -= s(1,0);
         matrix(0,0) -= s(2,0);
@@ -326,6 +374,16 @@ struct AffineTransformEstimationFunctor
         matrix(1,0) -= s(4,0);
         matrix(1,1) -= s(5,0);
     }
+
+    template <class SplineImage, class Image>
+    void operator()(SplineImage const & src, Image const & dest, Matrix<double> & matrix) const
+    {
+        Matrix<double> m(6,6), r(6,1), s(6,1);
+
+        accumulate(src, dest, matrix, 0, dest.height(), m, r);
+        linearSolve(m, r, s);
+        update(s, matrix);
+    }
 };
 
 template <class SrcIterator, class SrcAccessor, 
@@ -366,20 +424,87 @@ estimateAffineMotionImpl(SrcIterator sul, SrcIterator slr, SrcAccessor src,
     
     for(int level = toplevel; level >= 0; --level)
     {
-        SplineImageView<SPLINEORDER, STmpType> sp(srcImageRange(srcPyramid[level]));
-        
-        for(int iter = 0; iter < options.iterations_per_level; ++iter)
+        typedef SplineImageView<SPLINEORDER, STmpType> SplineImage;
+        SplineImage sp(srcImageRange(srcPyramid[level]));
+
+#ifdef _OPENMP
+        int num_threads = options.parallel_options.getNumThreads();
+        if(num_threads > destPyramid[level].height())
+            num_threads = destPyramid[level].height();
+        if(num_threads > 1)
         {
-            motionModel(sp, destPyramid[level], currentMatrix);
+            // every thread gets its own view onto the already prefiltered
+            // spline coefficients, because SplineImageView caches the
+            // current facet in mutable members
+            ArrayVector<SplineImage> views;
+            views.reserve(num_threads);
+            for(int t = 0; t < num_threads; ++t)
+                views.push_back(SplineImage(srcImageRange(sp.image()), true));
+
+            int h = destPyramid[level].height();
+            ArrayVector<int> bounds(num_threads+1);
+            for(int t = 0; t <= num_threads; ++t)
+                bounds[t] = (int)(((long long)h * t) / num_threads);
+
+            int dim = Functor::Dimension;
+
+            for(int iter = 0; iter < options.iterations_per_level; ++iter)
+            {
+                ArrayVector<Matrix<double> > ms(num_threads, Matrix<double>(dim, dim)),
+                                             rs(num_threads, Matrix<double>(dim, 1));
+                std::string errorMessage;
+
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+                for(int t = 0; t < num_threads; ++t)
+                {
+                    try
+                    {
+                        motionModel.accumulate(views[t], destPyramid[level], currentMatrix,
+                                               bounds[t], bounds[t+1], ms[t], rs[t]);
+                    }
+                    catch(std::exception & e)
+                    {
+#pragma omp critical(vigra_affine_motion_error)
+                        errorMessage = e.what();
+                    }
+                    catch(...)
+                    {
+#pragma omp critical(vigra_affine_motion_error)
+                        errorMessage = "unknown error";
+                    }
+                }
+
+                if(errorMessage.size())
+                    vigra_fail("estimateAffineMotionImpl(): worker thread failed with:\n" + errorMessage);
+
+                // summation in band order keeps the result deterministic
+                // for a given thread count
+                Matrix<double> m(dim, dim), r(dim, 1), s(dim, 1);
+                for(int t = 0; t < num_threads; ++t)
+                {
+                    m += ms[t];
+                    r += rs[t];
+                }
+                linearSolve(m, r, s);
+                motionModel.update(s, currentMatrix);
+            }
         }
-        
+        else
+#endif // _OPENMP
+        {
+            for(int iter = 0; iter < options.iterations_per_level; ++iter)
+            {
+                motionModel(sp, destPyramid[level], currentMatrix);
+            }
+        }
+
         if(level > 0)
         {
             currentMatrix(0,2) *= 2.0;
             currentMatrix(1,2) *= 2.0;
         }
     }
-    
+
     affineMatrix = currentMatrix;
 }
 
@@ -399,18 +399,44 @@ void affineWarpImage(SplineImageView<ORDER, T> const & src,
         "affineWarpImage(): matrix doesn't represent an affine transformation with homogeneous 2D coordinates.");
          
     
-    double w = dlr.x - dul.x;
-    double h = dlr.y - dul.y;
-    
-    for(double y = 0.0; y < h; ++y, ++dul.y)
+    int w = dlr.x - dul.x;
+    int h = dlr.y - dul.y;
+
+    double a00 = affineMatrix(0,0), a01 = affineMatrix(0,1), a02 = affineMatrix(0,2);
+    double a10 = affineMatrix(1,0), a11 = affineMatrix(1,1), a12 = affineMatrix(1,2);
+
+    // Process the destination in square blocks: for rotation-like
+    // transforms, the source accesses of one block then stay within a
+    // compact region of the spline coefficient image instead of sweeping
+    // a long diagonal stripe through it per destination row.
+    int const blockSize = 64;
+
+    for(int by = 0; by < h; by += blockSize)
     {
-        typename DestIterator::row_iterator rd = dul.rowIterator();
-        for(double x=0.0; x < w; ++x, ++rd)
+        int bh = (by + blockSize < h) ? by + blockSize : h;
+        for(int bx = 0; bx < w; bx += blockSize)
         {
-            double sx = x*affineMatrix(0,0) + y*affineMatrix(0,1) + affineMatrix(0,2);
-            double sy = x*affineMatrix(1,0) + y*affineMatrix(1,1) + affineMatrix(1,2);
-            if(src.isInside(sx, sy))
-                dest.set(src(sx, sy), rd);
+            int bw = (bx + blockSize < w) ? bx + blockSize : w;
+
+            DestIterator bul(dul);
+            bul.x += bx;
+            bul.y += by;
+
+            for(int y = by; y < bh; ++y, ++bul.y)
+            {
+                typename DestIterator::row_iterator rd = bul.rowIterator();
+
+                // the transform is affine, so the source coordinate is
+                // stepped incrementally instead of re-evaluating the
+                // matrix product for every pixel
+                double sx = bx*a00 + y*a01 + a02;
+                double sy = bx*a10 + y*a11 + a12;
+                for(int x = bx; x < bw; ++x, ++rd, sx += a00, sy += a10)
+                {
+                    if(src.isInside(sx, sy))
+                        dest.set(src(sx, sy), rd);
+                }
+            }
         }
     }
 }
@@ -503,21 +503,19 @@ public:
     typedef Alloc        allocator_type;
 
 public:
+        // default construction allocates nothing -- the first allocation
+        // is deferred to the first insertion (see reserve())
     ArrayVector()
     : view_type(),
-      capacity_(minimumCapacity),
+      capacity_(0),
       alloc_(Alloc())
-    {
-        this->data_ = reserve_raw(capacity_);
-    }
+    {}
 
     explicit ArrayVector(Alloc const & alloc)
     : view_type(),
-      capacity_(minimumCapacity),
+      capacity_(0),
       alloc_(alloc)
-    {
-        this->data_ = reserve_raw(capacity_);
-    }
+    {}
 
     explicit ArrayVector( size_type size, Alloc const & alloc = Alloc())
     : view_type(),
@@ -897,6 +895,276 @@ ArrayVector<T, Alloc>::reserve_raw(size_type capacity)
     return data;
 }
 
+/** Sequence with small-buffer optimization.
+
+    <tt>SmallVector</tt> offers the most frequently used part of the
+    \ref vigra::ArrayVector interface, but stores up to
+    <tt>InlineCapacity</tt> elements directly inside the object instead
+    of on the heap. As long as the size never exceeds
+    <tt>InlineCapacity</tt>, the container performs no memory allocation
+    at all, which makes it the data structure of choice for the small
+    temporary buffers (reversed kernels, class histograms, per-node
+    index lists) that many algorithms create in their inner loops.
+    When the capacity is exceeded, the elements are moved to memory
+    obtained from <tt>Alloc</tt>, and the container behaves like an
+    ordinary vector with geometric growth.
+
+    Like <tt>ArrayVector</tt>, the memory is always contiguous and the
+    iterator is a <tt>T *</tt>, and <tt>SmallVector</tt> is derived from
+    \ref vigra::ArrayVectorView so that views and subarrays can be
+    created in the usual way. In contrast to <tt>ArrayVector</tt>,
+    <tt>swap()</tt> has to copy the elements when either container still
+    uses its inline buffer, so iterators are always invalidated by
+    <tt>swap()</tt>.
+
+    <b>\#include</b> \<vigra/array_vector.hxx\><br>
+    Namespace: vigra
+*/
+template <class T, unsigned int InlineCapacity, class Alloc = std::allocator<T> >
+class SmallVector
+: public ArrayVectorView<T>
+{
+    typedef SmallVector<T, InlineCapacity, Alloc> this_type;
+    enum { minimumCapacity = 2, resizeFactor = 2 };
+
+public:
+    typedef ArrayVectorView<T> view_type;
+    typedef typename view_type::value_type value_type;
+    typedef typename view_type::reference reference;
+    typedef typename view_type::const_reference const_reference;
+    typedef typename view_type::pointer pointer;
+    typedef typename view_type::const_pointer const_pointer;
+    typedef typename view_type::iterator iterator;
+    typedef typename view_type::const_iterator const_iterator;
+    typedef typename view_type::size_type size_type;
+    typedef typename view_type::difference_type difference_type;
+    typedef typename view_type::reverse_iterator reverse_iterator;
+    typedef typename view_type::const_reverse_iterator const_reverse_iterator;
+    typedef Alloc        allocator_type;
+
+public:
+    SmallVector()
+    : view_type(),
+      alloc_(Alloc())
+    {
+        this->data_ = inlineData();
+        capacity_ = InlineCapacity;
+    }
+
+    explicit SmallVector(Alloc const & alloc)
+    : view_type(),
+      alloc_(alloc)
+    {
+        this->data_ = inlineData();
+        capacity_ = InlineCapacity;
+    }
+
+    explicit SmallVector( size_type size, Alloc const & alloc = Alloc())
+    : view_type(),
+      alloc_(alloc)
+    {
+        initImpl(size, value_type());
+    }
+
+    SmallVector( size_type size, value_type const & initial, Alloc const & alloc = Alloc())
+    : view_type(),
+      alloc_(alloc)
+    {
+        initImpl(size, initial);
+    }
+
+    SmallVector( this_type const & rhs )
+    : view_type(),
+      alloc_(rhs.alloc_)
+    {
+        this->data_ = inlineData();
+        capacity_ = InlineCapacity;
+        assignImpl(rhs.begin(), rhs.end());
+    }
+
+    template <class U>
+    explicit SmallVector( ArrayVectorView<U> const & rhs, Alloc const & alloc = Alloc() )
+    : view_type(),
+      alloc_(alloc)
+    {
+        this->data_ = inlineData();
+        capacity_ = InlineCapacity;
+        assignImpl(rhs.begin(), rhs.end());
+    }
+
+    this_type & operator=( this_type const & rhs )
+    {
+        if(this != &rhs)
+            assignImpl(rhs.begin(), rhs.end());
+        return *this;
+    }
+
+    template <class U>
+    this_type & operator=( ArrayVectorView<U> const & rhs)
+    {
+        assignImpl(rhs.begin(), rhs.end());
+        return *this;
+    }
+
+    ~SmallVector()
+    {
+        detail::destroy_n(this->data_, (std::ptrdiff_t)this->size_);
+        if(!usesInlineBuffer())
+            alloc_.deallocate(this->data_, capacity_);
+    }
+
+        /** Whether the elements currently reside in the inline buffer
+            (i.e. no heap memory is held).
+        */
+    bool usesInlineBuffer() const
+    {
+        return this->data_ == inlineData();
+    }
+
+    void pop_back()
+    {
+        --this->size_;
+        alloc_.destroy(this->data_ + this->size_);
+    }
+
+    void push_back( value_type const & t )
+    {
+        reserveForGrowth();
+        alloc_.construct(this->data_ + this->size_, t);
+        ++this->size_;
+    }
+
+    void clear()
+    {
+        detail::destroy_n(this->data_, (std::ptrdiff_t)this->size_);
+        this->size_ = 0;
+    }
+
+    void reserve( size_type new_capacity )
+    {
+        if(new_capacity <= capacity_)
+            return;
+        pointer new_data = alloc_.allocate(new_capacity);
+        if(this->size_ > 0)
+            std::uninitialized_copy(this->data_, this->data_+this->size_, new_data);
+        detail::destroy_n(this->data_, (std::ptrdiff_t)this->size_);
+        if(!usesInlineBuffer())
+            alloc_.deallocate(this->data_, capacity_);
+        this->data_ = new_data;
+        capacity_ = new_capacity;
+    }
+
+    void resize( size_type new_size, value_type const & initial )
+    {
+        if(new_size < this->size_)
+        {
+            detail::destroy_n(this->data_ + new_size,
+                                     (std::ptrdiff_t)(this->size_ - new_size));
+            this->size_ = new_size;
+        }
+        else if(this->size_ < new_size)
+        {
+            if(new_size > capacity_)
+                reserve(std::max<size_type>(new_size, resizeFactor*capacity_));
+            std::uninitialized_fill(this->data_ + this->size_,
+                                    this->data_ + new_size, initial);
+            this->size_ = new_size;
+        }
+    }
+
+    void resize( size_type new_size )
+    {
+        resize(new_size, value_type());
+    }
+
+    size_type capacity() const
+    {
+        return capacity_;
+    }
+
+        /** Exchange the contents of two vectors. When both vectors have
+            outgrown their inline buffers, this only swaps pointers;
+            otherwise, the elements are copied. In contrast to
+            <tt>ArrayVector::swap()</tt>, iterators are always
+            invalidated.
+        */
+    void swap(this_type & rhs)
+    {
+        if(!usesInlineBuffer() && !rhs.usesInlineBuffer())
+        {
+            std::swap(this->size_, rhs.size_);
+            std::swap(capacity_, rhs.capacity_);
+            std::swap(this->data_, rhs.data_);
+        }
+        else
+        {
+            this_type t(*this);
+            *this = rhs;
+            rhs = t;
+        }
+    }
+
+  private:
+
+    pointer inlineData()
+    {
+        return reinterpret_cast<pointer>(inline_.bytes);
+    }
+
+    const_pointer inlineData() const
+    {
+        return reinterpret_cast<const_pointer>(inline_.bytes);
+    }
+
+    void reserveForGrowth()
+    {
+        if(this->size_ == capacity_)
+            reserve(capacity_ == 0
+                        ? (size_type)minimumCapacity
+                        : resizeFactor*capacity_);
+    }
+
+    void initImpl( size_type size, value_type const & initial)
+    {
+        this->data_ = inlineData();
+        capacity_ = InlineCapacity;
+        if(size > capacity_)
+        {
+            this->data_ = alloc_.allocate(size);
+            capacity_ = size;
+        }
+        if(size > 0)
+            std::uninitialized_fill(this->data_, this->data_+size, initial);
+        this->size_ = size;
+    }
+
+    template <class Iter>
+    void assignImpl( Iter b, Iter e )
+    {
+        size_type n = (size_type)std::distance(b, e);
+        if(n == this->size_)
+        {
+            std::copy(b, e, this->data_);
+        }
+        else
+        {
+            clear();
+            reserve(n);
+            if(n > 0)
+                detail::uninitializedCopy(b, e, this->data_);
+            this->size_ = n;
+        }
+    }
+
+    size_type capacity_;
+    Alloc alloc_;
+    union
+    {
+        char bytes[InlineCapacity == 0 ? 1 : InlineCapacity * sizeof(T)];
+        double alignDummy_;
+    } inline_;
+};
+
 } // namespace vigra
 
 namespace std {
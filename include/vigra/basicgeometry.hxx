@@ -39,10 +39,112 @@
 #include "error.hxx"
 #include "stdimage.hxx"
 #include "copyimage.hxx"
+#include "array_vector.hxx"
+#include "parallel_options.hxx"
 #include <cmath>
 
 namespace vigra {
 
+namespace detail {
+
+// Copy with exchanged axes in square blocks, so that the column-wise
+// traversal of the source stays within a cache-resident tile while the
+// destination is written row by row. A destination row r reads source
+// column (flipX ? ws-1-r : r), traversed backwards when flipY is set;
+// this covers transposition over both diagonals as well as the 90 and
+// 270 degree rotations. Only the destination rows [rbegin, rend) are
+// written, so callers can distribute row bands over several threads.
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void blockedTransposeImage(SrcIterator is, SrcAccessor as,
+                           DestIterator id, DestAccessor ad,
+                           int ws, int hs, bool flipX, bool flipY,
+                           int rbegin, int rend)
+{
+    int const blockSize = 64;
+
+    for(int r0 = rbegin; r0 < rend; r0 += blockSize)
+    {
+        int r1 = std::min(r0 + blockSize, rend);
+        for(int c0 = 0; c0 < hs; c0 += blockSize)
+        {
+            int c1 = std::min(c0 + blockSize, hs);
+            for(int r = r0; r < r1; ++r)
+            {
+                SrcIterator scol(is);
+                scol.x += flipX ? ws-1-r : r;
+                scol.y += flipY ? hs-1-c0 : c0;
+                typename SrcIterator::column_iterator cs = scol.columnIterator();
+
+                DestIterator drow(id);
+                drow.x += c0;
+                drow.y += r;
+                typename DestIterator::row_iterator rd = drow.rowIterator();
+
+                if(flipY)
+                {
+                    for(int c = c0; c < c1; ++c, --cs, ++rd)
+                        ad.set(as(cs), rd);
+                }
+                else
+                {
+                    for(int c = c0; c < c1; ++c, ++cs, ++rd)
+                        ad.set(as(cs), rd);
+                }
+            }
+        }
+    }
+}
+
+// band-parallel driver for blockedTransposeImage(); num_threads must
+// already be clamped to the number of destination rows
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void transposeImageBands(SrcIterator is, SrcAccessor as,
+                         DestIterator id, DestAccessor ad,
+                         int ws, int hs, bool flipX, bool flipY,
+                         int num_threads, char const * caller)
+{
+#ifdef _OPENMP
+    if(num_threads > 1)
+    {
+        ArrayVector<int> bounds(num_threads+1);
+        for(int t = 0; t <= num_threads; ++t)
+            bounds[t] = (int)(((long long)ws * t) / num_threads);
+
+        std::string errorMessage;
+
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(int t = 0; t < num_threads; ++t)
+        {
+            try
+            {
+                blockedTransposeImage(is, as, id, ad, ws, hs, flipX, flipY,
+                                      bounds[t], bounds[t+1]);
+            }
+            catch(std::exception & e)
+            {
+#pragma omp critical(vigra_transpose_image_error)
+                errorMessage = e.what();
+            }
+            catch(...)
+            {
+#pragma omp critical(vigra_transpose_image_error)
+                errorMessage = "unknown error";
+            }
+        }
+
+        if(errorMessage.size())
+            vigra_fail(std::string(caller) + "(): worker thread failed with:\n" + errorMessage);
+        return;
+    }
+#endif // _OPENMP
+
+    blockedTransposeImage(is, as, id, ad, ws, hs, flipX, flipY, 0, ws);
+}
+
+} // namespace detail
+
 /** \addtogroup GeometricTransformations Geometric Transformations
 */
 //@{
@@ -91,9 +193,14 @@ namespace vigra {
     Image dest(src.height(), src.width()); // note that width and height are exchanged
     
     vigra::rotateImage(srcImageRange(src), destImage(dest), 90);
-    
+
     \endcode
 
+    The 90 and 270 degree rotations copy the pixels in cache-friendly
+    square blocks. Both forms also accept a \ref vigra::ParallelOptions
+    object as last argument to distribute the blocks of these two cases
+    over several threads.
+
     <b> Required Interface:</b>
     
     \code
@@ -138,18 +245,8 @@ void rotateImage(SrcIterator is, SrcIterator end, SrcAccessor as,
         case 0:
             copyImage(is, end, as, id, ad);
             break;
-        case 90: 
-            is.x += (ws-1);
-            for(x=0; x != ws; x++, is.x--, id.y++)
-            {
-                typename SrcIterator::column_iterator cs = is.columnIterator();
-                typename DestIterator::row_iterator rd = id.rowIterator();
-                for(y=0; y != hs; y++, cs++, rd++)
-                {
-                    ad.set(as(cs), rd);
-                }
-        
-            }
+        case 90:
+            detail::blockedTransposeImage(is, as, id, ad, ws, hs, true, false, 0, ws);
             break;
 
         case 180:
@@ -167,18 +264,8 @@ void rotateImage(SrcIterator is, SrcIterator end, SrcAccessor as,
             }
             break;
 
-        case 270:  
-            is.y += (hs-1);
-            for(x=0; x != ws; x++, is.x++, id.y++)
-            {
-                typename SrcIterator::column_iterator cs = is.columnIterator();
-                typename DestIterator::row_iterator rd = id.rowIterator();
-                for(y=0; y != hs; y++, cs--, rd++)
-                {
-                    ad.set(as(cs), rd);
-                }
-        
-            }
+        case 270:
+            detail::blockedTransposeImage(is, as, id, ad, ws, hs, false, true, 0, ws);
             break;
         default: //not needful, because of the exception handig in if-statement 
             vigra_fail("internal error"); 
@@ -187,13 +274,60 @@ void rotateImage(SrcIterator is, SrcIterator end, SrcAccessor as,
 
 template <class SrcImageIterator, class SrcAccessor,
           class DestImageIterator, class DestAccessor>
-inline void 
+inline void
 rotateImage(triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
               pair<DestImageIterator, DestAccessor> dest, int rotation)
 {
     rotateImage(src.first, src.second, src.third, dest.first, dest.second, rotation);
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void rotateImage(SrcIterator is, SrcIterator end, SrcAccessor as,
+                 DestIterator id, DestAccessor ad, int rotation,
+                 ParallelOptions const & options)
+{
+    int ws = end.x - is.x;
+    int hs = end.y - is.y;
+
+    vigra_precondition(rotation % 90 == 0,
+                "rotateImage(): "
+                "This function rotates images only about multiples of 90 degree");
+
+    rotation = rotation%360;
+    if (rotation < 0)
+        rotation += 360;
+
+    int num_threads = options.getNumThreads();
+    if(num_threads > ws)
+        num_threads = ws;
+
+    switch(rotation)
+    {
+        case 90:
+            detail::transposeImageBands(is, as, id, ad, ws, hs, true, false,
+                                        num_threads, "rotateImage");
+            break;
+        case 270:
+            detail::transposeImageBands(is, as, id, ad, ws, hs, false, true,
+                                        num_threads, "rotateImage");
+            break;
+        default:
+            // 0 and 180 degrees are handled row by row anyway
+            rotateImage(is, end, as, id, ad, rotation);
+    }
+}
+
+template <class SrcImageIterator, class SrcAccessor,
+          class DestImageIterator, class DestAccessor>
+inline void
+rotateImage(triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
+              pair<DestImageIterator, DestAccessor> dest, int rotation,
+              ParallelOptions const & options)
+{
+    rotateImage(src.first, src.second, src.third, dest.first, dest.second, rotation, options);
+}
+
 /********************************************************/
 /*                                                      */
 /*                     reflectImage                     */
@@ -397,9 +531,14 @@ enum Transpose{major = 1, minor = 2};
     Image dest(src.width(), src.height());
     
     vigra::transposeImage(srcImageRange(src), destImage(dest), vigra::major | vigra::minor);
-    
+
     \endcode
 
+    The major and minor transpositions copy the pixels in cache-friendly
+    square blocks. Both forms also accept a \ref vigra::ParallelOptions
+    object as last argument to distribute the blocks of these two cases
+    over several threads.
+
     <b> Required Interface:</b>
     
     \code
@@ -434,31 +573,11 @@ void transposeImage(SrcIterator is, SrcIterator end, SrcAccessor as,
 
     if(transpose == major)
     {//Die Funktion spiegelt das Bild um (0,0) (1,1) Diagonale
-        for(x=0; x != ws; x++, is.x++, id.y++)
-        {
-
-            typename SrcIterator::column_iterator cs = is.columnIterator();
-            typename DestIterator::row_iterator rd = id.rowIterator();
-            for(y=0; y != hs; y++, cs++, rd++)
-            {
-                ad.set(as(cs), rd);
-            }
-        }
+        detail::blockedTransposeImage(is, as, id, ad, ws, hs, false, false, 0, ws);
     }
     else if(transpose == minor)
     {//Die Funktion spiegelt das Bild (1,0) (0,1) Diagonale
-        end.x--;
-        end.y--;
-        for(x=0; x != ws; x++, --end.x, ++id.y)
-        {
-
-            typename SrcIterator::column_iterator cs = end.columnIterator();
-            typename DestIterator::row_iterator rd = id.rowIterator();
-            for(y=0; y != hs; y++, --cs, ++rd)
-            {
-                ad.set(as(cs), rd);
-            }
-        }
+        detail::blockedTransposeImage(is, as, id, ad, ws, hs, true, true, 0, ws);
     }
     else if(transpose == (major | minor))
     {//flipFlopImage  //???
@@ -484,13 +603,54 @@ void transposeImage(SrcIterator is, SrcIterator end, SrcAccessor as,
 
 template <class SrcImageIterator, class SrcAccessor,
           class DestImageIterator, class DestAccessor>
-inline void 
+inline void
 transposeImage(triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
               pair<DestImageIterator, DestAccessor> dest, Transpose transpose)
 {
     transposeImage(src.first, src.second, src.third, dest.first, dest.second, transpose);
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void transposeImage(SrcIterator is, SrcIterator end, SrcAccessor as,
+                    DestIterator id, DestAccessor ad, Transpose transpose,
+                    ParallelOptions const & options)
+{
+    int ws = end.x - is.x;
+    int hs = end.y - is.y;
+
+    int num_threads = options.getNumThreads();
+    if(num_threads > ws)
+        num_threads = ws;
+
+    if(transpose == major)
+    {
+        detail::transposeImageBands(is, as, id, ad, ws, hs, false, false,
+                                    num_threads, "transposeImage");
+    }
+    else if(transpose == minor)
+    {
+        detail::transposeImageBands(is, as, id, ad, ws, hs, true, true,
+                                    num_threads, "transposeImage");
+    }
+    else
+    {
+        // (major | minor) equals a 180 degree rotation and is handled
+        // column by column on both sides anyway
+        transposeImage(is, end, as, id, ad, transpose);
+    }
+}
+
+template <class SrcImageIterator, class SrcAccessor,
+          class DestImageIterator, class DestAccessor>
+inline void
+transposeImage(triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
+              pair<DestImageIterator, DestAccessor> dest, Transpose transpose,
+              ParallelOptions const & options)
+{
+    transposeImage(src.first, src.second, src.third, dest.first, dest.second, transpose, options);
+}
+
 /********************************************************/
 /*                                                      */
 /*                        resampleLine                  */
@@ -751,6 +751,26 @@ class BasicImage
         resizeCopy(rhs);
     }
 
+#ifdef VIGRA_HAS_RVALUE_REFERENCES
+        /** move rhs image (C++ 11 only).<br>
+            Takes over the memory of \a rhs instead of copying the pixels.
+            \a rhs is left as an image of size 0x0.
+        */
+    BasicImage(BasicImage && rhs)
+    : data_(rhs.data_),
+      lines_(rhs.lines_),
+      width_(rhs.width_),
+      height_(rhs.height_),
+      allocator_(rhs.allocator_),
+      pallocator_(rhs.pallocator_)
+    {
+        rhs.data_ = 0;
+        rhs.lines_ = 0;
+        rhs.width_ = 0;
+        rhs.height_ = 0;
+    }
+#endif
+
         /** destructor
         */
     ~BasicImage()
@@ -762,6 +782,27 @@ class BasicImage
         */
     BasicImage & operator=(const BasicImage & rhs);
 
+#ifdef VIGRA_HAS_RVALUE_REFERENCES
+        /** move rhs image (C++ 11 only).<br>
+            Takes over the memory of \a rhs instead of copying the pixels and
+            releases the old memory of the left-hand side image. \a rhs is
+            left as an image of size 0x0.
+        */
+    BasicImage & operator=(BasicImage && rhs)
+    {
+        if(this != &rhs)
+        {
+            deallocate();
+            data_ = 0;
+            lines_ = 0;
+            width_ = 0;
+            height_ = 0;
+            swap(rhs);
+        }
+        return *this;
+    }
+#endif
+
         /** \deprecated set Image with const value
         */
     BasicImage & operator=(value_type pixel);
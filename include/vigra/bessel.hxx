@@ -330,6 +330,107 @@ inline double besselY(int n, double x)
 #endif
 }
 
+    /*! Bessel function of the first kind over a contiguous array.
+
+        Computes <tt>res[k] = besselJ(n, x[k])</tt> for
+        <tt>k = 0 ... size-1</tt>. The domain check and the dispatch on
+        the order are hoisted out of the loop, and the common orders 0
+        and +/-1 call the specialized library entry points directly, so
+        filter-bank construction over whole grids avoids the per-call
+        overhead of the scalar wrapper. The results agree with repeated
+        calls of \ref besselJ() to within 1 ULP (they may differ in the
+        last bit when the compiler constant-folds one of the calls).
+
+        <b>\#include</b> \<vigra/bessel.hxx\><br>
+        Namespace: vigra
+    */
+inline void besselJSpan(int n, double const * x, std::size_t size, double * res)
+{
+    for(std::size_t k = 0; k < size; ++k)
+        if(x[k] < 0.0)
+            throw std::domain_error("besselJSpan(n, x, size, res): x cannot be negative");
+#if !defined(HasBoostMath) && (defined(__GNUC__) || defined(_MSC_VER))
+    if(n == 0)
+    {
+        for(std::size_t k = 0; k < size; ++k)
+#if defined(__GNUC__)
+            res[k] = x[k] < 1e-15 ? 1.0 : ::j0(x[k]);
+#else
+            res[k] = x[k] < 1e-15 ? 1.0 : _j0(x[k]);
+#endif
+    }
+    else if(n == 1 || n == -1)
+    {
+        double sign = n < 0 ? -1.0 : 1.0;
+        for(std::size_t k = 0; k < size; ++k)
+#if defined(__GNUC__)
+            res[k] = x[k] < 1e-15 ? 0.0 : sign * ::j1(x[k]);
+#else
+            res[k] = x[k] < 1e-15 ? 0.0 : sign * _j1(x[k]);
+#endif
+    }
+    else
+#endif
+    {
+        for(std::size_t k = 0; k < size; ++k)
+            res[k] = x[k] < 1e-15
+                         ? (n == 0 ? 1.0 : 0.0)
+                         : besselJ(n, x[k]);
+    }
+}
+
+    /*! Bessel function of the second kind over a contiguous array.
+
+        Computes <tt>res[k] = besselY(n, x[k])</tt> for
+        <tt>k = 0 ... size-1</tt>, with the same loop structure, order
+        dispatch, and accuracy (within 1 ULP) as \ref besselJSpan().
+
+        <b>\#include</b> \<vigra/bessel.hxx\><br>
+        Namespace: vigra
+    */
+inline void besselYSpan(int n, double const * x, std::size_t size, double * res)
+{
+    for(std::size_t k = 0; k < size; ++k)
+        if(x[k] < 0.0)
+            throw std::domain_error("besselYSpan(n, x, size, res): x cannot be negative");
+#if !defined(HasBoostMath) && (defined(__GNUC__) || defined(_MSC_VER))
+    if(n == 0)
+    {
+        for(std::size_t k = 0; k < size; ++k)
+#if defined(__GNUC__)
+            res[k] = x[k] == 0.0
+                         ? -std::numeric_limits<double>::infinity()
+                         : ::y0(x[k]);
+#else
+            res[k] = x[k] == 0.0
+                         ? -std::numeric_limits<double>::infinity()
+                         : _y0(x[k]);
+#endif
+    }
+    else if(n == 1 || n == -1)
+    {
+        double sign = n < 0 ? -1.0 : 1.0;
+        for(std::size_t k = 0; k < size; ++k)
+#if defined(__GNUC__)
+            res[k] = x[k] == 0.0
+                         ? -std::numeric_limits<double>::infinity()
+                         : sign * ::y1(x[k]);
+#else
+            res[k] = x[k] == 0.0
+                         ? -std::numeric_limits<double>::infinity()
+                         : sign * _y1(x[k]);
+#endif
+    }
+    else
+#endif
+    {
+        for(std::size_t k = 0; k < size; ++k)
+            res[k] = x[k] == 0.0
+                         ? -std::numeric_limits<double>::infinity()
+                         : besselY(n, x[k]);
+    }
+}
+
 //@}
 
 } // namespace vigra
@@ -18,6 +18,12 @@ struct EnableBitArray
 // access functions set<unsigned>(), test<unsigned>(), reset<unsigned>(), and
 // flip<unsigned>(), plus all relational operators;
 // furthermore, there are no range checks.
+// Bulk set algebra is word-parallel: &=, |=, ^=, and the set difference
+// -= (ANDNOT) process one word per step, count() uses the compiler's
+// population count intrinsic (a single popcnt instruction when the
+// target supports it), and findNextSet() scans a word at a time via
+// count-trailing-zeros, so iterating the set bits of a sparse mask
+// costs O(words), not O(bits).
 
 template <unsigned SIZE, class WORD_TYPE = unsigned, class = void>
 class BitArray
@@ -246,6 +252,10 @@ class BitArray<SIZE, WORD_TYPE, typename EnableBitArray<SIZE, WORD_TYPE>::type>
     {
         static void assign(WORD_TYPE & a, WORD_TYPE b) { a |= b; }
     };
+    struct bit_andnot_assign
+    {
+        static void assign(WORD_TYPE & a, WORD_TYPE b) { a &= ~b; }
+    };
     template <class A>
     BitArray & assign_operator(const BitArray & x)
     {
@@ -266,13 +276,18 @@ class BitArray<SIZE, WORD_TYPE, typename EnableBitArray<SIZE, WORD_TYPE>::type>
     {
         return assign_operator<bit_or_assign>(x);
     }
-   
+    BitArray & operator-=(const BitArray & x) // set difference (ANDNOT)
+    {
+        return assign_operator<bit_andnot_assign>(x);
+    }
+
   protected:
     template <class A>
-    BitArray & bit_operator(const BitArray & y) const
+    BitArray bit_operator(const BitArray & y) const
     {
         BitArray x(*this);
-        return x.assign_operator<A>(y);
+        x.assign_operator<A>(y);
+        return x;
     }
   public:
     BitArray operator&(const BitArray & y) const
@@ -287,6 +302,68 @@ class BitArray<SIZE, WORD_TYPE, typename EnableBitArray<SIZE, WORD_TYPE>::type>
     {
         return bit_operator<bit_or_assign>(y);
     }
+    BitArray operator-(const BitArray & y) const
+    {
+        return bit_operator<bit_andnot_assign>(y);
+    }
+
+  protected:
+    static unsigned word_popcount(WORD_TYPE w)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return sizeof(WORD_TYPE) <= sizeof(unsigned)
+                   ? (unsigned)__builtin_popcount(w)
+                   : sizeof(WORD_TYPE) <= sizeof(unsigned long)
+                         ? (unsigned)__builtin_popcountl(w)
+                         : (unsigned)__builtin_popcountll(w);
+#else
+        unsigned n = 0;
+        for (; w != 0; w &= w - 1) // clear the lowest set bit
+            ++n;
+        return n;
+#endif
+    }
+    static unsigned word_trailing_zeros(WORD_TYPE w) // requires w != 0
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return sizeof(WORD_TYPE) <= sizeof(unsigned)
+                   ? (unsigned)__builtin_ctz(w)
+                   : sizeof(WORD_TYPE) <= sizeof(unsigned long)
+                         ? (unsigned)__builtin_ctzl(w)
+                         : (unsigned)__builtin_ctzll(w);
+#else
+        unsigned n = 0;
+        for (; (w & 1) == 0; w >>= 1)
+            ++n;
+        return n;
+#endif
+    }
+
+  public:
+    unsigned count() const // number of set bits
+    {
+        unsigned n = 0;
+        for (unsigned i = 0; i != array_len; ++i)
+            n += word_popcount(set_bits[i]);
+        return n;
+    }
+    // index of the first set bit at position >= pos, or SIZE if there
+    // is none -- iterate all set bits of a sparse mask like so:
+    //     for (unsigned i = x.findNextSet(); i < SIZE; i = x.findNextSet(i + 1))
+    unsigned findNextSet(unsigned pos = 0) const
+    {
+        if (pos >= bit_size)
+            return bit_size;
+        unsigned i = word_pos(pos);
+        WORD_TYPE w = set_bits[i] & (ones_mask << (pos % word_len));
+        while (w == 0)
+        {
+            if (++i == array_len)
+                return bit_size;
+            w = set_bits[i];
+        }
+        return i * word_len + word_trailing_zeros(w);
+    }
 
     bool operator&&(const BitArray & y) const
     {
@@ -214,6 +214,265 @@ class BucketQueue<ValueType, true> // ascending queue
     }
 };
 
+/** \brief Bucket queue with flat preallocated storage.
+
+    This template implements the same interface and ordering guarantees as
+    \ref vigra::BucketQueue, but stores all elements in a single preallocated
+    arena instead of one <tt>std::deque</tt> per bucket. The buckets are
+    realized as singly-linked lists of arena slots, and slots released by
+    <tt>pop</tt> are recycled through a free list. When the arena is created
+    with a sufficient \arg expected_size (e.g. the number of pixels for
+    watershed or region growing flooding), push and pop therefore perform
+    no memory allocations at all; if the estimate is exceeded, the arena
+    grows like a <tt>std::vector</tt> and the queue remains correct.
+
+    <tt>ValueType</tt> must be default constructible and assignable.
+
+    <b>\#include</b> \<vigra/bucket_queue.hxx\><br>
+    Namespace: vigra
+*/
+template <class ValueType,
+          bool Ascending = false>  // std::priority_queue is descending
+class PooledBucketQueue
+{
+    struct Node
+    {
+        ValueType value;
+        std::ptrdiff_t next;
+    };
+
+    ArrayVector<Node> arena_;
+    ArrayVector<std::ptrdiff_t> head_, tail_;
+    std::ptrdiff_t free_;
+    std::size_t size_;
+    std::ptrdiff_t top_;
+
+  public:
+
+    typedef ValueType value_type;
+    typedef ValueType & reference;
+    typedef ValueType const & const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t priority_type;
+
+        /** \brief Create bucket queue with \arg bucket_count entries
+            whose arena holds \arg expected_size elements.
+            Priorities must be integers in the range <tt>[0, ..., bucket_count-1]</tt>.
+        */
+    PooledBucketQueue(size_type bucket_count = 256, size_type expected_size = 0)
+    : head_(bucket_count, (std::ptrdiff_t)-1),
+      tail_(bucket_count, (std::ptrdiff_t)-1),
+      free_(-1), size_(0), top_(0)
+    {
+        arena_.reserve(expected_size);
+    }
+
+        /** \brief Enlarge the arena to hold \arg expected_size elements.
+        */
+    void reserve(size_type expected_size)
+    {
+        arena_.reserve(expected_size);
+    }
+
+        /** \brief Number of elements the arena can hold without allocating.
+        */
+    size_type capacity() const
+    {
+        return arena_.capacity();
+    }
+
+        /** \brief Number of elements in this queue.
+        */
+    size_type size() const
+    {
+        return size_;
+    }
+
+        /** \brief Queue contains no elements.
+             Equivalent to <tt>size() == 0</tt>.
+        */
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+        /** \brief Maximum index (i.e. priority) allowed in this queue.
+             Equivalent to <tt>bucket_count - 1</tt>.
+        */
+    priority_type maxIndex() const
+    {
+        return (priority_type)head_.size() - 1;
+    }
+
+        /** \brief Priority of the current top element.
+        */
+    priority_type topPriority() const
+    {
+        return top_;
+    }
+
+        /** \brief The current top element.
+        */
+    const_reference top() const
+    {
+        return arena_[head_[top_]].value;
+    }
+
+        /** \brief Remove the current top element.
+             Its arena slot is recycled via the free list.
+        */
+    void pop()
+    {
+        --size_;
+        std::ptrdiff_t n = head_[top_];
+        head_[top_] = arena_[n].next;
+        if(head_[top_] == -1)
+            tail_[top_] = -1;
+        arena_[n].next = free_;
+        free_ = n;
+
+        while(top_ > 0 && head_[top_] == -1)
+            --top_;
+    }
+
+        /** \brief Insert new element \arg v with given \arg priority.
+        */
+    void push(value_type const & v, priority_type priority)
+    {
+        std::ptrdiff_t n = free_;
+        if(n != -1)
+        {
+            free_ = arena_[n].next;
+        }
+        else
+        {
+            // only reached when expected_size was underestimated
+            arena_.push_back(Node());
+            n = (std::ptrdiff_t)arena_.size() - 1;
+        }
+        arena_[n].value = v;
+        arena_[n].next = -1;
+
+        if(tail_[priority] == -1)
+            head_[priority] = n;
+        else
+            arena_[tail_[priority]].next = n;
+        tail_[priority] = n;
+
+        ++size_;
+        if(priority > top_)
+            top_ = priority;
+    }
+};
+
+template <class ValueType>
+class PooledBucketQueue<ValueType, true> // ascending queue
+{
+    struct Node
+    {
+        ValueType value;
+        std::ptrdiff_t next;
+    };
+
+    ArrayVector<Node> arena_;
+    ArrayVector<std::ptrdiff_t> head_, tail_;
+    std::ptrdiff_t free_;
+    std::size_t size_;
+    std::ptrdiff_t top_;
+
+  public:
+
+    typedef ValueType value_type;
+    typedef ValueType & reference;
+    typedef ValueType const & const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t priority_type;
+
+    PooledBucketQueue(size_type bucket_count = 256, size_type expected_size = 0)
+    : head_(bucket_count, (std::ptrdiff_t)-1),
+      tail_(bucket_count, (std::ptrdiff_t)-1),
+      free_(-1), size_(0), top_((priority_type)bucket_count)
+    {
+        arena_.reserve(expected_size);
+    }
+
+    void reserve(size_type expected_size)
+    {
+        arena_.reserve(expected_size);
+    }
+
+    size_type capacity() const
+    {
+        return arena_.capacity();
+    }
+
+    size_type size() const
+    {
+        return size_;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    priority_type maxIndex() const
+    {
+        return (priority_type)head_.size() - 1;
+    }
+
+    priority_type topPriority() const
+    {
+        return top_;
+    }
+
+    const_reference top() const
+    {
+        return arena_[head_[top_]].value;
+    }
+
+    void pop()
+    {
+        --size_;
+        std::ptrdiff_t n = head_[top_];
+        head_[top_] = arena_[n].next;
+        if(head_[top_] == -1)
+            tail_[top_] = -1;
+        arena_[n].next = free_;
+        free_ = n;
+
+        while(top_ < (priority_type)head_.size() && head_[top_] == -1)
+            ++top_;
+    }
+
+    void push(value_type const & v, priority_type priority)
+    {
+        std::ptrdiff_t n = free_;
+        if(n != -1)
+        {
+            free_ = arena_[n].next;
+        }
+        else
+        {
+            // only reached when expected_size was underestimated
+            arena_.push_back(Node());
+            n = (std::ptrdiff_t)arena_.size() - 1;
+        }
+        arena_[n].value = v;
+        arena_[n].next = -1;
+
+        if(tail_[priority] == -1)
+            head_[priority] = n;
+        else
+            arena_[tail_[priority]].next = n;
+        tail_[priority] = n;
+
+        ++size_;
+        if(priority < top_)
+            top_ = priority;
+    }
+};
+
 /** \brief Priority queue implemented using bucket sort (STL compatible).
 
     This template is compatible to <tt><a href="http://www.sgi.com/tech/stl/priority_queue.html">std::priority_queue</a></tt>,
@@ -221,22 +480,25 @@ class BucketQueue<ValueType, true> // ascending queue
     like \ref vigra::BucketQueue, but has an additional <tt>PriorityFunctor</tt>
     which extracts the priority value of an element of type <tt>ValueType</tt>.
     Thus functor is called within <tt>push</tt> so that it does not need an
-    extra argument.
+    extra argument. The underlying queue implementation can be exchanged
+    via the <tt>QueueType</tt> parameter, e.g. to get the allocation-free
+    behavior of \ref vigra::PooledBucketQueue.
 
     <b>\#include</b> \<vigra/bucket_queue.hxx\><br>
     Namespace: vigra
 */
 template <class ValueType,
-          class PriorityFunctor, 
-          bool Ascending = false> 
+          class PriorityFunctor,
+          bool Ascending = false,
+          class QueueType = BucketQueue<ValueType, Ascending> >
 class MappedBucketQueue
-: public BucketQueue<ValueType, Ascending>
+: public QueueType
 {
     PriorityFunctor get_priority_;
-    
+
   public:
 
-    typedef BucketQueue<ValueType, Ascending> BaseType;
+    typedef QueueType BaseType;
     typedef typename BaseType::value_type value_type;
     typedef typename BaseType::reference reference;
     typedef typename BaseType::const_reference const_reference;
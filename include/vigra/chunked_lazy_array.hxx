@@ -0,0 +1,746 @@
+/************************************************************************/
+/*                                                                      */
+/*               Copyright 2012 by Ullrich Koethe                       */
+/*                                                                      */
+/*    This file is part of the VIGRA computer vision library.           */
+/*    The VIGRA Website is                                              */
+/*        http://hci.iwr.uni-heidelberg.de/vigra/                       */
+/*    Please direct questions, bug reports, and contributions to        */
+/*        ullrich.koethe@iwr.uni-heidelberg.de    or                    */
+/*        vigra@informatik.uni-hamburg.de                               */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+#ifndef VIGRA_CHUNKED_LAZY_ARRAY_HXX
+#define VIGRA_CHUNKED_LAZY_ARRAY_HXX
+
+#include <list>
+#include <map>
+#include "multi_array.hxx"
+#include "multi_convolution.hxx"
+#include "array_vector.hxx"
+#include "error.hxx"
+
+namespace vigra {
+
+/** \addtogroup ChunkedLazyArrays Chunked lazy arrays
+
+    Compose filter graphs over arrays that are far larger than main
+    memory; chunks are computed on demand and cached with an LRU policy.
+*/
+//@{
+
+/********************************************************/
+/*                                                      */
+/*                  ChunkedLazyNode                     */
+/*                                                      */
+/********************************************************/
+
+/** \brief Base class of the nodes in a chunked lazy evaluation graph.
+
+    A node represents an array of a given shape whose contents are computed
+    on demand, one chunk at a time, by the virtual function computeChunk().
+    Computed chunks are held in a per-node LRU cache with a configurable
+    byte limit, so overlapping requests (for example, the halo regions of
+    neighboring convolution tiles) are served from memory instead of being
+    recomputed or re-read from disk.
+
+    Users do not deal with nodes directly, but through the handle class
+    \ref ChunkedLazyArray, which manages node lifetime by reference
+    counting and offers factory functions for the built-in node types.
+*/
+template <unsigned int N, class T>
+class ChunkedLazyNode
+{
+  public:
+    typedef typename MultiArrayShape<N>::type shape_type;
+
+        /** Default cache limit of newly created nodes (64 MB).
+         */
+    static const std::size_t defaultCacheLimit = 1 << 26;
+
+    ChunkedLazyNode(shape_type const & shape, shape_type const & chunkShape,
+                    std::size_t cacheLimit)
+    : shape_(shape),
+      chunkShape_(chunkShape),
+      cacheLimit_(cacheLimit),
+      cacheBytes_(0),
+      refCount_(0)
+    {
+        for(unsigned int d = 0; d < N; ++d)
+        {
+            vigra_precondition(shape_[d] > 0 && chunkShape_[d] > 0,
+                "ChunkedLazyNode(): shape and chunkShape must be positive.");
+            chunkCount_[d] = (shape_[d] + chunkShape_[d] - 1) / chunkShape_[d];
+        }
+    }
+
+    virtual ~ChunkedLazyNode()
+    {
+        clearCache();
+    }
+
+        /** The shape of the (virtual) array this node represents.
+         */
+    shape_type const & shape() const
+    {
+        return shape_;
+    }
+
+        /** The chunk shape used for caching and on-demand computation
+            (chunks at the upper border may be smaller).
+         */
+    shape_type const & chunkShape() const
+    {
+        return chunkShape_;
+    }
+
+        /** Copy the region <tt>[start, stop)</tt> into \a dest, computing
+            the chunks it touches as needed. Chunks are cached subject to
+            the node's cache limit.
+         */
+    template <class Stride>
+    void readBlock(shape_type const & start, shape_type const & stop,
+                   MultiArrayView<N, T, Stride> dest)
+    {
+        for(unsigned int d = 0; d < N; ++d)
+        {
+            vigra_precondition(0 <= start[d] && start[d] < stop[d] && stop[d] <= shape_[d],
+                "ChunkedLazyNode::readBlock(): block out of bounds.");
+        }
+        vigra_precondition(dest.shape() == stop - start,
+            "ChunkedLazyNode::readBlock(): destination shape must equal stop - start.");
+
+        shape_type cfirst, clast;
+        for(unsigned int d = 0; d < N; ++d)
+        {
+            cfirst[d] = start[d] / chunkShape_[d];
+            clast[d]  = (stop[d] - 1) / chunkShape_[d];
+        }
+
+        // visit all chunks intersecting the requested block
+        shape_type chunk = cfirst;
+        for(;;)
+        {
+            shape_type cstart, cstop;
+            for(unsigned int d = 0; d < N; ++d)
+            {
+                cstart[d] = chunk[d] * chunkShape_[d];
+                cstop[d]  = std::min(cstart[d] + chunkShape_[d], shape_[d]);
+            }
+
+            MultiArray<N, T> scratch;
+            MultiArrayView<N, T> cview = checkoutChunk(chunk, cstart, cstop, scratch);
+
+            shape_type ostart, ostop;   // overlap of chunk and requested block
+            for(unsigned int d = 0; d < N; ++d)
+            {
+                ostart[d] = std::max(cstart[d], start[d]);
+                ostop[d]  = std::min(cstop[d], stop[d]);
+            }
+            dest.subarray(ostart - start, ostop - start).copy(
+                                 cview.subarray(ostart - cstart, ostop - cstart));
+
+            unsigned int d = 0;
+            for(; d < N; ++d)
+            {
+                if(++chunk[d] <= clast[d])
+                    break;
+                chunk[d] = cfirst[d];
+            }
+            if(d == N)
+                break;
+        }
+    }
+
+        /** Change the cache limit (in bytes) of this node. Cached chunks
+            are evicted in LRU order until the limit is satisfied. A limit
+            of zero disables caching entirely.
+         */
+    void setCacheLimit(std::size_t bytes)
+    {
+        cacheLimit_ = bytes;
+        trimCache(0);
+    }
+
+        /** The current cache limit in bytes.
+         */
+    std::size_t cacheLimit() const
+    {
+        return cacheLimit_;
+    }
+
+        /** The number of bytes currently held in the chunk cache.
+         */
+    std::size_t cachedBytes() const
+    {
+        return cacheBytes_;
+    }
+
+        /** Discard all cached chunks.
+         */
+    void clearCache()
+    {
+        for(typename Cache::iterator i = cache_.begin(); i != cache_.end(); ++i)
+            delete i->second.data;
+        cache_.clear();
+        lru_.clear();
+        cacheBytes_ = 0;
+    }
+
+    void incRef()
+    {
+        ++refCount_;
+    }
+
+    void decRef()
+    {
+        if(--refCount_ == 0)
+            delete this;
+    }
+
+  protected:
+        /** Compute the chunk covering <tt>[start, stop)</tt> into the
+            given (unstrided) view of shape <tt>stop - start</tt>.
+         */
+    virtual void computeChunk(shape_type const & start, shape_type const & stop,
+                              MultiArrayView<N, T> & chunk) = 0;
+
+  private:
+    struct CacheEntry
+    {
+        MultiArray<N, T> * data;
+        typename std::list<MultiArrayIndex>::iterator lruPos;
+    };
+
+    typedef std::map<MultiArrayIndex, CacheEntry> Cache;
+
+    MultiArrayIndex chunkIndex(shape_type const & chunk) const
+    {
+        MultiArrayIndex index = 0;
+        for(int d = N-1; d >= 0; --d)
+            index = index * chunkCount_[d] + chunk[d];
+        return index;
+    }
+
+    MultiArrayView<N, T>
+    checkoutChunk(shape_type const & chunk,
+                  shape_type const & cstart, shape_type const & cstop,
+                  MultiArray<N, T> & scratch)
+    {
+        MultiArrayIndex index = chunkIndex(chunk);
+        typename Cache::iterator i = cache_.find(index);
+        if(i != cache_.end())
+        {
+            lru_.splice(lru_.begin(), lru_, i->second.lruPos);   // mark as most recent
+            return *i->second.data;
+        }
+
+        std::size_t bytes = (std::size_t)prod(cstop - cstart) * sizeof(T);
+        if(bytes > cacheLimit_)
+        {
+            // chunk does not fit into the cache => compute into the
+            // caller's scratch buffer without caching
+            scratch.reshape(cstop - cstart);
+            MultiArrayView<N, T> & view = scratch;
+            computeChunk(cstart, cstop, view);
+            return view;
+        }
+
+        // compute first, insert afterwards, so a throwing computeChunk()
+        // cannot leave a half-filled chunk in the cache
+        CacheEntry entry;
+        entry.data = new MultiArray<N, T>(cstop - cstart);
+        MultiArrayView<N, T> & view = *entry.data;
+        try
+        {
+            computeChunk(cstart, cstop, view);
+        }
+        catch(...)
+        {
+            delete entry.data;
+            throw;
+        }
+
+        trimCache(bytes);
+        lru_.push_front(index);
+        entry.lruPos = lru_.begin();
+        cache_[index] = entry;
+        cacheBytes_ += bytes;
+        return view;
+    }
+
+    void trimCache(std::size_t incomingBytes)
+    {
+        while(!lru_.empty() && cacheBytes_ + incomingBytes > cacheLimit_)
+        {
+            typename Cache::iterator i = cache_.find(lru_.back());
+            cacheBytes_ -= (std::size_t)prod(i->second.data->shape()) * sizeof(T);
+            delete i->second.data;
+            cache_.erase(i);
+            lru_.pop_back();
+        }
+    }
+
+    static MultiArrayIndex prod(shape_type const & s)
+    {
+        MultiArrayIndex res = 1;
+        for(unsigned int d = 0; d < N; ++d)
+            res *= s[d];
+        return res;
+    }
+
+    shape_type shape_, chunkShape_, chunkCount_;
+    std::size_t cacheLimit_, cacheBytes_;
+    int refCount_;
+    Cache cache_;
+    std::list<MultiArrayIndex> lru_;
+
+    // nodes are managed by reference counting and must not be copied
+    ChunkedLazyNode(ChunkedLazyNode const &);
+    ChunkedLazyNode & operator=(ChunkedLazyNode const &);
+};
+
+template <unsigned int N, class T>
+const std::size_t ChunkedLazyNode<N, T>::defaultCacheLimit;
+
+namespace detail {
+
+/********************************************************/
+/*                                                      */
+/*              chunked lazy graph nodes                */
+/*                                                      */
+/********************************************************/
+
+    // source node referencing an in-memory array (the data must outlive
+    // the node -- enforced by the user, as with any MultiArrayView)
+template <unsigned int N, class T>
+class ChunkedLazyViewSource
+: public ChunkedLazyNode<N, T>
+{
+  public:
+    typedef ChunkedLazyNode<N, T> base_type;
+    typedef typename base_type::shape_type shape_type;
+
+    ChunkedLazyViewSource(MultiArrayView<N, T, StridedArrayTag> const & view,
+                          shape_type const & chunkShape)
+    : base_type(view.shape(), chunkShape, 0),   // data are already in memory => no cache
+      view_(view)
+    {}
+
+  protected:
+    virtual void computeChunk(shape_type const & start, shape_type const & stop,
+                              MultiArrayView<N, T> & chunk)
+    {
+        chunk.copy(view_.subarray(start, stop));
+    }
+
+  private:
+    MultiArrayView<N, T, StridedArrayTag> view_;
+};
+
+    // separable convolution node; reads its input with the halo the kernel
+    // radii require, convolves, and keeps only the core, exactly like one
+    // tile of separableConvolveTiled()
+template <unsigned int N, class T>
+class ChunkedLazyConvolution
+: public ChunkedLazyNode<N, T>
+{
+  public:
+    typedef ChunkedLazyNode<N, T> base_type;
+    typedef typename base_type::shape_type shape_type;
+
+    ChunkedLazyConvolution(ChunkedLazyNode<N, T> * input,
+                           ArrayVector<Kernel1D<T> > const & kernels)
+    : base_type(input->shape(), input->chunkShape(), base_type::defaultCacheLimit),
+      input_(input),
+      kernels_(kernels)
+    {
+        input_->incRef();
+        vigra_precondition(kernels_.size() == N,
+            "ChunkedLazyConvolution(): one kernel per dimension required.");
+        for(unsigned int d = 0; d < N; ++d)
+        {
+            vigra_precondition(kernels_[d].borderTreatment() != BORDER_TREATMENT_WRAP &&
+                               kernels_[d].borderTreatment() != BORDER_TREATMENT_AVOID,
+                "ChunkedLazyConvolution(): border treatments WRAP and AVOID cannot "
+                "be computed chunk-by-chunk.");
+            vigra_precondition(this->shape()[d] >=
+                       std::max<MultiArrayIndex>(kernels_[d].right(), -kernels_[d].left()) + 1,
+                "ChunkedLazyConvolution(): kernel longer than array.");
+            haloLeft_[d]  = kernels_[d].right();
+            haloRight_[d] = -kernels_[d].left();
+        }
+    }
+
+    virtual ~ChunkedLazyConvolution()
+    {
+        input_->decRef();
+    }
+
+  protected:
+    virtual void computeChunk(shape_type const & start, shape_type const & stop,
+                              MultiArrayView<N, T> & chunk)
+    {
+        shape_type estart, estop;
+        for(unsigned int d = 0; d < N; ++d)
+        {
+            estart[d] = std::max<MultiArrayIndex>(start[d] - haloLeft_[d], 0);
+            estop[d]  = std::min(stop[d] + haloRight_[d], this->shape()[d]);
+        }
+
+        MultiArray<N, T> etile(estop - estart);
+        input_->readBlock(estart, estop, MultiArrayView<N, T>(etile));
+
+        separableConvolveMultiArray(srcMultiArrayRange(etile), destMultiArray(etile),
+                                    kernels_.begin());
+
+        chunk.copy(etile.subarray(start - estart, stop - estart));
+    }
+
+  private:
+    ChunkedLazyNode<N, T> * input_;
+    ArrayVector<Kernel1D<T> > kernels_;
+    shape_type haloLeft_, haloRight_;
+};
+
+    // pointwise transformation of a single input
+template <unsigned int N, class T, class Functor>
+class ChunkedLazyTransform
+: public ChunkedLazyNode<N, T>
+{
+  public:
+    typedef ChunkedLazyNode<N, T> base_type;
+    typedef typename base_type::shape_type shape_type;
+
+    ChunkedLazyTransform(ChunkedLazyNode<N, T> * input, Functor const & f)
+    : base_type(input->shape(), input->chunkShape(), base_type::defaultCacheLimit),
+      input_(input),
+      f_(f)
+    {
+        input_->incRef();
+    }
+
+    virtual ~ChunkedLazyTransform()
+    {
+        input_->decRef();
+    }
+
+  protected:
+    virtual void computeChunk(shape_type const & start, shape_type const & stop,
+                              MultiArrayView<N, T> & chunk)
+    {
+        input_->readBlock(start, stop, chunk);
+        for(T * p = chunk.data(), * end = p + chunk.size(); p != end; ++p)
+            *p = f_(*p);
+    }
+
+  private:
+    ChunkedLazyNode<N, T> * input_;
+    Functor f_;
+};
+
+    // pointwise combination of two inputs of identical shape
+template <unsigned int N, class T, class Functor>
+class ChunkedLazyCombine
+: public ChunkedLazyNode<N, T>
+{
+  public:
+    typedef ChunkedLazyNode<N, T> base_type;
+    typedef typename base_type::shape_type shape_type;
+
+    ChunkedLazyCombine(ChunkedLazyNode<N, T> * input1,
+                       ChunkedLazyNode<N, T> * input2, Functor const & f)
+    : base_type(input1->shape(), input1->chunkShape(), base_type::defaultCacheLimit),
+      input1_(input1),
+      input2_(input2),
+      f_(f)
+    {
+        input1_->incRef();
+        input2_->incRef();
+        vigra_precondition(input1_->shape() == input2_->shape(),
+            "ChunkedLazyCombine(): input shapes must match.");
+    }
+
+    virtual ~ChunkedLazyCombine()
+    {
+        input1_->decRef();
+        input2_->decRef();
+    }
+
+  protected:
+    virtual void computeChunk(shape_type const & start, shape_type const & stop,
+                              MultiArrayView<N, T> & chunk)
+    {
+        input1_->readBlock(start, stop, chunk);
+        MultiArray<N, T> other(stop - start);
+        input2_->readBlock(start, stop, MultiArrayView<N, T>(other));
+        T const * q = other.data();
+        for(T * p = chunk.data(), * end = p + chunk.size(); p != end; ++p, ++q)
+            *p = f_(*p, *q);
+    }
+
+  private:
+    ChunkedLazyNode<N, T> * input1_, * input2_;
+    Functor f_;
+};
+
+} // namespace detail
+
+/********************************************************/
+/*                                                      */
+/*                  ChunkedLazyArray                    */
+/*                                                      */
+/********************************************************/
+
+/** \brief Handle to a chunked, lazily computed array.
+
+    A ChunkedLazyArray represents a (possibly very large) array whose
+    contents are only computed when a region is actually requested via
+    readBlock() or checkoutBlock(). Arrays are composed into filter
+    graphs: each operation (convolved(), gaussianSmoothed(),
+    transformed(), combined()) returns a new lazy array that pulls its
+    input chunk-by-chunk from its predecessor. Each graph node keeps an
+    LRU cache of computed chunks (see setCacheLimit()), so the halo
+    overlap between neighboring chunks and diamond-shaped graphs do not
+    cause repeated recomputation, while the total memory footprint stays
+    bounded no matter how large the dataset is.
+
+    Sources are created from in-memory views with
+    \ref makeChunkedLazyArray() or, for out-of-core data, from an HDF5
+    dataset with \ref makeChunkedLazyArrayHDF5() (declared in
+    \<vigra/chunked_lazy_hdf5.hxx\>). The convolution node uses the same
+    halo logic as \ref separableConvolveTiled(), so results are
+    bit-identical to the corresponding monolithic calls.
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/chunked_lazy_array.hxx\>
+
+    \code
+    MultiArray<3, float> data(Shape3(2000, 2000, 2000));
+    ...
+    ChunkedLazyArray<3, float> source =
+        makeChunkedLazyArray(data, Shape3(128, 128, 128));
+    ChunkedLazyArray<3, float> smoothed = source.gaussianSmoothed(2.0);
+
+    MultiArray<3, float> tile(Shape3(128, 128, 128));
+    smoothed.readBlock(Shape3(0,0,0), Shape3(128,128,128), tile);  // computed now
+    \endcode
+*/
+template <unsigned int N, class T>
+class ChunkedLazyArray
+{
+  public:
+    typedef ChunkedLazyNode<N, T> node_type;
+    typedef typename node_type::shape_type shape_type;
+    typedef T value_type;
+
+        /** Construct an invalid handle (isValid() returns false).
+         */
+    ChunkedLazyArray()
+    : node_(0)
+    {}
+
+        /** Construct from a node pointer, taking shared ownership.
+            Library users normally call the factory functions instead.
+         */
+    explicit ChunkedLazyArray(node_type * node)
+    : node_(node)
+    {
+        if(node_)
+            node_->incRef();
+    }
+
+    ChunkedLazyArray(ChunkedLazyArray const & other)
+    : node_(other.node_)
+    {
+        if(node_)
+            node_->incRef();
+    }
+
+    ChunkedLazyArray & operator=(ChunkedLazyArray const & other)
+    {
+        if(node_ != other.node_)
+        {
+            if(other.node_)
+                other.node_->incRef();
+            if(node_)
+                node_->decRef();
+            node_ = other.node_;
+        }
+        return *this;
+    }
+
+    ~ChunkedLazyArray()
+    {
+        if(node_)
+            node_->decRef();
+    }
+
+        /** Whether this handle refers to a node.
+         */
+    bool isValid() const
+    {
+        return node_ != 0;
+    }
+
+        /** The shape of the represented array.
+         */
+    shape_type const & shape() const
+    {
+        return node()->shape();
+    }
+
+        /** The chunk shape used for caching and lazy computation.
+         */
+    shape_type const & chunkShape() const
+    {
+        return node()->chunkShape();
+    }
+
+        /** Compute the region <tt>[start, stop)</tt> into \a dest
+            (whose shape must equal <tt>stop - start</tt>).
+         */
+    template <class Stride>
+    void readBlock(shape_type const & start, shape_type const & stop,
+                   MultiArrayView<N, T, Stride> dest) const
+    {
+        node()->readBlock(start, stop, dest);
+    }
+
+        /** Convenience variant of readBlock() that allocates and
+            returns the result array.
+         */
+    MultiArray<N, T> checkoutBlock(shape_type const & start, shape_type const & stop) const
+    {
+        MultiArray<N, T> res(stop - start);
+        node()->readBlock(start, stop, MultiArrayView<N, T>(res));
+        return res;
+    }
+
+        /** Limit the chunk cache of this array's node to the given
+            number of bytes (zero disables caching).
+         */
+    void setCacheLimit(std::size_t bytes) const
+    {
+        node()->setCacheLimit(bytes);
+    }
+
+        /** The number of bytes currently cached by this array's node.
+         */
+    std::size_t cachedBytes() const
+    {
+        return node()->cachedBytes();
+    }
+
+        /** Discard this node's cached chunks.
+         */
+    void clearCache() const
+    {
+        node()->clearCache();
+    }
+
+        /** Lazy separable convolution with one kernel per dimension.
+            Border treatments WRAP and AVOID are not supported.
+         */
+    ChunkedLazyArray convolved(ArrayVector<Kernel1D<T> > const & kernels) const
+    {
+        return ChunkedLazyArray(new detail::ChunkedLazyConvolution<N, T>(node(), kernels));
+    }
+
+        /** Lazy separable convolution with the same kernel in all dimensions.
+         */
+    ChunkedLazyArray convolved(Kernel1D<T> const & kernel) const
+    {
+        return convolved(ArrayVector<Kernel1D<T> >(N, kernel));
+    }
+
+        /** Lazy isotropic Gaussian smoothing at the given scale.
+         */
+    ChunkedLazyArray gaussianSmoothed(double sigma) const
+    {
+        Kernel1D<T> gauss;
+        gauss.initGaussian(sigma);
+        return convolved(gauss);
+    }
+
+        /** Lazy pointwise transformation; \a f must map T to T.
+         */
+    template <class Functor>
+    ChunkedLazyArray transformed(Functor const & f) const
+    {
+        return ChunkedLazyArray(new detail::ChunkedLazyTransform<N, T, Functor>(node(), f));
+    }
+
+        /** Lazy pointwise combination with \a other (of identical shape);
+            \a f must map (T, T) to T.
+         */
+    template <class Functor>
+    ChunkedLazyArray combined(ChunkedLazyArray const & other, Functor const & f) const
+    {
+        return ChunkedLazyArray(
+                  new detail::ChunkedLazyCombine<N, T, Functor>(node(), other.node(), f));
+    }
+
+        /** Access the underlying node (mainly for implementing new
+            node types).
+         */
+    node_type * node() const
+    {
+        vigra_precondition(node_ != 0,
+            "ChunkedLazyArray: handle does not refer to a node.");
+        return node_;
+    }
+
+  private:
+    node_type * node_;
+};
+
+/********************************************************/
+/*                                                      */
+/*                makeChunkedLazyArray                  */
+/*                                                      */
+/********************************************************/
+
+/** \brief Create a chunked lazy array that reads from the given view.
+
+    The view's data must remain valid for the lifetime of the returned
+    array and everything derived from it. Since the data are already in
+    memory, the source node does not cache.
+*/
+template <unsigned int N, class T, class Stride>
+ChunkedLazyArray<N, T>
+makeChunkedLazyArray(MultiArrayView<N, T, Stride> const & view,
+                     typename MultiArrayShape<N>::type const & chunkShape)
+{
+    return ChunkedLazyArray<N, T>(new detail::ChunkedLazyViewSource<N, T>(view, chunkShape));
+}
+
+//@}
+
+} // namespace vigra
+
+#endif // VIGRA_CHUNKED_LAZY_ARRAY_HXX
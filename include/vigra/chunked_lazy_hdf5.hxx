@@ -0,0 +1,123 @@
+/************************************************************************/
+/*                                                                      */
+/*               Copyright 2012 by Ullrich Koethe                       */
+/*                                                                      */
+/*    This file is part of the VIGRA computer vision library.           */
+/*    The VIGRA Website is                                              */
+/*        http://hci.iwr.uni-heidelberg.de/vigra/                       */
+/*    Please direct questions, bug reports, and contributions to        */
+/*        ullrich.koethe@iwr.uni-heidelberg.de    or                    */
+/*        vigra@informatik.uni-hamburg.de                               */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+#ifndef VIGRA_CHUNKED_LAZY_HDF5_HXX
+#define VIGRA_CHUNKED_LAZY_HDF5_HXX
+
+#include <string>
+#include "chunked_lazy_array.hxx"
+#include "hdf5impex.hxx"
+
+namespace vigra {
+
+/** \addtogroup ChunkedLazyArrays
+*/
+//@{
+
+namespace detail {
+
+    // source node reading chunks from an HDF5 dataset on demand; aligning
+    // the chunk shape with the dataset's chunk layout (see
+    // HDF5File::setChunkCache()) avoids repeated decompression
+template <unsigned int N, class T>
+class ChunkedLazyHDF5Source
+: public ChunkedLazyNode<N, T>
+{
+  public:
+    typedef ChunkedLazyNode<N, T> base_type;
+    typedef typename base_type::shape_type shape_type;
+
+    ChunkedLazyHDF5Source(HDF5File & file, std::string const & datasetName,
+                          shape_type const & shape, shape_type const & chunkShape,
+                          std::size_t cacheLimit)
+    : base_type(shape, chunkShape, cacheLimit),
+      file_(file),
+      datasetName_(datasetName)
+    {}
+
+  protected:
+    virtual void computeChunk(shape_type const & start, shape_type const & stop,
+                              MultiArrayView<N, T> & chunk)
+    {
+        file_.readBlock(datasetName_, start, stop - start, chunk);
+    }
+
+  private:
+    HDF5File & file_;
+    std::string datasetName_;
+};
+
+} // namespace detail
+
+/********************************************************/
+/*                                                      */
+/*              makeChunkedLazyArrayHDF5                */
+/*                                                      */
+/********************************************************/
+
+/** \brief Create a chunked lazy array backed by an HDF5 dataset.
+
+    Chunks are read with \ref HDF5File::readBlock() when first requested
+    and kept in the node's LRU cache (limited to \a cacheLimit bytes), so
+    a filter graph over a dataset of arbitrary size runs in bounded
+    memory. The given \a file must stay open for the lifetime of the
+    returned array and everything derived from it. The dataset's
+    dimension must equal <tt>N</tt>; for best performance, \a chunkShape
+    should be a multiple of the dataset's on-disk chunk layout.
+*/
+template <unsigned int N, class T>
+ChunkedLazyArray<N, T>
+makeChunkedLazyArrayHDF5(HDF5File & file, std::string const & datasetName,
+                         typename MultiArrayShape<N>::type const & chunkShape,
+                         std::size_t cacheLimit = ChunkedLazyNode<N, T>::defaultCacheLimit)
+{
+    ArrayVector<hsize_t> dimshape = file.getDatasetShape(datasetName);
+    vigra_precondition(dimshape.size() == N,
+        "makeChunkedLazyArrayHDF5(): dataset dimension mismatch.");
+
+    typename MultiArrayShape<N>::type shape;
+    for(unsigned int d = 0; d < N; ++d)
+        shape[d] = (MultiArrayIndex)dimshape[d];
+
+    return ChunkedLazyArray<N, T>(
+               new detail::ChunkedLazyHDF5Source<N, T>(file, datasetName,
+                                                       shape, chunkShape, cacheLimit));
+}
+
+//@}
+
+} // namespace vigra
+
+#endif // VIGRA_CHUNKED_LAZY_HDF5_HXX
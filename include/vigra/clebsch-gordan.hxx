@@ -414,10 +414,123 @@ double clebschGordan (double l1, double m1, double l2, double m2, double l3, dou
         Err << " clebschGordan: 3jM-sym error.\n";
         throw Err;
     }
-    return CG;                                                          
+    return CG;
 }
 
-} // namespace vigra 
+    /*!
+     *  \class ClebschGordanTable
+     *  \brief memoized lookup table for Clebsch-Gordan coefficients
+     *
+     * clebschGordan() evaluates a 3-j recursion on every call. Code that
+     * repeatedly combines the same small set of integer angular momenta
+     * (e.g. steerable filter construction) is better served by this table:
+     * ensureAngularMomentum() computes all coefficients with
+     * l1, l2, l3 <= l_max once (it serializes internally and is a no-op when
+     * the requested limit is already covered), after which operator() is a
+     * plain read from contiguous storage and safe for concurrent use from
+     * any number of threads.
+     *
+     * Only integer angular momenta are covered - use clebschGordan() directly
+     * for half-integer arguments. Argument combinations that violate
+     * m1 + m2 = m3 or the triangular condition yield 0.0 rather than an
+     * exception.
+     *
+     * A process-wide instance is available via ClebschGordanTable::global().
+     */
+class ClebschGordanTable
+{
+  public:
+         /*! \brief Create an empty table (angular momentum limit -1).
+          */
+    ClebschGordanTable()
+    : l_limit_(-1)
+    {}
+
+         /*! \brief Make sure all coefficients with l1, l2, l3 <= \a l_max
+          *         are available.
+          *
+          * Coefficients are computed at most once. This function must not be
+          * called concurrently with operator() on the same table.
+          */
+    void ensureAngularMomentum(int l_max)
+    {
+        vigra_precondition(l_max >= 0,
+            "ClebschGordanTable::ensureAngularMomentum(): angular momentum must be >= 0.");
+#ifdef _OPENMP
+#pragma omp critical(vigra_clebsch_gordan_table)
+#endif
+        {
+            if(l_max > l_limit_)
+            {
+                // contiguous layout: ((l1*(l1+1)+m1) * pairs + l2*(l2+1)+m2) * bands + l3
+                // with pairs = (l_max+1)^2 and bands = l_max+1, m3 = m1+m2 implied
+                int pairs = sq(l_max + 1);
+                ArrayVector<double> table((std::size_t)pairs * pairs * (l_max + 1), 0.0);
+                for(int l1 = 0; l1 <= l_max; ++l1)
+                {
+                    for(int l2 = 0; l2 <= l_max; ++l2)
+                    {
+                        for(int l3 = abs(l1 - l2); l3 <= std::min(l1 + l2, l_max); ++l3)
+                        {
+                            for(int m1 = -l1; m1 <= l1; ++m1)
+                            {
+                                for(int m2 = -l2; m2 <= l2; ++m2)
+                                {
+                                    int m3 = m1 + m2;
+                                    if(abs(m3) > l3)
+                                        continue;
+                                    std::size_t i = ((std::size_t)(l1*(l1+1) + m1) * pairs
+                                                     + l2*(l2+1) + m2) * (l_max + 1) + l3;
+                                    table[i] = clebschGordan(l1, m1, l2, m2, l3, m3);
+                                }
+                            }
+                        }
+                    }
+                }
+                table_.swap(table);
+                l_limit_ = l_max;
+            }
+        }
+    }
+
+         /*! \brief Highest angular momentum covered by the table.
+          */
+    int angularMomentumLimit() const
+    {
+        return l_limit_;
+    }
+
+         /*! \brief Look up the coefficient <l1 m1, l2 m2 | l3 m3>.
+          */
+    double operator()(int l1, int m1, int l2, int m2, int l3, int m3) const
+    {
+        vigra_precondition(l1 >= 0 && l2 >= 0 && l3 >= 0 &&
+                           l1 <= l_limit_ && l2 <= l_limit_ && l3 <= l_limit_,
+            "ClebschGordanTable::operator(): angular momentum exceeds the table limit, "
+            "call ensureAngularMomentum() first.");
+        vigra_precondition(abs(m1) <= l1 && abs(m2) <= l2 && abs(m3) <= l3,
+            "ClebschGordanTable::operator(): abs(m) must not exceed l.");
+        if(m1 + m2 != m3)
+            return 0.0;
+        int pairs = sq(l_limit_ + 1);
+        return table_[((std::size_t)(l1*(l1+1) + m1) * pairs
+                       + l2*(l2+1) + m2) * (l_limit_ + 1) + l3];
+    }
+
+         /*! \brief The process-wide table instance.
+          */
+    static ClebschGordanTable & global()
+    {
+        static ClebschGordanTable table;
+        return table;
+    }
+
+  private:
+    ArrayVector<double> table_;
+    int l_limit_;
+};
+
+} // namespace vigra
 
 #endif // VIGRA_CLEBSCH_GORDAN_HXX
 
@@ -47,6 +47,7 @@
 #ifndef VIGRA_CODEC_HXX
 #define VIGRA_CODEC_HXX
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
@@ -54,6 +55,7 @@
 #include "array_vector.hxx"
 #include "config.hxx"
 #include "diff2d.hxx"
+#include "error.hxx"
 #include "sized_int.hxx"
 
 // possible pixel types:
@@ -151,6 +153,25 @@ namespace vigra
           init(fileName);
         }
 
+        // in-memory decoding. Codecs that can parse an already encoded
+        // image from a caller-provided byte buffer override these; the
+        // buffer must stay valid until close() or abort(). Used by the
+        // memory-based getDecoder() and ImageImportInfo overloads so
+        // that images received over the network need not be written to
+        // a temporary file first.
+        virtual bool supportsMemoryInit() const
+        {
+            return false;
+        }
+
+        // initialize from size bytes of encoded image data instead of
+        // a file. Only available when supportsMemoryInit() returns true.
+        virtual void initFromMemory( const unsigned char *, std::size_t )
+        {
+            vigra_fail( "Decoder::initFromMemory(): "
+                        "codec does not support in-memory decoding." );
+        }
+
         virtual void close() = 0;
         virtual void abort() = 0;
 
@@ -200,6 +221,56 @@ namespace vigra
 
         virtual unsigned int getOffset() const = 0;
 
+        // region (ROI) reading. Codecs that can decode a rectangular
+        // region directly from the file's tiles or strips override these;
+        // the scanline interface then only delivers the region's rows
+        // and columns, so arbitrarily large images can be read with
+        // bounded memory.
+        virtual bool supportsRegionRead() const
+        {
+            return false;
+        }
+
+        // restrict subsequent nextScanline()/currentScanlineOfBand()
+        // calls to the given rectangle (must be inside the image).
+        // Only available when supportsRegionRead() returns true.
+        virtual void setRegion( const vigra::Rect2D & )
+        {
+            vigra_fail( "Decoder::setRegion(): "
+                        "codec does not support region reads." );
+        }
+
+        // direct (push-style) decoding. Codecs that can deliver decoded
+        // rows straight into caller-provided memory override these; the
+        // internal scanline staging buffer and the subsequent accessor
+        // copy in impexbase are then bypassed, saving one full copy of
+        // the image.
+        virtual bool supportsDirectRead() const
+        {
+            return false;
+        }
+
+        // decode the whole image into caller memory: row y starts at
+        // dest + y * rowStride (rowStride is given in bytes), and the
+        // samples of one row are stored interleaved in the band order
+        // of the scanline interface (getNumBands() samples per pixel).
+        // Only available for 8-bit pixel types and when
+        // supportsDirectRead() returns true; must be called instead of,
+        // not after, nextScanline().
+        virtual void readDirect( unsigned char *, std::ptrdiff_t )
+        {
+            vigra_fail( "Decoder::readDirect(): "
+                        "codec does not support direct reads." );
+        }
+
+        // set the number of worker threads used for decoding. Codecs
+        // whose underlying library has a thread pool (currently only
+        // OpenEXR) override this; all others silently ignore the
+        // setting. Must be called before the first scanline is read.
+        virtual void setNumThreads( int )
+        {
+        }
+
         virtual const void * currentScanlineOfBand( unsigned int ) const = 0;
         virtual void nextScanline() = 0;
 
@@ -256,6 +327,13 @@ namespace vigra
         {
         }
 
+        // set the number of worker threads used for encoding (see
+        // Decoder::setNumThreads()). Must be called before
+        // finalizeSettings().
+        virtual void setNumThreads( int )
+        {
+        }
+
         virtual void * currentScanlineOfBand( unsigned int ) = 0;
         virtual void nextScanline() = 0;
 
@@ -282,6 +360,9 @@ namespace vigra
     VIGRA_EXPORT VIGRA_UNIQUE_PTR<Decoder>
     getDecoder( const std::string &, const std::string & = "undefined", unsigned int = 0 );
 
+    VIGRA_EXPORT VIGRA_UNIQUE_PTR<Decoder>
+    getDecoder( const unsigned char *, std::size_t, const std::string & = "undefined" );
+
     VIGRA_EXPORT VIGRA_UNIQUE_PTR<Encoder>
     getEncoder( const std::string &, const std::string & = "undefined", const std::string & = "w" );
 
@@ -38,6 +38,7 @@
 #define VIGRA_COLORCONVERSIONS_HXX
 
 #include <cmath>
+#include <cstddef>
 #include <string>
 #include "mathutil.hxx"
 #include "rgbvalue.hxx"
@@ -89,11 +90,39 @@ inline ValueType inverse_sRGBCorrection(double value, double norm)
     typedef typename NumericTraits<ValueType>::RealPromote Promote;
     return NumericTraits<ValueType>::fromRealPromote(
              RequiresExplicitCast<ValueType>::cast(
-                (value <= 0.04045) 
+                (value <= 0.04045)
                     ? norm*value / 12.92
                     : norm*VIGRA_CSTD::pow((value + 0.055)/1.055, 2.4)));
 }
 
+// Fast cube root: polynomial seed on the reduced mantissa followed by
+// three Halley iterations. Much faster than pow(x, 1.0/3.0) and accurate
+// to a few ulps (relative error below 1e-15). Unlike pow(), it is also
+// defined for negative arguments (odd extension).
+inline double fastCbrt(double x)
+{
+    if(x == 0.0)
+        return x;
+    double ax = VIGRA_CSTD::fabs(x);
+    int e;
+    double m = VIGRA_CSTD::frexp(ax, &e);       // ax = m * 2^e, m in [0.5, 1)
+    int q = e / 3;
+    int r = e - 3*q;
+    if(r < 0)
+    {
+        r += 3;
+        --q;
+    }
+    m = VIGRA_CSTD::ldexp(m, r);                // m in [0.5, 4)
+    double y = 0.65154737 + (0.37684923 - 0.03680063*m)*m;
+    for(int k = 0; k < 3; ++k)
+    {
+        double y3 = y*y*y;
+        y = y*(y3 + 2.0*m)/(2.0*y3 + m);
+    }
+    double res = VIGRA_CSTD::ldexp(y, q);
+    return x < 0.0 ? -res : res;
+}
 
 } // namespace detail
 
@@ -2830,6 +2859,138 @@ class FunctorTraits<YPrimeCbCr2RGBPrimeFunctor<T> >
     typedef VigraTrueType isUnaryFunctor;
 };
 
+/********************************************************/
+/*                                                      */
+/*                 batch span conversions               */
+/*                                                      */
+/********************************************************/
+
+/** \brief Batch-convert a contiguous span of linear RGB pixels into CIE L*a*b*.
+
+    This function realizes the same transformation as
+    \ref vigra::RGB2LabFunctor, but processes a whole span of pixels at
+    once: all constants are hoisted out of the loop, and the per-pixel
+    <tt>pow(x, 1.0/3.0)</tt> calls are replaced by a fast cube root
+    (polynomial seed plus Halley iterations) whose relative error stays
+    below 1e-15. Source and destination pixel types only need to support
+    <tt>operator[]</tt> for the three components. For a parallel
+    image-level conversion, pass the corresponding functor to the
+    \ref vigra::ParallelOptions overload of \ref transformImage() instead.
+
+    <b> Declaration:</b>
+
+    \code
+    namespace vigra {
+        template <class SrcPixel, class DestPixel>
+        void rgb2LabSpan(SrcPixel const * rgb, std::size_t size,
+                         DestPixel * lab, double max = 255.0);
+    }
+    \endcode
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/colorconversions.hxx\><br>
+    Namespace: vigra
+
+    \code
+    vigra::BRGBImage rgb(w, h);
+    vigra::FRGBImage lab(w, h);
+
+    // convert one row at a time (rows of a BasicImage are contiguous)
+    for(int y = 0; y < h; ++y)
+        vigra::rgb2LabSpan(&rgb(0, y), w, &lab(0, y));
+    \endcode
+*/
+template <class SrcPixel, class DestPixel>
+void rgb2LabSpan(SrcPixel const * rgb, std::size_t size,
+                 DestPixel * lab, double max = 255.0)
+{
+    const double norm    = 1.0 / max;
+    const double kappa   = 24389.0/27.0;
+    const double epsilon = 216.0/24389.0;
+    for(std::size_t k = 0; k < size; ++k)
+    {
+        double red   = rgb[k][0] * norm;
+        double green = rgb[k][1] * norm;
+        double blue  = rgb[k][2] * norm;
+        double Y = 0.212671*red + 0.715160*green + 0.072169*blue;
+        double xgamma = detail::fastCbrt(
+                  (0.412453*red + 0.357580*green + 0.180423*blue) / 0.950456);
+        double ygamma = detail::fastCbrt(Y);
+        double zgamma = detail::fastCbrt(
+                  (0.019334*red + 0.119193*green + 0.950227*blue) / 1.088754);
+        lab[k][0] = Y < epsilon
+                        ? kappa * Y
+                        : 116.0 * ygamma - 16.0;
+        lab[k][1] = 500.0*(xgamma - ygamma);
+        lab[k][2] = 200.0*(ygamma - zgamma);
+    }
+}
+
+/** \brief Batch-convert a contiguous span of linear RGB pixels into CIE L*u*v*.
+
+    The span-oriented counterpart of \ref vigra::RGB2LuvFunctor,
+    analogous to \ref rgb2LabSpan(): constants are hoisted out of the
+    loop and the lightness cube root uses the same fast approximation
+    (relative error below 1e-15).
+*/
+template <class SrcPixel, class DestPixel>
+void rgb2LuvSpan(SrcPixel const * rgb, std::size_t size,
+                 DestPixel * luv, double max = 255.0)
+{
+    const double norm    = 1.0 / max;
+    const double kappa   = 24389.0/27.0;
+    const double epsilon = 216.0/24389.0;
+    for(std::size_t k = 0; k < size; ++k)
+    {
+        double red   = rgb[k][0] * norm;
+        double green = rgb[k][1] * norm;
+        double blue  = rgb[k][2] * norm;
+        double X = 0.412453*red + 0.357580*green + 0.180423*blue;
+        double Y = 0.212671*red + 0.715160*green + 0.072169*blue;
+        double Z = 0.019334*red + 0.119193*green + 0.950227*blue;
+        if(Y == 0.0)
+        {
+            luv[k][0] = 0.0;
+            luv[k][1] = 0.0;
+            luv[k][2] = 0.0;
+        }
+        else
+        {
+            double L = Y < epsilon
+                           ? kappa * Y
+                           : 116.0 * detail::fastCbrt(Y) - 16.0;
+            double denom = X + 15.0*Y + 3.0*Z;
+            luv[k][0] = L;
+            luv[k][1] = 13.0*L*(4.0*X / denom - 0.197839);
+            luv[k][2] = 13.0*L*(9.0*Y / denom - 0.468342);
+        }
+    }
+}
+
+/** \brief Batch-convert a contiguous span of non-linear R'G'B' pixels into Y'CbCr.
+
+    The span-oriented counterpart of
+    \ref vigra::RGBPrime2YPrimeCbCrFunctor. The transformation is purely
+    linear, so the loop compiles into straight-line arithmetic the
+    compiler can vectorize.
+*/
+template <class SrcPixel, class DestPixel>
+void rgbPrime2YPrimeCbCrSpan(SrcPixel const * rgb, std::size_t size,
+                             DestPixel * ycbcr, double max = 255.0)
+{
+    const double norm = 1.0 / max;
+    for(std::size_t k = 0; k < size; ++k)
+    {
+        double red   = rgb[k][0] * norm;
+        double green = rgb[k][1] * norm;
+        double blue  = rgb[k][2] * norm;
+        ycbcr[k][0] =  16.0 + 65.481*red + 128.553*green + 24.966*blue;
+        ycbcr[k][1] = 128.0 - 37.79683972*red - 74.20316028*green + 112.0*blue;
+        ycbcr[k][2] = 128.0 + 112.0*red - 93.78601998*green - 18.21398002*blue;
+    }
+}
+
 //@}
 
 /*
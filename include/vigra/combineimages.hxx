@@ -40,6 +40,8 @@
 #include "utilities.hxx"
 #include "numerictraits.hxx"
 #include "functortraits.hxx"
+#include "parallel_options.hxx"
+#include <algorithm>
 #include <cmath>
 
 namespace vigra {
@@ -153,7 +155,15 @@ combineThreeLines(SrcIterator1 s1,
                  Functor const & f)
     }
     \endcode
-    
+
+    Both variants also accept a \ref vigra::ParallelOptions argument after the
+    functor. The image rows are then partitioned among the requested number of
+    threads (provided the library is compiled with OpenMP support), and each
+    thread applies its own copy of the functor, so the functor must be
+    stateless or safely copyable. Small images fall through to the serial
+    code path automatically, because thread startup would outweigh the work.
+    The result is identical to the serial version.
+
     <b> Usage:</b>
     
         <b>\#include</b> \<vigra/combineimages.hxx\><br>
@@ -234,11 +244,82 @@ combineTwoImages(triple<SrcImageIterator1, SrcImageIterator1, SrcAccessor1> src1
              pair<DestImageIterator, DestAccessor> dest,
              Functor const & f)
 {
-    combineTwoImages(src1.first, src1.second, src1.third, 
-                     src2.first, src2.second, 
+    combineTwoImages(src1.first, src1.second, src1.third,
+                     src2.first, src2.second,
              dest.first, dest.second, f);
 }
 
+template <class SrcImageIterator1, class SrcAccessor1,
+          class SrcImageIterator2, class SrcAccessor2,
+          class DestImageIterator, class DestAccessor,
+          class Functor>
+void
+combineTwoImages(SrcImageIterator1 src1_upperleft,
+                 SrcImageIterator1 src1_lowerright, SrcAccessor1 sa1,
+                 SrcImageIterator2 src2_upperleft, SrcAccessor2 sa2,
+                 DestImageIterator dest_upperleft, DestAccessor da,
+                 Functor const & f, ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    int w = src1_lowerright.x - src1_upperleft.x;
+    int h = src1_lowerright.y - src1_upperleft.y;
+
+    // fall through to the serial version when the image is too small
+    // for thread startup to pay off
+    if(options.getNumThreads() > 1 && double(w)*double(h) >= 65536.0)
+    {
+        int stripHeight = options.getBlockSize(h);
+        int stripCount = (h + stripHeight - 1) / stripHeight;
+
+        #pragma omp parallel num_threads(options.getNumThreads())
+        {
+            Functor g(f);   // each thread applies its own functor copy
+
+            #pragma omp for schedule(dynamic)
+            for(int strip = 0; strip < stripCount; ++strip)
+            {
+                int y0 = strip * stripHeight,
+                    y1 = std::min(h, y0 + stripHeight);
+                SrcImageIterator1 s1(src1_upperleft);
+                SrcImageIterator2 s2(src2_upperleft);
+                DestImageIterator d(dest_upperleft);
+                s1.y += y0;
+                s2.y += y0;
+                d.y += y0;
+                for(int y = y0; y < y1; ++y, ++s1.y, ++s2.y, ++d.y)
+                {
+                    combineTwoLines(s1.rowIterator(), s1.rowIterator() + w, sa1,
+                                    s2.rowIterator(), sa2,
+                                    d.rowIterator(), da, g);
+                }
+            }
+        }
+        return;
+    }
+#else
+    (void)options;
+#endif
+    combineTwoImages(src1_upperleft, src1_lowerright, sa1,
+                     src2_upperleft, sa2,
+                     dest_upperleft, da, f);
+}
+
+template <class SrcImageIterator1, class SrcAccessor1,
+          class SrcImageIterator2, class SrcAccessor2,
+          class DestImageIterator, class DestAccessor,
+          class Functor>
+inline
+void
+combineTwoImages(triple<SrcImageIterator1, SrcImageIterator1, SrcAccessor1> src1,
+             pair<SrcImageIterator2, SrcAccessor2> src2,
+             pair<DestImageIterator, DestAccessor> dest,
+             Functor const & f, ParallelOptions const & options)
+{
+    combineTwoImages(src1.first, src1.second, src1.third,
+                     src2.first, src2.second,
+             dest.first, dest.second, f, options);
+}
+
 /********************************************************/
 /*                                                      */
 /*                  combineTwoImagesIf                  */
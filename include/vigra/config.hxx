@@ -109,6 +109,7 @@
     
     #if _MSC_VER >= 1600
         #define VIGRA_HAS_UNIQUE_PTR
+        #define VIGRA_HAS_RVALUE_REFERENCES
     #endif
     
     #define VIGRA_NEED_BIN_STREAMS
@@ -164,6 +165,7 @@
     
     #if defined(__GXX_EXPERIMENTAL_CXX0X__) || __cplusplus >= 201103L
         #define VIGRA_HAS_UNIQUE_PTR
+        #define VIGRA_HAS_RVALUE_REFERENCES
     #endif
 
 #endif  // __GNUC__
@@ -38,6 +38,8 @@
 #define VIGRA_CONTOURCIRCULATOR_HXX
 
 #include "pixelneighborhood.hxx"
+#include "basicimage.hxx"
+#include "array_vector.hxx"
 
 namespace vigra
 {
@@ -232,6 +234,197 @@ public:
         { return neighborCirc_.diff(); }
 };
 
+/********************************************************/
+/*                                                      */
+/*                   extractContours                    */
+/*                                                      */
+/********************************************************/
+
+/** \brief Extract all region contours of a label image in a single raster scan.
+
+    The function traces the <em>crack contours</em> of all regions
+    (8-connected components of pixels with the same value, see
+    \ref vigra::CrackContourCirculator) of the given label image. A contour
+    start is detected whenever the raster scan encounters a crack edge
+    between differing labels that has not been visited by a previous trace,
+    so every contour is found and traced exactly once, regardless of the
+    number of regions. A region with holes gives rise to one outer contour
+    and one contour per hole.
+
+    The contours are returned as packed polygon buffers: the corners of
+    contour <tt>i</tt> (<tt>0...N-1</tt> with <tt>N</tt> the return value)
+    are the closed polygon
+
+    \code
+    points[contourOffsets[i]] ... points[contourOffsets[i+1] - 1]
+    \endcode
+
+    (the first corner is <em>not</em> repeated at the end), and
+    <tt>contourLabels[i]</tt> holds the label of the region the contour
+    belongs to. Corner coordinates refer to the crack grid of the input
+    image, i.e. corner <tt>(x, y)</tt> is the upper left corner of pixel
+    <tt>(x, y)</tt>. The output arrays are cleared before use; they must
+    support <tt>push_back()</tt> and hold \ref vigra::Point2D,
+    <tt>unsigned int</tt>, and label values, respectively
+    (e.g. <tt>ArrayVector</tt>).
+
+    Internally, the image is copied into a frame of one pixel width filled
+    with \a boundaryLabel, so that regions touching the image border are
+    traced along the border without leaving valid memory. Therefore
+    \a boundaryLabel must differ from all labels occurring on the image
+    border (contours of the virtual boundary region itself are not
+    reported).
+
+    <b> Declarations:</b>
+
+    pass arguments explicitly:
+    \code
+    namespace vigra {
+        template <class SrcIterator, class SrcAccessor,
+                  class PointArray, class IndexArray, class LabelArray>
+        unsigned int
+        extractContours(SrcIterator ul, SrcIterator lr, SrcAccessor sa,
+                        PointArray & points, IndexArray & contourOffsets,
+                        LabelArray & contourLabels,
+                        typename SrcAccessor::value_type boundaryLabel);
+    }
+    \endcode
+
+    use argument objects in conjunction with \ref ArgumentObjectFactories :
+    \code
+    namespace vigra {
+        template <class SrcIterator, class SrcAccessor,
+                  class PointArray, class IndexArray, class LabelArray>
+        unsigned int
+        extractContours(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                        PointArray & points, IndexArray & contourOffsets,
+                        LabelArray & contourLabels,
+                        typename SrcAccessor::value_type boundaryLabel);
+    }
+    \endcode
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/contourcirculator.hxx\><br>
+    Namespace: vigra
+
+    \code
+    vigra::IImage labels(w, h);
+    ...  // e.g. result of labelImage()
+
+    vigra::ArrayVector<vigra::Point2D> points;
+    vigra::ArrayVector<unsigned int> contourOffsets;
+    vigra::ArrayVector<int> contourLabels;
+
+    // labelImage() labels start at 1, so 0 is a safe boundary label
+    unsigned int count = vigra::extractContours(srcImageRange(labels),
+                                                points, contourOffsets,
+                                                contourLabels, 0);
+
+    for(unsigned int i = 0; i < count; ++i)
+    {
+        // the corners of the i-th contour
+        for(unsigned int k = contourOffsets[i]; k < contourOffsets[i+1]; ++k)
+            ... points[k] ...
+    }
+    \endcode
+*/
+doxygen_overloaded_function(template <...> unsigned int extractContours)
+
+template <class SrcIterator, class SrcAccessor,
+          class PointArray, class IndexArray, class LabelArray>
+unsigned int
+extractContours(SrcIterator ul, SrcIterator lr, SrcAccessor sa,
+                PointArray & points, IndexArray & contourOffsets,
+                LabelArray & contourLabels,
+                typename SrcAccessor::value_type boundaryLabel)
+{
+    typedef typename SrcAccessor::value_type LabelType;
+    typedef typename BasicImage<LabelType>::traverser LabelTraverser;
+
+    int w = lr.x - ul.x, h = lr.y - ul.y;
+
+    points.clear();
+    contourOffsets.clear();
+    contourLabels.clear();
+    contourOffsets.push_back(0u);
+    if(w <= 0 || h <= 0)
+        return 0;
+
+    // copy the labels into a padded image so that the circulator never
+    // leaves valid memory when a region touches the image border
+    BasicImage<LabelType> labels(w+2, h+2, boundaryLabel);
+    {
+        SrcIterator row(ul);
+        for(int y = 0; y < h; ++y, ++row.y)
+        {
+            SrcIterator col(row);
+            for(int x = 0; x < w; ++x, ++col.x)
+            {
+                if(x == 0 || x == w-1 || y == 0 || y == h-1)
+                    vigra_precondition(sa(col) != boundaryLabel,
+                        "extractContours(): boundaryLabel must differ from all labels on the image border.");
+                labels(x+1, y+1) = sa(col);
+            }
+        }
+    }
+
+    // visited vertical crack edges whose east pixel belongs to the traced
+    // region -- the raster scan detects contour starts at exactly these
+    // edges, so marking them suppresses duplicate traces
+    int markStride = w + 3;
+    ArrayVector<unsigned char> mark(markStride * (h + 2), (unsigned char)0);
+
+    for(int y = 1; y <= h; ++y)
+    {
+        for(int x = 1; x <= w; ++x)
+        {
+            LabelType label = labels(x, y);
+            if(label == labels(x-1, y) || mark[x + y*markStride] != 0)
+                continue;
+
+            // new contour: the crack edge to the left of (x, y) separates
+            // the region from a differently labeled west neighbor
+            CrackContourCirculator<LabelTraverser> circ(labels.upperLeft() + Diff2D(x, y)),
+                                                   end(circ);
+            do
+            {
+                // the first corner is the upper left corner of pixel (x, y),
+                // i.e. corner (x-1, y-1) in unpadded crack coordinates
+                points.push_back(Point2D(x - 1 + circ.pos().x, y - 1 + circ.pos().y));
+
+                Diff2D step = circ.diff();
+                if(step.x == 0)
+                {
+                    // vertical crack edge: mark it when the region is its
+                    // east neighbor
+                    int ex = x + circ.pos().x,
+                        ey = y + (step.y < 0 ? circ.pos().y - 1 : circ.pos().y);
+                    if(labels(ex, ey) == label)
+                        mark[ex + ey*markStride] = 1;
+                }
+            }
+            while(++circ != end);
+
+            contourOffsets.push_back((unsigned int)points.size());
+            contourLabels.push_back(label);
+        }
+    }
+    return (unsigned int)contourLabels.size();
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class PointArray, class IndexArray, class LabelArray>
+inline unsigned int
+extractContours(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                PointArray & points, IndexArray & contourOffsets,
+                LabelArray & contourLabels,
+                typename SrcAccessor::value_type boundaryLabel)
+{
+    return extractContours(src.first, src.second, src.third,
+                           points, contourOffsets, contourLabels, boundaryLabel);
+}
+
 //@}
 
 } // namespace vigra
@@ -43,6 +43,7 @@
 #include "recursiveconvolution.hxx"
 #include "nonlineardiffusion.hxx"
 #include "combineimages.hxx"
+#include "parallel_options.hxx"
 
 /** \page Convolution Functions to Convolve Images and Signals
 
@@ -510,9 +511,14 @@ void gaussianSharpening(triple<SrcIterator, SrcIterator, SrcAccessor> src,
 
     This function is a shorthand for the concatenation of a call to
     \ref separableConvolveX() and \ref separableConvolveY() with a
-    Gaussian kernel of the given scale. If two scales are provided, 
-    smoothing in x and y direction will have different strength. 
-    The function uses <TT>BORDER_TREATMENT_REFLECT</TT>. 
+    Gaussian kernel of the given scale. If two scales are provided,
+    smoothing in x and y direction will have different strength.
+    The function uses <TT>BORDER_TREATMENT_REFLECT</TT>.
+
+    Overloads with a trailing \ref vigra::GaussianFilterMode argument can
+    opt into the recursive Young/van Vliet approximation
+    (<tt>GAUSSIAN_RECURSIVE</tt>), whose cost per pixel is independent of
+    the scale -- this is much faster for large scales.
 
     <b> Declarations:</b>
 
@@ -616,6 +622,67 @@ gaussianSmoothing(triple<SrcIterator, SrcIterator, SrcAccessor> src,
                       dest.first, dest.second, scale, scale);
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void
+gaussianSmoothing(SrcIterator supperleft, SrcIterator slowerright, SrcAccessor sa,
+                  DestIterator dupperleft, DestAccessor da,
+                  double scale_x, double scale_y, GaussianFilterMode mode)
+{
+    if(mode == GAUSSIAN_FIR)
+    {
+        gaussianSmoothing(supperleft, slowerright, sa,
+                          dupperleft, da,
+                          scale_x, scale_y);
+        return;
+    }
+
+    // recursive approximation: cost per pixel is independent of the scale
+    typedef typename
+        NumericTraits<typename SrcAccessor::value_type>::RealPromote
+        TmpType;
+    BasicImage<TmpType> tmp(slowerright - supperleft, SkipInitialization);
+
+    recursiveGaussianFilterX(srcIterRange(supperleft, slowerright, sa),
+                             destImage(tmp), scale_x);
+    recursiveGaussianFilterY(srcImageRange(tmp),
+                             destIter(dupperleft, da), scale_y);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void
+gaussianSmoothing(SrcIterator supperleft, SrcIterator slowerright, SrcAccessor sa,
+                  DestIterator dupperleft, DestAccessor da,
+                  double scale, GaussianFilterMode mode)
+{
+    gaussianSmoothing(supperleft, slowerright, sa,
+                      dupperleft, da,
+                      scale, scale, mode);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void
+gaussianSmoothing(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                  pair<DestIterator, DestAccessor> dest,
+                  double scale_x, double scale_y, GaussianFilterMode mode)
+{
+    gaussianSmoothing(src.first, src.second, src.third,
+                      dest.first, dest.second, scale_x, scale_y, mode);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void
+gaussianSmoothing(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                  pair<DestIterator, DestAccessor> dest,
+                  double scale, GaussianFilterMode mode)
+{
+    gaussianSmoothing(src.first, src.second, src.third,
+                      dest.first, dest.second, scale, scale, mode);
+}
+
 /********************************************************/
 /*                                                      */
 /*                     gaussianGradient                 */
@@ -762,6 +829,80 @@ gaussianGradient(triple<SrcIterator, SrcIterator, SrcAccessor> src,
                      dest.first, dest.second, scale);
 }
 
+/** \brief Parallel variant of \ref gaussianGradient().
+
+    This overload takes a \ref vigra::ParallelOptions object and computes
+    the same result as the serial version. The x- and y-derivative each
+    require two separable convolution passes, and the two pipelines are
+    independent of each other, so they run concurrently when the library
+    is compiled with OpenMP support. Small thread counts fall through to
+    the serial code path (which also needs one less intermediate image).
+*/
+template <class SrcIterator, class SrcAccessor,
+          class DestIteratorX, class DestAccessorX,
+          class DestIteratorY, class DestAccessorY>
+void gaussianGradient(SrcIterator supperleft,
+                        SrcIterator slowerright, SrcAccessor sa,
+                        DestIteratorX dupperleftx, DestAccessorX dax,
+                        DestIteratorY dupperlefty, DestAccessorY day,
+                        double scale, ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    if(options.getNumThreads() > 1)
+    {
+        typedef typename
+            NumericTraits<typename SrcAccessor::value_type>::RealPromote
+            TmpType;
+
+        // each derivative pipeline needs its own intermediate image
+        BasicImage<TmpType> tmpx(slowerright - supperleft, SkipInitialization),
+                            tmpy(slowerright - supperleft, SkipInitialization);
+
+        Kernel1D<double> smooth, grad;
+        smooth.initGaussian(scale);
+        grad.initGaussianDerivative(scale, 1);
+
+        // the x- and y-derivative pipelines are independent of each other
+        #pragma omp parallel sections num_threads(options.getNumThreads())
+        {
+            #pragma omp section
+            {
+                separableConvolveX(srcIterRange(supperleft, slowerright, sa),
+                                   destImage(tmpx), kernel1d(grad));
+                separableConvolveY(srcImageRange(tmpx),
+                                   destIter(dupperleftx, dax), kernel1d(smooth));
+            }
+            #pragma omp section
+            {
+                separableConvolveX(srcIterRange(supperleft, slowerright, sa),
+                                   destImage(tmpy), kernel1d(smooth));
+                separableConvolveY(srcImageRange(tmpy),
+                                   destIter(dupperlefty, day), kernel1d(grad));
+            }
+        }
+        return;
+    }
+#else
+    (void)options;
+#endif
+    gaussianGradient(supperleft, slowerright, sa,
+                     dupperleftx, dax, dupperlefty, day, scale);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIteratorX, class DestAccessorX,
+          class DestIteratorY, class DestAccessorY>
+inline void
+gaussianGradient(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                 pair<DestIteratorX, DestAccessorX> destx,
+                 pair<DestIteratorY, DestAccessorY> desty,
+                 double scale, ParallelOptions const & options)
+{
+    gaussianGradient(src.first, src.second, src.third,
+                 destx.first, destx.second, desty.first, desty.second,
+                 scale, options);
+}
+
 /** \brief Calculate the gradient magnitude by means of a 1st derivatives of
     Gaussian filter.
 
@@ -841,6 +982,54 @@ gaussianGradientMagnitude(triple<SrcIterator, SrcIterator, SrcAccessor> src,
                               dest.first, dest.second, scale);
 }
 
+/** \brief Parallel variant of \ref gaussianGradientMagnitude().
+
+    This overload takes a \ref vigra::ParallelOptions object and computes
+    the same result as the serial version: the two derivative images are
+    computed concurrently by the parallel \ref gaussianGradient(), and the
+    final magnitude is merged in a parallel row-wise pass over the dense
+    intermediate images (see \ref combineTwoImages()).
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/convolution.hxx\>
+
+    \code
+    vigra::FImage src(w,h), grad(w,h);
+    ...
+
+    // calculate gradient magnitude at scale = 3.0, using 4 threads
+    vigra::gaussianGradientMagnitude(srcImageRange(src), destImage(grad), 3.0,
+                                     vigra::ParallelOptions().numThreads(4));
+    \endcode
+*/
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void gaussianGradientMagnitude(SrcIterator sul,
+                               SrcIterator slr, SrcAccessor src,
+                               DestIterator dupperleft, DestAccessor dest,
+                               double scale, ParallelOptions const & options)
+{
+    typedef typename NumericTraits<typename SrcAccessor::value_type>::RealPromote TmpType;
+    BasicImage<TmpType> gradx(slr-sul, SkipInitialization), grady(slr-sul, SkipInitialization);
+
+    gaussianGradient(srcIterRange(sul, slr, src),
+                     destImage(gradx), destImage(grady), scale, options);
+    combineTwoImages(srcImageRange(gradx), srcImage(grady), destIter(dupperleft, dest),
+                     MagnitudeFunctor<TmpType>(), options);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void
+gaussianGradientMagnitude(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                          pair<DestIterator, DestAccessor> dest,
+                          double scale, ParallelOptions const & options)
+{
+    gaussianGradientMagnitude(src.first, src.second, src.third,
+                              dest.first, dest.second, scale, options);
+}
+
 /********************************************************/
 /*                                                      */
 /*                 laplacianOfGaussian                  */
@@ -1238,6 +1427,124 @@ structureTensor(triple<SrcIterator, SrcIterator, SrcAccessor> src,
                  inner_scale, outer_scale);
 }
 
+/** \brief Parallel variant of \ref structureTensor().
+
+    This overload takes a \ref vigra::ParallelOptions object and computes
+    the same result as the serial version. The gradient at the inner scale
+    is computed once by the parallel \ref gaussianGradient() and shared by
+    all three tensor channels. The three outer smoothing pipelines (one
+    per product of derivatives) are independent of each other and run
+    concurrently when the library is compiled with OpenMP support.
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/convolution.hxx\>
+
+    \code
+    vigra::FImage src(w,h),
+                  stxx(w,h), stxy(w,h), styy(w,h);
+    ...
+
+    // calculate Structure Tensor at inner scale = 1.0 and outer scale = 3.0,
+    // using 4 threads
+    vigra::structureTensor(srcImageRange(src),
+                           destImage(stxx), destImage(stxy), destImage(styy),
+                           1.0, 3.0, vigra::ParallelOptions().numThreads(4));
+    \endcode
+*/
+template <class SrcIterator, class SrcAccessor,
+          class DestIteratorX, class DestAccessorX,
+          class DestIteratorXY, class DestAccessorXY,
+          class DestIteratorY, class DestAccessorY>
+void structureTensor(SrcIterator supperleft,
+                        SrcIterator slowerright, SrcAccessor sa,
+                        DestIteratorX dupperleftx, DestAccessorX dax,
+                        DestIteratorXY dupperleftxy, DestAccessorXY daxy,
+                        DestIteratorY dupperlefty, DestAccessorY day,
+                        double inner_scale, double outer_scale,
+                        ParallelOptions const & options)
+{
+    typedef typename
+        NumericTraits<typename SrcAccessor::value_type>::RealPromote
+        TmpType;
+    BasicImage<TmpType> tmpx(slowerright - supperleft, SkipInitialization),
+                        tmpy(slowerright - supperleft, SkipInitialization);
+
+    // the gradient at the inner scale is shared by all three channels;
+    // its two derivative pipelines already run concurrently
+    gaussianGradient(srcIterRange(supperleft, slowerright, sa),
+           destImage(tmpx), destImage(tmpy), inner_scale, options);
+
+#ifdef _OPENMP
+    if(options.getNumThreads() > 1)
+    {
+        // the three product/smoothing pipelines are independent of each
+        // other, but each needs its own intermediate image
+        #pragma omp parallel sections num_threads(options.getNumThreads())
+        {
+            #pragma omp section
+            {
+                BasicImage<TmpType> tmp(slowerright - supperleft, SkipInitialization);
+                combineTwoImages(srcImageRange(tmpx), srcImage(tmpx),
+                                 destImage(tmp), std::multiplies<TmpType>());
+                gaussianSmoothing(srcImageRange(tmp),
+                                  destIter(dupperleftx, dax), outer_scale);
+            }
+            #pragma omp section
+            {
+                BasicImage<TmpType> tmp(slowerright - supperleft, SkipInitialization);
+                combineTwoImages(srcImageRange(tmpy), srcImage(tmpy),
+                                 destImage(tmp), std::multiplies<TmpType>());
+                gaussianSmoothing(srcImageRange(tmp),
+                                  destIter(dupperlefty, day), outer_scale);
+            }
+            #pragma omp section
+            {
+                BasicImage<TmpType> tmp(slowerright - supperleft, SkipInitialization);
+                combineTwoImages(srcImageRange(tmpx), srcImage(tmpy),
+                                 destImage(tmp), std::multiplies<TmpType>());
+                gaussianSmoothing(srcImageRange(tmp),
+                                  destIter(dupperleftxy, daxy), outer_scale);
+            }
+        }
+        return;
+    }
+#endif
+    BasicImage<TmpType> tmp(slowerright - supperleft, SkipInitialization);
+
+    combineTwoImages(srcImageRange(tmpx), srcImage(tmpx),
+                     destImage(tmp), std::multiplies<TmpType>());
+    gaussianSmoothing(srcImageRange(tmp),
+                      destIter(dupperleftx, dax), outer_scale);
+    combineTwoImages(srcImageRange(tmpy), srcImage(tmpy),
+                     destImage(tmp), std::multiplies<TmpType>());
+    gaussianSmoothing(srcImageRange(tmp),
+                      destIter(dupperlefty, day), outer_scale);
+    combineTwoImages(srcImageRange(tmpx), srcImage(tmpy),
+                     destImage(tmp), std::multiplies<TmpType>());
+    gaussianSmoothing(srcImageRange(tmp),
+                      destIter(dupperleftxy, daxy), outer_scale);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIteratorX, class DestAccessorX,
+          class DestIteratorXY, class DestAccessorXY,
+          class DestIteratorY, class DestAccessorY>
+inline void
+structureTensor(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                  pair<DestIteratorX, DestAccessorX> destx,
+                  pair<DestIteratorXY, DestAccessorXY> destxy,
+                  pair<DestIteratorY, DestAccessorY> desty,
+                  double inner_scale, double outer_scale,
+                  ParallelOptions const & options)
+{
+    structureTensor(src.first, src.second, src.third,
+                 destx.first, destx.second,
+                 destxy.first, destxy.second,
+                 desty.first, desty.second,
+                 inner_scale, outer_scale, options);
+}
+
 namespace detail {
 
 template <class SrcIterator, class SrcAccessor,
@@ -1284,6 +1591,52 @@ void structureTensor(SrcIterator supperleft,
     }
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void structureTensor(SrcIterator supperleft,
+                     SrcIterator slowerright, SrcAccessor src,
+                     DestIterator dupperleft, DestAccessor dest,
+                     double inner_scale, double outer_scale,
+                     ParallelOptions const & options,
+                     VigraTrueType /* isScalar */)
+{
+    typedef VectorElementAccessor<DestAccessor> DA;
+    structureTensor(supperleft, slowerright, src,
+                    dupperleft, DA(0, dest),
+                    dupperleft, DA(1, dest),
+                    dupperleft, DA(2, dest),
+                    inner_scale, outer_scale, options);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void structureTensor(SrcIterator supperleft,
+                     SrcIterator slowerright, SrcAccessor src,
+                     DestIterator dupperleft, DestAccessor dest,
+                     double inner_scale, double outer_scale,
+                     ParallelOptions const & options,
+                     VigraFalseType /* isScalar */)
+{
+    int bands = src.size(supperleft);
+    typedef VectorElementAccessor<SrcAccessor> SA;
+
+    structureTensor(supperleft, slowerright, SA(0, src),
+                    dupperleft, dest,
+                    inner_scale, outer_scale, options,
+                    VigraTrueType() /* isScalar */);
+
+    BasicImage<typename DestAccessor::value_type> st(slowerright - supperleft, SkipInitialization);
+    for(int k=1; k < bands; ++k)
+    {
+        structureTensor(supperleft, slowerright, SA(k, src),
+                        st.upperLeft(), st.accessor(),
+                        inner_scale, outer_scale, options,
+                        VigraTrueType() /* isScalar */);
+        combineTwoImages(srcImageRange(st), srcIter(dupperleft, dest), destIter(dupperleft, dest),
+                         std::plus<typename DestAccessor::value_type>(), options);
+    }
+}
+
 } // namespace detail
 
 template <class SrcIterator, class SrcAccessor,
@@ -1311,6 +1664,34 @@ structureTensor(triple<SrcIterator, SrcIterator, SrcAccessor> src,
                     inner_scale, outer_scale);
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void structureTensor(SrcIterator supperleft,
+                        SrcIterator slowerright, SrcAccessor src,
+                        DestIterator dupperleft, DestAccessor dest,
+                        double inner_scale, double outer_scale,
+                        ParallelOptions const & options)
+{
+    typedef typename
+        NumericTraits<typename SrcAccessor::value_type>::isScalar isScalar;
+    detail::structureTensor(supperleft, slowerright, src,
+                            dupperleft, dest, inner_scale, outer_scale,
+                            options, isScalar());
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void
+structureTensor(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                  pair<DestIterator, DestAccessor> dest,
+                  double inner_scale, double outer_scale,
+                  ParallelOptions const & options)
+{
+    structureTensor(src.first, src.second, src.third,
+                    dest.first, dest.second,
+                    inner_scale, outer_scale, options);
+}
+
 //@}
 
 } // namespace vigra
@@ -37,10 +37,40 @@
 #ifndef VIGRA_COPYIMAGE_HXX
 #define VIGRA_COPYIMAGE_HXX
 
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
 #include "utilities.hxx"
+#include "accessor.hxx"
+#include "rgbvalue.hxx"
+#include "metaprogramming.hxx"
+#include "numerictraits.hxx"
+#include "iteratortraits.hxx"
+#include "parallel_options.hxx"
 
 namespace vigra {
 
+namespace detail {
+
+// Copy a contiguous span, degenerating into memcpy() when source and
+// destination have the same POD element type.
+template <class T1, class T2>
+inline void
+copyContiguousLine(T1 const * s, std::ptrdiff_t n, T2 * d, VigraFalseType /* useMemcpy */)
+{
+    for(std::ptrdiff_t k = 0; k < n; ++k)
+        d[k] = RequiresExplicitCast<T2>::cast(s[k]);
+}
+
+template <class T>
+inline void
+copyContiguousLine(T const * s, std::ptrdiff_t n, T * d, VigraTrueType /* useMemcpy */)
+{
+    std::memcpy(d, s, n*sizeof(T));
+}
+
+} // namespace detail
+
 /** \addtogroup CopyAlgo Algorithms to Copy Images
     Copy images or regions
 */
@@ -55,7 +85,7 @@ namespace vigra {
 template <class SrcIterator, class SrcAccessor,
           class DestIterator, class DestAccessor>
 void
-copyLine(SrcIterator s, 
+copyLine(SrcIterator s,
          SrcIterator send, SrcAccessor src,
          DestIterator d, DestAccessor dest)
 {
@@ -63,6 +93,37 @@ copyLine(SrcIterator s,
         dest.set(src(s), d);
 }
 
+    // fast paths for contiguous scalar rows with the standard accessors:
+    // same-type rows degenerate into memcpy()
+template <class T>
+inline void
+copyLine(T const * s, T const * send, StandardConstValueAccessor<T>,
+         T * d, StandardValueAccessor<T>)
+{
+    detail::copyContiguousLine(s, send - s, d, typename TypeTraits<T>::isPOD());
+}
+
+template <class T>
+inline void
+copyLine(T const * s, T const * send, StandardConstAccessor<T>,
+         T * d, StandardAccessor<T>)
+{
+    detail::copyContiguousLine(s, send - s, d, typename TypeTraits<T>::isPOD());
+}
+
+    // rows of identically ordered RGB pixels need no per-channel
+    // accessor indirection -- plain assignments let the compiler emit
+    // wide moves; channel-swizzling copies keep the generic path above
+template <class V, unsigned int R, unsigned int G, unsigned int B>
+inline void
+copyLine(RGBValue<V, R, G, B> const * s, RGBValue<V, R, G, B> const * send,
+         RGBAccessor<RGBValue<V, R, G, B> >,
+         RGBValue<V, R, G, B> * d, RGBAccessor<RGBValue<V, R, G, B> >)
+{
+    for(; s != send; ++s, ++d)
+        *d = *s;
+}
+
 template <class SrcIterator, class SrcAccessor,
           class MaskIterator, class MaskAccessor, 
           class DestIterator, class DestAccessor>
@@ -102,22 +163,37 @@ swapLine(SrcIterator s,
 
     If necessary, type conversion takes place.
     The function uses accessors to access the pixel data.
-    
+
+    Rows of contiguous scalar images accessed through the standard
+    accessors are copied with memcpy() instead of the per-pixel accessor
+    indirection. The variants taking a \ref vigra::ParallelOptions
+    argument additionally distribute the rows over horizontal strips when
+    VIGRA was compiled with OpenMP support; small images are copied
+    serially, and results are identical in either case.
+
     <b> Declarations:</b>
-    
+
     pass arguments explicitly:
     \code
     namespace vigra {
         template <class SrcImageIterator, class SrcAccessor,
               class DestImageIterator, class DestAccessor>
         void
-        copyImage(SrcImageIterator src_upperleft, 
+        copyImage(SrcImageIterator src_upperleft,
               SrcImageIterator src_lowerright, SrcAccessor sa,
               DestImageIterator dest_upperleft, DestAccessor da)
+
+        template <class SrcImageIterator, class SrcAccessor,
+              class DestImageIterator, class DestAccessor>
+        void
+        copyImage(SrcImageIterator src_upperleft,
+              SrcImageIterator src_lowerright, SrcAccessor sa,
+              DestImageIterator dest_upperleft, DestAccessor da,
+              ParallelOptions const & options)
     }
     \endcode
-    
-    
+
+
     use argument objects in conjunction with \ref ArgumentObjectFactories :
     \code
     namespace vigra {
@@ -126,6 +202,13 @@ swapLine(SrcIterator s,
         void
         copyImage(triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
               pair<DestImageIterator, DestAccessor> dest)
+
+        template <class SrcImageIterator, class SrcAccessor,
+              class DestImageIterator, class DestAccessor>
+        void
+        copyImage(triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
+              pair<DestImageIterator, DestAccessor> dest,
+              ParallelOptions const & options)
     }
     \endcode
     
@@ -160,16 +243,29 @@ doxygen_overloaded_function(template <...> void copyImage)
 template <class SrcImageIterator, class SrcAccessor,
           class DestImageIterator, class DestAccessor>
 void
-copyImage(SrcImageIterator src_upperleft, 
+copyImage(SrcImageIterator src_upperleft,
           SrcImageIterator src_lowerright, SrcAccessor sa,
           DestImageIterator dest_upperleft, DestAccessor da)
 {
     int w = src_lowerright.x - src_upperleft.x;
-    
+    int h = src_lowerright.y - src_upperleft.y;
+
+    // when both images are contiguous in memory, copy all pixels in a
+    // single fused copyLine() call (which may degenerate into one big
+    // memcpy()) instead of row by row
+    if(detail::contiguousImageRows(src_upperleft, w, h, src_upperleft.rowIterator()) &&
+       detail::contiguousImageRows(dest_upperleft, w, h, dest_upperleft.rowIterator()))
+    {
+        copyLine(src_upperleft.rowIterator(),
+                 src_upperleft.rowIterator() + std::ptrdiff_t(w)*h, sa,
+                 dest_upperleft.rowIterator(), da);
+        return;
+    }
+
     for(; src_upperleft.y<src_lowerright.y; ++src_upperleft.y, ++dest_upperleft.y)
     {
-        copyLine(src_upperleft.rowIterator(), 
-                 src_upperleft.rowIterator() + w, sa, 
+        copyLine(src_upperleft.rowIterator(),
+                 src_upperleft.rowIterator() + w, sa,
                  dest_upperleft.rowIterator(), da);
     }
 }
@@ -181,10 +277,64 @@ void
 copyImage(triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
       pair<DestImageIterator, DestAccessor> dest)
 {
-    copyImage(src.first, src.second, src.third, 
+    copyImage(src.first, src.second, src.third,
                    dest.first, dest.second);
 }
 
+template <class SrcImageIterator, class SrcAccessor,
+          class DestImageIterator, class DestAccessor>
+void
+copyImage(SrcImageIterator src_upperleft,
+          SrcImageIterator src_lowerright, SrcAccessor sa,
+          DestImageIterator dest_upperleft, DestAccessor da,
+          ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    int w = src_lowerright.x - src_upperleft.x;
+    int h = src_lowerright.y - src_upperleft.y;
+
+    if(options.getNumThreads() > 1 && double(w)*double(h) >= 65536.0)
+    {
+        int stripHeight = options.getBlockSize(h);
+        int stripCount = (h + stripHeight - 1) / stripHeight;
+
+        #pragma omp parallel num_threads(options.getNumThreads())
+        {
+            #pragma omp for schedule(dynamic)
+            for(int strip = 0; strip < stripCount; ++strip)
+            {
+                int y0 = strip * stripHeight;
+                int y1 = std::min(h, y0 + stripHeight);
+
+                SrcImageIterator s(src_upperleft);
+                DestImageIterator d(dest_upperleft);
+                s.y += y0;
+                d.y += y0;
+                for(int y = y0; y < y1; ++y, ++s.y, ++d.y)
+                    copyLine(s.rowIterator(), s.rowIterator() + w, sa,
+                             d.rowIterator(), da);
+            }
+        }
+        return;
+    }
+#else
+    (void)options;
+#endif
+    copyImage(src_upperleft, src_lowerright, sa, dest_upperleft, da);
+}
+
+template <class SrcImageIterator, class SrcAccessor,
+          class DestImageIterator, class DestAccessor>
+inline
+void
+copyImage(triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
+      pair<DestImageIterator, DestAccessor> dest,
+      ParallelOptions const & options)
+{
+    copyImage(src.first, src.second, src.third,
+              dest.first, dest.second, options);
+}
+
 template <class SrcImageIterator, class SrcAccessor,
           class DestImageIterator, class DestAccessor>
 void
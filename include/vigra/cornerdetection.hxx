@@ -37,12 +37,15 @@
 #ifndef VIGRA_CORNERDETECTION_HXX
 #define VIGRA_CORNERDETECTION_HXX
 
+#include <algorithm> // min(), max()
 #include "utilities.hxx"
 #include "numerictraits.hxx"
 #include "stdimage.hxx"
+#include "copyimage.hxx"
 #include "combineimages.hxx"
 #include "convolution.hxx"
 #include "functortraits.hxx"
+#include "parallel_options.hxx"
 
 namespace vigra {
 
@@ -130,12 +133,409 @@ class FunctorTraits<BeaudetCornerFunctor<T> >
     typedef VigraTrueType isTernaryFunctor;
 };
 
+namespace detail {
+
+template <class SrcIterator, class SrcAccessor, class TmpType>
+void structureTensorStrip(SrcIterator sul, SrcAccessor as,
+                          int w, int h, int y0, int y1, double scale,
+                          BasicImage<TmpType> & stxx,
+                          BasicImage<TmpType> & stxy,
+                          BasicImage<TmpType> & styy)
+{
+    Kernel1D<double> smooth, deriv;
+    smooth.initGaussian(scale);
+    deriv.initGaussianDerivative(scale, 1);
+
+    // The strip is expanded by the radius of the outer smoothing plus the
+    // radius of the gradient filters. Since the horizontal convolution
+    // passes operate on entire rows, all rows that are eventually kept
+    // receive exactly the same values as in a whole-image computation.
+    int ro = smooth.right();
+    int ri = std::max(smooth.right(), deriv.right());
+    int py0 = std::max(0, y0 - ro);
+    int py1 = std::min(h, y1 + ro);
+    int gy0 = std::max(0, py0 - ri);
+    int gy1 = std::min(h, py1 + ri);
+
+    BasicImage<TmpType> tmpx(w, gy1 - gy0, SkipInitialization),
+                        tmpy(w, gy1 - gy0, SkipInitialization);
+    gaussianGradient(srcIterRange(sul + Diff2D(0, gy0), sul + Diff2D(w, gy1), as),
+                     destImage(tmpx), destImage(tmpy), scale);
+
+    BasicImage<TmpType> prod(w, py1 - py0, SkipInitialization),
+                        smoothed(w, py1 - py0, SkipInitialization);
+
+    combineTwoImages(srcIterRange(tmpx.upperLeft() + Diff2D(0, py0 - gy0),
+                                  tmpx.upperLeft() + Diff2D(w, py1 - gy0), tmpx.accessor()),
+                     srcIter(tmpx.upperLeft() + Diff2D(0, py0 - gy0)),
+                     destImage(prod), std::multiplies<TmpType>());
+    gaussianSmoothing(srcImageRange(prod), destImage(smoothed), scale);
+    copyImage(srcIterRange(smoothed.upperLeft() + Diff2D(0, y0 - py0),
+                           smoothed.upperLeft() + Diff2D(w, y1 - py0), smoothed.accessor()),
+              destIter(stxx.upperLeft() + Diff2D(0, y0)));
+
+    combineTwoImages(srcIterRange(tmpy.upperLeft() + Diff2D(0, py0 - gy0),
+                                  tmpy.upperLeft() + Diff2D(w, py1 - gy0), tmpy.accessor()),
+                     srcIter(tmpy.upperLeft() + Diff2D(0, py0 - gy0)),
+                     destImage(prod), std::multiplies<TmpType>());
+    gaussianSmoothing(srcImageRange(prod), destImage(smoothed), scale);
+    copyImage(srcIterRange(smoothed.upperLeft() + Diff2D(0, y0 - py0),
+                           smoothed.upperLeft() + Diff2D(w, y1 - py0), smoothed.accessor()),
+              destIter(styy.upperLeft() + Diff2D(0, y0)));
+
+    combineTwoImages(srcIterRange(tmpx.upperLeft() + Diff2D(0, py0 - gy0),
+                                  tmpx.upperLeft() + Diff2D(w, py1 - gy0), tmpx.accessor()),
+                     srcIter(tmpy.upperLeft() + Diff2D(0, py0 - gy0)),
+                     destImage(prod), std::multiplies<TmpType>());
+    gaussianSmoothing(srcImageRange(prod), destImage(smoothed), scale);
+    copyImage(srcIterRange(smoothed.upperLeft() + Diff2D(0, y0 - py0),
+                           smoothed.upperLeft() + Diff2D(w, y1 - py0), smoothed.accessor()),
+              destIter(stxy.upperLeft() + Diff2D(0, y0)));
+}
+
+template <class SrcIterator, class SrcAccessor, class TmpType>
+void hessianMatrixStrip(SrcIterator sul, SrcAccessor as,
+                        int w, int h, int y0, int y1, double scale,
+                        BasicImage<TmpType> & hxx,
+                        BasicImage<TmpType> & hxy,
+                        BasicImage<TmpType> & hyy)
+{
+    Kernel1D<double> smooth, deriv1, deriv2;
+    smooth.initGaussian(scale);
+    deriv1.initGaussianDerivative(scale, 1);
+    deriv2.initGaussianDerivative(scale, 2);
+
+    int r = std::max(std::max(smooth.right(), deriv1.right()), deriv2.right());
+    int gy0 = std::max(0, y0 - r);
+    int gy1 = std::min(h, y1 + r);
+
+    BasicImage<TmpType> txx(w, gy1 - gy0, SkipInitialization),
+                        txy(w, gy1 - gy0, SkipInitialization),
+                        tyy(w, gy1 - gy0, SkipInitialization);
+    hessianMatrixOfGaussian(srcIterRange(sul + Diff2D(0, gy0), sul + Diff2D(w, gy1), as),
+                            destImage(txx), destImage(txy), destImage(tyy), scale);
+
+    copyImage(srcIterRange(txx.upperLeft() + Diff2D(0, y0 - gy0),
+                           txx.upperLeft() + Diff2D(w, y1 - gy0), txx.accessor()),
+              destIter(hxx.upperLeft() + Diff2D(0, y0)));
+    copyImage(srcIterRange(txy.upperLeft() + Diff2D(0, y0 - gy0),
+                           txy.upperLeft() + Diff2D(w, y1 - gy0), txy.accessor()),
+              destIter(hxy.upperLeft() + Diff2D(0, y0)));
+    copyImage(srcIterRange(tyy.upperLeft() + Diff2D(0, y0 - gy0),
+                           tyy.upperLeft() + Diff2D(w, y1 - gy0), tyy.accessor()),
+              destIter(hyy.upperLeft() + Diff2D(0, y0)));
+}
+
+} // namespace detail
+
 /** \addtogroup CornerDetection Corner Detection
     Measure the 'cornerness' at each pixel.
     Note: The Kitchen-Rosenfeld detector is not implemented because of its
     inferior performance. The SUSAN detector is missing because it's patented.
 */
-//@{ 
+//@{
+
+/********************************************************/
+/*                                                      */
+/*                  CornerDetectorStage                 */
+/*                                                      */
+/********************************************************/
+
+/** \brief Shared filter stage for the corner detector family.
+
+    All structure tensor-based corner detectors (\ref cornerResponseFunction(),
+    \ref foerstnerCornerDetector(), \ref rohrCornerDetector()) spend almost
+    all of their time computing the very same structure tensor, and
+    \ref beaudetCornerDetector() likewise only differs in the per-pixel
+    combination of the Hessian matrix entries. This class computes the
+    requested matrices exactly once and then evaluates an arbitrary number
+    of detectors on them, so that running several detectors on the same
+    frame (e.g. for cross-validation) no longer repeats the filtering work.
+
+    The filtering is performed in parallel horizontal strips when a
+    \ref vigra::ParallelOptions argument is given and OpenMP is enabled.
+    The strips overlap by the appropriate filter radii, so the results are
+    identical to the sequential computation.
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/cornerdetection.hxx\><br>
+    Namespace: vigra
+
+    \code
+    vigra::BImage src(w,h);
+    vigra::FImage harris(w,h), foerstner(w,h);
+    ...
+
+    // compute the structure tensor once, at scale 1.0 and with 4 threads
+    vigra::CornerDetectorStage<float> corners(srcImageRange(src), 1.0,
+                                              vigra::ParallelOptions().numThreads(4));
+
+    // evaluate two detectors on it
+    corners.cornerResponseFunction(destImage(harris));
+    corners.foerstnerCornerDetector(destImage(foerstner));
+
+    // or apply a custom ternary functor to the tensor entries (A, B, C)
+    corners.apply(destImage(harris), vigra::CornerResponseFunctor<float>());
+    \endcode
+
+    To run \ref beaudetCornerDetector() as well, request the Hessian matrix
+    in addition to the structure tensor:
+
+    \code
+    vigra::CornerDetectorStage<float> corners(srcImageRange(src), 1.0,
+                                              vigra::ParallelOptions().numThreads(4),
+                                              vigra::CornerDetectorStage<float>::Both);
+    corners.cornerResponseFunction(destImage(harris));
+    corners.beaudetCornerDetector(destImage(beaudet));
+    \endcode
+
+    The template parameter <tt>T</tt> is the value type of the source image
+    (more precisely, the argument type of the detector functors).
+*/
+template <class T>
+class CornerDetectorStage
+{
+  public:
+        /** The matrices to be computed: all detectors except
+            \ref beaudetCornerDetector() use the structure tensor,
+            \ref beaudetCornerDetector() uses the Hessian matrix.
+        */
+    enum Ingredients { StructureTensorOnly = 1, HessianOnly = 2, Both = 3 };
+
+        /** The type of the matrix entries.
+        */
+    typedef typename NumericTraits<T>::RealPromote TmpType;
+
+        /** The type of the internal matrix images.
+        */
+    typedef BasicImage<TmpType> TensorImage;
+
+        /** Compute the requested matrices sequentially at the given scale.
+        */
+    template <class SrcIterator, class SrcAccessor>
+    CornerDetectorStage(SrcIterator sul, SrcIterator slr, SrcAccessor as,
+                        double scale, Ingredients what = StructureTensorOnly)
+    {
+        init(sul, slr, as, scale, what, ParallelOptions().numThreads(1));
+    }
+
+        /** Likewise, but process the image in parallel horizontal strips.
+        */
+    template <class SrcIterator, class SrcAccessor>
+    CornerDetectorStage(SrcIterator sul, SrcIterator slr, SrcAccessor as,
+                        double scale, ParallelOptions const & options,
+                        Ingredients what = StructureTensorOnly)
+    {
+        init(sul, slr, as, scale, what, options);
+    }
+
+        /** Compute the requested matrices sequentially at the given scale.
+        */
+    template <class SrcIterator, class SrcAccessor>
+    CornerDetectorStage(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                        double scale, Ingredients what = StructureTensorOnly)
+    {
+        init(src.first, src.second, src.third, scale, what,
+             ParallelOptions().numThreads(1));
+    }
+
+        /** Likewise, but process the image in parallel horizontal strips.
+        */
+    template <class SrcIterator, class SrcAccessor>
+    CornerDetectorStage(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                        double scale, ParallelOptions const & options,
+                        Ingredients what = StructureTensorOnly)
+    {
+        init(src.first, src.second, src.third, scale, what, options);
+    }
+
+        /** Apply a ternary functor to the structure tensor entries
+            (A, B, C) of every pixel and write the result into the
+            destination image.
+        */
+    template <class DestIterator, class DestAccessor, class Functor>
+    void apply(DestIterator dul, DestAccessor ad, Functor const & f) const
+    {
+        vigra_precondition(hasStructureTensor_,
+            "CornerDetectorStage::apply(): structure tensor was not computed.");
+        if(w_ <= 0 || h_ <= 0)
+            return;
+        combineThreeImages(srcImageRange(stxx_), srcImage(styy_), srcImage(stxy_),
+                           destIter(dul, ad), f);
+    }
+
+    template <class DestIterator, class DestAccessor, class Functor>
+    void apply(pair<DestIterator, DestAccessor> dest, Functor const & f) const
+    {
+        apply(dest.first, dest.second, f);
+    }
+
+        /** Apply a ternary functor to the Hessian matrix entries of every
+            pixel and write the result into the destination image. Only
+            allowed when the Hessian was requested at construction.
+        */
+    template <class DestIterator, class DestAccessor, class Functor>
+    void applyHessian(DestIterator dul, DestAccessor ad, Functor const & f) const
+    {
+        vigra_precondition(hasHessian_,
+            "CornerDetectorStage::applyHessian(): Hessian matrix was not computed.");
+        if(w_ <= 0 || h_ <= 0)
+            return;
+        combineThreeImages(srcImageRange(hxx_), srcImage(hyy_), srcImage(hxy_),
+                           destIter(dul, ad), f);
+    }
+
+    template <class DestIterator, class DestAccessor, class Functor>
+    void applyHessian(pair<DestIterator, DestAccessor> dest, Functor const & f) const
+    {
+        applyHessian(dest.first, dest.second, f);
+    }
+
+        /** Evaluate \ref cornerResponseFunction() on the precomputed tensor.
+        */
+    template <class DestIterator, class DestAccessor>
+    void cornerResponseFunction(DestIterator dul, DestAccessor ad) const
+    {
+        apply(dul, ad, CornerResponseFunctor<T>());
+    }
+
+    template <class DestIterator, class DestAccessor>
+    void cornerResponseFunction(pair<DestIterator, DestAccessor> dest) const
+    {
+        apply(dest.first, dest.second, CornerResponseFunctor<T>());
+    }
+
+        /** Evaluate \ref foerstnerCornerDetector() on the precomputed tensor.
+        */
+    template <class DestIterator, class DestAccessor>
+    void foerstnerCornerDetector(DestIterator dul, DestAccessor ad) const
+    {
+        apply(dul, ad, FoerstnerCornerFunctor<T>());
+    }
+
+    template <class DestIterator, class DestAccessor>
+    void foerstnerCornerDetector(pair<DestIterator, DestAccessor> dest) const
+    {
+        apply(dest.first, dest.second, FoerstnerCornerFunctor<T>());
+    }
+
+        /** Evaluate \ref rohrCornerDetector() on the precomputed tensor.
+        */
+    template <class DestIterator, class DestAccessor>
+    void rohrCornerDetector(DestIterator dul, DestAccessor ad) const
+    {
+        apply(dul, ad, RohrCornerFunctor<T>());
+    }
+
+    template <class DestIterator, class DestAccessor>
+    void rohrCornerDetector(pair<DestIterator, DestAccessor> dest) const
+    {
+        apply(dest.first, dest.second, RohrCornerFunctor<T>());
+    }
+
+        /** Evaluate \ref beaudetCornerDetector() on the precomputed Hessian.
+        */
+    template <class DestIterator, class DestAccessor>
+    void beaudetCornerDetector(DestIterator dul, DestAccessor ad) const
+    {
+        applyHessian(dul, ad, BeaudetCornerFunctor<T>());
+    }
+
+    template <class DestIterator, class DestAccessor>
+    void beaudetCornerDetector(pair<DestIterator, DestAccessor> dest) const
+    {
+        applyHessian(dest.first, dest.second, BeaudetCornerFunctor<T>());
+    }
+
+        /** The width of the processed image.
+        */
+    int width() const
+    {
+        return w_;
+    }
+
+        /** The height of the processed image.
+        */
+    int height() const
+    {
+        return h_;
+    }
+
+        /** Whether the structure tensor is available.
+        */
+    bool hasStructureTensor() const
+    {
+        return hasStructureTensor_;
+    }
+
+        /** Whether the Hessian matrix is available.
+        */
+    bool hasHessian() const
+    {
+        return hasHessian_;
+    }
+
+  private:
+    template <class SrcIterator, class SrcAccessor>
+    void init(SrcIterator sul, SrcIterator slr, SrcAccessor as,
+              double scale, Ingredients what, ParallelOptions const & options)
+    {
+        vigra_precondition(scale > 0.0,
+                     "CornerDetectorStage(): Scale must be > 0");
+
+        w_ = slr.x - sul.x;
+        h_ = slr.y - sul.y;
+        hasStructureTensor_ = (what & StructureTensorOnly) != 0;
+        hasHessian_ = (what & HessianOnly) != 0;
+
+        if(w_ <= 0 || h_ <= 0)
+            return;
+
+        if(hasStructureTensor_)
+        {
+            stxx_.resize(w_, h_);
+            stxy_.resize(w_, h_);
+            styy_.resize(w_, h_);
+        }
+        if(hasHessian_)
+        {
+            hxx_.resize(w_, h_);
+            hxy_.resize(w_, h_);
+            hyy_.resize(w_, h_);
+        }
+
+        int stripHeight = options.getNumThreads() > 1
+                              ? options.getBlockSize(h_)
+                              : h_;
+        int stripCount = (h_ + stripHeight - 1) / stripHeight;
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(options.getNumThreads())
+#endif
+        {
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+            for(int s = 0; s < stripCount; ++s)
+            {
+                int y0 = s*stripHeight;
+                int y1 = std::min(h_, y0 + stripHeight);
+                if(hasStructureTensor_)
+                    detail::structureTensorStrip(sul, as, w_, h_, y0, y1, scale,
+                                                 stxx_, stxy_, styy_);
+                if(hasHessian_)
+                    detail::hessianMatrixStrip(sul, as, w_, h_, y0, y1, scale,
+                                               hxx_, hxy_, hyy_);
+            }
+        }
+    }
+
+    int w_, h_;
+    bool hasStructureTensor_, hasHessian_;
+    TensorImage stxx_, stxy_, styy_;
+    TensorImage hxx_, hxy_, hyy_;
+};
                                     
 /********************************************************/
 /*                                                      */
@@ -160,14 +560,20 @@ class FunctorTraits<BeaudetCornerFunctor<T> >
         = A B - C^2 - 0.04 (A + B)^2
     \f]
     
-    The local maxima of the corner response denote the corners in the gray level 
+    The local maxima of the corner response denote the corners in the gray level
     image.
-    
+
     The source value type must be a linear algebra, i.e. addition, subtraction, and
-    multiplication with itself, multiplication with doubles and 
-    \ref NumericTraits "NumericTraits" must 
-    be defined. 
-    
+    multiplication with itself, multiplication with doubles and
+    \ref NumericTraits "NumericTraits" must
+    be defined.
+
+    Each detector in this family is also overloaded with an additional
+    \ref vigra::ParallelOptions argument that computes the response in
+    parallel horizontal strips (with identical results). To run several
+    detectors on the same image without recomputing the structure tensor,
+    use \ref vigra::CornerDetectorStage.
+
     <b> Declarations:</b>
     
     pass arguments explicitly:
@@ -256,33 +662,15 @@ cornerResponseFunction(SrcIterator sul, SrcIterator slr, SrcAccessor as,
 {
     vigra_precondition(scale > 0.0,
                  "cornerResponseFunction(): Scale must be > 0");
-                 
-    int w = slr.x - sul.x;
-    int h = slr.y - sul.y;
-    
-    if(w <= 0 || h <= 0) return;
-    
-    typedef typename 
-        NumericTraits<typename SrcAccessor::value_type>::RealPromote TmpType;
-        
-    typedef BasicImage<TmpType> TmpImage;
-    
-    TmpImage gx(w,h);
-    TmpImage gy(w,h);
-    TmpImage gxy(w,h);
-
-    structureTensor(srcIterRange(sul, slr, as), 
-                    destImage(gx), destImage(gxy), destImage(gy), 
-                    scale, scale);
-    CornerResponseFunctor<typename SrcAccessor::value_type > cf;
-                    
-    combineThreeImages(srcImageRange(gx), srcImage(gy), srcImage(gxy), 
-                       destIter(dul, ad), cf );
+
+    CornerDetectorStage<typename SrcAccessor::value_type>
+        corners(sul, slr, as, scale);
+    corners.cornerResponseFunction(dul, ad);
 }
 
 template <class SrcIterator, class SrcAccessor,
           class DestIterator, class DestAccessor>
-inline 
+inline
 void cornerResponseFunction(
            triple<SrcIterator, SrcIterator, SrcAccessor> src,
            pair<DestIterator, DestAccessor> dest,
@@ -293,6 +681,34 @@ void cornerResponseFunction(
                             scale);
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void
+cornerResponseFunction(SrcIterator sul, SrcIterator slr, SrcAccessor as,
+                       DestIterator dul, DestAccessor ad,
+                       double scale, ParallelOptions const & options)
+{
+    vigra_precondition(scale > 0.0,
+                 "cornerResponseFunction(): Scale must be > 0");
+
+    CornerDetectorStage<typename SrcAccessor::value_type>
+        corners(sul, slr, as, scale, options);
+    corners.cornerResponseFunction(dul, ad);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline
+void cornerResponseFunction(
+           triple<SrcIterator, SrcIterator, SrcAccessor> src,
+           pair<DestIterator, DestAccessor> dest,
+           double scale, ParallelOptions const & options)
+{
+    cornerResponseFunction(src.first, src.second, src.third,
+                            dest.first, dest.second,
+                            scale, options);
+}
+
 /********************************************************/
 /*                                                      */
 /*               foerstnerCornerDetector                */
@@ -406,33 +822,15 @@ foerstnerCornerDetector(SrcIterator sul, SrcIterator slr, SrcAccessor as,
 {
     vigra_precondition(scale > 0.0,
                  "foerstnerCornerDetector(): Scale must be > 0");
-                 
-    int w = slr.x - sul.x;
-    int h = slr.y - sul.y;
-    
-    if(w <= 0 || h <= 0) return;
-    
-    typedef typename 
-        NumericTraits<typename SrcAccessor::value_type>::RealPromote TmpType;
-        
-    typedef BasicImage<TmpType> TmpImage;
-    
-    TmpImage gx(w,h);
-    TmpImage gy(w,h);
-    TmpImage gxy(w,h);
-
-    structureTensor(srcIterRange(sul, slr, as), 
-                    destImage(gx), destImage(gxy), destImage(gy), 
-                    scale, scale);
-    FoerstnerCornerFunctor<typename SrcAccessor::value_type > cf;
-                    
-    combineThreeImages(srcImageRange(gx), srcImage(gy), srcImage(gxy), 
-                       destIter(dul, ad), cf );
+
+    CornerDetectorStage<typename SrcAccessor::value_type>
+        corners(sul, slr, as, scale);
+    corners.foerstnerCornerDetector(dul, ad);
 }
 
 template <class SrcIterator, class SrcAccessor,
           class DestIterator, class DestAccessor>
-inline 
+inline
 void foerstnerCornerDetector(
            triple<SrcIterator, SrcIterator, SrcAccessor> src,
            pair<DestIterator, DestAccessor> dest,
@@ -443,6 +841,34 @@ void foerstnerCornerDetector(
                             scale);
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void
+foerstnerCornerDetector(SrcIterator sul, SrcIterator slr, SrcAccessor as,
+                        DestIterator dul, DestAccessor ad,
+                        double scale, ParallelOptions const & options)
+{
+    vigra_precondition(scale > 0.0,
+                 "foerstnerCornerDetector(): Scale must be > 0");
+
+    CornerDetectorStage<typename SrcAccessor::value_type>
+        corners(sul, slr, as, scale, options);
+    corners.foerstnerCornerDetector(dul, ad);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline
+void foerstnerCornerDetector(
+           triple<SrcIterator, SrcIterator, SrcAccessor> src,
+           pair<DestIterator, DestAccessor> dest,
+           double scale, ParallelOptions const & options)
+{
+    foerstnerCornerDetector(src.first, src.second, src.third,
+                            dest.first, dest.second,
+                            scale, options);
+}
+
 /********************************************************/
 /*                                                      */
 /*                   rohrCornerDetector                 */
@@ -553,33 +979,15 @@ rohrCornerDetector(SrcIterator sul, SrcIterator slr, SrcAccessor as,
 {
     vigra_precondition(scale > 0.0,
                  "rohrCornerDetector(): Scale must be > 0");
-                 
-    int w = slr.x - sul.x;
-    int h = slr.y - sul.y;
-    
-    if(w <= 0 || h <= 0) return;
-    
-    typedef typename 
-        NumericTraits<typename SrcAccessor::value_type>::RealPromote TmpType;
-        
-    typedef BasicImage<TmpType> TmpImage;
-    
-    TmpImage gx(w,h);
-    TmpImage gy(w,h);
-    TmpImage gxy(w,h);
-
-    structureTensor(srcIterRange(sul, slr, as), 
-                    destImage(gx), destImage(gxy), destImage(gy), 
-                    scale, scale);
-    RohrCornerFunctor<typename SrcAccessor::value_type > cf;
-                    
-    combineThreeImages(srcImageRange(gx), srcImage(gy), srcImage(gxy), 
-                       destIter(dul, ad), cf );
+
+    CornerDetectorStage<typename SrcAccessor::value_type>
+        corners(sul, slr, as, scale);
+    corners.rohrCornerDetector(dul, ad);
 }
 
 template <class SrcIterator, class SrcAccessor,
           class DestIterator, class DestAccessor>
-inline 
+inline
 void rohrCornerDetector(
            triple<SrcIterator, SrcIterator, SrcAccessor> src,
            pair<DestIterator, DestAccessor> dest,
@@ -590,6 +998,34 @@ void rohrCornerDetector(
                             scale);
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void
+rohrCornerDetector(SrcIterator sul, SrcIterator slr, SrcAccessor as,
+                   DestIterator dul, DestAccessor ad,
+                   double scale, ParallelOptions const & options)
+{
+    vigra_precondition(scale > 0.0,
+                 "rohrCornerDetector(): Scale must be > 0");
+
+    CornerDetectorStage<typename SrcAccessor::value_type>
+        corners(sul, slr, as, scale, options);
+    corners.rohrCornerDetector(dul, ad);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline
+void rohrCornerDetector(
+           triple<SrcIterator, SrcIterator, SrcAccessor> src,
+           pair<DestIterator, DestAccessor> dest,
+           double scale, ParallelOptions const & options)
+{
+    rohrCornerDetector(src.first, src.second, src.third,
+                            dest.first, dest.second,
+                            scale, options);
+}
+
 /********************************************************/
 /*                                                      */
 /*                 beaudetCornerDetector                */
@@ -691,33 +1127,15 @@ beaudetCornerDetector(SrcIterator sul, SrcIterator slr, SrcAccessor as,
 {
     vigra_precondition(scale > 0.0,
                  "beaudetCornerDetector(): Scale must be > 0");
-                 
-    int w = slr.x - sul.x;
-    int h = slr.y - sul.y;
-    
-    if(w <= 0 || h <= 0) return;
-    
-    typedef typename 
-        NumericTraits<typename SrcAccessor::value_type>::RealPromote TmpType;
-        
-    typedef BasicImage<TmpType> TmpImage;
-    
-    TmpImage gx(w,h);
-    TmpImage gy(w,h);
-    TmpImage gxy(w,h);
-
-    hessianMatrixOfGaussian(srcIterRange(sul, slr, as), 
-                    destImage(gx), destImage(gxy), destImage(gy), 
-                    scale);
-    BeaudetCornerFunctor<typename SrcAccessor::value_type > cf;
-                    
-    combineThreeImages(srcImageRange(gx), srcImage(gy), srcImage(gxy), 
-                       destIter(dul, ad), cf );
+
+    typedef CornerDetectorStage<typename SrcAccessor::value_type> Stage;
+    Stage corners(sul, slr, as, scale, Stage::HessianOnly);
+    corners.beaudetCornerDetector(dul, ad);
 }
 
 template <class SrcIterator, class SrcAccessor,
           class DestIterator, class DestAccessor>
-inline 
+inline
 void beaudetCornerDetector(
            triple<SrcIterator, SrcIterator, SrcAccessor> src,
            pair<DestIterator, DestAccessor> dest,
@@ -728,6 +1146,34 @@ void beaudetCornerDetector(
                             scale);
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void
+beaudetCornerDetector(SrcIterator sul, SrcIterator slr, SrcAccessor as,
+                      DestIterator dul, DestAccessor ad,
+                      double scale, ParallelOptions const & options)
+{
+    vigra_precondition(scale > 0.0,
+                 "beaudetCornerDetector(): Scale must be > 0");
+
+    typedef CornerDetectorStage<typename SrcAccessor::value_type> Stage;
+    Stage corners(sul, slr, as, scale, options, Stage::HessianOnly);
+    corners.beaudetCornerDetector(dul, ad);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline
+void beaudetCornerDetector(
+           triple<SrcIterator, SrcIterator, SrcAccessor> src,
+           pair<DestIterator, DestAccessor> dest,
+           double scale, ParallelOptions const & options)
+{
+    beaudetCornerDetector(src.first, src.second, src.third,
+                            dest.first, dest.second,
+                            scale, options);
+}
+
 
 //@}
 
@@ -39,6 +39,8 @@
 
 #include <cmath>
 #include "stdimage.hxx"
+#include "array_vector.hxx"
+#include "parallel_options.hxx"
 
 namespace vigra {
 
@@ -266,6 +268,135 @@ internalDistanceTransform(SrcImageIterator src_upperleft,
     }
 }
 
+/*
+ * chamfer propagation over one row, left to right. The contributions of
+ * the previous row have no dependency between the pixels of the current
+ * row and are collected in 'tmp' first (this loop auto-vectorizes); the
+ * remaining left-neighbor propagation is a short scalar scan. Returns
+ * whether any pixel of the row was lowered.
+ */
+inline bool
+internalChamferPropagateLR(float * cur, float const * prev, float * tmp, int w)
+{
+    const float ortho = 1.0f;
+    const float diag  = 1.4142136f;
+
+    if(prev)
+    {
+        for(int x=1; x<w-1; ++x)
+        {
+            float v = prev[x] + ortho;
+            float l = prev[x-1] + diag;
+            float r = prev[x+1] + diag;
+            if(l < v) v = l;
+            if(r < v) v = r;
+            tmp[x] = v;
+        }
+        tmp[0] = prev[0] + ortho;
+        if(w > 1)
+        {
+            float v = prev[1] + diag;
+            if(v < tmp[0]) tmp[0] = v;
+            tmp[w-1] = prev[w-1] + ortho;
+            v = prev[w-2] + diag;
+            if(v < tmp[w-1]) tmp[w-1] = v;
+        }
+    }
+    else
+    {
+        for(int x=0; x<w; ++x)
+            tmp[x] = cur[x];
+    }
+
+    bool changed = false;
+    float left = tmp[0];
+    if(cur[0] < left)
+        left = cur[0];
+    else if(left < cur[0])
+    {
+        cur[0] = left;
+        changed = true;
+    }
+    for(int x=1; x<w; ++x)
+    {
+        float v = tmp[x];
+        float l = left + ortho;
+        if(l < v) v = l;
+        if(cur[x] < v)
+            v = cur[x];
+        else if(v < cur[x])
+        {
+            cur[x] = v;
+            changed = true;
+        }
+        left = v;
+    }
+    return changed;
+}
+
+/*
+ * mirror image of internalChamferPropagateLR: next row and right neighbor,
+ * right to left
+ */
+inline bool
+internalChamferPropagateRL(float * cur, float const * next, float * tmp, int w)
+{
+    const float ortho = 1.0f;
+    const float diag  = 1.4142136f;
+
+    if(next)
+    {
+        for(int x=1; x<w-1; ++x)
+        {
+            float v = next[x] + ortho;
+            float l = next[x-1] + diag;
+            float r = next[x+1] + diag;
+            if(l < v) v = l;
+            if(r < v) v = r;
+            tmp[x] = v;
+        }
+        tmp[0] = next[0] + ortho;
+        if(w > 1)
+        {
+            float v = next[1] + diag;
+            if(v < tmp[0]) tmp[0] = v;
+            tmp[w-1] = next[w-1] + ortho;
+            v = next[w-2] + diag;
+            if(v < tmp[w-1]) tmp[w-1] = v;
+        }
+    }
+    else
+    {
+        for(int x=0; x<w; ++x)
+            tmp[x] = cur[x];
+    }
+
+    bool changed = false;
+    float right = tmp[w-1];
+    if(cur[w-1] < right)
+        right = cur[w-1];
+    else if(right < cur[w-1])
+    {
+        cur[w-1] = right;
+        changed = true;
+    }
+    for(int x=w-2; x>=0; --x)
+    {
+        float v = tmp[x];
+        float r = right + ortho;
+        if(r < v) v = r;
+        if(cur[x] < v)
+            v = cur[x];
+        else if(v < cur[x])
+        {
+            cur[x] = v;
+            changed = true;
+        }
+        right = v;
+    }
+    return changed;
+}
+
 /********************************************************/
 /*                                                      */
 /*                 distanceTransform                    */
@@ -418,6 +549,230 @@ distanceTransform(
                       dest.first, dest.second, background, norm);
 }
 
+/********************************************************/
+/*                                                      */
+/*              chamferDistanceTransform                */
+/*                                                      */
+/********************************************************/
+
+/** \brief Approximate distance transform by two-pass chamfer propagation.
+
+    This function approximates the Euclidean distance of all background
+    pixels (label <tt>background</tt>) to the nearest object with the
+    (1, &radic;2) chamfer metric: a forward and a backward raster sweep
+    propagate the distances from the orthogonal and diagonal neighbors.
+    The result overestimates the true Euclidean distance by at most
+    about 8%, which is usually acceptable when the distance map merely
+    steers a dilation or a similar morphological operation. In exchange,
+    the two sweeps touch every pixel only twice and their inner loops
+    vectorize, so the transform runs considerably faster than
+    \ref distanceTransform() with the exact norm.
+
+    The overload taking a \ref ParallelOptions object divides the image
+    into one horizontal strip per thread. Each thread sweeps its strip
+    independently, and the sweeps are repeated (propagating across the
+    strip seams) until no pixel changes anymore; two rounds suffice
+    unless a shortest chamfer path crosses many seams. The converged
+    result equals the output of the sequential version up to the
+    floating-point rounding of the propagated sums (the chamfer path
+    costs are accumulated in a different order near the seams).
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/distancetransform.hxx\><br>
+    Namespace: vigra
+
+    \code
+    vigra::BImage edges(w,h);
+    vigra::FImage distance(w, h);
+    ...
+
+    // approximate distance of all pixels from the nearest edge
+    vigra::chamferDistanceTransform(srcImageRange(edges), destImage(distance), 0);
+
+    // the same with 4 threads
+    vigra::chamferDistanceTransform(srcImageRange(edges), destImage(distance), 0,
+                                    ParallelOptions().numThreads(4));
+    \endcode
+*/
+doxygen_overloaded_function(template <...> void chamferDistanceTransform)
+
+template <class SrcImageIterator, class SrcAccessor,
+                   class DestImageIterator, class DestAccessor,
+                   class ValueType>
+void
+chamferDistanceTransform(SrcImageIterator src_upperleft,
+                SrcImageIterator src_lowerright, SrcAccessor sa,
+                DestImageIterator dest_upperleft, DestAccessor da,
+                ValueType background)
+{
+    int w = src_lowerright.x - src_upperleft.x;
+    int h = src_lowerright.y - src_upperleft.y;
+    if(w <= 0 || h <= 0)
+        return;
+
+    FImage dist(w, h);
+    float large = 1.4142136f * (float)(w + h);
+
+    SrcImageIterator sy = src_upperleft;
+    for(int y=0; y<h; ++y, ++sy.y)
+    {
+        SrcImageIterator sx = sy;
+        float * d = &dist(0, y);
+        for(int x=0; x<w; ++x, ++sx.x)
+            d[x] = (sa(sx) != background) ? 0.0f : large;
+    }
+
+    ArrayVector<float> tmp(w);
+    for(int y=0; y<h; ++y)
+        internalChamferPropagateLR(&dist(0,y), y > 0 ? &dist(0,y-1) : 0,
+                                   tmp.begin(), w);
+    for(int y=h-1; y>=0; --y)
+        internalChamferPropagateRL(&dist(0,y), y < h-1 ? &dist(0,y+1) : 0,
+                                   tmp.begin(), w);
+
+    DestImageIterator ry = dest_upperleft;
+    for(int y=0; y<h; ++y, ++ry.y)
+    {
+        DestImageIterator rx = ry;
+        float const * d = &dist(0, y);
+        for(int x=0; x<w; ++x, ++rx.x)
+            da.set(d[x], rx);
+    }
+}
+
+template <class SrcImageIterator, class SrcAccessor,
+                   class DestImageIterator, class DestAccessor,
+                   class ValueType>
+void
+chamferDistanceTransform(SrcImageIterator src_upperleft,
+                SrcImageIterator src_lowerright, SrcAccessor sa,
+                DestImageIterator dest_upperleft, DestAccessor da,
+                ValueType background,
+                ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    int w = src_lowerright.x - src_upperleft.x;
+    int h = src_lowerright.y - src_upperleft.y;
+    int num_threads = options.getNumThreads();
+    if(num_threads > h)
+        num_threads = h;
+    if(num_threads > 1 && w > 0)
+    {
+        FImage dist(w, h);
+        float large = 1.4142136f * (float)(w + h);
+
+        ArrayVector<int> bounds((unsigned int)num_threads + 1);
+        for(int t = 0; t <= num_threads; ++t)
+            bounds[t] = (int)(((long long)h * t) / num_threads);
+
+        std::string errorMessage;
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(int t = 0; t < num_threads; ++t)
+        {
+            try
+            {
+                SrcImageIterator sy = src_upperleft + Diff2D(0, bounds[t]);
+                for(int y=bounds[t]; y<bounds[t+1]; ++y, ++sy.y)
+                {
+                    SrcImageIterator sx = sy;
+                    float * d = &dist(0, y);
+                    for(int x=0; x<w; ++x, ++sx.x)
+                        d[x] = (sa(sx) != background) ? 0.0f : large;
+                }
+            }
+            catch(std::exception & e)
+            {
+#pragma omp critical(vigra_chamfer_distance_error)
+                errorMessage = e.what();
+            }
+        }
+        if(!errorMessage.empty())
+            vigra_fail("chamferDistanceTransform(): worker thread failed with:\n" + errorMessage);
+
+        // sweep the strips independently and repeat (propagating across
+        // the seams) until the chamfer relaxation reaches its fixpoint
+        ArrayVector<unsigned char> changed((unsigned int)num_threads);
+        ArrayVector<ArrayVector<float> > tmp((unsigned int)num_threads,
+                                             ArrayVector<float>((unsigned int)w));
+        for(;;)
+        {
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+            for(int t = 0; t < num_threads; ++t)
+            {
+                bool c = false;
+                for(int y=bounds[t]; y<bounds[t+1]; ++y)
+                    if(internalChamferPropagateLR(&dist(0,y),
+                                   y > 0 ? &dist(0,y-1) : 0, tmp[t].begin(), w))
+                        c = true;
+                changed[t] = c ? 1 : 0;
+            }
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+            for(int t = 0; t < num_threads; ++t)
+            {
+                bool c = false;
+                for(int y=bounds[t+1]-1; y>=bounds[t]; --y)
+                    if(internalChamferPropagateRL(&dist(0,y),
+                                   y < h-1 ? &dist(0,y+1) : 0, tmp[t].begin(), w))
+                        c = true;
+                if(c)
+                    changed[t] = 1;
+            }
+            bool any = false;
+            for(int t = 0; t < num_threads; ++t)
+                if(changed[t] != 0)
+                    any = true;
+            if(!any)
+                break;
+        }
+
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(int t = 0; t < num_threads; ++t)
+        {
+            DestImageIterator ry = dest_upperleft + Diff2D(0, bounds[t]);
+            for(int y=bounds[t]; y<bounds[t+1]; ++y, ++ry.y)
+            {
+                DestImageIterator rx = ry;
+                float const * d = &dist(0, y);
+                for(int x=0; x<w; ++x, ++rx.x)
+                    da.set(d[x], rx);
+            }
+        }
+        return;
+    }
+#endif // _OPENMP
+
+    chamferDistanceTransform(src_upperleft, src_lowerright, sa,
+                             dest_upperleft, da, background);
+}
+
+template <class SrcImageIterator, class SrcAccessor,
+                   class DestImageIterator, class DestAccessor,
+                   class ValueType>
+inline void
+chamferDistanceTransform(
+    triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
+    pair<DestImageIterator, DestAccessor> dest,
+    ValueType background)
+{
+    chamferDistanceTransform(src.first, src.second, src.third,
+                             dest.first, dest.second, background);
+}
+
+template <class SrcImageIterator, class SrcAccessor,
+                   class DestImageIterator, class DestAccessor,
+                   class ValueType>
+inline void
+chamferDistanceTransform(
+    triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
+    pair<DestImageIterator, DestAccessor> dest,
+    ValueType background,
+    ParallelOptions const & options)
+{
+    chamferDistanceTransform(src.first, src.second, src.third,
+                             dest.first, dest.second, background, options);
+}
+
 //@}
 
 } // namespace vigra
@@ -40,6 +40,7 @@
 #include <vector>
 #include <queue>
 #include <cmath>     // sqrt(), abs()
+#include <algorithm> // min(), max()
 #include "utilities.hxx"
 #include "numerictraits.hxx"
 #include "stdimage.hxx"
@@ -52,6 +53,7 @@
 #include "pixelneighborhood.hxx"
 #include "linear_solve.hxx"
 #include "functorexpression.hxx"
+#include "parallel_options.hxx"
 
 
 namespace vigra {
@@ -1210,22 +1212,23 @@ class Edgel
     {}
 };
 
-template <class SrcIterator, class SrcAccessor, 
+template <class SrcIterator, class SrcAccessor,
           class MagnitudeImage, class BackInsertable, class GradValue>
-void internalCannyFindEdgels(SrcIterator ul, SrcAccessor grad,
-                             MagnitudeImage const & magnitude,
-                             BackInsertable & edgels, GradValue grad_thresh)
+void internalCannyFindEdgelsInRows(SrcIterator ul, SrcAccessor grad,
+                                   MagnitudeImage const & magnitude,
+                                   int yBegin, int yEnd, int yOffset,
+                                   BackInsertable & edgels, GradValue grad_thresh)
 {
     typedef typename SrcAccessor::value_type PixelType;
     typedef typename PixelType::value_type ValueType;
 
     vigra_precondition(grad_thresh >= NumericTraits<GradValue>::zero(),
          "cannyFindEdgels(): gradient threshold must not be negative.");
-    
+
     double t = 0.5 / VIGRA_CSTD::sin(M_PI/8.0);
 
-    ul += Diff2D(1,1);
-    for(int y=1; y<magnitude.height()-1; ++y, ++ul.y)
+    ul += Diff2D(1,yBegin);
+    for(int y=yBegin; y<yEnd; ++y, ++ul.y)
     {
         SrcIterator ix = ul;
         for(int x=1; x<magnitude.width()-1; ++x, ++ix.x)
@@ -1254,7 +1257,7 @@ void internalCannyFindEdgels(SrcIterator ul, SrcAccessor grad,
                 // local maximum => quadratic interpolation of sub-pixel location
                 double del = 0.5 * (m1 - m3) / (m1 + m3 - 2.0*mag);
                 edgel.x = Edgel::value_type(x + dx*del);
-                edgel.y = Edgel::value_type(y + dy*del);
+                edgel.y = Edgel::value_type(y + yOffset + dy*del);
                 edgel.strength = Edgel::value_type(mag);
                 double orientation = VIGRA_CSTD::atan2(grady, gradx) + 0.5*M_PI;
                 if(orientation < 0.0)
@@ -1266,6 +1269,52 @@ void internalCannyFindEdgels(SrcIterator ul, SrcAccessor grad,
     }
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class MagnitudeImage, class BackInsertable, class GradValue>
+inline void internalCannyFindEdgels(SrcIterator ul, SrcAccessor grad,
+                                    MagnitudeImage const & magnitude,
+                                    BackInsertable & edgels, GradValue grad_thresh)
+{
+    internalCannyFindEdgelsInRows(ul, grad, magnitude,
+                                  1, magnitude.height()-1, 0,
+                                  edgels, grad_thresh);
+}
+
+template <class SrcIterator, class SrcAccessor, class GradValue>
+void internalCannyEdgelsStrip(SrcIterator ul, SrcAccessor src,
+                              int w, int h, int y0, int y1,
+                              double scale, GradValue grad_thresh,
+                              std::vector<Edgel> & edgels)
+{
+    using namespace functor;
+
+    typedef typename NumericTraits<typename SrcAccessor::value_type>::RealPromote TmpType;
+
+    Kernel1D<double> smooth, deriv;
+    smooth.initGaussian(scale);
+    deriv.initGaussianDerivative(scale, 1);
+
+    // The strip is expanded by the kernel radius plus one row for the
+    // non-maxima suppression neighbors. Since the horizontal convolution
+    // passes operate on entire rows, the vertical passes for all rows we
+    // keep then see exactly the same inputs as in a whole-image
+    // computation, so the resulting edgels are identical.
+    int radius = std::max(smooth.right(), deriv.right());
+    int gy0 = std::max(0, y0 - 1 - radius);
+    int gy1 = std::min(h, y1 + 1 + radius);
+
+    BasicImage<TinyVector<TmpType, 2> > grad(w, gy1 - gy0);
+    gaussianGradient(srcIterRange(ul + Diff2D(0, gy0), ul + Diff2D(w, gy1), src),
+                     destImage(grad), scale);
+
+    BasicImage<TmpType> magnitude(w, gy1 - gy0);
+    transformImage(srcImageRange(grad), destImage(magnitude), norm(Arg1()));
+
+    internalCannyFindEdgelsInRows(grad.upperLeft(), grad.accessor(), magnitude,
+                                  std::max(y0, 1) - gy0, std::min(y1, h-1) - gy0,
+                                  gy0, edgels, grad_thresh);
+}
+
 /********************************************************/
 /*                                                      */
 /*                      cannyEdgelList                  */
@@ -1285,11 +1334,18 @@ void internalCannyFindEdgels(SrcIterator ul, SrcAccessor grad,
     larger gradient magnitude than its two neighbors in gradient direction
     (where the direction is rounded into octants). If this is the case,
     a new \ref Edgel is appended to the given vector of <TT>edgels</TT>. The subpixel
-    edgel position is determined by fitting a parabola to the three gradient 
+    edgel position is determined by fitting a parabola to the three gradient
     magnitude values mentioned above. The sub-pixel location of the parabola's tip
     and the gradient magnitude and direction (from the pixel center)
     are written in the newly created edgel.
 
+    The overloads taking a \ref vigra::ParallelOptions argument (only available
+    in conjunction with a 'scale') fuse the gradient computation, gradient
+    magnitude, and non-maxima suppression into a single pass over horizontal
+    strips of the image and distribute the strips over the requested number of
+    threads (when OpenMP is enabled). The strips overlap by the filter radius,
+    so the resulting edgel list is identical to the sequential one.
+
     <b> Declarations:</b>
 
     pass arguments explicitly:
@@ -1306,6 +1362,13 @@ void internalCannyFindEdgels(SrcIterator ul, SrcAccessor grad,
         void
         cannyEdgelList(SrcIterator ul, SrcIterator lr, SrcAccessor src,
                        BackInsertable & edgels, double scale);
+
+        // likewise, but process the image in parallel horizontal strips
+        template <class SrcIterator, class SrcAccessor, class BackInsertable>
+        void
+        cannyEdgelList(SrcIterator ul, SrcIterator lr, SrcAccessor src,
+                       BackInsertable & edgels, double scale,
+                       ParallelOptions const & options);
     }
     \endcode
 
@@ -1384,6 +1447,24 @@ cannyEdgelList(triple<SrcIterator, SrcIterator, SrcAccessor> src,
     cannyEdgelList(src.first, src.second, src.third, edgels, scale);
 }
 
+template <class SrcIterator, class SrcAccessor, class BackInsertable>
+inline void
+cannyEdgelList(SrcIterator ul, SrcIterator lr, SrcAccessor src,
+               BackInsertable & edgels, double scale,
+               ParallelOptions const & options)
+{
+    cannyEdgelListThreshold(ul, lr, src, edgels, scale, 0.0, options);
+}
+
+template <class SrcIterator, class SrcAccessor, class BackInsertable>
+inline void
+cannyEdgelList(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+               BackInsertable & edgels, double scale,
+               ParallelOptions const & options)
+{
+    cannyEdgelListThreshold(src.first, src.second, src.third, edgels, scale, 0.0, options);
+}
+
 template <class SrcIterator, class SrcAccessor, class BackInsertable>
 void 
 cannyEdgelList(SrcIterator ul, SrcIterator lr, SrcAccessor src,
@@ -1436,9 +1517,17 @@ cannyEdgelList(triple<SrcIterator, SrcIterator, SrcAccessor> src,
         // compute edgels from a scalar image (determine gradient internally at 'scale')
         template <class SrcIterator, class SrcAccessor, 
                   class BackInsertable, class GradValue>
-        void 
+        void
         cannyEdgelListThreshold(SrcIterator ul, SrcIterator lr, SrcAccessor src,
                                 BackInsertable & edgels, double scale, GradValue grad_threshold);
+
+        // likewise, but process the image in parallel horizontal strips
+        template <class SrcIterator, class SrcAccessor,
+                  class BackInsertable, class GradValue>
+        void
+        cannyEdgelListThreshold(SrcIterator ul, SrcIterator lr, SrcAccessor src,
+                                BackInsertable & edgels, double scale, GradValue grad_threshold,
+                                ParallelOptions const & options);
     }
     \endcode
 
@@ -1521,6 +1610,61 @@ cannyEdgelListThreshold(triple<SrcIterator, SrcIterator, SrcAccessor> src,
     cannyEdgelListThreshold(src.first, src.second, src.third, edgels, scale, grad_threshold);
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class BackInsertable, class GradValue>
+void
+cannyEdgelListThreshold(SrcIterator ul, SrcIterator lr, SrcAccessor src,
+                        BackInsertable & edgels, double scale, GradValue grad_threshold,
+                        ParallelOptions const & options)
+{
+    vigra_precondition(grad_threshold >= NumericTraits<GradValue>::zero(),
+         "cannyEdgelListThreshold(): gradient threshold must not be negative.");
+
+    int w = lr.x - ul.x;
+    int h = lr.y - ul.y;
+
+    int stripHeight = options.getBlockSize(h);
+    int stripCount = (h + stripHeight - 1) / stripHeight;
+
+    // Gradient, magnitude, and non-maxima suppression are fused into a
+    // single pass over each horizontal strip, so that no full-size
+    // intermediate image is ever allocated. Each strip collects its
+    // edgels into a private vector.
+    std::vector<std::vector<Edgel> > stripEdgels(stripCount);
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(options.getNumThreads())
+#endif
+    {
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for(int s = 0; s < stripCount; ++s)
+        {
+            internalCannyEdgelsStrip(ul, src, w, h,
+                                     s*stripHeight, std::min(h, (s+1)*stripHeight),
+                                     scale, grad_threshold, stripEdgels[s]);
+        }
+    }
+
+    // concatenating in strip order reproduces the row-major edgel order
+    // of the sequential implementation
+    for(int s = 0; s < stripCount; ++s)
+        for(unsigned int i = 0; i < stripEdgels[s].size(); ++i)
+            edgels.push_back(stripEdgels[s][i]);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class BackInsertable, class GradValue>
+inline void
+cannyEdgelListThreshold(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                        BackInsertable & edgels, double scale, GradValue grad_threshold,
+                        ParallelOptions const & options)
+{
+    cannyEdgelListThreshold(src.first, src.second, src.third,
+                            edgels, scale, grad_threshold, options);
+}
+
 template <class SrcIterator, class SrcAccessor, 
           class BackInsertable, class GradValue>
 void 
@@ -1574,6 +1718,16 @@ cannyEdgelListThreshold(triple<SrcIterator, SrcIterator, SrcAccessor> src,
                    SrcIterator sul, SrcIterator slr, SrcAccessor sa,
                    DestIterator dul, DestAccessor da,
                    double scale, GradValue gradient_threshold, DestValue edge_marker);
+
+        // likewise, but compute the edgels in parallel horizontal strips
+        template <class SrcIterator, class SrcAccessor,
+                  class DestIterator, class DestAccessor,
+                  class GradValue, class DestValue>
+        void cannyEdgeImage(
+                   SrcIterator sul, SrcIterator slr, SrcAccessor sa,
+                   DestIterator dul, DestAccessor da,
+                   double scale, GradValue gradient_threshold, DestValue edge_marker,
+                   ParallelOptions const & options);
     }
     \endcode
 
@@ -1667,6 +1821,49 @@ inline void cannyEdgeImage(
                    scale, gradient_threshold, edge_marker);
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor,
+          class GradValue, class DestValue>
+void cannyEdgeImage(
+           SrcIterator sul, SrcIterator slr, SrcAccessor sa,
+           DestIterator dul, DestAccessor da,
+           double scale, GradValue gradient_threshold, DestValue edge_marker,
+           ParallelOptions const & options)
+{
+    std::vector<Edgel> edgels;
+
+    cannyEdgelListThreshold(sul, slr, sa, edgels, scale, gradient_threshold, options);
+
+    int w = slr.x - sul.x;
+    int h = slr.y - sul.y;
+
+    // marking the edgel pixels is cheap compared to the edgel
+    // computation and remains sequential
+    for(unsigned int i=0; i<edgels.size(); ++i)
+    {
+        Diff2D pix((int)(edgels[i].x + 0.5), (int)(edgels[i].y + 0.5));
+
+        if(pix.x < 0 || pix.x >= w || pix.y < 0 || pix.y >= h)
+            continue;
+
+        da.set(edge_marker, dul, pix);
+    }
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor,
+          class GradValue, class DestValue>
+inline void cannyEdgeImage(
+           triple<SrcIterator, SrcIterator, SrcAccessor> src,
+           pair<DestIterator, DestAccessor> dest,
+           double scale, GradValue gradient_threshold, DestValue edge_marker,
+           ParallelOptions const & options)
+{
+    cannyEdgeImage(src.first, src.second, src.third,
+                   dest.first, dest.second,
+                   scale, gradient_threshold, edge_marker, options);
+}
+
 /********************************************************/
 
 namespace detail {
@@ -984,6 +984,110 @@ bool hessenbergQrDecomposition(MultiArrayView<2, T, C1> & H, MultiArrayView<2, T
     return true;
 }
 
+// closed-form eigensystem of a symmetric 2x2 matrix; eigenvalues are
+// sorted from largest to smallest like in tridiagonalMatrixEigensystem()
+template <class T, class C1, class C2, class C3>
+void symmetricEigensystemFixed2x2(MultiArrayView<2, T, C1> const & a,
+            MultiArrayView<2, T, C2> & ew, MultiArrayView<2, T, C3> & ev)
+{
+    T a00 = a(0,0), a01 = a(0,1), a11 = a(1,1);
+    T d = (T)hypot(a00 - a11, 2.0*a01);
+    ew(0,0) = 0.5*(a00 + a11 + d);
+    ew(1,0) = 0.5*(a00 + a11 - d);
+
+    // the eigenvector of the largest eigenvalue is the better conditioned
+    // of (a01, lambda - a00) and (lambda - a11, a01)
+    T vx = a01, vy = ew(0,0) - a00;
+    T wx = ew(0,0) - a11, wy = a01;
+    if(wx*wx + wy*wy > vx*vx + vy*vy)
+    {
+        vx = wx;
+        vy = wy;
+    }
+    T norm = (T)hypot(vx, vy);
+    if(norm == 0.0)
+    {
+        vx = 1.0;  // matrix is a multiple of the identity
+        vy = 0.0;
+    }
+    else
+    {
+        vx /= norm;
+        vy /= norm;
+    }
+    ev(0,0) = vx;
+    ev(1,0) = vy;
+    ev(0,1) = -vy;
+    ev(1,1) = vx;
+}
+
+// closed-form eigensystem of a symmetric 3x3 matrix; returns false when
+// the eigenvalues are too close for the analytic eigenvector formulas
+// to be accurate, in which case the caller should use the iterative path
+template <class T, class C1, class C2, class C3>
+bool symmetricEigensystemFixed3x3(MultiArrayView<2, T, C1> const & a,
+            MultiArrayView<2, T, C2> & ew, MultiArrayView<2, T, C3> & ev)
+{
+    double l0, l1, l2;
+    symmetric3x3Eigenvalues<double>(a(0,0), a(0,1), a(0,2), a(1,1), a(1,2), a(2,2),
+                                    &l0, &l1, &l2);
+    ew(0,0) = (T)l0;
+    ew(1,0) = (T)l1;
+    ew(2,0) = (T)l2;
+
+    double scale = std::max(abs(l0), abs(l2));
+    if(scale == 0.0)
+    {
+        ev = identityMatrix<T>(3); // zero matrix
+        return true;
+    }
+
+    // eigenvectors of the extreme eigenvalues via the largest cross
+    // product of two rows of (a - lambda*I)
+    double v[2][3];
+    double lambda[2] = { l0, l2 };
+    for(int k = 0; k < 2; ++k)
+    {
+        double r0[3] = { a(0,0) - lambda[k], a(0,1), a(0,2) };
+        double r1[3] = { a(0,1), a(1,1) - lambda[k], a(1,2) };
+        double r2[3] = { a(0,2), a(1,2), a(2,2) - lambda[k] };
+        double c[3][3] = {
+            { r0[1]*r1[2] - r0[2]*r1[1], r0[2]*r1[0] - r0[0]*r1[2], r0[0]*r1[1] - r0[1]*r1[0] },
+            { r0[1]*r2[2] - r0[2]*r2[1], r0[2]*r2[0] - r0[0]*r2[2], r0[0]*r2[1] - r0[1]*r2[0] },
+            { r1[1]*r2[2] - r1[2]*r2[1], r1[2]*r2[0] - r1[0]*r2[2], r1[0]*r2[1] - r1[1]*r2[0] }
+        };
+        int best = 0;
+        double bestNorm = 0.0;
+        for(int i = 0; i < 3; ++i)
+        {
+            double norm = c[i][0]*c[i][0] + c[i][1]*c[i][1] + c[i][2]*c[i][2];
+            if(norm > bestNorm)
+            {
+                best = i;
+                bestNorm = norm;
+            }
+        }
+        if(bestNorm <= sq(1e-4*scale*scale))
+            return false;  // (nearly) repeated eigenvalue
+        double norm = std::sqrt(bestNorm);
+        v[k][0] = c[best][0] / norm;
+        v[k][1] = c[best][1] / norm;
+        v[k][2] = c[best][2] / norm;
+    }
+
+    // the middle eigenvector completes the orthonormal system
+    double m[3] = { v[1][1]*v[0][2] - v[1][2]*v[0][1],
+                    v[1][2]*v[0][0] - v[1][0]*v[0][2],
+                    v[1][0]*v[0][1] - v[1][1]*v[0][0] };
+    for(int i = 0; i < 3; ++i)
+    {
+        ev(i, 0) = (T)v[0][i];
+        ev(i, 1) = (T)m[i];
+        ev(i, 2) = (T)v[1][i];
+    }
+    return true;
+}
+
 } // namespace detail
 
 /** \addtogroup MatrixAlgebra
@@ -999,6 +1103,11 @@ bool hessenbergQrDecomposition(MultiArrayView<2, T, C1> & H, MultiArrayView<2, T
         converge. It can be applied in-place, i.e. <tt>&a == &ev</tt> is allowed.
         The code of this function was adapted from JAMA.
 
+        2x2 and 3x3 matrices are solved by closed-form (analytic) formulas
+        instead of the iterative algorithm. 3x3 matrices with (nearly)
+        repeated eigenvalues automatically fall back to the iterative path
+        to retain full accuracy.
+
     <b>\#include</b> \<vigra/eigensystem.hxx\> or<br>
     <b>\#include</b> \<vigra/linear_algebra.hxx\><br>
         Namespaces: vigra and vigra::linalg
@@ -1015,6 +1124,14 @@ symmetricEigensystem(MultiArrayView<2, T, C1> const & a,
                        acols == columnCount(ev) && acols == rowCount(ev),
         "symmetricEigensystem(): matrix shape mismatch.");
 
+    if(acols == 2)
+    {
+        detail::symmetricEigensystemFixed2x2(a, ew, ev);
+        return true;
+    }
+    if(acols == 3 && detail::symmetricEigensystemFixed3x3(a, ew, ev))
+        return true;
+
     ev.copy(a); // does nothing if &ev == &a
     Matrix<T> de(acols, 2);
     detail::housholderTridiagonalization(ev, de);
@@ -77,9 +77,23 @@
     \endcode
     
     is identical to <tt>vigra_precondition()</tt> except that it is completely removed
-    when '<TT>NDEBUG</TT>' is defined. This is useful for test that are only needed during 
-    debugging, such as array index bound checking. The following macro
-    
+    when '<TT>NDEBUG</TT>' is defined. This is useful for test that are only needed during
+    debugging, such as array index bound checking. Similarly,
+
+    \code
+    vigra_inner_precondition(PREDICATE, MESSAGE);
+    \endcode
+
+    is identical to <tt>vigra_precondition()</tt> unless the compiler flag
+    '<TT>VIGRA_NO_INNER_CHECKS</TT>' is defined, in which case it is completely
+    removed. It is used for checks that are repeated in inner loops (e.g. once
+    per line of an image) although they are already enforced at the API
+    boundary of the calling algorithm, so that validated pipelines can compile
+    them out without losing the checks at the API boundary. In all macros, the
+    PREDICATE is annotated as unlikely to fail where the compiler supports
+    branch hints, and the MESSAGE is only evaluated when the check actually
+    fires. The following macro
+
     \code
     vigra_fail(MESSAGE);
     \endcode
@@ -120,6 +134,16 @@
     \endcode
 **/
 
+// branch hints for the check macros: a contract violation is the
+// exceptional case, so tell the compiler to optimize for the taken branch
+#if defined(__GNUC__)
+#define VIGRA_LIKELY(PREDICATE) __builtin_expect(!!(PREDICATE), 1)
+#define VIGRA_UNLIKELY(PREDICATE) __builtin_expect(!!(PREDICATE), 0)
+#else
+#define VIGRA_LIKELY(PREDICATE) (PREDICATE)
+#define VIGRA_UNLIKELY(PREDICATE) (PREDICATE)
+#endif
+
 namespace vigra {
 
 class ContractViolation : public StdException
@@ -266,14 +290,25 @@ void throw_runtime_error(std::string message, char const * file, int line)
     throw std::runtime_error(what.str()); 
 }
 
-#define vigra_precondition(PREDICATE, MESSAGE) vigra::throw_precondition_error((PREDICATE), MESSAGE, __FILE__, __LINE__)
+// test the predicate inline (with a branch hint), so that the MESSAGE
+// expression is only evaluated when the check actually fires
+#define vigra_precondition(PREDICATE, MESSAGE) \
+    (VIGRA_LIKELY(PREDICATE) \
+        ? (void)0 \
+        : vigra::throw_precondition_error(false, MESSAGE, __FILE__, __LINE__))
 
 #define vigra_assert(PREDICATE, MESSAGE) vigra_precondition(PREDICATE, MESSAGE)
 
-#define vigra_postcondition(PREDICATE, MESSAGE) vigra::throw_postcondition_error((PREDICATE), MESSAGE, __FILE__, __LINE__)
+#define vigra_postcondition(PREDICATE, MESSAGE) \
+    (VIGRA_LIKELY(PREDICATE) \
+        ? (void)0 \
+        : vigra::throw_postcondition_error(false, MESSAGE, __FILE__, __LINE__))
+
+#define vigra_invariant(PREDICATE, MESSAGE) \
+    (VIGRA_LIKELY(PREDICATE) \
+        ? (void)0 \
+        : vigra::throw_invariant_error(false, MESSAGE, __FILE__, __LINE__))
 
-#define vigra_invariant(PREDICATE, MESSAGE) vigra::throw_invariant_error((PREDICATE), MESSAGE, __FILE__, __LINE__)
-            
 #define vigra_fail(MESSAGE) vigra::throw_runtime_error(MESSAGE, __FILE__, __LINE__)
 
 #else // NDEBUG
@@ -320,18 +355,40 @@ void throw_postcondition_error(bool predicate, std::string message)
        throw vigra::PostconditionViolation(message.c_str()); 
 }
 
-#define vigra_precondition(PREDICATE, MESSAGE) vigra::throw_precondition_error((PREDICATE), MESSAGE)
+#define vigra_precondition(PREDICATE, MESSAGE) \
+    (VIGRA_LIKELY(PREDICATE) \
+        ? (void)0 \
+        : vigra::throw_precondition_error(false, MESSAGE))
 
 #define vigra_assert(PREDICATE, MESSAGE)
 
-#define vigra_postcondition(PREDICATE, MESSAGE) vigra::throw_postcondition_error((PREDICATE), MESSAGE)
+#define vigra_postcondition(PREDICATE, MESSAGE) \
+    (VIGRA_LIKELY(PREDICATE) \
+        ? (void)0 \
+        : vigra::throw_postcondition_error(false, MESSAGE))
+
+#define vigra_invariant(PREDICATE, MESSAGE) \
+    (VIGRA_LIKELY(PREDICATE) \
+        ? (void)0 \
+        : vigra::throw_invariant_error(false, MESSAGE))
 
-#define vigra_invariant(PREDICATE, MESSAGE) vigra::throw_invariant_error((PREDICATE), MESSAGE)
-            
 #define vigra_fail(MESSAGE) throw std::runtime_error(MESSAGE)
 
 #endif // NDEBUG
 
+// checks that are repeated in inner loops, but already enforced at the API
+// boundary of the calling algorithm -- validated pipelines may define
+// VIGRA_NO_INNER_CHECKS to compile them out entirely
+#ifdef VIGRA_NO_INNER_CHECKS
+
+#define vigra_inner_precondition(PREDICATE, MESSAGE)
+
+#else
+
+#define vigra_inner_precondition(PREDICATE, MESSAGE) vigra_precondition(PREDICATE, MESSAGE)
+
+#endif // VIGRA_NO_INNER_CHECKS
+
 } // namespace vigra
 
 #endif // VIGRA_ERROR_HXX
@@ -39,12 +39,14 @@
 #include <cmath>
 #include <functional>
 #include <complex>
+#include <map>
 #include "stdimage.hxx"
 #include "copyimage.hxx"
 #include "transformimage.hxx"
 #include "combineimages.hxx"
 #include "numerictraits.hxx"
 #include "imagecontainer.hxx"
+#include "parallel_options.hxx"
 #include <fftw3.h>
 
 namespace vigra {
@@ -665,6 +667,28 @@ struct MultiMathOperand<FFTWComplex<Real> >
 
 } // namespace multi_math
 
+/** \brief STL-compatible allocator backed by <tt>fftw_malloc()</tt>.
+
+    <tt>fftw_malloc()</tt> returns memory that is sufficiently aligned for the
+    SIMD instructions used by FFTW's vectorized codelets (16 or 32 bytes,
+    depending on how FFTW was built). Arrays allocated with an ordinary
+    allocator may lack this alignment, in which case FFTW silently falls back
+    to slower unaligned codelets. Pass this class as the allocator template
+    parameter of \ref vigra::MultiArray for any array that takes part in
+    Fourier transforms:
+
+    \code
+    MultiArray<2, double, FFTWAllocator<double> > spatial(Shape2(w, h));
+    \endcode
+
+    Note that <tt>std::allocator\<FFTWComplex\<Real\> \></tt> is specialized
+    below to use <tt>fftw_malloc()</tt> as well, so complex-valued MultiArrays
+    are correctly aligned even with the default allocator; this class is
+    mainly needed for real-valued arrays.
+
+    <b>\#include</b> \<vigra/fftw3.hxx\><br>
+    Namespace: vigra
+*/
 template<class Ty>
 class FFTWAllocator
 {
@@ -1726,6 +1750,181 @@ inline void moveDCToUpperLeft(
                                           dest.first, dest.second);
 }
 
+/********************************************************/
+/*                                                      */
+/*                    FFTWPlanCache                     */
+/*                                                      */
+/********************************************************/
+
+/** \brief Cache for FFTW transform plans.
+
+    Every FFTW transform needs a plan, and creating one is expensive --
+    prohibitively so when the planner flags request thorough measurement
+    (e.g. <tt>FFTW_MEASURE</tt>). This class caches plans keyed by the
+    transform geometry (height, width, direction, and whether the transform
+    is in-place), so that repeated transforms of identical geometry pay the
+    planning cost exactly once. Plans are created with the
+    <tt>FFTW_UNALIGNED</tt> flag on scratch arrays, which makes them
+    applicable to arbitrarily aligned user data via FFTW's new-array execute
+    interface and prevents the planner from clobbering user arrays.
+
+    \ref fourierTransform() and \ref fourierTransformInverse() obtain their
+    plans from the global cache instance returned by
+    <tt>FFTWPlanCache::global()</tt>. Since the FFTW planner is not
+    thread-safe, all cache accesses are serialized (in the same critical
+    section the library already uses around planner calls), whereas the
+    actual transform execution runs fully in parallel. Alternatively, each
+    thread may own a private <tt>FFTWPlanCache</tt> instance and pass the
+    plans it returns to <tt>fftw_execute_dft()</tt> directly.
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/fftw3.hxx\><br>
+    Namespace: vigra
+
+    \code
+    // plan thoroughly once, reuse for thousands of equally-sized tiles
+    vigra::FFTWPlanCache::global().setPlannerFlags(FFTW_MEASURE);
+
+    for(unsigned int i = 0; i < tiles.size(); ++i)
+        fourierTransform(srcImageRange(tiles[i]), destImage(spectra[i]));
+    \endcode
+*/
+class FFTWPlanCache
+{
+  public:
+
+    FFTWPlanCache()
+    : planner_flags_(FFTW_ESTIMATE)
+    {}
+
+    ~FFTWPlanCache()
+    {
+        clear();
+    }
+
+        /** Set the FFTW planner flags (e.g. <tt>FFTW_ESTIMATE</tt>,
+            <tt>FFTW_MEASURE</tt>, <tt>FFTW_PATIENT</tt>) used for plans
+            created after this call (default: <tt>FFTW_ESTIMATE</tt>).
+            Call <tt>clear()</tt> to force re-planning of cached geometries.
+        */
+    void setPlannerFlags(unsigned int flags)
+    {
+        planner_flags_ = flags;
+    }
+
+    unsigned int plannerFlags() const
+    {
+        return planner_flags_;
+    }
+
+        /** Get the plan for a complex-to-complex transform of the given
+            geometry, creating and caching it if no matching plan exists.
+            The plan can be applied to arbitrary arrays of that geometry
+            with <tt>fftw_execute_dft()</tt>, provided in-place and
+            out-of-place calls match the \a inplace flag.
+        */
+    fftw_plan getPlan(int height, int width, int sign, bool inplace)
+    {
+        Key key(height, width, sign, inplace);
+        fftw_plan plan = 0;
+
+#ifdef _OPENMP
+        #pragma omp critical(vigra_fftw_plan)
+#endif
+        {
+            PlanMap::iterator p = plans_.find(key);
+            if(p != plans_.end())
+            {
+                plan = p->second;
+            }
+            else
+            {
+                // plan on scratch arrays so that measuring planner flags
+                // cannot clobber user data
+                fftw_complex * in =
+                    (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * height * width);
+                fftw_complex * out = inplace
+                    ? in
+                    : (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * height * width);
+
+                plan = fftw_plan_dft_2d(height, width, in, out, sign,
+                                        planner_flags_ | FFTW_UNALIGNED);
+
+                if(!inplace)
+                    fftw_free(out);
+                fftw_free(in);
+
+                if(plan != 0)
+                    plans_[key] = plan;
+            }
+        }
+
+        vigra_postcondition(plan != 0,
+            "FFTWPlanCache::getPlan(): FFTW planner failed.");
+        return plan;
+    }
+
+        /** Destroy all cached plans.
+        */
+    void clear()
+    {
+#ifdef _OPENMP
+        #pragma omp critical(vigra_fftw_plan)
+#endif
+        {
+            for(PlanMap::iterator p = plans_.begin(); p != plans_.end(); ++p)
+                fftw_destroy_plan(p->second);
+            plans_.clear();
+        }
+    }
+
+        /** Number of currently cached plans.
+        */
+    unsigned int size() const
+    {
+        return (unsigned int)plans_.size();
+    }
+
+        /** The global cache instance used by \ref fourierTransform() and
+            \ref fourierTransformInverse().
+        */
+    static FFTWPlanCache & global()
+    {
+        static FFTWPlanCache cache;
+        return cache;
+    }
+
+  private:
+
+    struct Key
+    {
+        int height, width, sign;
+        bool inplace;
+
+        Key(int h, int w, int s, bool i)
+        : height(h), width(w), sign(s), inplace(i)
+        {}
+
+        bool operator<(Key const & o) const
+        {
+            if(height != o.height) return height < o.height;
+            if(width != o.width)   return width < o.width;
+            if(sign != o.sign)     return sign < o.sign;
+            return inplace < o.inplace;
+        }
+    };
+
+    typedef std::map<Key, fftw_plan> PlanMap;
+
+    // not copyable -- the cache owns its plans
+    FFTWPlanCache(FFTWPlanCache const &);
+    FFTWPlanCache & operator=(FFTWPlanCache const &);
+
+    PlanMap plans_;
+    unsigned int planner_flags_;
+};
+
 namespace detail {
 
 template <class T>
@@ -1755,9 +1954,8 @@ fourierTransformImpl(FFTWComplexImage::const_traverser sul,
         destPtr = (fftw_complex *)(&(*dworkImage.upperLeft()));
     }
 
-    fftw_plan plan = fftw_plan_dft_2d(h, w, srcPtr, destPtr, sign, FFTW_ESTIMATE );
-    fftw_execute(plan);
-    fftw_destroy_plan(plan);
+    fftw_plan plan = FFTWPlanCache::global().getPlan(h, w, sign, srcPtr == destPtr);
+    fftw_execute_dft(plan, srcPtr, destPtr);
 
     if (h > 1 && &(*(dul + Diff2D(w, 0))) != &(*(dul + Diff2D(0, 1))))
     {
@@ -1793,6 +1991,8 @@ fourierTransformImpl(FFTWComplexImage::const_traverser sul,
     can simply be dropped. By convention, this reduction is applied to the first (innermost) dimension, 
     such that <tt>fourier.shape(0) == spatial.shape(0)/2 + 1</tt> holds. The correct frequency domain
     shape can be conveniently computed by means of the function \ref fftwCorrespondingShapeR2C().
+    Alternatively, pass a \ref vigra::FFTWHermitianSpectrum, which bundles the packed half spectrum
+    with the spatial shape it came from, so the inverse transform needs no extra bookkeeping.
     
     Note that your program must always link against <tt>libfftw3</tt>. If you want to compute Fourier 
     transforms for <tt>float</tt> or <tt>long double</tt> arrays, you must <i>additionally</i> link against <tt>libfftw3f</tt> and <tt>libfftw3l</tt> respectively. (Old-style functions only support <tt>double</tt>).
@@ -1800,7 +2000,11 @@ fourierTransformImpl(FFTWComplexImage::const_traverser sul,
     The Fourier transform functions internally create <a href="http://www.fftw.org/doc/Using-Plans.html">FFTW plans</a>
     which control the algorithm details. The plans are creates with the flag <tt>FFTW_ESTIMATE</tt>, i.e.
     optimal settings are guessed or read from saved "wisdom" files. If you need more control over planning,
-    you can use the class \ref FFTWPlan.
+    you can use the class \ref FFTWPlan. The old-style (iterator-based) functions obtain their plans
+    from \ref vigra::FFTWPlanCache "FFTWPlanCache::global()", so repeated transforms of identical
+    geometry pay the planning cost only once; call
+    <tt>FFTWPlanCache::global().setPlannerFlags(FFTW_MEASURE)</tt> before the first transform to
+    enable thorough planning.
     
     <b> Declarations:</b>
 
@@ -1808,17 +2012,22 @@ fourierTransformImpl(FFTWComplexImage::const_traverser sul,
     \code
     namespace vigra {
         template <unsigned int N, class Real, class C1, class C2>
-        void 
-        fourierTransform(MultiArrayView<N, FFTWComplex<Real>, C1> in, 
+        void
+        fourierTransform(MultiArrayView<N, FFTWComplex<Real>, C1> in,
                          MultiArrayView<N, FFTWComplex<Real>, C2> out);
 
         template <unsigned int N, class Real, class C1, class C2>
-        void 
-        fourierTransformInverse(MultiArrayView<N, FFTWComplex<Real>, C1> in, 
+        void
+        fourierTransformInverse(MultiArrayView<N, FFTWComplex<Real>, C1> in,
                                 MultiArrayView<N, FFTWComplex<Real>, C2> out);
     }
     \endcode
 
+    All MultiArrayView variants also accept an additional \ref vigra::ParallelOptions
+    argument. It runs the single transform with FFTW's multi-threaded runtime, which
+    pays off for large volumes (the program must link against <tt>libfftw3_threads</tt>
+    etc.); see \ref vigra::FFTWPlan::setPlannerThreads() for details.
+
     use real-valued MultiArrayView in the spatial domain, complex-valued MultiArrayView 
     in the frequency domain (this works for arbitrary dimension N, and also supports
     the R2C and C2R transform, depending on the array shape in the frequency domain):
@@ -2404,6 +2613,143 @@ void applyFourierFilterFamilyImpl(
     fftw_destroy_plan(backwardPlan);
 }
 
+/** \brief Apply an array of filters in parallel.
+
+    These overloads of \ref applyFourierFilterFamily() take a
+    \ref vigra::ParallelOptions object and distribute the per-filter work
+    (frequency-domain multiplication, inverse transform, normalization) over
+    several threads. The forward transform of the source image is still computed
+    only once. This is especially profitable for large filter banks such as
+    \ref vigra::GaborFilterFamily, where the filter applications dominate the
+    total cost. When the library is compiled without OpenMP, the filters are
+    applied sequentially.
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/fftw3.hxx\><br>
+    Namespace: vigra
+
+    \code
+    vigra::GaborFilterFamily<vigra::FImage> filters(image.size());
+    vigra::ImageArray<vigra::FFTWComplexImage> results;
+
+    vigra::applyFourierFilterFamily(srcImageRange(image), filters, results,
+                                    vigra::ParallelOptions().numThreads(4));
+    \endcode
+*/
+template <class SrcImageIterator, class SrcAccessor,
+          class FilterType, class DestImage>
+inline
+void applyFourierFilterFamily(triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
+                              const ImageArray<FilterType> &filters,
+                              ImageArray<DestImage> &results,
+                              ParallelOptions const & options)
+{
+    applyFourierFilterFamily(src.first, src.second, src.third,
+                             filters, results, options);
+}
+
+template <class SrcImageIterator, class SrcAccessor,
+          class FilterType, class DestImage>
+void applyFourierFilterFamily(SrcImageIterator srcUpperLeft,
+                              SrcImageIterator srcLowerRight, SrcAccessor sa,
+                              const ImageArray<FilterType> &filters,
+                              ImageArray<DestImage> &results,
+                              ParallelOptions const & options)
+{
+    int w = int(srcLowerRight.x - srcUpperLeft.x);
+    int h = int(srcLowerRight.y - srcUpperLeft.y);
+
+    FFTWComplexImage workImage(w, h);
+    copyImage(srcIterRange(srcUpperLeft, srcLowerRight, sa),
+              destImage(workImage, FFTWWriteRealAccessor<>()));
+
+    FFTWComplexImage const & cworkImage = workImage;
+    applyFourierFilterFamilyImpl(cworkImage.upperLeft(), cworkImage.lowerRight(), cworkImage.accessor(),
+                                 filters, results, options);
+}
+
+template <class FilterType, class DestImage>
+void applyFourierFilterFamilyImpl(
+    FFTWComplexImage::const_traverser srcUpperLeft,
+    FFTWComplexImage::const_traverser srcLowerRight,
+    FFTWComplexImage::ConstAccessor sa,
+    const ImageArray<FilterType> &filters,
+    ImageArray<DestImage> &results,
+    ParallelOptions const & options)
+{
+#ifndef _OPENMP
+    applyFourierFilterFamilyImpl(srcUpperLeft, srcLowerRight, sa,
+                                 filters, results);
+    (void)options;
+#else
+    if(options.getNumThreads() == 1)
+    {
+        applyFourierFilterFamilyImpl(srcUpperLeft, srcLowerRight, sa,
+                                     filters, results);
+        return;
+    }
+
+    // make sure the filter images have the right dimensions
+    vigra_precondition((srcLowerRight - srcUpperLeft) == filters.imageSize(),
+                       "applyFourierFilterFamily called with src image size != filters.imageSize()!");
+
+    // make sure the result image array has the right dimensions
+    results.resize(filters.size());
+    results.resizeImages(filters.imageSize());
+
+    // FFT from srcImage to freqImage (once, shared by all filters)
+    int w = int(srcLowerRight.x - srcUpperLeft.x);
+    int h = int(srcLowerRight.y - srcUpperLeft.y);
+
+    FFTWComplexImage freqImage(w, h);
+
+    fftw_plan forwardPlan=
+        fftw_plan_dft_2d(h, w, (fftw_complex *)&(*srcUpperLeft),
+                               (fftw_complex *)freqImage.begin(),
+                               FFTW_FORWARD, FFTW_ESTIMATE );
+    fftw_execute(forwardPlan);
+    fftw_destroy_plan(forwardPlan);
+
+    typedef typename
+        NumericTraits<typename DestImage::Accessor::value_type>::isScalar
+        isScalarResult;
+
+    #pragma omp parallel num_threads(options.getNumThreads())
+    {
+        // each thread convolves with its share of the filters,
+        // using a private scratch image and backward plan
+        // (FFTW plan creation/destruction is not thread-safe)
+        FFTWComplexImage result(w, h);
+
+        fftw_plan backwardPlan;
+        #pragma omp critical(vigra_fftw_plan)
+        backwardPlan=
+            fftw_plan_dft_2d(h, w, (fftw_complex *)result.begin(),
+                                   (fftw_complex *)result.begin(),
+                                   FFTW_BACKWARD, FFTW_ESTIMATE );
+
+        #pragma omp for
+        for (int i= 0;  i < (int)filters.size(); i++)
+        {
+            combineTwoImages(srcImageRange(freqImage), srcImage(filters[i]),
+                             destImage(result), std::multiplies<FFTWComplex<> >());
+
+            // FFT back into spatial domain (inplace in destImage)
+            fftw_execute(backwardPlan);
+
+            // normalization (after FFTs), maybe stripping imaginary part
+            applyFourierFilterImplNormalization(result,
+                                                results[i].upperLeft(), results[i].accessor(),
+                                                isScalarResult());
+        }
+
+        #pragma omp critical(vigra_fftw_plan)
+        fftw_destroy_plan(backwardPlan);
+    }
+#endif // _OPENMP
+}
+
 /********************************************************/
 /*                                                      */
 /*                fourierTransformReal                  */
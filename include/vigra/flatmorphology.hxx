@@ -40,9 +40,219 @@
 #include <cmath>
 #include <vector>
 #include "utilities.hxx"
+#include "parallel_options.hxx"
 
 namespace vigra {
 
+namespace detail {
+
+/********************************************************/
+/*                                                      */
+/*               discRankOrderFilterRow                 */
+/*                                                      */
+/********************************************************/
+
+// Compute one row of the disc rank order filter with a sliding histogram
+// (Huang et al.): the disc histogram is built once at the row start and
+// then updated incrementally while the window moves right, by removing
+// the pixels of the trailing disc boundary and adding those of the
+// leading one. The rank position is re-found from its previous value, so
+// only the changed part of the histogram is rescanned. Rows are
+// completely independent of each other, which allows their parallel
+// execution.
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void
+discRankOrderFilterRow(SrcIterator ys, SrcAccessor sa,
+                       DestIterator yd, DestAccessor da,
+                       int w, int h, int y,
+                       int radius, float rank,
+                       int const * struct_function)
+{
+    int i, x, xmax, ymax, xx, yy;
+    int rankpos, winsize, leftsum;
+
+    long hist[256];
+
+    SrcIterator xs(ys);
+    DestIterator xd(yd);
+
+    // first column
+    int x0 = 0;
+    int y0 = y;
+    int x1 = w - 1;
+    int y1 = h - y - 1;
+
+    // clear histogram
+    for(i=0; i<256; ++i) hist[i] = 0;
+    winsize = 0;
+
+    // init histogram
+    ymax = (y1 < radius) ? y1 : radius;
+    for(yy=0; yy<=ymax; ++yy)
+    {
+        xmax = (x1 < struct_function[yy]) ? x1 : struct_function[yy];
+        for(xx=0; xx<=xmax; ++xx)
+        {
+            hist[sa(xs, Diff2D(xx, yy))]++;
+            winsize++;
+        }
+    }
+
+    ymax = (y0 < radius) ? y0 : radius;
+    for(yy=1; yy<=ymax; ++yy)
+    {
+        xmax = (x1 < struct_function[yy]) ? x1 : struct_function[yy];
+        for(xx=0; xx<=xmax; ++xx)
+        {
+            hist[sa(xs, Diff2D(xx, -yy))]++;
+            winsize++;
+        }
+    }
+
+    // find the desired histogram bin
+    leftsum = 0;
+    if(rank == 0.0)
+    {
+        for(i=0; i<256; i++)
+        {
+            if(hist[i]) break;
+        }
+        rankpos = i;
+    }
+    else
+    {
+        for(i=0; i<256; i++)
+        {
+            if((float)(hist[i]+leftsum) / winsize >= rank) break;
+            leftsum += hist[i];
+        }
+        rankpos = i;
+    }
+
+    da.set(rankpos, xd);
+
+    ++xs.x;
+    ++xd.x;
+
+    // inner columns
+    for(x=1; x<w; ++x, ++xs.x, ++xd.x)
+    {
+        x0 = x;
+        y0 = y;
+        x1 = w - x - 1;
+        y1 = h - y - 1;
+
+        // update histogram
+        // remove pixels at left border
+        yy = (y1 < radius) ? y1 : radius;
+        for(; yy>=0; yy--)
+        {
+            unsigned char cur;
+            xx = struct_function[yy]+1;
+            if(xx > x0) break;
+
+            cur = sa(xs, Diff2D(-xx, yy));
+
+            hist[cur]--;
+            if(cur < rankpos) leftsum--;
+            winsize--;
+        }
+        yy = (y0 < radius) ? y0 : radius;
+        for(; yy>=1; yy--)
+        {
+            unsigned char cur;
+            xx = struct_function[yy]+1;
+            if(xx > x0) break;
+
+            cur = sa(xs, Diff2D(-xx, -yy));
+
+            hist[cur]--;
+            if(cur < rankpos) leftsum--;
+            winsize--;
+        }
+
+        // add pixels at right border
+        yy = (y1 < radius) ? y1 : radius;
+        for(; yy>=0; yy--)
+        {
+            unsigned char cur;
+            xx = struct_function[yy];
+            if(xx > x1) break;
+
+            cur = sa(xs, Diff2D(xx, yy));
+
+            hist[cur]++;
+            if(cur < rankpos) leftsum++;
+            winsize++;
+        }
+        yy = (y0 < radius) ? y0 : radius;
+        for(; yy>=1; yy--)
+        {
+            unsigned char cur;
+            xx = struct_function[yy];
+            if(xx > x1) break;
+
+            cur = sa(xs, Diff2D(xx, -yy));
+
+            hist[cur]++;
+            if(cur < rankpos) leftsum++;
+            winsize++;
+        }
+
+        // find the desired histogram bin
+        if(rank == 0.0)
+        {
+            if(leftsum == 0)
+            {
+                // search to the right
+                for(i=rankpos; i<256; i++)
+                {
+                    if(hist[i]) break;
+                }
+                rankpos = i;
+            }
+            else
+            {
+                // search to the left
+                for(i=rankpos-1; i>=0; i--)
+                {
+                    leftsum -= hist[i];
+                    if(leftsum == 0) break;
+                }
+                rankpos = i;
+            }
+        }
+        else  // rank > 0.0
+        {
+            if((float)leftsum / winsize < rank)
+            {
+                // search to the right
+                for(i=rankpos; i<256; i++)
+                {
+                    if((float)(hist[i]+leftsum) / winsize >= rank) break;
+                    leftsum+=hist[i];
+                }
+                rankpos = i;
+            }
+            else
+            {
+                // search to the left
+                for(i=rankpos-1; i>=0; i--)
+                {
+                    leftsum-=hist[i];
+                    if((float)leftsum / winsize < rank) break;
+                }
+                rankpos = i;
+            }
+        }
+
+        da.set(rankpos, xd);
+    }
+}
+
+} // namespace detail
+
 /** \addtogroup Morphology Basic Morphological Operations
     Perform erosion, dilation, and median with disc structuring functions
     
@@ -63,16 +273,25 @@ namespace vigra {
     <= 1.0. The filter acts as a minimum filter if rank = 0.0, 
     as a median if rank = 0.5, and as a maximum filter if rank = 1.0.
     Accessor are used to access the pixel data.
-    
+
+    The filter maintains a sliding histogram of the disc (Huang et al.):
+    when the window moves one pixel to the right, only the pixels entering
+    and leaving the disc boundary are processed. Since every row computes
+    its own histogram, the rows are independent, and the overloads taking a
+    \ref vigra::ParallelOptions argument distribute contiguous bands of
+    rows over the requested number of threads, with results identical to
+    the sequential version. Without OpenMP support, or when one thread is
+    requested, this simply calls the sequential algorithm.
+
     <b> Declarations:</b>
-    
+
     pass arguments explicitly:
     \code
     namespace vigra {
         template <class SrcIterator, class SrcAccessor,
                   class DestIterator, class DestAccessor>
         void
-        discRankOrderFilter(SrcIterator upperleft1, 
+        discRankOrderFilter(SrcIterator upperleft1,
                             SrcIterator lowerright1, SrcAccessor sa,
                             DestIterator upperleft2, DestAccessor da,
                             int radius, float rank)
@@ -147,16 +366,13 @@ discRankOrderFilter(SrcIterator upperleft1,
     
     vigra_precondition(radius >= 0,
             "discRankOrderFilter(): Radius must be >= 0.");
-    
-    int i, x, y, xmax, ymax, xx, yy;
-    int rankpos, winsize, leftsum;
-    
-    long hist[256];
-    
+
+    int i, y;
+
     // prepare structuring function
     std::vector<int> struct_function(radius+1);
     struct_function[0] = radius;
-    
+
     double r2 = (double)radius*radius;
     for(i=1; i<=radius; ++i)
     {
@@ -166,188 +382,98 @@ discRankOrderFilter(SrcIterator upperleft1,
 
     int w = lowerright1.x - upperleft1.x;
     int h = lowerright1.y - upperleft1.y;
-    
+
     SrcIterator ys(upperleft1);
     DestIterator yd(upperleft2);
 
     for(y=0; y<h; ++y, ++ys.y, ++yd.y)
     {
-        SrcIterator xs(ys);
-        DestIterator xd(yd);
-        
-        // first column
-        int x0 = 0;
-        int y0 = y;
-        int x1 = w - 1;
-        int y1 = h - y - 1;
+        detail::discRankOrderFilterRow(ys, sa, yd, da, w, h, y,
+                                       radius, rank, &struct_function[0]);
+    }
+}
 
-        // clear histogram
-        for(i=0; i<256; ++i) hist[i] = 0;
-        winsize = 0;
-        
-        // init histogram
-        ymax = (y1 < radius) ? y1 : radius;
-        for(yy=0; yy<=ymax; ++yy)
-        {
-            xmax = (x1 < struct_function[yy]) ? x1 : struct_function[yy];
-            for(xx=0; xx<=xmax; ++xx)
-            {
-                hist[sa(xs, Diff2D(xx, yy))]++;
-                winsize++;
-            }
-        }
-        
-        ymax = (y0 < radius) ? y0 : radius;
-        for(yy=1; yy<=ymax; ++yy)
-        {
-            xmax = (x1 < struct_function[yy]) ? x1 : struct_function[yy];
-            for(xx=0; xx<=xmax; ++xx)
-            {
-                hist[sa(xs, Diff2D(xx, -yy))]++;
-                winsize++;
-            }
-        }
-    
-        // find the desired histogram bin 
-        leftsum = 0;
-        if(rank == 0.0)
-        {
-            for(i=0; i<256; i++)
-            {
-                if(hist[i]) break;
-            }
-            rankpos = i;
-        }
-        else
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void
+discRankOrderFilter(SrcIterator upperleft1,
+                    SrcIterator lowerright1, SrcAccessor sa,
+                    DestIterator upperleft2, DestAccessor da,
+                    int radius, float rank,
+                    ParallelOptions const & options)
+{
+    vigra_precondition((rank >= 0.0) && (rank <= 1.0),
+            "discRankOrderFilter(): Rank must be between 0 and 1"
+            " (inclusive).");
+
+    vigra_precondition(radius >= 0,
+            "discRankOrderFilter(): Radius must be >= 0.");
+
+#ifdef _OPENMP
+    int h = lowerright1.y - upperleft1.y;
+
+    int num_threads = options.getNumThreads();
+    if(num_threads > h)
+        num_threads = h;
+    if(num_threads > 1)
+    {
+        int w = lowerright1.x - upperleft1.x;
+
+        // prepare structuring function
+        std::vector<int> struct_function(radius+1);
+        struct_function[0] = radius;
+
+        double r2 = (double)radius*radius;
+        for(int i=1; i<=radius; ++i)
         {
-            for(i=0; i<256; i++)
-            {
-                if((float)(hist[i]+leftsum) / winsize >= rank) break;
-                leftsum += hist[i];
-            }
-            rankpos = i;
+            double r = (double) i - 0.5;
+            struct_function[i] = (int)(VIGRA_CSTD::sqrt(r2 - r*r) + 0.5);
         }
-        
-        da.set(rankpos, xd);
-        
-        ++xs.x;
-        ++xd.x;
-        
-        // inner columns
-        for(x=1; x<w; ++x, ++xs.x, ++xd.x)
+
+        // every row builds its own sliding histogram, so the rows can be
+        // distributed over the threads in contiguous bands
+        std::vector<int> bounds(num_threads+1);
+        for(int t = 0; t <= num_threads; ++t)
+            bounds[t] = (int)(((long long)h * t) / num_threads);
+
+        std::string errorMessage;
+
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(int t = 0; t < num_threads; ++t)
         {
-            x0 = x;
-            y0 = y;
-            x1 = w - x - 1;
-            y1 = h - y - 1;
-            
-            // update histogram 
-            // remove pixels at left border 
-            yy = (y1 < radius) ? y1 : radius;
-            for(; yy>=0; yy--)
-            {
-                unsigned char cur;
-                xx = struct_function[yy]+1;
-                if(xx > x0) break;
-                
-                cur = sa(xs, Diff2D(-xx, yy));
-                
-                hist[cur]--;
-                if(cur < rankpos) leftsum--;
-                winsize--;
-            }
-            yy = (y0 < radius) ? y0 : radius;
-            for(; yy>=1; yy--)
-            {
-                unsigned char cur;
-                xx = struct_function[yy]+1;
-                if(xx > x0) break;
-                
-                cur = sa(xs, Diff2D(-xx, -yy));
-                
-                hist[cur]--;
-                if(cur < rankpos) leftsum--;
-                winsize--;
-            }
-            
-            // add pixels at right border 
-            yy = (y1 < radius) ? y1 : radius;
-            for(; yy>=0; yy--)
-            {
-                unsigned char cur;
-                xx = struct_function[yy];
-                if(xx > x1) break;
-                
-                cur = sa(xs, Diff2D(xx, yy));
-                
-                hist[cur]++;
-                if(cur < rankpos) leftsum++;
-                winsize++;
-            }
-            yy = (y0 < radius) ? y0 : radius;
-            for(; yy>=1; yy--)
-            {
-                unsigned char cur;
-                xx = struct_function[yy];
-                if(xx > x1) break;
-                
-                cur = sa(xs, Diff2D(xx, -yy));
-                
-                hist[cur]++;
-                if(cur < rankpos) leftsum++;
-                winsize++;
-            }
-        
-            // find the desired histogram bin 
-            if(rank == 0.0)
+            try
             {
-                if(leftsum == 0)
-                {
-                    // search to the right 
-                    for(i=rankpos; i<256; i++)
-                    {
-                        if(hist[i]) break;
-                    }
-                    rankpos = i;
-                }
-                else
+                SrcIterator ys(upperleft1);
+                DestIterator yd(upperleft2);
+                ys.y += bounds[t];
+                yd.y += bounds[t];
+
+                for(int y = bounds[t]; y < bounds[t+1]; ++y, ++ys.y, ++yd.y)
                 {
-                    // search to the left 
-                    for(i=rankpos-1; i>=0; i--)
-                    {
-                        leftsum -= hist[i];
-                        if(leftsum == 0) break;
-                    }
-                    rankpos = i;
+                    detail::discRankOrderFilterRow(ys, sa, yd, da, w, h, y,
+                                                   radius, rank, &struct_function[0]);
                 }
             }
-            else  // rank > 0.0 
+            catch(std::exception & e)
             {
-                if((float)leftsum / winsize < rank)
-                {
-                    // search to the right 
-                    for(i=rankpos; i<256; i++)
-                    {
-                        if((float)(hist[i]+leftsum) / winsize >= rank) break;
-                        leftsum+=hist[i];
-                    }
-                    rankpos = i;
-                }
-                else
-                {
-                    // search to the left 
-                    for(i=rankpos-1; i>=0; i--)
-                    {
-                        leftsum-=hist[i];
-                        if((float)leftsum / winsize < rank) break;
-                    }
-                    rankpos = i;
-                }
+#pragma omp critical(vigra_disc_rank_order_filter_error)
+                errorMessage = e.what();
+            }
+            catch(...)
+            {
+#pragma omp critical(vigra_disc_rank_order_filter_error)
+                errorMessage = "unknown exception";
             }
-                    
-            da.set(rankpos, xd);
         }
+
+        if(errorMessage.size())
+            vigra_fail("discRankOrderFilter(): worker thread failed with:\n" + errorMessage);
+        return;
     }
+#endif // _OPENMP
+
+    discRankOrderFilter(upperleft1, lowerright1, sa,
+                        upperleft2, da, radius, rank);
 }
 
 template <class SrcIterator, class SrcAccessor,
@@ -362,6 +488,19 @@ discRankOrderFilter(triple<SrcIterator, SrcIterator, SrcAccessor> src,
                         radius, rank);
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void
+discRankOrderFilter(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                    pair<DestIterator, DestAccessor> dest,
+                    int radius, float rank,
+                    ParallelOptions const & options)
+{
+    discRankOrderFilter(src.first, src.second, src.third,
+                        dest.first, dest.second,
+                        radius, rank, options);
+}
+
 /********************************************************/
 /*                                                      */
 /*                      discErosion                     */
@@ -426,12 +565,40 @@ discErosion(triple<SrcIterator, SrcIterator, SrcAccessor> src,
             int radius)
 {
     vigra_precondition(radius >= 0, "discErosion(): Radius must be >= 0.");
-    
+
     discRankOrderFilter(src.first, src.second, src.third,
                         dest.first, dest.second,
                         radius, 0.0);
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void
+discErosion(SrcIterator upperleft1,
+            SrcIterator lowerright1, SrcAccessor sa,
+            DestIterator upperleft2, DestAccessor da,
+            int radius, ParallelOptions const & options)
+{
+    vigra_precondition(radius >= 0, "discErosion(): Radius must be >= 0.");
+
+    discRankOrderFilter(upperleft1, lowerright1, sa,
+                        upperleft2, da, radius, 0.0, options);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void
+discErosion(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+            pair<DestIterator, DestAccessor> dest,
+            int radius, ParallelOptions const & options)
+{
+    vigra_precondition(radius >= 0, "discErosion(): Radius must be >= 0.");
+
+    discRankOrderFilter(src.first, src.second, src.third,
+                        dest.first, dest.second,
+                        radius, 0.0, options);
+}
+
 /********************************************************/
 /*                                                      */
 /*                     discDilation                     */
@@ -502,6 +669,34 @@ discDilation(triple<SrcIterator, SrcIterator, SrcAccessor> src,
                         radius, 1.0);
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void
+discDilation(SrcIterator upperleft1,
+            SrcIterator lowerright1, SrcAccessor sa,
+            DestIterator upperleft2, DestAccessor da,
+            int radius, ParallelOptions const & options)
+{
+    vigra_precondition(radius >= 0, "discDilation(): Radius must be >= 0.");
+
+    discRankOrderFilter(upperleft1, lowerright1, sa,
+                        upperleft2, da, radius, 1.0, options);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void
+discDilation(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+            pair<DestIterator, DestAccessor> dest,
+            int radius, ParallelOptions const & options)
+{
+    vigra_precondition(radius >= 0, "discDilation(): Radius must be >= 0.");
+
+    discRankOrderFilter(src.first, src.second, src.third,
+                        dest.first, dest.second,
+                        radius, 1.0, options);
+}
+
 /********************************************************/
 /*                                                      */
 /*                      discMedian                      */
@@ -572,6 +767,34 @@ discMedian(triple<SrcIterator, SrcIterator, SrcAccessor> src,
                         radius, 0.5);
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void
+discMedian(SrcIterator upperleft1,
+            SrcIterator lowerright1, SrcAccessor sa,
+            DestIterator upperleft2, DestAccessor da,
+            int radius, ParallelOptions const & options)
+{
+    vigra_precondition(radius >= 0, "discMedian(): Radius must be >= 0.");
+
+    discRankOrderFilter(upperleft1, lowerright1, sa,
+                        upperleft2, da, radius, 0.5, options);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void
+discMedian(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+            pair<DestIterator, DestAccessor> dest,
+            int radius, ParallelOptions const & options)
+{
+    vigra_precondition(radius >= 0, "discMedian(): Radius must be >= 0.");
+
+    discRankOrderFilter(src.first, src.second, src.third,
+                        dest.first, dest.second,
+                        radius, 0.5, options);
+}
+
 /********************************************************/
 /*                                                      */
 /*            discRankOrderFilterWithMask               */
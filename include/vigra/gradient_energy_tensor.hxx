@@ -45,6 +45,7 @@
 #include "combineimages.hxx"
 #include "numerictraits.hxx"
 #include "convolution.hxx"
+#include "parallel_options.hxx"
 
 namespace vigra {
 
@@ -89,6 +90,13 @@ namespace vigra {
         void gradientEnergyTensor(SrcIterator supperleft, SrcIterator slowerright, SrcAccessor src,
                                   DestIterator dupperleft, DestAccessor dest,
                                   Kernel1D<double> const & derivKernel, Kernel1D<double> const & smoothKernel);
+
+        template <class SrcIterator, class SrcAccessor,
+                  class DestIterator, class DestAccessor>
+        void gradientEnergyTensor(SrcIterator supperleft, SrcIterator slowerright, SrcAccessor src,
+                                  DestIterator dupperleft, DestAccessor dest,
+                                  Kernel1D<double> const & derivKernel, Kernel1D<double> const & smoothKernel,
+                                  ParallelOptions const & options);
     }
     \endcode
 
@@ -100,9 +108,22 @@ namespace vigra {
         void gradientEnergyTensor(triple<SrcIterator, SrcIterator, SrcAccessor> src,
                                   pair<DestIterator, DestAccessor> dest,
                                   Kernel1D<double> const & derivKernel, Kernel1D<double> const & smoothKernel);
+
+        template <class SrcIterator, class SrcAccessor,
+                  class DestIterator, class DestAccessor>
+        void gradientEnergyTensor(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                                  pair<DestIterator, DestAccessor> dest,
+                                  Kernel1D<double> const & derivKernel, Kernel1D<double> const & smoothKernel,
+                                  ParallelOptions const & options);
     }
     \endcode
 
+    The overloads taking a \ref vigra::ParallelOptions argument compute the same result
+    (bit for bit), but run the independent derivative convolutions concurrently and
+    evaluate the per-pixel tensor combination row by row in parallel when OpenMP is
+    enabled. The combination is rewritten over contiguous rows of the intermediate
+    images so that the compiler can vectorize it.
+
     <b> Usage:</b>
 
     <b>\#include</b> \<vigra/gradient_energy_tensor.hxx\>
@@ -185,6 +206,130 @@ void gradientEnergyTensor(triple<SrcIterator, SrcIterator, SrcAccessor> src,
                          dest.first, dest.second, derivKernel, smoothKernel);
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void gradientEnergyTensor(SrcIterator supperleft, SrcIterator slowerright, SrcAccessor src,
+                          DestIterator dupperleft, DestAccessor dest,
+                          Kernel1D<double> const & derivKernel, Kernel1D<double> const & smoothKernel,
+                          ParallelOptions const & options)
+{
+    vigra_precondition(dest.size(dupperleft) == 3,
+                       "gradientEnergyTensor(): output image must have 3 bands.");
+
+    int w = slowerright.x - supperleft.x;
+    int h = slowerright.y - supperleft.y;
+
+    typedef typename
+       NumericTraits<typename SrcAccessor::value_type>::RealPromote TmpType;
+    typedef BasicImage<TmpType> TmpImage;
+    TmpImage gx(w, h), gy(w, h),
+             gxx(w, h), gxy(w, h), gyy(w, h),
+             laplace(w, h), gx3(w, h), gy3(w, h);
+
+    // the convolutions within each group are independent of each other
+#ifdef _OPENMP
+#pragma omp parallel sections num_threads(options.getNumThreads())
+#endif
+    {
+#ifdef _OPENMP
+#pragma omp section
+#endif
+        convolveImage(srcIterRange(supperleft, slowerright, src), destImage(gx),
+                      derivKernel, smoothKernel);
+#ifdef _OPENMP
+#pragma omp section
+#endif
+        convolveImage(srcIterRange(supperleft, slowerright, src), destImage(gy),
+                      smoothKernel, derivKernel);
+    }
+#ifdef _OPENMP
+#pragma omp parallel sections num_threads(options.getNumThreads())
+#endif
+    {
+#ifdef _OPENMP
+#pragma omp section
+#endif
+        convolveImage(srcImageRange(gx), destImage(gxx),
+                      derivKernel, smoothKernel);
+#ifdef _OPENMP
+#pragma omp section
+#endif
+        convolveImage(srcImageRange(gx), destImage(gxy),
+                      smoothKernel, derivKernel);
+#ifdef _OPENMP
+#pragma omp section
+#endif
+        convolveImage(srcImageRange(gy), destImage(gyy),
+                      smoothKernel, derivKernel);
+    }
+    combineTwoImages(srcImageRange(gxx), srcImage(gyy), destImage(laplace),
+                     std::plus<TmpType>());
+#ifdef _OPENMP
+#pragma omp parallel sections num_threads(options.getNumThreads())
+#endif
+    {
+#ifdef _OPENMP
+#pragma omp section
+#endif
+        convolveImage(srcImageRange(laplace), destImage(gx3),
+                      derivKernel, smoothKernel);
+#ifdef _OPENMP
+#pragma omp section
+#endif
+        convolveImage(srcImageRange(laplace), destImage(gy3),
+                      smoothKernel, derivKernel);
+    }
+
+    // combine the derivative images row by row: the arithmetic runs over
+    // contiguous rows of the intermediate images into dense row buffers
+    // (vectorizable), and only the final scatter goes through the accessor
+#ifdef _OPENMP
+#pragma omp parallel num_threads(options.getNumThreads())
+#endif
+    {
+        ArrayVector<TmpType> t11(w), t12(w), t22(w);
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for(int y = 0; y < h; ++y)
+        {
+            TmpType const * pgx  = gx[y],
+                          * pgy  = gy[y],
+                          * pgxx = gxx[y],
+                          * pgxy = gxy[y],
+                          * pgyy = gyy[y],
+                          * pgx3 = gx3[y],
+                          * pgy3 = gy3[y];
+            for(int x = 0; x < w; ++x)
+            {
+                t11[x] = sq(pgxx[x]) + sq(pgxy[x]) - pgx[x] * pgx3[x];
+                t12[x] = - pgxy[x] * (pgxx[x] + pgyy[x]) + 0.5 * (pgx[x] * pgy3[x] + pgy[x] * pgx3[x]);
+                t22[x] = sq(pgxy[x]) + sq(pgyy[x]) - pgy[x] * pgy3[x];
+            }
+            DestIterator drow = dupperleft + Diff2D(0, y);
+            typename DestIterator::row_iterator d = drow.rowIterator();
+            for(int x = 0; x < w; ++x, ++d)
+            {
+                dest.setComponent(t11[x], d, 0);
+                dest.setComponent(t12[x], d, 1);
+                dest.setComponent(t22[x], d, 2);
+            }
+        }
+    }
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline
+void gradientEnergyTensor(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                          pair<DestIterator, DestAccessor> dest,
+                          Kernel1D<double> const & derivKernel, Kernel1D<double> const & smoothKernel,
+                          ParallelOptions const & options)
+{
+    gradientEnergyTensor(src.first, src.second, src.third,
+                         dest.first, dest.second, derivKernel, smoothKernel, options);
+}
+
 //@}
 
 } // namespace vigra
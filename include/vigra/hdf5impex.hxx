@@ -551,6 +551,19 @@ class HDF5File
     // time tagging of datasets, turned off (= 0) by default.
     int track_time;
 
+    // chunk cache configuration applied to all datasets opened by this
+    // object; disabled (= use the HDF5 library defaults) until
+    // setChunkCache() is called.
+    bool use_chunk_cache;
+    std::size_t chunk_cache_bytes, chunk_cache_slots;
+    double chunk_cache_policy;
+
+    // whether the file was opened for concurrent MPI-IO access by
+    // openParallel(); writeBlock() then uses collective transfers
+    // (always false unless the HDF5 library was built with parallel
+    // support).
+    bool use_mpio;
+
     // helper class for ls()
     struct ls_closure
     {
@@ -605,7 +618,9 @@ class HDF5File
         by default).
         */
     HDF5File(int track_creation_times = 0)
-    : track_time(track_creation_times)
+    : track_time(track_creation_times),
+      use_chunk_cache(false), chunk_cache_bytes(0), chunk_cache_slots(0), chunk_cache_policy(0.0),
+      use_mpio(false)
     {}
 
         /** \brief Open or create an HDF5File object.
@@ -617,11 +632,31 @@ class HDF5File
         private to enforce this).
         */
     HDF5File(std::string filename, OpenMode mode, int track_creation_times = 0)
-        : track_time(track_creation_times)
+        : track_time(track_creation_times),
+          use_chunk_cache(false), chunk_cache_bytes(0), chunk_cache_slots(0), chunk_cache_policy(0.0),
+          use_mpio(false)
     {
         open(filename, mode);
     }
 
+#ifdef H5_HAVE_PARALLEL
+        /** \brief Open or create an HDF5File object for concurrent MPI-IO access.
+
+        Like the preceding constructor, but the file is opened on all ranks of
+        the MPI communicator \a comm simultaneously via the MPI-IO file driver
+        (only available when the HDF5 library was built with parallel support).
+        See openParallel() for the usage rules.
+        */
+    HDF5File(std::string filename, OpenMode mode, MPI_Comm comm, MPI_Info info,
+             int track_creation_times = 0)
+        : track_time(track_creation_times),
+          use_chunk_cache(false), chunk_cache_bytes(0), chunk_cache_slots(0), chunk_cache_policy(0.0),
+          use_mpio(false)
+    {
+        openParallel(filename, mode, comm, info);
+    }
+#endif // H5_HAVE_PARALLEL
+
         /** \brief The destructor flushes and closes the file.
          */
     ~HDF5File()
@@ -646,12 +681,43 @@ class HDF5File
     void open(std::string filename, OpenMode mode)
     {
         close();
-        
+        use_mpio = false;
+
         std::string errorMessage = "HDF5File.open(): Could not open or create file '" + filename + "'.";
         fileHandle_ = HDF5Handle(createFile_(filename, mode), &H5Fclose, errorMessage.c_str());
         cGroupHandle_ = HDF5Handle(openCreateGroup_("/"), &H5Gclose, "HDF5File.open(): Failed to open root group.");
     }
 
+#ifdef H5_HAVE_PARALLEL
+        /** \brief Open or create the given file for concurrent MPI-IO access.
+
+            The file is opened collectively on all ranks of \a comm through the
+            MPI-IO file driver, so every rank must call this function (and any
+            subsequent createDataset()) with the same arguments. Afterwards,
+            \ref writeBlock() performs collective writes: all ranks must call
+            it for the same dataset, each writing its own, disjoint hyperslab.
+            This way distributed jobs write one file concurrently instead of
+            serializing through a single writer rank. MPI hints (e.g. striping
+            parameters) can be passed via \a info. Only available when the
+            HDF5 library was built with parallel support
+            (<tt>H5_HAVE_PARALLEL</tt>).
+         */
+    void openParallel(std::string filename, OpenMode mode,
+                      MPI_Comm comm, MPI_Info info = MPI_INFO_NULL)
+    {
+        close();
+
+        HDF5Handle accessPlist(H5Pcreate(H5P_FILE_ACCESS), &H5Pclose,
+            "HDF5File.openParallel(): unable to create file access property list.");
+        H5Pset_fapl_mpio(accessPlist, comm, info);
+
+        std::string errorMessage = "HDF5File.openParallel(): Could not open or create file '" + filename + "'.";
+        fileHandle_ = HDF5Handle(createFile_(filename, mode, accessPlist), &H5Fclose, errorMessage.c_str());
+        cGroupHandle_ = HDF5Handle(openCreateGroup_("/"), &H5Gclose, "HDF5File.openParallel(): Failed to open root group.");
+        use_mpio = true;
+    }
+#endif // H5_HAVE_PARALLEL
+
         /** \brief Close the current file.
          */
     void close()
@@ -660,6 +726,32 @@ class HDF5File
         vigra_postcondition(success, "HDF5File.close() failed.");
     }
 
+        /** \brief Configure the HDF5 chunk cache of subsequently opened datasets.
+
+            Every dataset opened by this object afterwards (e.g. by read(),
+            readBlock(), or readBlockwise()) gets a chunk cache of
+            \a cacheBytes bytes with \a cacheSlots hash slots and chunk
+            preemption policy \a policy (between 0.0 and 1.0, see the HDF5
+            documentation of H5Pset_chunk_cache for details). By default, the
+            library's global settings apply (usually a 1 MB cache), which is
+            far too small when subvolumes crossing chunk borders of a large,
+            compressed dataset are read repeatedly: every access decompresses
+            the affected chunks again. The cache should be big enough to hold
+            all chunks a single access touches, and \a cacheSlots should be a
+            prime number roughly 100 times the number of chunks that fit into
+            the cache. The settings have no effect for HDF5 versions before 1.8.
+        */
+    void setChunkCache(std::size_t cacheBytes, std::size_t cacheSlots = 521, double policy = 0.75)
+    {
+        vigra_precondition(0.0 <= policy && policy <= 1.0,
+            "HDF5File::setChunkCache(): policy must be between 0.0 and 1.0.");
+
+        use_chunk_cache = true;
+        chunk_cache_bytes = cacheBytes;
+        chunk_cache_slots = cacheSlots;
+        chunk_cache_policy = policy;
+    }
+
         /** \brief Change current group to "/".
          */
     inline void root()
@@ -1130,7 +1222,11 @@ class HDF5File
             Note that the memory order between VIGRA and HDF5 files differs: VIGRA uses 
             Fortran-order, while HDF5 uses C-order. This means that a VIGRA MultiArray,
             whose indices represent the 'x'-, 'y'-, and 'z'-axis in that order, is reversed
-            upon writing to an HDF5 file, i.e. in the file the axis order is 'z', 'y', 'x'. 
+            upon writing to an HDF5 file, i.e. in the file the axis order is 'z', 'y', 'x'.
+
+            If the file was opened via \ref openParallel(), the write is a
+            collective MPI-IO operation: all ranks must call writeBlock() for
+            the same dataset, each with its own, disjoint block.
         */
     template<unsigned int N, class T>
     inline void writeBlock(std::string datasetName, typename MultiArrayShape<N>::type blockOffset, const MultiArrayView<N, T, UnstridedArrayTag> & array)
@@ -1447,6 +1543,128 @@ class HDF5File
         readBlock_(datasetName, blockOffset, blockShape, array, detail::getH5DataType<T>(), 3);
     }
 
+        /** \brief Read a complete dataset block-by-block.
+
+            The dataset is tiled into blocks of shape \a blockShape (blocks at
+            the upper borders may be smaller), and the blocks are read one after
+            the other and handed to \a processBlock together with their offset
+            in the dataset. This allows to stream a dataset that is too big to
+            be read at once. \a processBlock must be compatible to
+
+            \code
+            struct BlockProcessor
+            {
+                void operator()(MultiArrayShape<N>::type blockOffset,
+                                MultiArrayView<N, T, UnstridedArrayTag> const & block);
+            };
+            \endcode
+
+            When OpenMP is enabled, the next block is already read from the
+            file while the current one is processed (double buffering), so
+            \a processBlock must not access this HDF5File object (it may,
+            however, access other files). Only scalar datasets are supported.
+            If the dataset is chunked, \a blockShape should be a multiple of
+            the chunk shape, and the chunk cache should be adjusted via
+            \ref setChunkCache() such that all chunks a block touches fit into
+            the cache.
+        */
+    template<unsigned int N, class T, class BlockProcessor>
+    void readBlockwise(std::string datasetName, typename MultiArrayShape<N>::type blockShape, BlockProcessor & processBlock)
+    {
+        typedef typename MultiArrayShape<N>::type Shape;
+
+        // make datasetName clean
+        datasetName = get_absolute_path(datasetName);
+
+        hssize_t dimensions = getDatasetDimensions(datasetName);
+        vigra_precondition(MultiArrayIndex(N) == MultiArrayIndex(dimensions),
+            "HDF5File::readBlockwise(): Array dimension disagrees with data dimension.");
+
+        ArrayVector<hsize_t> dimshape = getDatasetShape(datasetName);
+
+        // tile the dataset into a grid of blocks
+        Shape blocksPerDim;
+        MultiArrayIndex blockCount = 1;
+        for(unsigned int d = 0; d < N; ++d)
+        {
+            vigra_precondition(blockShape[d] > 0,
+                "HDF5File::readBlockwise(): block shape must be positive.");
+            blocksPerDim[d] = (MultiArrayIndex(dimshape[d]) + blockShape[d] - 1) / blockShape[d];
+            blockCount *= blocksPerDim[d];
+        }
+
+        // double buffering: while one block is processed, the next one is
+        // already read into the other buffer
+        MultiArray<N, T> buffer[2];
+
+        Shape currentOffset, currentShape;
+        blockwiseBlock_<N>(blocksPerDim, blockShape, dimshape, 0, currentOffset, currentShape);
+        buffer[0].reshape(currentShape);
+        readBlock(datasetName, currentOffset, currentShape, buffer[0]);
+
+        for(MultiArrayIndex k = 0; k < blockCount; ++k)
+        {
+            int current = (int)(k % 2), next = 1 - current;
+
+            Shape nextOffset, nextShape;
+            if(k + 1 < blockCount)
+            {
+                blockwiseBlock_<N>(blocksPerDim, blockShape, dimshape, k + 1, nextOffset, nextShape);
+                if(buffer[next].shape() != nextShape)
+                    buffer[next].reshape(nextShape);
+            }
+
+            // exceptions must not escape the parallel sections -
+            // remember the errors and report them afterwards
+            std::string processError, readError;
+
+            // without OpenMP, the two sections simply execute one after
+            // the other
+#ifdef _OPENMP
+#pragma omp parallel sections num_threads(2)
+#endif
+            {
+#ifdef _OPENMP
+#pragma omp section
+#endif
+                {
+                    try
+                    {
+                        processBlock(currentOffset, buffer[current]);
+                    }
+                    catch(std::exception & e)
+                    {
+                        processError = e.what();
+                    }
+                }
+#ifdef _OPENMP
+#pragma omp section
+#endif
+                {
+                    if(k + 1 < blockCount)
+                    {
+                        try
+                        {
+                            readBlock(datasetName, nextOffset, nextShape, buffer[next]);
+                        }
+                        catch(std::exception & e)
+                        {
+                            readError = e.what();
+                        }
+                    }
+                }
+            }
+
+            if(!processError.empty())
+                vigra_fail(processError.c_str());
+            if(!readError.empty())
+                vigra_fail(readError.c_str());
+
+            currentOffset = nextOffset;
+            currentShape = nextShape;
+        }
+    }
+
         /** \brief Read a single value.
             Specialization of the read function for simple datatypes
          */
@@ -1716,7 +1934,8 @@ class HDF5File
 
         /* create an empty file and open is
          */
-    inline hid_t createFile_(std::string filePath, OpenMode mode = Open)
+    inline hid_t createFile_(std::string filePath, OpenMode mode = Open,
+                             hid_t accessPlist = H5P_DEFAULT)
     {
         // try to open file
         FILE * pFile;
@@ -1726,22 +1945,22 @@ class HDF5File
         // check if opening was successful (= file exists)
         if ( pFile == NULL )
         {
-            fileId = H5Fcreate(filePath.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+            fileId = H5Fcreate(filePath.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, accessPlist);
         }
         else if(mode == Open)
         {
             fclose( pFile );
-            fileId = H5Fopen(filePath.c_str(), H5F_ACC_RDWR, H5P_DEFAULT);
+            fileId = H5Fopen(filePath.c_str(), H5F_ACC_RDWR, accessPlist);
         }
         else if(mode == OpenReadOnly) {
             fclose( pFile );
-            fileId = H5Fopen(filePath.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+            fileId = H5Fopen(filePath.c_str(), H5F_ACC_RDONLY, accessPlist);
         }
         else
         {
             fclose(pFile);
             std::remove(filePath.c_str());
-            fileId = H5Fcreate(filePath.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+            fileId = H5Fcreate(filePath.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, accessPlist);
         }
         return fileId;
     }
@@ -1837,6 +2056,17 @@ class HDF5File
         // Open parent group
         HDF5Handle groupHandle(openCreateGroup_(groupname), &H5Gclose, "Internal error");
 
+#if H5_VERS_MAJOR > 1 || (H5_VERS_MAJOR == 1 && H5_VERS_MINOR >= 8)
+        if(use_chunk_cache)
+        {
+            // apply the chunk cache settings requested via setChunkCache()
+            HDF5Handle accessPlist(H5Pcreate(H5P_DATASET_ACCESS), &H5Pclose,
+                "HDF5File::getDatasetHandle_(): Unable to create dataset access property list.");
+            H5Pset_chunk_cache(accessPlist, chunk_cache_slots, chunk_cache_bytes, chunk_cache_policy);
+            return H5Dopen(groupHandle, setname.c_str(), accessPlist);
+        }
+#endif
+
         return H5Dopen(groupHandle, setname.c_str(), H5P_DEFAULT);
     }
 
@@ -2174,8 +2404,43 @@ class HDF5File
         HDF5Handle dataspaceHandle (H5Dget_space(datasetHandle),&H5Sclose,"Unable to create target dataspace");
         H5Sselect_hyperslab(dataspaceHandle, H5S_SELECT_SET, boffset, bones, bones, bshape);
 
+        // use a collective transfer when the file was opened for
+        // concurrent MPI-IO access by openParallel()
+        hid_t xferPlist = H5P_DEFAULT;
+#ifdef H5_HAVE_PARALLEL
+        HDF5Handle xferPlistHandle;
+        if(use_mpio)
+        {
+            xferPlistHandle = HDF5Handle(H5Pcreate(H5P_DATASET_XFER), &H5Pclose,
+                "HDF5File::writeBlock(): unable to create transfer property list.");
+            H5Pset_dxpl_mpio(xferPlistHandle, H5FD_MPIO_COLLECTIVE);
+            xferPlist = xferPlistHandle;
+        }
+#endif // H5_HAVE_PARALLEL
+
         // Write the data to the HDF5 dataset as is
-        H5Dwrite( datasetHandle, datatype, memspace_handle, dataspaceHandle, H5P_DEFAULT, array.data()); // .data() possible since void pointer!
+        H5Dwrite( datasetHandle, datatype, memspace_handle, dataspaceHandle, xferPlist, array.data()); // .data() possible since void pointer!
+    }
+
+        /* compute offset and shape of the block with the given linear index
+           in the block grid used by readBlockwise()
+        */
+    template<unsigned int N>
+    static void blockwiseBlock_(typename MultiArrayShape<N>::type const & blocksPerDim,
+                                typename MultiArrayShape<N>::type const & blockShape,
+                                ArrayVector<hsize_t> const & dimshape,
+                                MultiArrayIndex blockIndex,
+                                typename MultiArrayShape<N>::type & blockOffset,
+                                typename MultiArrayShape<N>::type & actualShape)
+    {
+        for(unsigned int d = 0; d < N; ++d)
+        {
+            blockOffset[d] = (blockIndex % blocksPerDim[d]) * blockShape[d];
+            blockIndex /= blocksPerDim[d];
+
+            // blocks at the upper borders may be smaller
+            actualShape[d] = std::min(blockShape[d], MultiArrayIndex(dimshape[d]) - blockOffset[d]);
+        }
     }
 
         /* low-level read function to read vigra unstrided MultiArray data from a sub-block of a dataset
@@ -38,10 +38,38 @@
 
 #include "config.hxx"
 #include "array_vector.hxx"
+#include "threadpool.hxx"
 #include <algorithm>
 
 namespace vigra {
 
+template <class DataType, class BinType>
+class HistogramView;
+
+namespace detail {
+
+    // fills one thread-private bin array from one partition of the data;
+    // used by HistogramView::fillParallel() via parallel_foreach()
+template <class DataIterator, class DataType, class BinType>
+struct HistogramBlockFill
+{
+    DataIterator begin_;
+    std::ptrdiff_t size_, blockSize_;
+    HistogramView<DataType, BinType> const * prototype_;
+    ArrayVector<ArrayVector<BinType> > * privateBins_;
+
+    void operator()(int threadIndex, std::ptrdiff_t blockIndex) const
+    {
+        std::ptrdiff_t from = blockIndex * blockSize_,
+                       to   = std::min(from + blockSize_, size_);
+        HistogramView<DataType, BinType> privateView(*prototype_);
+        privateView.setData(&(*privateBins_)[threadIndex][0]);
+        privateView.fill(begin_ + from, begin_ + to);
+    }
+};
+
+} // namespace detail
+
 /** \brief Set histogram options.
 
     HistogramOptions objects are used to pass histogram options to other objects. This \ref acc_hist_options "example" shows how it is is used to pass histogram options to an accumulator chain.
@@ -194,6 +222,79 @@ class HistogramView
         get(int(mapItem(d))) += weight;
     }
 
+        /** Bulk-fill the histogram from the given range, each sample with unit weight.
+
+            Binning proceeds in two phases over small chunks: the linear
+            value-to-index mapping is computed in a tight loop over a chunk
+            buffer (which the compiler can vectorize, since the uniform bin
+            width makes it a pure multiply-and-clamp), and only the bin
+            increments remain scalar. This is considerably faster than
+            calling add() per sample.
+        */
+    template <class DataIterator>
+    HistogramView & fill(DataIterator begin, DataIterator end)
+    {
+        static const int chunkSize = 256;
+        int indices[chunkSize];
+        while(begin != end)
+        {
+            int count = 0;
+            for(; count < chunkSize && begin != end; ++count, ++begin)
+            {
+                int index = int(mapItem(*begin));
+                if(index < 0)
+                    index = 0;
+                if(index >= size_)
+                    index = size_ - 1;
+                indices[count] = index;
+            }
+            for(int k = 0; k < count; ++k)
+                *(bins_ + indices[k]*stride_) += NumericTraits<BinType>::one();
+        }
+        return *this;
+    }
+
+        /** Bulk-fill the histogram from the given random-access range using
+            multiple threads.
+
+            The data are partitioned into blocks (size via
+            ParallelOptions::getBlockSize()), every thread accumulates into a
+            private bin array, and the private arrays are summed into the
+            histogram afterwards, so no locking is needed. The result is
+            identical to a serial fill(). The number of threads is determined
+            by \a options; by default, all cores are used for this purely
+            memory-bound work.
+        */
+    template <class DataIterator>
+    HistogramView & fillParallel(DataIterator begin, DataIterator end,
+                                 ParallelOptions const & options = ParallelOptions())
+    {
+        std::ptrdiff_t n = end - begin;
+        if(n <= 0)
+            return *this;
+        int threads = (int)std::min<std::ptrdiff_t>(n, options.getNumThreads());
+        if(threads <= 1)
+            return fill(begin, end);
+
+        std::ptrdiff_t blockSize = options.getBlockSize((int)n),
+                       blockCount = (n + blockSize - 1) / blockSize;
+        ArrayVector<ArrayVector<BinType> >
+            privateBins(threads, ArrayVector<BinType>(size_, BinType()));
+
+        detail::HistogramBlockFill<DataIterator, DataType, BinType> blockFill;
+        blockFill.begin_ = begin;
+        blockFill.size_ = n;
+        blockFill.blockSize_ = blockSize;
+        blockFill.prototype_ = this;
+        blockFill.privateBins_ = &privateBins;
+        parallel_foreach(blockCount, blockFill, options);
+
+        for(int t = 0; t < threads; ++t)
+            for(int k = 0; k < size_; ++k)
+                *(bins_ + k*stride_) += privateBins[t][k];
+        return *this;
+    }
+
   protected:
 
 	BinType & get(int index)
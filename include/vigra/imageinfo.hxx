@@ -243,6 +243,13 @@ class ImageExportInfo
             <DT>"PIZ"<DD> (recognized by EXR): use wavelet encoding.
             <DT>"PXR24"<DD> (recognized by EXR): reduce to 24-bit, then use zip-style encoding.
             <DT>"B44", "B44A"<DD> (recognized by EXR): see OpenEXR documentation.
+            <DT>"FAST"<DD> (recognized by PNG): store with minimal compression effort and
+                           no row filtering. This is much faster and useful for intermediate
+                           results that are read more often than archived.
+            <DT>"BEST"<DD> (recognized by PNG): spend maximal compression effort.
+                           You can also select the zlib compression level directly by
+                           passing "LOSSLESS QUALITY=N", where "N" must be an integer
+                           between 1 and 9 (e.g. "LOSSLESS QUALITY=2").
             <DT>"ASCII"<DD> (recognized by PNM): store pixels as ASCII (human readable numbers).
             <DT>"RAW"<DD> (recognized by PNM): store pixels as uncompressed binary data.
             <DT>"BILEVEL"<DD> (recognized by PNM): store as one bit per pixel.
@@ -355,6 +362,17 @@ class ImageExportInfo
          **/
     VIGRA_EXPORT ImageExportInfo & setICCProfile(const ICCProfile & profile);
 
+        /** Set the number of worker threads used for encoding.
+
+            Currently only supported by OpenEXR files, whose compressed
+            scanline blocks are then encoded in parallel by the IlmImf
+            thread pool. Other file formats silently ignore the setting.
+            The default value 0 keeps the codec's single-threaded
+            behavior.
+         **/
+    VIGRA_EXPORT ImageExportInfo & setNumThreads( int numThreads );
+    VIGRA_EXPORT int getNumThreads() const;
+
   private:
     std::string m_filename, m_filetype, m_pixeltype, m_comp, m_mode;
     float m_x_res, m_y_res;
@@ -362,6 +380,7 @@ class ImageExportInfo
     ICCProfile m_icc_profile;
     Size2D m_canvas_size;
     double fromMin_, fromMax_, toMin_, toMax_;
+    int m_num_threads;
 };
 
 // return an encoder for a given ImageExportInfo object
@@ -413,10 +432,33 @@ class ImageImportInfo
             </DL>
          **/
     VIGRA_EXPORT ImageImportInfo( const char *, unsigned int = 0 );
+
+        /** Construct ImageImportInfo object from a memory buffer.
+
+            The buffer must hold <tt>size</tt> bytes of encoded image
+            data, e.g. a file received over the network, and must stay
+            valid as long as this object (or a decoder created from it)
+            is in use. The file type is determined from the first few
+            bytes of the buffer (magic number). No temporary file is
+            created; the image is decoded directly from memory.
+            Currently only supported for PNG data.
+         **/
+    VIGRA_EXPORT ImageImportInfo( const void * data, std::size_t size );
+
     VIGRA_EXPORT ~ImageImportInfo();
 
     VIGRA_EXPORT const char * getFileName() const;
 
+        /** Get the memory buffer this object was constructed from,
+            or 0 when it refers to a file.
+         **/
+    VIGRA_EXPORT const void * getMemoryData() const;
+
+        /** Get the size of the memory buffer this object was
+            constructed from, or 0 when it refers to a file.
+         **/
+    VIGRA_EXPORT std::size_t getMemorySize() const;
+
         /** Get the file type of the image associated with this
             info object.
 
@@ -454,6 +496,20 @@ class ImageImportInfo
          **/
     VIGRA_EXPORT int getImageIndex() const;
 
+        /** Set the number of worker threads used for decoding.
+
+            Currently only supported by OpenEXR files, whose compressed
+            scanline blocks are then decoded in parallel by the IlmImf
+            thread pool. Other file formats silently ignore the setting.
+            The default value 0 keeps the codec's single-threaded
+            behavior.
+         **/
+    VIGRA_EXPORT ImageImportInfo & setNumThreads( int numThreads );
+
+        /** Get the number of worker threads used for decoding.
+         **/
+    VIGRA_EXPORT int getNumThreads() const;
+
         /** Get size of the image.
          **/
     VIGRA_EXPORT Size2D size() const;
@@ -509,6 +565,12 @@ class ImageImportInfo
          **/
     VIGRA_EXPORT bool isByte() const;
 
+        /** Returns true if the codec can decode a rectangular region
+            of this image directly from the file's tiles or strips,
+            i.e. if the image may be passed to \ref importImageRegion().
+         **/
+    VIGRA_EXPORT bool supportsRegionRead() const;
+
         /** Returns the layer offset of the current image, if there is one
          **/
     VIGRA_EXPORT Diff2D getPosition() const;
@@ -541,7 +603,11 @@ class ImageImportInfo
 
   private:
     std::string m_filename, m_filetype, m_pixeltype;
+    const void * m_mem_data;
+    std::size_t m_mem_size;
     int m_width, m_height, m_num_bands, m_num_extra_bands, m_num_images, m_image_index;
+    int m_num_threads;
+    bool m_supports_region_read;
     float m_x_res, m_y_res;
     Diff2D m_pos;
     Size2D m_canvas_size;
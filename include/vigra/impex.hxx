@@ -51,6 +51,10 @@
 #include "stdimage.hxx"
 #include "imageinfo.hxx"
 #include "impexbase.hxx"
+#include "multi_array.hxx"
+#include "parallel_options.hxx"
+
+#include <iterator>
 
 namespace vigra
 {
@@ -63,12 +67,11 @@ namespace vigra
                   class ImageIterator, class ImageAccessor>
         void
         read_image_band(Decoder* decoder,
+                        unsigned width, unsigned height,
                         ImageIterator image_iterator, ImageAccessor image_accessor)
         {
             typedef typename ImageIterator::row_iterator ImageRowIterator;
 
-            const unsigned width(decoder->getWidth());
-            const unsigned height(decoder->getHeight());
             const unsigned offset(decoder->getOffset());
 
             for (unsigned y = 0U; y != height; ++y)
@@ -92,16 +95,27 @@ namespace vigra
         }
 
 
+        template <class ValueType,
+                  class ImageIterator, class ImageAccessor>
+        inline void
+        read_image_band(Decoder* decoder,
+                        ImageIterator image_iterator, ImageAccessor image_accessor)
+        {
+            read_image_band<ValueType>(decoder,
+                                       decoder->getWidth(), decoder->getHeight(),
+                                       image_iterator, image_accessor);
+        }
+
+
         template <class ValueType,
                   class ImageIterator, class ImageAccessor>
         void
         read_image_bands(Decoder* decoder,
+                         unsigned width, unsigned height,
                          ImageIterator image_iterator, ImageAccessor image_accessor)
         {
             typedef typename ImageIterator::row_iterator ImageRowIterator;
 
-            const unsigned width(decoder->getWidth());
-            const unsigned height(decoder->getHeight());
             const unsigned offset(decoder->getOffset());
             const unsigned accessor_size(image_accessor.size(image_iterator));
 
@@ -172,6 +186,18 @@ namespace vigra
         }
 
 
+        template <class ValueType,
+                  class ImageIterator, class ImageAccessor>
+        inline void
+        read_image_bands(Decoder* decoder,
+                         ImageIterator image_iterator, ImageAccessor image_accessor)
+        {
+            read_image_bands<ValueType>(decoder,
+                                        decoder->getWidth(), decoder->getHeight(),
+                                        image_iterator, image_accessor);
+        }
+
+
         template <class ImageIterator, class ImageAccessor>
         void
         importImage(const ImageImportInfo& import_info,
@@ -249,6 +275,96 @@ namespace vigra
             decoder->close();
         }
 
+
+        template <class ImageIterator, class ImageAccessor>
+        void
+        importImageRegion(const ImageImportInfo& import_info,
+                          const Rect2D& roi,
+                          ImageIterator image_iterator, ImageAccessor image_accessor,
+                          /* isScalar? */ VigraTrueType)
+        {
+            VIGRA_UNIQUE_PTR<Decoder> decoder(vigra::decoder(import_info));
+
+            vigra_precondition(decoder->supportsRegionRead(),
+                               "importImageRegion(): file format does not support "
+                               "region reads.");
+            decoder->setRegion(roi);
+
+            switch (pixel_t_of_string(decoder->getPixelType()))
+            {
+            case UNSIGNED_INT_8:
+                read_image_band<UInt8>(decoder.get(), roi.width(), roi.height(), image_iterator, image_accessor);
+                break;
+            case UNSIGNED_INT_16:
+                read_image_band<UInt16>(decoder.get(), roi.width(), roi.height(), image_iterator, image_accessor);
+                break;
+            case UNSIGNED_INT_32:
+                read_image_band<UInt32>(decoder.get(), roi.width(), roi.height(), image_iterator, image_accessor);
+                break;
+            case SIGNED_INT_16:
+                read_image_band<Int16>(decoder.get(), roi.width(), roi.height(), image_iterator, image_accessor);
+                break;
+            case SIGNED_INT_32:
+                read_image_band<Int32>(decoder.get(), roi.width(), roi.height(), image_iterator, image_accessor);
+                break;
+            case IEEE_FLOAT_32:
+                read_image_band<float>(decoder.get(), roi.width(), roi.height(), image_iterator, image_accessor);
+                break;
+            case IEEE_FLOAT_64:
+                read_image_band<double>(decoder.get(), roi.width(), roi.height(), image_iterator, image_accessor);
+                break;
+            default:
+                vigra_fail("detail::importImageRegion<scalar>: not reached");
+            }
+
+            decoder->close();
+        }
+
+
+        template <class ImageIterator, class ImageAccessor>
+        void
+        importImageRegion(const ImageImportInfo& import_info,
+                          const Rect2D& roi,
+                          ImageIterator image_iterator, ImageAccessor image_accessor,
+                          /* isScalar? */ VigraFalseType)
+        {
+            VIGRA_UNIQUE_PTR<Decoder> decoder(vigra::decoder(import_info));
+
+            vigra_precondition(decoder->supportsRegionRead(),
+                               "importImageRegion(): file format does not support "
+                               "region reads.");
+            decoder->setRegion(roi);
+
+            switch (pixel_t_of_string(decoder->getPixelType()))
+            {
+            case UNSIGNED_INT_8:
+                read_image_bands<UInt8>(decoder.get(), roi.width(), roi.height(), image_iterator, image_accessor);
+                break;
+            case UNSIGNED_INT_16:
+                read_image_bands<UInt16>(decoder.get(), roi.width(), roi.height(), image_iterator, image_accessor);
+                break;
+            case UNSIGNED_INT_32:
+                read_image_bands<UInt32>(decoder.get(), roi.width(), roi.height(), image_iterator, image_accessor);
+                break;
+            case SIGNED_INT_16:
+                read_image_bands<Int16>(decoder.get(), roi.width(), roi.height(), image_iterator, image_accessor);
+                break;
+            case SIGNED_INT_32:
+                read_image_bands<Int32>(decoder.get(), roi.width(), roi.height(), image_iterator, image_accessor);
+                break;
+            case IEEE_FLOAT_32:
+                read_image_bands<float>(decoder.get(), roi.width(), roi.height(), image_iterator, image_accessor);
+                break;
+            case IEEE_FLOAT_64:
+                read_image_bands<double>(decoder.get(), roi.width(), roi.height(), image_iterator, image_accessor);
+                break;
+            default:
+                vigra_fail("vigra::detail::importImageRegion<non-scalar>: not reached");
+            }
+
+            decoder->close();
+        }
+
         template<class ValueType,
                  class ImageIterator, class ImageAccessor, class ImageScaler>
         void
@@ -704,6 +820,435 @@ namespace vigra
                     image.first, image.second);
     }
 
+    /*!
+     * \brief Read a rectangular region of the image specified by the
+     * given \ref vigra::ImageImportInfo object.
+     *
+     * Only the requested region is decoded, directly from the file's
+     * tiles or strips, so a small part of an image that is far too
+     * large for main memory can be read with bounded memory. The
+     * destination must be at least as large as the region. Region
+     * reads are currently only implemented by the TIFF codec; use
+     * \ref vigra::ImageImportInfo::supportsRegionRead() to find out
+     * whether they are available for a given file.
+     *
+     * <B>Declarations</B>
+     *
+     * Pass arguments explicitly:
+     * \code
+     * namespace vigra {
+     *     template <class ImageIterator, class Accessor>
+     *     void
+     *     importImageRegion(const ImageImportInfo& importInfo, const Rect2D& roi,
+     *                       ImageIterator imageIterator, Accessor imageAccessor)
+     * }
+     * \endcode
+     *
+     * Use argument objects in conjunction with \ref ArgumentObjectFactories :
+     * \code
+     * namespace vigra {
+     *     template <class ImageIterator, class Accessor>
+     *     inline void
+     *     importImageRegion(const ImageImportInfo& importInfo, const Rect2D& roi,
+     *                       const pair<ImageIterator, Accessor>& image)
+     * }
+     * \endcode
+     *
+     * <B>Usage</B>
+     *
+     * <B>\#include \<vigra/impex.hxx\></B>
+     *
+     * Namespace: vigra
+     *
+     * \code
+     *     ImageImportInfo info("huge_map.tif");
+     *
+     *     if (info.supportsRegionRead())
+     *     {
+     *         // read a 2000x2000 tile from the middle of the image
+     *         Rect2D roi(Point2D(info.width() / 2, info.height() / 2),
+     *                    Size2D(2000, 2000));
+     *         BImage image(roi.size());
+     *
+     *         importImageRegion(info, roi, destImage(image));
+     *         ...
+     *     }
+     * \endcode
+     *
+     * <B>Preconditions</B>
+     *
+     * - The image file must be readable,
+     * - the codec must support region reads and
+     * - the region must be non-empty and inside the image.
+     */
+    doxygen_overloaded_function(template <...> inline void importImageRegion)
+
+
+    template <class ImageIterator, class ImageAccessor>
+    inline void
+    importImageRegion(const ImageImportInfo& import_info, const Rect2D& roi,
+                      ImageIterator image_iterator, ImageAccessor image_accessor)
+    {
+        typedef typename ImageAccessor::value_type ImageValueType;
+        typedef typename NumericTraits<ImageValueType>::isScalar is_scalar;
+
+        detail::importImageRegion(import_info, roi,
+                    image_iterator, image_accessor,
+                    is_scalar());
+    }
+
+
+    template <class ImageIterator, class ImageAccessor>
+    inline void
+    importImageRegion(const ImageImportInfo& import_info, const Rect2D& roi,
+                      const vigra::pair<ImageIterator, ImageAccessor>& image)
+    {
+        importImageRegion(import_info, roi,
+                          image.first, image.second);
+    }
+
+    /*!
+     * \brief Read a batch of image files, possibly in parallel.
+     *
+     * The filenames in the range <tt>[filenameBegin, filenameEnd)</tt>
+     * (an iterator range over <tt>std::string</tt>) are read into
+     * \a images, which is resized and allocated to match the files.
+     * When OpenMP is enabled and \a options requests more than one
+     * thread, the files are decoded concurrently -- every thread uses
+     * its own decoder instance, so no shared state is involved, and
+     * the result equals that of reading the files one by one. This
+     * mainly pays off for ingest workloads that are dominated by the
+     * decompression (e.g. JPEG) of many small files. The headers are
+     * read up front in a single thread; if any file fails to decode,
+     * the first error is reported after the batch has finished.
+     *
+     * <B>Declarations</B>
+     *
+     * \code
+     * namespace vigra {
+     *     template <class FilenameIterator, class ImageType>
+     *     void
+     *     importImageBatch(FilenameIterator filenameBegin, FilenameIterator filenameEnd,
+     *                      ArrayVector<ImageType>& images,
+     *                      ParallelOptions const& options = ParallelOptions())
+     * }
+     * \endcode
+     *
+     * <B>Usage</B>
+     *
+     * <B>\#include \<vigra/impex.hxx\></B>
+     *
+     * Namespace: vigra
+     *
+     * \code
+     *     ArrayVector<std::string> filenames;
+     *     ... // collect the frames of one camera batch
+     *
+     *     ArrayVector<BRGBImage> frames;
+     *
+     *     // decode with 8 threads
+     *     importImageBatch(filenames.begin(), filenames.end(), frames,
+     *                      ParallelOptions().numThreads(8));
+     * \endcode
+     */
+    template <class FilenameIterator, class ImageType>
+    void
+    importImageBatch(FilenameIterator filenameBegin, FilenameIterator filenameEnd,
+                     ArrayVector<ImageType>& images,
+                     ParallelOptions const& options = ParallelOptions())
+    {
+        int count = (int)std::distance(filenameBegin, filenameEnd);
+
+        images.resize(count);
+
+        // read the headers and allocate the destination images up front;
+        // this also initializes the codec manager before threads start
+        ArrayVector<ImageImportInfo> infos;
+        infos.reserve(count);
+
+        FilenameIterator filename = filenameBegin;
+        for (int i = 0; i != count; ++i, ++filename)
+        {
+            infos.push_back(ImageImportInfo(filename->c_str()));
+            images[i].resize(infos[i].width(), infos[i].height());
+        }
+
+        std::string error;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(options.getNumThreads())
+#endif
+        for (int i = 0; i < count; ++i)
+        {
+            try
+            {
+                importImage(infos[i], destImage(images[i]));
+            }
+            catch (std::exception& e)
+            {
+                // exceptions must not leave the thread; report the
+                // first failure when the batch has finished
+#ifdef _OPENMP
+#pragma omp critical(vigra_impex_batch_error)
+#endif
+                {
+                    if (error.empty())
+                        error = e.what();
+                }
+            }
+        }
+
+        if (!error.empty())
+            vigra_fail(error.c_str());
+    }
+
+    /*!
+     * \brief Read a sequence of image files with prefetching.
+     *
+     * The filenames in the range <tt>[filenameBegin, filenameEnd)</tt>
+     * (an iterator range over <tt>std::string</tt>) are decoded one
+     * after the other, and every frame is handed to \a processFrame
+     * together with its index in the sequence. In contrast to
+     * \ref importImageBatch(), only two frames are in memory at any
+     * time: the frames are decoded into a pair of reusable buffers,
+     * and when OpenMP is enabled, the next frame is already decoded
+     * while the current one is processed (double buffering). This
+     * keeps both the decoder and the processing busy in per-frame
+     * loops that otherwise alternate between the two.
+     *
+     * \a processFrame must be compatible to
+     *
+     * \code
+     * struct FrameProcessor
+     * {
+     *     void operator()(int frameIndex, ImageType const & frame);
+     * };
+     * \endcode
+     *
+     * Since the processor runs concurrently with the decoder, it must
+     * not access the buffer of any frame but the current one. The
+     * template parameter <tt>ImageType</tt> (the buffer type, e.g.
+     * \ref vigra::BRGBImage) cannot be deduced and must be given
+     * explicitly. If a file fails to decode, the error is reported
+     * after the frames already decoded have been processed.
+     *
+     * <B>Declarations</B>
+     *
+     * \code
+     * namespace vigra {
+     *     template <class ImageType, class FilenameIterator, class FrameProcessor>
+     *     void
+     *     importImagePipeline(FilenameIterator filenameBegin, FilenameIterator filenameEnd,
+     *                         FrameProcessor & processFrame)
+     * }
+     * \endcode
+     *
+     * <B>Usage</B>
+     *
+     * <B>\#include \<vigra/impex.hxx\></B>
+     *
+     * Namespace: vigra
+     *
+     * \code
+     *     ArrayVector<std::string> filenames;
+     *     ... // collect the frames of one recording
+     *
+     *     struct FrameProcessor
+     *     {
+     *         void operator()(int frameIndex, BRGBImage const & frame)
+     *         {
+     *             ... // analyze the frame while the next one is decoded
+     *         }
+     *     } processFrame;
+     *
+     *     importImagePipeline<BRGBImage>(filenames.begin(), filenames.end(), processFrame);
+     * \endcode
+     */
+    template <class ImageType, class FilenameIterator, class FrameProcessor>
+    void
+    importImagePipeline(FilenameIterator filenameBegin, FilenameIterator filenameEnd,
+                        FrameProcessor & processFrame)
+    {
+        int count = (int)std::distance(filenameBegin, filenameEnd);
+        if (count == 0)
+            return;
+
+        // double buffering: while one frame is processed, the next one
+        // is decoded into the other buffer (the buffers are reused, so
+        // a sequence of equally-sized frames is decoded without any
+        // re-allocation)
+        ImageType buffers[2];
+
+        ArrayVector<std::string> filenames;
+        filenames.reserve(count);
+        for (FilenameIterator filename = filenameBegin; filename != filenameEnd; ++filename)
+            filenames.push_back(*filename);
+
+        // decode the first frame up front; this also initializes the
+        // codec manager before threads start
+        {
+            ImageImportInfo info(filenames[0].c_str());
+            buffers[0].resize(info.width(), info.height());
+            importImage(info, destImage(buffers[0]));
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            int current = i % 2, next = 1 - current;
+
+            // exceptions must not leave the parallel sections; remember
+            // the errors and report them afterwards
+            std::string processError, decodeError;
+
+            // without OpenMP, the two sections simply execute one after
+            // the other
+#ifdef _OPENMP
+#pragma omp parallel sections num_threads(2)
+#endif
+            {
+#ifdef _OPENMP
+#pragma omp section
+#endif
+                {
+                    try
+                    {
+                        processFrame(i, buffers[current]);
+                    }
+                    catch (std::exception& e)
+                    {
+                        processError = e.what();
+                    }
+                }
+#ifdef _OPENMP
+#pragma omp section
+#endif
+                {
+                    if (i + 1 < count)
+                    {
+                        try
+                        {
+                            ImageImportInfo info(filenames[i+1].c_str());
+                            buffers[next].resize(info.width(), info.height());
+                            importImage(info, destImage(buffers[next]));
+                        }
+                        catch (std::exception& e)
+                        {
+                            decodeError = e.what();
+                        }
+                    }
+                }
+            }
+
+            if (!processError.empty())
+                vigra_fail(processError.c_str());
+            if (!decodeError.empty())
+                vigra_fail(decodeError.c_str());
+        }
+    }
+
+    /*!
+     * \brief Read an image directly into caller-provided memory.
+     *
+     * When the file's codec supports push-style decoding (see
+     * <tt>Decoder::supportsDirectRead()</tt>; currently uncompressed
+     * 8-bit PNM and BMP files, which are decoded from memory-mapped
+     * pages), the rows are written straight into \a dest with the
+     * destination's row stride -- the codec's staging buffer and the
+     * accessor copy of importImage() are skipped, so every pixel is
+     * copied exactly once. For all other files, the function falls
+     * back to an ordinary importImage() call, so it may be used
+     * unconditionally.
+     *
+     * \a dest must be unstrided along x and match the shape of the
+     * image. Overloads exist for single-band <tt>UInt8</tt> and
+     * <tt>RGBValue\<UInt8\></tt> destinations; files with a different
+     * number of bands are rejected with a precondition error, files
+     * with deeper pixel types are converted via the fallback path.
+     *
+     * <B>Declarations</B>
+     *
+     * \code
+     * namespace vigra {
+     *     void
+     *     importImageDirect(const ImageImportInfo& import_info,
+     *                       MultiArrayView<2, UInt8, UnstridedArrayTag> dest)
+     *
+     *     void
+     *     importImageDirect(const ImageImportInfo& import_info,
+     *                       MultiArrayView<2, RGBValue<UInt8>, UnstridedArrayTag> dest)
+     * }
+     * \endcode
+     *
+     * <B>Usage</B>
+     *
+     * <B>\#include \<vigra/impex.hxx\></B>
+     *
+     * Namespace: vigra
+     *
+     * \code
+     *     ImageImportInfo info("frame.ppm");
+     *
+     *     MultiArray<2, RGBValue<UInt8> > frame(info.shape());
+     *     importImageDirect(info, frame);
+     * \endcode
+     */
+    inline void
+    importImageDirect(const ImageImportInfo& import_info,
+                      MultiArrayView<2, UInt8, UnstridedArrayTag> dest)
+    {
+        vigra_precondition(import_info.shape() == dest.shape(),
+            "importImageDirect(): image and destination shapes disagree.");
+        vigra_precondition(import_info.numBands() == 1,
+            "importImageDirect(): file is not a single-band image.");
+
+        VIGRA_UNIQUE_PTR<Decoder> dec = decoder(import_info);
+        if (dec->supportsDirectRead() &&
+            import_info.pixelType() == ImageImportInfo::UINT8)
+        {
+            dec->readDirect(dest.data(), dest.stride(1));
+            dec->close();
+        }
+        else
+        {
+            dec->abort();
+
+            // decode into a temporary buffer as usual
+            MultiArray<2, UInt8> buffer(dest.shape());
+            BasicImageView<UInt8> view = makeBasicImageView(buffer);
+            importImage(import_info, destImage(view));
+            dest.copy(buffer);
+        }
+    }
+
+    inline void
+    importImageDirect(const ImageImportInfo& import_info,
+                      MultiArrayView<2, RGBValue<UInt8>, UnstridedArrayTag> dest)
+    {
+        vigra_precondition(import_info.shape() == dest.shape(),
+            "importImageDirect(): image and destination shapes disagree.");
+        vigra_precondition(import_info.numBands() == 3,
+            "importImageDirect(): file is not an RGB image.");
+
+        VIGRA_UNIQUE_PTR<Decoder> dec = decoder(import_info);
+        if (dec->supportsDirectRead() &&
+            import_info.pixelType() == ImageImportInfo::UINT8)
+        {
+            dec->readDirect(reinterpret_cast<unsigned char *>(dest.data()),
+                            dest.stride(1) * sizeof(RGBValue<UInt8>));
+            dec->close();
+        }
+        else
+        {
+            dec->abort();
+
+            // decode into a temporary buffer as usual
+            MultiArray<2, RGBValue<UInt8> > buffer(dest.shape());
+            BasicImageView<RGBValue<UInt8> > view = makeBasicImageView(buffer);
+            importImage(import_info, destImage(view));
+            dest.copy(buffer);
+        }
+    }
+
     /*!
      * \brief Write an image given a \ref vigra::ImageExportInfo object.
      *
@@ -69,30 +69,64 @@ namespace vigra
             const unsigned height(decoder->getHeight());
             const unsigned offset(decoder->getOffset());
 
-            for (unsigned y = 0U; y != height; ++y)
+            // OPTIMIZATION: When the decoder stores the scanline
+            // fully interleaved (gray and alpha samples alternate),
+            // de-interleave it with a single sequential pointer
+            // instead of two strided ones -- one linear read stream
+            // halves the post-decode memory traffic.
+            if (offset == 2U)
             {
-                decoder->nextScanline();
+                for (unsigned y = 0U; y != height; ++y)
+                {
+                    decoder->nextScanline();
 
-                const ValueType* scanline0 = static_cast<const ValueType*>(decoder->currentScanlineOfBand(0));
-                const ValueType* scanline1 = static_cast<const ValueType*>(decoder->currentScanlineOfBand(1));
+                    const ValueType* scanline = static_cast<const ValueType*>(decoder->currentScanlineOfBand(0));
 
-                ImageRowIterator is(image_iterator.rowIterator());
-                const ImageRowIterator is_end(is + width);
-                AlphaRowIterator as(alpha_iterator.rowIterator());
+                    ImageRowIterator is(image_iterator.rowIterator());
+                    const ImageRowIterator is_end(is + width);
+                    AlphaRowIterator as(alpha_iterator.rowIterator());
 
-                while (is != is_end)
-                {
-                    image_accessor.set(*scanline0, is);
-                    scanline0 += offset;
-                    ++is;
+                    while (is != is_end)
+                    {
+                        image_accessor.set(scanline[0], is);
+                        alpha_accessor.set(scanline[1], as);
+                        scanline += 2;
 
-                    alpha_accessor.set(*scanline1, as);
-                    scanline1 += offset;
-                    ++as;
+                        ++is;
+                        ++as;
+                    }
+
+                    ++image_iterator.y;
+                    ++alpha_iterator.y;
                 }
+            }
+            else
+            {
+                for (unsigned y = 0U; y != height; ++y)
+                {
+                    decoder->nextScanline();
 
-                ++image_iterator.y;
-                ++alpha_iterator.y;
+                    const ValueType* scanline0 = static_cast<const ValueType*>(decoder->currentScanlineOfBand(0));
+                    const ValueType* scanline1 = static_cast<const ValueType*>(decoder->currentScanlineOfBand(1));
+
+                    ImageRowIterator is(image_iterator.rowIterator());
+                    const ImageRowIterator is_end(is + width);
+                    AlphaRowIterator as(alpha_iterator.rowIterator());
+
+                    while (is != is_end)
+                    {
+                        image_accessor.set(*scanline0, is);
+                        scanline0 += offset;
+                        ++is;
+
+                        alpha_accessor.set(*scanline1, as);
+                        scanline1 += offset;
+                        ++as;
+                    }
+
+                    ++image_iterator.y;
+                    ++alpha_iterator.y;
+                }
             }
         }
 
@@ -120,8 +154,38 @@ namespace vigra
 
             // OPTIMIZATION: Specialization for the most common case
             // of an RGBA-image, i.e. three color channels plus one
-            // alpha channel.
-            if (accessor_size == 3U)
+            // alpha channel.  When the decoder additionally stores
+            // the scanline fully interleaved, de-interleave it with a
+            // single sequential pointer instead of four strided ones.
+            if (accessor_size == 3U && offset == 4U)
+            {
+                for (unsigned y = 0U; y != height; ++y)
+                {
+                    decoder->nextScanline();
+
+                    const ValueType* scanline = static_cast<const ValueType*>(decoder->currentScanlineOfBand(0));
+
+                    ImageRowIterator is(image_iterator.rowIterator());
+                    const ImageRowIterator is_end(is + width);
+                    AlphaRowIterator as(alpha_iterator.rowIterator());
+
+                    while (is != is_end)
+                    {
+                        image_accessor.setComponent(scanline[0], is, 0);
+                        image_accessor.setComponent(scanline[1], is, 1);
+                        image_accessor.setComponent(scanline[2], is, 2);
+                        alpha_accessor.set(scanline[3], as);
+                        scanline += 4;
+
+                        ++is;
+                        ++as;
+                    }
+
+                    ++image_iterator.y;
+                    ++alpha_iterator.y;
+                }
+            }
+            else if (accessor_size == 3U)
             {
                 const ValueType* scanline_0;
                 const ValueType* scanline_1;
@@ -37,12 +37,51 @@
 #ifndef VIGRA_INITIMAGE_HXX
 #define VIGRA_INITIMAGE_HXX
 
+#include <cstring>
+#include <cstddef>
 #include "utilities.hxx"
 #include "iteratortraits.hxx"
 #include "functortraits.hxx"
+#include "accessor.hxx"
+#include "metaprogramming.hxx"
 
 namespace vigra {
 
+namespace detail {
+
+// Fill a contiguous span with a constant. For POD types, the fill is
+// lowered to memset() whenever all bytes of the fill pattern are
+// identical (in particular for zero), and to a plain assignment loop
+// that the compiler can vectorize otherwise.
+template <class T>
+inline void
+fillContiguousLine(T * d, std::ptrdiff_t n, T const & val, VigraTrueType /* isPOD */)
+{
+    unsigned char const * p = reinterpret_cast<unsigned char const *>(&val);
+    bool uniform = true;
+    for(std::size_t k = 1; k < sizeof(T); ++k)
+        uniform = uniform && (p[k] == p[0]);
+    if(uniform)
+    {
+        std::memset(d, p[0], n*sizeof(T));
+    }
+    else
+    {
+        for(std::ptrdiff_t k = 0; k < n; ++k)
+            d[k] = val;
+    }
+}
+
+template <class T>
+inline void
+fillContiguousLine(T * d, std::ptrdiff_t n, T const & val, VigraFalseType /* isPOD */)
+{
+    for(std::ptrdiff_t k = 0; k < n; ++k)
+        d[k] = val;
+}
+
+} // namespace detail
+
 /** \addtogroup InitAlgo Algorithms to Initialize Images
     
     Init images or image borders
@@ -73,6 +112,33 @@ initLineImpl(DestIterator d, DestIterator dend, DestAccessor dest,
         dest.set(f(), d);
 }
 
+    // fast path for contiguous scalar destinations with the standard
+    // accessors: convert the fill value once through the accessor, then
+    // fill the span with memset() or a vectorizable assignment loop
+template <class T, class VALUETYPE>
+inline void
+initLineImpl(T * d, T * dend, StandardValueAccessor<T> dest,
+             VALUETYPE const & v, VigraFalseType)
+{
+    if(d == dend)
+        return;
+    T val;
+    dest.set(v, &val);
+    detail::fillContiguousLine(d, dend - d, val, typename TypeTraits<T>::isPOD());
+}
+
+template <class T, class VALUETYPE>
+inline void
+initLineImpl(T * d, T * dend, StandardAccessor<T> dest,
+             VALUETYPE const & v, VigraFalseType)
+{
+    if(d == dend)
+        return;
+    T val;
+    dest.set(v, &val);
+    detail::fillContiguousLine(d, dend - d, val, typename TypeTraits<T>::isPOD());
+}
+
 template <class DestIterator, class DestAccessor, class VALUETYPE>
 inline void
 initLine(DestIterator d, DestIterator dend, DestAccessor dest,
@@ -45,6 +45,8 @@
 #include "functortraits.hxx"
 #include "rgbvalue.hxx"
 #include "inspector_passes.hxx"
+#include "array_vector.hxx"
+#include "parallel_options.hxx"
 
 namespace vigra {
 
@@ -126,6 +128,19 @@ inspectTwoLinesIf(SrcIterator1 s1,
     value.
     The function uses an accessor to access the pixel data.
 
+    The variants taking a \ref vigra::ParallelOptions argument distribute
+    the scan over horizontal strips when VIGRA was compiled with OpenMP
+    support. Each strip is inspected by a reset copy of the functor, and
+    the per-strip results are merged into <tt>f</tt> in strip order by
+    means of the functor's merge operator (e.g.
+    <tt>FindMinMax::operator()(FindMinMax const &)</tt>). The functor must
+    therefore be copy constructible and provide <tt>reset()</tt> and a
+    merge operator, as all analysers in this file do. Functors requiring
+    several synchronized passes over the image and small images are
+    processed serially. Results are identical to the
+    serial version up to the usual floating-point rounding differences
+    caused by the changed summation order.
+
     <b> Declarations:</b>
 
     pass arguments explicitly:
@@ -135,6 +150,11 @@ inspectTwoLinesIf(SrcIterator1 s1,
         void
         inspectImage(ImageIterator upperleft, ImageIterator lowerright,
                      Accessor a, Functor & f)
+
+        template <class ImageIterator, class Accessor, class Functor>
+        void
+        inspectImage(ImageIterator upperleft, ImageIterator lowerright,
+                     Accessor a, Functor & f, ParallelOptions const & options)
     }
     \endcode
 
@@ -145,6 +165,11 @@ inspectTwoLinesIf(SrcIterator1 s1,
         void
         inspectImage(triple<ImageIterator, ImageIterator, Accessor> img,
              Functor & f)
+
+        template <class ImageIterator, class Accessor, class Functor>
+        void
+        inspectImage(triple<ImageIterator, ImageIterator, Accessor> img,
+             Functor & f, ParallelOptions const & options)
     }
     \endcode
 
@@ -193,6 +218,17 @@ struct inspectImage_binder
     void operator()(Functor & f)
     {
         int w = lowerright.x - upperleft.x;
+        int h = lowerright.y - upperleft.y;
+
+        // a contiguous image can be inspected in a single fused
+        // inspectLine() call; the pixels are visited in the same
+        // scan order as by the row loop
+        if(detail::contiguousImageRows(upperleft, w, h, upperleft.rowIterator()))
+        {
+            inspectLine(upperleft.rowIterator(),
+                        upperleft.rowIterator() + std::ptrdiff_t(w)*h, a, f);
+            return;
+        }
 
         for (ImageIterator t = upperleft; t.y < lowerright.y; ++t.y)
         {
@@ -219,6 +255,62 @@ inspectImage(triple<ImageIterator, ImageIterator, Accessor> img,
     inspectImage(img.first, img.second, img.third, f);
 }
 
+template <class ImageIterator, class Accessor, class Functor>
+void
+inspectImage(ImageIterator upperleft, ImageIterator lowerright,
+         Accessor a, Functor & f, ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    int w = lowerright.x - upperleft.x;
+    int h = lowerright.y - upperleft.y;
+
+    if(options.getNumThreads() > 1 &&
+       double(w)*double(h) >= 65536.0 &&
+       !detail::get_extra_passes<Functor>::value)
+    {
+        int stripHeight = options.getBlockSize(h);
+        int stripCount = (h + stripHeight - 1) / stripHeight;
+
+        // one reset copy of f per strip, merged in strip order below
+        ArrayVector<Functor> stripResults(stripCount, f);
+
+        #pragma omp parallel num_threads(options.getNumThreads())
+        {
+            #pragma omp for schedule(dynamic)
+            for(int strip = 0; strip < stripCount; ++strip)
+            {
+                Functor & g = stripResults[strip];
+                g.reset();
+
+                int y0 = strip * stripHeight;
+                int y1 = std::min(h, y0 + stripHeight);
+
+                ImageIterator t(upperleft);
+                t.y += y0;
+                for(int y = y0; y < y1; ++y, ++t.y)
+                    inspectLine(t.rowIterator(), t.rowIterator() + w, a, g);
+            }
+        }
+
+        for(int strip = 0; strip < stripCount; ++strip)
+            f(stripResults[strip]);
+        return;
+    }
+#else
+    (void)options;
+#endif
+    inspectImage(upperleft, lowerright, a, f);
+}
+
+template <class ImageIterator, class Accessor, class Functor>
+inline
+void
+inspectImage(triple<ImageIterator, ImageIterator, Accessor> img,
+         Functor & f, ParallelOptions const & options)
+{
+    inspectImage(img.first, img.second, img.third, f, options);
+}
+
 namespace functor
 {
     template <class T> class UnaryAnalyser;
@@ -496,6 +588,18 @@ struct inspectTwoImages_binder
     void operator()(Functor & f)
     {
         int w = lowerright1.x - upperleft1.x;
+        int h = lowerright1.y - upperleft1.y;
+
+        // when both images are contiguous in memory, inspect all
+        // pixels in a single fused inspectTwoLines() call
+        if(detail::contiguousImageRows(upperleft1, w, h, upperleft1.rowIterator()) &&
+           detail::contiguousImageRows(upperleft2, w, h, upperleft2.rowIterator()))
+        {
+            inspectTwoLines(upperleft1.rowIterator(),
+                            upperleft1.rowIterator() + std::ptrdiff_t(w)*h, a1,
+                            upperleft2.rowIterator(), a2, f);
+            return;
+        }
 
         ImageIterator1 t1 = upperleft1;
         ImageIterator2 t2 = upperleft2;
@@ -901,6 +1005,63 @@ class FunctorTraits<FindMinMax<VALUETYPE> >
     typedef VigraTrueType isUnaryAnalyser;
 };
 
+namespace detail {
+
+template <class SrcIterator, class SrcAccessor, class VALUETYPE>
+inline void
+inspectLineMinMax(SrcIterator s, SrcIterator send, SrcAccessor src,
+                  FindMinMax<VALUETYPE> & f, VigraFalseType)
+{
+    for(; s != send; ++s)
+        f(src(s));
+}
+
+template <class SrcIterator, class SrcAccessor, class VALUETYPE>
+inline void
+inspectLineMinMax(SrcIterator s, SrcIterator send, SrcAccessor src,
+                  FindMinMax<VALUETYPE> & f, VigraTrueType)
+{
+    if(s == send)
+        return;
+
+    // accumulate the extremes of the line with branch-free selects
+    // that the compiler can vectorize, then update the functor once
+    VALUETYPE lo = src(s), hi = lo;
+    unsigned int n = 1;
+    for(++s; s != send; ++s, ++n)
+    {
+        VALUETYPE v = src(s);
+        lo = (v < lo) ? v : lo;
+        hi = (hi < v) ? v : hi;
+    }
+
+    if(f.count)
+    {
+        if(lo < f.min) f.min = lo;
+        if(f.max < hi) f.max = hi;
+    }
+    else
+    {
+        f.min = lo;
+        f.max = hi;
+    }
+    f.count += n;
+}
+
+} // namespace detail
+
+    // fast path for scalar pixels: the generic inspectLine() updates
+    // min, max, and count per pixel, which the compiler cannot vectorize
+template <class SrcIterator, class SrcAccessor, class VALUETYPE>
+inline void
+inspectLine(SrcIterator s, SrcIterator send, SrcAccessor src,
+            FindMinMax<VALUETYPE> & f)
+{
+    typedef typename IsSameType<typename SrcAccessor::value_type,
+                                VALUETYPE>::result UseDirectPath;
+    detail::inspectLineMinMax(s, send, src, f, UseDirectPath());
+}
+
 /********************************************************/
 /*                                                      */
 /*                      FindSum                         */
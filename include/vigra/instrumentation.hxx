@@ -0,0 +1,285 @@
+/************************************************************************/
+/*                                                                      */
+/*               Copyright 2012 by Ullrich Koethe                       */
+/*                                                                      */
+/*    This file is part of the VIGRA computer vision library.           */
+/*    The VIGRA Website is                                              */
+/*        http://hci.iwr.uni-heidelberg.de/vigra/                       */
+/*    Please direct questions, bug reports, and contributions to        */
+/*        ullrich.koethe@iwr.uni-heidelberg.de    or                    */
+/*        vigra@informatik.uni-hamburg.de                               */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+#ifndef VIGRA_INSTRUMENTATION_HXX
+#define VIGRA_INSTRUMENTATION_HXX
+
+#include <cstddef>
+#include <string>
+#include <map>
+#include <vector>
+#include <ostream>
+
+/** \page Instrumentation  Hot-path instrumentation counters
+
+    <b>\#include</b> \<vigra/instrumentation.hxx\><br>
+    Namespace: vigra
+
+    Instrumented library internals count temporary heap allocations,
+    temporary bytes, full-array data passes, and bytes moved per
+    algorithm, so that memory-bandwidth problems can be attributed to
+    specific library calls. The counters are disabled by default: the
+    instrumentation macros compile to nothing unless the program is
+    built with <tt>-DVIGRA_INSTRUMENTATION</tt>, so release builds pay
+    no overhead. The query interface (\ref vigra::instrumentationStats()
+    etc.) is always available and simply reports zero counts in
+    uninstrumented builds.
+
+    Counts are attributed to every instrumented scope active at the
+    time of the event, so a convolution performed inside
+    <tt>gaussianGradientMultiArray()</tt> shows up both under
+    "gaussianGradientMultiArray" and under
+    "separableConvolveMultiArray". The "allocations" counter covers
+    the temporaries annotated inside the library, not every call to
+    <tt>operator new</tt>. The registry is not thread-safe; collect
+    statistics from single-threaded runs (e.g. with
+    <tt>ParallelOptions().numThreads(1)</tt>).
+
+    Typical usage:
+
+    \code
+    // compile with -DVIGRA_INSTRUMENTATION
+    vigra::resetInstrumentation();
+
+    gaussianGradientMultiArray(srcMultiArrayRange(vol), destMultiArray(grad), 2.0);
+
+    vigra::InstrumentationStats s =
+        vigra::instrumentationStats("gaussianGradientMultiArray");
+    std::cout << s.passes << " passes, "
+              << s.bytesMoved / (1024.0*1024.0) << " MB moved, "
+              << s.allocatedBytes << " temporary bytes\n";
+
+    // or dump everything:
+    vigra::printInstrumentationReport(std::cout);
+    \endcode
+*/
+
+namespace vigra {
+
+/** \brief Counters collected for one instrumented algorithm.
+
+    See \ref Instrumentation for an overview.
+*/
+struct InstrumentationStats
+{
+        /** number of annotated temporary heap allocations */
+    std::size_t allocations;
+        /** total size of the annotated allocations in bytes */
+    std::size_t allocatedBytes;
+        /** number of full passes over the algorithm's data */
+    std::size_t passes;
+        /** bytes read and written by the counted passes */
+    std::size_t bytesMoved;
+
+    InstrumentationStats()
+    : allocations(0),
+      allocatedBytes(0),
+      passes(0),
+      bytesMoved(0)
+    {}
+};
+
+/** \brief Registry holding the \ref InstrumentationStats of all
+    instrumented algorithms, keyed by algorithm name.
+
+    Use the free functions \ref instrumentationStats(),
+    \ref resetInstrumentation() and \ref printInstrumentationReport()
+    for queries; the member functions below are called by the
+    instrumentation macros inside the library.
+*/
+class InstrumentationRegistry
+{
+  public:
+    typedef std::map<std::string, InstrumentationStats> StatsMap;
+
+    static InstrumentationRegistry & instance()
+    {
+        static InstrumentationRegistry registry;
+        return registry;
+    }
+
+        /** Counters of the given algorithm (all zero when the
+            algorithm never ran or the build is uninstrumented).
+        */
+    InstrumentationStats stats(std::string const & name) const
+    {
+        StatsMap::const_iterator i = stats_.find(name);
+        return i == stats_.end() ? InstrumentationStats() : i->second;
+    }
+
+        /** All counters collected so far.
+        */
+    StatsMap const & statsMap() const
+    {
+        return stats_;
+    }
+
+        /** Forget all counters (active scopes are retained).
+        */
+    void reset()
+    {
+        stats_.clear();
+    }
+
+        // the functions below are the back-end of the
+        // VIGRA_INSTRUMENT_* macros
+
+    void enterScope(char const * name)
+    {
+        scopes_.push_back(name);
+    }
+
+    void leaveScope()
+    {
+        scopes_.pop_back();
+    }
+
+    void recordAllocation(std::size_t bytes)
+    {
+        for(std::size_t k = 0; k < scopes_.size(); ++k)
+        {
+            InstrumentationStats & s = stats_[scopes_[k]];
+            ++s.allocations;
+            s.allocatedBytes += bytes;
+        }
+    }
+
+    void recordPass(std::size_t bytesMoved)
+    {
+        for(std::size_t k = 0; k < scopes_.size(); ++k)
+        {
+            InstrumentationStats & s = stats_[scopes_[k]];
+            ++s.passes;
+            s.bytesMoved += bytesMoved;
+        }
+    }
+
+  private:
+    InstrumentationRegistry()
+    {}
+
+    InstrumentationRegistry(InstrumentationRegistry const &); // not implemented
+    InstrumentationRegistry & operator=(InstrumentationRegistry const &); // not implemented
+
+    StatsMap stats_;
+    std::vector<std::string> scopes_;
+};
+
+    /** Counters of the given algorithm (see \ref InstrumentationRegistry::stats()).
+    */
+inline InstrumentationStats instrumentationStats(std::string const & name)
+{
+    return InstrumentationRegistry::instance().stats(name);
+}
+
+    /** Reset all counters, typically right before the code region to
+        be measured.
+    */
+inline void resetInstrumentation()
+{
+    InstrumentationRegistry::instance().reset();
+}
+
+    /** Write a table of all collected counters to the given stream.
+    */
+inline void printInstrumentationReport(std::ostream & out)
+{
+    InstrumentationRegistry::StatsMap const & m =
+        InstrumentationRegistry::instance().statsMap();
+    out << "algorithm,allocations,allocated_bytes,passes,bytes_moved\n";
+    for(InstrumentationRegistry::StatsMap::const_iterator i = m.begin();
+                                                          i != m.end(); ++i)
+    {
+        out << i->first << "," << i->second.allocations << ","
+            << i->second.allocatedBytes << "," << i->second.passes << ","
+            << i->second.bytesMoved << "\n";
+    }
+}
+
+#ifdef VIGRA_INSTRUMENTATION
+
+namespace detail {
+
+// RAII helper of VIGRA_INSTRUMENT_SCOPE
+class InstrumentationScope
+{
+  public:
+    explicit InstrumentationScope(char const * name)
+    {
+        InstrumentationRegistry::instance().enterScope(name);
+    }
+
+    ~InstrumentationScope()
+    {
+        InstrumentationRegistry::instance().leaveScope();
+    }
+
+  private:
+    InstrumentationScope(InstrumentationScope const &); // not implemented
+    InstrumentationScope & operator=(InstrumentationScope const &); // not implemented
+};
+
+} // namespace detail
+
+    /** Declare the enclosing block an instrumented algorithm: all
+        events recorded until the end of the block are attributed to
+        \a name. \hideinitializer
+    */
+#define VIGRA_INSTRUMENT_SCOPE(name) \
+    ::vigra::detail::InstrumentationScope vigra_instrumentation_scope_(name);
+
+    /** Record a temporary heap allocation of the given size.
+        \hideinitializer
+    */
+#define VIGRA_INSTRUMENT_ALLOCATION(bytes) \
+    ::vigra::InstrumentationRegistry::instance().recordAllocation(bytes);
+
+    /** Record one full pass over the data that reads and writes the
+        given number of bytes. \hideinitializer
+    */
+#define VIGRA_INSTRUMENT_PASS(bytesMoved) \
+    ::vigra::InstrumentationRegistry::instance().recordPass(bytesMoved);
+
+#else // VIGRA_INSTRUMENTATION
+
+#define VIGRA_INSTRUMENT_SCOPE(name)
+#define VIGRA_INSTRUMENT_ALLOCATION(bytes)
+#define VIGRA_INSTRUMENT_PASS(bytesMoved)
+
+#endif // VIGRA_INSTRUMENTATION
+
+} // namespace vigra
+
+#endif // VIGRA_INSTRUMENTATION_HXX
@@ -144,6 +144,46 @@ struct IteratorTraitsBase
 
 //@}
 
+namespace detail {
+
+// Support for the contiguous-row fast path of the old-style 2-D
+// algorithms (copyImage(), transformImage(), inspectImage(), ...):
+// when the row_iterator of an image iterator is a plain pointer, the
+// overload below checks at run time whether the h rows of width w
+// starting at 'upperLeft' follow each other in memory without gaps. If
+// they do, the caller may collapse its x/y loop nest into a single
+// 1-D loop over the w*h consecutive pixels beginning at
+// upperLeft.rowIterator(), saving the per-row iterator bookkeeping.
+// The generic overload (non-pointer row iterator) reports a
+// non-contiguous layout, so callers keep the row-by-row code. The
+// check costs one pointer comparison per row, which is negligible
+// compared to the row contents.
+
+template <class ImageIterator, class RowIterator>
+inline bool
+contiguousImageRows(ImageIterator const &, int, int, RowIterator)
+{
+    return false;
+}
+
+template <class ImageIterator, class T>
+inline bool
+contiguousImageRows(ImageIterator const & upperLeft, int w, int h, T * rowStart)
+{
+    ImageIterator row(upperLeft);
+    for(int y = 1; y < h; ++y)
+    {
+        ++row.y;
+        T * nextRowStart = row.rowIterator();
+        if(nextRowStart != rowStart + w)
+            return false;
+        rowStart = nextRowStart;
+    }
+    return true;
+}
+
+} // namespace detail
+
 
 /***********************************************************/
 
@@ -43,6 +43,9 @@
 #include "stdimage.hxx"
 #include "union_find.hxx"
 #include "sized_int.hxx"
+#include "transformimage.hxx"
+#include "array_vector.hxx"
+#include "parallel_options.hxx"
 
 namespace vigra {
 
@@ -289,6 +292,164 @@ unsigned int labelImage(triple<SrcIterator, SrcIterator, SrcAccessor> src,
                  std::equal_to<typename SrcAccessor::value_type>());
 }
 
+/** \brief Multi-threaded variant of \ref labelImage().
+
+    The image is divided into one horizontal strip per thread, and every
+    thread labels its strip independently with the sequential algorithm.
+    Afterwards, components crossing strip boundaries are merged by running
+    union-find over the boundary rows, and a parallel relabeling pass maps
+    all pixels to the merged, contiguous label range. The resulting labels
+    are identical to the output of the sequential \ref labelImage(): regions
+    are numbered 1, 2, ... in scan order of their first pixel.
+
+    \code
+    vigra::BImage src(w,h);
+    vigra::IImage labels(w,h);
+
+    vigra::labelImage(srcImageRange(src), destImage(labels), false,
+                      ParallelOptions().numThreads(4));
+    \endcode
+
+    Without OpenMP support, or when one thread is requested, this simply
+    calls the sequential algorithm.
+*/
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor,
+          class EqualityFunctor>
+unsigned int labelImage(SrcIterator upperlefts,
+                        SrcIterator lowerrights, SrcAccessor sa,
+                        DestIterator upperleftd, DestAccessor da,
+                        bool eight_neighbors, EqualityFunctor equal,
+                        ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    typedef typename DestAccessor::value_type LabelType;
+
+    int w = lowerrights.x - upperlefts.x;
+    int h = lowerrights.y - upperlefts.y;
+    int num_threads = options.getNumThreads();
+    if(num_threads > h)
+        num_threads = h;
+    if(num_threads > 1 && w > 0)
+    {
+        // pass 1: label one horizontal strip per thread independently,
+        // using the sequential algorithm with strip-local labels 1...counts[t]
+        ArrayVector<int> bounds((unsigned int)num_threads + 1);
+        for(int t = 0; t <= num_threads; ++t)
+            bounds[t] = (int)(((long long)h * t) / num_threads);
+        ArrayVector<unsigned int> counts((unsigned int)num_threads, 0u);
+        std::string errorMessage;
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(int t = 0; t < num_threads; ++t)
+        {
+            try
+            {
+                counts[t] = labelImage(upperlefts + Diff2D(0, bounds[t]),
+                                       upperlefts + Diff2D(w, bounds[t+1]), sa,
+                                       upperleftd + Diff2D(0, bounds[t]), da,
+                                       eight_neighbors, equal);
+            }
+            catch(std::exception & e)
+            {
+#pragma omp critical(vigra_label_image_error)
+                if(errorMessage.empty())
+                    errorMessage = e.what();
+            }
+        }
+        if(!errorMessage.empty())
+            vigra_fail("labelImage(): worker thread failed with:\n" + errorMessage);
+
+        ArrayVector<unsigned int> offsets((unsigned int)num_threads + 1, 0u);
+        for(int t = 0; t < num_threads; ++t)
+            offsets[t+1] = offsets[t] + counts[t];
+        unsigned int total = offsets[num_threads];
+        vigra_invariant(total < (unsigned int)NumericTraits<LabelType>::max(),
+                "connected components: Need more labels than can be represented in the destination type.");
+
+        // pass 2: merge components crossing the strip boundaries
+        detail::UnionFindArray<LabelType> label((LabelType)(total + 1));
+        for(int t = 1; t < num_threads; ++t)
+        {
+            int y = bounds[t];
+            SrcIterator stop = upperlefts + Diff2D(0, y - 1),
+                        sbot = upperlefts + Diff2D(0, y);
+            DestIterator dtop = upperleftd + Diff2D(0, y - 1),
+                         dbot = upperleftd + Diff2D(0, y);
+            int dx_begin = eight_neighbors ? -1 : 0,
+                dx_end   = eight_neighbors ?  1 : 0;
+            for(int x = 0; x < w; ++x, ++stop.x, ++sbot.x, ++dtop.x, ++dbot.x)
+            {
+                for(int dx = dx_begin; dx <= dx_end; ++dx)
+                {
+                    if(x + dx < 0 || x + dx >= w)
+                        continue;
+                    if(equal(sa(sbot), sa(stop, Diff2D(dx, 0))))
+                        label.makeUnion((LabelType)(da(dtop, Diff2D(dx, 0)) + offsets[t-1]),
+                                        (LabelType)(da(dbot) + offsets[t]));
+                }
+            }
+        }
+        unsigned int count = label.makeContiguous();
+
+        // pass 3: map all pixels to the merged, contiguous label range
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(int t = 0; t < num_threads; ++t)
+        {
+            DestIterator yd = upperleftd + Diff2D(0, bounds[t]);
+            for(int y = bounds[t]; y < bounds[t+1]; ++y, ++yd.y)
+            {
+                typename DestIterator::row_iterator xd = yd.rowIterator();
+                for(int x = 0; x < w; ++x, ++xd)
+                    da.set(label[(LabelType)(da(xd) + offsets[t])], xd);
+            }
+        }
+        return count;
+    }
+#endif
+    return labelImage(upperlefts, lowerrights, sa,
+                      upperleftd, da, eight_neighbors, equal);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor,
+          class EqualityFunctor>
+inline
+unsigned int labelImage(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                        pair<DestIterator, DestAccessor> dest,
+                        bool eight_neighbors, EqualityFunctor equal,
+                        ParallelOptions const & options)
+{
+    return labelImage(src.first, src.second, src.third,
+                      dest.first, dest.second, eight_neighbors, equal, options);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline
+unsigned int labelImage(SrcIterator upperlefts,
+                        SrcIterator lowerrights, SrcAccessor sa,
+                        DestIterator upperleftd, DestAccessor da,
+                        bool eight_neighbors,
+                        ParallelOptions const & options)
+{
+    return labelImage(upperlefts, lowerrights, sa,
+                 upperleftd, da, eight_neighbors,
+                 std::equal_to<typename SrcAccessor::value_type>(), options);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline
+unsigned int labelImage(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                        pair<DestIterator, DestAccessor> dest,
+                        bool eight_neighbors,
+                        ParallelOptions const & options)
+{
+    return labelImage(src.first, src.second, src.third,
+                 dest.first, dest.second, eight_neighbors,
+                 std::equal_to<typename SrcAccessor::value_type>(), options);
+}
+
 /********************************************************/
 /*                                                      */
 /*             labelImageWithBackground                 */
@@ -971,6 +1132,159 @@ void regionImageToEdgeImage(
                                         edge_marker);
 }
 
+/********************************************************/
+/*                                                      */
+/*                    applyLabelLUT                     */
+/*                                                      */
+/********************************************************/
+
+namespace detail {
+
+// look up each label in a translation table
+template <class Label>
+class LabelLUTFunctor
+{
+  public:
+    typedef Label argument_type;
+    typedef Label result_type;
+
+    LabelLUTFunctor(ArrayVector<Label> const & lut)
+    : lut_(lut)
+    {}
+
+    template <class T>
+    Label operator()(T const & v) const
+    {
+        return lut_[(std::size_t)v];
+    }
+
+  private:
+    ArrayVector<Label> const & lut_;
+};
+
+} // namespace detail
+
+/** \brief Translate every label of an image through a look-up table.
+
+    For every pixel, the destination receives <tt>lut[source pixel]</tt>.
+    This is the bulk operation to compact or merge the labels produced by
+    \ref labelImage(): build the table once (e.g. with
+    <tt>UnionFindArray::buildCompactingLUT()</tt> after recording merge
+    decisions) and translate the whole label image in one pass instead of
+    with a hand-written loop. Every source label must be a valid index
+    into \a lut. Source and destination may be the same image.
+
+    The function is implemented on top of \ref transformImage(), so
+    contiguous label images are processed in a single fused loop over all
+    pixels, and the variant taking a \ref vigra::ParallelOptions argument
+    distributes the rows over several threads.
+
+    <b> Declarations:</b>
+
+    pass arguments explicitly:
+    \code
+    namespace vigra {
+        template <class SrcIterator, class SrcAccessor,
+                  class DestIterator, class DestAccessor, class Label>
+        void applyLabelLUT(SrcIterator upperlefts,
+                           SrcIterator lowerrights, SrcAccessor sa,
+                           DestIterator upperleftd, DestAccessor da,
+                           ArrayVector<Label> const & lut)
+
+        template <class SrcIterator, class SrcAccessor,
+                  class DestIterator, class DestAccessor, class Label>
+        void applyLabelLUT(SrcIterator upperlefts,
+                           SrcIterator lowerrights, SrcAccessor sa,
+                           DestIterator upperleftd, DestAccessor da,
+                           ArrayVector<Label> const & lut,
+                           ParallelOptions const & options)
+    }
+    \endcode
+
+    use argument objects in conjunction with \ref ArgumentObjectFactories :
+    \code
+    namespace vigra {
+        template <class SrcIterator, class SrcAccessor,
+                  class DestIterator, class DestAccessor, class Label>
+        void applyLabelLUT(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                           pair<DestIterator, DestAccessor> dest,
+                           ArrayVector<Label> const & lut)
+
+        template <class SrcIterator, class SrcAccessor,
+                  class DestIterator, class DestAccessor, class Label>
+        void applyLabelLUT(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                           pair<DestIterator, DestAccessor> dest,
+                           ArrayVector<Label> const & lut,
+                           ParallelOptions const & options)
+    }
+    \endcode
+
+    <b> Usage:</b>
+
+        <b>\#include</b> \<vigra/labelimage.hxx\><br>
+    Namespace: vigra
+
+    \code
+    vigra::IImage labels(w,h);
+    vigra::labelImage(srcImageRange(img), destImage(labels), false);
+
+    // merge and compact the labels according to external decisions
+    vigra::ArrayVector<int> lut;
+    ... // fill the table, e.g. with UnionFindArray::buildCompactingLUT()
+
+    vigra::applyLabelLUT(srcImageRange(labels), destImage(labels), lut);
+    \endcode
+*/
+doxygen_overloaded_function(template <...> void applyLabelLUT)
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor, class Label>
+inline void
+applyLabelLUT(SrcIterator upperlefts,
+              SrcIterator lowerrights, SrcAccessor sa,
+              DestIterator upperleftd, DestAccessor da,
+              ArrayVector<Label> const & lut)
+{
+    transformImage(upperlefts, lowerrights, sa, upperleftd, da,
+                   detail::LabelLUTFunctor<Label>(lut));
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor, class Label>
+inline void
+applyLabelLUT(SrcIterator upperlefts,
+              SrcIterator lowerrights, SrcAccessor sa,
+              DestIterator upperleftd, DestAccessor da,
+              ArrayVector<Label> const & lut,
+              ParallelOptions const & options)
+{
+    transformImage(upperlefts, lowerrights, sa, upperleftd, da,
+                   detail::LabelLUTFunctor<Label>(lut), options);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor, class Label>
+inline void
+applyLabelLUT(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+              pair<DestIterator, DestAccessor> dest,
+              ArrayVector<Label> const & lut)
+{
+    applyLabelLUT(src.first, src.second, src.third,
+                  dest.first, dest.second, lut);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor, class Label>
+inline void
+applyLabelLUT(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+              pair<DestIterator, DestAccessor> dest,
+              ArrayVector<Label> const & lut,
+              ParallelOptions const & options)
+{
+    applyLabelLUT(src.first, src.second, src.third,
+                  dest.first, dest.second, lut, options);
+}
+
 //@}
 
 } // namespace vigra
@@ -40,6 +40,7 @@
 #include "voxelneighborhood.hxx"
 #include "multi_array.hxx"
 #include "union_find.hxx"
+#include "parallel_options.hxx"
 
 namespace vigra{
 
@@ -339,6 +340,156 @@ unsigned int labelVolumeSix(triple<SrcIterator, SrcShape, SrcAccessor> src,
 
 
 
+/********************************************************/
+/*                                                      */
+/*                 labelVolumeBlockwise                 */
+/*                                                      */
+/********************************************************/
+
+/** \brief Find the connected components of a segmented volume block by block.
+
+    This out-of-core engine labels volumes that do not fit into RAM. The
+    volume is processed in slabs of at most <tt>block_depth</tt> z-slices:
+    every slab is read from the volume source, labeled in memory with
+    \ref labelVolume(), and written back with slab-local labels. Components
+    crossing slab boundaries are then resolved through a global union-find
+    over the saved boundary slices, and a final pass streams the label
+    slabs through the resulting mapping. Only one slab plus two slices per
+    slab boundary reside in memory at any time, and the output is identical
+    to what \ref labelVolume() would produce on the complete volume
+    (regions numbered 1, 2, ... in scan order of their first voxel).
+
+    The volume source mediates all I/O and must provide the following
+    interface, e.g. implemented on top of HDF5File::readBlock() and
+    HDF5File::writeBlock():
+
+    \code
+    struct MyVolumeSource
+    {
+        typedef ... value_type;   // voxel type of the segmentation
+        typedef ... label_type;   // voxel type of the label volume
+
+        MultiArrayShape<3>::type shape() const;
+
+        // transfer the block at the given offset whose extent is
+        // determined by the shape of the passed array
+        void read(MultiArrayShape<3>::type const & offset,
+                  MultiArray<3, value_type> & block) const;
+        void readLabels(MultiArrayShape<3>::type const & offset,
+                        MultiArray<3, label_type> & block) const;
+        void writeLabels(MultiArrayShape<3>::type const & offset,
+                         MultiArray<3, label_type> const & block);
+    };
+    \endcode
+
+    Return:  the number of regions found (= largest region label)
+*/
+template <class VolumeSource, class Neighborhood3D, class EqualityFunctor>
+unsigned int labelVolumeBlockwise(VolumeSource & volume, MultiArrayIndex block_depth,
+                                  Neighborhood3D, EqualityFunctor equal)
+{
+    typedef typename VolumeSource::value_type ValueType;
+    typedef typename VolumeSource::label_type LabelType;
+    typedef typename MultiArrayShape<3>::type Shape;
+
+    Shape shape = volume.shape();
+    MultiArrayIndex w = shape[0], h = shape[1], d = shape[2];
+    if(w <= 0 || h <= 0 || d <= 0)
+        return 0;
+    vigra_precondition(block_depth > 0,
+        "labelVolumeBlockwise(): block_depth > 0 required.");
+
+    unsigned int block_count = (unsigned int)((d + block_depth - 1) / block_depth);
+
+    // pass 1: label each slab independently with slab-local labels
+    //         1...counts[b], keeping copies of the boundary slices
+    ArrayVector<unsigned int> counts(block_count, 0u);
+    ArrayVector<MultiArray<3, ValueType> > first_src(block_count), last_src(block_count);
+    ArrayVector<MultiArray<3, LabelType> > first_label(block_count), last_label(block_count);
+    for(unsigned int b = 0; b < block_count; ++b)
+    {
+        MultiArrayIndex z0 = b * block_depth,
+                        z1 = std::min<MultiArrayIndex>(z0 + block_depth, d);
+        MultiArray<3, ValueType> src(Shape(w, h, z1 - z0));
+        volume.read(Shape(0, 0, z0), src);
+        MultiArray<3, LabelType> labels(src.shape());
+        counts[b] = labelVolume(srcMultiArrayRange(src), destMultiArray(labels),
+                                Neighborhood3D(), equal);
+        volume.writeLabels(Shape(0, 0, z0), labels);
+        if(b > 0)
+        {
+            first_src[b] = src.subarray(Shape(0, 0, 0), Shape(w, h, 1));
+            first_label[b] = labels.subarray(Shape(0, 0, 0), Shape(w, h, 1));
+        }
+        if(b < block_count - 1)
+        {
+            last_src[b] = src.subarray(Shape(0, 0, z1-z0-1), Shape(w, h, z1-z0));
+            last_label[b] = labels.subarray(Shape(0, 0, z1-z0-1), Shape(w, h, z1-z0));
+        }
+    }
+
+    ArrayVector<unsigned int> offsets(block_count + 1, 0u);
+    for(unsigned int b = 0; b < block_count; ++b)
+        offsets[b+1] = offsets[b] + counts[b];
+    unsigned int total = offsets[block_count];
+    vigra_invariant(total < (unsigned int)NumericTraits<LabelType>::max(),
+            "connected components: Need more labels than can be represented in the destination type.");
+
+    // pass 2: merge components crossing the slab boundaries
+    detail::UnionFindArray<LabelType> label((LabelType)(total + 1));
+    MultiArrayIndex delta = ((int)Neighborhood3D::DirectionCount > 6) ? 1 : 0;
+    for(unsigned int b = 1; b < block_count; ++b)
+    {
+        for(MultiArrayIndex y = 0; y < h; ++y)
+        {
+            for(MultiArrayIndex x = 0; x < w; ++x)
+            {
+                for(MultiArrayIndex dy = -delta; dy <= delta; ++dy)
+                {
+                    if(y + dy < 0 || y + dy >= h)
+                        continue;
+                    for(MultiArrayIndex dx = -delta; dx <= delta; ++dx)
+                    {
+                        if(x + dx < 0 || x + dx >= w)
+                            continue;
+                        if(equal(last_src[b-1](x+dx, y+dy, 0), first_src[b](x, y, 0)))
+                            label.makeUnion(
+                                (LabelType)(last_label[b-1](x+dx, y+dy, 0) + offsets[b-1]),
+                                (LabelType)(first_label[b](x, y, 0) + offsets[b]));
+                    }
+                }
+            }
+        }
+        first_src[b] = MultiArray<3, ValueType>();     // boundary data no longer
+        last_src[b-1] = MultiArray<3, ValueType>();    // needed => release memory
+    }
+    unsigned int count = label.makeContiguous();
+
+    // pass 3: stream the label slabs through the merged, contiguous mapping
+    for(unsigned int b = 0; b < block_count; ++b)
+    {
+        MultiArrayIndex z0 = b * block_depth,
+                        z1 = std::min<MultiArrayIndex>(z0 + block_depth, d);
+        MultiArray<3, LabelType> labels(Shape(w, h, z1 - z0));
+        volume.readLabels(Shape(0, 0, z0), labels);
+        typename MultiArray<3, LabelType>::iterator i = labels.begin(),
+                                                    end = labels.end();
+        for(; i != end; ++i)
+            *i = label[(LabelType)(*i + offsets[b])];
+        volume.writeLabels(Shape(0, 0, z0), labels);
+    }
+    return count;
+}
+
+template <class VolumeSource, class Neighborhood3D>
+inline
+unsigned int labelVolumeBlockwise(VolumeSource & volume, MultiArrayIndex block_depth,
+                                  Neighborhood3D neighborhood3D)
+{
+    return labelVolumeBlockwise(volume, block_depth, neighborhood3D,
+                                std::equal_to<typename VolumeSource::value_type>());
+}
+
 /********************************************************/
 /*                                                      */
 /*               labelVolumeWithBackground              */
@@ -599,6 +750,171 @@ unsigned int labelVolumeWithBackground(SrcIterator s_Iter, SrcShape srcShape, Sr
     return count;
 }
 
+/********************************************************/
+/*                                                      */
+/*                    applyLabelLUT                     */
+/*                                                      */
+/********************************************************/
+
+/** \brief Translate every label of a volume through a look-up table.
+
+    For every voxel, the destination receives <tt>lut[source voxel]</tt>.
+    This is the 3-dimensional counterpart of the image version of
+    \ref applyLabelLUT() and serves the same purpose: compacting or
+    merging the labels produced by \ref labelVolume() in one bulk pass,
+    e.g. with a table obtained from
+    <tt>UnionFindArray::buildCompactingLUT()</tt>. Every source label
+    must be a valid index into \a lut. Source and destination may be the
+    same volume. The variant taking a \ref vigra::ParallelOptions
+    argument distributes the slices of the volume over several threads.
+
+    <b> Declarations:</b>
+
+    pass arguments explicitly:
+    \code
+    namespace vigra {
+        template <class SrcIterator, class SrcShape, class SrcAccessor,
+                  class DestIterator, class DestAccessor, class Label>
+        void applyLabelLUT(SrcIterator s_Iter, SrcShape srcShape, SrcAccessor sa,
+                           DestIterator d_Iter, DestAccessor da,
+                           ArrayVector<Label> const & lut)
+
+        template <class SrcIterator, class SrcShape, class SrcAccessor,
+                  class DestIterator, class DestAccessor, class Label>
+        void applyLabelLUT(SrcIterator s_Iter, SrcShape srcShape, SrcAccessor sa,
+                           DestIterator d_Iter, DestAccessor da,
+                           ArrayVector<Label> const & lut,
+                           ParallelOptions const & options)
+    }
+    \endcode
+
+    use argument objects in conjunction with \ref ArgumentObjectFactories :
+    \code
+    namespace vigra {
+        template <class SrcIterator, class SrcShape, class SrcAccessor,
+                  class DestIterator, class DestAccessor, class Label>
+        void applyLabelLUT(triple<SrcIterator, SrcShape, SrcAccessor> src,
+                           pair<DestIterator, DestAccessor> dest,
+                           ArrayVector<Label> const & lut)
+
+        template <class SrcIterator, class SrcShape, class SrcAccessor,
+                  class DestIterator, class DestAccessor, class Label>
+        void applyLabelLUT(triple<SrcIterator, SrcShape, SrcAccessor> src,
+                           pair<DestIterator, DestAccessor> dest,
+                           ArrayVector<Label> const & lut,
+                           ParallelOptions const & options)
+    }
+    \endcode
+
+    <b> Usage:</b>
+
+        <b>\#include</b> \<vigra/labelvolume.hxx\><br>
+    Namespace: vigra
+
+    \code
+    typedef vigra::MultiArray<3,int> IntVolume;
+    IntVolume labels(IntVolume::difference_type(w,h,d));
+    vigra::labelVolumeSix(srcMultiArrayRange(src), destMultiArray(labels));
+
+    vigra::ArrayVector<int> lut;
+    ... // fill the table, e.g. with UnionFindArray::buildCompactingLUT()
+
+    vigra::applyLabelLUT(srcMultiArrayRange(labels), destMultiArray(labels),
+                         lut, vigra::ParallelOptions().numThreads(4));
+    \endcode
+*/
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor, class Label>
+void applyLabelLUT(SrcIterator s_Iter, SrcShape srcShape, SrcAccessor sa,
+                   DestIterator d_Iter, DestAccessor da,
+                   ArrayVector<Label> const & lut)
+{
+    int w = srcShape[0], h = srcShape[1], d = srcShape[2];
+
+    SrcIterator zs = s_Iter;
+    DestIterator zd = d_Iter;
+    for(int z = 0; z != d; ++z, ++zs.dim2(), ++zd.dim2())
+    {
+        SrcIterator ys(zs);
+        DestIterator yd(zd);
+
+        for(int y = 0; y != h; ++y, ++ys.dim1(), ++yd.dim1())
+        {
+            SrcIterator xs(ys);
+            DestIterator xd(yd);
+
+            for(int x = 0; x != w; ++x, ++xs.dim0(), ++xd.dim0())
+            {
+                da.set(lut[(std::size_t)sa(xs)], xd);
+            }
+        }
+    }
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor, class Label>
+void applyLabelLUT(SrcIterator s_Iter, SrcShape srcShape, SrcAccessor sa,
+                   DestIterator d_Iter, DestAccessor da,
+                   ArrayVector<Label> const & lut,
+                   ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    int w = srcShape[0], h = srcShape[1], d = srcShape[2];
+
+    if(options.getNumThreads() > 1 && d > 1)
+    {
+        #pragma omp parallel for schedule(static) num_threads(options.getNumThreads())
+        for(int z = 0; z < d; ++z)
+        {
+            SrcIterator zs(s_Iter);
+            DestIterator zd(d_Iter);
+            zs.dim2() += z;
+            zd.dim2() += z;
+
+            SrcIterator ys(zs);
+            DestIterator yd(zd);
+            for(int y = 0; y != h; ++y, ++ys.dim1(), ++yd.dim1())
+            {
+                SrcIterator xs(ys);
+                DestIterator xd(yd);
+
+                for(int x = 0; x != w; ++x, ++xs.dim0(), ++xd.dim0())
+                {
+                    da.set(lut[(std::size_t)sa(xs)], xd);
+                }
+            }
+        }
+        return;
+    }
+#else
+    (void)options;
+#endif
+    applyLabelLUT(s_Iter, srcShape, sa, d_Iter, da, lut);
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor, class Label>
+inline
+void applyLabelLUT(triple<SrcIterator, SrcShape, SrcAccessor> src,
+                   pair<DestIterator, DestAccessor> dest,
+                   ArrayVector<Label> const & lut)
+{
+    applyLabelLUT(src.first, src.second, src.third,
+                  dest.first, dest.second, lut);
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor, class Label>
+inline
+void applyLabelLUT(triple<SrcIterator, SrcShape, SrcAccessor> src,
+                   pair<DestIterator, DestAccessor> dest,
+                   ArrayVector<Label> const & lut,
+                   ParallelOptions const & options)
+{
+    applyLabelLUT(src.first, src.second, src.third,
+                  dest.first, dest.second, lut, options);
+}
+
 //@}
 
 } //end of namespace vigra
@@ -41,6 +41,7 @@
 #include <string>
 #include "mathutil.hxx"
 #include "matrix.hxx"
+#include "parallel_options.hxx"
 #include "singular_value_decomposition.hxx"
 
 
@@ -592,7 +593,7 @@ void applyHouseholderColumnReflections(MultiArrayView<2, T, C1> const &household
     MultiArrayIndex n = rowCount(householder);
     MultiArrayIndex m = columnCount(householder);
     MultiArrayIndex rhsCount = columnCount(res);
-    
+
     for(int k = m-1; k >= 0; --k)
     {
         MultiArrayView<2, T, C1> u = columnVector(householder, Shape(k,k), n);
@@ -601,6 +602,109 @@ void applyHouseholderColumnReflections(MultiArrayView<2, T, C1> const &household
     }
 }
 
+// factor the panel columns [jb, jend) of 'L' in place, transforming the
+// rows below the panel alongside; contributions of the columns left of
+// the panel must already have been subtracted by trailing updates
+template <class T, class C2>
+bool choleskyPanel(MultiArrayView<2, T, C2> & L, MultiArrayIndex jb, MultiArrayIndex jend)
+{
+    MultiArrayIndex n = rowCount(L);
+    for(MultiArrayIndex j = jb; j < jend; ++j)
+    {
+        for(MultiArrayIndex k = jb; k < j; ++k)
+        {
+            T f = L(j, k);
+            for(MultiArrayIndex i = j; i < n; ++i)
+                L(i, j) -= L(i, k) * f;
+        }
+        if(L(j, j) <= 0.0)
+            return false;  // A is not positive definite
+        T d = std::sqrt(L(j, j));
+        L(j, j) = d;
+        for(MultiArrayIndex i = j + 1; i < n; ++i)
+            L(i, j) /= d;
+    }
+    return true;
+}
+
+// subtract the outer product of the panel columns [jb, jend) from the
+// trailing columns [c0, c1) of 'L' (rows c0 and below)
+template <class T, class C2>
+void choleskyTrailingBlock(MultiArrayView<2, T, C2> & L,
+                           MultiArrayIndex jb, MultiArrayIndex jend,
+                           MultiArrayIndex c0, MultiArrayIndex c1)
+{
+    typedef typename MultiArrayShape<2>::type Shape;
+    MultiArrayIndex n = rowCount(L);
+
+    // copy the transposed panel rows so that mmul() sees contiguous columns
+    Matrix<T> panelT(jend - jb, c1 - c0);
+    for(MultiArrayIndex i = c0; i < c1; ++i)
+        for(MultiArrayIndex k = jb; k < jend; ++k)
+            panelT(k - jb, i - c0) = L(i, k);
+
+    Matrix<T> prod(n - c0, c1 - c0);
+    mmul(L.subarray(Shape(c0, jb), Shape(n, jend)), panelT, prod);
+    L.subarray(Shape(c0, c0), Shape(n, c1)) -= prod;
+}
+
+// blocked right-looking Cholesky decomposition; the O(n^3) trailing
+// updates run on block columns and may be distributed over threads
+template <class T, class C1, class C2>
+bool choleskyDecompositionBlocked(MultiArrayView<2, T, C1> const & A,
+                                  MultiArrayView<2, T, C2> & L, int num_threads)
+{
+    const MultiArrayIndex n = columnCount(A);
+    const MultiArrayIndex blockSize = 64;
+
+    L = A;
+    for(MultiArrayIndex jb = 0; jb < n; jb += blockSize)
+    {
+        MultiArrayIndex jend = std::min(jb + blockSize, n);
+        if(!choleskyPanel(L, jb, jend))
+            return false;
+
+        MultiArrayIndex blocks = (n - jend + blockSize - 1) / blockSize;
+#ifdef _OPENMP
+        if(num_threads > 1 && blocks > 1)
+        {
+            std::string errorMessage;
+
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+            for(int bi = 0; bi < (int)blocks; ++bi)
+            {
+                try
+                {
+                    MultiArrayIndex c0 = jend + bi*blockSize;
+                    choleskyTrailingBlock(L, jb, jend, c0, std::min(c0 + blockSize, n));
+                }
+                catch(std::exception & e)
+                {
+#pragma omp critical(vigra_cholesky_error)
+                    errorMessage += e.what();
+                }
+            }
+
+            if(errorMessage.size())
+                vigra_fail("choleskyDecomposition(): worker thread failed with:\n" + errorMessage);
+        }
+        else
+#endif // _OPENMP
+        {
+            for(MultiArrayIndex bi = 0; bi < blocks; ++bi)
+            {
+                MultiArrayIndex c0 = jend + bi*blockSize;
+                choleskyTrailingBlock(L, jb, jend, c0, std::min(c0 + blockSize, n));
+            }
+        }
+    }
+
+    for(MultiArrayIndex j = 0; j < n; ++j)
+        for(MultiArrayIndex k = j + 1; k < n; ++k)
+            L(j, k) = 0.0;
+    return true;
+}
+
 } // namespace detail
 
 template <class T, class C1, class C2, class C3>
@@ -899,6 +1003,14 @@ T logDeterminant(MultiArrayView<2, T, C1> const & a)
         If \a A is not symmetric, a <tt>ContractViolation</tt> exception is thrown. If it
         is not positive definite, the function returns <tt>false</tt>.
 
+        Matrices with more than 64 columns are factored by a blocked
+        right-looking algorithm whose trailing updates run as matrix products
+        on cache-sized blocks. The second form additionally accepts a
+        \ref vigra::ParallelOptions object and distributes these trailing
+        updates over the given number of threads (one block column per task)
+        when the library is compiled with OpenMP support. The result does not
+        depend on the thread count.
+
     <b>\#include</b> \<vigra/linear_solve.hxx\> or<br>
     <b>\#include</b> \<vigra/linear_algebra.hxx\><br>
         Namespaces: vigra and vigra::linalg
@@ -907,7 +1019,7 @@ template <class T, class C1, class C2>
 bool choleskyDecomposition(MultiArrayView<2, T, C1> const & A,
                            MultiArrayView<2, T, C2> &L)
 {
-    MultiArrayIndex n = columnCount(A); 
+    MultiArrayIndex n = columnCount(A);
     vigra_precondition(rowCount(A) == n,
                        "choleskyDecomposition(): Input matrix must be square.");
     vigra_precondition(n == columnCount(L) && n == rowCount(L),
@@ -915,13 +1027,16 @@ bool choleskyDecomposition(MultiArrayView<2, T, C1> const & A,
     vigra_precondition(isSymmetric(A),
                        "choleskyDecomposition(): Input matrix must be symmetric.");
 
-    for (MultiArrayIndex j = 0; j < n; ++j) 
+    if(n > 64)
+        return detail::choleskyDecompositionBlocked(A, L, 1);
+
+    for (MultiArrayIndex j = 0; j < n; ++j)
     {
         T d(0.0);
-        for (MultiArrayIndex k = 0; k < j; ++k) 
+        for (MultiArrayIndex k = 0; k < j; ++k)
         {
             T s(0.0);
-            for (MultiArrayIndex i = 0; i < k; ++i) 
+            for (MultiArrayIndex i = 0; i < k; ++i)
             {
                s += L(k, i)*L(j, i);
             }
@@ -932,7 +1047,7 @@ bool choleskyDecomposition(MultiArrayView<2, T, C1> const & A,
         if(d <= 0.0)
             return false;  // A is not positive definite
         L(j, j) = std::sqrt(d);
-        for (MultiArrayIndex k = j+1; k < n; ++k) 
+        for (MultiArrayIndex k = j+1; k < n; ++k)
         {
            L(j, k) = 0.0;
         }
@@ -940,6 +1055,22 @@ bool choleskyDecomposition(MultiArrayView<2, T, C1> const & A,
     return true;
 }
 
+template <class T, class C1, class C2>
+bool choleskyDecomposition(MultiArrayView<2, T, C1> const & A,
+                           MultiArrayView<2, T, C2> &L,
+                           ParallelOptions const & options)
+{
+    MultiArrayIndex n = columnCount(A);
+    vigra_precondition(rowCount(A) == n,
+                       "choleskyDecomposition(): Input matrix must be square.");
+    vigra_precondition(n == columnCount(L) && n == rowCount(L),
+                       "choleskyDecomposition(): Output matrix must have same shape as input matrix.");
+    vigra_precondition(isSymmetric(A),
+                       "choleskyDecomposition(): Input matrix must be symmetric.");
+
+    return detail::choleskyDecompositionBlocked(A, L, options.getNumThreads());
+}
+
     /** QR decomposition.
 
         \a a contains the original matrix, results are returned in \a q and \a r, where
@@ -1157,8 +1288,12 @@ void choleskySolve(MultiArrayView<2, T, C1> & L, MultiArrayView<2, T, C2> const
         This function can be applied in-place, i.e. <tt>&b == &res</tt> or <tt>&A == &res</tt> are allowed
         (provided they have the required shapes).
 
+        The second form accepts a \ref vigra::ParallelOptions object which is
+        forwarded to \ref choleskyDecomposition() when \a method is "Cholesky"
+        or "NE"; the other methods ignore it.
+
         The following size requirements apply:
-        
+
         \code
         rowCount(r) == rowCount(b);
         columnCount(r) == rowCount(x);
@@ -1171,7 +1306,8 @@ void choleskySolve(MultiArrayView<2, T, C1> & L, MultiArrayView<2, T, C2> const
      */
 template <class T, class C1, class C2, class C3>
 bool linearSolve(const MultiArrayView<2, T, C1> &A, const MultiArrayView<2, T, C2> &b,
-                 MultiArrayView<2, T, C3> & res, std::string method = "QR")
+                 MultiArrayView<2, T, C3> & res, std::string method,
+                 ParallelOptions const & options)
 {
     typedef typename Matrix<T>::difference_type Shape;
     typedef typename Matrix<T>::view_type SubMatrix;
@@ -1191,7 +1327,7 @@ bool linearSolve(const MultiArrayView<2, T, C1> &A, const MultiArrayView<2, T, C
         vigra_precondition(columnCount(A) == rowCount(A),
             "linearSolve(): Cholesky method requires square coefficient matrix.");
         Matrix<T> L(A.shape());
-        if(!choleskyDecomposition(A, L))
+        if(!choleskyDecomposition(A, L, options))
             return false; // false if A wasn't symmetric positive definite
         choleskySolve(L, b, res);
     }
@@ -1201,7 +1337,7 @@ bool linearSolve(const MultiArrayView<2, T, C1> &A, const MultiArrayView<2, T, C
     }
     else if(method == "ne")
     {
-        return linearSolve(transpose(A)*A, transpose(A)*b, res, "Cholesky");
+        return linearSolve(transpose(A)*A, transpose(A)*b, res, "Cholesky", options);
     }
     else if(method == "svd")
     {
@@ -1229,6 +1365,14 @@ bool linearSolve(const MultiArrayView<2, T, C1> &A, const MultiArrayView<2, T, C
     return true;
 }
 
+template <class T, class C1, class C2, class C3>
+inline bool
+linearSolve(const MultiArrayView<2, T, C1> &A, const MultiArrayView<2, T, C2> &b,
+            MultiArrayView<2, T, C3> & res, std::string method = "QR")
+{
+    return linearSolve(A, b, res, method, ParallelOptions().numThreads(1));
+}
+
 //@}
 
 } // namespace linalg
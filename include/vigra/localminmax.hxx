@@ -45,6 +45,9 @@
 #include "labelvolume.hxx"
 #include "pixelneighborhood.hxx"
 #include "voxelneighborhood.hxx"
+#include "array_vector.hxx"
+#include "union_find.hxx"
+#include "parallel_options.hxx"
 
 namespace vigra
 {
@@ -172,11 +175,130 @@ localMinMax(SrcIterator sul, SrcIterator slr, SrcAccessor sa,
     }
 }
 
+// multi-threaded version: every destination pixel depends only on the
+// immediate source neighborhood, so the interior rows can be processed in
+// independent strips without any seam handling; the border rows (which
+// are only inspected when extrema at the border are allowed) are handled
+// sequentially afterwards
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor,
+          class DestValue, class Neighborhood,
+          class Compare>
+void
+localMinMax(SrcIterator sul, SrcIterator slr, SrcAccessor sa,
+            DestIterator dul, DestAccessor da,
+            DestValue marker, Neighborhood neighborhood,
+            typename SrcAccessor::value_type threshold,
+            Compare compare,
+            bool allowExtremaAtBorder,
+            ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    int w = slr.x - sul.x;
+    int h = slr.y - sul.y;
+    int num_threads = options.getNumThreads();
+    if(num_threads > h - 2)
+        num_threads = h - 2;
+    if(num_threads > 1 && w > 2)
+    {
+        std::string errorMessage;
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(int t = 0; t < num_threads; ++t)
+        {
+            try
+            {
+                int y0 = 1 + (int)(((long long)(h-2) * t) / num_threads);
+                int y1 = 1 + (int)(((long long)(h-2) * (t+1)) / num_threads);
+                SrcIterator  sy = sul + Diff2D(1, y0);
+                DestIterator dy = dul + Diff2D(1, y0);
+                for(int y=y0; y<y1; ++y, ++sy.y, ++dy.y)
+                {
+                    SrcIterator  sx = sy;
+                    DestIterator dx = dy;
+                    for(int x=1; x<w-1; ++x, ++sx.x, ++dx.x)
+                    {
+                        typename SrcAccessor::value_type v = sa(sx);
+
+                        if(!compare(v, threshold))
+                            continue;
+
+                        int i;
+                        NeighborhoodCirculator<SrcIterator, Neighborhood> sc(sx);
+                        for(i = 0; i < Neighborhood::DirectionCount; ++i, ++sc)
+                        {
+                            if(!compare(v, sa(sc)))
+                                break;
+                        }
+
+                        if(i == Neighborhood::DirectionCount)
+                            da.set(marker, dx);
+                    }
+                }
+            }
+            catch(std::exception & e)
+            {
+#pragma omp critical(vigra_local_minmax_error)
+                errorMessage = e.what();
+            }
+        }
+        if(!errorMessage.empty())
+            vigra_fail("localMinMax(): worker thread failed with:\n" + errorMessage);
+
+        if(allowExtremaAtBorder)
+        {
+            SrcIterator is = sul;
+            DestIterator id = dul;
+
+            for(int x=0; x<w; ++x, ++is.x, ++id.x)
+            {
+                if(isLocalExtremum(is, sa, neighborhood, threshold, compare,
+                                    isAtImageBorder(x, 0, w, h)))
+                    da.set(marker, id);
+            }
+
+            is = sul + Diff2D(0,1);
+            id = dul + Diff2D(0,1);
+
+            for(int y=1; y<h-1; ++y, ++is.y, ++id.y)
+            {
+                if(isLocalExtremum(is, sa, neighborhood, threshold, compare,
+                                    isAtImageBorder(0, y, w, h)))
+                    da.set(marker, id);
+            }
+
+            is = sul + Diff2D(w-1,1);
+            id = dul + Diff2D(w-1,1);
+
+            for(int y=1; y<h-1; ++y, ++is.y, ++id.y)
+            {
+                if(isLocalExtremum(is, sa, neighborhood, threshold, compare,
+                                    isAtImageBorder(w-1, y, w, h)))
+                    da.set(marker, id);
+            }
+
+            is = sul + Diff2D(0,h-1);
+            id = dul + Diff2D(0,h-1);
+
+            for(int x=0; x<w; ++x, ++is.x, ++id.x)
+            {
+                if(isLocalExtremum(is, sa, neighborhood, threshold, compare,
+                                    isAtImageBorder(x, h-1, w, h)))
+                    da.set(marker, id);
+            }
+        }
+        return;
+    }
+#endif // _OPENMP
+
+    localMinMax(sul, slr, sa, dul, da, marker, neighborhood,
+                threshold, compare, allowExtremaAtBorder);
+}
+
 template<class SrcIterator, class SrcShape, class SrcAccessor,
         class DestIterator, class DestAccessor, class DestValue,
         class Neighborhood, class Compare>
-void 
-localMinMax3D(SrcIterator sul, SrcShape shp, SrcAccessor sa, 
+void
+localMinMax3D(SrcIterator sul, SrcShape shp, SrcAccessor sa,
               DestIterator dul, DestAccessor da,
               DestValue marker,
               Neighborhood neighborhood,
@@ -279,6 +401,55 @@ localMinMax3D(SrcIterator sul, SrcShape shp, SrcAccessor sa,
     }
 }
 
+// Label one row of equal-value plateaus, given the labels of the previous
+// row. The same routine is replayed in the later scans of
+// extendedLocalMinMax(): with recordUnions == false, no unions are
+// recorded and fresh labels are drawn from nextFresh instead, which
+// reproduces the label sequence of the first scan (the representative
+// stored for a pixel may differ between scans, but always belongs to the
+// same region of the union-find structure)
+template <class SrcIterator, class SrcAccessor, class Equal>
+void
+plateauLabelRow(SrcIterator sx, SrcAccessor sa, int w, bool hasPreviousRow,
+                bool eightNeighbors, Equal equal,
+                int const * prev, int * cur,
+                UnionFindArray<int> & regions, bool recordUnions, int & nextFresh)
+{
+    for(int x = 0; x < w; ++x, ++sx.x)
+    {
+        typename SrcAccessor::value_type v = sa(sx);
+
+        int neighbors[4];
+        int nc = 0;
+        if(x > 0 && equal(v, sa(sx, Diff2D(-1, 0))))
+            neighbors[nc++] = cur[x-1];
+        if(hasPreviousRow)
+        {
+            if(eightNeighbors && x > 0 && equal(v, sa(sx, Diff2D(-1, -1))))
+                neighbors[nc++] = prev[x-1];
+            if(equal(v, sa(sx, Diff2D(0, -1))))
+                neighbors[nc++] = prev[x];
+            if(eightNeighbors && x < w-1 && equal(v, sa(sx, Diff2D(1, -1))))
+                neighbors[nc++] = prev[x+1];
+        }
+
+        if(nc == 0)
+        {
+            cur[x] = recordUnions
+                         ? regions.makeNewLabel()
+                         : nextFresh++;
+        }
+        else
+        {
+            int label = neighbors[0];
+            if(recordUnions)
+                for(int i = 1; i < nc; ++i)
+                    label = regions.makeUnion(label, neighbors[i]);
+            cur[x] = label;
+        }
+    }
+}
+
 template <class SrcIterator, class SrcAccessor,
           class DestIterator, class DestAccessor, class DestValue,
           class Neighborhood, class Compare, class Equal>
@@ -286,7 +457,7 @@ void
 extendedLocalMinMax(SrcIterator sul, SrcIterator slr, SrcAccessor sa,
                     DestIterator dul, DestAccessor da, DestValue marker,
                     Neighborhood /*neighborhood*/,
-                    Compare compare, Equal equal, 
+                    Compare compare, Equal equal,
                     typename SrcAccessor::value_type threshold,
                     bool allowExtremaAtBorder = false)
 {
@@ -295,95 +466,296 @@ extendedLocalMinMax(SrcIterator sul, SrcIterator slr, SrcAccessor sa,
     int w = slr.x - sul.x;
     int h = slr.y - sul.y;
 
-    int i,x,y;
+    if(w <= 0 || h <= 0)
+        return;
 
-    BasicImage<int> labels(w,h);
+    bool eightNeighbors = (Neighborhood::DirectionCount == 8);
 
-    int number_of_regions =
-        labelImage(sul, slr, sa, labels.upperLeft(), labels.accessor(),
-                   (Neighborhood::DirectionCount == 8), equal);
-
-    // assume that a region is a extremum until the opposite is proved
-    std::vector<unsigned char> isExtremum(number_of_regions+1, (unsigned char)1);
+    // first scan: label the plateaus of equal pixels with a union-find
+    // structure, keeping only the labels of two adjacent rows in memory
+    // (no intermediate label image is created)
+    UnionFindArray<int> regions;
+    {
+        ArrayVector<int> prev((unsigned int)w), cur((unsigned int)w);
+        int unusedFresh = 1;
+        SrcIterator sy = sul;
+        for(int y = 0; y < h; ++y, ++sy.y)
+        {
+            plateauLabelRow(sy, sa, w, y > 0, eightNeighbors, equal,
+                            prev.begin(), cur.begin(), regions, true, unusedFresh);
+            prev.swap(cur);
+        }
+    }
 
-    BasicImage<int>::traverser ly = labels.upperLeft();
+    // assume that a region is an extremum until the opposite is proved;
+    // the flags are indexed by the union-find roots
+    std::vector<unsigned char> isExtremum((unsigned int)regions.nextFreeLabel(),
+                                          (unsigned char)1);
 
-    for(y=0; y<h; ++y, ++sul.y, ++ly.y)
+    // second scan: replay the labeling with a three-row window and check
+    // every pixel against its neighbors, exactly as with a full label
+    // image, but looking regions up by their union-find root
     {
-        SrcIterator  sx = sul;
-        BasicImage<int>::traverser lx(ly);
-
-        for(x=0; x<w; ++x, ++sx.x, ++lx.x)
+        ArrayVector<int> buf0((unsigned int)w), buf1((unsigned int)w),
+                         buf2((unsigned int)w);
+        int * rowPrev = buf0.begin();
+        int * rowCur  = buf1.begin();
+        int * rowNext = buf2.begin();
+        int nextFresh = 1;
+
+        plateauLabelRow(sul, sa, w, false, eightNeighbors, equal,
+                        rowPrev, rowCur, regions, false, nextFresh);
+
+        SrcIterator sy = sul;
+        for(int y = 0; y < h; ++y, ++sy.y)
         {
-            int lab = *lx;
-            SrcType v = sa(sx);
-            
-            if(isExtremum[lab] == 0)
-                continue;
-                
-            if(!compare(v, threshold))
+            if(y+1 < h)
             {
-                // mark all regions that don't exceed the threshold as non-extremum
-                isExtremum[lab] = 0;
-                continue;
+                SrcIterator snext = sy;
+                ++snext.y;
+                plateauLabelRow(snext, sa, w, true, eightNeighbors, equal,
+                                rowCur, rowNext, regions, false, nextFresh);
             }
 
-            AtImageBorder atBorder = isAtImageBorder(x, y, w, h);
-            if(atBorder == NotAtBorder)
+            SrcIterator sx = sy;
+            for(int x = 0; x < w; ++x, ++sx.x)
             {
-                NeighborhoodCirculator<SrcIterator, Neighborhood> sc(sx);
-                NeighborhoodCirculator<BasicImage<int>::traverser, Neighborhood> lc(lx);
-                for(i=0; i<Neighborhood::DirectionCount; ++i, ++sc, ++lc)
+                int lab = regions.find(rowCur[x]);
+                SrcType v = sa(sx);
+
+                if(isExtremum[lab] == 0)
+                    continue;
+
+                if(!compare(v, threshold))
                 {
-                    if(lab != *lc && compare(sa(sc),v))
-                    {
-                        isExtremum[lab] = 0;
-                        break;
-                    }
+                    // mark all regions that don't exceed the threshold as non-extremum
+                    isExtremum[lab] = 0;
+                    continue;
                 }
-            }
-            else
-            {
-                if(allowExtremaAtBorder)
+
+                AtImageBorder atBorder = isAtImageBorder(x, y, w, h);
+                if(atBorder == NotAtBorder)
                 {
-                    RestrictedNeighborhoodCirculator<SrcIterator, Neighborhood> 
-                                                               sc(sx, atBorder), scend(sc);
-                    do
+                    NeighborhoodCirculator<SrcIterator, Neighborhood> sc(sx);
+                    for(int i=0; i<Neighborhood::DirectionCount; ++i, ++sc)
                     {
-                        if(lab != *(lx+sc.diff()) && compare(sa(sc),v))
+                        Diff2D d = sc.diff();
+                        int nlab = (d.y < 0 ? rowPrev : d.y > 0 ? rowNext : rowCur)[x + d.x];
+                        if(lab != regions.find(nlab) && compare(sa(sc),v))
                         {
                             isExtremum[lab] = 0;
                             break;
                         }
                     }
-                    while(++sc != scend);
                 }
                 else
                 {
-                    isExtremum[lab] = 0;
+                    if(allowExtremaAtBorder)
+                    {
+                        RestrictedNeighborhoodCirculator<SrcIterator, Neighborhood>
+                                                                   sc(sx, atBorder), scend(sc);
+                        do
+                        {
+                            Diff2D d = sc.diff();
+                            int nlab = (d.y < 0 ? rowPrev : d.y > 0 ? rowNext : rowCur)[x + d.x];
+                            if(lab != regions.find(nlab) && compare(sa(sc),v))
+                            {
+                                isExtremum[lab] = 0;
+                                break;
+                            }
+                        }
+                        while(++sc != scend);
+                    }
+                    else
+                    {
+                        isExtremum[lab] = 0;
+                    }
                 }
             }
+
+            int * tmp = rowPrev;
+            rowPrev = rowCur;
+            rowCur = rowNext;
+            rowNext = tmp;
         }
     }
 
-    ly = labels.upperLeft();
-    for(y=0; y<h; ++y, ++dul.y, ++ly.y)
+    // third scan: replay the labeling once more and mark the pixels of
+    // the surviving regions
     {
-        DestIterator  xd = dul;
-        BasicImage<int>::Iterator lx(ly);
+        ArrayVector<int> prev((unsigned int)w), cur((unsigned int)w);
+        int nextFresh = 1;
+        SrcIterator sy = sul;
+        for(int y = 0; y < h; ++y, ++sy.y, ++dul.y)
+        {
+            plateauLabelRow(sy, sa, w, y > 0, eightNeighbors, equal,
+                            prev.begin(), cur.begin(), regions, false, nextFresh);
 
-        for(x=0; x<w; ++x, ++xd.x, ++lx.x)
+            DestIterator xd = dul;
+            for(int x = 0; x < w; ++x, ++xd.x)
+            {
+                if(isExtremum[regions.find(cur[x])])
+                    da.set(marker, xd);
+            }
+            prev.swap(cur);
+        }
+    }
+}
+
+// multi-threaded version: the plateau labeling runs with the parallel
+// labelImage(); the subsequent scan marks regions as non-extrema in one
+// flag array per strip (writes never cross strips, reads of the label and
+// source images are side-effect free), and the per-strip verdicts are
+// combined before the marking pass
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor, class DestValue,
+          class Neighborhood, class Compare, class Equal>
+void
+extendedLocalMinMax(SrcIterator sul, SrcIterator slr, SrcAccessor sa,
+                    DestIterator dul, DestAccessor da, DestValue marker,
+                    Neighborhood neighborhood,
+                    Compare compare, Equal equal,
+                    typename SrcAccessor::value_type threshold,
+                    bool allowExtremaAtBorder,
+                    ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    typedef typename SrcAccessor::value_type SrcType;
+
+    int w = slr.x - sul.x;
+    int h = slr.y - sul.y;
+    int num_threads = options.getNumThreads();
+    if(num_threads > h)
+        num_threads = h;
+    if(num_threads > 1 && w > 0)
+    {
+        BasicImage<int> labels(w,h);
+
+        int number_of_regions =
+            labelImage(sul, slr, sa, labels.upperLeft(), labels.accessor(),
+                       (Neighborhood::DirectionCount == 8), equal, options);
+
+        ArrayVector<int> bounds((unsigned int)num_threads + 1);
+        for(int t = 0; t <= num_threads; ++t)
+            bounds[t] = (int)(((long long)h * t) / num_threads);
+
+        // assume that a region is an extremum until one of the strips
+        // proves the opposite
+        ArrayVector<std::vector<unsigned char> >
+            isExtremumPerStrip((unsigned int)num_threads,
+                        std::vector<unsigned char>(number_of_regions+1, (unsigned char)1));
+
+        std::string errorMessage;
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(int t = 0; t < num_threads; ++t)
         {
-            if(isExtremum[*lx])
-                da.set(marker, xd);
+            try
+            {
+                std::vector<unsigned char> & isExtremum = isExtremumPerStrip[t];
+                SrcIterator sy = sul + Diff2D(0, bounds[t]);
+                BasicImage<int>::traverser ly = labels.upperLeft() + Diff2D(0, bounds[t]);
+                for(int y=bounds[t]; y<bounds[t+1]; ++y, ++sy.y, ++ly.y)
+                {
+                    SrcIterator sx = sy;
+                    BasicImage<int>::traverser lx(ly);
+
+                    for(int x=0; x<w; ++x, ++sx.x, ++lx.x)
+                    {
+                        int lab = *lx;
+                        SrcType v = sa(sx);
+
+                        if(isExtremum[lab] == 0)
+                            continue;
+
+                        if(!compare(v, threshold))
+                        {
+                            isExtremum[lab] = 0;
+                            continue;
+                        }
+
+                        AtImageBorder atBorder = isAtImageBorder(x, y, w, h);
+                        if(atBorder == NotAtBorder)
+                        {
+                            NeighborhoodCirculator<SrcIterator, Neighborhood> sc(sx);
+                            NeighborhoodCirculator<BasicImage<int>::traverser, Neighborhood> lc(lx);
+                            for(int i=0; i<Neighborhood::DirectionCount; ++i, ++sc, ++lc)
+                            {
+                                if(lab != *lc && compare(sa(sc),v))
+                                {
+                                    isExtremum[lab] = 0;
+                                    break;
+                                }
+                            }
+                        }
+                        else
+                        {
+                            if(allowExtremaAtBorder)
+                            {
+                                RestrictedNeighborhoodCirculator<SrcIterator, Neighborhood>
+                                                           sc(sx, atBorder), scend(sc);
+                                do
+                                {
+                                    if(lab != *(lx+sc.diff()) && compare(sa(sc),v))
+                                    {
+                                        isExtremum[lab] = 0;
+                                        break;
+                                    }
+                                }
+                                while(++sc != scend);
+                            }
+                            else
+                            {
+                                isExtremum[lab] = 0;
+                            }
+                        }
+                    }
+                }
+            }
+            catch(std::exception & e)
+            {
+#pragma omp critical(vigra_extended_local_minmax_error)
+                errorMessage = e.what();
+            }
         }
+        if(!errorMessage.empty())
+            vigra_fail("extendedLocalMinMax(): worker thread failed with:\n" + errorMessage);
+
+        // a region is an extremum only if no strip found a counterexample
+        std::vector<unsigned char> & isExtremum = isExtremumPerStrip[0];
+        for(int t = 1; t < num_threads; ++t)
+            for(int lab = 0; lab <= number_of_regions; ++lab)
+                if(isExtremumPerStrip[t][lab] == 0)
+                    isExtremum[lab] = 0;
+
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(int t = 0; t < num_threads; ++t)
+        {
+            DestIterator dy = dul + Diff2D(0, bounds[t]);
+            BasicImage<int>::traverser ly = labels.upperLeft() + Diff2D(0, bounds[t]);
+            for(int y=bounds[t]; y<bounds[t+1]; ++y, ++dy.y, ++ly.y)
+            {
+                DestIterator xd = dy;
+                BasicImage<int>::Iterator lx(ly);
+
+                for(int x=0; x<w; ++x, ++xd.x, ++lx.x)
+                {
+                    if(isExtremum[*lx])
+                        da.set(marker, xd);
+                }
+            }
+        }
+        return;
     }
+#endif // _OPENMP
+
+    extendedLocalMinMax(sul, slr, sa, dul, da, marker, neighborhood,
+                        compare, equal, threshold, allowExtremaAtBorder);
 }
 
 template<class SrcIterator, class SrcShape, class SrcAccessor,
         class DestIterator, class DestAccessor, class DestValue,
         class Neighborhood, class Compare, class Equal>
-void 
+void
 extendedLocalMinMax3D(SrcIterator sul, SrcShape shp, SrcAccessor sa,
                       DestIterator dul, DestAccessor da,
                       DestValue marker,
@@ -868,6 +1240,79 @@ localMinima(SrcIterator sul, SrcIterator slr, SrcAccessor sa,
     }
 }
 
+/** \brief Multi-threaded variant of \ref localMinima().
+
+    The image is divided into one horizontal strip per thread. Since every
+    destination pixel only depends on its immediate source neighborhood,
+    the strips are processed independently; with
+    <tt>LocalMinmaxOptions::allowPlateaus()</tt>, the internal plateau
+    labeling uses the parallel \ref labelImage() and the per-region checks
+    are likewise performed strip-wise. The result is identical to the
+    output of the sequential algorithm.
+
+    \code
+    vigra::BImage src(w,h), minima(w,h);
+
+    vigra::localMinima(srcImageRange(src), destImage(minima),
+                       vigra::LocalMinmaxOptions().allowPlateaus(),
+                       ParallelOptions().numThreads(4));
+    \endcode
+
+    Without OpenMP support, or when one thread is requested, this simply
+    calls the sequential algorithm.
+*/
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void
+localMinima(SrcIterator sul, SrcIterator slr, SrcAccessor sa,
+            DestIterator dul, DestAccessor da,
+            LocalMinmaxOptions const & options,
+            ParallelOptions const & parallel_options)
+{
+    typedef typename SrcAccessor::value_type SrcType;
+    typedef typename DestAccessor::value_type DestType;
+
+    SrcType threshold = options.use_threshold
+                           ? std::min(NumericTraits<SrcType>::max(), (SrcType)options.thresh)
+                           : NumericTraits<SrcType>::max();
+    DestType marker = (DestType)options.marker;
+
+    if(options.allow_plateaus)
+    {
+        if(options.neigh == 0 || options.neigh == 4)
+        {
+            detail::extendedLocalMinMax(sul, slr, sa, dul, da, marker, FourNeighborCode(),
+                                        std::less<SrcType>(), std::equal_to<SrcType>(),
+                                        threshold, options.allow_at_border, parallel_options);
+        }
+        else if(options.neigh == 1 || options.neigh == 8)
+        {
+            detail::extendedLocalMinMax(sul, slr, sa, dul, da, marker, EightNeighborCode(),
+                                        std::less<SrcType>(), std::equal_to<SrcType>(),
+                                        threshold, options.allow_at_border, parallel_options);
+        }
+        else
+            vigra_precondition(false, "localMinima(): neighborhood must be 4 or 8.");
+    }
+    else
+    {
+        if(options.neigh == 0 || options.neigh == 4)
+        {
+            detail::localMinMax(sul, slr, sa, dul, da, marker, FourNeighborCode(),
+                                threshold, std::less<SrcType>(), options.allow_at_border,
+                                parallel_options);
+        }
+        else if(options.neigh == 1 || options.neigh == 8)
+        {
+            detail::localMinMax(sul, slr, sa, dul, da, marker, EightNeighborCode(),
+                                threshold, std::less<SrcType>(), options.allow_at_border,
+                                parallel_options);
+        }
+        else
+            vigra_precondition(false, "localMinima(): neighborhood must be 4 or 8.");
+    }
+}
+
 template <class SrcIterator, class SrcAccessor,
           class DestIterator, class DestAccessor,
           class DestValue>
@@ -950,6 +1395,18 @@ localMinima(triple<SrcIterator, SrcIterator, SrcAccessor> src,
                 dest.first, dest.second, options);
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void
+localMinima(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+            pair<DestIterator, DestAccessor> dest,
+            LocalMinmaxOptions const & options,
+            ParallelOptions const & parallel_options)
+{
+    localMinima(src.first, src.second, src.third,
+                dest.first, dest.second, options, parallel_options);
+}
+
 /**************************************************************************/
 
 /********************************************************/
@@ -1210,6 +1667,65 @@ localMaxima(SrcIterator sul, SrcIterator slr, SrcAccessor sa,
     }
 }
 
+/** \brief Multi-threaded variant of \ref localMaxima().
+
+    See the parallel \ref localMinima() for a description of the strip
+    decomposition; the result is identical to the output of the
+    sequential algorithm. Without OpenMP support, or when one thread is
+    requested, this simply calls the sequential algorithm.
+*/
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void
+localMaxima(SrcIterator sul, SrcIterator slr, SrcAccessor sa,
+            DestIterator dul, DestAccessor da,
+            LocalMinmaxOptions const & options,
+            ParallelOptions const & parallel_options)
+{
+    typedef typename SrcAccessor::value_type SrcType;
+    typedef typename DestAccessor::value_type DestType;
+
+    SrcType threshold = options.use_threshold
+                           ? std::max(NumericTraits<SrcType>::min(), (SrcType)options.thresh)
+                           : NumericTraits<SrcType>::min();
+    DestType marker = (DestType)options.marker;
+
+    if(options.allow_plateaus)
+    {
+        if(options.neigh == 0 || options.neigh == 4)
+        {
+            detail::extendedLocalMinMax(sul, slr, sa, dul, da, marker, FourNeighborCode(),
+                                        std::greater<SrcType>(), std::equal_to<SrcType>(),
+                                        threshold, options.allow_at_border, parallel_options);
+        }
+        else if(options.neigh == 1 || options.neigh == 8)
+        {
+            detail::extendedLocalMinMax(sul, slr, sa, dul, da, marker, EightNeighborCode(),
+                                        std::greater<SrcType>(), std::equal_to<SrcType>(),
+                                        threshold, options.allow_at_border, parallel_options);
+        }
+        else
+            vigra_precondition(false, "localMaxima(): neighborhood must be 4 or 8.");
+    }
+    else
+    {
+        if(options.neigh == 0 || options.neigh == 4)
+        {
+            detail::localMinMax(sul, slr, sa, dul, da, marker, FourNeighborCode(),
+                                threshold, std::greater<SrcType>(), options.allow_at_border,
+                                parallel_options);
+        }
+        else if(options.neigh == 1 || options.neigh == 8)
+        {
+            detail::localMinMax(sul, slr, sa, dul, da, marker, EightNeighborCode(),
+                                threshold, std::greater<SrcType>(), options.allow_at_border,
+                                parallel_options);
+        }
+        else
+            vigra_precondition(false, "localMaxima(): neighborhood must be 4 or 8.");
+    }
+}
+
 template <class SrcIterator, class SrcAccessor,
           class DestIterator, class DestAccessor,
           class DestValue>
@@ -1292,6 +1808,18 @@ localMaxima(triple<SrcIterator, SrcIterator, SrcAccessor> src,
                 dest.first, dest.second, options);
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void
+localMaxima(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+            pair<DestIterator, DestAccessor> dest,
+            LocalMinmaxOptions const & options,
+            ParallelOptions const & parallel_options)
+{
+    localMaxima(src.first, src.second, src.third,
+                dest.first, dest.second, options, parallel_options);
+}
+
 /**************************************************************************/
 
 /********************************************************/
@@ -1404,6 +1932,10 @@ localMaxima3D(triple<SrcIterator, SrcShape, SrcAccessor> src,
     a more readable way, so localMinima() should be preferred.
     The function uses accessors.
 
+    Internally, the plateaus are resolved with a union-find structure over
+    a sliding window of image rows, so no intermediate label image is
+    allocated.
+
     <b> Declarations:</b>
 
     use 3-dimensional arrays:
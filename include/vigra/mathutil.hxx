@@ -701,7 +701,7 @@ void symmetric2x2Eigenvalues(T a00, T a01, T a11, T * r0, T * r1)
         This uses a numerically stable version of the analytical eigenvalue formula according to
         <p>
         David Eberly: <a href="http://www.geometrictools.com/Documentation/EigenSymmetric3x3.pdf">
-        <em>"Eigensystems for 3 � 3 Symmetric Matrices (Revisited)"</em></a>, Geometric Tools Documentation, 2006
+        <em>"Eigensystems for 3 � 3 Symmetric Matrices (Revisited)"</em></a>, Geometric Tools Documentation, 2006
 
 
         <b>\#include</b> \<vigra/mathutil.hxx\><br>
@@ -887,6 +887,34 @@ using ::erf;
 
 #endif
 
+    /*! Evaluate the error function over a contiguous array.
+
+        Computes <tt>res[k] = erf(x[k])</tt> for <tt>k = 0 ... size-1</tt>,
+        using the rational approximation from Press et al. "Numerical
+        Recipes" in a tight loop without data-dependent branches, so
+        whole filter grids can be evaluated without serializing on the
+        scalar library function. The absolute error of the approximation
+        is below 1.5e-7 for all arguments; the sign symmetry
+        <tt>erf(-x) == -erf(x)</tt> is exact. For isolated values, or when
+        full double precision is needed, use \ref erf() instead.
+
+        <b>\#include</b> \<vigra/mathutil.hxx\><br>
+        Namespace: vigra
+    */
+inline void erfSpan(double const * x, std::size_t size, double * res)
+{
+    for(std::size_t k = 0; k < size; ++k)
+    {
+        double ax = VIGRA_CSTD::fabs(x[k]);
+        double t = 1.0/(1.0+0.5*ax);
+        double ans = t*VIGRA_CSTD::exp(-ax*ax-1.26551223+t*(1.00002368+t*(0.37409196+
+                                        t*(0.09678418+t*(-0.18628806+t*(0.27886807+
+                                        t*(-1.13520398+t*(1.48851587+t*(-0.82215223+
+                                        t*0.17087277)))))))));
+        res[k] = x[k] >= 0.0 ? 1.0 - ans : ans - 1.0;
+    }
+}
+
 namespace detail {
 
 template <class T>
@@ -42,6 +42,7 @@
 #include "array_vector.hxx"
 #include "sized_int.hxx"
 #include "matrix.hxx"
+#include "rgbvalue.hxx"
 #include <map>
 #include <time.h>
 // This is needed with visual studio 10
@@ -470,6 +471,134 @@ createImage(mwSize width, mwSize height, CellArray::Proxy t)
     return BasicImageView<T>((T *)mxGetData(t), width, height);
 }
 
+/* Zero-copy views of vector-valued (channel-interleaved) MATLAB arrays.
+
+   MATLAB stores arrays in column-major order, i.e. the first dimension
+   varies fastest -- exactly like the innermost dimension of a
+   MultiArrayView. A (SIZE x M x ... x N) MATLAB array whose first
+   dimension holds the channels is therefore bitwise identical to an
+   interleaved (M x ... x N) array of TinyVector<T, SIZE>, and the
+   functions below hand out views of the mxArray storage without copying
+   in either direction. Conventional channels-last arrays must be brought
+   into this layout on the MATLAB side first (e.g. 'permute(A, [3 1 2])'
+   for an RGB image); the functions check the layout and report a
+   mismatch instead of silently copying.
+*/
+template <int DIM, class T, int SIZE>
+MultiArrayView<DIM, TinyVector<T, SIZE> >
+getVectorMultiArray(mxArray const * t)
+{
+    typedef typename MultiArrayView<DIM, TinyVector<T, SIZE> >::difference_type Shape;
+
+    if(!ValueType<T>::check(t))
+    {
+        std::string msg = std::string("getVectorMultiArray(): Input array must have type ") +
+                          ValueType<T>::typeName() + ".";
+        mexErrMsgTxt(msg.c_str());
+    }
+
+    int mdim = mxGetNumberOfDimensions(t);
+    if(DIM + 1 < mdim)
+    {
+        mexErrMsgTxt("getVectorMultiArray(): Input array has too many dimensions.");
+    }
+    const mwSize * matlabShape = mxGetDimensions(t);
+    if(static_cast<int>(matlabShape[0]) != SIZE)
+    {
+        mexErrMsgTxt("getVectorMultiArray(): First dimension of the input array must "
+                     "hold the channels (use 'permute()' to interleave channels-last data).");
+    }
+
+    Shape shape;
+    for(int k=1; k<mdim; ++k)
+    {
+        shape[k-1] = static_cast<typename Shape::value_type>(matlabShape[k]);
+    }
+    for(int k=mdim; k<DIM+1; ++k)
+    {
+        shape[k-1] = 1;
+    }
+    return MultiArrayView<DIM, TinyVector<T, SIZE> >(shape, (TinyVector<T, SIZE> *)mxGetData(t));
+}
+
+template <int DIM, class T, int SIZE>
+MultiArrayView<DIM, TinyVector<T, SIZE> >
+createVectorMultiArray(typename MultiArrayShape<DIM>::type const & shape, mxArray * & t)
+{
+    mwSize matlabShape[DIM+1];
+    matlabShape[0] = static_cast<mwSize>(SIZE);
+    for(int k=0; k<DIM; ++k)
+        matlabShape[k+1] = static_cast<mwSize>(shape[k]);
+    t = mxCreateNumericArray(DIM+1, matlabShape, ValueType<T>::classID, mxREAL);
+
+    return MultiArrayView<DIM, TinyVector<T, SIZE> >(shape, (TinyVector<T, SIZE> *)mxGetData(t));
+}
+
+template <int DIM, class T, int SIZE>
+MultiArrayView<DIM, TinyVector<T, SIZE> >
+createVectorMultiArray(typename MultiArrayShape<DIM>::type const & shape, CellArray::Proxy t)
+{
+    mwSize matlabShape[DIM+1];
+    matlabShape[0] = static_cast<mwSize>(SIZE);
+    for(int k=0; k<DIM; ++k)
+        matlabShape[k+1] = static_cast<mwSize>(shape[k]);
+    t = mxCreateNumericArray(DIM+1, matlabShape, ValueType<T>::classID, mxREAL);
+
+    return MultiArrayView<DIM, TinyVector<T, SIZE> >(shape, (TinyVector<T, SIZE> *)mxGetData(t));
+}
+
+template <class T>
+BasicImageView<RGBValue<T> >
+getRGBImage(mxArray const * t)
+{
+    if(!ValueType<T>::check(t))
+    {
+        std::string msg = std::string("getRGBImage(): Input array must have type ") +
+                          ValueType<T>::typeName() + ".";
+        mexErrMsgTxt(msg.c_str());
+    }
+
+    if(3 != mxGetNumberOfDimensions(t))
+        mexErrMsgTxt("getRGBImage(): Input array must have 3 dimensions.");
+
+    const mwSize * matlabShape = mxGetDimensions(t);
+    if(3 != static_cast<int>(matlabShape[0]))
+    {
+        mexErrMsgTxt("getRGBImage(): First dimension of the input array must "
+                     "hold the channels (use 'permute()' to interleave channels-last data).");
+    }
+
+    return BasicImageView<RGBValue<T> >((RGBValue<T> *)mxGetData(t),
+                                        static_cast<int>(matlabShape[1]),
+                                        static_cast<int>(matlabShape[2]));
+}
+
+template <class T>
+BasicImageView<RGBValue<T> >
+createRGBImage(mwSize width, mwSize height, mxArray * & t)
+{
+    mwSize matlabShape[3];
+    matlabShape[0] = 3;
+    matlabShape[1] = width;
+    matlabShape[2] = height;
+    t = mxCreateNumericArray(3, matlabShape, ValueType<T>::classID, mxREAL);
+
+    return BasicImageView<RGBValue<T> >((RGBValue<T> *)mxGetData(t), width, height);
+}
+
+template <class T>
+BasicImageView<RGBValue<T> >
+createRGBImage(mwSize width, mwSize height, CellArray::Proxy t)
+{
+    mwSize matlabShape[3];
+    matlabShape[0] = 3;
+    matlabShape[1] = width;
+    matlabShape[2] = height;
+    t = mxCreateNumericArray(3, matlabShape, ValueType<T>::classID, mxREAL);
+
+    return BasicImageView<RGBValue<T> >((RGBValue<T> *)mxGetData(t), width, height);
+}
+
 inline ConstCellArray
 getCellArray(mxArray const * t)
 {
@@ -865,6 +994,21 @@ class InputArray
         }
     }
 
+    template <unsigned int N, class T, int SIZE, class Place, class ReqType>
+    MultiArrayView<N, TinyVector<T, SIZE> > getVectorMultiArray(Place posOrName, ReqType req)
+    {
+        if(!hasData(posOrName))
+        {
+            return errorOrDefault< MultiArrayView<N, TinyVector<T, SIZE> > >(req, posOrName);
+        }
+        else
+        {
+            req.argumentWasProvided();
+            value_type temp = (*this)[posOrName];
+            return matlab::getVectorMultiArray<N,T,SIZE>(temp);
+        }
+    }
+
     template < class T, class Place, class ReqType>
     BasicImageView<T> getImage(Place posOrName, ReqType req)
     {
@@ -880,6 +1024,21 @@ class InputArray
         }
     }
 
+    template < class T, class Place, class ReqType>
+    BasicImageView<RGBValue<T> > getRGBImage(Place posOrName, ReqType req)
+    {
+        if(!hasData(posOrName))
+        {
+            return errorOrDefault<BasicImageView<RGBValue<T> > >(req, posOrName);
+        }
+        else
+        {
+            req.argumentWasProvided();
+            value_type temp = (*this)[posOrName];
+            return matlab::getRGBImage<T>(temp);
+        }
+    }
+
     template<class T,unsigned int sze, class Place, class ReqType>
     TinyVectorView< T, sze> getTinyVector(Place posOrName, ReqType req)
     {
@@ -1027,6 +1186,16 @@ class OutputArray
         return matlab::createMultiArray<DIM, T>(shape, (*this)[pos]);
     }
 
+    template <unsigned int DIM, class T, int SIZE, class ReqType>
+    MultiArrayView<DIM, TinyVector<T, SIZE> > createVectorMultiArray(int pos, ReqType req,
+                                            const TinyVector<int, DIM>  & shape)
+    {
+        if(!isValid(pos))
+            return errorOrDefault<MultiArrayView<DIM, TinyVector<T, SIZE> > >(req, pos);
+        req.argumentWasProvided();
+        return matlab::createVectorMultiArray<DIM, T, SIZE>(shape, (*this)[pos]);
+    }
+
     template <class T, class ReqType>
     BasicImageView<T> createImage(int pos, ReqType req,
                                     mwSize width, mwSize height)
@@ -1037,6 +1206,16 @@ class OutputArray
         return matlab::createImage<T>(width, height, (*this)[pos]);
     }
 
+    template <class T, class ReqType>
+    BasicImageView<RGBValue<T> > createRGBImage(int pos, ReqType req,
+                                    mwSize width, mwSize height)
+    {
+        if(!isValid(pos))
+            return errorOrDefault<BasicImageView<RGBValue<T> > >(req, pos);
+        req.argumentWasProvided();
+        return matlab::createRGBImage<T>(width, height, (*this)[pos]);
+    }
+
     template <class T, class ReqType>
     BasicImageView<T> createImage(  int pos, ReqType req,
                                     typename MultiArrayShape<2>::type const & shape)
@@ -1573,9 +1573,128 @@ void smul(T a, const MultiArrayView<2, T, C2> &b, MultiArrayView<2, T, C3> &r)
     smul(b, a, r);
 }
 
+namespace detail {
+
+#ifdef VIGRA_USE_BLAS
+
+extern "C" {
+    void sgemm_(char const * transa, char const * transb,
+                int const * m, int const * n, int const * k,
+                float const * alpha, float const * a, int const * lda,
+                float const * b, int const * ldb,
+                float const * beta, float * c, int const * ldc);
+    void dgemm_(char const * transa, char const * transb,
+                int const * m, int const * n, int const * k,
+                double const * alpha, double const * a, int const * lda,
+                double const * b, int const * ldb,
+                double const * beta, double * c, int const * ldc);
+}
+
+    // fallback when no BLAS routine exists for the value type
+template <class T, class C1, class C2, class C3>
+inline bool
+mmulBlasDispatch(const MultiArrayView<2, T, C1> &, const MultiArrayView<2, T, C2> &,
+                 MultiArrayView<2, T, C3> &)
+{
+    return false;
+}
+
+template <class C1, class C2, class C3>
+inline bool
+mmulBlasDispatch(const MultiArrayView<2, float, C1> &a, const MultiArrayView<2, float, C2> &b,
+                 MultiArrayView<2, float, C3> &r)
+{
+    if(a.stride(0) != 1 || b.stride(0) != 1 || r.stride(0) != 1)
+        return false;  // BLAS expects column-major storage
+    int m = (int)rowCount(r), n = (int)columnCount(r), k = (int)columnCount(a),
+        lda = (int)a.stride(1), ldb = (int)b.stride(1), ldc = (int)r.stride(1);
+    float one = 1.0f, zero = 0.0f;
+    sgemm_("N", "N", &m, &n, &k, &one, a.data(), &lda, b.data(), &ldb, &zero, r.data(), &ldc);
+    return true;
+}
+
+template <class C1, class C2, class C3>
+inline bool
+mmulBlasDispatch(const MultiArrayView<2, double, C1> &a, const MultiArrayView<2, double, C2> &b,
+                 MultiArrayView<2, double, C3> &r)
+{
+    if(a.stride(0) != 1 || b.stride(0) != 1 || r.stride(0) != 1)
+        return false;  // BLAS expects column-major storage
+    int m = (int)rowCount(r), n = (int)columnCount(r), k = (int)columnCount(a),
+        lda = (int)a.stride(1), ldb = (int)b.stride(1), ldc = (int)r.stride(1);
+    double one = 1.0, zero = 0.0;
+    dgemm_("N", "N", &m, &n, &k, &one, a.data(), &lda, b.data(), &ldb, &zero, r.data(), &ldc);
+    return true;
+}
+
+#endif // VIGRA_USE_BLAS
+
+    // cache-blocked matrix product kernel for column-major data with
+    // contiguous columns; 'r' must be zero-initialized
+template <class T>
+void mmulBlocked(T const * a, MultiArrayIndex lda,
+                 T const * b, MultiArrayIndex ldb,
+                 T * r, MultiArrayIndex ldr,
+                 MultiArrayIndex rows, MultiArrayIndex cols, MultiArrayIndex inner)
+{
+    const MultiArrayIndex blockSize = 64;
+
+    for(MultiArrayIndex jb = 0; jb < rows; jb += blockSize)
+    {
+        MultiArrayIndex jend = std::min(jb + blockSize, rows);
+        for(MultiArrayIndex kb = 0; kb < inner; kb += blockSize)
+        {
+            MultiArrayIndex kend = std::min(kb + blockSize, inner);
+
+            // the (jb, kb) block of 'a' stays in cache while all columns of
+            // 'r' are updated; four columns at a time reuse each load of 'a'
+            MultiArrayIndex i = 0;
+            for(; i + 4 <= cols; i += 4)
+            {
+                T * r0 = r + i*ldr, * r1 = r0 + ldr, * r2 = r1 + ldr, * r3 = r2 + ldr;
+                for(MultiArrayIndex k = kb; k < kend; ++k)
+                {
+                    T const * ac = a + k*lda;
+                    T b0 = b[k + i*ldb], b1 = b[k + (i+1)*ldb],
+                      b2 = b[k + (i+2)*ldb], b3 = b[k + (i+3)*ldb];
+                    for(MultiArrayIndex j = jb; j < jend; ++j)
+                    {
+                        T av = ac[j];
+                        r0[j] += av * b0;
+                        r1[j] += av * b1;
+                        r2[j] += av * b2;
+                        r3[j] += av * b3;
+                    }
+                }
+            }
+            for(; i < cols; ++i)
+            {
+                T * rc = r + i*ldr;
+                for(MultiArrayIndex k = kb; k < kend; ++k)
+                {
+                    T const * ac = a + k*lda;
+                    T bk = b[k + i*ldb];
+                    for(MultiArrayIndex j = jb; j < jend; ++j)
+                        rc[j] += ac[j] * bk;
+                }
+            }
+        }
+    }
+}
+
+} // namespace detail
+
     /** perform matrix multiplication of matrices \a a and \a b.
         The result is written into \a r. The three matrices must have matching shapes.
 
+        When all three matrices have contiguous columns (the default storage
+        of \ref vigra::linalg::Matrix), the product is computed with a
+        cache-blocked kernel whose inner loops vectorize; otherwise a generic
+        loop handles arbitrarily strided views. If the macro
+        <tt>VIGRA_USE_BLAS</tt> is defined, <tt>float</tt> and <tt>double</tt>
+        products are instead forwarded to the <tt>sgemm</tt>/<tt>dgemm</tt>
+        routines of an external BLAS library that must be linked in.
+
     <b>\#include</b> \<vigra/matrix.hxx\> or<br>
     <b>\#include</b> \<vigra/linear_algebra.hxx\><br>
         Namespace: vigra::linalg
@@ -1590,13 +1709,27 @@ void mmul(const MultiArrayView<2, T, C1> &a, const MultiArrayView<2, T, C2> &b,
     vigra_precondition(rrows == rowCount(a) && rcols == columnCount(b) && acols == rowCount(b),
                        "mmul(): Matrix shapes must agree.");
 
+#ifdef VIGRA_USE_BLAS
+    if(detail::mmulBlasDispatch(a, b, r))
+        return;
+#endif
+
+    if(a.stride(0) == 1 && b.stride(0) == 1 && r.stride(0) == 1 &&
+       a.stride(1) >= rrows && b.stride(1) >= acols && r.stride(1) >= rrows)
+    {
+        r.init(NumericTraits<T>::zero());
+        detail::mmulBlocked(a.data(), a.stride(1), b.data(), b.stride(1),
+                            r.data(), r.stride(1), rrows, rcols, acols);
+        return;
+    }
+
     // order of loops ensures that inner loop goes down columns
-    for(MultiArrayIndex i = 0; i < rcols; ++i) 
+    for(MultiArrayIndex i = 0; i < rcols; ++i)
     {
-        for(MultiArrayIndex j = 0; j < rrows; ++j) 
+        for(MultiArrayIndex j = 0; j < rrows; ++j)
             r(j, i) = a(j, 0) * b(0, i);
-        for(MultiArrayIndex k = 1; k < acols; ++k) 
-            for(MultiArrayIndex j = 0; j < rrows; ++j) 
+        for(MultiArrayIndex k = 1; k < acols; ++k)
+            for(MultiArrayIndex j = 0; j < rrows; ++j)
                 r(j, i) += a(j, k) * b(k, i);
     }
 }
@@ -2930,7 +3063,7 @@ prepareColumns(MultiArrayView<2, T, C1> const & A, MultiArrayView<2, T, C2> & re
                     MultiArrayView<2, T, C2> & res, 
                     MultiArrayView<2, T, C3> & offset, 
                     MultiArrayView<2, T, C4> & scaling, 
-                    DataPreparationGoals goals = ZeroMean | UnitVariance)�;
+                    DataPreparationGoals goals = ZeroMean | UnitVariance)�;
     } }
     \endcode
 
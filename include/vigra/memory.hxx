@@ -36,9 +36,14 @@
 #ifndef VIGRA_MEMORY_HXX
 #define VIGRA_MEMORY_HXX
 
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <new>
 #include "metaprogramming.hxx"
+#include "error.hxx"
 
-namespace vigra { 
+namespace vigra {
 
 enum SkipInitializationTag { SkipInitialization};
 
@@ -49,6 +54,635 @@ struct CanSkipInitialization
     static const bool value = type::asBool;
 };
 
+/********************************************************/
+/*                                                      */
+/*                     MemoryArena                      */
+/*                                                      */
+/********************************************************/
+
+/** \brief Region-based memory pool with 64-byte aligned allocations.
+
+    A MemoryArena hands out memory by bumping a pointer within large
+    pre-allocated chunks. Every returned address is aligned to
+    <tt>MemoryArena::alignment</tt> (64 bytes, i.e. a cache line and the
+    widest vector register), and an allocation costs only a pointer
+    increment once the chunks exist. Chunks are never returned to the
+    heap before the arena is destroyed: when all outstanding blocks have
+    been deallocated, the arena automatically rewinds and reuses its
+    chunks. Algorithms that allocate the same temporaries in every
+    iteration (e.g. per-frame filtering) therefore perform no heap
+    allocations in the steady state.
+
+    The arena is used via \ref vigra::ArenaAllocator, which can be
+    plugged into \ref vigra::MultiArray, \ref vigra::ArrayVector, or any
+    other container with standard allocator support:
+
+    \code
+    MemoryArena arena;
+
+    for(int frame = 0; frame < nframes; ++frame)
+    {
+        // heap allocation in the first frame only
+        MultiArray<2, float, ArenaAllocator<float> > tmp(shape, ArenaAllocator<float>(arena));
+        ...
+    }   // all blocks returned => arena rewinds for the next frame
+    \endcode
+
+    Deallocation of the most recently allocated block releases its
+    memory immediately (stack-like usage is optimal); blocks freed in
+    any other order are reclaimed collectively when the number of
+    outstanding blocks drops to zero.
+
+    A MemoryArena is not copyable and not thread-safe -- use one arena
+    per thread.
+
+    <b>\#include</b> \<vigra/memory.hxx\><br>
+    Namespace: vigra
+*/
+class MemoryArena
+{
+  public:
+        /** Alignment (in bytes) of all addresses returned by allocate().
+        */
+    static const std::size_t alignment = 64;
+
+        /** Construct an arena.
+
+            New chunks are allocated with at least <tt>minimumChunkSize</tt>
+            bytes (default: 1 MB), larger if a single allocation requires it.
+        */
+    explicit MemoryArena(std::size_t minimumChunkSize = 1 << 20)
+    : chunks_(0),
+      current_chunk_(0),
+      minimum_chunk_size_(alignUp(minimumChunkSize)),
+      outstanding_count_(0),
+      capacity_(0)
+    {}
+
+    ~MemoryArena()
+    {
+        for(Chunk * c = chunks_; c != 0;)
+        {
+            Chunk * next = c->next;
+            delete[] c->raw;
+            delete c;
+            c = next;
+        }
+    }
+
+        /** Get a 64-byte aligned block of at least \a bytes bytes.
+        */
+    void * allocate(std::size_t bytes)
+    {
+        std::size_t n = alignUp(bytes == 0 ? 1 : bytes);
+        if(current_chunk_ == 0 || current_chunk_->size - current_chunk_->used < n)
+        {
+            // chunks behind the current one are guaranteed to be empty;
+            // skip those that are too small (they remain available for
+            // later, smaller requests of the same allocation pattern)
+            Chunk * c = (current_chunk_ == 0)
+                            ? chunks_
+                            : current_chunk_->next;
+            while(c != 0 && c->size < n)
+                c = c->next;
+            if(c == 0)
+                c = addChunk(n);
+            current_chunk_ = c;
+        }
+        char * p = current_chunk_->aligned + current_chunk_->used;
+        current_chunk_->used += n;
+        ++outstanding_count_;
+        return p;
+    }
+
+        /** Return a block obtained from allocate().
+
+            \a bytes must equal the size originally requested. The most
+            recently allocated block is released immediately; other
+            blocks are reclaimed when the last outstanding block has
+            been returned.
+        */
+    void deallocate(void * p, std::size_t bytes)
+    {
+        vigra_precondition(outstanding_count_ > 0,
+            "MemoryArena::deallocate(): no outstanding allocations.");
+        std::size_t n = alignUp(bytes == 0 ? 1 : bytes);
+        if(current_chunk_ != 0 &&
+           static_cast<char *>(p) + n == current_chunk_->aligned + current_chunk_->used)
+        {
+            current_chunk_->used -= n;   // stack-like deallocation
+        }
+        if(--outstanding_count_ == 0)
+            rewind();
+    }
+
+        /** Make the entire arena available for reuse.
+
+            No allocation may be outstanding. The chunks are kept, so
+            subsequent allocations are served without going to the heap.
+        */
+    void reset()
+    {
+        vigra_precondition(outstanding_count_ == 0,
+            "MemoryArena::reset(): allocations are still outstanding.");
+        rewind();
+    }
+
+        /** Number of blocks currently allocated from this arena.
+        */
+    std::size_t outstandingAllocations() const
+    {
+        return outstanding_count_;
+    }
+
+        /** Total number of usable bytes held in the arena's chunks.
+        */
+    std::size_t capacity() const
+    {
+        return capacity_;
+    }
+
+  private:
+    struct Chunk
+    {
+        char * raw;        // address returned by new[]
+        char * aligned;    // first aligned address within 'raw'
+        std::size_t size;  // usable bytes starting at 'aligned'
+        std::size_t used;  // bump offset
+        Chunk * next;
+    };
+
+    MemoryArena(MemoryArena const &);               // not implemented
+    MemoryArena & operator=(MemoryArena const &);   // not implemented
+
+    static std::size_t alignUp(std::size_t n)
+    {
+        return (n + (alignment - 1)) & ~(alignment - 1);
+    }
+
+    Chunk * addChunk(std::size_t n)
+    {
+        std::size_t size = std::max(minimum_chunk_size_, n);
+        Chunk * c = new Chunk;
+        try
+        {
+            c->raw = new char[size + alignment];
+        }
+        catch(...)
+        {
+            delete c;
+            throw;
+        }
+        c->aligned = c->raw +
+                     (alignment - reinterpret_cast<std::size_t>(c->raw) % alignment) % alignment;
+        c->size = size;
+        c->used = 0;
+        c->next = 0;
+        // append, so that the allocation order of the chunks is preserved
+        if(chunks_ == 0)
+        {
+            chunks_ = c;
+        }
+        else
+        {
+            Chunk * last = chunks_;
+            while(last->next != 0)
+                last = last->next;
+            last->next = c;
+        }
+        capacity_ += size;
+        return c;
+    }
+
+    void rewind()
+    {
+        for(Chunk * c = chunks_; c != 0; c = c->next)
+            c->used = 0;
+        current_chunk_ = 0;
+    }
+
+    Chunk * chunks_;
+    Chunk * current_chunk_;
+    std::size_t minimum_chunk_size_;
+    std::size_t outstanding_count_;
+    std::size_t capacity_;
+};
+
+namespace detail {
+
+// 64-byte aligned heap allocation; the address returned by new[] is
+// remembered immediately in front of the aligned block
+inline void * alignedAllocate(std::size_t bytes)
+{
+    char * raw = new char[bytes + MemoryArena::alignment + sizeof(char *)];
+    char * aligned = raw + sizeof(char *);
+    aligned += MemoryArena::alignment -
+               reinterpret_cast<std::size_t>(aligned) % MemoryArena::alignment;
+    reinterpret_cast<char **>(aligned)[-1] = raw;
+    return aligned;
+}
+
+inline void alignedDeallocate(void * p)
+{
+    if(p != 0)
+        delete[] reinterpret_cast<char **>(p)[-1];
+}
+
+} // namespace detail
+
+/********************************************************/
+/*                                                      */
+/*                    ArenaAllocator                    */
+/*                                                      */
+/********************************************************/
+
+/** \brief Standard-conforming allocator that draws from a \ref vigra::MemoryArena.
+
+    An ArenaAllocator holds a pointer to a MemoryArena and serves all
+    requests from it, so containers using this allocator obtain 64-byte
+    aligned memory without touching the heap once the arena's chunks
+    exist. A default-constructed ArenaAllocator has no arena and falls
+    back to 64-byte aligned heap allocation, which makes it usable as a
+    drop-in default. The arena (if any) must outlive all containers
+    using the allocator.
+
+    <b>\#include</b> \<vigra/memory.hxx\><br>
+    Namespace: vigra
+*/
+template <class T>
+class ArenaAllocator
+{
+  public:
+    typedef T value_type;
+    typedef T * pointer;
+    typedef T const * const_pointer;
+    typedef T & reference;
+    typedef T const & const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <class U>
+    struct rebind
+    {
+        typedef ArenaAllocator<U> other;
+    };
+
+        /** Construct without an arena (aligned heap fallback).
+        */
+    ArenaAllocator()
+    : arena_(0)
+    {}
+
+        /** Construct an allocator drawing from \a arena.
+        */
+    explicit ArenaAllocator(MemoryArena & arena)
+    : arena_(&arena)
+    {}
+
+        /** Construct from an arena pointer (may be NULL for the
+            aligned heap fallback).
+        */
+    explicit ArenaAllocator(MemoryArena * arena)
+    : arena_(arena)
+    {}
+
+    template <class U>
+    ArenaAllocator(ArenaAllocator<U> const & rhs)
+    : arena_(rhs.arena())
+    {}
+
+    pointer allocate(size_type n, void const * /* hint */ = 0)
+    {
+        if(arena_ != 0)
+            return static_cast<pointer>(arena_->allocate(n * sizeof(T)));
+        return static_cast<pointer>(detail::alignedAllocate(n * sizeof(T)));
+    }
+
+    void deallocate(pointer p, size_type n)
+    {
+        if(arena_ != 0)
+            arena_->deallocate(p, n * sizeof(T));
+        else
+            detail::alignedDeallocate(p);
+    }
+
+    void construct(pointer p, const_reference value)
+    {
+        new(p) T(value);
+    }
+
+    void destroy(pointer p)
+    {
+        p->~T();
+    }
+
+    pointer address(reference x) const
+    {
+        return &x;
+    }
+
+    const_pointer address(const_reference x) const
+    {
+        return &x;
+    }
+
+    size_type max_size() const throw()
+    {
+        return size_type(-1) / sizeof(T);
+    }
+
+    MemoryArena * arena() const
+    {
+        return arena_;
+    }
+
+  private:
+    MemoryArena * arena_;
+};
+
+template <class T, class U>
+inline bool
+operator==(ArenaAllocator<T> const & lhs, ArenaAllocator<U> const & rhs)
+{
+    return lhs.arena() == rhs.arena();
+}
+
+template <class T, class U>
+inline bool
+operator!=(ArenaAllocator<T> const & lhs, ArenaAllocator<U> const & rhs)
+{
+    return lhs.arena() != rhs.arena();
+}
+
+/********************************************************/
+/*                                                      */
+/*                      MemoryPool                      */
+/*                                                      */
+/********************************************************/
+
+/** \brief Recycling pool for equally-sized memory blocks.
+
+    A MemoryPool keeps deallocated blocks in per-size free lists and
+    hands them back verbatim when a block of the same size is requested
+    again. In contrast to \ref vigra::MemoryArena, blocks may remain
+    outstanding for arbitrary periods and in arbitrary order -- the pool
+    is therefore the right tool when the <em>same few buffer sizes</em>
+    recur over and over, as with the full-frame temporaries of a video
+    pipeline: after the first frame, creating and destroying the
+    temporaries performs no heap allocation at all. All blocks are
+    64-byte aligned.
+
+    The pool is used via \ref vigra::PoolAllocator, which plugs into
+    \ref vigra::BasicImage, \ref vigra::MultiArray,
+    \ref vigra::ArrayVector, or any other container with standard
+    allocator support:
+
+    \code
+    typedef BasicImage<float, PoolAllocator<float> > FrameImage;
+
+    MemoryPool pool;
+    PoolAllocator<float> alloc(pool);
+
+    for(int frame = 0; frame < nframes; ++frame)
+    {
+        // heap allocation in the first frame only
+        FrameImage tmp1(w, h, alloc), tmp2(w, h, alloc);
+        ...
+    }   // the frame buffers return to the pool, not to the heap
+    \endcode
+
+    Cached blocks are only returned to the heap by
+    releaseUnusedMemory() or the destructor. A MemoryPool is not
+    copyable and not thread-safe -- use one pool per thread. It must
+    outlive all containers drawing from it.
+
+    <b>\#include</b> \<vigra/memory.hxx\><br>
+    Namespace: vigra
+*/
+class MemoryPool
+{
+  public:
+    MemoryPool()
+    : outstanding_count_(0),
+      cached_bytes_(0)
+    {}
+
+        /** Destroy the pool and free all cached blocks.
+            All outstanding blocks must have been returned.
+        */
+    ~MemoryPool()
+    {
+        releaseUnusedMemory();
+    }
+
+        /** Get a 64-byte aligned block of \a bytes bytes, reusing a
+            cached block of exactly this size when one is available.
+        */
+    void * allocate(std::size_t bytes)
+    {
+        std::size_t n = blockSize(bytes);
+        FreeLists::iterator i = free_lists_.find(n);
+        void * p;
+        if(i != free_lists_.end() && i->second != 0)
+        {
+            p = i->second;
+            i->second = *static_cast<void **>(p);  // unlink from the free list
+            cached_bytes_ -= n;
+        }
+        else
+        {
+            p = detail::alignedAllocate(n);
+        }
+        ++outstanding_count_;
+        return p;
+    }
+
+        /** Return a block obtained from allocate() to the pool's cache.
+            \a bytes must equal the size originally requested.
+        */
+    void deallocate(void * p, std::size_t bytes)
+    {
+        vigra_precondition(outstanding_count_ > 0,
+            "MemoryPool::deallocate(): no outstanding allocations.");
+        std::size_t n = blockSize(bytes);
+        void ** head = &free_lists_[n];
+        *static_cast<void **>(p) = *head;          // link into the free list
+        *head = p;
+        cached_bytes_ += n;
+        --outstanding_count_;
+    }
+
+        /** Free all cached blocks. Outstanding blocks are unaffected.
+        */
+    void releaseUnusedMemory()
+    {
+        for(FreeLists::iterator i = free_lists_.begin(); i != free_lists_.end(); ++i)
+        {
+            for(void * p = i->second; p != 0;)
+            {
+                void * next = *static_cast<void **>(p);
+                detail::alignedDeallocate(p);
+                p = next;
+            }
+        }
+        free_lists_.clear();
+        cached_bytes_ = 0;
+    }
+
+        /** Number of blocks currently allocated from this pool.
+        */
+    std::size_t outstandingAllocations() const
+    {
+        return outstanding_count_;
+    }
+
+        /** Number of bytes currently held in the pool's free lists.
+        */
+    std::size_t cachedBytes() const
+    {
+        return cached_bytes_;
+    }
+
+  private:
+    typedef std::map<std::size_t, void *> FreeLists;  // size => free-list head
+
+    MemoryPool(MemoryPool const &);               // not implemented
+    MemoryPool & operator=(MemoryPool const &);   // not implemented
+
+    // cached blocks store the free-list link in their first bytes
+    static std::size_t blockSize(std::size_t bytes)
+    {
+        return std::max(bytes, sizeof(void *));
+    }
+
+    FreeLists free_lists_;
+    std::size_t outstanding_count_;
+    std::size_t cached_bytes_;
+};
+
+/********************************************************/
+/*                                                      */
+/*                     PoolAllocator                    */
+/*                                                      */
+/********************************************************/
+
+/** \brief Standard-conforming allocator that draws from a \ref vigra::MemoryPool.
+
+    A PoolAllocator holds a pointer to a MemoryPool and serves all
+    requests from it, so containers using this allocator recycle their
+    buffers instead of returning them to the heap. A
+    default-constructed PoolAllocator has no pool and falls back to
+    64-byte aligned heap allocation. The pool (if any) must outlive all
+    containers using the allocator.
+
+    <b>\#include</b> \<vigra/memory.hxx\><br>
+    Namespace: vigra
+*/
+template <class T>
+class PoolAllocator
+{
+  public:
+    typedef T value_type;
+    typedef T * pointer;
+    typedef T const * const_pointer;
+    typedef T & reference;
+    typedef T const & const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <class U>
+    struct rebind
+    {
+        typedef PoolAllocator<U> other;
+    };
+
+        /** Construct without a pool (aligned heap fallback).
+        */
+    PoolAllocator()
+    : pool_(0)
+    {}
+
+        /** Construct an allocator drawing from \a pool.
+        */
+    explicit PoolAllocator(MemoryPool & pool)
+    : pool_(&pool)
+    {}
+
+        /** Construct from a pool pointer (may be NULL for the
+            aligned heap fallback).
+        */
+    explicit PoolAllocator(MemoryPool * pool)
+    : pool_(pool)
+    {}
+
+    template <class U>
+    PoolAllocator(PoolAllocator<U> const & rhs)
+    : pool_(rhs.pool())
+    {}
+
+    pointer allocate(size_type n, void const * /* hint */ = 0)
+    {
+        if(pool_ != 0)
+            return static_cast<pointer>(pool_->allocate(n * sizeof(T)));
+        return static_cast<pointer>(detail::alignedAllocate(n * sizeof(T)));
+    }
+
+    void deallocate(pointer p, size_type n)
+    {
+        if(pool_ != 0)
+            pool_->deallocate(p, n * sizeof(T));
+        else
+            detail::alignedDeallocate(p);
+    }
+
+    void construct(pointer p, const_reference value)
+    {
+        new(p) T(value);
+    }
+
+    void destroy(pointer p)
+    {
+        p->~T();
+    }
+
+    pointer address(reference x) const
+    {
+        return &x;
+    }
+
+    const_pointer address(const_reference x) const
+    {
+        return &x;
+    }
+
+    size_type max_size() const throw()
+    {
+        return size_type(-1) / sizeof(T);
+    }
+
+    MemoryPool * pool() const
+    {
+        return pool_;
+    }
+
+  private:
+    MemoryPool * pool_;
+};
+
+template <class T, class U>
+inline bool
+operator==(PoolAllocator<T> const & lhs, PoolAllocator<U> const & rhs)
+{
+    return lhs.pool() == rhs.pool();
+}
+
+template <class T, class U>
+inline bool
+operator!=(PoolAllocator<T> const & lhs, PoolAllocator<U> const & rhs)
+{
+    return lhs.pool() != rhs.pool();
+}
+
 namespace detail {
 
 // differs from std::uninitialized_copy by explicit type conversion
@@ -86,6 +86,10 @@ struct MeshGridAccessor
     If \a upperLeft is not the point (0,0), the mesh grid is translated relative to
     the pixel indices.
 
+    For arbitrary-dimensional \ref MultiArrayView "MultiArrayViews", the lazy
+    coordinate grid \ref vigra::multi_math::meshGrid() "multi_math::meshGrid()"
+    can be used directly within array expressions.
+
     <b> Declarations:</b>
 
     \code
@@ -63,6 +63,20 @@ namespace vigra
 
 namespace detail
 {
+
+// defined in multi_pointoperators.hxx; declared here because the include
+// order depends on which of the two mutually including headers is seen
+// first, and MultiArrayView's init and copy implementations refer to them
+template <class Shape, class T1, class T2>
+void
+copyArrayDataReordered(Shape const & shape,
+                       T1 const * s, Shape const & sstride,
+                       T2 * d, Shape const & dstride);
+
+template <class Shape, class T>
+void
+fillArrayDataReordered(Shape const & shape, T * d, Shape const & dstride, T const & val);
+
 /********************************************************/
 /*                                                      */
 /*                    defaultStride                     */
@@ -372,7 +386,6 @@ VIGRA_COPY_MULTI_ARRAY_DATA(copyMul, *=)
 VIGRA_COPY_MULTI_ARRAY_DATA(copyDiv, /=)
 
 #undef VIGRA_COPY_MULTI_ARRAY_DATA
-
 template <class SrcIterator, class Shape, class T, class ALLOC>
 inline void
 uninitializedCopyMultiArrayData(SrcIterator s, Shape const & shape, T * & d, ALLOC & a, MetaInt<0>)
@@ -855,6 +868,20 @@ protected:
     template <class U, class CN>
     void copyImpl(const MultiArrayView <N, U, CN>& rhs);
 
+    template <class U>
+    void initImpl(const U & init, VigraTrueType /* isPOD */)
+    {
+        // convert once, then fill in cache-friendly axis order
+        T val = detail::RequiresExplicitCast<T>::cast(init);
+        detail::fillArrayDataReordered(m_shape, m_ptr, m_stride, val);
+    }
+
+    template <class U>
+    void initImpl(const U & init, VigraFalseType /* isPOD */)
+    {
+        detail::copyScalarMultiArrayData(traverser_begin(), shape(), init, MetaInt<actual_dimension-1>());
+    }
+
     template <class U, class CN>
     void swapDataImpl(MultiArrayView <N, U, CN> rhs);
 
@@ -1209,13 +1236,16 @@ public:
         return m_ptr [m_stride[0]*x + m_stride[1]*y + m_stride[2]*z + m_stride[3]*u + m_stride[4]*v];
     }
 
-        /** Init with a constant.
+        /** Init with a constant. For POD element types, the fill is
+            performed in cache-friendly axis order and degenerates into
+            memset() or contiguous vectorizable spans whenever the memory
+            layout permits.
          */
     template <class U>
     MultiArrayView & init(const U & init)
     {
         if(hasData())
-            detail::copyScalarMultiArrayData(traverser_begin(), shape(), init, MetaInt<actual_dimension-1>());
+            initImpl(init, typename TypeTraits<T>::isPOD());
         return *this;
     }
 
@@ -1966,15 +1996,15 @@ MultiArrayView <N, T, StrideTag>::copyImpl(const MultiArrayView <N, U, CN>& rhs)
 {
     if(!arraysOverlap(rhs))
     {
-        // no overlap -- can copy directly
-        detail::copyMultiArrayData(rhs.traverser_begin(), shape(), traverser_begin(), MetaInt<actual_dimension-1>());
+        // no overlap -- can copy directly, in cache-friendly axis order
+        detail::copyArrayDataReordered(m_shape, rhs.data(), rhs.stride(), m_ptr, m_stride);
     }
     else
     {
         // overlap: we got different views to the same data -- copy to intermediate memory in order to avoid
         // overwriting elements that are still needed on the rhs.
         MultiArray<N, T> tmp(rhs);
-        detail::copyMultiArrayData(tmp.traverser_begin(), shape(), traverser_begin(), MetaInt<actual_dimension-1>());
+        detail::copyArrayDataReordered(m_shape, tmp.data(), tmp.stride(), m_ptr, m_stride);
     }
 }
 
@@ -2539,6 +2569,21 @@ public:
         allocate (this->m_ptr, this->elementCount (), rhs.data ());
     }
 
+#ifdef VIGRA_HAS_RVALUE_REFERENCES
+        /** move constructor (C++ 11 only).<br>
+            Takes over the memory of \a rhs instead of copying the data.
+            \a rhs is left as an empty array.
+         */
+    MultiArray (MultiArray &&rhs)
+    : MultiArrayView <N, T> (rhs.m_shape, rhs.m_stride, rhs.m_ptr),
+      m_alloc (rhs.m_alloc)
+    {
+        rhs.m_shape  = difference_type (diff_zero_t(0));
+        rhs.m_stride = difference_type (diff_zero_t(0));
+        rhs.m_ptr    = 0;
+    }
+#endif
+
         /** constructor from an array expression
          */
     template<class Expression>
@@ -2569,6 +2614,25 @@ public:
         return *this;
     }
 
+#ifdef VIGRA_HAS_RVALUE_REFERENCES
+        /** move assignment (C++ 11 only).<br>
+            Takes over the memory of \a rhs instead of copying the data and
+            releases the old memory of the left-hand side array. \a rhs is
+            left as an empty array.
+         */
+    MultiArray & operator= (MultiArray &&rhs)
+    {
+        if (this != &rhs)
+        {
+            this->swap(rhs);
+            rhs.deallocate(rhs.m_ptr, rhs.elementCount());
+            rhs.m_shape  = difference_type (diff_zero_t(0));
+            rhs.m_stride = difference_type (diff_zero_t(0));
+        }
+        return *this;
+    }
+#endif
+
         /** assignment from arbitrary MultiArrayView.<br>
             If the size of \a rhs is the same as the left-hand side arrays's old size, only
             the data are copied. Otherwise, new storage is allocated, which invalidates all
@@ -2760,7 +2824,8 @@ public:
     }
 
         /** Allocate new memory with the given shape and initialize it
-            with the given value.<br>
+            with the given value. The old buffer is reused when the total
+            number of elements remains the same.<br>
             <em>Note:</em> this operation invalidates all dependent objects
             (array views and iterators)
          */
@@ -2773,6 +2838,43 @@ public:
          */
     void swap (MultiArray & other);
 
+        /** Give up ownership of the array's memory and return the pointer
+            to its first element. The array is left empty. The buffer holds
+            <tt>elementCount()</tt> (at the time of the call) constructed
+            elements which the caller must eventually destroy and deallocate
+            by means of an allocator equal to <tt>allocator()</tt>.
+         */
+    pointer release ()
+    {
+        pointer p = this->m_ptr;
+        this->m_ptr    = 0;
+        this->m_shape  = difference_type (diff_zero_t(0));
+        this->m_stride = difference_type (diff_zero_t(0));
+        return p;
+    }
+
+        /** Take ownership of the given buffer, interpreting it as an
+            unstrided array of the given shape. The old memory of the array is
+            released. The buffer must contain constructed elements for the
+            entire shape and must have been allocated by an allocator equal to
+            <tt>allocator()</tt>, e.g. by <tt>release()</tt> from a compatible
+            array.<br>
+            <em>Note:</em> this operation invalidates all dependent objects
+            (array views and iterators)
+         */
+    void adopt (pointer ptr, const difference_type &shape)
+    {
+        deallocate (this->m_ptr, this->elementCount ());
+        this->m_ptr    = ptr;
+        this->m_shape  = shape;
+        this->m_stride = detail::defaultStride <actual_dimension> (shape);
+        if (N == 0)
+        {
+            this->m_shape [0] = 1;
+            this->m_stride [0] = 0;
+        }
+    }
+
         /** sequential iterator pointing to the first array element.
          */
     iterator begin ()
@@ -2910,12 +3012,22 @@ void MultiArray <N, T, A>::reshape (const difference_type & new_shape,
     {
         difference_type new_stride = detail::defaultStride <MultiArrayView<N,T>::actual_dimension> (new_shape);
         difference_type_1 new_size = new_shape [MultiArrayView<N,T>::actual_dimension-1] * new_stride [MultiArrayView<N,T>::actual_dimension-1];
-        T *new_ptr;
-        allocate (new_ptr, new_size, initial);
-        deallocate (this->m_ptr, this->elementCount ());
-        this->m_ptr = new_ptr;
-        this->m_shape = new_shape;
-        this->m_stride = new_stride;
+        if (new_size == this->elementCount ())
+        {
+            // the total number of elements is unchanged => reuse the old buffer
+            this->m_shape = new_shape;
+            this->m_stride = new_stride;
+            this->init(initial);
+        }
+        else
+        {
+            T *new_ptr;
+            allocate (new_ptr, new_size, initial);
+            deallocate (this->m_ptr, this->elementCount ());
+            this->m_ptr = new_ptr;
+            this->m_shape = new_shape;
+            this->m_stride = new_stride;
+        }
     }
 }
 
@@ -49,6 +49,10 @@
 #include "functorexpression.hxx"
 #include "tinyvector.hxx"
 #include "algorithm.hxx"
+#include "parallel_options.hxx"
+#include "recursiveconvolution.hxx"
+#include "memory.hxx"
+#include "instrumentation.hxx"
 
 namespace vigra
 {
@@ -332,13 +336,15 @@ class ConvolutionOptions
     ParamVec outer_scale;
     double window_ratio;
     Shape from_point, to_point;
-     
+    MemoryArena * memory_arena;
+
     ConvolutionOptions()
     : sigma_eff(0.0),
       sigma_d(0.0),
       step_size(1.0),
       outer_scale(0.0),
-      window_ratio(0.0)
+      window_ratio(0.0),
+      memory_arena(0)
     {}
 
     typedef typename detail::WrapDoubleIteratorTriple<ParamIt, ParamIt, ParamIt>
@@ -482,6 +488,23 @@ class ConvolutionOptions
         to_point = to;
         return *this;
     }
+
+        /** Allocate internal temporary arrays from the given \ref vigra::MemoryArena.
+
+            The convolution functions allocate temporary arrays of the size of
+            the input. When the same filter sizes are applied repeatedly (e.g.
+            once per frame of a video), drawing these temporaries from an arena
+            avoids repeated heap allocation: after the first call, the arena's
+            chunks are simply reused. The arena must outlive the option object
+            and all convolution calls using it.
+
+            Default: no arena (temporaries are allocated on the heap)
+        */
+    ConvolutionOptions<dim> & memoryArena(MemoryArena & arena)
+    {
+        memory_arena = &arena;
+        return *this;
+    }
 };
 
 namespace detail
@@ -498,7 +521,8 @@ template <class SrcIterator, class SrcShape, class SrcAccessor,
 void
 internalSeparableConvolveMultiArrayTmp(
                       SrcIterator si, SrcShape const & shape, SrcAccessor src,
-                      DestIterator di, DestAccessor dest, KernelIterator kit)
+                      DestIterator di, DestAccessor dest, KernelIterator kit,
+                      MemoryArena * arena = 0)
 {
     enum { N = 1 + SrcIterator::level };
 
@@ -506,18 +530,21 @@ internalSeparableConvolveMultiArrayTmp(
     typedef typename AccessorTraits<TmpType>::default_accessor TmpAcessor;
 
     // temporary array to hold the current line to enable in-place operation
-    ArrayVector<TmpType> tmp( shape[0] );
+    ArrayVector<TmpType, ArenaAllocator<TmpType> > tmp( shape[0], ArenaAllocator<TmpType>(arena) );
+    VIGRA_INSTRUMENT_ALLOCATION((std::size_t)shape[0] * sizeof(TmpType))
 
     typedef MultiArrayNavigator<SrcIterator, N> SNavigator;
     typedef MultiArrayNavigator<DestIterator, N> DNavigator;
-    
+
     TmpAcessor acc;
 
     {
+        VIGRA_INSTRUMENT_PASS(2 * (std::size_t)prod(shape) * sizeof(TmpType))
+
         // only operate on first dimension here
         SNavigator snav( si, shape, 0 );
         DNavigator dnav( di, shape, 0 );
-        
+
         for( ; snav.hasMore(); snav++, dnav++ )
         {
              // first copy source to tmp for maximum cache efficiency
@@ -533,6 +560,8 @@ internalSeparableConvolveMultiArrayTmp(
     // operate on further dimensions
     for( int d = 1; d < N; ++d, ++kit )
     {
+        VIGRA_INSTRUMENT_PASS(2 * (std::size_t)prod(shape) * sizeof(TmpType))
+
         DNavigator dnav( di, shape, d );
 
         tmp.resize( shape[d] );
@@ -549,6 +578,156 @@ internalSeparableConvolveMultiArrayTmp(
     }
 }
 
+/********************************************************/
+/*                                                      */
+/*       internalRecursiveGaussianMultiArray            */
+/*                                                      */
+/********************************************************/
+
+// apply the recursive Young/van Vliet Gaussian approximation along every
+// axis (analogous to internalSeparableConvolveMultiArrayTmp)
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void
+internalRecursiveGaussianMultiArray(
+                      SrcIterator si, SrcShape const & shape, SrcAccessor src,
+                      DestIterator di, DestAccessor dest, double sigma)
+{
+    enum { N = 1 + SrcIterator::level };
+
+    typedef typename NumericTraits<typename DestAccessor::value_type>::RealPromote TmpType;
+    typedef typename AccessorTraits<TmpType>::default_accessor TmpAcessor;
+
+    // temporary array to hold the current line to enable in-place operation
+    ArrayVector<TmpType> tmp( shape[0] );
+
+    typedef MultiArrayNavigator<SrcIterator, N> SNavigator;
+    typedef MultiArrayNavigator<DestIterator, N> DNavigator;
+
+    TmpAcessor acc;
+
+    {
+        // only operate on first dimension here
+        SNavigator snav( si, shape, 0 );
+        DNavigator dnav( di, shape, 0 );
+
+        for( ; snav.hasMore(); snav++, dnav++ )
+        {
+             // first copy source to tmp for maximum cache efficiency
+             copyLine(snav.begin(), snav.end(), src, tmp.begin(), acc);
+
+             recursiveGaussianFilterLine(tmp.begin(), tmp.end(), acc,
+                                         dnav.begin(), dest, sigma);
+        }
+    }
+
+    // operate on further dimensions
+    for( int d = 1; d < N; ++d )
+    {
+        DNavigator dnav( di, shape, d );
+
+        tmp.resize( shape[d] );
+
+        for( ; dnav.hasMore(); dnav++ )
+        {
+             copyLine(dnav.begin(), dnav.end(), dest, tmp.begin(), acc);
+
+             recursiveGaussianFilterLine(tmp.begin(), tmp.end(), acc,
+                                         dnav.begin(), dest, sigma);
+        }
+    }
+}
+
+/********************************************************/
+/*                                                      */
+/*    internalSeparableConvolveMultiArrayParallel       */
+/*                                                      */
+/********************************************************/
+
+// Same algorithm as internalSeparableConvolveMultiArrayTmp(), but the
+// per-line work of every axis is distributed across threads. Lines are
+// assigned to threads in contiguous blocks (block-cyclically), each
+// thread using its own temporary line buffer. The navigators only
+// support forward iteration, so every thread sweeps over all lines and
+// skips those belonging to other threads -- the increment is negligible
+// compared to the convolution work per line.
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor, class KernelIterator>
+void
+internalSeparableConvolveMultiArrayParallel(
+                      SrcIterator si, SrcShape const & shape, SrcAccessor src,
+                      DestIterator di, DestAccessor dest, KernelIterator kit,
+                      ParallelOptions const & options)
+{
+    enum { N = 1 + SrcIterator::level };
+
+    typedef typename NumericTraits<typename DestAccessor::value_type>::RealPromote TmpType;
+    typedef typename AccessorTraits<TmpType>::default_accessor TmpAcessor;
+
+    typedef MultiArrayNavigator<SrcIterator, N> SNavigator;
+    typedef MultiArrayNavigator<DestIterator, N> DNavigator;
+
+    TmpAcessor acc;
+
+    for( int d = 0; d < N; ++d, ++kit )
+    {
+        int lineCount = 1;
+        for( int k = 0; k < N; ++k )
+            if( k != d )
+                lineCount *= (int)shape[k];
+
+        const int blockSize = options.getBlockSize(lineCount);
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(options.getNumThreads())
+#endif
+        {
+            int threads = 1, threadIndex = 0;
+#ifdef _OPENMP
+            threads = omp_get_num_threads();
+            threadIndex = omp_get_thread_num();
+#endif
+            ArrayVector<TmpType> tmp( shape[d] );
+
+            if( d == 0 )
+            {
+                // read from source, write to destination
+                SNavigator snav( si, shape, 0 );
+                DNavigator dnav( di, shape, 0 );
+
+                for( int i = 0; snav.hasMore(); ++i, snav++, dnav++ )
+                {
+                    if( (i / blockSize) % threads != threadIndex )
+                        continue;
+
+                    copyLine(snav.begin(), snav.end(), src, tmp.begin(), acc);
+
+                    convolveLine(srcIterRange(tmp.begin(), tmp.end(), acc),
+                                 destIter( dnav.begin(), dest ),
+                                 kernel1d( *kit ));
+                }
+            }
+            else
+            {
+                // work in-place on the destination
+                DNavigator dnav( di, shape, d );
+
+                for( int i = 0; dnav.hasMore(); ++i, dnav++ )
+                {
+                    if( (i / blockSize) % threads != threadIndex )
+                        continue;
+
+                    copyLine(dnav.begin(), dnav.end(), dest, tmp.begin(), acc);
+
+                    convolveLine(srcIterRange(tmp.begin(), tmp.end(), acc),
+                                 destIter( dnav.begin(), dest ),
+                                 kernel1d( *kit ));
+                }
+            }
+        } // implicit barrier before the next axis is started
+    }
+}
+
 /********************************************************/
 /*                                                      */
 /*         internalSeparableConvolveSubarray            */
@@ -561,12 +740,13 @@ void
 internalSeparableConvolveSubarray(
                       SrcIterator si, SrcShape const & shape, SrcAccessor src,
                       DestIterator di, DestAccessor dest, KernelIterator kit,
-                      SrcShape const & start, SrcShape const & stop)
+                      SrcShape const & start, SrcShape const & stop,
+                      MemoryArena * arena = 0)
 {
     enum { N = 1 + SrcIterator::level };
 
     typedef typename NumericTraits<typename DestAccessor::value_type>::RealPromote TmpType;
-    typedef MultiArray<N, TmpType> TmpArray;
+    typedef MultiArray<N, TmpType, ArenaAllocator<TmpType> > TmpArray;
     typedef typename TmpArray::traverser TmpIterator;
     typedef typename AccessorTraits<TmpType>::default_accessor TmpAcessor;
     
@@ -589,7 +769,7 @@ internalSeparableConvolveSubarray(
     dstop[axisorder[0]]  = stop[axisorder[0]] - start[axisorder[0]];
     
     // temporary array to hold the current line to enable in-place operation
-    MultiArray<N, TmpType> tmp(dstop);
+    TmpArray tmp(dstop, ArenaAllocator<TmpType>(arena));
 
     typedef MultiArrayNavigator<SrcIterator, N> SNavigator;
     typedef MultiArrayNavigator<TmpIterator, N> TNavigator;
@@ -602,7 +782,8 @@ internalSeparableConvolveSubarray(
         SNavigator snav( si, sstart, sstop, axisorder[0]);
         TNavigator tnav( tmp.traverser_begin(), dstart, dstop, axisorder[0]);
         
-        ArrayVector<TmpType> tmpline(sstop[axisorder[0]] - sstart[axisorder[0]]);
+        ArrayVector<TmpType, ArenaAllocator<TmpType> >
+            tmpline(sstop[axisorder[0]] - sstart[axisorder[0]], ArenaAllocator<TmpType>(arena));
         
         int lstart = start[axisorder[0]] - sstart[axisorder[0]];
         int lstop  = lstart + (stop[axisorder[0]] - start[axisorder[0]]);
@@ -623,7 +804,8 @@ internalSeparableConvolveSubarray(
     {
         TNavigator tnav( tmp.traverser_begin(), dstart, dstop, axisorder[d]);
         
-        ArrayVector<TmpType> tmpline(dstop[axisorder[d]] - dstart[axisorder[d]]);
+        ArrayVector<TmpType, ArenaAllocator<TmpType> >
+            tmpline(dstop[axisorder[d]] - dstart[axisorder[d]], ArenaAllocator<TmpType>(arena));
         
         int lstart = start[axisorder[d]] - sstart[axisorder[d]];
         int lstop  = lstart + (stop[axisorder[d]] - start[axisorder[d]]);
@@ -646,8 +828,96 @@ internalSeparableConvolveSubarray(
 }
 
 
+/********************************************************/
+/*                                                      */
+/*          internalConvolveOneDimensionTiled           */
+/*                                                      */
+/********************************************************/
+
+// Cache-blocked traversal for convolveMultiArrayOneDimension() along a
+// strided axis. Copying one strided line at a time touches a new cache
+// line per element, so a tile of adjacent lines (consecutive navigator
+// positions are neighbors along dimension 0) is gathered position-major
+// into an interleaved buffer: each step of the strided axis then reads
+// 'tileSize' contiguous elements instead of one. The lines are convolved
+// from the buffer (which is cache-resident) and the results are written
+// back to the destination in the same position-major order.
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor, class T>
+void
+internalConvolveOneDimensionTiled(SrcIterator s, SrcShape const & shape, SrcAccessor src,
+                                  DestIterator d, DestAccessor dest,
+                                  unsigned int dim, vigra::Kernel1D<T> const & kernel)
+{
+    enum { N = 1 + SrcIterator::level };
+    const int tileSize = 16;
+
+    typedef typename NumericTraits<typename DestAccessor::value_type>::RealPromote TmpType;
+    typedef typename AccessorTraits<TmpType>::default_const_accessor TmpConstAccessor;
+    typedef typename AccessorTraits<TmpType>::default_accessor TmpAccessor;
+
+    typedef MultiArrayNavigator<SrcIterator, N> SNavigator;
+    typedef MultiArrayNavigator<DestIterator, N> DNavigator;
+
+    const int lineLength = (int)shape[dim];
+
+    ArrayVector<TmpType> gather( tileSize * lineLength ),
+                         result( tileSize * lineLength ),
+                         tmpline( lineLength ),
+                         outline( lineLength );
+    ArrayVector<typename SNavigator::iterator> srcLine;
+    ArrayVector<typename DNavigator::iterator> destLine;
+    srcLine.reserve( tileSize );
+    destLine.reserve( tileSize );
+
+    SNavigator snav( s, shape, dim );
+    DNavigator dnav( d, shape, dim );
+
+    while( snav.hasMore() )
+    {
+        srcLine.clear();
+        destLine.clear();
+        for( ; (int)srcLine.size() < tileSize && snav.hasMore(); snav++, dnav++ )
+        {
+            srcLine.push_back( snav.begin() );
+            destLine.push_back( dnav.begin() );
+        }
+        const int lines = (int)srcLine.size();
+
+        // gather the tile, interleaved position-major
+        for( int i = 0; i < lineLength; ++i )
+        {
+            TmpType * buf = gather.begin() + i*lines;
+            for( int t = 0; t < lines; ++t )
+                buf[t] = src( srcLine[t], i );
+        }
+
+        // convolve each line out of the cache-resident buffer
+        for( int t = 0; t < lines; ++t )
+        {
+            for( int i = 0; i < lineLength; ++i )
+                tmpline[i] = gather[i*lines + t];
+
+            convolveLine(srcIterRange( tmpline.begin(), tmpline.end(), TmpConstAccessor() ),
+                         destIter( outline.begin(), TmpAccessor() ),
+                         kernel1d( kernel ));
+
+            for( int i = 0; i < lineLength; ++i )
+                result[i*lines + t] = outline[i];
+        }
+
+        // scatter the results position-major
+        for( int i = 0; i < lineLength; ++i )
+        {
+            TmpType const * buf = result.begin() + i*lines;
+            for( int t = 0; t < lines; ++t )
+                dest.set( buf[t], destLine[t], i );
+        }
+    }
+}
+
 template <class K>
-void 
+void
 scaleKernel(K & kernel, double a)
 {
     for(int i = kernel.left(); i <= kernel.right(); ++i)
@@ -694,10 +964,15 @@ scaleKernel(K & kernel, double a)
     != typeid(typename DestAccessor::value_type)</tt>.
     
     If <tt>start</tt> and <tt>stop</tt> have non-default values, they must represent
-    a valid subarray of the input array. The convolution is then restricted to that 
+    a valid subarray of the input array. The convolution is then restricted to that
     subarray, and it is assumed that the output array only refers to the
-    subarray (i.e. <tt>diter</tt> points to the element corresponding to 
-    <tt>start</tt>). 
+    subarray (i.e. <tt>diter</tt> points to the element corresponding to
+    <tt>start</tt>).
+
+    Overloads accepting a \ref vigra::ParallelOptions object instead of
+    <tt>start</tt>/<tt>stop</tt> distribute the per-line work of every
+    dimension across multiple threads (provided the library is compiled
+    with OpenMP support; otherwise they fall back to serial execution).
 
     <b> Declarations:</b>
 
@@ -790,10 +1065,13 @@ separableConvolveMultiArray( SrcIterator s, SrcShape const & shape, SrcAccessor
                              DestIterator d, DestAccessor dest, 
                              KernelIterator kernels,
                              SrcShape const & start = SrcShape(),
-                             SrcShape const & stop = SrcShape())
+                             SrcShape const & stop = SrcShape(),
+                             MemoryArena * arena = 0)
 {
     typedef typename NumericTraits<typename DestAccessor::value_type>::RealPromote TmpType;
 
+    VIGRA_INSTRUMENT_SCOPE("separableConvolveMultiArray")
+
     if(stop != SrcShape())
     {
         enum { N = 1 + SrcIterator::level };
@@ -801,20 +1079,24 @@ separableConvolveMultiArray( SrcIterator s, SrcShape const & shape, SrcAccessor
             vigra_precondition(0 <= start[k] && start[k] < stop[k] && stop[k] <= shape[k],
               "separableConvolveMultiArray(): invalid subarray shape.");
 
-        detail::internalSeparableConvolveSubarray(s, shape, src, d, dest, kernels, start, stop);
+        detail::internalSeparableConvolveSubarray(s, shape, src, d, dest, kernels, start, stop, arena);
     }
     else if(!IsSameType<TmpType, typename DestAccessor::value_type>::boolResult)
     {
         // need a temporary array to avoid rounding errors
-        MultiArray<SrcShape::static_size, TmpType> tmpArray(shape);
+        MultiArray<SrcShape::static_size, TmpType, ArenaAllocator<TmpType> >
+            tmpArray(shape, ArenaAllocator<TmpType>(arena));
+        VIGRA_INSTRUMENT_ALLOCATION((std::size_t)prod(shape) * sizeof(TmpType))
         detail::internalSeparableConvolveMultiArrayTmp( s, shape, src,
-             tmpArray.traverser_begin(), typename AccessorTraits<TmpType>::default_accessor(), kernels );
+             tmpArray.traverser_begin(), typename AccessorTraits<TmpType>::default_accessor(), kernels, arena );
         copyMultiArray(srcMultiArrayRange(tmpArray), destIter(d, dest));
+        VIGRA_INSTRUMENT_PASS((std::size_t)prod(shape) *
+                (sizeof(TmpType) + sizeof(typename DestAccessor::value_type)))
     }
     else
     {
         // work directly on the destination array
-        detail::internalSeparableConvolveMultiArrayTmp( s, shape, src, d, dest, kernels );
+        detail::internalSeparableConvolveMultiArrayTmp( s, shape, src, d, dest, kernels, arena );
     }
 }
 
@@ -826,10 +1108,11 @@ void separableConvolveMultiArray(
     pair<DestIterator, DestAccessor> const & dest, 
     KernelIterator kit,
     SrcShape const & start = SrcShape(),
-    SrcShape const & stop = SrcShape())
+    SrcShape const & stop = SrcShape(),
+    MemoryArena * arena = 0)
 {
     separableConvolveMultiArray( source.first, source.second, source.third,
-                                 dest.first, dest.second, kit, start, stop );
+                                 dest.first, dest.second, kit, start, stop, arena );
 }
 
 template <class SrcIterator, class SrcShape, class SrcAccessor,
@@ -839,11 +1122,12 @@ separableConvolveMultiArray( SrcIterator s, SrcShape const & shape, SrcAccessor
                              DestIterator d, DestAccessor dest,
                              Kernel1D<T> const & kernel,
                              SrcShape const & start = SrcShape(),
-                             SrcShape const & stop = SrcShape())
+                             SrcShape const & stop = SrcShape(),
+                             MemoryArena * arena = 0)
 {
     ArrayVector<Kernel1D<T> > kernels(shape.size(), kernel);
 
-    separableConvolveMultiArray( s, shape, src, d, dest, kernels.begin(), start, stop);
+    separableConvolveMultiArray( s, shape, src, d, dest, kernels.begin(), start, stop, arena);
 }
 
 template <class SrcIterator, class SrcShape, class SrcAccessor,
@@ -853,12 +1137,82 @@ separableConvolveMultiArray(triple<SrcIterator, SrcShape, SrcAccessor> const & s
                             pair<DestIterator, DestAccessor> const & dest,
                             Kernel1D<T> const & kernel,
                             SrcShape const & start = SrcShape(),
-                            SrcShape const & stop = SrcShape())
+                            SrcShape const & stop = SrcShape(),
+                            MemoryArena * arena = 0)
+{
+    ArrayVector<Kernel1D<T> > kernels(source.second.size(), kernel);
+
+    separableConvolveMultiArray( source.first, source.second, source.third,
+                                 dest.first, dest.second, kernels.begin(), start, stop, arena);
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor, class KernelIterator>
+void
+separableConvolveMultiArray( SrcIterator s, SrcShape const & shape, SrcAccessor src,
+                             DestIterator d, DestAccessor dest,
+                             KernelIterator kernels,
+                             ParallelOptions const & options)
+{
+    typedef typename NumericTraits<typename DestAccessor::value_type>::RealPromote TmpType;
+
+    VIGRA_INSTRUMENT_SCOPE("separableConvolveMultiArray")
+
+    if(!IsSameType<TmpType, typename DestAccessor::value_type>::boolResult)
+    {
+        // need a temporary array to avoid rounding errors
+        MultiArray<SrcShape::static_size, TmpType> tmpArray(shape);
+        detail::internalSeparableConvolveMultiArrayParallel( s, shape, src,
+             tmpArray.traverser_begin(), typename AccessorTraits<TmpType>::default_accessor(),
+             kernels, options );
+        copyMultiArray(srcMultiArrayRange(tmpArray), destIter(d, dest));
+    }
+    else
+    {
+        // work directly on the destination array
+        detail::internalSeparableConvolveMultiArrayParallel( s, shape, src, d, dest,
+                                                             kernels, options );
+    }
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor, class KernelIterator>
+inline void
+separableConvolveMultiArray(
+    triple<SrcIterator, SrcShape, SrcAccessor> const & source,
+    pair<DestIterator, DestAccessor> const & dest,
+    KernelIterator kit,
+    ParallelOptions const & options)
+{
+    separableConvolveMultiArray( source.first, source.second, source.third,
+                                 dest.first, dest.second, kit, options );
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor, class T>
+inline void
+separableConvolveMultiArray( SrcIterator s, SrcShape const & shape, SrcAccessor src,
+                             DestIterator d, DestAccessor dest,
+                             Kernel1D<T> const & kernel,
+                             ParallelOptions const & options)
+{
+    ArrayVector<Kernel1D<T> > kernels(shape.size(), kernel);
+
+    separableConvolveMultiArray( s, shape, src, d, dest, kernels.begin(), options);
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor, class T>
+inline void
+separableConvolveMultiArray(triple<SrcIterator, SrcShape, SrcAccessor> const & source,
+                            pair<DestIterator, DestAccessor> const & dest,
+                            Kernel1D<T> const & kernel,
+                            ParallelOptions const & options)
 {
     ArrayVector<Kernel1D<T> > kernels(source.second.size(), kernel);
 
     separableConvolveMultiArray( source.first, source.second, source.third,
-                                 dest.first, dest.second, kernels.begin(), start, stop);
+                                 dest.first, dest.second, kernels.begin(), options);
 }
 
 /********************************************************/
@@ -949,11 +1303,20 @@ convolveMultiArrayOneDimension(SrcIterator s, SrcShape const & shape, SrcAccesso
 
     typedef typename NumericTraits<typename DestAccessor::value_type>::RealPromote TmpType;
     typedef typename AccessorTraits<TmpType>::default_const_accessor TmpAccessor;
+
+    if(dim > 0 && stop == SrcShape())
+    {
+        // along a strided axis, gather tiles of adjacent lines to avoid
+        // reading/writing a full cache line per element
+        detail::internalConvolveOneDimensionTiled(s, shape, src, d, dest, dim, kernel);
+        return;
+    }
+
     ArrayVector<TmpType> tmp( shape[dim] );
 
     typedef MultiArrayNavigator<SrcIterator, N> SNavigator;
     typedef MultiArrayNavigator<DestIterator, N> DNavigator;
-    
+
     SrcShape sstart, sstop(shape), dstart, dstop(shape);
     
     if(stop != SrcShape())
@@ -1084,13 +1447,16 @@ gaussianSmoothMultiArray( SrcIterator s, SrcShape const & shape, SrcAccessor src
 
     static const int N = SrcShape::static_size;
 
+    VIGRA_INSTRUMENT_SCOPE("gaussianSmoothMultiArray")
+
     typename ConvolutionOptions<N>::ScaleIterator params = opt.scaleParams();
     ArrayVector<Kernel1D<double> > kernels(N);
 
     for (int dim = 0; dim < N; ++dim, ++params)
-        kernels[dim].initGaussian(params.sigma_scaled(function_name), 1.0, opt.window_ratio);
+        detail::initCachedGaussian(kernels[dim], params.sigma_scaled(function_name), opt.window_ratio);
 
-    separableConvolveMultiArray(s, shape, src, d, dest, kernels.begin(), opt.from_point, opt.to_point);
+    separableConvolveMultiArray(s, shape, src, d, dest, kernels.begin(), opt.from_point, opt.to_point,
+                                opt.memory_arena);
 }
 
 template <class SrcIterator, class SrcShape, class SrcAccessor,
@@ -1127,6 +1493,48 @@ gaussianSmoothMultiArray(triple<SrcIterator, SrcShape, SrcAccessor> const & sour
 }
 
 
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void
+gaussianSmoothMultiArray( SrcIterator s, SrcShape const & shape, SrcAccessor src,
+                   DestIterator d, DestAccessor dest, double sigma,
+                   GaussianFilterMode mode )
+{
+    if(mode == GAUSSIAN_FIR)
+    {
+        gaussianSmoothMultiArray(s, shape, src, d, dest, sigma);
+        return;
+    }
+
+    typedef typename NumericTraits<typename DestAccessor::value_type>::RealPromote TmpType;
+
+    if(!IsSameType<TmpType, typename DestAccessor::value_type>::boolResult)
+    {
+        // need a temporary array to avoid rounding errors
+        MultiArray<SrcShape::static_size, TmpType> tmpArray(shape);
+        detail::internalRecursiveGaussianMultiArray( s, shape, src,
+             tmpArray.traverser_begin(),
+             typename AccessorTraits<TmpType>::default_accessor(), sigma );
+        copyMultiArray(srcMultiArrayRange(tmpArray), destIter(d, dest));
+    }
+    else
+    {
+        // work directly on the destination array
+        detail::internalRecursiveGaussianMultiArray( s, shape, src, d, dest, sigma );
+    }
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void
+gaussianSmoothMultiArray(triple<SrcIterator, SrcShape, SrcAccessor> const & source,
+                  pair<DestIterator, DestAccessor> const & dest, double sigma,
+                  GaussianFilterMode mode)
+{
+    gaussianSmoothMultiArray( source.first, source.second, source.third,
+                              dest.first, dest.second, sigma, mode );
+}
+
 /********************************************************/
 /*                                                      */
 /*             gaussianGradientMultiArray               */
@@ -1231,6 +1639,8 @@ gaussianGradientMultiArray(SrcIterator si, SrcShape const & shape, SrcAccessor s
     static const int N = SrcShape::static_size;
     typedef typename ConvolutionOptions<N>::ScaleIterator ParamType;
 
+    VIGRA_INSTRUMENT_SCOPE("gaussianGradientMultiArray")
+
     for(int k=0; k<N; ++k)
         if(shape[k] <=0)
             return;
@@ -1245,7 +1655,7 @@ gaussianGradientMultiArray(SrcIterator si, SrcShape const & shape, SrcAccessor s
     for (int dim = 0; dim < N; ++dim, ++params)
     {
         double sigma = params.sigma_scaled(function_name);
-        plain_kernels[dim].initGaussian(sigma, 1.0, opt.window_ratio);
+        detail::initCachedGaussian(plain_kernels[dim], sigma, opt.window_ratio);
     }
 
     typedef VectorElementAccessor<DestAccessor> ElementAccessor;
@@ -1254,10 +1664,10 @@ gaussianGradientMultiArray(SrcIterator si, SrcShape const & shape, SrcAccessor s
     for (int dim = 0; dim < N; ++dim, ++params2)
     {
         ArrayVector<Kernel1D<KernelType> > kernels(plain_kernels);
-        kernels[dim].initGaussianDerivative(params2.sigma_scaled(), 1, 1.0, opt.window_ratio);
+        detail::initCachedGaussianDerivative(kernels[dim], params2.sigma_scaled(), 1, opt.window_ratio);
         detail::scaleKernel(kernels[dim], 1.0 / params2.step_size());
         separableConvolveMultiArray(si, shape, src, di, ElementAccessor(dim, dest), kernels.begin(), 
-                                    opt.from_point, opt.to_point);
+                                    opt.from_point, opt.to_point, opt.memory_arena);
     }
 }
 
@@ -1295,6 +1705,204 @@ gaussianGradientMultiArray(triple<SrcIterator, SrcShape, SrcAccessor> const & so
                                 dest.first, dest.second, sigma, opt );
 }
 
+/********************************************************/
+/*                                                      */
+/*           gaussianGradientMultiArrayFused            */
+/*                                                      */
+/********************************************************/
+
+/** \brief Calculate Gaussian gradient of a multi-dimensional array with shared smoothing passes.
+
+    This function computes the same result as \ref gaussianGradientMultiArray()
+    (up to floating-point round-off), but factorizes the computation differently:
+    instead of running one full separable convolution per gradient component
+    (which re-reads the source array N times), component <tt>dim</tt> is computed
+    as
+
+    \code
+    S_0 ... S_{dim-1} D_dim S_{dim+1} ... S_{N-1} src
+    \endcode
+
+    where <tt>S_k</tt> denotes Gaussian smoothing and <tt>D_k</tt> Gaussian
+    differentiation along dimension <tt>k</tt>. The suffix smoothings
+    <tt>S_{dim+1} ... S_{N-1}</tt> are computed only once and shared between all
+    components, so the source array is read only twice regardless of N, and the
+    number of 1D convolution passes drops from N*N to N*(N+3)/2 - 1 (8 instead
+    of 9 for N=3, 13 instead of 16 for N=4). This reduces memory traffic
+    considerably for large volumes.
+
+    If a region-of-interest is requested via \ref ConvolutionOptions::subarray(),
+    the function falls back to \ref gaussianGradientMultiArray(), because the
+    shared intermediate results would have to be computed on the full array
+    anyway.
+
+    <b> Declarations:</b>
+
+    pass arguments explicitly:
+    \code
+    namespace vigra {
+        template <class SrcIterator, class SrcShape, class SrcAccessor,
+                  class DestIterator, class DestAccessor>
+        void
+        gaussianGradientMultiArrayFused(SrcIterator siter, SrcShape const & shape, SrcAccessor src,
+                                        DestIterator diter, DestAccessor dest,
+                                        double sigma, const ConvolutionOptions<N> & opt);
+    }
+    \endcode
+
+    use argument objects in conjunction with \ref ArgumentObjectFactories :
+    \code
+    namespace vigra {
+        template <class SrcIterator, class SrcShape, class SrcAccessor,
+                  class DestIterator, class DestAccessor>
+        void
+        gaussianGradientMultiArrayFused(triple<SrcIterator, SrcShape, SrcAccessor> const & source,
+                                        pair<DestIterator, DestAccessor> const & dest,
+                                        double sigma, const ConvolutionOptions<N> & opt);
+    }
+    \endcode
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/multi_convolution.hxx\>
+
+    \code
+    MultiArray<3, unsigned char>::size_type shape(width, height, depth);
+    MultiArray<3, unsigned char> source(shape);
+    MultiArray<3, TinyVector<float, 3> > dest(shape);
+    ...
+    // compute Gaussian gradient at scale sigma
+    gaussianGradientMultiArrayFused(srcMultiArrayRange(source), destMultiArray(dest), sigma);
+    \endcode
+
+    \see gaussianGradientMultiArray(), convolveMultiArrayOneDimension()
+*/
+doxygen_overloaded_function(template <...> void gaussianGradientMultiArrayFused)
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void
+gaussianGradientMultiArrayFused(SrcIterator si, SrcShape const & shape, SrcAccessor src,
+                                DestIterator di, DestAccessor dest,
+                                ConvolutionOptions<SrcShape::static_size> const & opt,
+                                const char *const function_name = "gaussianGradientMultiArrayFused")
+{
+    typedef typename DestAccessor::value_type DestType;
+    typedef typename DestType::value_type     DestValueType;
+    typedef typename NumericTraits<DestValueType>::RealPromote KernelType;
+
+    static const int N = SrcShape::static_size;
+    typedef typename ConvolutionOptions<N>::ScaleIterator ParamType;
+
+    for(int k=0; k<N; ++k)
+        if(shape[k] <=0)
+            return;
+
+    vigra_precondition(N == (int)dest.size(di),
+        "gaussianGradientMultiArrayFused(): Wrong number of channels in output array.");
+
+    if(opt.to_point != SrcShape())
+    {
+        // the shared intermediates cover the full array, so there is nothing
+        // to be gained for ROI processing -- use the unfused implementation
+        gaussianGradientMultiArray(si, shape, src, di, dest, opt, function_name);
+        return;
+    }
+
+    ParamType params = opt.scaleParams();
+    ParamType params2(params);
+
+    ArrayVector<Kernel1D<KernelType> > smooth_kernels(N), deriv_kernels(N);
+    for (int dim = 0; dim < N; ++dim, ++params)
+        detail::initCachedGaussian(smooth_kernels[dim], params.sigma_scaled(function_name), opt.window_ratio);
+    for (int dim = 0; dim < N; ++dim, ++params2)
+    {
+        detail::initCachedGaussianDerivative(deriv_kernels[dim], params2.sigma_scaled(), 1, opt.window_ratio);
+        detail::scaleKernel(deriv_kernels[dim], 1.0 / params2.step_size());
+    }
+
+    typedef VectorElementAccessor<DestAccessor> ElementAccessor;
+
+    if(N == 1)
+    {
+        convolveMultiArrayOneDimension(si, shape, src, di, ElementAccessor(0, dest),
+                                       0, deriv_kernels[0]);
+        return;
+    }
+
+    typedef typename AccessorTraits<KernelType>::default_accessor TmpAccessor;
+    TmpAccessor ta;
+
+    // 'smoothed' accumulates the shared suffix smoothings S_{dim+1} ... S_{N-1} src,
+    // 'work' holds the prefix passes of the component currently being computed
+    // (convolveMultiArrayOneDimension() buffers each line, so it may run in-place)
+    ArenaAllocator<KernelType> alloc(opt.memory_arena);
+    MultiArray<N, KernelType, ArenaAllocator<KernelType> > smoothed(shape, alloc), work(shape, alloc);
+
+    convolveMultiArrayOneDimension(si, shape, src, work.traverser_begin(), ta,
+                                   N-1, deriv_kernels[N-1]);
+    convolveMultiArrayOneDimension(si, shape, src, smoothed.traverser_begin(), ta,
+                                   N-1, smooth_kernels[N-1]);
+    for (int j = 0; j < N-2; ++j)
+        convolveMultiArrayOneDimension(work.traverser_begin(), shape, ta,
+                                       work.traverser_begin(), ta, j, smooth_kernels[j]);
+    convolveMultiArrayOneDimension(work.traverser_begin(), shape, ta,
+                                   di, ElementAccessor(N-1, dest),
+                                   N-2, smooth_kernels[N-2]);
+
+    for (int dim = N-2; dim >= 1; --dim)
+    {
+        convolveMultiArrayOneDimension(smoothed.traverser_begin(), shape, ta,
+                                       work.traverser_begin(), ta, dim, deriv_kernels[dim]);
+        for (int j = 0; j < dim-1; ++j)
+            convolveMultiArrayOneDimension(work.traverser_begin(), shape, ta,
+                                           work.traverser_begin(), ta, j, smooth_kernels[j]);
+        convolveMultiArrayOneDimension(work.traverser_begin(), shape, ta,
+                                       di, ElementAccessor(dim, dest),
+                                       dim-1, smooth_kernels[dim-1]);
+        convolveMultiArrayOneDimension(smoothed.traverser_begin(), shape, ta,
+                                       smoothed.traverser_begin(), ta, dim, smooth_kernels[dim]);
+    }
+
+    convolveMultiArrayOneDimension(smoothed.traverser_begin(), shape, ta,
+                                   di, ElementAccessor(0, dest),
+                                   0, deriv_kernels[0]);
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void
+gaussianGradientMultiArrayFused(SrcIterator si, SrcShape const & shape, SrcAccessor src,
+                                DestIterator di, DestAccessor dest, double sigma,
+                                const ConvolutionOptions<SrcShape::static_size> & opt = ConvolutionOptions<SrcShape::static_size>())
+{
+    ConvolutionOptions<SrcShape::static_size> par = opt;
+    gaussianGradientMultiArrayFused(si, shape, src, di, dest, par.stdDev(sigma));
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void
+gaussianGradientMultiArrayFused(triple<SrcIterator, SrcShape, SrcAccessor> const & source,
+                                pair<DestIterator, DestAccessor> const & dest,
+                                ConvolutionOptions<SrcShape::static_size> const & opt )
+{
+    gaussianGradientMultiArrayFused( source.first, source.second, source.third,
+                                     dest.first, dest.second, opt );
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void
+gaussianGradientMultiArrayFused(triple<SrcIterator, SrcShape, SrcAccessor> const & source,
+                                pair<DestIterator, DestAccessor> const & dest,
+                                double sigma,
+                                const ConvolutionOptions<SrcShape::static_size> & opt = ConvolutionOptions<SrcShape::static_size>())
+{
+    gaussianGradientMultiArrayFused( source.first, source.second, source.third,
+                                     dest.first, dest.second, sigma, opt );
+}
+
 /********************************************************/
 /*                                                      */
 /*             symmetricGradientMultiArray              */
@@ -1540,32 +2148,35 @@ laplacianOfGaussianMultiArray(SrcIterator si, SrcShape const & shape, SrcAccesso
     for (int dim = 0; dim < N; ++dim, ++params)
     {
         double sigma = params.sigma_scaled("laplacianOfGaussianMultiArray");
-        plain_kernels[dim].initGaussian(sigma, 1.0, opt.window_ratio);
+        detail::initCachedGaussian(plain_kernels[dim], sigma, opt.window_ratio);
     }
     
     SrcShape dshape(shape);
     if(opt.to_point != SrcShape())
         dshape = opt.to_point - opt.from_point;
     
-    MultiArray<N, KernelType> derivative(dshape);
+    MultiArray<N, KernelType, ArenaAllocator<KernelType> >
+        derivative(dshape, ArenaAllocator<KernelType>(opt.memory_arena));
 
     // compute 2nd derivatives and sum them up
     for (int dim = 0; dim < N; ++dim, ++params2)
     {
         ArrayVector<Kernel1D<KernelType> > kernels(plain_kernels);
-        kernels[dim].initGaussianDerivative(params2.sigma_scaled(), 2, 1.0, opt.window_ratio);
+        detail::initCachedGaussianDerivative(kernels[dim], params2.sigma_scaled(), 2, opt.window_ratio);
         detail::scaleKernel(kernels[dim], 1.0 / sq(params2.step_size()));
 
         if (dim == 0)
         {
             separableConvolveMultiArray( si, shape, src, 
-                                         di, dest, kernels.begin(), opt.from_point, opt.to_point);
+                                         di, dest, kernels.begin(), opt.from_point, opt.to_point,
+                                         opt.memory_arena);
         }
         else
         {
             separableConvolveMultiArray( si, shape, src, 
                                          derivative.traverser_begin(), DerivativeAccessor(), 
-                                         kernels.begin(), opt.from_point, opt.to_point);
+                                         kernels.begin(), opt.from_point, opt.to_point,
+                                         opt.memory_arena);
             combineTwoMultiArrays(di, dshape, dest, derivative.traverser_begin(), DerivativeAccessor(), 
                                   di, dest, Arg1() + Arg2() );
         }
@@ -1721,7 +2332,7 @@ hessianOfGaussianMultiArray(SrcIterator si, SrcShape const & shape, SrcAccessor
     for (int dim = 0; dim < N; ++dim, ++params)
     {
         double sigma = params.sigma_scaled("hessianOfGaussianMultiArray");
-        plain_kernels[dim].initGaussian(sigma, 1.0, opt.window_ratio);
+        detail::initCachedGaussian(plain_kernels[dim], sigma, opt.window_ratio);
     }
 
     typedef VectorElementAccessor<DestAccessor> ElementAccessor;
@@ -1736,17 +2347,18 @@ hessianOfGaussianMultiArray(SrcIterator si, SrcShape const & shape, SrcAccessor
             ArrayVector<Kernel1D<KernelType> > kernels(plain_kernels);
             if(i == j)
             {
-                kernels[i].initGaussianDerivative(params_i.sigma_scaled(), 2, 1.0, opt.window_ratio);
+                detail::initCachedGaussianDerivative(kernels[i], params_i.sigma_scaled(), 2, opt.window_ratio);
             }
             else
             {
-                kernels[i].initGaussianDerivative(params_i.sigma_scaled(), 1, 1.0, opt.window_ratio);
-                kernels[j].initGaussianDerivative(params_j.sigma_scaled(), 1, 1.0, opt.window_ratio);
+                detail::initCachedGaussianDerivative(kernels[i], params_i.sigma_scaled(), 1, opt.window_ratio);
+                detail::initCachedGaussianDerivative(kernels[j], params_j.sigma_scaled(), 1, opt.window_ratio);
             }
             detail::scaleKernel(kernels[i], 1 / params_i.step_size());
             detail::scaleKernel(kernels[j], 1 / params_j.step_size());
             separableConvolveMultiArray(si, shape, src, di, ElementAccessor(b, dest),
-                                        kernels.begin(), opt.from_point, opt.to_point);
+                                        kernels.begin(), opt.from_point, opt.to_point,
+                                        opt.memory_arena);
         }
     }
 }
@@ -1785,6 +2397,289 @@ hessianOfGaussianMultiArray(triple<SrcIterator, SrcShape, SrcAccessor> const & s
                                  dest.first, dest.second, sigma, opt );
 }
 
+/********************************************************/
+/*                                                      */
+/*          gaussianScaleSpacePassMultiArray            */
+/*                                                      */
+/********************************************************/
+
+namespace detail {
+
+// channel of Hessian element (i,j), i <= j, in the upper triangular part
+inline int hessianElementChannel(int i, int j, int n)
+{
+    return i*n - i*(i-1)/2 + j - i;
+}
+
+} // namespace detail
+
+/** \brief Compute smoothing, gradient, Laplacian, and Hessian in one shared pass.
+
+    Feature stacks often need the smoothed array, the Gaussian gradient, the
+    Laplacian of Gaussian, and the Hessian of Gaussian at the same scale.
+    Calling \ref gaussianSmoothMultiArray(), \ref gaussianGradientMultiArray(),
+    \ref laplacianOfGaussianMultiArray() and \ref hessianOfGaussianMultiArray()
+    separately repeats the full set of smoothing convolutions for every output.
+    This function computes all four outputs from shared suffix-smoothed
+    intermediate arrays (the factorization generalizes the one of
+    \ref gaussianGradientMultiArrayFused()), and obtains the Laplacian as the
+    pointwise trace of the Hessian -- roughly halving the number of 1D
+    convolution passes and the memory traffic (20 passes instead of 39 for 3D).
+
+    The destination arrays must have a scalar value type for <tt>smoothed</tt>
+    and <tt>laplacian</tt>, N channels for <tt>gradient</tt>, and N*(N+1)/2
+    channels for <tt>hessian</tt> (upper triangular part, as in
+    \ref hessianOfGaussianMultiArray()). All outputs agree with the individual
+    functions up to floating-point round-off. If a region-of-interest is
+    requested via \ref ConvolutionOptions::subarray(), the function falls back
+    to the individual implementations.
+
+    <b> Declarations:</b>
+
+    pass arguments explicitly:
+    \code
+    namespace vigra {
+        template <class SrcIterator, class SrcShape, class SrcAccessor,
+                  class SmoothedIterator, class SmoothedAccessor,
+                  class GradientIterator, class GradientAccessor,
+                  class LaplacianIterator, class LaplacianAccessor,
+                  class HessianIterator, class HessianAccessor>
+        void
+        gaussianScaleSpacePassMultiArray(SrcIterator siter, SrcShape const & shape, SrcAccessor src,
+                                         SmoothedIterator smiter, SmoothedAccessor smoothed,
+                                         GradientIterator griter, GradientAccessor gradient,
+                                         LaplacianIterator laiter, LaplacianAccessor laplacian,
+                                         HessianIterator heiter, HessianAccessor hessian,
+                                         double sigma, const ConvolutionOptions<N> & opt);
+    }
+    \endcode
+
+    use argument objects in conjunction with \ref ArgumentObjectFactories :
+    \code
+    namespace vigra {
+        template <class SrcIterator, class SrcShape, class SrcAccessor,
+                  class SmoothedIterator, class SmoothedAccessor,
+                  class GradientIterator, class GradientAccessor,
+                  class LaplacianIterator, class LaplacianAccessor,
+                  class HessianIterator, class HessianAccessor>
+        void
+        gaussianScaleSpacePassMultiArray(triple<SrcIterator, SrcShape, SrcAccessor> const & source,
+                                         pair<SmoothedIterator, SmoothedAccessor> const & smoothed,
+                                         pair<GradientIterator, GradientAccessor> const & gradient,
+                                         pair<LaplacianIterator, LaplacianAccessor> const & laplacian,
+                                         pair<HessianIterator, HessianAccessor> const & hessian,
+                                         double sigma, const ConvolutionOptions<N> & opt);
+    }
+    \endcode
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/multi_convolution.hxx\>
+
+    \code
+    MultiArray<3, float> source(shape), smoothed(shape), laplacian(shape);
+    MultiArray<3, TinyVector<float, 3> > gradient(shape);
+    MultiArray<3, TinyVector<float, 6> > hessian(shape);
+    ...
+    // compute all four features at scale sigma in one pass
+    gaussianScaleSpacePassMultiArray(srcMultiArrayRange(source),
+                                     destMultiArray(smoothed), destMultiArray(gradient),
+                                     destMultiArray(laplacian), destMultiArray(hessian),
+                                     sigma);
+    \endcode
+
+    \see gaussianSmoothMultiArray(), gaussianGradientMultiArray(),
+         laplacianOfGaussianMultiArray(), hessianOfGaussianMultiArray()
+*/
+doxygen_overloaded_function(template <...> void gaussianScaleSpacePassMultiArray)
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class SmoothedIterator, class SmoothedAccessor,
+          class GradientIterator, class GradientAccessor,
+          class LaplacianIterator, class LaplacianAccessor,
+          class HessianIterator, class HessianAccessor>
+void
+gaussianScaleSpacePassMultiArray(SrcIterator si, SrcShape const & shape, SrcAccessor src,
+                                 SmoothedIterator smi, SmoothedAccessor smoothed,
+                                 GradientIterator gri, GradientAccessor gradient,
+                                 LaplacianIterator lai, LaplacianAccessor laplacian,
+                                 HessianIterator hei, HessianAccessor hessian,
+                                 ConvolutionOptions<SrcShape::static_size> const & opt)
+{
+    using namespace functor;
+
+    typedef typename GradientAccessor::value_type GradientType;
+    typedef typename GradientType::value_type     GradientValueType;
+    typedef typename NumericTraits<GradientValueType>::RealPromote KernelType;
+
+    static const int N = SrcShape::static_size;
+    static const int M = N*(N+1)/2;
+    typedef typename ConvolutionOptions<N>::ScaleIterator ParamType;
+
+    for(int k=0; k<N; ++k)
+        if(shape[k] <=0)
+            return;
+
+    vigra_precondition(N == (int)gradient.size(gri),
+        "gaussianScaleSpacePassMultiArray(): Wrong number of channels in gradient array.");
+    vigra_precondition(M == (int)hessian.size(hei),
+        "gaussianScaleSpacePassMultiArray(): Wrong number of channels in hessian array.");
+
+    if(opt.to_point != SrcShape())
+    {
+        // ROI processing needs the margins of the individual implementations
+        gaussianSmoothMultiArray(si, shape, src, smi, smoothed, opt);
+        gaussianGradientMultiArray(si, shape, src, gri, gradient, opt);
+        laplacianOfGaussianMultiArray(si, shape, src, lai, laplacian, opt);
+        hessianOfGaussianMultiArray(si, shape, src, hei, hessian, opt);
+        return;
+    }
+
+    ParamType params = opt.scaleParams();
+    ParamType params2(params);
+
+    ArrayVector<Kernel1D<KernelType> > smooth_kernels(N), d1_kernels(N), d2_kernels(N);
+    for (int dim = 0; dim < N; ++dim, ++params)
+        detail::initCachedGaussian(smooth_kernels[dim],
+                                   params.sigma_scaled("gaussianScaleSpacePassMultiArray"),
+                                   opt.window_ratio);
+    for (int dim = 0; dim < N; ++dim, ++params2)
+    {
+        double sigma = params2.sigma_scaled();
+        detail::initCachedGaussianDerivative(d1_kernels[dim], sigma, 1, opt.window_ratio);
+        detail::scaleKernel(d1_kernels[dim], 1.0 / params2.step_size());
+        detail::initCachedGaussianDerivative(d2_kernels[dim], sigma, 2, opt.window_ratio);
+        detail::scaleKernel(d2_kernels[dim], 1.0 / sq(params2.step_size()));
+    }
+
+    typedef VectorElementAccessor<GradientAccessor> GradientElement;
+    typedef VectorElementAccessor<HessianAccessor>  HessianElement;
+    typedef typename AccessorTraits<KernelType>::default_accessor TmpAccessor;
+    TmpAccessor ta;
+
+    // 'sxs' accumulates the shared suffix smoothings S_{j+1} ... S_{N-1} src;
+    // all outputs whose highest derivative axis is j are derived from it
+    // (convolveMultiArrayOneDimension() buffers each line, so it may run in-place)
+    ArenaAllocator<KernelType> alloc(opt.memory_arena);
+    MultiArray<N, KernelType, ArenaAllocator<KernelType> > sxs(shape, alloc), deriv(shape, alloc), work(shape, alloc);
+    copyMultiArray(si, shape, src, sxs.traverser_begin(), ta);
+
+    for (int j = N-1; j >= 1; --j)
+    {
+        // diagonal Hessian element (j,j)
+        convolveMultiArrayOneDimension(sxs.traverser_begin(), shape, ta,
+                                       work.traverser_begin(), ta, j, d2_kernels[j]);
+        for (int m = 0; m < j-1; ++m)
+            convolveMultiArrayOneDimension(work.traverser_begin(), shape, ta,
+                                           work.traverser_begin(), ta, m, smooth_kernels[m]);
+        convolveMultiArrayOneDimension(work.traverser_begin(), shape, ta,
+                                       hei, HessianElement(detail::hessianElementChannel(j, j, N), hessian),
+                                       j-1, smooth_kernels[j-1]);
+
+        // first derivative along j; the mixed elements (k,j) and the gradient
+        // component j share its prefix smoothings
+        convolveMultiArrayOneDimension(sxs.traverser_begin(), shape, ta,
+                                       deriv.traverser_begin(), ta, j, d1_kernels[j]);
+        for (int k = j-1; k >= 1; --k)
+        {
+            convolveMultiArrayOneDimension(deriv.traverser_begin(), shape, ta,
+                                           work.traverser_begin(), ta, k, d1_kernels[k]);
+            for (int m = 0; m < k-1; ++m)
+                convolveMultiArrayOneDimension(work.traverser_begin(), shape, ta,
+                                               work.traverser_begin(), ta, m, smooth_kernels[m]);
+            convolveMultiArrayOneDimension(work.traverser_begin(), shape, ta,
+                                           hei, HessianElement(detail::hessianElementChannel(k, j, N), hessian),
+                                           k-1, smooth_kernels[k-1]);
+            convolveMultiArrayOneDimension(deriv.traverser_begin(), shape, ta,
+                                           deriv.traverser_begin(), ta, k, smooth_kernels[k]);
+        }
+        convolveMultiArrayOneDimension(deriv.traverser_begin(), shape, ta,
+                                       hei, HessianElement(detail::hessianElementChannel(0, j, N), hessian),
+                                       0, d1_kernels[0]);
+        convolveMultiArrayOneDimension(deriv.traverser_begin(), shape, ta,
+                                       gri, GradientElement(j, gradient),
+                                       0, smooth_kernels[0]);
+
+        convolveMultiArrayOneDimension(sxs.traverser_begin(), shape, ta,
+                                       sxs.traverser_begin(), ta, j, smooth_kernels[j]);
+    }
+
+    // 'sxs' now holds S_1 ... S_{N-1} src
+    convolveMultiArrayOneDimension(sxs.traverser_begin(), shape, ta,
+                                   hei, HessianElement(0, hessian), 0, d2_kernels[0]);
+    convolveMultiArrayOneDimension(sxs.traverser_begin(), shape, ta,
+                                   gri, GradientElement(0, gradient), 0, d1_kernels[0]);
+    convolveMultiArrayOneDimension(sxs.traverser_begin(), shape, ta,
+                                   smi, smoothed, 0, smooth_kernels[0]);
+
+    // the Laplacian is the trace of the Hessian
+    copyMultiArray(hei, shape, HessianElement(0, hessian), lai, laplacian);
+    for (int i = 1; i < N; ++i)
+        combineTwoMultiArrays(lai, shape, laplacian,
+                              hei, HessianElement(detail::hessianElementChannel(i, i, N), hessian),
+                              lai, laplacian, Arg1() + Arg2());
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class SmoothedIterator, class SmoothedAccessor,
+          class GradientIterator, class GradientAccessor,
+          class LaplacianIterator, class LaplacianAccessor,
+          class HessianIterator, class HessianAccessor>
+inline void
+gaussianScaleSpacePassMultiArray(SrcIterator si, SrcShape const & shape, SrcAccessor src,
+                                 SmoothedIterator smi, SmoothedAccessor smoothed,
+                                 GradientIterator gri, GradientAccessor gradient,
+                                 LaplacianIterator lai, LaplacianAccessor laplacian,
+                                 HessianIterator hei, HessianAccessor hessian,
+                                 double sigma,
+                                 const ConvolutionOptions<SrcShape::static_size> & opt = ConvolutionOptions<SrcShape::static_size>())
+{
+    ConvolutionOptions<SrcShape::static_size> par = opt;
+    gaussianScaleSpacePassMultiArray(si, shape, src, smi, smoothed, gri, gradient,
+                                     lai, laplacian, hei, hessian, par.stdDev(sigma));
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class SmoothedIterator, class SmoothedAccessor,
+          class GradientIterator, class GradientAccessor,
+          class LaplacianIterator, class LaplacianAccessor,
+          class HessianIterator, class HessianAccessor>
+inline void
+gaussianScaleSpacePassMultiArray(triple<SrcIterator, SrcShape, SrcAccessor> const & source,
+                                 pair<SmoothedIterator, SmoothedAccessor> const & smoothed,
+                                 pair<GradientIterator, GradientAccessor> const & gradient,
+                                 pair<LaplacianIterator, LaplacianAccessor> const & laplacian,
+                                 pair<HessianIterator, HessianAccessor> const & hessian,
+                                 ConvolutionOptions<SrcShape::static_size> const & opt )
+{
+    gaussianScaleSpacePassMultiArray( source.first, source.second, source.third,
+                                      smoothed.first, smoothed.second,
+                                      gradient.first, gradient.second,
+                                      laplacian.first, laplacian.second,
+                                      hessian.first, hessian.second, opt );
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class SmoothedIterator, class SmoothedAccessor,
+          class GradientIterator, class GradientAccessor,
+          class LaplacianIterator, class LaplacianAccessor,
+          class HessianIterator, class HessianAccessor>
+inline void
+gaussianScaleSpacePassMultiArray(triple<SrcIterator, SrcShape, SrcAccessor> const & source,
+                                 pair<SmoothedIterator, SmoothedAccessor> const & smoothed,
+                                 pair<GradientIterator, GradientAccessor> const & gradient,
+                                 pair<LaplacianIterator, LaplacianAccessor> const & laplacian,
+                                 pair<HessianIterator, HessianAccessor> const & hessian,
+                                 double sigma,
+                                 const ConvolutionOptions<SrcShape::static_size> & opt = ConvolutionOptions<SrcShape::static_size>())
+{
+    gaussianScaleSpacePassMultiArray( source.first, source.second, source.third,
+                                      smoothed.first, smoothed.second,
+                                      gradient.first, gradient.second,
+                                      laplacian.first, laplacian.second,
+                                      hessian.first, hessian.second, sigma, opt );
+}
+
 namespace detail {
 
 template<int N, class VectorType>
@@ -1936,7 +2831,7 @@ structureTensorMultiArray(SrcIterator si, SrcShape const & shape, SrcAccessor sr
         for(int k=0; k<N; ++k, ++params)
         {
             Kernel1D<double> gauss;
-            gauss.initGaussian(params.sigma_scaled("structureTensorMultiArray"), 1.0, opt.window_ratio);
+            detail::initCachedGaussian(gauss, params.sigma_scaled("structureTensorMultiArray"), opt.window_ratio);
             int dilation = gauss.right();
             innerOptions.from_point[k] = std::max<MultiArrayIndex>(0, opt.from_point[k] - dilation);
             innerOptions.to_point[k] = std::min<MultiArrayIndex>(shape[k], opt.to_point[k] + dilation);
@@ -2000,6 +2895,185 @@ structureTensorMultiArray(triple<SrcIterator, SrcShape, SrcAccessor> const & sou
                                innerScale, outerScale, opt);
 }
 
+/********************************************************/
+/*                                                      */
+/*               separableConvolveTiled                 */
+/*                                                      */
+/********************************************************/
+
+namespace detail {
+
+// Convolve the tile with linear index 'tileIndex'. The tile is read with
+// a halo determined by the kernel radii (clamped at the array borders),
+// convolved as a whole, and only the core region is written back, so the
+// garbage the border treatment produces at interior tile edges never
+// reaches the output. The reader/writer calls are serialized because tile
+// providers typically perform I/O and need not be thread-safe.
+template <unsigned int N, class T, class TileReader, class TileWriter,
+          class KernelIterator>
+void
+internalConvolveOneTile(MultiArrayIndex tileIndex,
+                        typename MultiArrayShape<N>::type const & shape,
+                        typename MultiArrayShape<N>::type const & tileShape,
+                        typename MultiArrayShape<N>::type const & tileCount,
+                        typename MultiArrayShape<N>::type const & haloLeft,
+                        typename MultiArrayShape<N>::type const & haloRight,
+                        TileReader & readTile, TileWriter & writeTile,
+                        KernelIterator kernels)
+{
+    typedef typename MultiArrayShape<N>::type Shape;
+
+    Shape cstart, cstop, estart, estop;
+    MultiArrayIndex rest = tileIndex;
+    for(unsigned int d = 0; d < N; ++d)
+    {
+        cstart[d] = (rest % tileCount[d]) * tileShape[d];
+        rest /= tileCount[d];
+        cstop[d]  = std::min(cstart[d] + tileShape[d], shape[d]);
+        estart[d] = std::max<MultiArrayIndex>(cstart[d] - haloLeft[d], 0);
+        estop[d]  = std::min(cstop[d] + haloRight[d], shape[d]);
+    }
+
+    MultiArray<N, T> etile(estop - estart);
+    MultiArrayView<N, T> & etileView = etile;
+
+#ifdef _OPENMP
+#pragma omp critical(vigra_tiled_convolution_io)
+#endif
+    readTile(estart, estop, etileView);
+
+    separableConvolveMultiArray(srcMultiArrayRange(etile), destMultiArray(etile),
+                                kernels);
+
+    MultiArrayView<N, T> core = etile.subarray(cstart - estart, cstop - estart);
+
+#ifdef _OPENMP
+#pragma omp critical(vigra_tiled_convolution_io)
+#endif
+    writeTile(cstart, cstop, core);
+}
+
+} // namespace detail
+
+/** \brief Tiled separable convolution for arrays that do not fit into memory.
+
+    This function convolves an array of the given <tt>shape</tt> tile-by-tile,
+    so only one tile (plus its halo) per thread is ever held in memory. It is
+    intended for out-of-core data: the caller supplies the tiles through a
+    reader and collects the results through a writer functor with the
+    interfaces
+
+    \code
+    void readTile(Shape const & start, Shape const & stop,
+                  MultiArrayView<N, T> & tile);         // fill tile with source[start, stop)
+    void writeTile(Shape const & start, Shape const & stop,
+                   MultiArrayView<N, T> const & tile);  // store tile as result[start, stop)
+    \endcode
+
+    where <tt>Shape</tt> is <tt>MultiArrayShape&lt;N&gt;::type</tt> and the tile
+    view always has shape <tt>stop - start</tt>. The halo required around each
+    tile is derived from the radii of the given kernels, so the results are
+    identical to a monolithic \ref separableConvolveMultiArray() call on the
+    entire array. Since <tt>BORDER_TREATMENT_WRAP</tt> needs data from the
+    opposite end of the array and <tt>BORDER_TREATMENT_AVOID</tt> leaves border
+    pixels undefined, these modes cannot be computed tile-by-tile and are
+    rejected with a precondition violation.
+
+    When compiled with OpenMP, the tiles are distributed dynamically across the
+    threads requested in <tt>options</tt>. Calls to the reader and writer are
+    serialized, so the functors may perform unguarded I/O; only the convolution
+    itself runs concurrently.
+
+    The array dimensionality <tt>N</tt> and the (real-valued) working pixel
+    type <tt>T</tt> cannot be deduced from the arguments and must be given
+    explicitly.
+
+    <b> Declaration:</b>
+
+    \code
+    namespace vigra {
+        template <unsigned int N, class T,
+                  class TileReader, class TileWriter, class KernelIterator>
+        void
+        separableConvolveTiled(typename MultiArrayShape<N>::type const & shape,
+                               typename MultiArrayShape<N>::type const & tileShape,
+                               TileReader & readTile, TileWriter & writeTile,
+                               KernelIterator kernels,
+                               ParallelOptions const & options = ParallelOptions());
+    }
+    \endcode
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/multi_convolution.hxx\>
+
+    \code
+    MultiArrayShape<3>::type shape(2000, 2000, 4000), tileShape(256, 256, 256);
+
+    ArrayVector<Kernel1D<double> > kernels(3);
+    for(int d = 0; d < 3; ++d)
+        kernels[d].initGaussian(2.0);
+
+    MyHDF5Reader reader(...);    // models the TileReader concept
+    MyHDF5Writer writer(...);    // models the TileWriter concept
+
+    separableConvolveTiled<3, double>(shape, tileShape, reader, writer,
+                                      kernels.begin());
+    \endcode
+
+    \see separableConvolveMultiArray()
+*/
+template <unsigned int N, class T,
+          class TileReader, class TileWriter, class KernelIterator>
+void
+separableConvolveTiled(typename MultiArrayShape<N>::type const & shape,
+                       typename MultiArrayShape<N>::type const & tileShape,
+                       TileReader & readTile, TileWriter & writeTile,
+                       KernelIterator kernels,
+                       ParallelOptions const & options = ParallelOptions())
+{
+    typedef typename MultiArrayShape<N>::type Shape;
+
+    Shape haloLeft, haloRight, tileCount;
+    MultiArrayIndex numTiles = 1;
+    KernelIterator kit = kernels;
+    for(unsigned int d = 0; d < N; ++d, ++kit)
+    {
+        vigra_precondition(shape[d] > 0 && tileShape[d] > 0,
+            "separableConvolveTiled(): shape and tileShape must be positive.");
+        vigra_precondition(kit->borderTreatment() != BORDER_TREATMENT_WRAP &&
+                           kit->borderTreatment() != BORDER_TREATMENT_AVOID,
+            "separableConvolveTiled(): border treatments WRAP and AVOID cannot "
+            "be computed tile-by-tile.");
+        vigra_precondition(shape[d] >= std::max<MultiArrayIndex>(kit->right(), -kit->left()) + 1,
+            "separableConvolveTiled(): kernel longer than array.");
+        haloLeft[d]  = kit->right();
+        haloRight[d] = -kit->left();
+        tileCount[d] = (shape[d] + tileShape[d] - 1) / tileShape[d];
+        numTiles *= tileCount[d];
+    }
+
+#ifdef _OPENMP
+    if(options.getNumThreads() != 1 && numTiles > 1)
+    {
+#pragma omp parallel num_threads(options.getNumThreads())
+        {
+#pragma omp for schedule(dynamic)
+            for(MultiArrayIndex t = 0; t < numTiles; ++t)
+                detail::internalConvolveOneTile<N, T>(t, shape, tileShape, tileCount,
+                                                      haloLeft, haloRight,
+                                                      readTile, writeTile, kernels);
+        }
+        return;
+    }
+#endif
+
+    for(MultiArrayIndex t = 0; t < numTiles; ++t)
+        detail::internalConvolveOneTile<N, T>(t, shape, tileShape, tileCount,
+                                              haloLeft, haloRight,
+                                              readTile, writeTile, kernels);
+}
+
 //@}
 
 } //-- namespace vigra
@@ -47,6 +47,7 @@
 #include "metaprogramming.hxx"
 #include "multi_pointoperators.hxx"
 #include "functorexpression.hxx"
+#include "parallel_options.hxx"
 
 namespace vigra
 {
@@ -210,6 +211,95 @@ void internalSeparableMultiArrayDistTmp(
     if(invert) transformMultiArray( di, shape, dest, di, dest, -Arg1());
 }
 
+// multi-threaded version: the parabola-envelope passes along every axis
+// consist of independent line computations, so each thread handles one
+// contiguous batch of lines per axis with its own temporary buffer
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor, class Array>
+void internalSeparableMultiArrayDistTmp(
+                      SrcIterator si, SrcShape const & shape, SrcAccessor src,
+                      DestIterator di, DestAccessor dest, Array const & sigmas, bool invert,
+                      ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    enum { N =  SrcShape::static_size};
+
+    typedef typename NumericTraits<typename DestAccessor::value_type>::RealPromote TmpType;
+    typedef MultiArrayNavigator<SrcIterator, N> SNavigator;
+    typedef MultiArrayNavigator<DestIterator, N> DNavigator;
+
+    int num_threads = options.getNumThreads();
+    if(num_threads > 1)
+    {
+        using namespace vigra::functor;
+
+        for( int d = 0; d < (int)N; ++d )
+        {
+            long long lines = 1;
+            for( int k = 0; k < (int)N; ++k )
+                if(k != d)
+                    lines *= shape[k];
+            int nt = ((long long)num_threads > lines)
+                          ? (int)lines
+                          : num_threads;
+            std::string errorMessage;
+#pragma omp parallel for schedule(static) num_threads(nt)
+            for(int t = 0; t < nt; ++t)
+            {
+                try
+                {
+                    long long begin = lines * t / nt,
+                              end   = lines * (t+1) / nt;
+                    ArrayVector<TmpType> tmp( shape[d] );
+                    SNavigator snav( si, shape, d );
+                    DNavigator dnav( di, shape, d );
+                    for(long long k = 0; k < begin; ++k)
+                    {
+                        snav++;
+                        dnav++;
+                    }
+                    for(long long k = begin; k < end; ++k, snav++, dnav++)
+                    {
+                        if(d == 0)
+                        {
+                            // the first pass reads the source array
+                            // (and inverts it for grayscale morphology)
+                            if(invert)
+                                transformLine( snav.begin(), snav.end(), src, tmp.begin(),
+                                               typename AccessorTraits<TmpType>::default_accessor(),
+                                               Param(NumericTraits<TmpType>::zero())-Arg1());
+                            else
+                                copyLine( snav.begin(), snav.end(), src, tmp.begin(),
+                                          typename AccessorTraits<TmpType>::default_accessor() );
+                        }
+                        else
+                        {
+                            copyLine( dnav.begin(), dnav.end(), dest,
+                                      tmp.begin(), typename AccessorTraits<TmpType>::default_accessor() );
+                        }
+
+                        detail::distParabola( srcIterRange(tmp.begin(), tmp.end(),
+                                      typename AccessorTraits<TmpType>::default_const_accessor()),
+                                      destIter( dnav.begin(), dest ), sigmas[d] );
+                    }
+                }
+                catch(std::exception & e)
+                {
+#pragma omp critical(vigra_multi_distance_error)
+                    errorMessage = e.what();
+                }
+            }
+            if(!errorMessage.empty())
+                vigra_fail("internalSeparableMultiArrayDistTmp(): worker thread failed with:\n" + errorMessage);
+        }
+        if(invert) transformMultiArray( di, shape, dest, di, dest, -Arg1());
+        return;
+    }
+#endif // _OPENMP
+
+    internalSeparableMultiArrayDistTmp( si, shape, src, di, dest, sigmas, invert );
+}
+
 template <class SrcIterator, class SrcShape, class SrcAccessor,
           class DestIterator, class DestAccessor, class Array>
 inline void internalSeparableMultiArrayDistTmp( SrcIterator si, SrcShape const & shape, SrcAccessor src,
@@ -427,6 +517,122 @@ inline void separableMultiDistSquared( triple<SrcIterator, SrcShape, SrcAccessor
                                dest.first, dest.second, background );
 }
 
+/** \brief Multi-threaded variant of \ref separableMultiDistSquared().
+
+    The line computations of the parabola-envelope pass along each axis
+    are independent, so every thread processes a contiguous batch of
+    lines; the axes are still traversed one after another because each
+    pass depends on the result of the previous one. The result is
+    identical to the output of the sequential algorithm.
+
+    \code
+    MultiArray<3, unsigned char> source(shape);
+    MultiArray<3, float> dest(shape);
+
+    separableMultiDistSquared(srcMultiArrayRange(source), destMultiArray(dest),
+                              true, ParallelOptions().numThreads(4));
+    \endcode
+
+    Without OpenMP support, or when one thread is requested, this simply
+    calls the sequential algorithm.
+*/
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor, class Array>
+void separableMultiDistSquared( SrcIterator s, SrcShape const & shape, SrcAccessor src,
+                                DestIterator d, DestAccessor dest, bool background,
+                                Array const & pixelPitch,
+                                ParallelOptions const & options)
+{
+    int N = shape.size();
+
+    typedef typename SrcAccessor::value_type SrcType;
+    typedef typename DestAccessor::value_type DestType;
+    typedef typename NumericTraits<DestType>::RealPromote Real;
+
+    SrcType zero = NumericTraits<SrcType>::zero();
+
+    double dmax = 0.0;
+    bool pixelPitchIsReal = false;
+    for( int k=0; k<N; ++k)
+    {
+        if(int(pixelPitch[k]) != pixelPitch[k])
+            pixelPitchIsReal = true;
+        dmax += sq(pixelPitch[k]*shape[k]);
+    }
+
+    using namespace vigra::functor;
+
+    if(dmax > NumericTraits<DestType>::toRealPromote(NumericTraits<DestType>::max())
+       || pixelPitchIsReal) // need a temporary array to avoid overflows
+    {
+        // Threshold the values so all objects have infinity value in the beginning
+        Real maxDist = (Real)dmax, rzero = (Real)0.0;
+        MultiArray<SrcShape::static_size, Real> tmpArray(shape);
+        if(background == true)
+            transformMultiArray( s, shape, src,
+                                 tmpArray.traverser_begin(), typename AccessorTraits<Real>::default_accessor(),
+                                 ifThenElse( Arg1() == Param(zero), Param(maxDist), Param(rzero) ));
+        else
+            transformMultiArray( s, shape, src,
+                                 tmpArray.traverser_begin(), typename AccessorTraits<Real>::default_accessor(),
+                                 ifThenElse( Arg1() != Param(zero), Param(maxDist), Param(rzero) ));
+
+        detail::internalSeparableMultiArrayDistTmp( tmpArray.traverser_begin(),
+                shape, typename AccessorTraits<Real>::default_accessor(),
+                tmpArray.traverser_begin(),
+                typename AccessorTraits<Real>::default_accessor(), pixelPitch,
+                false, options);
+
+        copyMultiArray(srcMultiArrayRange(tmpArray), destIter(d, dest));
+    }
+    else        // work directly on the destination array
+    {
+        // Threshold the values so all objects have infinity value in the beginning
+        DestType maxDist = DestType(std::ceil(dmax)), rzero = (DestType)0;
+        if(background == true)
+            transformMultiArray( s, shape, src, d, dest,
+                                 ifThenElse( Arg1() == Param(zero), Param(maxDist), Param(rzero) ));
+        else
+            transformMultiArray( s, shape, src, d, dest,
+                                 ifThenElse( Arg1() != Param(zero), Param(maxDist), Param(rzero) ));
+
+        detail::internalSeparableMultiArrayDistTmp( d, shape, dest, d, dest, pixelPitch,
+                                                    false, options);
+    }
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor, class Array>
+inline void separableMultiDistSquared( triple<SrcIterator, SrcShape, SrcAccessor> const & source,
+                                       pair<DestIterator, DestAccessor> const & dest, bool background,
+                                       Array const & pixelPitch,
+                                       ParallelOptions const & options)
+{
+    separableMultiDistSquared( source.first, source.second, source.third,
+                               dest.first, dest.second, background, pixelPitch, options );
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline
+void separableMultiDistSquared( SrcIterator s, SrcShape const & shape, SrcAccessor src,
+                                DestIterator d, DestAccessor dest, bool background,
+                                ParallelOptions const & options)
+{
+    ArrayVector<double> pixelPitch(shape.size(), 1.0);
+    separableMultiDistSquared( s, shape, src, d, dest, background, pixelPitch, options );
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void separableMultiDistSquared( triple<SrcIterator, SrcShape, SrcAccessor> const & source,
+                                       pair<DestIterator, DestAccessor> const & dest, bool background,
+                                       ParallelOptions const & options)
+{
+    separableMultiDistSquared( source.first, source.second, source.third,
+                               dest.first, dest.second, background, options );
+}
+
 /********************************************************/
 /*                                                      */
 /*             separableMultiDistance                   */
@@ -552,6 +758,62 @@ inline void separableMultiDistance( triple<SrcIterator, SrcShape, SrcAccessor> c
                             dest.first, dest.second, background );
 }
 
+/** \brief Multi-threaded variant of \ref separableMultiDistance().
+
+    Calls the parallel \ref separableMultiDistSquared() and takes the
+    pixel-wise square root of the result. Without OpenMP support, or when
+    one thread is requested, this simply calls the sequential algorithm.
+*/
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor, class Array>
+void separableMultiDistance( SrcIterator s, SrcShape const & shape, SrcAccessor src,
+                             DestIterator d, DestAccessor dest, bool background,
+                             Array const & pixelPitch,
+                             ParallelOptions const & options)
+{
+    separableMultiDistSquared( s, shape, src, d, dest, background, pixelPitch, options);
+
+    // Finally, calculate the square root of the distances
+    using namespace vigra::functor;
+
+    transformMultiArray( d, shape, dest, d, dest, sqrt(Arg1()) );
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void separableMultiDistance( SrcIterator s, SrcShape const & shape, SrcAccessor src,
+                             DestIterator d, DestAccessor dest, bool background,
+                             ParallelOptions const & options)
+{
+    separableMultiDistSquared( s, shape, src, d, dest, background, options);
+
+    // Finally, calculate the square root of the distances
+    using namespace vigra::functor;
+
+    transformMultiArray( d, shape, dest, d, dest, sqrt(Arg1()) );
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor, class Array>
+inline void separableMultiDistance( triple<SrcIterator, SrcShape, SrcAccessor> const & source,
+                                    pair<DestIterator, DestAccessor> const & dest, bool background,
+                                    Array const & pixelPitch,
+                                    ParallelOptions const & options)
+{
+    separableMultiDistance( source.first, source.second, source.third,
+                            dest.first, dest.second, background, pixelPitch, options );
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void separableMultiDistance( triple<SrcIterator, SrcShape, SrcAccessor> const & source,
+                                    pair<DestIterator, DestAccessor> const & dest, bool background,
+                                    ParallelOptions const & options)
+{
+    separableMultiDistance( source.first, source.second, source.third,
+                            dest.first, dest.second, background, options );
+}
+
 //@}
 
 } //-- namespace vigra
@@ -40,6 +40,7 @@
 #include "multi_array.hxx"
 #include "navigator.hxx"
 #include "copyimage.hxx"
+#include "stdconvolution.hxx"
 
 namespace vigra {
 
@@ -292,6 +293,75 @@ inline void fftwPlanDestroy(fftwl_plan plan)
         fftwl_destroy_plan(plan);
 }
 
+inline int fftwAlignmentOf(double * p)
+{
+    return fftw_alignment_of(p);
+}
+
+inline int fftwAlignmentOf(float * p)
+{
+    return fftwf_alignment_of(p);
+}
+
+inline int fftwAlignmentOf(long double * p)
+{
+    return fftwl_alignment_of(p);
+}
+
+template <class Real>
+inline int fftwAlignmentOf(FFTWComplex<Real> * p)
+{
+    return fftwAlignmentOf((Real *)p);
+}
+
+inline bool fftwInitThreads(double)
+{
+    static int status = fftw_init_threads();
+    return status != 0;
+}
+
+inline bool fftwInitThreads(float)
+{
+    static int status = fftwf_init_threads();
+    return status != 0;
+}
+
+inline bool fftwInitThreads(long double)
+{
+    static int status = fftwl_init_threads();
+    return status != 0;
+}
+
+inline void fftwPlanWithNThreads(double, int numThreads)
+{
+    fftw_plan_with_nthreads(numThreads);
+}
+
+inline void fftwPlanWithNThreads(float, int numThreads)
+{
+    fftwf_plan_with_nthreads(numThreads);
+}
+
+inline void fftwPlanWithNThreads(long double, int numThreads)
+{
+    fftwl_plan_with_nthreads(numThreads);
+}
+
+inline void fftwCleanupThreads(double)
+{
+    fftw_cleanup_threads();
+}
+
+inline void fftwCleanupThreads(float)
+{
+    fftwf_cleanup_threads();
+}
+
+inline void fftwCleanupThreads(long double)
+{
+    fftwl_cleanup_threads();
+}
+
 inline void 
 fftwPlanExecute(fftw_plan plan) 
 {
@@ -780,6 +850,128 @@ fftwCorrespondingShapeC2R(TinyVector<T, N> shape, bool oddDimension0 = false)
     return shape;
 }
 
+/********************************************************/
+/*                                                      */
+/*                FFTWHermitianSpectrum                 */
+/*                                                      */
+/********************************************************/
+
+/** \brief Hermitian-packed half spectrum of a real-valued array.
+
+    The Fourier transform of a real-valued array is Hermitian symmetric, so
+    FFTW's <a href="http://www.fftw.org/doc/Multi_002dDimensional-DFTs-of-Real-Data.html">R2C
+    transform</a> stores only about half of the coefficients
+    (<tt>shape(0)</tt> is reduced to <tt>shape(0) / 2 + 1</tt>, see
+    \ref fftwCorrespondingShapeR2C()). This halves both the memory footprint
+    and the transform time compared to a full complex spectrum, which matters
+    for large memory-bound arrays.
+
+    This class makes the packed layout a first-class type: it holds the
+    half-spectrum array together with the spatial shape it was transformed
+    from. The latter cannot be recovered from the packed shape alone (spatial
+    extents <tt>2*m</tt> and <tt>2*m+1</tt> both pack to <tt>m+1</tt>), so
+    keeping it here relieves callers of tracking the parity themselves when
+    transforming back.
+
+    \ref fourierTransform() fills an <tt>FFTWHermitianSpectrum</tt> from a
+    real array, and \ref fourierTransformInverse() transforms it back
+    (normalized). Frequency-domain filters operate directly on the packed
+    coefficients via array().
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/multi_fft.hxx\><br>
+    Namespace: vigra
+
+    \code
+    MultiArray<2, float> src(Shape2(16384, 16384)), dest(src.shape());
+    FFTWHermitianSpectrum<2, float> spectrum;
+
+    fourierTransform(src, spectrum);   // R2C, half memory and time
+
+    // apply a frequency-domain filter defined on the half spectrum
+    spectrum.array() *= filter;
+
+    fourierTransformInverse(spectrum, dest);  // C2R
+    \endcode
+*/
+template <unsigned int N, class Real = double>
+class FFTWHermitianSpectrum
+{
+  public:
+    typedef FFTWComplex<Real> value_type;
+    typedef typename MultiArrayShape<N>::type Shape;
+    typedef MultiArray<N, value_type, FFTWAllocator<value_type> > ArrayType;
+
+        /** \brief Create an empty spectrum.
+
+            The spectrum is allocated upon resize() or by \ref fourierTransform().
+        */
+    FFTWHermitianSpectrum()
+    : spatialShape_()
+    {}
+
+        /** \brief Create a spectrum for real arrays of the given spatial shape.
+
+            The internal array gets the packed shape
+            <tt>fftwCorrespondingShapeR2C(spatialShape)</tt>.
+        */
+    explicit FFTWHermitianSpectrum(Shape const & spatialShape)
+    {
+        resize(spatialShape);
+    }
+
+        /** \brief Reallocate the spectrum for the given spatial shape.
+        */
+    void resize(Shape const & spatialShape)
+    {
+        vigra_precondition(prod(spatialShape) > 0,
+            "FFTWHermitianSpectrum::resize(): shape must be positive.");
+        spatialShape_ = spatialShape;
+        data_.reshape(fftwCorrespondingShapeR2C(spatialShape));
+    }
+
+        /** \brief The shape of the real array this spectrum corresponds to.
+        */
+    Shape const & spatialShape() const
+    {
+        return spatialShape_;
+    }
+
+        /** \brief The packed shape of the stored half spectrum.
+        */
+    Shape shape() const
+    {
+        return data_.shape();
+    }
+
+        /** \brief Whether the spatial extent of dimension 0 is odd
+            (needed to unpack the half spectrum unambiguously).
+        */
+    bool oddDimension0() const
+    {
+        return odd(spatialShape_[0]);
+    }
+
+        /** \brief Access the packed coefficient array.
+        */
+    ArrayType & array()
+    {
+        return data_;
+    }
+
+        /** \brief Access the packed coefficient array.
+        */
+    ArrayType const & array() const
+    {
+        return data_;
+    }
+
+  private:
+    ArrayType data_;
+    Shape spatialShape_;
+};
+
 /********************************************************/
 /*                                                      */
 /*                       FFTWPlan                       */
@@ -809,9 +1001,28 @@ fftwCorrespondingShapeC2R(TinyVector<T, N> shape, bool oddDimension0 = false)
     
     // create an optimized plan by measuring the speed of several algorithm variants
     FFTWPlan<2, double> plan(src, fourier, FFTW_MEASURE);
-    
-    plan.execute(src, fourier); 
+
+    plan.execute(src, fourier);
     \endcode
+
+    Large single transforms can use FFTW's multi-threaded execution. Call
+    \ref setPlannerThreads() before creating the plan (this requires linking
+    against <tt>libfftw3_threads</tt> and its <tt>float</tt>/<tt>long double</tt>
+    counterparts):
+
+    \code
+    MultiArray<3, FFTWComplex<double> > volume(Shape3(2048, 2048, 2048)), spectrum(volume.shape());
+
+    // let subsequently created plans use all cores
+    FFTWPlan<3, double>::setPlannerThreads();
+
+    FFTWPlan<3, double> plan(volume, spectrum, FFTW_FORWARD, FFTW_MEASURE);
+    plan.execute(volume, spectrum);
+    \endcode
+
+    When the caller already runs one transform per thread (e.g. over tiles),
+    leave the planner thread count at its default of one -- executing plans
+    is thread-safe, and nested parallelism would only cause oversubscription.
 */
 template <unsigned int N, class Real = double>
 class FFTWPlan
@@ -823,14 +1034,17 @@ class FFTWPlan
     PlanType plan;
     Shape shape, instrides, outstrides;
     int sign;
-    
+    int in_alignment, out_alignment;
+
   public:
         /** \brief Create an empty plan.
-        
+
             The plan can be initialized later by one of the init() functions.
         */
     FFTWPlan()
-    : plan(0)
+    : plan(0),
+      in_alignment(0),
+      out_alignment(0)
     {}
     
         /** \brief Create a plan for a complex-to-complex transform.
@@ -894,7 +1108,9 @@ class FFTWPlan
         */
     FFTWPlan(FFTWPlan const & other)
     : plan(other.plan),
-      sign(other.sign)
+      sign(other.sign),
+      in_alignment(other.in_alignment),
+      out_alignment(other.out_alignment)
     {
         FFTWPlan & o = const_cast<FFTWPlan &>(other);
         shape.swap(o.shape);
@@ -915,6 +1131,8 @@ class FFTWPlan
             instrides.swap(o.instrides);
             outstrides.swap(o.outstrides);
             sign = o.sign;
+            in_alignment = o.in_alignment;
+            out_alignment = o.out_alignment;
             o.plan = 0; // act like std::auto_ptr
         }
         return *this;
@@ -980,7 +1198,8 @@ class FFTWPlan
             The array shapes must be the same as in the corresponding init function
             or constructor. However, execute() can be called several times on
             the same plan, even with different arrays, as long as they have the appropriate 
-            shapes.
+            shapes and alignment (allocate them with \ref FFTWAllocator to get
+            consistent alignment).
         */
     template <class C1, class C2>
     void execute(MultiArrayView<N, FFTWComplex<Real>, C1> in, 
@@ -994,7 +1213,8 @@ class FFTWPlan
             The array shapes must be the same as in the corresponding init function
             or constructor. However, execute() can be called several times on
             the same plan, even with different arrays, as long as they have the appropriate 
-            shapes.
+            shapes and alignment (allocate them with \ref FFTWAllocator to get
+            consistent alignment).
         */
     template <class C1, class C2>
     void execute(MultiArrayView<N, Real, C1> in, 
@@ -1008,15 +1228,65 @@ class FFTWPlan
             The array shapes must be the same as in the corresponding init function
             or constructor. However, execute() can be called several times on
             the same plan, even with different arrays, as long as they have the appropriate 
-            shapes.
+            shapes and alignment (allocate them with \ref FFTWAllocator to get
+            consistent alignment).
         */
     template <class C1, class C2>
-    void execute(MultiArrayView<N, FFTWComplex<Real>, C1> in, 
+    void execute(MultiArrayView<N, FFTWComplex<Real>, C1> in,
                  MultiArrayView<N, Real, C2> out) const
     {
         executeImpl(in.permuteStridesDescending(), out.permuteStridesDescending());
     }
-    
+
+        /** \brief Let subsequently created plans execute with \a numThreads threads.
+
+            <tt>ParallelOptions::Auto</tt> (the default) uses one thread per
+            processor. The function initializes the FFTW threading runtime for
+            the precision <tt>Real</tt> on first use and then calls
+            <tt>fftw_plan_with_nthreads()</tt>; the caller must link against
+            <tt>libfftw3_threads</tt> (resp. the <tt>float</tt>/<tt>long double</tt>
+            counterpart). The thread count is planner state, i.e. it only
+            affects plans created afterwards; already existing plans keep the
+            thread count they were planned with. Returns the thread count that
+            was set, or 0 if the FFTW threading runtime failed to initialize.
+        */
+    static int setPlannerThreads(int numThreads = ParallelOptions::Auto)
+    {
+        int n = (numThreads == int(ParallelOptions::Auto))
+                     ? ParallelOptions::maxThreads()
+                     : numThreads;
+        if(n < 1)
+            n = 1;
+
+        bool initialized;
+        // the FFTW planner (including fftw_plan_with_nthreads) is not thread-safe
+#ifdef _OPENMP
+        #pragma omp critical(vigra_fftw_plan)
+#endif
+        {
+            initialized = detail::fftwInitThreads(Real());
+            if(initialized)
+                detail::fftwPlanWithNThreads(Real(), n);
+        }
+        return initialized ? n : 0;
+    }
+
+        /** \brief Release the resources of the FFTW threading runtime.
+
+            Optional cleanup counterpart of \ref setPlannerThreads(), to be
+            called at most once, after all plans have been destroyed (it
+            invalidates existing plans).
+        */
+    static void cleanupThreads()
+    {
+#ifdef _OPENMP
+        #pragma omp critical(vigra_fftw_plan)
+#endif
+        {
+            detail::fftwCleanupThreads(Real());
+        }
+    }
+
   private:
     
     template <class MI, class MO>
@@ -1086,6 +1356,8 @@ FFTWPlan<N, Real>::initImpl(MI ins, MO outs, int SIGN, unsigned int planner_flag
     instrides.swap(newIStrides);
     outstrides.swap(newOStrides);
     sign = SIGN;
+    in_alignment = detail::fftwAlignmentOf(ins.data());
+    out_alignment = detail::fftwAlignmentOf(outs.data());
 }
 
 template <unsigned int N, class Real>
@@ -1105,6 +1377,14 @@ void FFTWPlan<N, Real>::executeImpl(MI ins, MO outs) const
     vigra_precondition((outs.stride() == TinyVectorView<int, N>(outstrides.data())),
         "FFTWPlan::execute(): strides mismatch between plan and output data.");
 
+    // FFTW plans may only be applied to arrays whose alignment matches the
+    // arrays the plan was created with (use FFTWAllocator to get consistently
+    // aligned arrays)
+    vigra_precondition(detail::fftwAlignmentOf(ins.data()) == in_alignment,
+        "FFTWPlan::execute(): alignment mismatch between plan and input data.");
+    vigra_precondition(detail::fftwAlignmentOf(outs.data()) == out_alignment,
+        "FFTWPlan::execute(): alignment mismatch between plan and output data.");
+
     detail::fftwPlanExecute(plan, ins.data(), outs.data());
     
     typedef typename MO::value_type V;
@@ -1484,6 +1764,51 @@ class FFTWConvolvePlan
         executeManyImpl(in, kernels, kernelsEnd, outs, UseFourierKernel());
     }
 
+        /** \brief Execute a plan to convolve a complex array with a sequence of kernels,
+            processing the kernels in parallel.
+
+            The forward transform of \a in is computed once and shared by all
+            kernels; the kernel transforms, spectrum products, and inverse
+            transforms are distributed across threads, each working on private
+            scratch arrays. The result is identical to the serial
+            executeMany() for any thread count.
+        */
+    template <class C1, class KernelIterator, class OutIterator>
+    void executeMany(MultiArrayView<N, FFTWComplex<Real>, C1> in,
+                     KernelIterator kernels, KernelIterator kernelsEnd,
+                     OutIterator outs, ParallelOptions const & options);
+
+        /** \brief Execute a plan to convolve a real array with a sequence of kernels,
+            processing the kernels in parallel.
+
+            The forward transform of \a in is computed once and shared by all
+            kernels; the kernel transforms, spectrum products, and inverse
+            transforms are distributed across threads, each working on private
+            scratch arrays. The result is identical to the serial
+            executeMany() for any thread count.
+        */
+    template <class C1, class KernelIterator, class OutIterator>
+    void executeMany(MultiArrayView<N, Real, C1> in,
+                     KernelIterator kernels, KernelIterator kernelsEnd,
+                     OutIterator outs, ParallelOptions const & options)
+    {
+        typedef typename std::iterator_traits<KernelIterator>::value_type KernelArray;
+        typedef typename KernelArray::value_type KernelValue;
+        typedef typename IsSameType<KernelValue, Complex>::type UseFourierKernel;
+        typedef typename std::iterator_traits<OutIterator>::value_type OutArray;
+        typedef typename OutArray::value_type OutValue;
+
+        bool realKernel = IsSameType<KernelValue, Real>::value;
+        bool fourierKernel = IsSameType<KernelValue, Complex>::value;
+
+        vigra_precondition(realKernel || fourierKernel,
+             "FFTWConvolvePlan::executeMany(): kernels have unsuitable value_type.");
+        vigra_precondition((IsSameType<OutValue, Real>::value),
+             "FFTWConvolvePlan::executeMany(): outputs have unsuitable value_type.");
+
+        executeManyImpl(in, kernels, kernelsEnd, outs, UseFourierKernel(), options);
+    }
+
   private:
   
     template <class KernelIterator, class OutIterator>
@@ -1508,12 +1833,26 @@ class FFTWConvolvePlan
                     OutIterator outs, VigraFalseType /* useFourierKernel*/);
     
     template <class C1, class KernelIterator, class OutIterator>
-    void 
-    executeManyImpl(MultiArrayView<N, Real, C1> in, 
+    void
+    executeManyImpl(MultiArrayView<N, Real, C1> in,
                     KernelIterator kernels, KernelIterator kernelsEnd,
                     OutIterator outs, VigraTrueType /* useFourierKernel*/);
-    
-};    
+
+    template <class C1, class KernelIterator, class OutIterator>
+    void
+    executeManyImpl(MultiArrayView<N, Real, C1> in,
+                    KernelIterator kernels, KernelIterator kernelsEnd,
+                    OutIterator outs, VigraFalseType /* useFourierKernel*/,
+                    ParallelOptions const & options);
+
+    template <class C1, class KernelIterator, class OutIterator>
+    void
+    executeManyImpl(MultiArrayView<N, Real, C1> in,
+                    KernelIterator kernels, KernelIterator kernelsEnd,
+                    OutIterator outs, VigraTrueType /* useFourierKernel*/,
+                    ParallelOptions const & options);
+
+};
     
 template <unsigned int N, class Real>
 void 
@@ -1827,13 +2166,203 @@ FFTWConvolvePlan<N, Real>::executeMany(MultiArrayView<N, FFTWComplex<Real>, C1>
         }
 
         fourierKernel *= fourierArray;
-        
+
         backward_plan.execute(fourierKernel, fourierKernel);
-        
+
         *outs = fourierKernel.subarray(left, right);
     }
 }
 
+template <unsigned int N, class Real>
+template <class C1, class KernelIterator, class OutIterator>
+void
+FFTWConvolvePlan<N, Real>::executeManyImpl(MultiArrayView<N, Real, C1> in,
+                                           KernelIterator kernels, KernelIterator kernelsEnd,
+                                           OutIterator outs, VigraFalseType /*useFourierKernel*/,
+                                           ParallelOptions const & options)
+{
+    vigra_precondition(!useFourierKernel,
+       "FFTWConvolvePlan::execute(): plan was generated for Fourier kernel, got spatial kernel.");
+
+    Shape kernelMax = checkShapes(in.shape(), kernels, kernelsEnd, outs),
+          paddedShape = fftwBestPaddedShapeR2C(in.shape() + kernelMax - Shape(1)),
+          diff = paddedShape - in.shape(),
+          left = div(diff, MultiArrayIndex(2)),
+          right = in.shape() + left;
+
+    vigra_precondition(paddedShape == realArray.shape(),
+       "FFTWConvolvePlan::executeMany(): shape mismatch between input and plan.");
+
+    // the forward transform of the input is computed once and shared
+    detail::fftEmbedArray(in, realArray);
+    forward_plan.execute(realArray, fourierArray);
+
+    ArrayVector<KernelIterator> kernelIters;
+    ArrayVector<OutIterator> outIters;
+    for(; kernels != kernelsEnd; ++kernels, ++outs)
+    {
+        kernelIters.push_back(kernels);
+        outIters.push_back(outs);
+    }
+    int kernelCount = (int)kernelIters.size();
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(options.getNumThreads())
+#endif
+    {
+        // per-thread scratch mirroring realKernel/fourierKernel; executing
+        // shared plans on private arrays is thread-safe
+        CArray threadFourierKernel(fourierKernel.shape());
+        Shape threadRealStrides = 2*threadFourierKernel.stride();
+        threadRealStrides[0] = 1;
+        RArray threadRealKernel(realArray.shape(), threadRealStrides,
+                                (Real *)threadFourierKernel.data());
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for(int i = 0; i < kernelCount; ++i)
+        {
+            detail::fftEmbedKernel(*kernelIters[i], threadRealKernel);
+            forward_plan.execute(threadRealKernel, threadFourierKernel);
+
+            threadFourierKernel *= fourierArray;
+
+            backward_plan.execute(threadFourierKernel, threadRealKernel);
+
+            *outIters[i] = threadRealKernel.subarray(left, right);
+        }
+    }
+}
+
+template <unsigned int N, class Real>
+template <class C1, class KernelIterator, class OutIterator>
+void
+FFTWConvolvePlan<N, Real>::executeManyImpl(MultiArrayView<N, Real, C1> in,
+                                           KernelIterator kernels, KernelIterator kernelsEnd,
+                                           OutIterator outs, VigraTrueType /*useFourierKernel*/,
+                                           ParallelOptions const & options)
+{
+    vigra_precondition(useFourierKernel,
+       "FFTWConvolvePlan::execute(): plan was generated for spatial kernel, got Fourier kernel.");
+
+    Shape complexShape = checkShapesFourier(in.shape(), kernels, kernelsEnd, outs),
+          paddedShape = fftwCorrespondingShapeC2R(complexShape, odd(in.shape(0))),
+          diff = paddedShape - in.shape(),
+          left = div(diff, MultiArrayIndex(2)),
+          right = in.shape() + left;
+
+    vigra_precondition(complexShape == fourierArray.shape(),
+       "FFTWConvolvePlan::executeFourierKernelMany(): shape mismatch between kernels and plan.");
+
+    vigra_precondition(paddedShape == realArray.shape(),
+       "FFTWConvolvePlan::executeFourierKernelMany(): shape mismatch between input and plan.");
+
+    // the forward transform of the input is computed once and shared
+    detail::fftEmbedArray(in, realArray);
+    forward_plan.execute(realArray, fourierArray);
+
+    ArrayVector<KernelIterator> kernelIters;
+    ArrayVector<OutIterator> outIters;
+    for(; kernels != kernelsEnd; ++kernels, ++outs)
+    {
+        kernelIters.push_back(kernels);
+        outIters.push_back(outs);
+    }
+    int kernelCount = (int)kernelIters.size();
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(options.getNumThreads())
+#endif
+    {
+        CArray threadFourierKernel(fourierKernel.shape());
+        Shape threadRealStrides = 2*threadFourierKernel.stride();
+        threadRealStrides[0] = 1;
+        RArray threadRealKernel(realArray.shape(), threadRealStrides,
+                                (Real *)threadFourierKernel.data());
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for(int i = 0; i < kernelCount; ++i)
+        {
+            threadFourierKernel = *kernelIters[i];
+            moveDCToHalfspaceUpperLeft(threadFourierKernel);
+            threadFourierKernel *= fourierArray;
+
+            backward_plan.execute(threadFourierKernel, threadRealKernel);
+
+            *outIters[i] = threadRealKernel.subarray(left, right);
+        }
+    }
+}
+
+template <unsigned int N, class Real>
+template <class C1, class KernelIterator, class OutIterator>
+void
+FFTWConvolvePlan<N, Real>::executeMany(MultiArrayView<N, FFTWComplex<Real>, C1> in,
+                                       KernelIterator kernels, KernelIterator kernelsEnd,
+                                       OutIterator outs, ParallelOptions const & options)
+{
+    typedef typename std::iterator_traits<KernelIterator>::value_type KernelArray;
+    typedef typename KernelArray::value_type KernelValue;
+    typedef typename std::iterator_traits<OutIterator>::value_type OutArray;
+    typedef typename OutArray::value_type OutValue;
+
+    vigra_precondition((IsSameType<KernelValue, Complex>::value),
+         "FFTWConvolvePlan::executeMany(): kernels have unsuitable value_type.");
+    vigra_precondition((IsSameType<OutValue, Complex>::value),
+         "FFTWConvolvePlan::executeMany(): outputs have unsuitable value_type.");
+
+    Shape paddedShape = checkShapesComplex(in.shape(), kernels, kernelsEnd, outs),
+          diff = paddedShape - in.shape(),
+          left = div(diff, MultiArrayIndex(2)),
+          right = in.shape() + left;
+
+    // the forward transform of the input is computed once and shared
+    detail::fftEmbedArray(in, fourierArray);
+    forward_plan.execute(fourierArray, fourierArray);
+
+    ArrayVector<KernelIterator> kernelIters;
+    ArrayVector<OutIterator> outIters;
+    for(; kernels != kernelsEnd; ++kernels, ++outs)
+    {
+        kernelIters.push_back(kernels);
+        outIters.push_back(outs);
+    }
+    int kernelCount = (int)kernelIters.size();
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(options.getNumThreads())
+#endif
+    {
+        CArray threadFourierKernel(fourierArray.shape());
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for(int i = 0; i < kernelCount; ++i)
+        {
+            if(useFourierKernel)
+            {
+                threadFourierKernel = *kernelIters[i];
+                moveDCToUpperLeft(threadFourierKernel);
+            }
+            else
+            {
+                detail::fftEmbedKernel(*kernelIters[i], threadFourierKernel);
+                forward_plan.execute(threadFourierKernel, threadFourierKernel);
+            }
+
+            threadFourierKernel *= fourierArray;
+
+            backward_plan.execute(threadFourierKernel, threadFourierKernel);
+
+            *outIters[i] = threadFourierKernel.subarray(left, right);
+        }
+    }
+}
+
 #endif // DOXYGEN
 
 template <unsigned int N, class Real>
@@ -1970,8 +2499,8 @@ fourierTransform(MultiArrayView<N, Real, C1> in,
 }
 
 template <unsigned int N, class Real, class C1, class C2>
-void 
-fourierTransformInverse(MultiArrayView<N, FFTWComplex<Real>, C1> in, 
+void
+fourierTransformInverse(MultiArrayView<N, FFTWComplex<Real>, C1> in,
                         MultiArrayView<N, Real, C2> out)
 {
     vigra_precondition(in.shape() == fftwCorrespondingShapeR2C(out.shape()),
@@ -1979,6 +2508,88 @@ fourierTransformInverse(MultiArrayView<N, FFTWComplex<Real>, C1> in,
     FFTWPlan<N, Real>(in, out).execute(in, out);
 }
 
+// overloads with a ParallelOptions argument execute the single transform with
+// FFTW's multi-threaded runtime (the caller must link against libfftw3_threads);
+// the planner thread count is reset to one afterwards, so that subsequent
+// plans created by other threads remain single-threaded
+
+template <unsigned int N, class Real, class C1, class C2>
+inline void
+fourierTransform(MultiArrayView<N, FFTWComplex<Real>, C1> in,
+                 MultiArrayView<N, FFTWComplex<Real>, C2> out,
+                 ParallelOptions const & options)
+{
+    bool threaded = options.getNumThreads() > 1;
+    if(threaded)
+        FFTWPlan<N, Real>::setPlannerThreads(options.getNumThreads());
+    FFTWPlan<N, Real>(in, out, FFTW_FORWARD).execute(in, out);
+    if(threaded)
+        FFTWPlan<N, Real>::setPlannerThreads(1);
+}
+
+template <unsigned int N, class Real, class C1, class C2>
+inline void
+fourierTransformInverse(MultiArrayView<N, FFTWComplex<Real>, C1> in,
+                        MultiArrayView<N, FFTWComplex<Real>, C2> out,
+                        ParallelOptions const & options)
+{
+    bool threaded = options.getNumThreads() > 1;
+    if(threaded)
+        FFTWPlan<N, Real>::setPlannerThreads(options.getNumThreads());
+    FFTWPlan<N, Real>(in, out, FFTW_BACKWARD).execute(in, out);
+    if(threaded)
+        FFTWPlan<N, Real>::setPlannerThreads(1);
+}
+
+template <unsigned int N, class Real, class C1, class C2>
+void
+fourierTransform(MultiArrayView<N, Real, C1> in,
+                 MultiArrayView<N, FFTWComplex<Real>, C2> out,
+                 ParallelOptions const & options)
+{
+    bool threaded = options.getNumThreads() > 1;
+    if(threaded)
+        FFTWPlan<N, Real>::setPlannerThreads(options.getNumThreads());
+    fourierTransform(in, out);
+    if(threaded)
+        FFTWPlan<N, Real>::setPlannerThreads(1);
+}
+
+template <unsigned int N, class Real, class C1, class C2>
+void
+fourierTransformInverse(MultiArrayView<N, FFTWComplex<Real>, C1> in,
+                        MultiArrayView<N, Real, C2> out,
+                        ParallelOptions const & options)
+{
+    bool threaded = options.getNumThreads() > 1;
+    if(threaded)
+        FFTWPlan<N, Real>::setPlannerThreads(options.getNumThreads());
+    fourierTransformInverse(in, out);
+    if(threaded)
+        FFTWPlan<N, Real>::setPlannerThreads(1);
+}
+
+template <unsigned int N, class Real, class C1>
+void
+fourierTransform(MultiArrayView<N, Real, C1> in,
+                 FFTWHermitianSpectrum<N, Real> & out)
+{
+    if(out.spatialShape() != in.shape())
+        out.resize(in.shape());
+    FFTWPlan<N, Real>(in, out.array()).execute(in, out.array());
+}
+
+template <unsigned int N, class Real, class C2>
+void
+fourierTransformInverse(FFTWHermitianSpectrum<N, Real> & in,
+                        MultiArrayView<N, Real, C2> out)
+{
+    vigra_precondition(out.shape() == in.spatialShape(),
+        "fourierTransformInverse(): shape mismatch between spectrum and output.");
+    // note: FFTW's multi-dimensional C2R transform overwrites the input spectrum
+    FFTWPlan<N, Real>(in.array(), out).execute(in.array(), out);
+}
+
 //@}
 
 /** \addtogroup MultiArrayConvolutionFilters
@@ -2024,6 +2635,11 @@ fourierTransformInverse(MultiArrayView<N, FFTWComplex<Real>, C1> in,
     
     The output arrays must have the same shape as the input arrays. In the "Many" variants of the
     convolution functions, the kernels must all have the same shape.
+
+    The "Many" variants compute the forward transform of the input exactly once and reuse it for the
+    entire kernel bank. They also accept an additional \ref vigra::ParallelOptions argument which
+    distributes the per-kernel work (kernel transform, spectrum product, inverse transform) across
+    threads, yielding the same results as the serial call.
     
     The origin of the kernel is always assumed to be in the center of the kernel array (precisely,
     at the point <tt>floor(kernel.shape() / 2.0)</tt>, except when the half-space format is used, see below). 
@@ -2222,16 +2838,28 @@ convolveFFTMany(MultiArrayView<N, Real, C1> in,
     plan.executeMany(in, kernels, kernelsEnd, outs);
 }
 
+template <unsigned int N, class Real, class C1,
+          class KernelIterator, class OutIterator>
+void
+convolveFFTMany(MultiArrayView<N, Real, C1> in,
+                KernelIterator kernels, KernelIterator kernelsEnd,
+                OutIterator outs, ParallelOptions const & options)
+{
+    FFTWConvolvePlan<N, Real> plan;
+    plan.initMany(in, kernels, kernelsEnd, outs);
+    plan.executeMany(in, kernels, kernelsEnd, outs, options);
+}
+
 /** \brief Convolve a complex-valued array with a sequence of kernels by means of the Fourier transform.
 
     See \ref convolveFFT() for details.
 */
 doxygen_overloaded_function(template <...> void convolveFFTComplexMany)
 
-template <unsigned int N, class Real, class C1, 
+template <unsigned int N, class Real, class C1,
           class KernelIterator, class OutIterator>
-void 
-convolveFFTComplexMany(MultiArrayView<N, FFTWComplex<Real>, C1> in, 
+void
+convolveFFTComplexMany(MultiArrayView<N, FFTWComplex<Real>, C1> in,
                 KernelIterator kernels, KernelIterator kernelsEnd,
                 OutIterator outs,
                 bool fourierDomainKernel)
@@ -2241,6 +2869,326 @@ convolveFFTComplexMany(MultiArrayView<N, FFTWComplex<Real>, C1> in,
     plan.executeMany(in, kernels, kernelsEnd, outs);
 }
 
+template <unsigned int N, class Real, class C1,
+          class KernelIterator, class OutIterator>
+void
+convolveFFTComplexMany(MultiArrayView<N, FFTWComplex<Real>, C1> in,
+                KernelIterator kernels, KernelIterator kernelsEnd,
+                OutIterator outs,
+                bool fourierDomainKernel, ParallelOptions const & options)
+{
+    FFTWConvolvePlan<N, Real> plan;
+    plan.initMany(in, kernels, kernelsEnd, outs, fourierDomainKernel);
+    plan.executeMany(in, kernels, kernelsEnd, outs, options);
+}
+
+/********************************************************/
+/*                                                      */
+/*                convolveFFTStreaming                  */
+/*                                                      */
+/********************************************************/
+
+/** \brief FFT-based convolution of an out-of-core image, strip by strip.
+
+    \ref convolveFFT() requires the entire image to be resident in memory.
+    This function filters arbitrarily large 2D images with bounded memory by
+    the overlap-save method: the image is processed in horizontal strips of
+    <tt>stripHeight</tt> rows; for each strip, the rows extended by the
+    vertical kernel reach are fetched from the caller, convolved via
+    \ref convolveFFT() (with the usual reflective padding), and only the core
+    rows of the result are written back. Since the halo rows provide genuine
+    image data everywhere except at the true image borders, the result agrees
+    with a whole-image convolveFFT() up to the round-off of the
+    differently-sized transforms.
+
+    The caller provides the I/O through two functors:
+
+    \code
+    // fill the (w x (y1-y0)) array 'strip' with image rows [y0, y1)
+    readStrip(MultiArrayIndex y0, MultiArrayIndex y1, MultiArrayView<2, Real> & strip);
+
+    // store the result rows [y0, y1) held in 'strip'
+    writeStrip(MultiArrayIndex y0, MultiArrayIndex y1, MultiArrayView<2, Real> const & strip);
+    \endcode
+
+    When OpenMP is enabled and \a options requests more than one thread, the
+    strips are distributed across threads, so that one thread's strip I/O
+    overlaps the FFT work of the others; the functor calls themselves are
+    serialized and therefore need not be thread-safe. Each output row is
+    computed by exactly one strip, so the result does not depend on the
+    thread count. The kernel must be given in the spatial domain --
+    frequency-domain filters defined on the full image spectrum depend on all
+    pixels at once and cannot be applied strip-wise.
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/multi_fft.hxx\><br>
+    Namespace: vigra
+
+    \code
+    struct StripReader
+    {
+        void operator()(MultiArrayIndex y0, MultiArrayIndex y1,
+                        MultiArrayView<2, float> & strip);  // e.g. read from file
+    };
+    struct StripWriter
+    {
+        void operator()(MultiArrayIndex y0, MultiArrayIndex y1,
+                        MultiArrayView<2, float> const & strip);
+    };
+
+    MultiArray<2, float> kernel(Shape2(65, 65));
+    ... // init a large non-separable kernel
+
+    StripReader reader;
+    StripWriter writer;
+
+    // filter a 200000 x 200000 image in strips of 2048 rows, using 4 threads
+    convolveFFTStreaming(Shape2(200000, 200000), 2048, reader, writer,
+                         MultiArrayView<2, float>(kernel),
+                         ParallelOptions().numThreads(4));
+    \endcode
+*/
+doxygen_overloaded_function(template <...> void convolveFFTStreaming)
+
+template <class Real, class C1, class StripReader, class StripWriter>
+void
+convolveFFTStreaming(typename MultiArrayShape<2>::type shape,
+                     MultiArrayIndex stripHeight,
+                     StripReader & readStrip, StripWriter & writeStrip,
+                     MultiArrayView<2, Real, C1> kernel,
+                     ParallelOptions const & options = ParallelOptions())
+{
+    typedef typename MultiArrayShape<2>::type Shape;
+
+    MultiArrayIndex w = shape[0], h = shape[1];
+
+    vigra_precondition(w > 0 && h > 0,
+        "convolveFFTStreaming(): image shape must be positive.");
+    vigra_precondition(stripHeight > 0,
+        "convolveFFTStreaming(): stripHeight must be positive.");
+    vigra_precondition(prod(kernel.shape()) > 0,
+        "convolveFFTStreaming(): kernel must be non-empty.");
+
+    // rows of context needed above and below a strip so that its core rows
+    // see every kernel tap (one extra row dodges any center convention)
+    MultiArrayIndex halo = kernel.shape(1) / 2 + 1;
+    MultiArrayIndex stripCount = (h + stripHeight - 1) / stripHeight;
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(options.getNumThreads())
+#endif
+    {
+        MultiArray<2, Real, FFTWAllocator<Real> > strip, result;
+        FFTWConvolvePlan<2, Real> plan;
+        Shape plannedShape;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for(int s = 0; s < (int)stripCount; ++s)
+        {
+            MultiArrayIndex y0 = s * stripHeight,
+                            y1 = std::min(h, y0 + stripHeight),
+                            e0 = std::max(MultiArrayIndex(0), y0 - halo),
+                            e1 = std::min(h, y1 + halo);
+
+            Shape stripShape(w, e1 - e0);
+            if(strip.shape() != stripShape)
+            {
+                strip.reshape(stripShape);
+                result.reshape(stripShape);
+            }
+
+#ifdef _OPENMP
+#pragma omp critical(vigra_fft_streaming_io)
+#endif
+            {
+                readStrip(e0, e1, static_cast<MultiArrayView<2, Real> &>(strip));
+            }
+
+            if(plannedShape != stripShape)
+            {
+                // FFTW plan creation is not thread-safe
+#ifdef _OPENMP
+#pragma omp critical(vigra_fftw_plan)
+#endif
+                {
+                    plan.init(strip, kernel,
+                              static_cast<MultiArrayView<2, Real> &>(result));
+                }
+                plannedShape = stripShape;
+            }
+
+            plan.execute(strip, kernel,
+                         static_cast<MultiArrayView<2, Real> &>(result));
+
+            MultiArrayView<2, Real> core =
+                result.subarray(Shape(0, y0 - e0), Shape(w, y1 - e0));
+
+#ifdef _OPENMP
+#pragma omp critical(vigra_fft_streaming_io)
+#endif
+            {
+                writeStrip(y0, y1, static_cast<MultiArrayView<2, Real> const &>(core));
+            }
+        }
+    }
+}
+
+/********************************************************/
+/*                                                      */
+/*              convolveImage (dispatched)              */
+/*                                                      */
+/********************************************************/
+
+/** \brief Policy for choosing between spatial and FFT-based 2D convolution.
+
+    Used by the dispatching overloads of \ref convolveImage() declared in this file.
+
+    <DL>
+    <DT><b>CONVOLVE_SPATIAL</b><DD> always convolve in the spatial domain
+                        (equivalent to calling \ref convolveImage() without a policy).
+    <DT><b>CONVOLVE_FFT</b><DD> always convolve via \ref convolveFFT().
+    <DT><b>CONVOLVE_AUTO</b><DD> convolve via \ref convolveFFT() when the kernel has more
+                        than 225 (i.e. 15x15) coefficients and the border treatment is
+                        BORDER_TREATMENT_REFLECT (the boundary condition the FFT path
+                        implements), and in the spatial domain otherwise.
+    </DL>
+*/
+enum ConvolutionMethod
+{
+    CONVOLVE_SPATIAL = 0,
+    CONVOLVE_FFT     = 1,
+    CONVOLVE_AUTO    = 2
+};
+
+/** \brief Perform 2D convolution, choosing between the spatial and FFT algorithms.
+
+    These overloads of \ref convolveImage() extend the spatial-domain convolution
+    from \<vigra/stdconvolution.hxx\> with an algorithm selection policy
+    (see \ref ConvolutionMethod). Spatial convolution is O(width * height * kernel size)
+    and becomes prohibitively slow for large non-separable kernels, whereas the
+    FFT cost is independent of the kernel size. With <tt>CONVOLVE_AUTO</tt>, large
+    kernels are routed through \ref convolveFFT() transparently, so a single call
+    gives the better of the two algorithms.
+
+    The FFT path requires a scalar pixel type and BORDER_TREATMENT_REFLECT
+    (which is the boundary condition used by the internal padding of
+    \ref convolveFFT()); the results then agree with the spatial algorithm up to
+    floating-point round-off. Requesting <tt>CONVOLVE_FFT</tt> with a different
+    border treatment is a precondition violation.
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/multi_fft.hxx\><br>
+    Namespace: vigra
+
+    \code
+    vigra::FImage src(w,h), dest(w,h);
+    vigra::Kernel2D<float> largeKernel;
+    ...                                   // init a large non-separable kernel,
+                                          // border treatment BORDER_TREATMENT_REFLECT
+
+    // let the library choose the faster algorithm
+    vigra::convolveImage(srcImageRange(src), destImage(dest),
+                         kernel2d(largeKernel), vigra::CONVOLVE_AUTO);
+    \endcode
+*/
+doxygen_overloaded_function(template <...> void convolveImage)
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor,
+          class KernelIterator, class KernelAccessor>
+void convolveImage(SrcIterator src_ul, SrcIterator src_lr, SrcAccessor src_acc,
+                   DestIterator dest_ul, DestAccessor dest_acc,
+                   KernelIterator ki, KernelAccessor ak,
+                   Diff2D kul, Diff2D klr, BorderTreatmentMode border,
+                   ConvolutionMethod method)
+{
+    int kernel_width  = klr.x - kul.x + 1;
+    int kernel_height = klr.y - kul.y + 1;
+
+    bool useFFT = (method == CONVOLVE_FFT) ||
+                  (method == CONVOLVE_AUTO &&
+                   kernel_width * kernel_height > 225 &&
+                   border == BORDER_TREATMENT_REFLECT);
+
+    if(!useFFT)
+    {
+        convolveImage(src_ul, src_lr, src_acc, dest_ul, dest_acc,
+                      ki, ak, kul, klr, border);
+        return;
+    }
+
+    vigra_precondition(border == BORDER_TREATMENT_REFLECT,
+        "convolveImage(): FFT-based convolution requires BORDER_TREATMENT_REFLECT.");
+    vigra_precondition(kul.x <= 0 && kul.y <= 0,
+                       "convolveImage(): coordinates of "
+                       "kernel's upper left must be <= 0.");
+    vigra_precondition(klr.x >= 0 && klr.y >= 0,
+                       "convolveImage(): coordinates of "
+                       "kernel's lower right must be >= 0.");
+
+    typedef typename DestAccessor::value_type DestType;
+    typedef typename MultiArrayShape<2>::type Shape;
+
+    int w = src_lr.x - src_ul.x;
+    int h = src_lr.y - src_ul.y;
+
+    vigra_precondition(w >= std::max(klr.x, -kul.x) + 1 && h >= std::max(klr.y, -kul.y) + 1,
+                       "convolveImage(): kernel larger than image.");
+
+    MultiArray<2, double> in(Shape(w, h)),
+                          out(Shape(w, h));
+
+    SrcIterator ys = src_ul;
+    for(int y = 0; y < h; ++y, ++ys.y)
+    {
+        typename SrcIterator::row_iterator xs = ys.rowIterator();
+        for(int x = 0; x < w; ++x, ++xs)
+            in(x, y) = src_acc(xs);
+    }
+
+    // embed the kernel in a symmetric array so that its origin
+    // ends up at floor(shape / 2), as convolveFFT() expects
+    int rx = std::max(klr.x, -kul.x);
+    int ry = std::max(klr.y, -kul.y);
+
+    MultiArray<2, double> kernel(Shape(2*rx + 1, 2*ry + 1));
+    for(int yk = kul.y; yk <= klr.y; ++yk)
+        for(int xk = kul.x; xk <= klr.x; ++xk)
+            kernel(rx + xk, ry + yk) = ak(ki + Diff2D(xk, yk));
+
+    convolveFFT(MultiArrayView<2, double>(in),
+                MultiArrayView<2, double>(kernel),
+                MultiArrayView<2, double>(out));
+
+    DestIterator yd = dest_ul;
+    for(int y = 0; y < h; ++y, ++yd.y)
+    {
+        typename DestIterator::row_iterator xd = yd.rowIterator();
+        for(int x = 0; x < w; ++x, ++xd)
+            dest_acc.set(detail::RequiresExplicitCast<DestType>::cast(out(x, y)), xd);
+    }
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor,
+          class KernelIterator, class KernelAccessor>
+inline void
+convolveImage(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+              pair<DestIterator, DestAccessor> dest,
+              tuple5<KernelIterator, KernelAccessor, Diff2D, Diff2D,
+                     BorderTreatmentMode> kernel,
+              ConvolutionMethod method)
+{
+    convolveImage(src.first, src.second, src.third,
+                  dest.first, dest.second,
+                  kernel.first, kernel.second, kernel.third,
+                  kernel.fourth, kernel.fifth, method);
+}
+
 //@}
 
 } // namespace vigra
@@ -49,6 +49,7 @@
 #include "impex.hxx"
 #include "multi_array.hxx"
 #include "multi_pointoperators.hxx"
+#include "parallel_options.hxx"
 
 #ifdef _MSC_VER
 # include <direct.h>
@@ -162,7 +163,8 @@ class VolumeImportInfo
     VIGRA_EXPORT const std::string &description() const;
 
     template <class T, class Stride>
-    void importImpl(MultiArrayView <3, T, Stride> &volume) const;
+    void importImpl(MultiArrayView <3, T, Stride> &volume,
+                    ParallelOptions const & options = ParallelOptions()) const;
 
   protected:
     void getVolumeInfoFromFirstSlice(const std::string &filename);
@@ -410,7 +412,8 @@ readVolumeImpl(DestIterator d, Shape const & shape, std::ifstream & s, ArrayVect
 } // namespace detail
 
 template <class T, class Stride>
-void VolumeImportInfo::importImpl(MultiArrayView <3, T, Stride> &volume) const
+void VolumeImportInfo::importImpl(MultiArrayView <3, T, Stride> &volume,
+                                  ParallelOptions const & options) const
 {
     vigra_precondition(this->shape() == volume.shape(), "importVolume(): Volume must be shaped according to VolumeImportInfo.");
 
@@ -465,21 +468,47 @@ void VolumeImportInfo::importImpl(MultiArrayView <3, T, Stride> &volume) const
     }
     else
     {
+        // read all slice headers up front - this checks the slice sizes
+        // and initializes the codec manager before any threads are started
+        ArrayVector<ImageImportInfo> infos;
         for (unsigned int i = 0; i < numbers_.size(); ++i)
         {
             // build the filename
             std::string name = baseName_ + numbers_[i] + extension_;
 
-            // import the image
-            ImageImportInfo info (name.c_str ());
-
-            // generate a basic image view to the current layer
-            MultiArrayView <2, T, Stride> view (volume.bindOuter (i));
-            vigra_precondition(view.shape() == info.shape(),
+            infos.push_back(ImageImportInfo (name.c_str ()));
+            vigra_precondition(volume.bindOuter(i).shape() == infos[i].shape(),
                 "importVolume(): the images have inconsistent sizes.");
+        }
 
-            importImage (info, destImage(view));
+        // every slice is decoded into its own layer of the volume, so the
+        // slices can be read concurrently in arbitrary order
+        std::string error;
+        int count = (int)numbers_.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(options.getNumThreads())
+#endif
+        for (int i = 0; i < count; ++i)
+        {
+            try
+            {
+                // generate a basic image view to the current layer
+                MultiArrayView <2, T, Stride> view (volume.bindOuter (i));
+                importImage (infos[i], destImage(view));
+            }
+            catch(std::exception & e)
+            {
+                // exceptions must not escape the parallel region -
+                // remember the first error and report it afterwards
+#ifdef _OPENMP
+#pragma omp critical(vigra_import_volume_error)
+#endif
+                if(error.empty())
+                    error = e.what();
+            }
         }
+        if(!error.empty())
+            vigra_fail(error.c_str());
     }
 }
 
@@ -503,7 +532,9 @@ VIGRA_EXPORT void findImageSequence(const std::string &name_base,
     but can otherwise start anywhere and need not be successive. Slices will be read
     in ascending numerical (not lexicographic) order. All slices must have the
     same size. The <tt>volume</tt> will be reshaped to match the count and
-    size of the slices found.
+    size of the slices found. When \ref vigra::ParallelOptions request more
+    than one thread (and OpenMP is enabled), the slices are decoded in
+    parallel.
 
     <b>\#include</b>
     \<vigra/multi_impex.hxx\>
@@ -513,12 +544,13 @@ VIGRA_EXPORT void findImageSequence(const std::string &name_base,
 template <class T, class Allocator>
 void importVolume (MultiArray <3, T, Allocator> & volume,
                    const std::string &name_base,
-                   const std::string &name_ext)
+                   const std::string &name_ext,
+                   ParallelOptions const & options = ParallelOptions())
 {
     VolumeImportInfo info(name_base, name_ext);
     volume.reshape(info.shape());
 
-    info.importImpl(volume);
+    info.importImpl(volume, options);
 }
 
 
@@ -561,12 +593,13 @@ void importVolume (MultiArray <3, T, Allocator> & volume,
 */
 template <class T, class Allocator>
 void importVolume(MultiArray <3, T, Allocator> &volume,
-                  const std::string &filename)
+                  const std::string &filename,
+                  ParallelOptions const & options = ParallelOptions())
 {
     VolumeImportInfo info(filename);
     volume.reshape(info.shape());
 
-    info.importImpl(volume);
+    info.importImpl(volume, options);
 }
 
 /** \brief Function for importing a 3D volume.
@@ -575,7 +608,9 @@ void importVolume(MultiArray <3, T, Allocator> &volume,
     of the info object allows to allocate a <tt>volume</tt> object type whose
     <tt>value_type</tt> matches the voxel type of the stored data.
     The <tt>volume</tt> will be reshaped to match the count and
-    size of the slices found.
+    size of the slices found. When \ref vigra::ParallelOptions request more
+    than one thread (and OpenMP is enabled), the slices are decoded in
+    parallel.
 
     <b>\#include</b>
     \<vigra/multi_impex.hxx\>
@@ -583,9 +618,10 @@ void importVolume(MultiArray <3, T, Allocator> &volume,
     Namespace: vigra
 */
 template <class T, class Stride>
-void importVolume(VolumeImportInfo const & info, MultiArrayView <3, T, Stride> &volume)
+void importVolume(VolumeImportInfo const & info, MultiArrayView <3, T, Stride> &volume,
+                  ParallelOptions const & options = ParallelOptions())
 {
-    info.importImpl(volume);
+    info.importImpl(volume, options);
 }
 
 namespace detail {
@@ -674,6 +710,9 @@ void setRangeMapping(MultiArrayView <3, T, Tag> const & volume,
     (the actual number of zeros depends on the depth). If the target image type
     does not support the source voxel type, all slices will be mapped simultaneously
     to the appropriate target range.
+    When \ref vigra::ParallelOptions request more than one thread (and OpenMP
+    is enabled), the slices are encoded and written in parallel; this is
+    particularly effective with per-slice compression.
 
     <b>\#include</b>
     \<vigra/multi_impex.hxx\>
@@ -682,7 +721,8 @@ void setRangeMapping(MultiArrayView <3, T, Tag> const & volume,
 */
 template <class T, class Tag>
 void exportVolume (MultiArrayView <3, T, Tag> const & volume,
-                   const VolumeExportInfo & volinfo)
+                   const VolumeExportInfo & volinfo,
+                   ParallelOptions const & options = ParallelOptions())
 {
     std::string name = std::string(volinfo.getFileNameBase()) + std::string(volinfo.getFileNameExt());
     ImageExportInfo info(name.c_str());
@@ -690,35 +730,65 @@ void exportVolume (MultiArrayView <3, T, Tag> const & volume,
     info.setPixelType(volinfo.getPixelType());
     detail::setRangeMapping(volume, info, typename NumericTraits<T>::isScalar());
 
-    const unsigned int depth = volume.shape (2);
+    const int depth = volume.shape (2);
     int numlen = static_cast <int> (std::ceil (std::log10 ((double)depth)));
-    for (unsigned int i = 0; i < depth; ++i)
-    {
 
-        // build the filename
-        std::stringstream stream;
-        stream << std::setfill ('0') << std::setw (numlen) << i;
-        std::string name_num;
-        stream >> name_num;
-        std::string name = std::string(volinfo.getFileNameBase()) + name_num + std::string(volinfo.getFileNameExt());
+#ifdef _OPENMP
+    // make sure the codec manager singleton is created before
+    // the worker threads use it
+    getEncoderType(name, "undefined");
+#endif
 
-        MultiArrayView <2, T, Tag> view (volume.bindOuter (i));
+    // each slice goes into its own file, so the slices can be
+    // encoded in any order; exceptions must not leave the OpenMP
+    // region and are re-raised afterwards
+    std::string errorMessage;
 
-        // export the image
-        info.setFileName(name.c_str ());
-        exportImage(srcImageRange(view), info); 
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(options.getNumThreads())
+#endif
+    for (int i = 0; i < depth; ++i)
+    {
+        try
+        {
+            // build the filename
+            std::stringstream stream;
+            stream << std::setfill ('0') << std::setw (numlen) << i;
+            std::string name_num;
+            stream >> name_num;
+            std::string name = std::string(volinfo.getFileNameBase()) + name_num + std::string(volinfo.getFileNameExt());
+
+            MultiArrayView <2, T, Tag> view (volume.bindOuter (i));
+
+            // export the image
+            ImageExportInfo slice_info(info);
+            slice_info.setFileName(name.c_str ());
+            exportImage(srcImageRange(view), slice_info);
+        }
+        catch (std::exception & e)
+        {
+#ifdef _OPENMP
+#pragma omp critical(vigra_export_volume_error)
+#endif
+            if (errorMessage.empty())
+                errorMessage = e.what();
+        }
     }
+
+    if (!errorMessage.empty())
+        vigra_fail(errorMessage.c_str());
 }
 
 // for backward compatibility
 template <class T, class Tag>
-inline 
+inline
 void exportVolume (MultiArrayView <3, T, Tag> const & volume,
                    const std::string &name_base,
-                   const std::string &name_ext)
+                   const std::string &name_ext,
+                   ParallelOptions const & options = ParallelOptions())
 {
     VolumeExportInfo volinfo(name_base.c_str(), name_ext.c_str());
-    exportVolume(volume, volinfo);
+    exportVolume(volume, volinfo, options);
 }
 
 //@}
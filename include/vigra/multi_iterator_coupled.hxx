@@ -124,18 +124,42 @@ public:
     }
 
     template<int DIMENSION>
-    inline void increment() 
+    inline void increment()
     {
         pointer_ += strides_[DIMENSION];
         base_type::template increment<DIMENSION>();
     }
-    
+
     template<int DIMENSION>
-    inline void decrement() 
+    inline void decrement()
     {
         pointer_ -= strides_[DIMENSION];
         base_type::template decrement<DIMENSION>();
     }
+
+    // true when the strides are the canonical scan-order strides for
+    // the common shape, i.e. consecutive scan-order positions are
+    // consecutive in memory (singleton dimensions are ignored)
+    bool isUnstrided() const
+    {
+        shape_type const & sh = this->shape();
+        MultiArrayIndex stride = 1;
+        for(unsigned int k = 0; k < dimensions; ++k)
+        {
+            if(sh[k] > 1 && strides_[k] != stride)
+                return false;
+            stride *= sh[k];
+        }
+        return base_type::isUnstrided();
+    }
+
+    // advance to the next scan-order position by a unit-stride pointer
+    // bump; only valid when isUnstrided() is true
+    inline void incrementContiguous()
+    {
+        ++pointer_;
+        base_type::incrementContiguous();
+    }
     
     // TODO: test if making the above a default case of the this hurts performance
     template<int DIMENSION>
@@ -264,7 +288,29 @@ public:
         scanOrderIndex_ = 0;
     }
 
-    inline void incrementIndex() 
+    bool isUnstrided() const
+    {
+        return true;
+    }
+
+    // advance point and scan-order index to the next scan-order position;
+    // the carry into the higher dimensions is rare, so this is cheaper
+    // than the per-dimension checks of CoupledScanOrderIterator::operator++()
+    inline void incrementContiguous()
+    {
+        ++scanOrderIndex_;
+        ++point_[0];
+        if(point_[0] == shape_[0])
+        {
+            for(int k = 0; k < (int)N-1 && point_[k] == shape_[k]; ++k)
+            {
+                point_[k] = 0;
+                ++point_[k+1];
+            }
+        }
+    }
+
+    inline void incrementIndex()
     {
         ++scanOrderIndex_;
     }
@@ -407,6 +453,25 @@ public:
         base_type::template decrement<DIMENSION>(offset);
     }
     
+    bool isUnstrided() const
+    {
+        shape_type const & sh = this->shape();
+        MultiArrayIndex stride = 1;
+        for(unsigned int k = 0; k < dimensions; ++k)
+        {
+            if(sh[k] > 1 && strides_[k] != stride)
+                return false;
+            stride *= sh[k];
+        }
+        return base_type::isUnstrided();
+    }
+
+    inline void incrementContiguous()
+    {
+        ++view_.unsafePtr();
+        base_type::incrementContiguous();
+    }
+
     void restrictToSubarray(shape_type const & start, shape_type const & end)
     {
         view_.unsafePtr() += dot(start, strides_);
@@ -733,6 +798,8 @@ class CoupledScanOrderIterator
     using base_type::atBorder;
     using base_type::neighborhoodType;
     using base_type::get;
+    using base_type::isUnstrided;
+    using base_type::incrementContiguous;
 
 #ifdef DOXYGEN
   
@@ -955,6 +1022,28 @@ class CoupledScanOrderIterator<N, HANDLES, 0>
         return operator+(prod(shape()));
     }
 
+        /** Whether all coupled arrays have canonical scan-order strides,
+            so that consecutive scan-order positions are consecutive in
+            memory for every array. Algorithms use this to dispatch to a
+            fused 1-D loop via incrementContiguous() (see e.g.
+            acc::extractFeatures()).
+        */
+    bool isUnstrided() const
+    {
+        return handles_.isUnstrided();
+    }
+
+        /** Advance to the next scan-order position by a unit-stride
+            pointer bump in every coupled array, skipping the
+            per-dimension carry logic of operator++(). Only valid when
+            isUnstrided() returned true; coordinates and the scan-order
+            index remain exact.
+        */
+    void incrementContiguous()
+    {
+        handles_.incrementContiguous();
+    }
+
     bool atBorder() const
     {
         return (handles_.neighborhoodType() != 0);
@@ -40,6 +40,7 @@
 #include "tinyvector.hxx"
 #include "rgbvalue.hxx"
 #include "mathutil.hxx"
+#include "parallel_options.hxx"
 #include <complex>
 
 namespace vigra {
@@ -80,14 +81,36 @@ namespace vigra {
     \code
     double s = sum<double>(i);  // compute the sum of the elements, using 'double' as accumulator type
     double p = product<double>(abs(i));  // compute the product of the elements' absolute values
-    
+
+    double mi = minimum<double>(i);  // the smallest element
+    double ma = maximum<double>(abs(i - j));  // the largest absolute difference
+
     bool a = any(i < 0.0);  // check if any element of i is negative
     bool b = all(i > 0.0);  // check if all elements of i are positive
     \endcode
-    
+    The reductions evaluate the expression in a single fused pass without creating
+    a temporary array. <tt>sum</tt>, <tt>product</tt>, <tt>minimum</tt>, and
+    <tt>maximum</tt> also accept a \ref vigra::ParallelOptions argument to
+    distribute the pass over several threads:
+    \code
+    double e = sum<double>(abs(i - j), ParallelOptions().numThreads(4));
+    \endcode
+
+    Coordinate-dependent expressions can be formed with the lazy coordinate grids
+    \ref vigra::multi_math::meshGrid() "meshGrid()" and
+    \ref vigra::multi_math::coordinate() "coordinate()", which generate the
+    coordinates on the fly instead of storing them in an array:
+    \code
+    // distance of every pixel from the point (50, 50)
+    h = norm(meshGrid<2>() - Shape2(50, 50));
+    \endcode
+
     Expressions are expanded so that no temporary arrays have to be created. To optimize cache locality,
-    loops are executed in the stride ordering of the left-hand-side array.
-    
+    loops are executed in the stride ordering of the left-hand-side array. When the left-hand side and
+    all arrays in the expression are unstrided and have identical shape, the entire expression is
+    evaluated in a single flat loop over the scan-order index, which enables auto-vectorization by
+    the compiler.
+
     <b>\#include</b> \<vigra/multi_math.hxx\>
 
     Namespace: vigra::multi_math
@@ -140,7 +163,15 @@ struct MultiMathOperand
     {
         return arg_[s];
     }
-    
+
+    // check if all arrays in the expression are unstrided with the given shape,
+    // so that the expression can be evaluated by a flat scan-order index
+    template <class SHAPE>
+    bool isUnstrided(SHAPE const & s) const
+    {
+        return arg_.isUnstrided(s);
+    }
+
     ARG arg_;
 };
 
@@ -192,7 +223,32 @@ struct MultiMathOperand<MultiArrayView<N, T, C> >
     {
         return p_[dot(s, strides_)];
     }
-    
+
+    // get the value of the array at the given scan-order index
+    // (only valid when isUnstrided() returned true)
+    T const & operator[](MultiArrayIndex i) const
+    {
+        return p_[i];
+    }
+
+    // Check if the array can be accessed by a flat scan-order index,
+    // i.e. if it has the given shape and consecutive memory layout
+    // (singleton axes may carry arbitrary strides because they never
+    // contribute to the element address).
+    bool isUnstrided(Shape const & s) const
+    {
+        if(shape_ != s)
+            return false;
+        MultiArrayIndex stride = 1;
+        for(unsigned int k=0; k<N; ++k)
+        {
+            if(shape_[k] > 1 && strides_[k] != stride)
+                return false;
+            stride *= shape_[k];
+        }
+        return true;
+    }
+
     void inc(unsigned int axis) const
     {
         p_ += strides_[axis];
@@ -240,7 +296,13 @@ struct MultiMathScalarOperand
     {
         return true;
     }
-    
+
+    template <class SHAPE>
+    bool isUnstrided(SHAPE const &) const
+    {
+        return true;
+    }
+
     template <class SHAPE>
     T const & operator[](SHAPE const &) const
     {
@@ -300,6 +362,205 @@ VIGRA_CONSTANT_OPERAND(VIGRA_RGBVALUE_ARGS, VIGRA_RGBVALUE_DECL)
 
 #undef VIGRA_CONSTANT_OPERAND
 
+// Lazy coordinate grid. The operand evaluates to the N-dimensional index
+// of the current element, so that coordinate-dependent expressions (e.g.
+// distance-from-center masks) can be computed on the fly without ever
+// materializing the coordinate arrays. Like a scalar, a coordinate grid
+// has no intrinsic shape - it adapts to the shape of the other operands
+// resp. the left-hand side. See meshGrid() and coordinate() below.
+template <unsigned int N>
+struct MultiMathCoordinateOperand
+{
+    typedef typename MultiArrayShape<N>::type Shape;
+    typedef Shape result_type;
+
+    static const int ndim = (int)N;
+
+    MultiMathCoordinateOperand()
+    : point_(),
+      shape_(0)
+    {}
+
+    bool checkShape(Shape & s) const
+    {
+        // remember the expression shape for flat scan-order access
+        // (it lives in the caller's scope throughout the evaluation)
+        shape_ = &s;
+        return true;
+    }
+
+    bool isUnstrided(Shape const &) const
+    {
+        // Report 'strided' so that coordinate expressions are evaluated by
+        // the coordinate-tracking algorithm, where inc() and reset() are
+        // mere integer increments. Recovering coordinates from a flat
+        // scan-order index would require two divisions per element.
+        return false;
+    }
+
+    Shape operator[](Shape const & s) const
+    {
+        return point_ + s;
+    }
+
+    // scan-order access (used by expressions that were evaluated in
+    // flat mode before a coordinate operand was appended, cf. isUnstrided())
+    Shape operator[](MultiArrayIndex i) const
+    {
+        Shape res;
+        for(unsigned int k=0; k<N; ++k)
+        {
+            res[k] = i % (*shape_)[k];
+            i /= (*shape_)[k];
+        }
+        return res;
+    }
+
+    void inc(unsigned int axis) const
+    {
+        ++point_[axis];
+    }
+
+    void reset(unsigned int axis) const
+    {
+        point_[axis] = 0;
+    }
+
+    result_type operator*() const
+    {
+        return point_;
+    }
+
+    mutable Shape point_;
+    mutable Shape const * shape_;
+};
+
+// Lazy coordinate grid for a single axis, evaluating to the scalar index
+// of the current element along that axis (see coordinate() below).
+template <unsigned int N>
+struct MultiMathCoordinateAxisOperand
+{
+    typedef typename MultiArrayShape<N>::type Shape;
+    typedef MultiArrayIndex result_type;
+
+    static const int ndim = (int)N;
+
+    explicit MultiMathCoordinateAxisOperand(unsigned int axis)
+    : axis_(axis),
+      coord_(0),
+      shape_(0)
+    {
+        vigra_precondition(axis < N,
+            "coordinate(): axis out of range.");
+    }
+
+    bool checkShape(Shape & s) const
+    {
+        shape_ = &s;
+        return true;
+    }
+
+    bool isUnstrided(Shape const &) const
+    {
+        return false;
+    }
+
+    result_type operator[](Shape const & s) const
+    {
+        return coord_ + s[axis_];
+    }
+
+    result_type operator[](MultiArrayIndex i) const
+    {
+        for(unsigned int k=0; k<axis_; ++k)
+            i /= (*shape_)[k];
+        return i % (*shape_)[axis_];
+    }
+
+    void inc(unsigned int axis) const
+    {
+        if(axis == axis_)
+            ++coord_;
+    }
+
+    void reset(unsigned int axis) const
+    {
+        if(axis == axis_)
+            coord_ = 0;
+    }
+
+    result_type operator*() const
+    {
+        return coord_;
+    }
+
+    unsigned int axis_;
+    mutable MultiArrayIndex coord_;
+    mutable Shape const * shape_;
+};
+
+/** \brief Create a lazy coordinate grid for use in multi_math expressions.
+
+    The expression <tt>meshGrid&lt;N&gt;()</tt> acts like an N-dimensional array
+    whose element at index <tt>(x, y, ...)</tt> is the coordinate vector
+    <tt>Shape(x, y, ...)</tt>, but no coordinates are ever stored - they are
+    generated on the fly while the expression is evaluated. The grid adapts
+    to the shape of the other operands in the expression (or of the
+    left-hand-side array, if the expression contains no array at all).
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/multi_math.hxx\><br>
+    Namespace: vigra::multi_math
+
+    \code
+    using namespace vigra::multi_math;
+
+    MultiArray<2, float> window(Shape2(w, h));
+    TinyVector<double, 2> center((w-1)/2.0, (h-1)/2.0);
+
+    // Gaussian window around the image center, computed without
+    // materializing any coordinate arrays
+    window = exp(-0.01*squaredNorm(meshGrid<2>() - center));
+    \endcode
+*/
+template <unsigned int N>
+inline MultiMathOperand<MultiMathCoordinateOperand<N> >
+meshGrid()
+{
+    typedef MultiMathCoordinateOperand<N> OP;
+    return MultiMathOperand<OP>(OP());
+}
+
+/** \brief Create a lazy coordinate grid for a single axis.
+
+    The expression <tt>coordinate&lt;N&gt;(axis)</tt> acts like an N-dimensional
+    array whose elements equal their own index along the given axis (the
+    scalar counterpart of \ref vigra::multi_math::meshGrid()). It is useful
+    for anisotropic coordinate expressions, e.g. separable window functions:
+
+    \code
+    using namespace vigra::multi_math;
+
+    MultiArray<2, float> window(Shape2(w, h));
+
+    window = cos_pi((coordinate<2>(0) - (w-1)/2.0) / w) *
+             cos_pi((coordinate<2>(1) - (h-1)/2.0) / h);
+    \endcode
+
+    A precondition exception is thrown when <tt>axis &gt;= N</tt>.
+
+    <b>\#include</b> \<vigra/multi_math.hxx\><br>
+    Namespace: vigra::multi_math
+*/
+template <unsigned int N>
+inline MultiMathOperand<MultiMathCoordinateAxisOperand<N> >
+coordinate(unsigned int axis)
+{
+    typedef MultiMathCoordinateAxisOperand<N> OP;
+    return MultiMathOperand<OP>(OP(axis));
+}
+
 template <class O, class F>
 struct MultiMathUnaryOperator
 {
@@ -316,7 +577,13 @@ struct MultiMathUnaryOperator
     {
         return o_.checkShape(s);
     }
-    
+
+    template <class SHAPE>
+    bool isUnstrided(SHAPE const & s) const
+    {
+        return o_.isUnstrided(s);
+    }
+
     //
     void inc(unsigned int axis) const
     {
@@ -470,7 +737,13 @@ struct MultiMathBinaryOperator
     {
         return o1_.checkShape(s) && o2_.checkShape(s);
     }
-    
+
+    template <class SHAPE>
+    bool isUnstrided(SHAPE const & s) const
+    {
+        return o1_.isUnstrided(s) && o2_.isUnstrided(s);
+    }
+
     template <class POINT>
     result_type operator[](POINT const & p) const
     {
@@ -718,6 +991,22 @@ struct MultiMathExec<1, Assign>
     }
 };
 
+// Evaluate the expression via a single scan-order index when the LHS and
+// all RHS arrays are unstrided and have identical shape. The simple loop
+// avoids the per-axis pointer bookkeeping of MultiMathExec and can be
+// auto-vectorized by the compiler. The traversal order (and thus the
+// result) is exactly the same as in the general algorithm.
+template <class Assign>
+struct MultiMathFlatExec
+{
+    template <class T, class Expression>
+    static void exec(T * data, MultiArrayIndex size, Expression const & e)
+    {
+        for(MultiArrayIndex i=0; i<size; ++i)
+            Assign::assign(data + i, e, i);
+    }
+};
+
 #define VIGRA_MULTIMATH_ASSIGN(NAME, OP) \
 struct MultiMath##NAME \
 { \
@@ -726,6 +1015,12 @@ struct MultiMath##NAME \
     { \
         *data OP vigra::detail::RequiresExplicitCast<T>::cast(*e); \
     } \
+     \
+    template <class T, class Expression> \
+    static void assign(T * data, Expression const & e, MultiArrayIndex i) \
+    { \
+        *data OP vigra::detail::RequiresExplicitCast<T>::cast(e[i]); \
+    } \
 }; \
  \
 template <unsigned int N, class T, class C, class Expression> \
@@ -736,8 +1031,11 @@ void NAME(MultiArrayView<N, T, C> a, MultiMathOperand<Expression> const & e) \
     vigra_precondition(e.checkShape(shape), \
        "multi_math: shape mismatch in expression."); \
         \
-    MultiMathExec<N, MultiMath##NAME>::exec(a.data(), a.shape(), a.stride(), \
-                                            a.strideOrdering(), e); \
+    if(a.isUnstrided() && e.isUnstrided(a.shape())) \
+        MultiMathFlatExec<MultiMath##NAME>::exec(a.data(), a.size(), e); \
+    else \
+        MultiMathExec<N, MultiMath##NAME>::exec(a.data(), a.shape(), a.stride(), \
+                                                a.strideOrdering(), e); \
 } \
  \
 template <unsigned int N, class T, class A, class Expression> \
@@ -751,8 +1049,11 @@ void NAME##OrResize(MultiArray<N, T, A> & a, MultiMathOperand<Expression> const
     if(a.size() == 0) \
         a.reshape(shape); \
          \
-    MultiMathExec<N, MultiMath##NAME>::exec(a.data(), a.shape(), a.stride(), \
-                                            a.strideOrdering(), e); \
+    if(e.isUnstrided(a.shape())) \
+        MultiMathFlatExec<MultiMath##NAME>::exec(a.data(), a.size(), e); \
+    else \
+        MultiMathExec<N, MultiMath##NAME>::exec(a.data(), a.shape(), a.stride(), \
+                                                a.strideOrdering(), e); \
 }
 
 VIGRA_MULTIMATH_ASSIGN(assign, =)
@@ -795,6 +1096,52 @@ struct MultiMathReduce<1, Assign>
     }
 };
 
+// Scan-order counterpart of MultiMathReduce for unstrided expressions,
+// analogous to MultiMathFlatExec. Elements are visited in the same order
+// as in the general algorithm, so the result is identical.
+template <class Assign>
+struct MultiMathFlatReduce
+{
+    template <class T, class Expression>
+    static void exec(T & t, MultiArrayIndex size, Expression const & e)
+    {
+        for(MultiArrayIndex i=0; i<size; ++i)
+            Assign::assign(&t, e, i);
+    }
+};
+
+#ifdef _OPENMP
+// Parallel counterpart of MultiMathFlatReduce: split the scan-order index
+// range into one contiguous chunk per thread, reduce each chunk into a
+// per-thread partial result (initialized with the reduction's neutral
+// element), and finally combine the partials with the same functor. The
+// expression is only read via the const index operator, so it can safely
+// be shared among the threads.
+template <class Assign>
+struct MultiMathParallelFlatReduce
+{
+    template <class T, class Expression>
+    static void exec(T & t, MultiArrayIndex size, Expression const & e,
+                     T const & neutral, int numThreads)
+    {
+        ArrayVector<T> partial((std::size_t)numThreads, neutral);
+        #pragma omp parallel num_threads(numThreads)
+        {
+            int threads = omp_get_num_threads(),
+                threadIndex = omp_get_thread_num();
+            MultiArrayIndex begin = size * threadIndex / threads,
+                            end   = size * (threadIndex + 1) / threads;
+            T res = neutral;
+            for(MultiArrayIndex i = begin; i < end; ++i)
+                Assign::assign(&res, e, i);
+            partial[threadIndex] = res;
+        }
+        for(MultiArrayIndex k = 0; k < (MultiArrayIndex)partial.size(); ++k)
+            Assign::assign(&t, partial, k);
+    }
+};
+#endif // _OPENMP
+
 struct MultiMathReduceAll
 {
     template <class T, class Expression>
@@ -802,6 +1149,12 @@ struct MultiMathReduceAll
     {
         *data = *data && (*e != NumericTraits<typename Expression::result_type>::zero());
     }
+
+    template <class T, class Expression>
+    static void assign(T * data, Expression const & e, MultiArrayIndex i)
+    {
+        *data = *data && (e[i] != NumericTraits<typename Expression::result_type>::zero());
+    }
 };
 
 struct MultiMathReduceAny
@@ -811,6 +1164,50 @@ struct MultiMathReduceAny
     {
         *data = *data || (*e != NumericTraits<typename Expression::result_type>::zero());
     }
+
+    template <class T, class Expression>
+    static void assign(T * data, Expression const & e, MultiArrayIndex i)
+    {
+        *data = *data || (e[i] != NumericTraits<typename Expression::result_type>::zero());
+    }
+};
+
+struct MultiMathReduceMin
+{
+    template <class T, class Expression>
+    static void assign(T * data, Expression const & e)
+    {
+        T v = vigra::detail::RequiresExplicitCast<T>::cast(*e);
+        if(v < *data)
+            *data = v;
+    }
+
+    template <class T, class Expression>
+    static void assign(T * data, Expression const & e, MultiArrayIndex i)
+    {
+        T v = vigra::detail::RequiresExplicitCast<T>::cast(e[i]);
+        if(v < *data)
+            *data = v;
+    }
+};
+
+struct MultiMathReduceMax
+{
+    template <class T, class Expression>
+    static void assign(T * data, Expression const & e)
+    {
+        T v = vigra::detail::RequiresExplicitCast<T>::cast(*e);
+        if(*data < v)
+            *data = v;
+    }
+
+    template <class T, class Expression>
+    static void assign(T * data, Expression const & e, MultiArrayIndex i)
+    {
+        T v = vigra::detail::RequiresExplicitCast<T>::cast(e[i]);
+        if(*data < v)
+            *data = v;
+    }
 };
 
 
@@ -823,17 +1220,53 @@ sum(MultiMathOperand<T> const & v, U res = NumericTraits<U>::zero())
     static const int ndim = MultiMathOperand<T>::ndim;
     typename MultiArrayShape<ndim>::type shape;
     v.checkShape(shape);
-    detail::MultiMathReduce<ndim, detail::MultiMathplusAssign>::exec(res, shape, v);
+    if(v.isUnstrided(shape))
+        detail::MultiMathFlatReduce<detail::MultiMathplusAssign>::exec(res, prod(shape), v);
+    else
+        detail::MultiMathReduce<ndim, detail::MultiMathplusAssign>::exec(res, shape, v);
     return res;
 }
 
 template <class U, unsigned int N, class T, class S>
 U
-sum(MultiArrayView<N, T, S> const & v, U res = NumericTraits<U>::zero()) 
-{ 
+sum(MultiArrayView<N, T, S> const & v, U res = NumericTraits<U>::zero())
+{
     return v.template sum<U>() + res;
 }
 
+// Parallel variant: unstrided expressions are reduced in one contiguous
+// chunk per thread. The order of the additions differs from the serial
+// version, so floating-point results may deviate by rounding errors.
+// Strided expressions fall back to the serial algorithm.
+template <class U, class T>
+U
+sum(MultiMathOperand<T> const & v, ParallelOptions const & options,
+    U res = NumericTraits<U>::zero())
+{
+    static const int ndim = MultiMathOperand<T>::ndim;
+    typename MultiArrayShape<ndim>::type shape;
+    v.checkShape(shape);
+#ifdef _OPENMP
+    if(v.isUnstrided(shape) && options.getNumThreads() > 1)
+    {
+        detail::MultiMathParallelFlatReduce<detail::MultiMathplusAssign>::exec(
+            res, prod(shape), v, NumericTraits<U>::zero(), (int)options.getNumThreads());
+        return res;
+    }
+#else
+    (void)options;
+#endif
+    return sum(v, res);
+}
+
+template <class U, unsigned int N, class T, class S>
+U
+sum(MultiArrayView<N, T, S> const & v, ParallelOptions const & options,
+    U res = NumericTraits<U>::zero())
+{
+    return sum(MultiMathOperand<MultiArrayView<N, T, S> >(v), options, res);
+}
+
 template <class U, class T>
 U
 product(MultiMathOperand<T> const & v, U res = NumericTraits<U>::one()) 
@@ -841,17 +1274,158 @@ product(MultiMathOperand<T> const & v, U res = NumericTraits<U>::one())
     static const int ndim = MultiMathOperand<T>::ndim;
     typename MultiArrayShape<ndim>::type shape;
     v.checkShape(shape);
-    detail::MultiMathReduce<ndim, detail::MultiMathmultiplyAssign>::exec(res, shape, v);
+    if(v.isUnstrided(shape))
+        detail::MultiMathFlatReduce<detail::MultiMathmultiplyAssign>::exec(res, prod(shape), v);
+    else
+        detail::MultiMathReduce<ndim, detail::MultiMathmultiplyAssign>::exec(res, shape, v);
     return res;
 }
 
 template <class U, unsigned int N, class T, class S>
 U
-product(MultiArrayView<N, T, S> const & v, U res = NumericTraits<U>::one()) 
-{ 
+product(MultiArrayView<N, T, S> const & v, U res = NumericTraits<U>::one())
+{
     return v.template product<U>() * res;
 }
 
+// Parallel variant, see the parallel sum() for the details.
+template <class U, class T>
+U
+product(MultiMathOperand<T> const & v, ParallelOptions const & options,
+        U res = NumericTraits<U>::one())
+{
+    static const int ndim = MultiMathOperand<T>::ndim;
+    typename MultiArrayShape<ndim>::type shape;
+    v.checkShape(shape);
+#ifdef _OPENMP
+    if(v.isUnstrided(shape) && options.getNumThreads() > 1)
+    {
+        detail::MultiMathParallelFlatReduce<detail::MultiMathmultiplyAssign>::exec(
+            res, prod(shape), v, NumericTraits<U>::one(), (int)options.getNumThreads());
+        return res;
+    }
+#else
+    (void)options;
+#endif
+    return product(v, res);
+}
+
+template <class U, unsigned int N, class T, class S>
+U
+product(MultiArrayView<N, T, S> const & v, ParallelOptions const & options,
+        U res = NumericTraits<U>::one())
+{
+    return product(MultiMathOperand<MultiArrayView<N, T, S> >(v), options, res);
+}
+
+template <class U, class T>
+U
+minimum(MultiMathOperand<T> const & v)
+{
+    static const int ndim = MultiMathOperand<T>::ndim;
+    typename MultiArrayShape<ndim>::type shape;
+    v.checkShape(shape);
+    U res = NumericTraits<U>::max();
+    if(v.isUnstrided(shape))
+        detail::MultiMathFlatReduce<detail::MultiMathReduceMin>::exec(res, prod(shape), v);
+    else
+        detail::MultiMathReduce<ndim, detail::MultiMathReduceMin>::exec(res, shape, v);
+    return res;
+}
+
+template <class U, unsigned int N, class T, class S>
+U
+minimum(MultiArrayView<N, T, S> const & v)
+{
+    T mi, ma;
+    v.minmax(&mi, &ma);
+    return vigra::detail::RequiresExplicitCast<U>::cast(mi);
+}
+
+// Parallel variant. In contrast to sum() and product(), the result is
+// always identical to the serial version.
+template <class U, class T>
+U
+minimum(MultiMathOperand<T> const & v, ParallelOptions const & options)
+{
+    static const int ndim = MultiMathOperand<T>::ndim;
+    typename MultiArrayShape<ndim>::type shape;
+    v.checkShape(shape);
+#ifdef _OPENMP
+    if(v.isUnstrided(shape) && options.getNumThreads() > 1)
+    {
+        U res = NumericTraits<U>::max();
+        detail::MultiMathParallelFlatReduce<detail::MultiMathReduceMin>::exec(
+            res, prod(shape), v, NumericTraits<U>::max(), (int)options.getNumThreads());
+        return res;
+    }
+#else
+    (void)options;
+#endif
+    return minimum<U>(v);
+}
+
+template <class U, unsigned int N, class T, class S>
+U
+minimum(MultiArrayView<N, T, S> const & v, ParallelOptions const & options)
+{
+    return minimum<U>(MultiMathOperand<MultiArrayView<N, T, S> >(v), options);
+}
+
+template <class U, class T>
+U
+maximum(MultiMathOperand<T> const & v)
+{
+    static const int ndim = MultiMathOperand<T>::ndim;
+    typename MultiArrayShape<ndim>::type shape;
+    v.checkShape(shape);
+    U res = NumericTraits<U>::min();
+    if(v.isUnstrided(shape))
+        detail::MultiMathFlatReduce<detail::MultiMathReduceMax>::exec(res, prod(shape), v);
+    else
+        detail::MultiMathReduce<ndim, detail::MultiMathReduceMax>::exec(res, shape, v);
+    return res;
+}
+
+template <class U, unsigned int N, class T, class S>
+U
+maximum(MultiArrayView<N, T, S> const & v)
+{
+    T mi, ma;
+    v.minmax(&mi, &ma);
+    return vigra::detail::RequiresExplicitCast<U>::cast(ma);
+}
+
+// Parallel variant. In contrast to sum() and product(), the result is
+// always identical to the serial version.
+template <class U, class T>
+U
+maximum(MultiMathOperand<T> const & v, ParallelOptions const & options)
+{
+    static const int ndim = MultiMathOperand<T>::ndim;
+    typename MultiArrayShape<ndim>::type shape;
+    v.checkShape(shape);
+#ifdef _OPENMP
+    if(v.isUnstrided(shape) && options.getNumThreads() > 1)
+    {
+        U res = NumericTraits<U>::min();
+        detail::MultiMathParallelFlatReduce<detail::MultiMathReduceMax>::exec(
+            res, prod(shape), v, NumericTraits<U>::min(), (int)options.getNumThreads());
+        return res;
+    }
+#else
+    (void)options;
+#endif
+    return maximum<U>(v);
+}
+
+template <class U, unsigned int N, class T, class S>
+U
+maximum(MultiArrayView<N, T, S> const & v, ParallelOptions const & options)
+{
+    return maximum<U>(MultiMathOperand<MultiArrayView<N, T, S> >(v), options);
+}
+
 template <class T>
 bool
 all(MultiMathOperand<T> const & v) 
@@ -860,7 +1434,10 @@ all(MultiMathOperand<T> const & v)
     typename MultiArrayShape<ndim>::type shape;
     v.checkShape(shape);
     bool res = true;
-    detail::MultiMathReduce<ndim, detail::MultiMathReduceAll>::exec(res, shape, v);
+    if(v.isUnstrided(shape))
+        detail::MultiMathFlatReduce<detail::MultiMathReduceAll>::exec(res, prod(shape), v);
+    else
+        detail::MultiMathReduce<ndim, detail::MultiMathReduceAll>::exec(res, shape, v);
     return res;
 }
 
@@ -872,7 +1449,10 @@ any(MultiMathOperand<T> const & v)
     typename MultiArrayShape<ndim>::type shape;
     v.checkShape(shape);
     bool res = false;
-    detail::MultiMathReduce<ndim, detail::MultiMathReduceAny>::exec(res, shape, v);
+    if(v.isUnstrided(shape))
+        detail::MultiMathFlatReduce<detail::MultiMathReduceAny>::exec(res, prod(shape), v);
+    else
+        detail::MultiMathReduce<ndim, detail::MultiMathReduceAny>::exec(res, shape, v);
     return res;
 }
 
@@ -39,6 +39,7 @@
 
 #include <vector>
 #include <cmath>
+#include <functional>
 #include "multi_distance.hxx"
 #include "array_vector.hxx"
 #include "multi_array.hxx"
@@ -131,6 +132,126 @@ struct MultiBinaryMorphologyImpl<bool, bool>
     }
 };
 
+/********************************************************/
+/*                                                      */
+/*             vanHerkGilWermanLine                     */
+/*                                                      */
+/********************************************************/
+
+// Running extremum of a flat window (radius r, i.e. size 2r+1) along one
+// line in O(1) per pixel, independent of the radius (van Herk; Gil & Werman).
+// The line is divided into blocks of the window size, and precomputed prefix
+// and suffix extrema of these blocks are combined into the window extremum.
+// Windows reaching beyond the line are clipped to the valid range, so the
+// border is treated as if the structuring element were shrunk there.
+// <compare> selects the operation: std::less => erosion (minimum),
+// std::greater => dilation (maximum).
+template <class T, class Compare>
+void vanHerkGilWermanLine(T const * in, int size, int radius, Compare compare,
+                          T * prefix, T * suffix, T * out)
+{
+    int w = 2*radius + 1;
+    for(int blockStart = 0; blockStart < size; blockStart += w)
+    {
+        int blockEnd = blockStart + w < size
+                          ? blockStart + w
+                          : size;
+        suffix[blockEnd-1] = in[blockEnd-1];
+        for(int i = blockEnd-2; i >= blockStart; --i)
+            suffix[i] = compare(in[i], suffix[i+1]) ? in[i] : suffix[i+1];
+        prefix[blockStart] = in[blockStart];
+        for(int i = blockStart+1; i < blockEnd; ++i)
+            prefix[i] = compare(in[i], prefix[i-1]) ? in[i] : prefix[i-1];
+    }
+    for(int i = 0; i < size; ++i)
+    {
+        int lo = i - radius < 0 ? 0 : i - radius,
+            hi = i + radius > size-1 ? size-1 : i + radius;
+        if(lo / w == hi / w)
+        {
+            // clipped or block-aligned window lying in a single block:
+            // either the block starts at lo (then prefix[hi] is exact)
+            // or it ends at hi (then suffix[lo] is exact)
+            out[i] = lo % w == 0 ? prefix[hi] : suffix[lo];
+        }
+        else
+        {
+            // the window covers a suffix of one block and a prefix of the next
+            out[i] = compare(suffix[lo], prefix[hi]) ? suffix[lo] : prefix[hi];
+        }
+    }
+}
+
+/********************************************************/
+/*                                                      */
+/*           internalMultiFlatMorphology                */
+/*                                                      */
+/********************************************************/
+
+// apply the van Herk / Gil-Werman running extremum separably along every
+// axis, which realizes erosion or dilation with a flat box of the given
+// radius at a cost independent of the radius
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor, class Compare>
+void internalMultiFlatMorphology(SrcIterator si, SrcShape const & shape, SrcAccessor src,
+                                 DestIterator di, DestAccessor dest,
+                                 int radius, Compare compare)
+{
+    enum { N = SrcShape::static_size };
+
+    typedef typename DestAccessor::value_type DestType;
+    typedef MultiArrayNavigator<SrcIterator, N> SNavigator;
+    typedef MultiArrayNavigator<DestIterator, N> DNavigator;
+
+    // temporary line buffers enable in-place operation and hold the
+    // block prefix and suffix extrema of the running extremum filter
+    ArrayVector<DestType> tmp(shape[0]), out(shape[0]),
+                          prefix(shape[0]), suffix(shape[0]);
+
+    // only operate on first dimension here
+    SNavigator snav( si, shape, 0 );
+    DNavigator dnav( di, shape, 0 );
+
+    for( ; snav.hasMore(); snav++, dnav++ )
+    {
+        // first copy source to temp for maximum cache efficiency
+        copyLine( snav.begin(), snav.end(), src, tmp.begin(),
+                  typename AccessorTraits<DestType>::default_accessor() );
+
+        vanHerkGilWermanLine( tmp.begin(), (int)shape[0], radius, compare,
+                              prefix.begin(), suffix.begin(), out.begin() );
+
+        copyLine( out.begin(), out.end(),
+                  typename AccessorTraits<DestType>::default_const_accessor(),
+                  dnav.begin(), dest );
+    }
+
+    // operate on further dimensions
+    for( int d = 1; d < N; ++d )
+    {
+        DNavigator dnav( di, shape, d );
+
+        tmp.resize( shape[d] );
+        out.resize( shape[d] );
+        prefix.resize( shape[d] );
+        suffix.resize( shape[d] );
+
+        for( ; dnav.hasMore(); dnav++ )
+        {
+            // first copy source to temp for maximum cache efficiency
+            copyLine( dnav.begin(), dnav.end(), dest, tmp.begin(),
+                      typename AccessorTraits<DestType>::default_accessor() );
+
+            vanHerkGilWermanLine( tmp.begin(), (int)shape[d], radius, compare,
+                                  prefix.begin(), suffix.begin(), out.begin() );
+
+            copyLine( out.begin(), out.end(),
+                      typename AccessorTraits<DestType>::default_const_accessor(),
+                      dnav.begin(), dest );
+        }
+    }
+}
+
 } // namespace detail
 
 /** \addtogroup MultiArrayMorphology Morphological operators for multi-dimensional arrays.
@@ -572,10 +693,183 @@ void multiGrayscaleDilation(
     triple<SrcIterator, SrcShape, SrcAccessor> const & source,
     pair<DestIterator, DestAccessor> const & dest, double sigma)
 {
-    multiGrayscaleDilation( source.first, source.second, source.third, 
+    multiGrayscaleDilation( source.first, source.second, source.third,
             dest.first, dest.second, sigma);
 }
 
+/********************************************************/
+/*                                                      */
+/*             multiFlatErosion                         */
+/*                                                      */
+/********************************************************/
+/** \brief Flat box erosion on multi-dimensional arrays.
+
+    This function applies a flat erosion operator whose structuring element is
+    an axis-aligned box with half-width <tt>radius</tt> (i.e. side length
+    <tt>2*radius+1</tt>) on a grayscale array. The box is separable, so the
+    operation is computed as a running minimum along every axis in turn, using
+    the algorithm of van Herk and Gil/Werman. The cost is therefore constant
+    per pixel, independent of the radius. Near the array border, the
+    structuring element is clipped to the valid region.
+
+    This function may work in-place, which means that <tt>siter == diter</tt>
+    is allowed.
+
+    <b> Declarations:</b>
+
+    pass arguments explicitly:
+    \code
+    namespace vigra {
+        template <class SrcIterator, class SrcShape, class SrcAccessor,
+                  class DestIterator, class DestAccessor>
+        void
+        multiFlatErosion(SrcIterator siter, SrcShape const & shape, SrcAccessor src,
+                                    DestIterator diter, DestAccessor dest, int radius);
+
+    }
+    \endcode
+
+    use argument objects in conjunction with \ref ArgumentObjectFactories :
+    \code
+    namespace vigra {
+        template <class SrcIterator, class SrcShape, class SrcAccessor,
+                  class DestIterator, class DestAccessor>
+        void
+        multiFlatErosion(triple<SrcIterator, SrcShape, SrcAccessor> const & source,
+                                    pair<DestIterator, DestAccessor> const & dest,
+                                    int radius);
+
+    }
+    \endcode
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/multi_morphology.hxx\>
+
+    \code
+    MultiArray<3, unsigned char>::size_type shape(width, height, depth);
+    MultiArray<3, unsigned char> source(shape);
+    MultiArray<3, unsigned char> dest(shape);
+    ...
+
+    // perform flat erosion with a 7x7x7 box
+    multiFlatErosion(srcMultiArrayRange(source), destMultiArray(dest), 3);
+    \endcode
+
+    \see vigra::multiGrayscaleErosion(), vigra::discErosion()
+*/
+doxygen_overloaded_function(template <...> void multiFlatErosion)
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void multiFlatErosion( SrcIterator s, SrcShape const & shape, SrcAccessor src,
+                       DestIterator d, DestAccessor dest, int radius)
+{
+    vigra_precondition(radius >= 0, "multiFlatErosion(): Radius must be >= 0.");
+
+    typedef typename DestAccessor::value_type DestType;
+
+    detail::internalMultiFlatMorphology( s, shape, src, d, dest, radius,
+                                         std::less<DestType>() );
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline
+void multiFlatErosion(
+    triple<SrcIterator, SrcShape, SrcAccessor> const & source,
+    pair<DestIterator, DestAccessor> const & dest, int radius)
+{
+    multiFlatErosion( source.first, source.second, source.third,
+            dest.first, dest.second, radius);
+}
+
+/********************************************************/
+/*                                                      */
+/*             multiFlatDilation                        */
+/*                                                      */
+/********************************************************/
+/** \brief Flat box dilation on multi-dimensional arrays.
+
+    This function applies a flat dilation operator whose structuring element is
+    an axis-aligned box with half-width <tt>radius</tt> (i.e. side length
+    <tt>2*radius+1</tt>) on a grayscale array. The box is separable, so the
+    operation is computed as a running maximum along every axis in turn, using
+    the algorithm of van Herk and Gil/Werman. The cost is therefore constant
+    per pixel, independent of the radius. Near the array border, the
+    structuring element is clipped to the valid region.
+
+    This function may work in-place, which means that <tt>siter == diter</tt>
+    is allowed.
+
+    <b> Declarations:</b>
+
+    pass arguments explicitly:
+    \code
+    namespace vigra {
+        template <class SrcIterator, class SrcShape, class SrcAccessor,
+                  class DestIterator, class DestAccessor>
+        void
+        multiFlatDilation(SrcIterator siter, SrcShape const & shape, SrcAccessor src,
+                                    DestIterator diter, DestAccessor dest, int radius);
+
+    }
+    \endcode
+
+    use argument objects in conjunction with \ref ArgumentObjectFactories :
+    \code
+    namespace vigra {
+        template <class SrcIterator, class SrcShape, class SrcAccessor,
+                  class DestIterator, class DestAccessor>
+        void
+        multiFlatDilation(triple<SrcIterator, SrcShape, SrcAccessor> const & source,
+                                    pair<DestIterator, DestAccessor> const & dest,
+                                    int radius);
+
+    }
+    \endcode
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/multi_morphology.hxx\>
+
+    \code
+    MultiArray<3, unsigned char>::size_type shape(width, height, depth);
+    MultiArray<3, unsigned char> source(shape);
+    MultiArray<3, unsigned char> dest(shape);
+    ...
+
+    // perform flat dilation with a 7x7x7 box
+    multiFlatDilation(srcMultiArrayRange(source), destMultiArray(dest), 3);
+    \endcode
+
+    \see vigra::multiGrayscaleDilation(), vigra::discDilation()
+*/
+doxygen_overloaded_function(template <...> void multiFlatDilation)
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void multiFlatDilation( SrcIterator s, SrcShape const & shape, SrcAccessor src,
+                        DestIterator d, DestAccessor dest, int radius)
+{
+    vigra_precondition(radius >= 0, "multiFlatDilation(): Radius must be >= 0.");
+
+    typedef typename DestAccessor::value_type DestType;
+
+    detail::internalMultiFlatMorphology( s, shape, src, d, dest, radius,
+                                         std::greater<DestType>() );
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline
+void multiFlatDilation(
+    triple<SrcIterator, SrcShape, SrcAccessor> const & source,
+    pair<DestIterator, DestAccessor> const & dest, int radius)
+{
+    multiFlatDilation( source.first, source.second, source.third,
+            dest.first, dest.second, radius);
+}
 
 //@}
 
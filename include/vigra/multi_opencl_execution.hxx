@@ -0,0 +1,1048 @@
+/************************************************************************/
+/*                                                                      */
+/*               Copyright 2012 by Ullrich Koethe                       */
+/*                                                                      */
+/*    This file is part of the VIGRA computer vision library.           */
+/*    The VIGRA Website is                                              */
+/*        http://hci.iwr.uni-heidelberg.de/vigra/                       */
+/*    Please direct questions, bug reports, and contributions to        */
+/*        ullrich.koethe@iwr.uni-heidelberg.de    or                    */
+/*        vigra@informatik.uni-hamburg.de                               */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+#ifndef VIGRA_MULTI_OPENCL_EXECUTION_HXX
+#define VIGRA_MULTI_OPENCL_EXECUTION_HXX
+
+#include "multi_array.hxx"
+#include "separableconvolution.hxx"
+#include "error.hxx"
+
+#include <map>
+#include <string>
+#include <sstream>
+#include <utility>
+
+    // only the runtime API is needed here; include vigra/multi_opencl.hxx
+    // in addition when the OpenCL vector types shall be used as pixel types
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/opencl.h>
+#endif
+
+namespace vigra {
+
+/** \addtogroup MultiArrayConvolutionFilters
+*/
+//@{
+
+/** \defgroup OpenCLExecution OpenCL execution of multi-array primitives
+
+    Off-load selected multi-array primitives to an OpenCL device:
+    separable convolution (mirroring \ref separableConvolveMultiArray()),
+    element-wise transformations (mirroring \ref transformMultiArray() and
+    \ref combineTwoMultiArrays(), with the operation given as an OpenCL
+    expression string), and flat grayscale morphology.
+
+    All functions use the process-wide \ref OpenCLExecutor, which lazily
+    initializes a context and command queue on the first GPU device it
+    finds (falling back to any device), caches compiled programs by their
+    source text, and recycles device buffer allocations between calls, so
+    repeated filtering of same-sized arrays pays the allocation and
+    compilation costs only once. When no OpenCL device is available,
+    <tt>OpenCLExecutor::global().available()</tt> returns <tt>false</tt>
+    and the algorithms throw a <tt>std::runtime_error</tt>; callers are
+    expected to fall back to the CPU implementations in that case.
+*/
+//@{
+
+namespace detail {
+
+inline void openclCheck(cl_int status, char const * where)
+{
+    if(status != CL_SUCCESS)
+    {
+        std::ostringstream s;
+        s << where << " failed with OpenCL error code " << status << ".";
+        vigra_fail(s.str());
+    }
+}
+
+} // namespace detail
+
+/** \brief Process-wide OpenCL context, program cache, and buffer cache.
+
+    The executor is created on first use via global(). It owns the OpenCL
+    context and in-order command queue, a cache of compiled programs keyed
+    by their source text, and a cache of device buffers keyed by requested
+    size, so that repeated calls with same-sized arrays reuse both the
+    compiled kernels and the device allocations.
+
+    The executor is not thread-safe; serialize access when calling the
+    OpenCL algorithms from several threads.
+*/
+class OpenCLExecutor
+{
+  public:
+
+        /** Access the process-wide executor instance. */
+    static OpenCLExecutor & global()
+    {
+        static OpenCLExecutor executor;
+        return executor;
+    }
+
+        /** True if a device, context, and queue could be initialized. */
+    bool available() const
+    {
+        return available_;
+    }
+
+    cl_context context() const
+    {
+        return context_;
+    }
+
+    cl_command_queue queue() const
+    {
+        return queue_;
+    }
+
+        /** Get a kernel for the given program source, compiling and caching
+            the program on first use. The kernel itself is cached as well,
+            keyed by (source, name). */
+    cl_kernel kernel(std::string const & source, char const * name)
+    {
+        vigra_precondition(available_,
+            "OpenCLExecutor::kernel(): no OpenCL device available.");
+        std::pair<std::string, std::string> key(source, name);
+        KernelCache::iterator k = kernels_.find(key);
+        if(k != kernels_.end())
+            return k->second;
+
+        cl_program program;
+        ProgramCache::iterator p = programs_.find(source);
+        if(p != programs_.end())
+        {
+            program = p->second;
+        }
+        else
+        {
+            cl_int status;
+            char const * text = source.c_str();
+            std::size_t length = source.size();
+            program = clCreateProgramWithSource(context_, 1, &text, &length, &status);
+            detail::openclCheck(status, "clCreateProgramWithSource()");
+            status = clBuildProgram(program, 1, &device_, "", 0, 0);
+            if(status != CL_SUCCESS)
+            {
+                char log[2048];
+                std::size_t logSize = 0;
+                clGetProgramBuildInfo(program, device_, CL_PROGRAM_BUILD_LOG,
+                                      sizeof(log) - 1, log, &logSize);
+                log[logSize < sizeof(log) ? logSize : sizeof(log) - 1] = 0;
+                vigra_fail(std::string("OpenCLExecutor::kernel(): program build failed:\n") + log);
+            }
+            programs_[source] = program;
+        }
+
+        cl_int status;
+        cl_kernel kern = clCreateKernel(program, name, &status);
+        detail::openclCheck(status, "clCreateKernel()");
+        kernels_[key] = kern;
+        return kern;
+    }
+
+        /** Get a device buffer of (at least) the given size, reusing a
+            cached allocation when possible. The slot identifies the role
+            of the buffer within one algorithm call (input, output,
+            temporary, ...), so that a single call can hold several cached
+            buffers of the same size at once. */
+    cl_mem buffer(std::size_t bytes, int slot)
+    {
+        vigra_precondition(available_,
+            "OpenCLExecutor::buffer(): no OpenCL device available.");
+        BufferCache::iterator b = buffers_.find(slot);
+        if(b != buffers_.end())
+        {
+            if(b->second.second >= bytes)
+                return b->second.first;
+            clReleaseMemObject(b->second.first);
+            buffers_.erase(b);
+        }
+        cl_int status;
+        cl_mem mem = clCreateBuffer(context_, CL_MEM_READ_WRITE, bytes, 0, &status);
+        detail::openclCheck(status, "clCreateBuffer()");
+        buffers_[slot] = std::make_pair(mem, bytes);
+        return mem;
+    }
+
+        /** Release all cached device buffers (e.g. to free GPU memory
+            after a batch of large arrays has been processed). */
+    void releaseBuffers()
+    {
+        for(BufferCache::iterator b = buffers_.begin(); b != buffers_.end(); ++b)
+            clReleaseMemObject(b->second.first);
+        buffers_.clear();
+    }
+
+  private:
+
+    OpenCLExecutor()
+    : context_(0),
+      queue_(0),
+      device_(0),
+      available_(false)
+    {
+        cl_platform_id platforms[8];
+        cl_uint platformCount = 0;
+        if(clGetPlatformIDs(8, platforms, &platformCount) != CL_SUCCESS)
+            return;
+        for(cl_uint p = 0; p < platformCount && device_ == 0; ++p)
+        {
+            cl_uint deviceCount = 0;
+            // prefer a GPU, fall back to any device type
+            if(clGetDeviceIDs(platforms[p], CL_DEVICE_TYPE_GPU, 1, &device_, &deviceCount) != CL_SUCCESS ||
+               deviceCount == 0)
+            {
+                device_ = 0;
+                clGetDeviceIDs(platforms[p], CL_DEVICE_TYPE_ALL, 1, &device_, &deviceCount);
+                if(deviceCount == 0)
+                    device_ = 0;
+            }
+        }
+        if(device_ == 0)
+            return;
+        cl_int status;
+        context_ = clCreateContext(0, 1, &device_, 0, 0, &status);
+        if(status != CL_SUCCESS)
+            return;
+        queue_ = clCreateCommandQueue(context_, device_, 0, &status);
+        if(status != CL_SUCCESS)
+        {
+            clReleaseContext(context_);
+            context_ = 0;
+            return;
+        }
+        available_ = true;
+    }
+
+    ~OpenCLExecutor()
+    {
+        releaseBuffers();
+        for(KernelCache::iterator k = kernels_.begin(); k != kernels_.end(); ++k)
+            clReleaseKernel(k->second);
+        for(ProgramCache::iterator p = programs_.begin(); p != programs_.end(); ++p)
+            clReleaseProgram(p->second);
+        if(queue_)
+            clReleaseCommandQueue(queue_);
+        if(context_)
+            clReleaseContext(context_);
+    }
+
+    OpenCLExecutor(OpenCLExecutor const &);             // not implemented
+    OpenCLExecutor & operator=(OpenCLExecutor const &); // not implemented
+
+    typedef std::map<std::string, cl_program> ProgramCache;
+    typedef std::map<std::pair<std::string, std::string>, cl_kernel> KernelCache;
+    typedef std::map<int, std::pair<cl_mem, std::size_t> > BufferCache;
+
+    ProgramCache programs_;
+    KernelCache kernels_;
+    BufferCache buffers_;
+    cl_context context_;
+    cl_command_queue queue_;
+    cl_device_id device_;
+    bool available_;
+};
+
+namespace detail {
+
+enum { OpenCLBufferSource = 0, OpenCLBufferSource2 = 1, OpenCLBufferDest = 2,
+       OpenCLBufferKernel = 3, OpenCLBufferScratch1 = 4, OpenCLBufferScratch2 = 5 };
+
+    // the per-axis 1D pass shared by convolution and flat morphology:
+    // the array is viewed as outer x len x inner (first index fastest,
+    // matching the default MultiArrayView memory order), and every work
+    // item produces one output element with reflecting border treatment
+inline char const * openclSeparablePassSource()
+{
+    return
+    "__kernel void convolve1d(__global const float * src,\n"
+    "                         __global float * dst,\n"
+    "                         __global const float * coef,\n"
+    "                         const int left, const int right,\n"
+    "                         const ulong inner, const ulong len, const ulong outer)\n"
+    "{\n"
+    "    size_t i = get_global_id(0);\n"
+    "    if(i >= inner*len*outer) return;\n"
+    "    size_t in   = i % inner;\n"
+    "    size_t rest = i / inner;\n"
+    "    long   pos  = rest % len;\n"
+    "    size_t out  = rest / len;\n"
+    "    float sum = 0.0f;\n"
+    "    for(int k = left; k <= right; ++k)\n"
+    "    {\n"
+    "        long p = pos + k;\n"
+    "        if(p < 0) p = -p;                        // reflect\n"
+    "        if(p >= (long)len) p = 2*(long)len - 2 - p;\n"
+    "        sum += coef[k - left] * src[(out*len + (size_t)p)*inner + in];\n"
+    "    }\n"
+    "    dst[i] = sum;\n"
+    "}\n"
+    "__kernel void minmax1d(__global const float * src,\n"
+    "                       __global float * dst,\n"
+    "                       const int radius, const int dilate,\n"
+    "                       const ulong inner, const ulong len, const ulong outer)\n"
+    "{\n"
+    "    size_t i = get_global_id(0);\n"
+    "    if(i >= inner*len*outer) return;\n"
+    "    size_t in   = i % inner;\n"
+    "    size_t rest = i / inner;\n"
+    "    long   pos  = rest % len;\n"
+    "    size_t out  = rest / len;\n"
+    "    float extremum = src[(out*len + (size_t)pos)*inner + in];\n"
+    "    for(int k = -radius; k <= radius; ++k)\n"
+    "    {\n"
+    "        long p = pos + k;\n"
+    "        if(p < 0 || p >= (long)len) continue;    // border: shrink window\n"
+    "        float v = src[(out*len + (size_t)p)*inner + in];\n"
+    "        extremum = dilate ? fmax(extremum, v) : fmin(extremum, v);\n"
+    "    }\n"
+    "    dst[i] = extremum;\n"
+    "}\n";
+}
+
+    // run one 1D pass along every axis of a device-resident array; reads
+    // from 'source', writes the final result into 'dest' (which may equal
+    // 'source'), and routes intermediate passes through cached scratch
+    // buffers; 'setExtraArgs' configures the pass-specific kernel
+    // arguments (convolution coefficients or morphology radius)
+template <class Shape, class SetArgs>
+void
+openclSeparablePassDevice(cl_mem source, cl_mem dest, Shape const & shape,
+                          unsigned int N, char const * kernelName,
+                          SetArgs const & setExtraArgs)
+{
+    OpenCLExecutor & exec = OpenCLExecutor::global();
+
+    std::size_t count = 1;
+    for(unsigned int k = 0; k < N; ++k)
+        count *= (std::size_t)shape[k];
+    std::size_t bytes = count * sizeof(float);
+
+    cl_mem scratch[2] = { 0, 0 };
+    cl_kernel kern = exec.kernel(openclSeparablePassSource(), kernelName);
+    cl_mem in = source;
+    for(unsigned int d = 0; d < N; ++d)
+    {
+        cl_mem out;
+        if(d == N - 1)
+        {
+            out = dest;
+        }
+        else
+        {
+            if(scratch[d % 2] == 0)
+                scratch[d % 2] = exec.buffer(bytes, d % 2 == 0 ? (int)OpenCLBufferScratch1
+                                                               : (int)OpenCLBufferScratch2);
+            out = scratch[d % 2];
+        }
+
+        cl_ulong inner = 1, outer = 1, len = (cl_ulong)shape[d];
+        for(unsigned int k = 0; k < d; ++k)
+            inner *= (cl_ulong)shape[k];
+        for(unsigned int k = d + 1; k < N; ++k)
+            outer *= (cl_ulong)shape[k];
+
+        detail::openclCheck(clSetKernelArg(kern, 0, sizeof(cl_mem), &in),  "clSetKernelArg()");
+        detail::openclCheck(clSetKernelArg(kern, 1, sizeof(cl_mem), &out), "clSetKernelArg()");
+        int extra = setExtraArgs(exec, kern, d);
+        detail::openclCheck(clSetKernelArg(kern, extra,     sizeof(cl_ulong), &inner), "clSetKernelArg()");
+        detail::openclCheck(clSetKernelArg(kern, extra + 1, sizeof(cl_ulong), &len),   "clSetKernelArg()");
+        detail::openclCheck(clSetKernelArg(kern, extra + 2, sizeof(cl_ulong), &outer), "clSetKernelArg()");
+
+        std::size_t globalSize = (count + 63) / 64 * 64;
+        detail::openclCheck(
+            clEnqueueNDRangeKernel(exec.queue(), kern, 1, 0, &globalSize, 0, 0, 0, 0),
+            "clEnqueueNDRangeKernel()");
+        in = out;
+    }
+}
+
+    // host-array front-end: upload, run the device passes, download
+template <unsigned int N, class SetArgs>
+void
+openclSeparablePass(MultiArrayView<N, float> const & source,
+                    MultiArrayView<N, float> & dest,
+                    char const * kernelName, SetArgs const & setExtraArgs)
+{
+    OpenCLExecutor & exec = OpenCLExecutor::global();
+    vigra_precondition(exec.available(),
+        "openclSeparablePass(): no OpenCL device available.");
+    vigra_precondition(source.shape() == dest.shape(),
+        "openclSeparablePass(): shape mismatch between input and output.");
+    vigra_precondition(source.isUnstrided() && dest.isUnstrided(),
+        "openclSeparablePass(): arrays must be unstrided.");
+
+    std::size_t count = (std::size_t)source.size(),
+                bytes = count * sizeof(float);
+    cl_mem in = exec.buffer(bytes, OpenCLBufferSource),
+           out = exec.buffer(bytes, OpenCLBufferDest);
+    detail::openclCheck(
+        clEnqueueWriteBuffer(exec.queue(), in, CL_TRUE, 0, bytes,
+                             source.data(), 0, 0, 0),
+        "clEnqueueWriteBuffer()");
+
+    openclSeparablePassDevice(in, out, source.shape(), N, kernelName, setExtraArgs);
+
+    detail::openclCheck(
+        clEnqueueReadBuffer(exec.queue(), out, CL_TRUE, 0, bytes,
+                            dest.data(), 0, 0, 0),
+        "clEnqueueReadBuffer()");
+}
+
+struct OpenCLConvolutionArgs
+{
+    ArrayVector<ArrayVector<float> > const * coefficients_;
+    ArrayVector<int> const * lefts_, * rights_;
+
+    int operator()(OpenCLExecutor & exec, cl_kernel kern, unsigned int d) const
+    {
+        ArrayVector<float> const & coef = (*coefficients_)[d];
+        std::size_t bytes = coef.size() * sizeof(float);
+        cl_mem mem = exec.buffer(bytes, OpenCLBufferKernel);
+        detail::openclCheck(
+            clEnqueueWriteBuffer(exec.queue(), mem, CL_TRUE, 0, bytes,
+                                 &coef[0], 0, 0, 0),
+            "clEnqueueWriteBuffer()");
+        int left = (*lefts_)[d], right = (*rights_)[d];
+        detail::openclCheck(clSetKernelArg(kern, 2, sizeof(cl_mem), &mem),  "clSetKernelArg()");
+        detail::openclCheck(clSetKernelArg(kern, 3, sizeof(int), &left),    "clSetKernelArg()");
+        detail::openclCheck(clSetKernelArg(kern, 4, sizeof(int), &right),   "clSetKernelArg()");
+        return 5;
+    }
+};
+
+struct OpenCLMorphologyArgs
+{
+    int radius_, dilate_;
+
+    int operator()(OpenCLExecutor &, cl_kernel kern, unsigned int) const
+    {
+        detail::openclCheck(clSetKernelArg(kern, 2, sizeof(int), &radius_), "clSetKernelArg()");
+        detail::openclCheck(clSetKernelArg(kern, 3, sizeof(int), &dilate_), "clSetKernelArg()");
+        return 4;
+    }
+};
+
+template <class KernelArray>
+inline void
+openclPrepareConvolutionArgs(KernelArray const & kernels,
+                             ArrayVector<ArrayVector<float> > & coefficients,
+                             ArrayVector<int> & lefts, ArrayVector<int> & rights)
+{
+    for(unsigned int d = 0; d < kernels.size(); ++d)
+    {
+        Kernel1D<float> const & kernel = kernels[d];
+        lefts[d] = kernel.left();
+        rights[d] = kernel.right();
+        for(int k = kernel.left(); k <= kernel.right(); ++k)
+            coefficients[d].push_back(kernel[k]);
+    }
+}
+
+    // enqueue an element-wise kernel generated from an expression string;
+    // 'in2 == 0' selects the unary form (variable 'a' only)
+inline void
+openclRunPointwise(cl_mem in1, cl_mem in2, cl_mem out,
+                   std::size_t count, char const * expression)
+{
+    OpenCLExecutor & exec = OpenCLExecutor::global();
+
+    std::string prog;
+    if(in2 == 0)
+        prog = std::string("__kernel void transform(__global const float * in,\n"
+                           "                        __global float * out, const ulong n)\n"
+                           "{\n"
+                           "    size_t i = get_global_id(0);\n"
+                           "    if(i >= n) return;\n"
+                           "    float a = in[i];\n"
+                           "    out[i] = ") + expression + ";\n}\n";
+    else
+        prog = std::string("__kernel void transform(__global const float * in1,\n"
+                           "                        __global const float * in2,\n"
+                           "                        __global float * out, const ulong n)\n"
+                           "{\n"
+                           "    size_t i = get_global_id(0);\n"
+                           "    if(i >= n) return;\n"
+                           "    float a = in1[i];\n"
+                           "    float b = in2[i];\n"
+                           "    out[i] = ") + expression + ";\n}\n";
+
+    cl_kernel kern = exec.kernel(prog, "transform");
+    cl_ulong n = (cl_ulong)count;
+    cl_uint arg = 0;
+    detail::openclCheck(clSetKernelArg(kern, arg++, sizeof(cl_mem), &in1), "clSetKernelArg()");
+    if(in2 != 0)
+        detail::openclCheck(clSetKernelArg(kern, arg++, sizeof(cl_mem), &in2), "clSetKernelArg()");
+    detail::openclCheck(clSetKernelArg(kern, arg++, sizeof(cl_mem), &out),   "clSetKernelArg()");
+    detail::openclCheck(clSetKernelArg(kern, arg++, sizeof(cl_ulong), &n),   "clSetKernelArg()");
+    std::size_t globalSize = (count + 63) / 64 * 64;
+    detail::openclCheck(
+        clEnqueueNDRangeKernel(exec.queue(), kern, 1, 0, &globalSize, 0, 0, 0, 0),
+        "clEnqueueNDRangeKernel()");
+}
+
+} // namespace detail
+
+/********************************************************/
+/*                                                      */
+/*                   DeviceMultiArray                   */
+/*                                                      */
+/********************************************************/
+
+/** \brief Device-resident companion of MultiArray for OpenCL off-load.
+
+    A DeviceMultiArray owns a host mirror and a device buffer of the same
+    shape and keeps track of which copy is current, so that a chain of
+    off-loaded operations runs entirely on the device and data cross the
+    bus only when a side actually becomes stale. Transfers are enqueued
+    asynchronously: upload() and download() return immediately by
+    default, and the DMA overlaps with whatever the host does next;
+    sync() (or any access to the stale side) waits for completion.
+
+    <b> Usage:</b>
+
+    \code
+    DeviceMultiArray<3> a(source), b(source.shape()), c(source.shape());
+
+    openclSeparableConvolveMultiArray(a, b, kernels);  // device to device
+    openclGrayscaleDilation(b, c, 2);                  // no host round-trip
+    openclCombineTwoMultiArrays(a, c, c, "a - b");
+
+    MultiArrayView<3, float> result = c.view();        // downloads on demand
+    \endcode
+
+    Like the executor itself, a DeviceMultiArray is not thread-safe.
+*/
+template <unsigned int N>
+class DeviceMultiArray
+{
+  public:
+
+    typedef typename MultiArrayShape<N>::type difference_type;
+    typedef MultiArrayView<N, float> view_type;
+
+        /** Construct with the given shape. Both copies start out empty
+            and valid (all zero on the host; the device side is only
+            allocated, its initial contents are undefined but will never
+            be read before a kernel or upload wrote them). */
+    explicit DeviceMultiArray(difference_type const & shape)
+    : shape_(shape),
+      data_((std::size_t)prod(shape)),
+      deviceData_(0),
+      pendingTransfer_(0),
+      hostValid_(true),
+      deviceValid_(false)
+    {
+        allocateDeviceBuffer();
+    }
+
+        /** Construct from a host array. The data are copied into the host
+            mirror and asynchronously uploaded to the device right away. */
+    explicit DeviceMultiArray(MultiArrayView<N, float> const & host)
+    : shape_(host.shape()),
+      data_(host.data(), host.data() + host.size()),
+      deviceData_(0),
+      pendingTransfer_(0),
+      hostValid_(true),
+      deviceValid_(false)
+    {
+        vigra_precondition(host.isUnstrided(),
+            "DeviceMultiArray(): host array must be unstrided.");
+        allocateDeviceBuffer();
+        upload();
+    }
+
+    ~DeviceMultiArray()
+    {
+        sync();
+        clReleaseMemObject(deviceData_);
+    }
+
+    difference_type const & shape() const
+    {
+        return shape_;
+    }
+
+    std::size_t size() const
+    {
+        return data_.size();
+    }
+
+        /** True if the device copy is current. */
+    bool onDevice() const
+    {
+        return deviceValid_;
+    }
+
+        /** True if the host copy is current. */
+    bool onHost() const
+    {
+        return hostValid_;
+    }
+
+        /** Enqueue a host-to-device transfer unless the device copy is
+            already current. The transfer is asynchronous by default and
+            overlaps with subsequent host work; device-side consumers are
+            ordered after it automatically by the in-order queue. */
+    void upload(bool blocking = false)
+    {
+        if(deviceValid_)
+            return;
+        sync();
+        detail::openclCheck(
+            clEnqueueWriteBuffer(OpenCLExecutor::global().queue(), deviceData_,
+                                 blocking ? CL_TRUE : CL_FALSE, 0,
+                                 data_.size() * sizeof(float), &data_[0],
+                                 0, 0, &pendingTransfer_),
+            "clEnqueueWriteBuffer()");
+        if(blocking)
+            releasePendingTransfer();
+        deviceValid_ = true;
+    }
+
+        /** Enqueue a device-to-host transfer unless the host copy is
+            already current. Pass <tt>blocking = false</tt> to overlap the
+            DMA with host work; the host data must then not be touched
+            before the next sync(). */
+    void download(bool blocking = true)
+    {
+        if(hostValid_)
+            return;
+        sync();
+        detail::openclCheck(
+            clEnqueueReadBuffer(OpenCLExecutor::global().queue(), deviceData_,
+                                blocking ? CL_TRUE : CL_FALSE, 0,
+                                data_.size() * sizeof(float), &data_[0],
+                                0, 0, &pendingTransfer_),
+            "clEnqueueReadBuffer()");
+        if(blocking)
+            releasePendingTransfer();
+        hostValid_ = true;
+    }
+
+        /** Wait for an outstanding asynchronous transfer, if any. */
+    void sync()
+    {
+        if(pendingTransfer_ == 0)
+            return;
+        detail::openclCheck(clWaitForEvents(1, &pendingTransfer_), "clWaitForEvents()");
+        releasePendingTransfer();
+    }
+
+        /** View of the host copy, downloading it first if it is stale.
+            Call markHostModified() after writing through the view. */
+    view_type view()
+    {
+        download();
+        sync();
+        return view_type(shape_, &data_[0]);
+    }
+
+        /** The device buffer, uploading the host copy first if the device
+            copy is stale. Kernels that write into the buffer must be
+            followed by markDeviceModified(). */
+    cl_mem deviceData()
+    {
+        upload();
+        return deviceData_;
+    }
+
+        /** Declare that a kernel has written to the device buffer; the
+            host copy becomes stale. */
+    void markDeviceModified()
+    {
+        deviceValid_ = true;
+        hostValid_ = false;
+    }
+
+        /** Declare that the host copy has been written through view();
+            the device copy becomes stale. */
+    void markHostModified()
+    {
+        hostValid_ = true;
+        deviceValid_ = false;
+    }
+
+  private:
+
+    void allocateDeviceBuffer()
+    {
+        OpenCLExecutor & exec = OpenCLExecutor::global();
+        vigra_precondition(exec.available(),
+            "DeviceMultiArray(): no OpenCL device available.");
+        vigra_precondition(data_.size() > 0,
+            "DeviceMultiArray(): shape must not be empty.");
+        cl_int status;
+        deviceData_ = clCreateBuffer(exec.context(), CL_MEM_READ_WRITE,
+                                     data_.size() * sizeof(float), 0, &status);
+        detail::openclCheck(status, "clCreateBuffer()");
+    }
+
+    void releasePendingTransfer()
+    {
+        if(pendingTransfer_)
+        {
+            clReleaseEvent(pendingTransfer_);
+            pendingTransfer_ = 0;
+        }
+    }
+
+    DeviceMultiArray(DeviceMultiArray const &);             // not implemented
+    DeviceMultiArray & operator=(DeviceMultiArray const &); // not implemented
+
+    difference_type shape_;
+    ArrayVector<float> data_;
+    cl_mem deviceData_;
+    cl_event pendingTransfer_;
+    bool hostValid_, deviceValid_;
+};
+
+/********************************************************/
+/*                                                      */
+/*          openclSeparableConvolveMultiArray           */
+/*                                                      */
+/********************************************************/
+
+/** \brief Separable convolution on the OpenCL device.
+
+    Mirrors \ref separableConvolveMultiArray() with
+    <tt>BORDER_TREATMENT_REFLECT</tt> for unstrided <tt>float</tt> arrays:
+    the array is convolved with <tt>kernels[d]</tt> along every axis
+    <tt>d</tt> in turn, ping-ponging between two cached device buffers, so
+    the data cross the PCIe bus exactly twice regardless of the dimension.
+    Kernels with <tt>BORDER_TREATMENT_REFLECT</tt> or the default border
+    treatment are accepted.
+
+    <b> Usage:</b>
+
+    \code
+    MultiArray<3, float> source(shape), dest(shape);
+    ...
+    ArrayVector<Kernel1D<float> > kernels(3);
+    for(int d=0; d<3; ++d)
+        kernels[d].initGaussian(2.0);
+    if(OpenCLExecutor::global().available())
+        openclSeparableConvolveMultiArray(source, dest, kernels);
+    else
+        separableConvolveMultiArray(srcMultiArrayRange(source),
+                                    destMultiArray(dest), kernels.begin());
+    \endcode
+*/
+template <unsigned int N>
+void
+openclSeparableConvolveMultiArray(MultiArrayView<N, float> const & source,
+                                  MultiArrayView<N, float> dest,
+                                  ArrayVector<Kernel1D<float> > const & kernels)
+{
+    vigra_precondition(kernels.size() == N,
+        "openclSeparableConvolveMultiArray(): one kernel per dimension required.");
+
+    ArrayVector<ArrayVector<float> > coefficients(N);
+    ArrayVector<int> lefts(N), rights(N);
+    detail::openclPrepareConvolutionArgs(kernels, coefficients, lefts, rights);
+
+    detail::OpenCLConvolutionArgs args;
+    args.coefficients_ = &coefficients;
+    args.lefts_ = &lefts;
+    args.rights_ = &rights;
+    detail::openclSeparablePass(source, dest, "convolve1d", args);
+}
+
+    /** \brief Separable convolution on the OpenCL device with a single
+        kernel applied to all dimensions (overload).
+    */
+template <unsigned int N>
+void
+openclSeparableConvolveMultiArray(MultiArrayView<N, float> const & source,
+                                  MultiArrayView<N, float> dest,
+                                  Kernel1D<float> const & kernel)
+{
+    ArrayVector<Kernel1D<float> > kernels(N, kernel);
+    openclSeparableConvolveMultiArray(source, dest, kernels);
+}
+
+    /** \brief Separable convolution between device-resident arrays
+        (overload).
+
+        Input and output stay on the device; nothing is transferred to or
+        from the host, so several off-loaded operations can be chained.
+        \a source and \a dest must be distinct objects.
+    */
+template <unsigned int N>
+void
+openclSeparableConvolveMultiArray(DeviceMultiArray<N> & source,
+                                  DeviceMultiArray<N> & dest,
+                                  ArrayVector<Kernel1D<float> > const & kernels)
+{
+    vigra_precondition(kernels.size() == N,
+        "openclSeparableConvolveMultiArray(): one kernel per dimension required.");
+    vigra_precondition(source.shape() == dest.shape(),
+        "openclSeparableConvolveMultiArray(): shape mismatch between input and output.");
+    vigra_precondition(&source != &dest,
+        "openclSeparableConvolveMultiArray(): in-place operation is not supported.");
+
+    ArrayVector<ArrayVector<float> > coefficients(N);
+    ArrayVector<int> lefts(N), rights(N);
+    detail::openclPrepareConvolutionArgs(kernels, coefficients, lefts, rights);
+
+    detail::OpenCLConvolutionArgs args;
+    args.coefficients_ = &coefficients;
+    args.lefts_ = &lefts;
+    args.rights_ = &rights;
+    detail::openclSeparablePassDevice(source.deviceData(), dest.deviceData(),
+                                      source.shape(), N, "convolve1d", args);
+    dest.markDeviceModified();
+}
+
+/********************************************************/
+/*                                                      */
+/*              openclTransformMultiArray               */
+/*                                                      */
+/********************************************************/
+
+/** \brief Element-wise transformation on the OpenCL device.
+
+    Mirrors \ref transformMultiArray() for unstrided <tt>float</tt>
+    arrays. The operation is given as an OpenCL expression in the variable
+    <tt>a</tt>, e.g. <tt>"sqrt(a)"</tt> or <tt>"a*a + 0.5f"</tt>; a kernel
+    is generated from the expression, compiled once, and cached for
+    subsequent calls with the same expression.
+*/
+template <unsigned int N>
+void
+openclTransformMultiArray(MultiArrayView<N, float> const & source,
+                          MultiArrayView<N, float> dest,
+                          char const * expression)
+{
+    OpenCLExecutor & exec = OpenCLExecutor::global();
+    vigra_precondition(exec.available(),
+        "openclTransformMultiArray(): no OpenCL device available.");
+    vigra_precondition(source.shape() == dest.shape(),
+        "openclTransformMultiArray(): shape mismatch between input and output.");
+    vigra_precondition(source.isUnstrided() && dest.isUnstrided(),
+        "openclTransformMultiArray(): arrays must be unstrided.");
+
+    std::size_t count = (std::size_t)source.size(),
+                bytes = count * sizeof(float);
+    cl_mem in = exec.buffer(bytes, detail::OpenCLBufferSource),
+           out = exec.buffer(bytes, detail::OpenCLBufferDest);
+    detail::openclCheck(
+        clEnqueueWriteBuffer(exec.queue(), in, CL_TRUE, 0, bytes, source.data(), 0, 0, 0),
+        "clEnqueueWriteBuffer()");
+    detail::openclRunPointwise(in, 0, out, count, expression);
+    detail::openclCheck(
+        clEnqueueReadBuffer(exec.queue(), out, CL_TRUE, 0, bytes, dest.data(), 0, 0, 0),
+        "clEnqueueReadBuffer()");
+}
+
+    /** \brief Element-wise transformation between device-resident arrays
+        (overload). In-place operation (<tt>&source == &dest</tt>) is
+        allowed here, since every element is read exactly once.
+    */
+template <unsigned int N>
+void
+openclTransformMultiArray(DeviceMultiArray<N> & source,
+                          DeviceMultiArray<N> & dest,
+                          char const * expression)
+{
+    vigra_precondition(source.shape() == dest.shape(),
+        "openclTransformMultiArray(): shape mismatch between input and output.");
+    detail::openclRunPointwise(source.deviceData(), 0, dest.deviceData(),
+                               source.size(), expression);
+    dest.markDeviceModified();
+}
+
+/********************************************************/
+/*                                                      */
+/*             openclCombineTwoMultiArrays              */
+/*                                                      */
+/********************************************************/
+
+/** \brief Element-wise combination of two arrays on the OpenCL device.
+
+    Mirrors \ref combineTwoMultiArrays() for unstrided <tt>float</tt>
+    arrays. The operation is given as an OpenCL expression in the
+    variables <tt>a</tt> and <tt>b</tt>, e.g. <tt>"a*b"</tt> or
+    <tt>"fmax(a, b)"</tt>.
+*/
+template <unsigned int N>
+void
+openclCombineTwoMultiArrays(MultiArrayView<N, float> const & source1,
+                            MultiArrayView<N, float> const & source2,
+                            MultiArrayView<N, float> dest,
+                            char const * expression)
+{
+    OpenCLExecutor & exec = OpenCLExecutor::global();
+    vigra_precondition(exec.available(),
+        "openclCombineTwoMultiArrays(): no OpenCL device available.");
+    vigra_precondition(source1.shape() == source2.shape() && source1.shape() == dest.shape(),
+        "openclCombineTwoMultiArrays(): shape mismatch.");
+    vigra_precondition(source1.isUnstrided() && source2.isUnstrided() && dest.isUnstrided(),
+        "openclCombineTwoMultiArrays(): arrays must be unstrided.");
+
+    std::size_t count = (std::size_t)source1.size(),
+                bytes = count * sizeof(float);
+    cl_mem in1 = exec.buffer(bytes, detail::OpenCLBufferSource),
+           in2 = exec.buffer(bytes, detail::OpenCLBufferSource2),
+           out = exec.buffer(bytes, detail::OpenCLBufferDest);
+    detail::openclCheck(
+        clEnqueueWriteBuffer(exec.queue(), in1, CL_TRUE, 0, bytes, source1.data(), 0, 0, 0),
+        "clEnqueueWriteBuffer()");
+    detail::openclCheck(
+        clEnqueueWriteBuffer(exec.queue(), in2, CL_TRUE, 0, bytes, source2.data(), 0, 0, 0),
+        "clEnqueueWriteBuffer()");
+    detail::openclRunPointwise(in1, in2, out, count, expression);
+    detail::openclCheck(
+        clEnqueueReadBuffer(exec.queue(), out, CL_TRUE, 0, bytes, dest.data(), 0, 0, 0),
+        "clEnqueueReadBuffer()");
+}
+
+    /** \brief Element-wise combination of two device-resident arrays
+        (overload). \a dest may coincide with either input.
+    */
+template <unsigned int N>
+void
+openclCombineTwoMultiArrays(DeviceMultiArray<N> & source1,
+                            DeviceMultiArray<N> & source2,
+                            DeviceMultiArray<N> & dest,
+                            char const * expression)
+{
+    vigra_precondition(source1.shape() == source2.shape() && source1.shape() == dest.shape(),
+        "openclCombineTwoMultiArrays(): shape mismatch.");
+    detail::openclRunPointwise(source1.deviceData(), source2.deviceData(),
+                               dest.deviceData(), source1.size(), expression);
+    dest.markDeviceModified();
+}
+
+/********************************************************/
+/*                                                      */
+/*        openclGrayscaleErosion / Dilation             */
+/*                                                      */
+/********************************************************/
+
+/** \brief Flat grayscale erosion on the OpenCL device.
+
+    Separable minimum filter with a box structuring element of the given
+    \a radius along every axis (window size <tt>2*radius+1</tt>); at the
+    borders, the window shrinks. Note that this is the flat analogue of
+    \ref multiGrayscaleErosion(), which uses a parabolic structuring
+    function instead.
+*/
+template <unsigned int N>
+void
+openclGrayscaleErosion(MultiArrayView<N, float> const & source,
+                       MultiArrayView<N, float> dest, int radius)
+{
+    vigra_precondition(radius > 0,
+        "openclGrayscaleErosion(): radius must be positive.");
+    detail::OpenCLMorphologyArgs args;
+    args.radius_ = radius;
+    args.dilate_ = 0;
+    detail::openclSeparablePass(source, dest, "minmax1d", args);
+}
+
+/** \brief Flat grayscale dilation on the OpenCL device.
+
+    Separable maximum filter with a box structuring element of the given
+    \a radius along every axis; see \ref openclGrayscaleErosion().
+*/
+template <unsigned int N>
+void
+openclGrayscaleDilation(MultiArrayView<N, float> const & source,
+                        MultiArrayView<N, float> dest, int radius)
+{
+    vigra_precondition(radius > 0,
+        "openclGrayscaleDilation(): radius must be positive.");
+    detail::OpenCLMorphologyArgs args;
+    args.radius_ = radius;
+    args.dilate_ = 1;
+    detail::openclSeparablePass(source, dest, "minmax1d", args);
+}
+
+    /** \brief Flat grayscale erosion between device-resident arrays
+        (overload). \a source and \a dest must be distinct objects.
+    */
+template <unsigned int N>
+void
+openclGrayscaleErosion(DeviceMultiArray<N> & source,
+                       DeviceMultiArray<N> & dest, int radius)
+{
+    vigra_precondition(radius > 0,
+        "openclGrayscaleErosion(): radius must be positive.");
+    vigra_precondition(source.shape() == dest.shape(),
+        "openclGrayscaleErosion(): shape mismatch between input and output.");
+    vigra_precondition(&source != &dest,
+        "openclGrayscaleErosion(): in-place operation is not supported.");
+    detail::OpenCLMorphologyArgs args;
+    args.radius_ = radius;
+    args.dilate_ = 0;
+    detail::openclSeparablePassDevice(source.deviceData(), dest.deviceData(),
+                                      source.shape(), N, "minmax1d", args);
+    dest.markDeviceModified();
+}
+
+    /** \brief Flat grayscale dilation between device-resident arrays
+        (overload). \a source and \a dest must be distinct objects.
+    */
+template <unsigned int N>
+void
+openclGrayscaleDilation(DeviceMultiArray<N> & source,
+                        DeviceMultiArray<N> & dest, int radius)
+{
+    vigra_precondition(radius > 0,
+        "openclGrayscaleDilation(): radius must be positive.");
+    vigra_precondition(source.shape() == dest.shape(),
+        "openclGrayscaleDilation(): shape mismatch between input and output.");
+    vigra_precondition(&source != &dest,
+        "openclGrayscaleDilation(): in-place operation is not supported.");
+    detail::OpenCLMorphologyArgs args;
+    args.radius_ = radius;
+    args.dilate_ = 1;
+    detail::openclSeparablePassDevice(source.deviceData(), dest.deviceData(),
+                                      source.shape(), N, "minmax1d", args);
+    dest.markDeviceModified();
+}
+
+//@}
+
+//@}
+
+} // namespace vigra
+
+#endif // VIGRA_MULTI_OPENCL_EXECUTION_HXX
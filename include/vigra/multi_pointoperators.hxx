@@ -42,15 +42,196 @@
 #include "transformimage.hxx"
 #include "combineimages.hxx"
 #include "inspectimage.hxx"
+#include <cstring>
 #include "multi_array.hxx"
 #include "metaprogramming.hxx"
 #include "inspector_passes.hxx"
+#include "parallel_options.hxx"
 
 
 
 namespace vigra
 {
 
+// forward declaration (the definition in multi_array.hxx is not yet
+// available when this file is included from there)
+template <unsigned int N, class T, class C>
+class MultiArrayView;
+
+namespace detail {
+
+// Normalize the axes of a same-shaped pointer/stride pair for cache-aware
+// traversal: sort the axes by ascending destination stride (so that the
+// innermost loop runs along the axis with the best destination locality),
+// drop singleton axes, and collapse neighboring axes that are contiguous
+// in both arrays into a single longer axis. Returns the number of
+// remaining axes (zero when the arrays contain a single element, -1
+// when they are empty, i.e. some axis has extent 0 — callers must not
+// touch any memory in that case).
+template <class Shape>
+int
+collapseStrideOrder(Shape shape, Shape sstride, Shape dstride,
+                    typename Shape::value_type * sh,
+                    typename Shape::value_type * ss,
+                    typename Shape::value_type * ds)
+{
+    typedef typename Shape::value_type Index;
+    static const int N = Shape::static_size;
+
+    for(int k = 0; k < N; ++k)
+        if(shape[k] == 0)
+            return -1;
+
+    // insertion sort by ascending destination stride
+    for(int i = 1; i < N; ++i)
+    {
+        Index shi = shape[i], ssi = sstride[i], dsi = dstride[i];
+        int j = i - 1;
+        for(; j >= 0 && dstride[j] > dsi; --j)
+        {
+            shape[j+1]   = shape[j];
+            sstride[j+1] = sstride[j];
+            dstride[j+1] = dstride[j];
+        }
+        shape[j+1]   = shi;
+        sstride[j+1] = ssi;
+        dstride[j+1] = dsi;
+    }
+
+    int m = 0;
+    for(int k = 0; k < N; ++k)
+    {
+        if(shape[k] == 1)
+            continue;
+        if(m > 0 && sstride[k] == ss[m-1]*sh[m-1] && dstride[k] == ds[m-1]*sh[m-1])
+        {
+            sh[m-1] *= shape[k];   // contiguous in both arrays => merge
+        }
+        else
+        {
+            sh[m] = shape[k];
+            ss[m] = sstride[k];
+            ds[m] = dstride[k];
+            ++m;
+        }
+    }
+    return m;
+}
+
+// copyContiguousLine() is defined in copyimage.hxx and shared with the
+// row-wise copyLine() fast path there.
+
+// Stride-aware copy between two non-overlapping arrays of the same shape.
+// The axes are reordered and collapsed via collapseStrideOrder(), so that
+// copies between differently ordered views proceed along the cache-friendly
+// axis and degenerate into memcpy() whenever the memory layouts permit.
+template <class Shape, class T1, class T2>
+void
+copyArrayDataReordered(Shape const & shape,
+                       T1 const * s, Shape const & sstride,
+                       T2 * d, Shape const & dstride)
+{
+    typedef typename Shape::value_type Index;
+    typedef typename And<typename IsSameType<T1, T2>::result,
+                         typename TypeTraits<T1>::isPOD>::result UseMemcpy;
+    static const int N = Shape::static_size;
+
+    Index sh[N], ss[N], ds[N];
+    int m = collapseStrideOrder(shape, sstride, dstride, sh, ss, ds);
+    if(m < 0)          // empty array
+        return;
+    if(m == 0)
+    {
+        *d = RequiresExplicitCast<T2>::cast(*s);
+        return;
+    }
+
+    Index index[N];
+    for(int k = 0; k < m; ++k)
+        index[k] = 0;
+    for(;;)
+    {
+        if(ss[0] == 1 && ds[0] == 1)
+        {
+            copyContiguousLine(s, (std::ptrdiff_t)sh[0], d, UseMemcpy());
+        }
+        else
+        {
+            T1 const * sp = s;
+            T2 * dp = d;
+            for(Index i = 0; i < sh[0]; ++i, sp += ss[0], dp += ds[0])
+                *dp = RequiresExplicitCast<T2>::cast(*sp);
+        }
+
+        int k = 1;
+        for(; k < m; ++k)
+        {
+            s += ss[k];
+            d += ds[k];
+            if(++index[k] < sh[k])
+                break;
+            index[k] = 0;
+            s -= sh[k]*ss[k];
+            d -= sh[k]*ds[k];
+        }
+        if(k == m)
+            break;
+    }
+}
+
+// Stride-aware constant fill of an array. The axes are reordered and
+// collapsed via collapseStrideOrder(), so that the fill proceeds along
+// the cache-friendly axis and degenerates into memset() or contiguous
+// vectorizable spans whenever the memory layout permits.
+template <class Shape, class T>
+void
+fillArrayDataReordered(Shape const & shape, T * d, Shape const & dstride, T const & val)
+{
+    typedef typename Shape::value_type Index;
+    static const int N = Shape::static_size;
+
+    Index sh[N], ss[N], ds[N];
+    int m = collapseStrideOrder(shape, dstride, dstride, sh, ss, ds);
+    if(m < 0)          // empty array
+        return;
+    if(m == 0)
+    {
+        *d = val;
+        return;
+    }
+
+    Index index[N];
+    for(int k = 0; k < m; ++k)
+        index[k] = 0;
+    for(;;)
+    {
+        if(ds[0] == 1)
+        {
+            fillContiguousLine(d, (std::ptrdiff_t)sh[0], val, typename TypeTraits<T>::isPOD());
+        }
+        else
+        {
+            T * dp = d;
+            for(Index i = 0; i < sh[0]; ++i, dp += ds[0])
+                *dp = val;
+        }
+
+        int k = 1;
+        for(; k < m; ++k)
+        {
+            d += ds[k];
+            if(++index[k] < sh[k])
+                break;
+            index[k] = 0;
+            d -= sh[k]*ds[k];
+        }
+        if(k == m)
+            break;
+    }
+}
+
+} // namespace detail
+
 /** \addtogroup MultiPointoperators Point operators for multi-dimensional arrays.
 
     Copy, transform, and inspect arbitrary dimensional arrays which are represented
@@ -76,10 +257,10 @@ initMultiArrayImpl(Iterator s, Shape const & shape, Accessor a,  VALUETYPE const
     initLine(s, s + shape[0], a, v);
 }
     
-template <class Iterator, class Shape, class Accessor, 
+template <class Iterator, class Shape, class Accessor,
           class VALUETYPE, int N>
 void
-initMultiArrayImpl(Iterator s, Shape const & shape, Accessor a,  
+initMultiArrayImpl(Iterator s, Shape const & shape, Accessor a,
                    VALUETYPE const & v, MetaInt<N>)
 {
     Iterator send = s + shape[N];
@@ -88,7 +269,39 @@ initMultiArrayImpl(Iterator s, Shape const & shape, Accessor a,
         initMultiArrayImpl(s.begin(), shape, a, v, MetaInt<N-1>());
     }
 }
-    
+
+template <class Iterator, class Shape, class Accessor,
+          class VALUETYPE>
+inline void
+initMultiArrayParallelImpl(Iterator s, Shape const & shape, Accessor a,  VALUETYPE const & v,
+                           MetaInt<0>, ParallelOptions const &)
+{
+    initLine(s, s + shape[0], a, v);   // nothing to split in 1D
+}
+
+template <class Iterator, class Shape, class Accessor,
+          class VALUETYPE, int N>
+void
+initMultiArrayParallelImpl(Iterator s, Shape const & shape, Accessor a,
+                           VALUETYPE const & v, MetaInt<N>, ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    int count = (int)shape[N];
+    #pragma omp parallel num_threads(options.getNumThreads())
+    {
+        #pragma omp for schedule(static)
+        for(int k = 0; k < count; ++k)
+        {
+            Iterator t = s + k;
+            initMultiArrayImpl(t.begin(), shape, a, v, MetaInt<N-1>());
+        }
+    }
+#else
+    (void)options;
+    initMultiArrayImpl(s, shape, a, v, MetaInt<N>());
+#endif
+}
+
 /** \brief Write a value to every pixel in a multi-dimensional array.
 
     This function can be used to init the array which must be represented by
@@ -101,11 +314,15 @@ initMultiArrayImpl(Iterator s, Shape const & shape, Accessor a,
     The initial value can either be a constant of appropriate type (compatible with 
     the destination's value_type), or a functor with compatible result_type. These two 
     cases are automatically distinguished when <tt>FunctorTraits<FUNCTOR>::isInitializer</tt>
-    yields <tt>VigraTrueType</tt>. Since the functor is passed by <tt>const</tt> reference, its 
+    yields <tt>VigraTrueType</tt>. Since the functor is passed by <tt>const</tt> reference, its
     <tt>operator()</tt> must be const, and its internal state may need to be <tt>mutable</tt>.
-    
+
+    The variants taking a \ref vigra::ParallelOptions argument distribute the
+    initialization of large arrays over the outermost dimension when VIGRA
+    was compiled with OpenMP support; small arrays are initialized serially.
+
     <b> Declarations:</b>
-    
+
     pass arguments explicitly:
     \code
     namespace vigra {
@@ -113,6 +330,10 @@ initMultiArrayImpl(Iterator s, Shape const & shape, Accessor a,
         void
         initMultiArray(Iterator s, Shape const & shape, Accessor a,  VALUETYPE const & v);
 
+        template <class Iterator, class Shape, class Accessor, class VALUETYPE>
+        void
+        initMultiArray(Iterator s, Shape const & shape, Accessor a,  VALUETYPE const & v,
+                       ParallelOptions const & options);
 
         template <class Iterator, class Shape, class Accessor, class FUNCTOR>
         void
@@ -189,13 +410,42 @@ initMultiArray(Iterator s, Shape const & shape, Accessor a,  VALUETYPE const & v
 }
     
 template <class Iterator, class Shape, class Accessor, class VALUETYPE>
-inline 
+inline
 void
 initMultiArray(triple<Iterator, Shape, Accessor> const & s, VALUETYPE const & v)
 {
     initMultiArray(s.first, s.second, s.third, v);
 }
 
+template <class Iterator, class Shape, class Accessor, class VALUETYPE>
+void
+initMultiArray(Iterator s, Shape const & shape, Accessor a,  VALUETYPE const & v,
+               ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    double total = 1.0;
+    for(unsigned int k = 0; k < (unsigned int)Shape::static_size; ++k)
+        total *= (double)shape[k];
+    if(Iterator::level > 0 && options.getNumThreads() > 1 && total >= 65536.0)
+    {
+        initMultiArrayParallelImpl(s, shape, a, v, MetaInt<Iterator::level>(), options);
+        return;
+    }
+#else
+    (void)options;
+#endif
+    initMultiArray(s, shape, a, v);
+}
+
+template <class Iterator, class Shape, class Accessor, class VALUETYPE>
+inline
+void
+initMultiArray(triple<Iterator, Shape, Accessor> const & s, VALUETYPE const & v,
+               ParallelOptions const & options)
+{
+    initMultiArray(s.first, s.second, s.third, v, options);
+}
+
 /********************************************************/
 /*                                                      */
 /*                  initMultiArrayBorder                */
@@ -328,6 +578,18 @@ copyMultiArrayImpl(SrcIterator s, SrcShape const & sshape, SrcAccessor src,
                        DestIterator d, DestShape const & dshape, DestAccessor dest);
     }
     \endcode
+
+    use views directly (data are copied in cache-optimized axis order,
+    regardless of the axis ordering of the two views):
+    \code
+    namespace vigra {
+        template <unsigned int N, class T1, class C1,
+                                  class T2, class C2>
+        void
+        copyMultiArray(MultiArrayView<N, T1, C1> const & source,
+                       MultiArrayView<N, T2, C2> dest);
+    }
+    \endcode
     
     
     use argument objects in conjunction with \ref ArgumentObjectFactories :
@@ -436,6 +698,18 @@ copyMultiArray(triple<SrcIterator, SrcShape, SrcAccessor> const & src,
     copyMultiArray(src.first, src.second, src.third, dest.first, dest.second, dest.third);
 }
 
+template <unsigned int N, class T1, class C1, class T2, class C2>
+inline void
+copyMultiArray(MultiArrayView<N, T1, C1> const & source,
+               MultiArrayView<N, T2, C2> dest)
+{
+    if(source.shape() == dest.shape())
+        detail::copyArrayDataReordered(dest.shape(), source.data(), source.stride(),
+                                       dest.data(), dest.stride());
+    else
+        copyMultiArray(srcMultiArrayRange(source), destMultiArrayRange(dest));
+}
+
 /********************************************************/
 /*                                                      */
 /*                 transformMultiArray                  */
@@ -632,6 +906,18 @@ transformMultiArrayImpl(SrcIterator s, SrcShape const & sshape, SrcAccessor src,
     }
     \endcode
 
+    use views directly (in standard mode, the elements are visited in
+    cache-optimized axis order, regardless of the axis ordering of the views):
+    \code
+    namespace vigra {
+        template <unsigned int N, class T1, class C1,
+                                  class T2, class C2, class Functor>
+        void
+        transformMultiArray(MultiArrayView<N, T1, C1> const & source,
+                            MultiArrayView<N, T2, C2> dest, Functor const & f);
+    }
+    \endcode
+
 
     use argument objects in conjunction with \ref ArgumentObjectFactories :
     \code
@@ -819,6 +1105,93 @@ transformMultiArray(triple<SrcIterator, SrcShape, SrcAccessor> const & src,
                         dest.first, dest.second, dest.third, f);
 }
 
+namespace detail {
+
+// stride-aware elementwise transform between two same-shaped arrays,
+// analogous to copyArrayDataReordered() above
+template <class Shape, class T1, class T2, class Functor>
+void
+transformArrayDataReordered(Shape const & shape,
+                            T1 const * s, Shape const & sstride,
+                            T2 * d, Shape const & dstride,
+                            Functor const & f)
+{
+    typedef typename Shape::value_type Index;
+    static const int N = Shape::static_size;
+
+    Index sh[N], ss[N], ds[N];
+    int m = collapseStrideOrder(shape, sstride, dstride, sh, ss, ds);
+    if(m < 0)          // empty array
+        return;
+    if(m == 0)
+    {
+        *d = RequiresExplicitCast<T2>::cast(f(*s));
+        return;
+    }
+
+    Index index[N];
+    for(int k = 0; k < m; ++k)
+        index[k] = 0;
+    for(;;)
+    {
+        T1 const * sp = s;
+        T2 * dp = d;
+        for(Index i = 0; i < sh[0]; ++i, sp += ss[0], dp += ds[0])
+            *dp = RequiresExplicitCast<T2>::cast(f(*sp));
+
+        int k = 1;
+        for(; k < m; ++k)
+        {
+            s += ss[k];
+            d += ds[k];
+            if(++index[k] < sh[k])
+                break;
+            index[k] = 0;
+            s -= sh[k]*ss[k];
+            d -= sh[k]*ds[k];
+        }
+        if(k == m)
+            break;
+    }
+}
+
+template <unsigned int N, class T1, class C1, class T2, class C2, class Functor>
+inline void
+transformMultiArrayViewImpl(MultiArrayView<N, T1, C1> const & source,
+                            MultiArrayView<N, T2, C2> & dest, Functor const & f,
+                            VigraFalseType /* isAnalyserInitializer */)
+{
+    if(source.shape() == dest.shape())
+        transformArrayDataReordered(dest.shape(), source.data(), source.stride(),
+                                    dest.data(), dest.stride(), f);
+    else
+        transformMultiArray(srcMultiArrayRange(source), destMultiArrayRange(dest), f);
+}
+
+template <unsigned int N, class T1, class C1, class T2, class C2, class Functor>
+inline void
+transformMultiArrayViewImpl(MultiArrayView<N, T1, C1> const & source,
+                            MultiArrayView<N, T2, C2> & dest, Functor const & f,
+                            VigraTrueType /* isAnalyserInitializer */)
+{
+    // reduce mode must inspect the source in logical axis order
+    transformMultiArray(srcMultiArrayRange(source), destMultiArrayRange(dest), f);
+}
+
+} // namespace detail
+
+template <unsigned int N, class T1, class C1, class T2, class C2, class Functor>
+inline void
+transformMultiArray(MultiArrayView<N, T1, C1> const & source,
+                    MultiArrayView<N, T2, C2> dest, Functor const & f)
+{
+    typedef FunctorTraits<Functor> FT;
+    typedef typename 
+        And<typename FT::isInitializer, typename FT::isUnaryAnalyser>::result
+        isAnalyserInitializer;
+    detail::transformMultiArrayViewImpl(source, dest, f, isAnalyserInitializer());
+}
+
 /********************************************************/
 /*                                                      */
 /*                combineTwoMultiArrays                 */
@@ -40,6 +40,7 @@
 #include <vector>
 #include "resizeimage.hxx"
 #include "navigator.hxx"
+#include "memory.hxx"
 
 namespace vigra {
 
@@ -100,6 +101,161 @@ internalResizeMultiArrayOneDimension(
     }
 }
 
+// Streaming implementation: the array is processed in slabs along the
+// outermost axis, so that the temporary arrays of the inner axis passes
+// only ever hold one slab (plus the filter support and a prefilter
+// margin) instead of the entire resized array. The lines of the inner
+// axes are complete within a slab, hence those passes are exact; along
+// the outermost axis the recursive prefilter is applied to a padded
+// window whose margin is large enough for the filter response to decay
+// to machine precision (cf. the lazy prefilter tiles in
+// splineimageview.hxx), and reflective boundary conditions at true array
+// borders coincide with the global filter.
+template <class SrcIterator, class Shape, class SrcAccessor,
+          class DestIterator, class DestAccessor, class Kernel>
+void
+internalResizeMultiArrayStreaming(
+                      SrcIterator si, Shape const & sshape, SrcAccessor src,
+                      DestIterator di, Shape const & dshape, DestAccessor dest,
+                      Kernel const & spline, int slabThickness,
+                      MemoryArena * arena = 0)
+{
+    enum { N = 1 + SrcIterator::level };
+
+    typedef typename NumericTraits<typename DestAccessor::value_type>::RealPromote TmpType;
+    typedef typename AccessorTraits<TmpType>::default_accessor TmpAccessor;
+    typedef MultiArray<N, TmpType, ArenaAllocator<TmpType> > TmpArray;
+    typedef MultiArrayNavigator<SrcIterator, N> SNavigator;
+    typedef MultiArrayNavigator<DestIterator, N> DNavigator;
+    typedef MultiArrayNavigator<typename TmpArray::traverser, N> TNavigator;
+
+    unsigned int d = N - 1;
+    int ssize = sshape[d];
+    int dsize = dshape[d];
+
+    vigra_precondition(ssize > 1,
+                 "resizeMultiArraySplineInterpolation(): "
+                 "Source array too small.\n");
+
+    Rational<int> ratio(dsize - 1, ssize - 1);
+    Rational<int> offset(0);
+    resampling_detail::MapTargetToSourceCoordinate mapCoordinate(ratio, offset);
+    int period = lcm(ratio.numerator(), ratio.denominator());
+
+    ArrayVector<double> const & prefilterCoeffs = spline.prefilterCoefficients();
+    ArrayVector<Kernel1D<double> > kernels(period);
+    createResamplingKernels(spline, mapCoordinate, kernels);
+
+    // after 48 pixels, the impulse response of the slowest recursive
+    // prefilter (largest pole 0.43 for spline order 5) has decayed
+    // below 1e-17
+    int margin = prefilterCoeffs.size() > 0 ? 48 : 0;
+
+    TmpAccessor ta;
+
+    for(int z0 = 0; z0 < dsize; z0 += slabThickness)
+    {
+        int z1 = std::min(z0 + slabThickness, dsize);
+
+        // source range required by the resampling kernels of this slab
+        int ilo = ssize, ihi = -1;
+        for(int z = z0; z < z1; ++z)
+        {
+            int is = mapCoordinate(z);
+            Kernel1D<double> const & k = kernels[z % period];
+            if(is - k.right() < ilo)
+                ilo = is - k.right();
+            if(is - k.left() > ihi)
+                ihi = is - k.left();
+        }
+        int plo = std::max(0, ilo - margin);
+        int phi = std::min(ssize - 1, ihi + margin);
+        int thick = phi - plo + 1;
+
+        // copy the padded source slab
+        Shape bshape(sshape);
+        bshape[d] = thick;
+        TmpArray slab(bshape, ArenaAllocator<TmpType>(arena));
+        {
+            SNavigator snav( si, sshape, d );
+            TNavigator bnav( slab.traverser_begin(), bshape, d );
+            for( ; snav.hasMore(); snav++, bnav++ )
+                copyLine( snav.begin() + plo, snav.begin() + plo + thick, src,
+                          bnav.begin(), ta);
+        }
+
+        // resize the inner axes; their lines are complete, so this is
+        // identical to the non-streaming algorithm
+        for(unsigned int d2 = 0; d2 < d; ++d2)
+        {
+            Shape tshape(bshape);
+            tshape[d2] = dshape[d2];
+            TmpArray dtmp(tshape, ArenaAllocator<TmpType>(arena));
+
+            internalResizeMultiArrayOneDimension(slab.traverser_begin(), bshape, ta,
+                                  dtmp.traverser_begin(), tshape, ta, spline, d2);
+            dtmp.swap(slab);
+            bshape = tshape;
+        }
+
+        // prefilter and resample the padded lines of the outermost axis
+        TNavigator bnav( slab.traverser_begin(), bshape, d );
+        DNavigator dnav( di, dshape, d );
+
+        ArrayVector<TmpType, ArenaAllocator<TmpType> > tmp( thick, ArenaAllocator<TmpType>(arena) );
+        typename ArrayVector<TmpType, ArenaAllocator<TmpType> >::iterator t = tmp.begin(), tend = tmp.end();
+        int wo2 = 2*thick - 2;
+
+        for( ; bnav.hasMore(); bnav++, dnav++ )
+        {
+            copyLine( bnav.begin(), bnav.end(), ta, t, ta);
+
+            for(unsigned int b = 0; b < prefilterCoeffs.size(); ++b)
+            {
+                recursiveFilterLine(t, tend, ta, t, ta,
+                                    prefilterCoeffs[b], BORDER_TREATMENT_REFLECT);
+            }
+
+            typename DNavigator::iterator dline = dnav.begin();
+            for(int z = z0; z < z1; ++z)
+            {
+                Kernel1D<double> const & kernel = kernels[z % period];
+                int is = mapCoordinate(z) - plo;
+
+                TmpType sum = NumericTraits<TmpType>::zero();
+
+                int lbound = is - kernel.right(),
+                    hbound = is - kernel.left();
+
+                typename Kernel1D<double>::const_iterator k = kernel.center() + kernel.right();
+                if(lbound < 0 || hbound >= thick)
+                {
+                    for(int m = lbound; m <= hbound; ++m, --k)
+                    {
+                        int mm = (m < 0) ?
+                                    -m :
+                                    (m >= thick) ?
+                                        wo2 - m :
+                                        m;
+                        sum = TmpType(sum + *k * tmp[mm]);
+                    }
+                }
+                else
+                {
+                    typename ArrayVector<TmpType>::const_iterator ss = tmp.begin() + lbound,
+                                                                  ssend = tmp.begin() + hbound;
+                    for(; ss <= ssend; ++ss, --k)
+                    {
+                        sum = TmpType(sum + *k * *ss);
+                    }
+                }
+
+                dest.set(sum, dline + z);
+            }
+        }
+    }
+}
+
 } // namespace detail
 
 /** \addtogroup GeometricTransformations Geometric Transformations
@@ -172,6 +328,15 @@ internalResizeMultiArrayOneDimension(
     real number and \ref NumericTraits "NumericTraits".
     The function uses accessors.
 
+    For arrays that are too large to afford the full-size temporary array
+    of each axis pass, both forms accept an additional <tt>slabThickness</tt>
+    argument after the spline. The array is then processed in slabs of the
+    given thickness along the outermost axis, so the scratch memory is
+    bounded by the slab size (plus the spline support and a small prefilter
+    margin) regardless of the array size. The streamed result agrees with
+    the default algorithm up to the decay of the recursive prefilter across
+    the margin, i.e. to near machine precision.
+
     <b> Usage:</b>
 
         <b>\#include</b> \<vigra/multi_resize.hxx\><br>
@@ -203,11 +368,12 @@ void
 resizeMultiArraySplineInterpolation(
                       SrcIterator si, Shape const & sshape, SrcAccessor src,
                       DestIterator di, Shape const & dshape, DestAccessor dest, 
-                      Kernel const & spline)
+                      Kernel const & spline,
+                      MemoryArena * arena = 0)
 {
     enum { N = 1 + SrcIterator::level };
     typedef typename NumericTraits<typename DestAccessor::value_type>::RealPromote TmpType;
-    typedef MultiArray<N, TmpType> TmpArray;
+    typedef MultiArray<N, TmpType, ArenaAllocator<TmpType> > TmpArray;
     typedef typename AccessorTraits<TmpType>::default_accessor TmpAccessor;
         
     if(N==1)
@@ -220,7 +386,7 @@ resizeMultiArraySplineInterpolation(
         unsigned int d = 0;
         Shape tmpShape(sshape);
         tmpShape[d] = dshape[d];
-        MultiArray<N, TmpType> tmp(tmpShape);
+        TmpArray tmp(tmpShape, ArenaAllocator<TmpType>(arena));
         TmpAccessor ta;
         
         detail::internalResizeMultiArrayOneDimension(si, sshape, src, 
@@ -229,7 +395,7 @@ resizeMultiArraySplineInterpolation(
         for(; d<N-1; ++d)
         {
             tmpShape[d] = dshape[d];
-            MultiArray<N, TmpType> dtmp(tmpShape);
+            TmpArray dtmp(tmpShape, ArenaAllocator<TmpType>(arena));
             
             detail::internalResizeMultiArrayOneDimension(tmp.traverser_begin(), tmp.shape(), ta, 
                                   dtmp.traverser_begin(), tmpShape, ta, spline, d);
@@ -241,15 +407,57 @@ resizeMultiArraySplineInterpolation(
 }
 
 template <class SrcIterator, class Shape, class SrcAccessor,
-          class DestIterator, class DestAccessor, 
+          class DestIterator, class DestAccessor,
+          class Kernel>
+inline void
+resizeMultiArraySplineInterpolation(triple<SrcIterator, Shape, SrcAccessor> src,
+                      triple<DestIterator, Shape, DestAccessor> dest,
+                      Kernel const & spline,
+                      MemoryArena * arena = 0)
+{
+    resizeMultiArraySplineInterpolation(src.first, src.second, src.third,
+                                   dest.first, dest.second, dest.third, spline, arena);
+}
+
+template <class SrcIterator, class Shape, class SrcAccessor,
+          class DestIterator, class DestAccessor,
+          class Kernel>
+void
+resizeMultiArraySplineInterpolation(
+                      SrcIterator si, Shape const & sshape, SrcAccessor src,
+                      DestIterator di, Shape const & dshape, DestAccessor dest,
+                      Kernel const & spline, int slabThickness,
+                      MemoryArena * arena = 0)
+{
+    enum { N = 1 + SrcIterator::level };
+
+    vigra_precondition(slabThickness > 0,
+                 "resizeMultiArraySplineInterpolation(): "
+                 "slabThickness must be > 0.\n");
+
+    if(N == 1 || slabThickness >= dshape[N-1])
+    {
+        resizeMultiArraySplineInterpolation(si, sshape, src, di, dshape, dest, spline, arena);
+    }
+    else
+    {
+        detail::internalResizeMultiArrayStreaming(si, sshape, src,
+                                   di, dshape, dest, spline, slabThickness, arena);
+    }
+}
+
+template <class SrcIterator, class Shape, class SrcAccessor,
+          class DestIterator, class DestAccessor,
           class Kernel>
 inline void
 resizeMultiArraySplineInterpolation(triple<SrcIterator, Shape, SrcAccessor> src,
                       triple<DestIterator, Shape, DestAccessor> dest,
-                      Kernel const & spline)
+                      Kernel const & spline, int slabThickness,
+                      MemoryArena * arena = 0)
 {
     resizeMultiArraySplineInterpolation(src.first, src.second, src.third,
-                                   dest.first, dest.second, dest.third, spline);
+                                   dest.first, dest.second, dest.third,
+                                   spline, slabThickness, arena);
 }
 
 template <class SrcIterator, class Shape, class SrcAccessor,
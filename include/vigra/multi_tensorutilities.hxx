@@ -41,6 +41,7 @@
 #include "mathutil.hxx"
 #include "metaprogramming.hxx"
 #include "multi_pointoperators.hxx"
+#include "parallel_options.hxx"
 
 namespace vigra {
 
@@ -178,6 +179,81 @@ public:
     }
 };
 
+// Compute any combination of eigenvalues, trace, and determinant for a
+// contiguous range of array lines (a line runs along axis 0). Empty views
+// mark outputs that are not requested. Used by tensorAnalysisMultiArray()
+// to process the tensor volume in a single pass, and to distribute the
+// lines across threads in the parallel version.
+template <unsigned int N, class T, int M, class C1,
+          class TE, int ME, class C2,
+          class TT, class C3,
+          class TD, class C4>
+void
+fusedTensorAnalysisLines(MultiArrayView<N, TinyVector<T, M>, C1> const & tensor,
+                         MultiArrayView<N, TinyVector<TE, ME>, C2> & eigenvalues,
+                         MultiArrayView<N, TT, C3> & trace,
+                         MultiArrayView<N, TD, C4> & determinant,
+                         MultiArrayIndex lineBegin, MultiArrayIndex lineEnd)
+{
+    typedef typename MultiArrayShape<N>::type Shape;
+    typedef TinyVector<T, M> TensorType;
+    static const int Dim = (int)N;
+
+    Shape shape = tensor.shape();
+    bool wantEigenvalues = eigenvalues.hasData(),
+         wantTrace       = trace.hasData(),
+         wantDeterminant = determinant.hasData();
+
+    EigenvaluesFunctor<Dim, TensorType, TinyVector<TE, ME> > eigenvaluesFunctor;
+    TensorTraceFunctor<Dim, TensorType>                      traceFunctor;
+    DeterminantFunctor<Dim, TensorType>                      determinantFunctor;
+
+    for(MultiArrayIndex l = lineBegin; l < lineEnd; ++l)
+    {
+        Shape coord;
+        MultiArrayIndex rest = l;
+        for(int k=1; k<Dim; ++k)
+        {
+            coord[k] = rest % shape[k];
+            rest /= shape[k];
+        }
+        for(; coord[0] < shape[0]; ++coord[0])
+        {
+            TensorType const & t = tensor[coord];
+            if(wantEigenvalues)
+                eigenvalues[coord] = eigenvaluesFunctor(t);
+            if(wantTrace)
+                trace[coord] = RequiresExplicitCast<TT>::cast(traceFunctor(t));
+            if(wantDeterminant)
+                determinant[coord] = RequiresExplicitCast<TD>::cast(determinantFunctor(t));
+        }
+    }
+}
+
+template <unsigned int N, class T, int M, class C1,
+          class TE, int ME, class C2,
+          class TT, class C3,
+          class TD, class C4>
+void
+checkTensorAnalysisShapes(MultiArrayView<N, TinyVector<T, M>, C1> const & tensor,
+                          MultiArrayView<N, TinyVector<TE, ME>, C2> const & eigenvalues,
+                          MultiArrayView<N, TT, C3> const & trace,
+                          MultiArrayView<N, TD, C4> const & determinant)
+{
+    static const int Dim = (int)N;
+
+    vigra_precondition(M == Dim*(Dim+1)/2,
+        "tensorAnalysisMultiArray(): Wrong number of channels in input array.");
+    vigra_precondition(!eigenvalues.hasData() || ME == Dim,
+        "tensorAnalysisMultiArray(): Wrong number of channels in eigenvalue array.");
+    vigra_precondition(!eigenvalues.hasData() || eigenvalues.shape() == tensor.shape(),
+        "tensorAnalysisMultiArray(): Shape mismatch between input and eigenvalue array.");
+    vigra_precondition(!trace.hasData() || trace.shape() == tensor.shape(),
+        "tensorAnalysisMultiArray(): Shape mismatch between input and trace array.");
+    vigra_precondition(!determinant.hasData() || determinant.shape() == tensor.shape(),
+        "tensorAnalysisMultiArray(): Shape mismatch between input and determinant array.");
+}
+
 } // namespace detail
 
 
@@ -525,13 +601,147 @@ tensorDeterminantMultiArray(SrcIterator si,  SrcShape const & shape, SrcAccessor
 
 template <class SrcIterator, class SrcShape, class SrcAccessor,
           class DestIterator, class DestAccessor>
-inline void 
+inline void
 tensorDeterminantMultiArray(triple<SrcIterator, SrcShape, SrcAccessor> s,
                             pair<DestIterator, DestAccessor> d)
 {
     tensorDeterminantMultiArray(s.first, s.second, s.third, d.first, d.second);
 }
 
+/********************************************************/
+/*                                                      */
+/*               tensorAnalysisMultiArray               */
+/*                                                      */
+/********************************************************/
+
+/** \brief Calculate eigenvalues, trace, and/or determinant of a N-D tensor array in one pass.
+
+    This function computes any subset of the results of
+    \ref tensorEigenvaluesMultiArray(), \ref tensorTraceMultiArray(), and
+    \ref tensorDeterminantMultiArray() while reading the tensor array only
+    once. When several of these quantities are needed (as, for example, in
+    vesselness filters, which require eigenvalues and trace), this halves
+    the memory traffic compared to calling the individual functions in
+    sequence. Outputs that are not desired are marked by passing a
+    default-constructed (empty) \ref MultiArrayView of the appropriate type;
+    all non-empty output arrays must have the same shape as the input array.
+
+    The second variant accepts a \ref vigra::ParallelOptions argument and
+    distributes the array lines across the given number of threads (when the
+    library is compiled with OpenMP support, otherwise it falls back to
+    serial execution).
+
+    Currently, <tt>N <= 3</tt> is required.
+
+    <b> Declarations:</b>
+
+    \code
+    namespace vigra {
+        template <unsigned int N, class T, int M, class C1,
+                  class TE, int ME, class C2,
+                  class TT, class C3,
+                  class TD, class C4>
+        void
+        tensorAnalysisMultiArray(MultiArrayView<N, TinyVector<T, M>, C1> const & tensor,
+                                 MultiArrayView<N, TinyVector<TE, ME>, C2> eigenvalues,
+                                 MultiArrayView<N, TT, C3> trace,
+                                 MultiArrayView<N, TD, C4> determinant);
+
+        template <unsigned int N, class T, int M, class C1,
+                  class TE, int ME, class C2,
+                  class TT, class C3,
+                  class TD, class C4>
+        void
+        tensorAnalysisMultiArray(MultiArrayView<N, TinyVector<T, M>, C1> const & tensor,
+                                 MultiArrayView<N, TinyVector<TE, ME>, C2> eigenvalues,
+                                 MultiArrayView<N, TT, C3> trace,
+                                 MultiArrayView<N, TD, C4> determinant,
+                                 ParallelOptions const & options);
+    }
+    \endcode
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/multi_tensorutilities.hxx\>
+
+    \code
+    MultiArray<3, float> vol(shape);
+    MultiArray<3, TinyVector<float, 6> > hessian(shape);
+    MultiArray<3, TinyVector<float, 3> > eigenvalues(shape);
+    MultiArray<3, float> trace(shape);
+
+    hessianOfGaussianMultiArray(srcMultiArrayRange(vol), destMultiArray(hessian), 2.0);
+
+    // compute eigenvalues and trace in a single pass, skipping the determinant
+    tensorAnalysisMultiArray(hessian, eigenvalues, trace,
+                             MultiArrayView<3, float>());
+    \endcode
+
+*/
+doxygen_overloaded_function(template <...> void tensorAnalysisMultiArray)
+
+template <unsigned int N, class T, int M, class C1,
+          class TE, int ME, class C2,
+          class TT, class C3,
+          class TD, class C4>
+void
+tensorAnalysisMultiArray(MultiArrayView<N, TinyVector<T, M>, C1> const & tensor,
+                         MultiArrayView<N, TinyVector<TE, ME>, C2> eigenvalues,
+                         MultiArrayView<N, TT, C3> trace,
+                         MultiArrayView<N, TD, C4> determinant)
+{
+    detail::checkTensorAnalysisShapes(tensor, eigenvalues, trace, determinant);
+
+    MultiArrayIndex lineCount = 1;
+    for(unsigned int k=1; k<N; ++k)
+        lineCount *= tensor.shape(k);
+
+    detail::fusedTensorAnalysisLines(tensor, eigenvalues, trace, determinant,
+                                     0, lineCount);
+}
+
+template <unsigned int N, class T, int M, class C1,
+          class TE, int ME, class C2,
+          class TT, class C3,
+          class TD, class C4>
+void
+tensorAnalysisMultiArray(MultiArrayView<N, TinyVector<T, M>, C1> const & tensor,
+                         MultiArrayView<N, TinyVector<TE, ME>, C2> eigenvalues,
+                         MultiArrayView<N, TT, C3> trace,
+                         MultiArrayView<N, TD, C4> determinant,
+                         ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    // fall through to the serial version when the array is too small
+    // for thread startup to pay off
+    if(options.getNumThreads() > 1 && (double)tensor.size() >= 65536.0)
+    {
+        detail::checkTensorAnalysisShapes(tensor, eigenvalues, trace, determinant);
+
+        MultiArrayIndex lineCount = 1;
+        for(unsigned int k=1; k<N; ++k)
+            lineCount *= tensor.shape(k);
+
+        int blockSize = options.getBlockSize((int)lineCount);
+        int blockCount = (int)((lineCount + blockSize - 1) / blockSize);
+
+        #pragma omp parallel for schedule(dynamic) \
+                    num_threads(options.getNumThreads())
+        for(int block = 0; block < blockCount; ++block)
+        {
+            MultiArrayIndex lineBegin = (MultiArrayIndex)block * blockSize,
+                            lineEnd   = std::min(lineCount, lineBegin + blockSize);
+            detail::fusedTensorAnalysisLines(tensor, eigenvalues, trace, determinant,
+                                             lineBegin, lineEnd);
+        }
+        return;
+    }
+#else
+    (void)options;
+#endif
+    tensorAnalysisMultiArray(tensor, eigenvalues, trace, determinant);
+}
+
 //@}
 
 } // namespace vigra
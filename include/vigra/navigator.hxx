@@ -239,6 +239,143 @@ class MultiArrayNavigator<MULTI_ITERATOR, 1>
     MULTI_ITERATOR i_;
 };
 
+/********************************************************/
+/*                                                      */
+/*                 MultiArrayLineRange                  */
+/*                                                      */
+/********************************************************/
+
+/** \brief Random access to the 1D subranges of an n-dimensional range.
+
+    This class provides the same 1D subsets (lines) as
+    \ref vigra::MultiArrayNavigator, but instead of sequentially advancing a
+    single navigator, it maps a line index <tt>0...size()-1</tt> to the
+    corresponding line in constant time. Line indices enumerate the lines in
+    the same order in which a MultiArrayNavigator would visit them. Since
+    all member functions are <tt>const</tt> and the class holds no iteration
+    state, one instance can be shared by any number of threads, and the
+    "process every line along axis d" loops of the multi-dimensional
+    algorithms can be partitioned across threads by simply splitting the
+    line index range.
+
+    The template parameters specify the embedded iterator type and its dimension.
+
+    <b>Usage:</b>
+
+    <b>\#include</b> \<vigra/navigator.hxx\>
+
+    Namespace: vigra
+
+    \code
+    typedef vigra::MultiArray<3, int>  Array;
+
+    Array a(Array::size_type(X, Y, Z));
+
+    typedef vigra::MultiArrayLineRange<Array::traverser, 3> LineRange;
+
+    for(int d=0; d<3; ++d)
+    {
+        // create the line range for dimension d
+        LineRange lines(a.traverser_begin(), a.shape(), d);
+
+        // the loop iterations are independent and may be distributed
+        // across threads (e.g. with '#pragma omp parallel for')
+        for(vigra::MultiArrayIndex l=0; l<lines.size(); ++l)
+        {
+            // inner loop: linear iteration over the current subset
+            //             d == {0, 1, 2}: iterate along {x, y, z}-axis respectively
+            LineRange::iterator i = lines.lineBegin(l), end = lines.lineEnd(l);
+            for(; i != end; ++i)
+                // do something
+        }
+    }
+    \endcode
+*/
+template <class MULTI_ITERATOR, unsigned int N>
+class MultiArrayLineRange
+{
+  public:
+        /** The required shape type for the given iterator type.
+         */
+    typedef typename MULTI_ITERATOR::multi_difference_type shape_type;
+
+        /** The iterator type for the inner loop (result of lineBegin() and lineEnd()).
+         */
+    typedef typename MULTI_ITERATOR::iterator iterator;
+
+        /** Construct the line range for multi-dimensional iterator <TT>i</TT>,
+            array shape <TT>shape</TT> and inner loop dimension <TT>inner_dimension</TT>.
+         */
+    MultiArrayLineRange(MULTI_ITERATOR const & i, shape_type const & shape, unsigned int inner_dimension)
+    : start_(), stop_(shape),
+      inner_dimension_(inner_dimension),
+      i_(i)
+    {}
+
+        /** Construct the line range for the subrange <TT>[start, stop)</TT>.
+         */
+    MultiArrayLineRange(MULTI_ITERATOR const & i, shape_type const & start, shape_type const & stop,
+                        unsigned int inner_dimension)
+    : start_(start), stop_(stop),
+      inner_dimension_(inner_dimension),
+      i_(i)
+    {}
+
+        /** The number of lines in the range.
+         */
+    MultiArrayIndex size() const
+    {
+        MultiArrayIndex res = 1;
+        for(unsigned int k = 0; k < N; ++k)
+            if(k != inner_dimension_)
+                res *= stop_[k] - start_[k];
+        return res;
+    }
+
+        /** The number of elements in every line.
+         */
+    MultiArrayIndex lineLength() const
+    {
+        return stop_[inner_dimension_] - start_[inner_dimension_];
+    }
+
+        /** The coordinate of the first element of the given line.
+            <tt>line</tt> must be in the range <tt>0...size()-1</tt>.
+         */
+    shape_type lineStart(MultiArrayIndex line) const
+    {
+        shape_type coord(start_);
+        for(unsigned int k = 0; k < N; ++k)
+        {
+            if(k == inner_dimension_)
+                continue;
+            MultiArrayIndex extent = stop_[k] - start_[k];
+            coord[k] = start_[k] + line % extent;
+            line /= extent;
+        }
+        return coord;
+    }
+
+        /** Get the beginning of the given line.
+         */
+    iterator lineBegin(MultiArrayIndex line) const
+    {
+        return (i_ + lineStart(line)).iteratorForDimension(inner_dimension_);
+    }
+
+        /** Get the end of the given line.
+         */
+    iterator lineEnd(MultiArrayIndex line) const
+    {
+        return lineBegin(line) + lineLength();
+    }
+
+  protected:
+    shape_type start_, stop_;
+    unsigned int inner_dimension_;
+    MULTI_ITERATOR i_;
+};
+
 /********************************************************/
 /*                                                      */
 /*               MultiCoordinateNavigator               */
@@ -49,6 +49,7 @@
 #include "linear_solve.hxx"
 #include "array_vector.hxx"
 #include "static_assert.hxx"
+#include "parallel_options.hxx"
 #include <algorithm>
 
 namespace vigra {
@@ -96,7 +97,9 @@ class NoiseNormalizationOptions
       noise_estimation_quantile(1.5),
       averaging_quantile(0.8),
       noise_variance_initial_guess(10.0),
-      use_gradient(true)
+      subsample_fraction(1.0),
+      use_gradient(true),
+      parallel_options(ParallelOptions().numThreads(1))
     {}
 
         /** Select the noise estimation algorithm.
@@ -177,9 +180,40 @@ class NoiseNormalizationOptions
         return *this;
     }
 
+        /** Estimate the noise from only a fraction of the candidate windows.
+            The candidate windows (centers of homogeneous regions) are subsampled in
+            a stratified manner, i.e. the used windows are spread evenly over the image.
+            Since the candidates far outnumber the quantities to be estimated, a small
+            fraction is usually sufficient.<br>
+            Default: 1.0 (use all candidate windows)<br>
+            Precondition: 0 < \a fraction <= 1.0
+        */
+    NoiseNormalizationOptions & subsampleFraction(double fraction)
+    {
+        vigra_precondition(fraction > 0.0 && fraction <= 1.0,
+            "NoiseNormalizationOptions: subsample fraction must be between 0 and 1.");
+        subsample_fraction = fraction;
+        return *this;
+    }
+
+        /** Estimate the noise of the candidate windows in parallel.
+            When a \ref vigra::ParallelOptions "ParallelOptions" object requesting more
+            than one thread is passed (and VIGRA was compiled with OpenMP support), the
+            candidate windows are distributed over the given number of threads. The
+            result is independent of the thread count.<br>
+            Default: one thread (sequential estimation)
+        */
+    NoiseNormalizationOptions & parallelOptions(ParallelOptions const & opt)
+    {
+        parallel_options = opt;
+        return *this;
+    }
+
     unsigned int window_radius, cluster_count;
-    double noise_estimation_quantile, averaging_quantile, noise_variance_initial_guess;
+    double noise_estimation_quantile, averaging_quantile, noise_variance_initial_guess,
+           subsample_fraction;
     bool use_gradient;
+    ParallelOptions parallel_options;
 };
 
 //@}
@@ -689,8 +723,14 @@ void noiseVarianceEstimationImpl(SrcIterator sul, SrcIterator slr, SrcAccessor s
     findHomogeneousRegions(gradient.upperLeft(), gradient.lowerRight(), gradient.accessor(),
                                    homogeneous.upperLeft(), homogeneous.accessor());
 
-    // Generate noise of each of the remaining pixels == centers of homogeneous areas (border is not used)
+    // Collect the candidate pixels == centers of homogeneous areas (border is not used).
+    // When a subsample fraction below one is requested, the candidates are subsampled
+    // in a stratified manner: every time the accumulated fraction crosses an integer,
+    // a candidate is kept, so the used windows are spread evenly over the scan order.
     unsigned int windowRadius = options.window_radius;
+    double fraction = options.subsample_fraction;
+    ArrayVector<Diff2D> candidates;
+    unsigned int candidateCount = 0;
     for(unsigned int y=windowRadius; y<h-windowRadius; ++y)
     {
         for(unsigned int x=windowRadius; x<w-windowRadius; ++x)
@@ -698,29 +738,81 @@ void noiseVarianceEstimationImpl(SrcIterator sul, SrcIterator slr, SrcAccessor s
             if (! homogeneous(x, y))
                 continue;
 
-            Diff2D center(x, y);
-            double mean = 0.0, variance = options.noise_variance_initial_guess;
+            ++candidateCount;
+            if ((unsigned int)(candidateCount*fraction) == (unsigned int)((candidateCount-1)*fraction))
+                continue;  // skipped by subsampling
+
+            candidates.push_back(Diff2D(x, y));
+        }
+    }
 
-            bool success;
+    // Generate a noise estimate for each remaining candidate. Every candidate is
+    // processed by exactly one thread, so the result is independent of the thread count.
+    int candidateCountUsed = (int)candidates.size();
+    ArrayVector<double> means(candidateCountUsed), variances(candidateCountUsed);
+    ArrayVector<unsigned char> success(candidateCountUsed, (unsigned char)0);
 
-            if(options.use_gradient)
+    int num_threads = options.parallel_options.getNumThreads();
+#ifdef _OPENMP
+    if(num_threads > 1 && candidateCountUsed > 1)
+    {
+        std::string errorMessage;
+# pragma omp parallel for schedule(dynamic, 16) num_threads(num_threads)
+        for(int i = 0; i < candidateCountUsed; ++i)
+        {
+            try
+            {
+                double mean = 0.0, variance = options.noise_variance_initial_guess;
+                if(options.use_gradient)
+                {
+                    success[i] = iterativeNoiseEstimationChi2(sul + candidates[i], src,
+                                     gradient.upperLeft() + candidates[i], mean, variance,
+                                     options.noise_estimation_quantile, windowRadius);
+                }
+                else
+                {
+                    success[i] = iterativeNoiseEstimationGauss(sul + candidates[i], src,
+                                     gradient.upperLeft() + candidates[i], mean, variance,
+                                     options.noise_estimation_quantile, windowRadius);
+                }
+                means[i] = mean;
+                variances[i] = variance;
+            }
+            catch(std::exception & e)
             {
-                success = iterativeNoiseEstimationChi2(sul + center, src,
-                              gradient.upperLeft() + center, mean, variance,
-                              options.noise_estimation_quantile, windowRadius);
+# pragma omp critical(vigra_noise_estimation_error)
+                errorMessage = e.what();
             }
-            else
+        }
+        if(!errorMessage.empty())
+            vigra_fail("noiseVarianceEstimation(): worker thread failed with:\n" + errorMessage);
+    }
+    else
+#endif // _OPENMP
+    {
+        for(int i = 0; i < candidateCountUsed; ++i)
+        {
+            double mean = 0.0, variance = options.noise_variance_initial_guess;
+            if(options.use_gradient)
             {
-                success = iterativeNoiseEstimationGauss(sul + center, src,
-                              gradient.upperLeft() + center, mean, variance,
-                              options.noise_estimation_quantile, windowRadius);
+                success[i] = iterativeNoiseEstimationChi2(sul + candidates[i], src,
+                                 gradient.upperLeft() + candidates[i], mean, variance,
+                                 options.noise_estimation_quantile, windowRadius);
             }
-            if (success)
+            else
             {
-                result.push_back(ResultType(mean, variance));
+                success[i] = iterativeNoiseEstimationGauss(sul + candidates[i], src,
+                                 gradient.upperLeft() + candidates[i], mean, variance,
+                                 options.noise_estimation_quantile, windowRadius);
             }
+            means[i] = mean;
+            variances[i] = variance;
         }
     }
+
+    for(int i = 0; i < candidateCountUsed; ++i)
+        if(success[i])
+            result.push_back(ResultType(means[i], variances[i]));
 }
 
 template <class Vector, class BackInsertable>
@@ -41,6 +41,7 @@
 #include "stdimagefunctions.hxx"
 #include "imageiteratoradapter.hxx"
 #include "functortraits.hxx"
+#include "parallel_options.hxx"
 
 namespace vigra {
 
@@ -181,6 +182,121 @@ void internalNonlinearDiffusionAOSStep(
     }
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class WeightIterator, class WeightAccessor,
+          class DestIterator, class DestAccessor>
+void internalNonlinearDiffusionAOSStep(
+                   SrcIterator sul, SrcIterator slr, SrcAccessor as,
+                   WeightIterator wul, WeightAccessor aw,
+                   DestIterator dul, DestAccessor ad, double timestep,
+                   ParallelOptions const & options)
+{
+#ifndef _OPENMP
+    internalNonlinearDiffusionAOSStep(sul, slr, as, wul, aw, dul, ad, timestep);
+    (void)options;
+#else
+    if(options.getNumThreads() == 1)
+    {
+        internalNonlinearDiffusionAOSStep(sul, slr, as, wul, aw, dul, ad, timestep);
+        return;
+    }
+
+    // use traits to determine SumType as to prevent possible overflow
+    typedef typename
+        NumericTraits<typename DestAccessor::value_type>::RealPromote
+        DestType;
+
+    typedef typename
+        NumericTraits<typename WeightAccessor::value_type>::RealPromote
+        WeightType;
+
+    // calculate width and height of the image
+    int w = slr.x - sul.x;
+    int h = slr.y - sul.y;
+    int d = (w < h) ? h : w;
+
+    WeightType one = NumericTraits<WeightType>::one();
+
+    // the tridiagonal systems of the rows (and likewise those of the
+    // columns) are independent -- solve them concurrently, with
+    // per-thread matrix and result buffers
+    #pragma omp parallel num_threads(options.getNumThreads())
+    {
+        std::vector<WeightType> lower(d),
+                                diag(d),
+                                upper(d),
+                                res(d);
+
+        int x, y;
+
+        // x-direction
+        #pragma omp for
+        for(y=0; y<h; ++y)
+        {
+            typename SrcIterator::row_iterator xs = (sul + Diff2D(0, y)).rowIterator();
+            typename WeightIterator::row_iterator xw = (wul + Diff2D(0, y)).rowIterator();
+            typename DestIterator::row_iterator xd = (dul + Diff2D(0, y)).rowIterator();
+
+            // fill 3-diag matrix
+
+            diag[0] = one + timestep * (aw(xw) + aw(xw, 1));
+            for(x=1; x<w-1; ++x)
+            {
+                diag[x] = one + timestep * (2.0 * aw(xw, x) + aw(xw, x+1) + aw(xw, x-1));
+            }
+            diag[w-1] = one + timestep * (aw(xw, w-1) + aw(xw, w-2));
+
+            for(x=0; x<w-1; ++x)
+            {
+                lower[x] = -timestep * (aw(xw, x) + aw(xw, x+1));
+                upper[x] = lower[x];
+            }
+
+            internalNonlinearDiffusionDiagonalSolver(xs, xs+w, as,
+                                diag.begin(), upper.begin(), lower.begin(), res.begin());
+
+            for(x=0; x<w; ++x, ++xd)
+            {
+                ad.set(res[x], xd);
+            }
+        }
+        // implicit barrier: the y-direction reads what the x-direction wrote
+
+        // y-direction
+        #pragma omp for
+        for(x=0; x<w; ++x)
+        {
+            typename SrcIterator::column_iterator xs = (sul + Diff2D(x, 0)).columnIterator();
+            typename WeightIterator::column_iterator xw = (wul + Diff2D(x, 0)).columnIterator();
+            typename DestIterator::column_iterator xd = (dul + Diff2D(x, 0)).columnIterator();
+
+            // fill 3-diag matrix
+
+            diag[0] = one + timestep * (aw(xw) + aw(xw, 1));
+            for(y=1; y<h-1; ++y)
+            {
+                diag[y] = one + timestep * (2.0 * aw(xw, y) + aw(xw, y+1) + aw(xw, y-1));
+            }
+            diag[h-1] = one + timestep * (aw(xw, h-1) + aw(xw, h-2));
+
+            for(y=0; y<h-1; ++y)
+            {
+                lower[y] = -timestep * (aw(xw, y) + aw(xw, y+1));
+                upper[y] = lower[y];
+            }
+
+            internalNonlinearDiffusionDiagonalSolver(xs, xs+h, as,
+                                diag.begin(), upper.begin(), lower.begin(), res.begin());
+
+            for(y=0; y<h; ++y, ++xd)
+            {
+                ad.set(0.5 * (ad(xd) + res[y]), xd);
+            }
+        }
+    }
+#endif // _OPENMP
+}
+
 /** \addtogroup NonLinearDiffusion Non-linear Diffusion and Total Variation
     
     Perform edge-preserving smoothing.
@@ -366,6 +482,94 @@ void nonlinearDiffusion(
                            weight, scale);
 }
 
+/** \brief Perform edge-preserving smoothing in parallel.
+
+    These overloads of \ref nonlinearDiffusion() take a
+    \ref vigra::ParallelOptions object. Each AOS step solves one independent
+    tridiagonal system per row and per column; the parallel version distributes
+    these solves over OpenMP threads, so the iteration count and the results
+    stay the same while the wall-clock time drops with the core count. When the
+    library is compiled without OpenMP, the sequential algorithm is used.
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/nonlineardiffusion.hxx\>
+
+    \code
+    FImage src(w,h), dest(w,h);
+    float edge_threshold, scale;
+    ...
+
+    nonlinearDiffusion(srcImageRange(src), destImage(dest),
+                       DiffusivityFunctor<float>(edge_threshold), scale,
+                       ParallelOptions().numThreads(4));
+    \endcode
+*/
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor,
+          class DiffusivityFunc>
+void nonlinearDiffusion(SrcIterator sul, SrcIterator slr, SrcAccessor as,
+                   DestIterator dul, DestAccessor ad,
+                   DiffusivityFunc const & weight, double scale,
+                   ParallelOptions const & options)
+{
+    vigra_precondition(scale > 0.0, "nonlinearDiffusion(): scale must be > 0");
+
+    double total_time = scale*scale/2.0;
+    const double time_step = 5.0;
+    int number_of_steps = (int)(total_time / time_step);
+    double rest_time = total_time - time_step * number_of_steps;
+
+    Size2D size(slr.x - sul.x, slr.y - sul.y);
+
+    typedef typename
+        NumericTraits<typename SrcAccessor::value_type>::RealPromote
+        TmpType;
+    typedef typename DiffusivityFunc::value_type WeightType;
+
+    BasicImage<TmpType> smooth1(size);
+    BasicImage<TmpType> smooth2(size);
+
+    BasicImage<WeightType> weights(size);
+
+    typename BasicImage<TmpType>::Iterator s1 = smooth1.upperLeft(),
+                                  s2 = smooth2.upperLeft();
+    typename BasicImage<TmpType>::Accessor a = smooth1.accessor();
+
+    typename BasicImage<WeightType>::Iterator wi = weights.upperLeft();
+    typename BasicImage<WeightType>::Accessor wa = weights.accessor();
+
+    gradientBasedTransform(sul, slr, as, wi, wa, weight);
+
+    internalNonlinearDiffusionAOSStep(sul, slr, as, wi, wa, s1, a, rest_time, options);
+
+    for(int i = 0; i < number_of_steps; ++i)
+    {
+        gradientBasedTransform(s1, s1+size, a, wi, wa, weight);
+
+        internalNonlinearDiffusionAOSStep(s1, s1+size, a, wi, wa, s2, a, time_step, options);
+
+        std::swap(s1, s2);
+    }
+
+    copyImage(s1, s1+size, a, dul, ad);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor,
+          class DiffusivityFunc>
+inline
+void nonlinearDiffusion(
+    triple<SrcIterator, SrcIterator, SrcAccessor> src,
+    pair<DestIterator, DestAccessor> dest,
+    DiffusivityFunc const & weight, double scale,
+    ParallelOptions const & options)
+{
+    nonlinearDiffusion(src.first, src.second, src.third,
+                           dest.first, dest.second,
+                           weight, scale, options);
+}
+
 template <class SrcIterator, class SrcAccessor,
           class WeightIterator, class WeightAccessor,
           class DestIterator, class DestAccessor>
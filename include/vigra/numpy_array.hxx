@@ -682,10 +682,11 @@ class NumpyArray
          * Otherwise, the function attempts to create a
          * new reference to the given Python object, unless
          * copying is forced by setting \a createCopy to true.
-         * If either of this fails, the function throws an exception.
-         * This will not happen if isReferenceCompatible(obj) (in case
-         * of creating a new reference) or isCopyCompatible(obj)
-         * (in case of copying) have returned true beforehand.
+         * When the object's memory layout cannot be referenced
+         * directly (see isReferenceCompatible()), a copy is made as a
+         * last resort, provided that obj is at least copy compatible
+         * (see isCopyCompatible()) and has a matching value type.
+         * If all of this fails, the function throws an exception.
          */
     explicit NumpyArray(PyObject *obj = 0, bool createCopy = false)
     {
@@ -693,9 +694,13 @@ class NumpyArray
             return;
         if(createCopy)
             makeCopy(obj);
-        else
-            vigra_precondition(makeReference(obj),
+        else if(!makeReference(obj))
+        {
+            vigra_precondition(isCopyCompatible(obj) &&
+                               ArrayTraits::isValuetypeCompatible((PyArrayObject *)obj),
                   "NumpyArray(obj): Cannot construct from incompatible array.");
+            makeCopy(obj);
+        }
     }
 
        /**
@@ -765,9 +770,13 @@ class NumpyArray
             return;
         if(createCopy)
             makeCopy(other.pyObject());
-        else
-            vigra_precondition(makeReference(other.pyObject()), //, false),
+        else if(!makeReference(other.pyObject()))
+        {
+            vigra_precondition(isCopyCompatible(other.pyObject()) &&
+                               ArrayTraits::isValuetypeCompatible((PyArrayObject *)other.pyObject()),
                    "NumpyArray(NumpyAnyArray): Cannot construct from incompatible or empty array.");
+            makeCopy(other.pyObject());
+        }
     }
 
         /**
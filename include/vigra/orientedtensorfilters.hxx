@@ -40,6 +40,8 @@
 #include "utilities.hxx"
 #include "initimage.hxx"
 #include "stdconvolution.hxx"
+#include "array_vector.hxx"
+#include "parallel_options.hxx"
 
 namespace vigra {
 
@@ -199,6 +201,182 @@ void hourGlassFilter(triple<SrcIterator, SrcIterator, SrcAccessor> s,
     hourGlassFilter(s.first, s.second, s.third, d.first, d.second, sigma, rho);
 }
 
+/********************************************************/
+/*                                                      */
+/*                 HourGlassKernelTable                 */
+/*                                                      */
+/********************************************************/
+
+/** \brief Precomputed hourglass filter stencils for a set of orientation bins.
+
+    The plain \ref hourGlassFilter() evaluates an exponential for every
+    stencil element of every pixel, because the stencil depends on the local
+    edge orientation. This table samples the orientation range [-pi/2, pi/2)
+    with <tt>orientationBins</tt> equidistant bins (the hourglass kernel has
+    period pi) and precomputes the complete stencil for each bin, so the
+    filter is reduced to one <tt>atan2()</tt> per pixel plus multiply-adds.
+    The default of 180 bins (one degree spacing) keeps the quantization error
+    well below the accuracy of the orientation estimate itself; increase the
+    bin count if your application is sensitive to it. The table can be reused
+    across any number of images.
+*/
+class HourGlassKernelTable
+{
+  public:
+    HourGlassKernelTable(double sigma, double rho, unsigned int orientationBins = 180)
+    : radius_((int)VIGRA_CSTD::floor(3.0*sigma + 0.5)),
+      binCount_(orientationBins),
+      weights_(orientationBins)
+    {
+        vigra_precondition(sigma >= 0.0 && rho >= 0.0,
+                           "HourGlassKernelTable(): sigma and rho must be >= 0.0");
+        vigra_precondition(orientationBins > 0,
+                           "HourGlassKernelTable(): need at least one orientation bin.");
+
+        double sigma2 = -0.5 / sigma / sigma;
+        double rho2 = -0.5 / rho / rho;
+        double norm = 1.0 / (2.0 * M_PI * sigma * sigma);
+
+        for(unsigned int b = 0; b < orientationBins; ++b)
+        {
+            double phi = M_PI * ((double)b / orientationBins - 0.5);
+            double u = VIGRA_CSTD::sin(phi);
+            double v = VIGRA_CSTD::cos(phi);
+
+            weights_[b].resize(2*radius_+1, 2*radius_+1);
+            for(int yy = -radius_; yy <= radius_; ++yy)
+            {
+                for(int xx = -radius_; xx <= radius_; ++xx)
+                {
+                    double r2 = xx*xx + yy*yy;
+                    double p  = u*xx - v*yy;
+                    double q  = v*xx + u*yy;
+                    weights_[b](xx+radius_, yy+radius_) = (p == 0.0) ?
+                                      (q == 0.0) ?
+                                       norm :
+                                       0.0 :
+                                       norm * VIGRA_CSTD::exp(sigma2*r2 + rho2*q*q/p/p);
+                }
+            }
+        }
+    }
+
+    int radius() const
+        { return radius_; }
+
+    unsigned int binCount() const
+        { return binCount_; }
+
+        /** Index of the bin whose center is closest to the orientation
+            <tt>phi</tt> (in radians, any value is wrapped into the period).
+        */
+    unsigned int binOfOrientation(double phi) const
+    {
+        int b = (int)VIGRA_CSTD::floor((phi / M_PI + 0.5) * binCount_ + 0.5);
+        b %= (int)binCount_;
+        if(b < 0)
+            b += binCount_;
+        return (unsigned int)b;
+    }
+
+    DImage const & weights(unsigned int bin) const
+        { return weights_[bin]; }
+
+    int radius_;
+    unsigned int binCount_;
+    ArrayVector<DImage> weights_;
+};
+
+/** \brief Hourglass filtering with precomputed stencils, parallelized over rows.
+
+    This overload of \ref hourGlassFilter() takes the stencils from the given
+    \ref HourGlassKernelTable instead of evaluating the hourglass kernel
+    per pixel. It first quantizes the orientation of every pixel into the
+    table's bins and then accumulates each output pixel by gathering from its
+    neighborhood, so every destination row is written by exactly one thread
+    and the result does not depend on the number of threads used. Apart from
+    the orientation quantization (see \ref HourGlassKernelTable) and the
+    summation order, the result is the same as that of the plain filter.
+*/
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void hourGlassFilter(SrcIterator sul, SrcIterator slr, SrcAccessor src,
+                     DestIterator dul, DestAccessor dest,
+                     HourGlassKernelTable const & table,
+                     ParallelOptions const & options = ParallelOptions())
+{
+    vigra_precondition(src.size(sul) == 3,
+                       "hourGlassFilter(): input image must have 3 bands.");
+    vigra_precondition(dest.size(dul) == 3,
+                       "hourGlassFilter(): output image must have 3 bands.");
+
+    int w = slr.x - sul.x;
+    int h = slr.y - sul.y;
+    int radius = table.radius();
+
+    typedef typename NumericTraits<typename SrcAccessor::value_type>::RealPromote SumType;
+
+    IImage bins(w, h);
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(options.getNumThreads())
+#endif
+    {
+        // quantize the orientation of every pixel once
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for(int y=0; y<h; ++y)
+        {
+            SrcIterator s = sul + Diff2D(0, y);
+            for(int x=0; x<w; ++x, ++s.x)
+            {
+                double phi = 0.5 * VIGRA_CSTD::atan2(
+                                         2.0*src.getComponent(s,1),
+                                         (double)src.getComponent(s,0) - src.getComponent(s,2));
+                bins(x, y) = (int)table.binOfOrientation(phi);
+            }
+        }
+        // implicit barrier, then gather with the cached stencils
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for(int y=0; y<h; ++y)
+        {
+            DestIterator d = dul + Diff2D(0, y);
+            int ys0 = y - radius < 0 ? 0 : y - radius;
+            int ys1 = y + radius >= h ? h - 1 : y + radius;
+            for(int x=0; x<w; ++x, ++d.x)
+            {
+                int xs0 = x - radius < 0 ? 0 : x - radius;
+                int xs1 = x + radius >= w ? w - 1 : x + radius;
+
+                SumType sum = NumericTraits<SumType>::zero();
+                for(int ys=ys0; ys <= ys1; ++ys)
+                {
+                    SrcIterator s = sul + Diff2D(xs0, ys);
+                    for(int xs=xs0; xs <= xs1; ++xs, ++s.x)
+                    {
+                        sum += table.weights(bins(xs, ys))(x-xs+radius, y-ys+radius) * src(s);
+                    }
+                }
+                dest.set(sum, d);
+            }
+        }
+    }
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline
+void hourGlassFilter(triple<SrcIterator, SrcIterator, SrcAccessor> s,
+                     pair<DestIterator, DestAccessor> d,
+                     HourGlassKernelTable const & table,
+                     ParallelOptions const & options = ParallelOptions())
+{
+    hourGlassFilter(s.first, s.second, s.third, d.first, d.second, table, options);
+}
+
 /********************************************************/
 /*                                                      */
 /*                    ellipticGaussian                  */
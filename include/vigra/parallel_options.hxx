@@ -0,0 +1,174 @@
+/************************************************************************/
+/*                                                                      */
+/*               Copyright 2011-2012 by Ullrich Koethe                  */
+/*                                                                      */
+/*    This file is part of the VIGRA computer vision library.           */
+/*    The VIGRA Website is                                              */
+/*        http://hci.iwr.uni-heidelberg.de/vigra/                       */
+/*    Please direct questions, bug reports, and contributions to        */
+/*        ullrich.koethe@iwr.uni-heidelberg.de    or                    */
+/*        vigra@informatik.uni-hamburg.de                               */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+#ifndef VIGRA_PARALLEL_OPTIONS_HXX
+#define VIGRA_PARALLEL_OPTIONS_HXX
+
+#include "config.hxx"
+
+#ifdef _OPENMP
+#  include <omp.h>
+#endif
+
+namespace vigra {
+
+namespace detail {
+
+    // Global default thread count, configured via setGlobalNumThreads()
+    // in threadpool.hxx (ParallelOptions::Auto: one thread per processor).
+inline int & globalNumThreadsSetting()
+{
+    static int setting = 0; // == ParallelOptions::Auto
+    return setting;
+}
+
+} // namespace detail
+
+/** \brief Options object for algorithms that support parallel execution.
+
+    Several VIGRA algorithms offer overloads that distribute their
+    per-line or per-block work across multiple threads (using OpenMP when
+    the library is compiled with OpenMP support, and falling back to
+    serial execution otherwise). A <tt>ParallelOptions</tt> object
+    specifies the desired thread count and work distribution granularity
+    for such a call.
+
+    <b>Usage:</b>
+
+    <b>\#include</b> \<vigra/parallel_options.hxx\>
+
+    Namespace: vigra
+
+    \code
+    MultiArray<3, float> source(shape), dest(shape);
+    Kernel1D<double> gauss;
+    gauss.initGaussian(2.0);
+
+    // convolve with 4 threads, distributing the lines in blocks of 32
+    separableConvolveMultiArray(srcMultiArrayRange(source),
+                                destMultiArray(dest), gauss,
+                                ParallelOptions().numThreads(4).blockSize(32));
+    \endcode
+*/
+class ParallelOptions
+{
+  public:
+        /** Constant for numThreads() requesting as many threads as the
+            runtime reports processors (the default).
+        */
+    enum { Auto = 0 };
+
+    ParallelOptions()
+    : num_threads_(Auto),
+      block_size_(0)
+    {}
+
+        /** Set the number of threads to use.
+
+            <tt>ParallelOptions::Auto</tt> (the default) uses one thread
+            per processor; <tt>1</tt> forces serial execution.
+        */
+    ParallelOptions & numThreads(int n)
+    {
+        num_threads_ = n < 0 ? int(Auto) : n;
+        return *this;
+    }
+
+        /** Return the number of threads that will actually be used.
+
+            <tt>Auto</tt> is resolved against the global thread pool
+            (see \ref setGlobalNumThreads()), which defaults to one
+            thread per processor. Inside an existing parallel region,
+            the result is always 1, so that nested parallel calls
+            execute serially in their worker thread instead of
+            oversubscribing the machine.
+        */
+    int getNumThreads() const
+    {
+#ifdef _OPENMP
+        if(omp_in_parallel())
+            return 1;
+#endif
+        if(num_threads_ != int(Auto))
+            return num_threads_;
+        if(detail::globalNumThreadsSetting() != int(Auto))
+            return detail::globalNumThreadsSetting();
+        return maxThreads();
+    }
+
+        /** Set the number of work items (e.g. array lines) each thread
+            grabs at a time.
+
+            Zero (the default) lets the algorithm choose a granularity
+            that balances scheduling overhead against load balancing.
+        */
+    ParallelOptions & blockSize(int s)
+    {
+        block_size_ = s < 0 ? 0 : s;
+        return *this;
+    }
+
+        /** Resolve the block size against a concrete workload of
+            <tt>workload</tt> items (result is always at least 1).
+        */
+    int getBlockSize(int workload) const
+    {
+        if(block_size_ > 0)
+            return block_size_;
+        int blocks = 8 * getNumThreads();
+        int size = (workload + blocks - 1) / blocks;
+        return size < 1 ? 1 : size;
+    }
+
+        /** Number of threads the runtime offers (1 when the library
+            was compiled without OpenMP support).
+        */
+    static int maxThreads()
+    {
+#ifdef _OPENMP
+        return omp_get_max_threads();
+#else
+        return 1;
+#endif
+    }
+
+  private:
+    int num_threads_;
+    int block_size_;
+};
+
+} // namespace vigra
+
+#endif // VIGRA_PARALLEL_OPTIONS_HXX
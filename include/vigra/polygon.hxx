@@ -43,6 +43,7 @@
 #include "config.hxx"
 #include "error.hxx"
 #include "array_vector.hxx"
+#include "matrix.hxx"
 
 namespace vigra {
 
@@ -123,6 +124,303 @@ void convexHull(const PointArray1 &points, PointArray2 & convex_hull)
     std::copy(H.begin(), H.begin()+k, std::back_inserter(convex_hull));
 }
 
+/** \brief Apply an affine transformation to an array of 2D points.
+
+    The input array \a points contains 2D points (e.g. <tt>TinyVector<double, 2></tt>)
+    which are mapped by the affine part of the homogeneous 3x3 matrix \a transform
+    (as created, for example, by \ref rotationMatrix2DDegrees()) into the array
+    \a result, which is resized appropriately. The function may be called with
+    identical \a points and \a result for an in-place transformation.
+
+    In contrast to transforming the points one at a time, the bulk loop reads
+    the transformation coefficients only once and processes the coordinates in
+    a form that optimizing compilers can vectorize, which matters when millions
+    of polygon vertices must be mapped.
+*/
+template<class PointArray1, class PointArray2>
+void transformPoints(const PointArray1 & points, Matrix<double> const & transform,
+                     PointArray2 & result)
+{
+    vigra_precondition(rowCount(transform) == 3 && columnCount(transform) == 3,
+                       "transformPoints(): homogeneous 3x3 transformation matrix required.");
+
+    typedef typename PointArray2::value_type Point;
+
+    double a00 = transform(0,0), a01 = transform(0,1), t0 = transform(0,2),
+           a10 = transform(1,0), a11 = transform(1,1), t1 = transform(1,2);
+
+    std::size_t n = points.size();
+    result.resize(n);
+    for(std::size_t k = 0; k < n; ++k)
+    {
+        double x = points[k][0],
+               y = points[k][1];
+        result[k] = Point(a00*x + a01*y + t0,
+                          a10*x + a11*y + t1);
+    }
+}
+
+/** \brief Convex hull with reusable storage and incremental updates.
+
+    This class computes the same convex hull as \ref convexHull() (Andrew's
+    Monotone Chain algorithm), but keeps its working arrays between calls, so
+    that repeated hull computations (e.g. one per contour of a large volume) do
+    not allocate memory once the arrays have grown to their working size. In
+    addition, points can be added incrementally via addPoint(), which updates
+    the existing hull in time proportional to the number of hull points removed
+    instead of recomputing it from scratch.
+
+    The hull is stored as an open counter-clockwise ring of the extreme points
+    (accessible via hull()). hullPolygon() writes the closed polygon in the
+    format of \ref convexHull(), i.e. starting at the leftmost point and
+    repeating the first point at the end.
+
+    <b> Usage:</b>
+
+        <b>\#include</b> \<vigra/polygon.hxx\><br>
+    Namespace: vigra
+
+    \code
+    typedef vigra::TinyVector<double, 2> Point;
+    vigra::IncrementalConvexHull<Point> hull;
+
+    for(unsigned int k = 0; k < contours.size(); ++k)
+    {
+        hull.compute(contours[k]);       // reuses internal storage
+
+        while(...)
+            hull.addPoint(...);          // incremental update
+
+        vigra::ArrayVector<Point> polygon;
+        hull.hullPolygon(polygon);
+    }
+    \endcode
+*/
+template<class Point>
+class IncrementalConvexHull
+{
+  public:
+    typedef Point point_type;
+    typedef ArrayVector<Point> PointArray;
+
+        /** Create an empty hull.
+        */
+    IncrementalConvexHull()
+    {}
+
+        /** Create the convex hull of the given points (same as compute()).
+        */
+    template<class PointArray1>
+    IncrementalConvexHull(const PointArray1 & points)
+    {
+        compute(points);
+    }
+
+        /** Compute the convex hull of the given points.
+
+            Replaces the current hull. Internal storage is reused, so no
+            allocation happens when the hull of a similarly sized point set
+            has been computed before.
+        */
+    template<class PointArray1>
+    void compute(const PointArray1 & points)
+    {
+        vigra_precondition(points.size() >= 2,
+                           "IncrementalConvexHull::compute(): at least two input points are needed.");
+        vigra_precondition(points[0].size() == 2,
+                           "IncrementalConvexHull::compute(): 2-dimensional points required.");
+
+        ordered_.clear();
+        ordered_.reserve(points.size());
+        for(std::size_t i = 0; i < (std::size_t)points.size(); ++i)
+            ordered_.push_back(points[i]);
+        std::sort(ordered_.begin(), ordered_.end(), detail::sortPoints<Point>);
+
+        hull_.clear();
+
+        int n = ordered_.size(), k = 0;
+
+        // build lower hull
+        for(int i = 0; i < n; i++)
+        {
+            while(k >= 2 && detail::orderedClockwise(hull_[k-2], hull_[k-1], ordered_[i]))
+            {
+                hull_.pop_back();
+                --k;
+            }
+            hull_.push_back(ordered_[i]);
+            ++k;
+        }
+
+        // build upper hull
+        for(int i = n-2, t = k+1; i >= 0; i--)
+        {
+            while(k >= t && detail::orderedClockwise(hull_[k-2], hull_[k-1], ordered_[i]))
+            {
+                hull_.pop_back();
+                --k;
+            }
+            hull_.push_back(ordered_[i]);
+            ++k;
+        }
+
+        // drop the closing duplicate of the first point - the hull
+        // is stored as an open ring
+        hull_.pop_back();
+    }
+
+        /** Add a single point to the hull.
+
+            If the point lies inside or on the current hull, nothing changes.
+            Otherwise, the hull points that become interior are removed and
+            the new point is inserted. Returns whether the hull was modified.
+        */
+    bool addPoint(Point const & p)
+    {
+        int n = hull_.size();
+        if(n == 0)
+        {
+            hull_.push_back(p);
+            return true;
+        }
+        if(n == 1)
+        {
+            if(p == hull_[0])
+                return false;
+            if(detail::sortPoints(p, hull_[0]))
+                hull_.insert(hull_.begin(), p);
+            else
+                hull_.push_back(p);
+            return true;
+        }
+        if(n == 2)
+        {
+            double c = cross(hull_[0], hull_[1], p);
+            if(c > 0.0)
+            {
+                hull_.push_back(p);
+                return true;
+            }
+            if(c < 0.0)
+            {
+                hull_.insert(hull_.begin() + 1, p);
+                return true;
+            }
+            // collinear - keep the two extreme points
+            Point lo = hull_[0], hi = hull_[1];
+            if(detail::sortPoints(p, lo))
+                lo = p;
+            else if(detail::sortPoints(hi, p))
+                hi = p;
+            else
+                return false;
+            hull_[0] = lo;
+            hull_[1] = hi;
+            return true;
+        }
+
+        // mark the hull edges from which p is strictly visible
+        visible_.resize(n);
+        bool any = false;
+        for(int i = 0; i < n; ++i)
+        {
+            visible_[i] = cross(hull_[i], hull_[(i+1) % n], p) < 0.0;
+            any = any || visible_[i] != 0;
+        }
+        if(!any)
+            return false;     // p is inside or on the hull
+
+        // the visible edges form one contiguous arc [s, t] of the ring
+        int s = -1;
+        for(int i = 0; i < n; ++i)
+        {
+            if(visible_[i] && !visible_[(i+n-1) % n])
+            {
+                s = i;
+                break;
+            }
+        }
+        if(s < 0)
+            return false;     // cannot happen for a consistent hull
+        int t = s;
+        while(visible_[(t+1) % n])
+            t = (t+1) % n;
+
+        // keep the invisible arc and append p
+        scratch_.clear();
+        for(int i = (t+1) % n; true; i = (i+1) % n)
+        {
+            scratch_.push_back(hull_[i]);
+            if(i == s)
+                break;
+        }
+        scratch_.push_back(p);
+        hull_.swap(scratch_);
+
+        // p may have turned its neighbors into collinear points - remove them
+        while(hull_.size() > 3)
+        {
+            int m = hull_.size();
+            if(cross(hull_[m-3], hull_[m-2], hull_[m-1]) > 0.0)
+                break;
+            hull_.erase(hull_.end() - 2);
+        }
+        while(hull_.size() > 3)
+        {
+            int m = hull_.size();
+            if(cross(hull_[m-1], hull_[0], hull_[1]) > 0.0)
+                break;
+            hull_.erase(hull_.begin());
+        }
+        return true;
+    }
+
+        /** The current hull as an open counter-clockwise ring.
+        */
+    PointArray const & hull() const
+    {
+        return hull_;
+    }
+
+        /** Number of points on the current hull.
+        */
+    std::size_t size() const
+    {
+        return hull_.size();
+    }
+
+        /** Append the closed hull polygon to \a polygon.
+
+            The output matches \ref convexHull(): counter-clockwise order,
+            starting with the leftmost point, which is repeated at the end.
+        */
+    template<class PointArray1>
+    void hullPolygon(PointArray1 & polygon) const
+    {
+        int n = hull_.size();
+        if(n == 0)
+            return;
+        int start = 0;
+        for(int i = 1; i < n; ++i)
+        {
+            if(detail::sortPoints(hull_[i], hull_[start]))
+                start = i;
+        }
+        for(int i = 0; i < n; ++i)
+            polygon.push_back(hull_[(start + i) % n]);
+        polygon.push_back(hull_[start]);
+    }
+
+  private:
+    static double cross(Point const & o, Point const & a, Point const & b)
+    {
+        return (a[0] - o[0]) * (b[1] - o[1]) - (a[1] - o[1]) * (b[0] - o[0]);
+    }
+
+    ArrayVector<Point> hull_, ordered_, scratch_;
+    ArrayVector<unsigned char> visible_;
+};
+
 //@}
 
 } // namespace vigra
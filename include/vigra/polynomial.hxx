@@ -863,7 +863,7 @@ struct PolynomialRootCompare
     PolynomialRootCompare(Real eps)
     : epsilon(eps)
     {}
-    
+
     template <class T>
     bool operator()(T const & l, T const & r)
     {
@@ -873,7 +873,227 @@ struct PolynomialRootCompare
     }
 };
 
-} // namespace detail 
+// closed-form real-root computation for polynomials up to order 4;
+// all functions append the real roots (counted with multiplicity) to
+// the array 'r' and return their number, using real arithmetic only
+
+inline double realCbrt(double x)
+{
+    return x < 0.0
+              ? -VIGRA_CSTD::pow(-x, 1.0/3.0)
+              :  VIGRA_CSTD::pow(x, 1.0/3.0);
+}
+
+inline unsigned int realLinearRoots(double const * c, double * r)
+{
+    if(c[1] == 0.0)
+        return 0;
+    r[0] = -c[0] / c[1];
+    return 1;
+}
+
+inline unsigned int realQuadraticRoots(double const * c, double * r)
+{
+    double disc = c[1]*c[1] - 4.0*c[2]*c[0];
+    if(disc < 0.0)
+        return 0;
+    double q = c[1] >= 0.0
+                  ? -0.5 * (c[1] + VIGRA_CSTD::sqrt(disc))
+                  : -0.5 * (c[1] - VIGRA_CSTD::sqrt(disc));
+    if(q == 0.0)  // implies c[1] == 0 and c[0] == 0
+    {
+        r[0] = r[1] = 0.0;
+    }
+    else
+    {
+        r[0] = q / c[2];
+        r[1] = c[0] / q;
+    }
+    return 2;
+}
+
+inline unsigned int realCubicRoots(double const * c, double * r)
+{
+    double b = c[2] / c[3],
+           c1 = c[1] / c[3],
+           d = c[0] / c[3];
+    double shift = b / 3.0;
+    // depressed cubic t^3 + p t + q with x = t - shift
+    double p = c1 - b*b / 3.0;
+    double q = b*(2.0*b*b - 9.0*c1) / 27.0 + d;
+    double disc = 0.25*q*q + p*p*p / 27.0;
+    if(disc > 0.0)
+    {
+        // one real root (Cardano)
+        double sd = VIGRA_CSTD::sqrt(disc);
+        r[0] = realCbrt(-0.5*q + sd) + realCbrt(-0.5*q - sd) - shift;
+        return 1;
+    }
+    else if(p == 0.0)
+    {
+        // disc <= 0 and p == 0 imply q == 0: triple root
+        r[0] = r[1] = r[2] = -shift;
+        return 3;
+    }
+    else
+    {
+        // three real roots (trigonometric method, p < 0)
+        double m = 2.0 * VIGRA_CSTD::sqrt(-p / 3.0);
+        double arg = 3.0*q / (p * m);
+        if(arg < -1.0)
+            arg = -1.0;
+        else if(arg > 1.0)
+            arg = 1.0;
+        double theta = VIGRA_CSTD::acos(arg) / 3.0;
+        for(int k = 0; k < 3; ++k)
+            r[k] = m * VIGRA_CSTD::cos(theta - 2.0*M_PI*k / 3.0) - shift;
+        return 3;
+    }
+}
+
+inline unsigned int realQuarticRoots(double const * co, double * r)
+{
+    double b = co[3] / co[4],
+           c = co[2] / co[4],
+           d = co[1] / co[4],
+           e = co[0] / co[4];
+    double shift = 0.25 * b;
+    // depressed quartic y^4 + p y^2 + q y + rr with x = y - shift
+    double b2 = b*b;
+    double p = c - 0.375*b2;
+    double q = 0.125*b2*b - 0.5*b*c + d;
+    double rr = -3.0*b2*b2 / 256.0 + b2*c / 16.0 - 0.25*b*d + e;
+
+    unsigned int count = 0;
+    if(q == 0.0)
+    {
+        // biquadratic in y^2
+        double qc[3] = { rr, p, 1.0 }, u[2];
+        unsigned int n = realQuadraticRoots(qc, u);
+        for(unsigned int i = 0; i < n; ++i)
+        {
+            if(u[i] > 0.0)
+            {
+                double s = VIGRA_CSTD::sqrt(u[i]);
+                r[count++] =  s - shift;
+                r[count++] = -s - shift;
+            }
+            else if(u[i] == 0.0)
+            {
+                // double root at y == 0
+                r[count++] = -shift;
+                r[count++] = -shift;
+            }
+        }
+        return count;
+    }
+
+    // Ferrari: factor into two real quadratics using the largest root
+    // of the resolvent cubic m^3 + 2p m^2 + (p^2 - 4rr) m - q^2 = 0
+    // (a positive real root exists because the value at m = 0 is -q^2 < 0)
+    double rc[4] = { -q*q, p*p - 4.0*rr, 2.0*p, 1.0 };
+    double m[3];
+    unsigned int n = realCubicRoots(rc, m);
+    double mmax = m[0];
+    for(unsigned int i = 1; i < n; ++i)
+        if(m[i] > mmax)
+            mmax = m[i];
+    if(mmax <= 0.0)
+        return 0;
+
+    double s = VIGRA_CSTD::sqrt(mmax);
+    double t = 0.5*(p + mmax),
+           w = 0.5*q / s;
+    double q1[3] = { t - w,  s, 1.0 },
+           q2[3] = { t + w, -s, 1.0 },
+           rs[2];
+    n = realQuadraticRoots(q1, rs);
+    for(unsigned int i = 0; i < n; ++i)
+        r[count++] = rs[i] - shift;
+    n = realQuadraticRoots(q2, rs);
+    for(unsigned int i = 0; i < n; ++i)
+        r[count++] = rs[i] - shift;
+    return count;
+}
+
+// a few Newton steps on the original polynomial to polish a real root
+template <class POLYNOMIAL>
+double newtonPolishRealRoot(POLYNOMIAL const & p, double x)
+{
+    for(int iter = 0; iter < 3; ++iter)
+    {
+        double f  = (double)p[p.order()];
+        double df = 0.0;
+        for(int i = (int)p.order() - 1; i >= 0; --i)
+        {
+            df = df * x + f;
+            f  = f * x + (double)p[i];
+        }
+        if(df == 0.0)
+            break;
+        double dx = f / df;
+        x -= dx;
+        if(VIGRA_CSTD::fabs(dx) <= p.epsilon() * VIGRA_CSTD::fabs(x))
+            break;
+    }
+    return x;
+}
+
+// closed-form fast path of polynomialRealRoots() for real polynomials
+// of order <= 4; returns false if the order is too high, so that the
+// caller falls back to the iterative algorithm
+template <class POLYNOMIAL, class VECTOR>
+bool realRootsLowOrder(POLYNOMIAL const & p, VECTOR & roots,
+                       bool polishRoots, VigraTrueType /* isRealPolynomial */)
+{
+    unsigned int order = p.order();
+    while(order > 0 && p[order] == 0.0)  // cf. minimizeOrder()
+        --order;
+    if(order > 4)
+        return false;
+
+    double c[5];
+    for(unsigned int i = 0; i <= order; ++i)
+        c[i] = (double)p[i];
+
+    double r[4];
+    unsigned int count = 0;
+    switch(order)
+    {
+      case 1:
+        count = realLinearRoots(c, r);
+        break;
+      case 2:
+        count = realQuadraticRoots(c, r);
+        break;
+      case 3:
+        count = realCubicRoots(c, r);
+        break;
+      case 4:
+        count = realQuarticRoots(c, r);
+        break;
+      default:  // constant polynomial has no roots
+        break;
+    }
+
+    if(polishRoots)
+        for(unsigned int i = 0; i < count; ++i)
+            r[i] = newtonPolishRealRoot(p, r[i]);
+
+    std::sort(r, r + count);
+    for(unsigned int i = 0; i < count; ++i)
+        roots.push_back((typename VECTOR::value_type)r[i]);
+    return true;
+}
+
+template <class POLYNOMIAL, class VECTOR>
+inline bool realRootsLowOrder(POLYNOMIAL const &, VECTOR &,
+                              bool, VigraFalseType /* isRealPolynomial */)
+{
+    return false;
+}
+
+} // namespace detail
 
 /** \addtogroup Polynomials Polynomials and root determination
 
@@ -1040,8 +1260,14 @@ polynomialRoots(POLYNOMIAL const & poriginal, VECTOR & roots)
 
 /** Determine the real roots of the polynomial <tt>p</tt>.
 
-    This function simply calls \ref polynomialRoots() and than throws away all complex roots.
-    Accordingly, <tt>VECTOR</tt> must be compatible to <tt>std::vector</tt>
+    For polynomials with real coefficients and order up to 4, the roots
+    are computed in closed form (quadratic formula, Cardano, Ferrari),
+    entirely in real arithmetic and optionally polished with a few Newton
+    steps -- this is much faster than the iterative algorithm and covers
+    the degrees that dominate geometric code such as spline intersection.
+    For higher orders (or complex coefficients), the function calls
+    \ref polynomialRoots() and then throws away all complex roots.
+    In either case, <tt>VECTOR</tt> must be compatible to <tt>std::vector</tt>
     with a <tt>value_type</tt> compatible to the type <tt>POLYNOMIAL::Real</tt>.
 
     <b> Declaration:</b>
@@ -1077,6 +1303,13 @@ template <class POLYNOMIAL, class VECTOR>
 bool polynomialRealRoots(POLYNOMIAL const & p, VECTOR & roots, bool polishRoots)
 {
     typedef typename NumericTraits<typename VECTOR::value_type>::ComplexPromote Complex;
+    typedef typename IsSameType<typename POLYNOMIAL::value_type,
+                                typename POLYNOMIAL::Real>::result isRealPolynomial;
+
+    // closed-form fast path for real polynomials up to order 4
+    if(detail::realRootsLowOrder(p, roots, polishRoots, isRealPolynomial()))
+        return true;
+
     ArrayVector<Complex> croots;
     if(!polynomialRoots(p, croots, polishRoots))
         return false;
@@ -38,6 +38,9 @@
 #ifndef VIGRA_PROJECT2ELLIPSE_HXX
 #define VIGRA_PROJECT2ELLIPSE_HXX
 #include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 
 namespace vigra{
 
@@ -172,6 +175,153 @@ void projectEllipse2D(double &vx, double &vy, const double _a,const double _b,co
   }
   return;
 }
+/* Batched version of projectEllipse2D().
+
+   Projects size points (vx[k], vy[k]) onto their ellipses (a[k], b[k]) in
+   place. Points whose projection needs the iterative bisection are gathered
+   into fixed-size lanes and iterated in lockstep: every bisection step sweeps
+   a flat inner loop over all lanes, and converged lanes are frozen by a
+   per-lane mask instead of leaving the loop. The masked selects compile to
+   branch-free code that vectorizes well, which is the point of this routine -
+   projectEllipse2D() is called once per pixel in every constraint step of the
+   total variation filters. The results are identical to calling
+   projectEllipse2D() on each point.
+*/
+inline void projectEllipse2DBatch(double *vx, double *vy,
+                                  const double *a, const double *b,
+                                  std::size_t size,
+                                  const double eps, const int iter_max){
+
+  const std::size_t chunk_size = 64;
+  double px[chunk_size], py[chunk_size], pa[chunk_size], pb[chunk_size],
+         tmin[chunk_size], tmax[chunk_size], tcur[chunk_size];
+  unsigned char active[chunk_size], swapped[chunk_size],
+                x_reflect[chunk_size], y_reflect[chunk_size];
+  std::size_t lane_index[chunk_size];
+
+  for (std::size_t begin=0; begin<size; begin+=chunk_size){
+    std::size_t end = std::min(begin+chunk_size, size);
+
+    // gather the points that need the bisection; all special cases
+    // (inside, circle, point on an axis) are resolved immediately
+    std::size_t lanes = 0;
+    for (std::size_t k=begin; k<end; k++){
+      double wx=vx[k], wy=vy[k], wa=a[k], wb=b[k];
+
+      if (((wx/wa)*(wx/wa)+(wy/wb)*(wy/wb))<=1)
+        continue;
+
+      if (fabs(wa-wb) < eps){
+        double l = sqrt(wx*wx+wy*wy);
+        if (l>(wa+wb)/2.){
+          vx[k]=(wa+wb)/(2*l)*wx;
+          vy[k]=(wa+wb)/(2*l)*wy;
+        }
+        continue;
+      }
+
+      unsigned char xr = 0, yr = 0, sw = 0;
+      if (wx < -eps){
+        xr = 1;
+        wx = -wx;
+      }
+      else if (wx <= eps){
+        wx = 0.0;
+      }
+      if (wy < -eps){
+        yr = 1;
+        wy = -wy;
+      }
+      else if (wy <= eps){
+        wy = 0.0;
+      }
+      if (wa < wb){
+        sw = 1;
+        std::swap(wa,wb);
+        std::swap(wx,wy);
+      }
+
+      if (wx != 0.0 && wy != 0.0){
+        // needs the iterative projection - occupy a lane
+        px[lanes]=wx;
+        py[lanes]=wy;
+        pa[lanes]=wa;
+        pb[lanes]=wb;
+        tmax[lanes]=std::max(2*wa*wx,2*wb*wy);
+        tmin[lanes]=-wb*wb;
+        tcur[lanes]=0.0;
+        active[lanes]=1;
+        swapped[lanes]=sw;
+        x_reflect[lanes]=xr;
+        y_reflect[lanes]=yr;
+        lane_index[lanes]=k;
+        ++lanes;
+        continue;
+      }
+
+      // closed-form cases on the axes
+      if (wx != 0.0){
+        if (wx < wa - wb*wb/wa){
+          double wx_temp = wx;
+          wx = wa*wa*wx/(wa*wa-wb*wb);
+          wy = wy*sqrt(fabs(1.0-wx_temp/wa*wx_temp/wa));
+        }
+        else{
+          wx = wa;
+          wy = 0.0;
+        }
+      }
+      else{
+        wx = 0.0;
+        wy = wb;
+      }
+      if (sw)
+        std::swap(wx,wy);
+      if (yr)
+        wy = -wy;
+      if (xr)
+        wx = -wx;
+      vx[k]=wx;
+      vy[k]=wy;
+    }
+
+    // lockstep bisection with convergence masking
+    for (int i=0; i<iter_max; i++){
+      unsigned char any = 0;
+      for (std::size_t l=0; l<lanes; l++){
+        double t=.5*(tmin[l]+tmax[l]);
+        double d1=pa[l]*px[l]/(t+pa[l]*pa[l]);
+        double d2=pb[l]*py[l]/(t+pb[l]*pb[l]);
+        double f=d1*d1+d2*d2-1;
+        unsigned char act = active[l];
+        unsigned char go = act && !(fabs(f)<eps) && f != 0.0;
+        tcur[l] = act ? t : tcur[l];
+        tmin[l] = (go && f>0) ? t : tmin[l];
+        tmax[l] = (go && f<0) ? t : tmax[l];
+        active[l] = go;
+        any |= go;
+      }
+      if (!any)
+        break;
+    }
+
+    // scatter the lane results back
+    for (std::size_t l=0; l<lanes; l++){
+      double t=tcur[l];
+      double wx=pa[l]*pa[l]*px[l]/(t+pa[l]*pa[l]);
+      double wy=pb[l]*pb[l]*py[l]/(t+pb[l]*pb[l]);
+      if (swapped[l])
+        std::swap(wx,wy);
+      if (y_reflect[l])
+        wy = -wy;
+      if (x_reflect[l])
+        wx = -wx;
+      vx[lane_index[l]]=wx;
+      vy[lane_index[l]]=wy;
+    }
+  }
+}
+
   } //closing namespace detail
 } //closing namespace vigra
 #endif // VIGRA_PROJECT2ELLIPSE_HXX
\ No newline at end of file
@@ -84,11 +84,122 @@ void quadprogDeleteConstraint(MultiArrayView<2, T, C1> & R, MultiArrayView<2, T,
                                                    Shape(newActiveConstraintCount,newActiveConstraintCount)));
 }
 
+    // select the next violated inequality constraint to become active
+    //
+    // Returns the index (into 'activeSet') of the most violated constraint and its
+    // violation in 'ss' (zero when all constraints are satisfied). Constraints flagged
+    // in 'preferred' (those active in a previous solve of a similar problem) take
+    // precedence over unflagged ones, so that a warm-started solve rebuilds the
+    // old active set with as little add/drop churn as possible.
+template <class T, class C1, class C2, class C3>
+int quadprogSelectConstraint(MultiArrayView<2, T, C1> const & CI, MultiArrayView<2, T, C2> const & ci,
+                             MultiArrayView<2, T, C3> const & x,
+                             ArrayVector<int> const & activeSet, int first, int mi,
+                             ArrayVector<bool> const & preferred, T & ss)
+{
+    T ssAny = 0.0, ssPreferred = 0.0;
+    int candidateAny = first, candidatePreferred = -1;
+    for (int i = first; i < mi; ++i)
+    {
+        // compute CI*x - ci with appropriate row permutation
+        T s = dot(rowVector(CI, activeSet[i]), x) - ci(activeSet[i], 0);
+        if (s < ssAny)
+        {
+            ssAny = s;
+            candidateAny = i;
+        }
+        if (s < ssPreferred && preferred[activeSet[i]])
+        {
+            ssPreferred = s;
+            candidatePreferred = i;
+        }
+    }
+    if (candidatePreferred >= 0)
+    {
+        ss = ssPreferred;
+        return candidatePreferred;
+    }
+    ss = ssAny;
+    return candidateAny;
+}
+
 } // namespace detail
 
 /** \addtogroup Optimization Optimization and Regression
  */
 //@{
+
+   /** \brief Reusable state for warm-starting quadraticProgramming().
+
+     When a sequence of closely related quadratic programs must be solved (e.g.
+     per-frame constrained fits with a fixed matrix <b>G</b>), most of the work
+     of every cold solve is redundant: the Cholesky factorization of <b>G</b>
+     is recomputed, and the active set is rebuilt from scratch. A
+     QuadraticProgrammingContext passed to \ref quadraticProgramming() keeps
+     the factorization of <b>G</b> and the active inequality constraints of the
+     most recent solve across calls. The factorization is computed on first
+     use (or explicitly via setHessian()) and reused as long as the context
+     exists, and previously active constraints are given priority when the
+     active set of the next problem is constructed. Call reset() when matrix
+     <b>G</b> changes.
+
+     <b>\#include</b> \<vigra/quadprog.hxx\>
+         Namespace: vigra
+   */
+template <class T>
+class QuadraticProgrammingContext
+{
+  public:
+
+        /** Initialize an empty context.
+
+            The factorization will be computed during the first call to
+            \ref quadraticProgramming() receiving this context.
+        */
+    QuadraticProgrammingContext()
+    : has_factorization(false)
+    {}
+
+        /** Factorize matrix \a G for reuse in subsequent solves.
+
+            Computes the Cholesky factorization of \a G and its inverse factor.
+            \a G must be symmetric positive definite.
+        */
+    template <class C1>
+    void setHessian(MultiArrayView<2, T, C1> const & G)
+    {
+        MultiArrayIndex n = rowCount(G);
+        vigra_precondition(columnCount(G) == n,
+            "QuadraticProgrammingContext::setHessian(): Matrix G must be square.");
+        cholesky_factor.reshape(G.shape());
+        linalg::choleskyDecomposition(G, cholesky_factor);
+        inverse_factor = linalg::identityMatrix<T>((unsigned int)n);
+        linalg::linearSolveLowerTriangular(cholesky_factor, inverse_factor, inverse_factor);
+        has_factorization = true;
+    }
+
+        /** Discard the stored factorization and active set.
+
+            Must be called when matrix \a G changes between solves.
+        */
+    void reset()
+    {
+        has_factorization = false;
+        active_set.clear();
+    }
+
+        /** Active inequality constraints (row indices into <b>C</b><sub>I</sub>)
+            of the most recent successful solve.
+        */
+    ArrayVector<int> const & activeSet() const
+    {
+        return active_set;
+    }
+
+    linalg::Matrix<T> cholesky_factor, inverse_factor;
+    ArrayVector<int> active_set;
+    bool has_factorization;
+};
    /** Solve Quadratic Programming Problem.
 
      The quadraticProgramming() function implements the algorithm described in
@@ -104,13 +215,22 @@ void quadprogDeleteConstraint(MultiArrayView<2, T, C1> & R, MultiArrayView<2, T,
      <b>Declaration:</b>
 
      \code
-     namespace vigra { 
+     namespace vigra {
          template <class T, class C1, class C2, class C3, class C4, class C5, class C6, class C7>
-         T 
-         quadraticProgramming(MultiArrayView<2, T, C1> const & GG, MultiArrayView<2, T, C2> const & g,  
-                              MultiArrayView<2, T, C3> const & CE, MultiArrayView<2, T, C4> const & ce,  
-                              MultiArrayView<2, T, C5> const & CI, MultiArrayView<2, T, C6> const & ci, 
+         T
+         quadraticProgramming(MultiArrayView<2, T, C1> const & GG, MultiArrayView<2, T, C2> const & g,
+                              MultiArrayView<2, T, C3> const & CE, MultiArrayView<2, T, C4> const & ce,
+                              MultiArrayView<2, T, C5> const & CI, MultiArrayView<2, T, C6> const & ci,
                               MultiArrayView<2, T, C7> & x);
+
+         // warm-started variant for sequences of related problems
+         template <class T, class C1, class C2, class C3, class C4, class C5, class C6, class C7>
+         T
+         quadraticProgramming(MultiArrayView<2, T, C1> const & GG, MultiArrayView<2, T, C2> const & g,
+                              MultiArrayView<2, T, C3> const & CE, MultiArrayView<2, T, C4> const & ce,
+                              MultiArrayView<2, T, C5> const & CI, MultiArrayView<2, T, C6> const & ci,
+                              MultiArrayView<2, T, C7> & x,
+                              QuadraticProgrammingContext<T> & context);
      }
      \endcode
 
@@ -164,13 +284,31 @@ void quadprogDeleteConstraint(MultiArrayView<2, T, C1> & R, MultiArrayView<2, T,
                    
       double f = quadraticProgramming(G, g, CE, ce, CI, ci, x);
      \endcode
+
+     When a sequence of nearly identical problems must be solved (same matrix <b>G</b>,
+     slightly changing <b>g</b>, <b>c</b><sub>e</sub>, <b>c</b><sub>i</sub>), pass a
+     \ref vigra::QuadraticProgrammingContext "QuadraticProgrammingContext" to reuse the
+     factorization of <b>G</b> and to warm-start the active set search from the previous
+     solution:
+
+     \code
+      QuadraticProgrammingContext<double> context;
+      for(int frame = 0; frame < frameCount; ++frame)
+      {
+          ... // update g, ce, ci for the current frame
+          double f = quadraticProgramming(G, g, CE, ce, CI, ci, x, context);
+      }
+     \endcode
    */
+doxygen_overloaded_function(template <...> T quadraticProgramming)
+
 template <class T, class C1, class C2, class C3, class C4, class C5, class C6, class C7>
-T 
-quadraticProgramming(MultiArrayView<2, T, C1> const & G, MultiArrayView<2, T, C2> const & g,  
-               MultiArrayView<2, T, C3> const & CE, MultiArrayView<2, T, C4> const & ce,  
-               MultiArrayView<2, T, C5> const & CI, MultiArrayView<2, T, C6> const & ci, 
-               MultiArrayView<2, T, C7> & x)
+T
+quadraticProgramming(MultiArrayView<2, T, C1> const & G, MultiArrayView<2, T, C2> const & g,
+               MultiArrayView<2, T, C3> const & CE, MultiArrayView<2, T, C4> const & ce,
+               MultiArrayView<2, T, C5> const & CI, MultiArrayView<2, T, C6> const & ci,
+               MultiArrayView<2, T, C7> & x,
+               QuadraticProgrammingContext<T> & context)
 {
     using namespace linalg;
     typedef typename MultiArrayShape<2>::type Shape;
@@ -191,15 +329,15 @@ quadraticProgramming(MultiArrayView<2, T, C1> const & G, MultiArrayView<2, T, C2
                        (mi == 0 && columnCount(CI) == 0),
         "quadraticProgramming(): Matrix CI has illegal shape.");
 
-    Matrix<T> J = identityMatrix<T>(n);
-    {
-        Matrix<T> L(G.shape());
-        choleskyDecomposition(G, L);
-        // find unconstrained minimizer of the quadratic form  0.5 * x G x + g' x
-        choleskySolve(L, -g, x);
-        // compute the inverse of the factorized matrix G^-1, this is the initial value for J
-        linearSolveLowerTriangular(L, J, J);
-    }
+    if(!context.has_factorization)
+        context.setHessian(G);
+    vigra_precondition(rowCount(context.cholesky_factor) == n,
+        "quadraticProgramming(): Stored factorization does not match the shape of G.");
+
+    // find unconstrained minimizer of the quadratic form  0.5 * x G x + g' x
+    choleskySolve(context.cholesky_factor, -g, x);
+    // the inverse of the factorized matrix G^-1 is the initial value for J
+    Matrix<T> J = context.inverse_factor;
     // current solution value
     T f_value = 0.5 * dot(g, x);
     
@@ -239,23 +377,28 @@ quadraticProgramming(MultiArrayView<2, T, C1> const & G, MultiArrayView<2, T, C2
     for (int i = 0; i < mi; ++i)
         activeSet[i] = i;
 
-    int constraintToBeAdded = 0;
+    // give the active constraints of the previous solve priority when
+    // constructing the active set of the current problem
+    ArrayVector<bool> preferred(mi, false);
+    for (unsigned int i = 0; i < context.active_set.size(); ++i)
+        if (context.active_set[i] < mi)
+            preferred[context.active_set[i]] = true;
+
     T ss = 0.0;
-    for (int i = activeConstraintCount-me; i < mi; ++i)
-    {
-        T s = dot(rowVector(CI, activeSet[i]), x) - ci(activeSet[i], 0);
-        if (s < ss)
-        {
-            ss = s;
-            constraintToBeAdded = i;
-        }
-    }
+    int constraintToBeAdded = vigra::detail::quadprogSelectConstraint(CI, ci, x, activeSet,
+                                               activeConstraintCount-me, mi, preferred, ss);
 
-    int iter = 0, maxIter = 10*mi;    
+    int iter = 0, maxIter = 10*mi;
     while(iter++ < maxIter)
-    {        
+    {
         if (ss >= 0.0)       // all constraints are satisfied
+        {
+            // remember the active set for warm-starting the next solve
+            context.active_set.resize(activeConstraintCount - me);
+            for (int i = 0; i < activeConstraintCount - me; ++i)
+                context.active_set[i] = activeSet[i];
             return f_value;  // => solved!
+        }
 
         // determine step direction in the primal space (through J, see the paper)
         MultiArrayView<2, T, C5> np = rowVector(CI, activeSet[constraintToBeAdded]);
@@ -332,21 +475,23 @@ quadraticProgramming(MultiArrayView<2, T, C1> const & G, MultiArrayView<2, T, C2
         }
         
         // update values of inactive inequality constraints
-        ss = 0.0;
-        for (int i = activeConstraintCount-me; i < mi; ++i)
-        {
-            // compute CI*x - ci with appropriate row permutation
-            T s = dot(rowVector(CI, activeSet[i]), x) - ci(activeSet[i], 0);
-            if (s < ss)
-            {
-                ss = s;
-                constraintToBeAdded = i;
-            }
-        }
+        constraintToBeAdded = vigra::detail::quadprogSelectConstraint(CI, ci, x, activeSet,
+                                               activeConstraintCount-me, mi, preferred, ss);
     }
     return inf; // too many iterations
 }
 
+template <class T, class C1, class C2, class C3, class C4, class C5, class C6, class C7>
+inline T
+quadraticProgramming(MultiArrayView<2, T, C1> const & G, MultiArrayView<2, T, C2> const & g,
+               MultiArrayView<2, T, C3> const & CE, MultiArrayView<2, T, C4> const & ce,
+               MultiArrayView<2, T, C5> const & CI, MultiArrayView<2, T, C6> const & ci,
+               MultiArrayView<2, T, C7> & x)
+{
+    QuadraticProgrammingContext<T> context;
+    return quadraticProgramming(G, g, CE, ce, CI, ci, x, context);
+}
+
 //@}
 
 } // namespace vigra
@@ -41,7 +41,9 @@
 #include "tinyvector.hxx"
 #include "matrix.hxx"
 #include "mathutil.hxx"
+#include "array_vector.hxx"
 #include <iosfwd>   // ostream
+#include <algorithm> // upper_bound
 
 
 namespace vigra {
@@ -527,6 +529,138 @@ abs(Quaternion<Type> const & q)
     return norm(q);
 }
 
+/** Apply the rotation represented by quaternion \a q to an array of 3D points.
+
+    The points must be given in a 2-dimensional array of shape <tt>3 x N</tt>
+    (i.e. the three coordinates of each point are consecutive in memory when
+    the array is unstrided), \a res must have the same shape. In-place
+    operation (<tt>points</tt> and <tt>res</tt> referring to the same data)
+    is allowed.
+
+    Instead of performing full quaternion multiplications
+    <tt>q * p * conj(q)</tt> for every point, the rotation matrix is computed
+    once by means of \ref vigra::Quaternion::fillRotationMatrix(), and the
+    points are then transformed in a simple loop that the compiler can
+    vectorize. The quaternion is normalized implicitly, i.e. \a q need not
+    have unit norm.
+
+    <b>\#include</b> \<vigra/quaternion.hxx\><br>
+    Namespace: vigra
+*/
+template<class ValueType, class T, class C1, class C2>
+void rotatePoints(Quaternion<ValueType> const & q,
+                  MultiArrayView<2, T, C1> const & points,
+                  MultiArrayView<2, T, C2> res)
+{
+    vigra_precondition(points.shape(0) == 3,
+        "rotatePoints(): points must have shape 3 x N.");
+    vigra_precondition(points.shape() == res.shape(),
+        "rotatePoints(): shape mismatch between input and output.");
+
+    ValueType m[3][3];
+    q.fillRotationMatrix(m);
+
+    MultiArrayIndex size = points.shape(1);
+    for(MultiArrayIndex k = 0; k < size; ++k)
+    {
+        T x = points(0, k), y = points(1, k), z = points(2, k);
+        res(0, k) = detail::RequiresExplicitCast<T>::cast(m[0][0]*x + m[0][1]*y + m[0][2]*z);
+        res(1, k) = detail::RequiresExplicitCast<T>::cast(m[1][0]*x + m[1][1]*y + m[1][2]*z);
+        res(2, k) = detail::RequiresExplicitCast<T>::cast(m[2][0]*x + m[2][1]*y + m[2][2]*z);
+    }
+}
+
+/** Spherical linear interpolation (slerp) between rotations \a q0 and \a q1.
+
+    For unit quaternions and <tt>t</tt> in <tt>[0, 1]</tt>, the result is the
+    unit quaternion that rotates from \a q0 towards \a q1 along the shorter
+    of the two great-circle arcs, with constant angular velocity in \a t.
+    When the two rotations are (nearly) identical, the function falls back
+    to normalized linear interpolation which is accurate in this regime.
+
+    <b>\#include</b> \<vigra/quaternion.hxx\><br>
+    Namespace: vigra
+*/
+template<typename Type>
+Quaternion<Type>
+slerp(Quaternion<Type> const & q0, Quaternion<Type> const & q1, double t)
+{
+    double cosTheta = q0.w()*q1.w() + dot(q0.v(), q1.v());
+
+    // q and -q represent the same rotation - use the one on the shorter arc
+    double sign = 1.0;
+    if(cosTheta < 0.0)
+    {
+        cosTheta = -cosTheta;
+        sign = -1.0;
+    }
+
+    double w0, w1;
+    if(cosTheta > 1.0 - 1e-10)
+    {
+        // rotations nearly coincide - sin(theta) is unreliable,
+        // linear interpolation with subsequent normalization is exact enough
+        w0 = 1.0 - t;
+        w1 = t;
+    }
+    else
+    {
+        double theta    = VIGRA_CSTD::acos(cosTheta),
+               sinTheta = VIGRA_CSTD::sin(theta);
+        w0 = VIGRA_CSTD::sin((1.0 - t)*theta) / sinTheta;
+        w1 = VIGRA_CSTD::sin(t*theta) / sinTheta;
+    }
+
+    Quaternion<Type> res = q0*w0 + q1*(sign*w1);
+    return res / norm(res);
+}
+
+/** Resample a quaternion trajectory by spherical interpolation.
+
+    The rotations \a keys are the key frames of a trajectory, taken at the
+    strictly increasing times \a keyTimes (both arrays must have equal,
+    non-zero length). For every entry of \a sampleTimes, the rotation at
+    that time is computed by \ref slerp() between the two enclosing key
+    frames and appended to \a res. Sample times outside the key frame range
+    are clamped to the first or last key frame respectively.
+
+    <b>\#include</b> \<vigra/quaternion.hxx\><br>
+    Namespace: vigra
+*/
+template<typename Type>
+void
+slerpTrajectory(ArrayVector<double> const & keyTimes,
+                ArrayVector<Quaternion<Type> > const & keys,
+                ArrayVector<double> const & sampleTimes,
+                ArrayVector<Quaternion<Type> > & res)
+{
+    vigra_precondition(keyTimes.size() == keys.size() && keys.size() > 0,
+        "slerpTrajectory(): there must be as many key times as key frames, and at least one.");
+
+    res.reserve(res.size() + sampleTimes.size());
+    for(unsigned int k = 0; k < sampleTimes.size(); ++k)
+    {
+        double t = sampleTimes[k];
+        ArrayVector<double>::const_iterator i =
+            std::upper_bound(keyTimes.begin(), keyTimes.end(), t);
+        if(i == keyTimes.begin())
+        {
+            res.push_back(keys.front() / norm(keys.front()));
+        }
+        else if(i == keyTimes.end())
+        {
+            res.push_back(keys.back() / norm(keys.back()));
+        }
+        else
+        {
+            std::size_t right = i - keyTimes.begin(),
+                        left  = right - 1;
+            double u = (t - keyTimes[left]) / (keyTimes[right] - keyTimes[left]);
+            res.push_back(slerp(keys[left], keys[right], u));
+        }
+    }
+}
+
 //@}
 
 } // namespace vigra
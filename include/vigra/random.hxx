@@ -66,7 +66,7 @@ enum RandomSeedTag { RandomSeed };
 
 namespace detail {
 
-enum RandomEngineTag { TT800, MT19937 };
+enum RandomEngineTag { TT800, MT19937, Philox4x32 };
 
 
 template<RandomEngineTag EngineTag>
@@ -307,6 +307,122 @@ void RandomState<MT19937>::generateNumbers() const
     current_ = 0;
 }
 
+    /* Counter-based generator Philox4x32-10 by Salmon et al.,
+       "Parallel Random Numbers: As Easy as 1, 2, 3" (SC'11).
+
+       In contrast to the twisters above, this engine carries no large
+       mutable state table: the sequence is the block cipher encryption
+       of a 128-bit counter under a 64-bit key. The key is composed of
+       the seed and a stream id, so independent, reproducible random
+       streams for parallel algorithms are obtained simply by giving
+       every thread (or work item) its own stream id -- no locking and
+       no state-table jump-ahead required. */
+template<>
+struct RandomState<Philox4x32>
+{
+    static const UInt32 N = 6; // state_[0..1]: key (seed, stream id),
+                               // state_[2..5]: 128-bit block counter
+
+    mutable UInt32 state_[N];
+    mutable UInt32 buffer_[4];
+    mutable UInt32 current_;
+
+    RandomState()
+    : current_(4)
+    {
+        state_[0] = 19650218U;
+        state_[1] = 0;
+        resetCounter();
+    }
+
+        /* Switch this generator to the given stream. Streams with different
+           ids are statistically independent, and the pair (seed, stream id)
+           completely determines the sequence, so parallel consumers remain
+           reproducible regardless of scheduling. The counter is reset, i.e.
+           the stream starts from its beginning. */
+    void setStream(UInt32 streamId)
+    {
+        state_[1] = streamId;
+        resetCounter();
+    }
+
+        /* The id of the stream this generator currently produces. */
+    UInt32 stream() const
+    {
+        return state_[1];
+    }
+
+  protected:
+
+    void resetCounter()
+    {
+        state_[2] = state_[3] = state_[4] = state_[5] = 0;
+        current_ = 4; // force encryption of the new counter
+    }
+
+    UInt32 get() const
+    {
+        if(current_ == 4)
+            generateNumbers<void>();
+        return buffer_[current_++];
+    }
+
+    template <class DUMMY>
+    void generateNumbers() const;
+
+    void seedImpl(RandomSeedTag)
+    {
+        seed(RandomSeed, *this); // fills key and counter with entropy
+        current_ = 4;
+    }
+
+    void seedImpl(UInt32 theSeed)
+    {
+        state_[0] = theSeed;
+        state_[1] = 0; // stream 0 -- change via setStream()
+        resetCounter();
+    }
+
+    template<class Iterator>
+    void seedImpl(Iterator init, UInt32 length)
+    {
+        seed(19650218U, *this);
+        seed(init, length, *this);
+        current_ = 4;
+    }
+};
+
+template <class DUMMY>
+void RandomState<Philox4x32>::generateNumbers() const
+{
+    // encrypt the current counter value with ten Philox rounds ...
+    UInt32 k0 = state_[0], k1 = state_[1];
+    UInt32 c0 = state_[2], c1 = state_[3], c2 = state_[4], c3 = state_[5];
+    for(int round = 0; round < 10; ++round)
+    {
+        UInt64 p0 = (UInt64)0xD2511F53U * c0;
+        UInt64 p1 = (UInt64)0xCD9E8D57U * c2;
+        UInt32 t0 = c1, t1 = c3;
+        c0 = (UInt32)(p1 >> 32) ^ t0 ^ k0;
+        c1 = (UInt32)p1;
+        c2 = (UInt32)(p0 >> 32) ^ t1 ^ k1;
+        c3 = (UInt32)p0;
+        k0 += 0x9E3779B9U; // golden ratio
+        k1 += 0xBB67AE85U; // sqrt(3) - 1
+    }
+    buffer_[0] = c0;
+    buffer_[1] = c1;
+    buffer_[2] = c2;
+    buffer_[3] = c3;
+    current_ = 0;
+
+    // ... and advance the 128-bit counter
+    if(++state_[2] == 0)
+        if(++state_[3] == 0)
+            if(++state_[4] == 0)
+                ++state_[5];
+}
+
 } // namespace detail
 
 
@@ -318,14 +434,20 @@ void RandomState<MT19937>::generateNumbers() const
 
 /** Generic random number generator.
 
-    The actual generator is passed in the template argument <tt>Engine</tt>. Two generators
+    The actual generator is passed in the template argument <tt>Engine</tt>. Three generators
     are currently available:
     <ul>
     <li> <tt>RandomMT19937</tt>: The state-of-the-art <a href="http://www.math.sci.hiroshima-u.ac.jp/~m-mat/MT/emt.html">Mersenne Twister</a> with a state length of 2<sup>19937</sup> and very high statistical quality.
     <li> <tt>RandomTT800</tt>: (default) The Tempered Twister, a simpler predecessor of the Mersenne Twister with period length 2<sup>800</sup>.
+    <li> <tt>RandomPhilox</tt>: The counter-based Philox4x32-10 generator by Salmon et al.
+         It carries only a small counter and key instead of a large state table,
+         and its <tt>setStream()</tt> member splits it into independent, reproducible
+         streams identified by the pair (seed, stream id). This is the generator of
+         choice when many parallel consumers each need their own deterministic
+         random sequence.
     </ul>
-    
-    Both generators have been designed by <a href="http://www.math.sci.hiroshima-u.ac.jp/~m-mat/eindex.html">Makoto Matsumoto</a>. 
+
+    The twisters have been designed by <a href="http://www.math.sci.hiroshima-u.ac.jp/~m-mat/eindex.html">Makoto Matsumoto</a>.
     
     <b>Traits defined:</b>
     
@@ -611,6 +733,17 @@ typedef RandomNumberGenerator<detail::RandomState<detail::MT19937> > RandomMT199
     */
 typedef RandomNumberGenerator<detail::RandomState<detail::MT19937> > MersenneTwister;
 
+    /** Shorthand for the counter-based Philox4x32-10 random number generator class.
+
+        Unlike the twisters, this generator supports cheap stream splitting: after
+        <tt>RandomPhilox rnd(theSeed); rnd.setStream(streamId);</tt> every distinct
+        <tt>streamId</tt> yields a statistically independent sequence that is fully
+        determined by the pair (seed, stream id). This makes it easy to give each
+        thread of a parallel algorithm its own reproducible generator without
+        locking or expensive jump-ahead.
+    */
+typedef RandomNumberGenerator<detail::RandomState<detail::Philox4x32> > RandomPhilox;
+
     /** Access the global (program-wide) instance of the TT800 random number generator.
     */
 inline RandomTT800   & randomTT800()   { return RandomTT800::global(); }
@@ -619,6 +752,10 @@ inline RandomTT800   & randomTT800()   { return RandomTT800::global(); }
     */
 inline RandomMT19937 & randomMT19937() { return RandomMT19937::global(); }
 
+    /** Access the global (program-wide) instance of the Philox4x32 random number generator.
+    */
+inline RandomPhilox  & randomPhilox()  { return RandomPhilox::global(); }
+
 template <class Engine>
 class FunctorTraits<RandomNumberGenerator<Engine> >
 {
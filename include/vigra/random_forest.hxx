@@ -285,7 +285,7 @@ class RandomForest
      */
     Options_t & set_options()
     {
-        return options;
+        return options_;
     }
 
 
@@ -312,6 +312,46 @@ class RandomForest
         return trees_[index];
     }
 
+    /**\brief flatten all trees into a cache-friendly layout for
+     * prediction.
+     *
+     * Call this once after learning (or deserialization) to speed up
+     * predictLabels() and predictProbabilities(): each tree is
+     * compiled into a contiguous struct-of-arrays node block (split
+     * column, threshold, child offsets), so per-sample prediction
+     * walks small linear arrays instead of chasing node proxies
+     * through the topology array. The predictions themselves are
+     * unchanged. Trees containing node types other than threshold
+     * splits and constant-probability leaves stay uncompiled and
+     * keep using the generic traversal. Relearning a tree
+     * invalidates its compiled form automatically.
+     */
+    void compileTrees()
+    {
+        for(unsigned int k = 0; k < trees_.size(); ++k)
+            trees_[k].compile();
+    }
+
+    /**\brief flatten all trees into a quantized cache-friendly layout
+     * for prediction.
+     *
+     * Like compileTrees(), but the traversal data is additionally
+     * quantized: split columns are stored as 16 bit integers and
+     * thresholds as 32 bit floats, shrinking the per-node data from 16
+     * to 10 bytes so that larger forests stay cache-resident during
+     * prediction. This is an opt-in approximation - samples whose
+     * feature value lies within float rounding distance of a threshold
+     * may be classified differently than by the exact tree. Trees
+     * that cannot be compiled, or that use more than 32767 feature
+     * columns, keep their exact representation. Relearning a tree
+     * invalidates its quantized form automatically.
+     */
+    void quantizeTrees()
+    {
+        for(unsigned int k = 0; k < trees_.size(); ++k)
+            trees_[k].compileQuantized();
+    }
+
     /*\}*/
 
     /**\brief return number of features used while 
@@ -612,6 +652,17 @@ class RandomForest
     void predictProbabilities(OnlinePredictionSet<T1> &  predictionSet,
                                MultiArrayView<2, T2, C> &       prob);
 
+    /* worker of predictProbabilities(): classifies the feature rows
+     * [row_begin, row_end) - predictProbabilities() calls it once for
+     * the whole matrix or, when RandomForestOptions::num_threads() asks
+     * for it, concurrently for disjoint row blocks.
+     */
+    template <class U, class C1, class T, class C2, class Stop>
+    void predictProbabilitiesBlock_(MultiArrayView<2, U, C1> const & features,
+                                    MultiArrayView<2, T, C2> &       prob,
+                                    Stop                     &       stop,
+                                    int row_begin, int row_end) const;
+
     /** \brief predict the class probabilities for multiple labels
      *
      *  \param features same as above
@@ -921,7 +972,6 @@ void RandomForest<LabelType, PreprocessorTag>::
                 typename RF_CHOOSER(Visitor_t)::type> IntermedVis; 
     IntermedVis
         visitor(online_visitor_, RF_CHOOSER(Visitor_t)::choose(visitor_, stopvisiting));
-    #undef RF_CHOOSER
     if(options_.prepare_online_learning_)
         online_visitor_.activate();
     else
@@ -955,12 +1005,84 @@ void RandomForest<LabelType, PreprocessorTag>::
 
     visitor.visit_at_beginning(*this, preprocessor);
     // THE MAIN EFFING RF LOOP - YEAY DUDE!
-    
+
+#ifdef _OPENMP
+    if(options_.num_threads_ > 1 && !options_.prepare_online_learning_)
+    {
+        // parallel learning mode: the trees are independent given
+        // per-tree random streams, so each tree is grown from its own
+        // deterministically seeded generator and its own sampler and
+        // split/stop copies. The base seed is drawn from the caller's
+        // generator, so the result only depends on the input random
+        // state, not on the thread count - but it differs from the
+        // sequential branch below, which draws all trees from the
+        // caller's stream directly (see RandomForestOptions::num_threads).
+        // Exceptions must not leave the OpenMP region and are re-raised
+        // afterwards.
+        UInt32 base_seed = randint(0xffffffffU);
+        std::string errorMessage;
+
+#pragma omp parallel for schedule(dynamic) num_threads(options_.num_threads_)
+        for(int ii = 0; ii < (int)trees_.size(); ++ii)
+        {
+            try
+            {
+                typedef UniformIntRandomFunctor<RandomNumberGenerator<> >
+                                                        TreeRandFunctor_t;
+                RandomNumberGenerator<> tree_random(base_seed + ii);
+                TreeRandFunctor_t       tree_randint(tree_random);
+                typename RF_CHOOSER(Split_t)::type tree_split(split);
+                typename RF_CHOOSER(Stop_t)::type  tree_stop(stop);
+
+                Sampler<RandomNumberGenerator<> >
+                    tree_sampler(preprocessor.strata().begin(),
+                                 preprocessor.strata().end(),
+                                 detail::make_sampler_opt(options_)
+                                          .sampleSize(ext_param().actual_msample_),
+                                 tree_random);
+                tree_sampler
+                    .sample();
+                StackEntry_t
+                    first_stack_entry(  tree_sampler.sampledIndices().begin(),
+                                        tree_sampler.sampledIndices().end(),
+                                        ext_param_.class_count_);
+                first_stack_entry
+                    .set_oob_range(     tree_sampler.oobIndices().begin(),
+                                        tree_sampler.oobIndices().end());
+                trees_[ii]
+                    .learn(             preprocessor.features(),
+                                        preprocessor.response(),
+                                        first_stack_entry,
+                                        tree_split,
+                                        tree_stop,
+                                        visitor,
+                                        tree_randint);
+#pragma omp critical(vigra_rf_learn_visitor)
+                visitor
+                    .visit_after_tree(  *this,
+                                        preprocessor,
+                                        tree_sampler,
+                                        first_stack_entry,
+                                        ii);
+            }
+            catch(std::exception & e)
+            {
+#pragma omp critical(vigra_rf_learn_error)
+                if(errorMessage.empty())
+                    errorMessage = e.what();
+            }
+        }
+
+        if(!errorMessage.empty())
+            vigra_fail(errorMessage.c_str());
+    }
+    else
+#endif
     for(int ii = 0; ii < (int)trees_.size(); ++ii)
     {
         //initialize First region/node/stack entry
         sampler
-            .sample();  
+            .sample();
         StackEntry_t
             first_stack_entry(  sampler.sampledIndices().begin(),
                                 sampler.sampledIndices().end(),
@@ -983,6 +1105,7 @@ void RandomForest<LabelType, PreprocessorTag>::
                                 first_stack_entry,
                                 ii);
     }
+    #undef RF_CHOOSER
 
     visitor.visit_at_end(*this, preprocessor);
     // Only for online learning?
@@ -1199,11 +1322,10 @@ void RandomForest<LabelType, PreprocessorTag>
       "RandomForestn::predictProbabilities():"
       " Probability matrix must have as many columns as there are classes.");
 
-    #define RF_CHOOSER(type_) detail::Value_Chooser<type_, Default_##type_> 
+    #define RF_CHOOSER(type_) detail::Value_Chooser<type_, Default_##type_>
     Default_Stop_t default_stop(options_);
     typename RF_CHOOSER(Stop_t)::type & stop
-            = RF_CHOOSER(Stop_t)::choose(stop_, default_stop); 
-    #undef RF_CHOOSER 
+            = RF_CHOOSER(Stop_t)::choose(stop_, default_stop);
     stop.set_external_parameters(ext_param_, tree_count());
     prob.init(NumericTraits<T>::zero());
     /* This code was originally there for testing early stopping
@@ -1211,49 +1333,124 @@ void RandomForest<LabelType, PreprocessorTag>
     if(tree_indices_.size() != 0)
     {
        std::random_shuffle(tree_indices_.begin(),
-                           tree_indices_.end()); 
+                           tree_indices_.end());
     }
     */
-    //Classify for each row.
-    for(int row=0; row < rowCount(features); ++row)
+    const int row_count = (int)rowCount(features);
+#ifdef _OPENMP
+    if(options_.num_threads_ > 1)
     {
-        ArrayVector<double>::const_iterator weights;
+        // classify disjoint row blocks concurrently. Each block gets
+        // its own copy of the stopping criterion, so stateful early
+        // stopping functors see their rows in order, just block-wise.
+        const int block_size = 256;
+        const int block_count = (row_count + block_size - 1) / block_size;
+        std::string errorMessage;
+#pragma omp parallel for schedule(dynamic) num_threads(options_.num_threads_)
+        for(int block = 0; block < block_count; ++block)
+        {
+            try
+            {
+                typename RF_CHOOSER(Stop_t)::type block_stop(stop);
+                predictProbabilitiesBlock_(features, prob, block_stop,
+                                           block * block_size,
+                                           std::min<int>((block + 1) * block_size,
+                                                         row_count));
+            }
+            catch(std::exception & e)
+            {
+#pragma omp critical(vigra_rf_predict_error)
+                if(errorMessage.empty())
+                    errorMessage = e.what();
+            }
+        }
+        if(!errorMessage.empty())
+            vigra_fail("RandomForest::predictProbabilities(): worker "
+                       "thread failed with:\n" + errorMessage);
+    }
+    else
+#endif
+    {
+        predictProbabilitiesBlock_(features, prob, stop, 0, row_count);
+    }
+    #undef RF_CHOOSER
+}
 
-        //totalWeight == totalVoteCount!
-        double totalWeight = 0.0;
+template <class LabelType, class PreprocessorTag>
+template <class U, class C1, class T, class C2, class Stop>
+void RandomForest<LabelType, PreprocessorTag>
+    ::predictProbabilitiesBlock_(MultiArrayView<2, U, C1> const & features,
+                                 MultiArrayView<2, T, C2> &       prob,
+                                 Stop                     &       stop,
+                                 int row_begin, int row_end) const
+{
+    // when every tree has been compiled (see compileTrees()), a small
+    // batch of samples is sent through each tree in lock-step so that
+    // several traversals hide each other's memory latency
+    bool batched = tree_count() > 0;
+    for(int k = 0; k < (int)tree_count(); ++k)
+        batched = batched && (trees_[k].isCompiled() || trees_[k].isQuantized());
+
+    //Classify for each row.
+    for(int row = row_begin; row < row_end; )
+    {
+        const int batch = batched
+            ? std::min<int>((int)DecisionTree_t::MaxPredictBatch,
+                            row_end - row)
+            : 1;
+        ArrayVector<double>::const_iterator weights[DecisionTree_t::MaxPredictBatch];
+        double totalWeight[DecisionTree_t::MaxPredictBatch];
+        bool   stopped[DecisionTree_t::MaxPredictBatch];
+        int    stopped_count = 0;
+        for(int b = 0; b < batch; ++b)
+        {
+            //totalWeight == totalVoteCount!
+            totalWeight[b] = 0.0;
+            stopped[b] = false;
+        }
 
         //Let each tree classify...
-        for(int k=0; k<options_.tree_count_; ++k)
+        for(int k = 0; k < options_.tree_count_ && stopped_count < batch; ++k)
         {
             //get weights predicted by single tree
-            weights = trees_[k /*tree_indices_[k]*/].predict(rowVector(features, row));
-
-            //update votecount.
-            int weighted = options_.predict_weighted_;
-            for(int l=0; l<ext_param_.class_count_; ++l)
-            {
-                double cur_w = weights[l] * (weighted * (*(weights-1))
-                                           + (1-weighted));
-                prob(row, l) += (T)cur_w;
-                //every weight in totalWeight.
-                totalWeight += cur_w;
-            }
-            if(stop.after_prediction(weights, 
-                                     k,
-                                     rowVector(prob, row),
-                                     totalWeight))
+            if(batch > 1)
+                trees_[k].predictBatch(features, row, batch, stopped, weights);
+            for(int b = 0; b < batch; ++b)
             {
-                break;
+                if(stopped[b])
+                    continue;
+                if(batch == 1)
+                    weights[b] = trees_[k /*tree_indices_[k]*/].predict(rowVector(features, row + b));
+
+                //update votecount.
+                int weighted = options_.predict_weighted_;
+                for(int l=0; l<ext_param_.class_count_; ++l)
+                {
+                    double cur_w = weights[b][l] * (weighted * (*(weights[b]-1))
+                                               + (1-weighted));
+                    prob(row + b, l) += (T)cur_w;
+                    //every weight in totalWeight.
+                    totalWeight[b] += cur_w;
+                }
+                if(stop.after_prediction(weights[b],
+                                         k,
+                                         rowVector(prob, row + b),
+                                         totalWeight[b]))
+                {
+                    stopped[b] = true;
+                    ++stopped_count;
+                }
             }
         }
 
         //Normalise votes in each row by total VoteCount (totalWeight
-        for(int l=0; l< ext_param_.class_count_; ++l)
-        {
-            prob(row, l) /= detail::RequiresExplicitCast<T>::cast(totalWeight);
-        }
+        for(int b = 0; b < batch; ++b)
+            for(int l=0; l< ext_param_.class_count_; ++l)
+            {
+                prob(row + b, l) /= detail::RequiresExplicitCast<T>::cast(totalWeight[b]);
+            }
+        row += batch;
     }
-
 }
 
 template <class LabelType, class PreprocessorTag>
@@ -38,6 +38,7 @@
 #include "splices.hxx"
 #include <queue>
 #include <fstream>
+#include <vigra/parallel_options.hxx>
 namespace vigra
 {
  
@@ -352,6 +353,108 @@ void forward_selection(FeatureT          const & features,
     forward_selection(features, response, result, RFErrorCallback());
 }
 
+/** Parallel variant of \ref forward_selection()
+ *
+ * The candidate features of each round are evaluated concurrently:
+ * every candidate trains its own forest through its own copy of the
+ * error callback (so the callback must be safely copyable), while the
+ * feature matrix and the response statistics gathered by
+ * VariableSelectionResult::init() are shared between all candidates.
+ * Since forest training is randomized, the error estimates - and hence
+ * the selected order - may vary between runs, just as for repeated
+ * serial runs.
+ */
+template<class FeatureT, class ResponseT, class ErrorRateCallBack>
+void forward_selection(FeatureT          const & features,
+                       ResponseT          const & response,
+                       VariableSelectionResult & result,
+                       ErrorRateCallBack          errorcallback,
+                       ParallelOptions    const & options)
+{
+#ifdef _OPENMP
+    if(options.getNumThreads() > 1)
+    {
+        VariableSelectionResult::FeatureList_t & selected = result.selected;
+        VariableSelectionResult::ErrorList_t &   errors   = result.errors;
+        VariableSelectionResult::Pivot_t &       pivot    = result.pivot;
+        int featureCount = features.shape(1);
+        // initialize result struct if in use for the first time
+        if(!result.init(features, response, errorcallback))
+        {
+            //result is being reused just ensure that the number of features is
+            //the same.
+            vigra_precondition((int)selected.size() == featureCount,
+                               "forward_selection(): Number of features in Feature "
+                               "matrix and number of features in previously used "
+                               "result struct mismatch!");
+        }
+
+        int not_selected_size = std::distance(pivot, selected.end());
+        while(not_selected_size > 1)
+        {
+            int prefix = std::distance(selected.begin(), pivot);
+            std::vector<double> current_errors(not_selected_size, 0.0);
+            std::string errorMessage;
+
+#pragma omp parallel for schedule(dynamic) num_threads(options.getNumThreads())
+            for(int ii = 0; ii < not_selected_size; ++ii)
+            {
+                try
+                {
+                    // candidate feature set: the common prefix of already
+                    // selected features plus the ii-th remaining feature
+                    VariableSelectionResult::FeatureList_t
+                        candidate(selected.begin(),
+                                  selected.begin() + prefix + 1);
+                    candidate[prefix] = selected[prefix + ii];
+
+                    MultiArray<2, double> cur_feats;
+                    detail::choose( features,
+                                    candidate.begin(),
+                                    candidate.end(),
+                                    cur_feats);
+                    ErrorRateCallBack candidate_callback(errorcallback);
+                    current_errors[ii] = candidate_callback(cur_feats, response);
+                }
+                catch(std::exception & e)
+                {
+#pragma omp critical(vigra_rf_selection_error)
+                    if(errorMessage.empty())
+                        errorMessage = e.what();
+                }
+            }
+            if(!errorMessage.empty())
+                vigra_fail(errorMessage.c_str());
+
+            int pos = std::distance(current_errors.begin(),
+                                    std::min_element(current_errors.begin(),
+                                                       current_errors.end()));
+            std::swap(*pivot, *(pivot + pos));
+            errors[std::distance(selected.begin(), pivot)] = current_errors[pos];
+#ifdef RN_VERBOSE
+            std::copy(current_errors.begin(), current_errors.end(), std::ostream_iterator<double>(std::cerr, ", "));
+            std::cerr << "Choosing " << *pivot << " at error of " <<  current_errors[pos] << std::endl;
+#endif
+            ++pivot;
+            not_selected_size = std::distance(pivot, selected.end());
+        }
+        return;
+    }
+#else
+    (void)options;
+#endif
+    forward_selection(features, response, result, errorcallback);
+}
+
+template<class FeatureT, class ResponseT>
+void forward_selection(FeatureT          const & features,
+                       ResponseT          const & response,
+                       VariableSelectionResult & result,
+                       ParallelOptions    const & options)
+{
+    forward_selection(features, response, result, RFErrorCallback(), options);
+}
+
 
 /** Perform backward elimination
  *
@@ -457,6 +560,104 @@ void backward_elimination(FeatureT              const & features,
     backward_elimination(features, response, result, RFErrorCallback());
 }
 
+/** Parallel variant of \ref backward_elimination()
+ *
+ * The elimination candidates of each round are evaluated concurrently,
+ * each with its own copy of the error callback; see the parallel
+ * \ref forward_selection() for details.
+ */
+template<class FeatureT, class ResponseT, class ErrorRateCallBack>
+void backward_elimination(FeatureT              const & features,
+                             ResponseT         const & response,
+                          VariableSelectionResult & result,
+                          ErrorRateCallBack         errorcallback,
+                          ParallelOptions    const & options)
+{
+#ifdef _OPENMP
+    if(options.getNumThreads() > 1)
+    {
+        int featureCount = features.shape(1);
+        VariableSelectionResult::FeatureList_t & selected = result.selected;
+        VariableSelectionResult::ErrorList_t &   errors   = result.errors;
+        VariableSelectionResult::Pivot_t &       pivot    = result.pivot;
+
+        // initialize result struct if in use for the first time
+        if(!result.init(features, response, errorcallback))
+        {
+            //result is being reused just ensure that the number of features is
+            //the same.
+            vigra_precondition((int)selected.size() == featureCount,
+                               "backward_elimination(): Number of features in Feature "
+                               "matrix and number of features in previously used "
+                               "result struct mismatch!");
+        }
+        pivot = selected.end() - 1;
+
+        int selected_size = std::distance(selected.begin(), pivot);
+        while(selected_size > 1)
+        {
+            std::vector<double> current_errors(selected_size, 0.0);
+            std::string errorMessage;
+
+#pragma omp parallel for schedule(dynamic) num_threads(options.getNumThreads())
+            for(int ii = 0; ii < selected_size; ++ii)
+            {
+                try
+                {
+                    // candidate feature set: all features up to the pivot,
+                    // with the ii-th feature moved to the pivot position
+                    VariableSelectionResult::FeatureList_t
+                        candidate(selected.begin(),
+                                  selected.begin() + selected_size + 1);
+                    std::swap(candidate[selected_size], candidate[ii]);
+
+                    MultiArray<2, double> cur_feats;
+                    detail::choose( features,
+                                    candidate.begin(),
+                                    candidate.end(),
+                                    cur_feats);
+                    ErrorRateCallBack candidate_callback(errorcallback);
+                    current_errors[ii] = candidate_callback(cur_feats, response);
+                }
+                catch(std::exception & e)
+                {
+#pragma omp critical(vigra_rf_selection_error)
+                    if(errorMessage.empty())
+                        errorMessage = e.what();
+                }
+            }
+            if(!errorMessage.empty())
+                vigra_fail(errorMessage.c_str());
+
+            int pos = std::distance(current_errors.begin(),
+                                    std::min_element(current_errors.begin(),
+                                                       current_errors.end()));
+            std::swap(*pivot, *(selected.begin() + pos));
+            errors[std::distance(selected.begin(), pivot)-1] = current_errors[pos];
+            selected_size = std::distance(selected.begin(), pivot);
+#ifdef RN_VERBOSE
+            std::copy(current_errors.begin(), current_errors.end(), std::ostream_iterator<double>(std::cerr, ", "));
+            std::cerr << "Eliminating " << *pivot << " at error of " << current_errors[pos] << std::endl;
+#endif
+            --pivot;
+        }
+        return;
+    }
+#else
+    (void)options;
+#endif
+    backward_elimination(features, response, result, errorcallback);
+}
+
+template<class FeatureT, class ResponseT>
+void backward_elimination(FeatureT              const & features,
+                             ResponseT         const & response,
+                          VariableSelectionResult & result,
+                          ParallelOptions    const & options)
+{
+    backward_elimination(features, response, result, RFErrorCallback(), options);
+}
+
 /** Perform rank selection using a predefined ranking
  *
  * \param features    IN:     n x p matrix containing n instances with p attributes/features
@@ -537,6 +738,81 @@ void rank_selection      (FeatureT              const & features,
     rank_selection(features, response, result, RFErrorCallback());
 }
 
+/** Parallel variant of \ref rank_selection()
+ *
+ * The error rates of the feature prefixes are independent of each other
+ * and are evaluated concurrently, each with its own copy of the error
+ * callback; see the parallel \ref forward_selection() for details.
+ */
+template<class FeatureT, class ResponseT, class ErrorRateCallBack>
+void rank_selection      (FeatureT              const & features,
+                             ResponseT         const & response,
+                          VariableSelectionResult & result,
+                          ErrorRateCallBack         errorcallback,
+                          ParallelOptions    const & options)
+{
+#ifdef _OPENMP
+    if(options.getNumThreads() > 1)
+    {
+        VariableSelectionResult::FeatureList_t & selected = result.selected;
+        VariableSelectionResult::ErrorList_t &   errors   = result.errors;
+        VariableSelectionResult::Pivot_t &       iter     = result.pivot;
+        int featureCount = features.shape(1);
+        // initialize result struct if in use for the first time
+        if(!result.init(features, response, errorcallback))
+        {
+            //result is being reused just ensure that the number of features is
+            //the same.
+            vigra_precondition((int)selected.size() == featureCount,
+                               "rank_selection(): Number of features in Feature "
+                               "matrix and number of features in previously used "
+                               "result struct mismatch!");
+        }
+
+        int begin = std::distance(selected.begin(), iter);
+        std::string errorMessage;
+
+#pragma omp parallel for schedule(dynamic) num_threads(options.getNumThreads())
+        for(int ii = begin; ii < featureCount; ++ii)
+        {
+            try
+            {
+                MultiArray<2, double> cur_feats;
+                detail::choose( features,
+                                selected.begin(),
+                                selected.begin() + ii + 1,
+                                cur_feats);
+                ErrorRateCallBack candidate_callback(errorcallback);
+                errors[ii] = candidate_callback(cur_feats, response);
+            }
+            catch(std::exception & e)
+            {
+#pragma omp critical(vigra_rf_selection_error)
+                if(errorMessage.empty())
+                    errorMessage = e.what();
+            }
+        }
+        if(!errorMessage.empty())
+            vigra_fail(errorMessage.c_str());
+
+        iter = selected.end();
+        return;
+    }
+#else
+    (void)options;
+#endif
+    rank_selection(features, response, result, errorcallback);
+}
+
+template<class FeatureT, class ResponseT>
+void rank_selection      (FeatureT              const & features,
+                             ResponseT         const & response,
+                          VariableSelectionResult & result,
+                          ParallelOptions    const & options)
+{
+    rank_selection(features, response, result, RFErrorCallback(), options);
+}
+
 
 
 enum ClusterLeafTypes{c_Leaf = 95, c_Node = 99};
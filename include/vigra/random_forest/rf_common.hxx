@@ -194,10 +194,11 @@ class RandomForestOptions
     int     mtry_;
     int (*mtry_func_)(int) ;
 
-    bool predict_weighted_; 
+    bool predict_weighted_;
     int tree_count_;
     int min_split_node_size_;
     bool prepare_online_learning_;
+    int num_threads_;
     /*\}*/
 
     typedef ArrayVector<double> double_array;
@@ -359,7 +360,8 @@ class RandomForestOptions
         predict_weighted_(false),
         tree_count_(256),
         min_split_node_size_(1),
-        prepare_online_learning_(false)
+        prepare_online_learning_(false),
+        num_threads_(1)
     {}
 
     /**\brief specify stratification strategy
@@ -513,6 +515,27 @@ class RandomForestOptions
         min_split_node_size_ = in;
         return *this;
     }
+
+    /**\brief Number of threads used by RandomForest::learn().
+     *
+     *  When more than one thread is requested (and VIGRA was compiled
+     *  with OpenMP support), the trees are grown in parallel, each from
+     *  its own deterministically seeded random stream, so the learnt
+     *  forest is the same for any thread count greater than one. Note
+     *  that this per-tree seeding consumes the caller's random stream
+     *  differently than sequential growing: for the same seed, a forest
+     *  learnt in parallel therefore differs from one learnt with the
+     *  default num_threads(1). Visitors are invoked concurrently from
+     *  several trees; their visit_after_tree() calls are serialized,
+     *  but not ordered by tree index. This setting is not serialized
+     *  with the forest.
+     *  <br> Default: 1 (sequential learning)
+     */
+    RandomForestOptions & num_threads(int in)
+    {
+        num_threads_ = in;
+        return *this;
+    }
 };
 
 
@@ -87,6 +87,34 @@ class DecisionTree
     ArrayVector<TreeInt>  topology_;
     ArrayVector<double>   parameters_;
 
+    /* struct-of-arrays representation of the tree built by compile()
+     * for fast prediction; empty while the tree is not compiled.
+     * Nodes are stored breadth-first with both children of a split
+     * adjacent: fast_column_[n] is the split column (-1 for leaves),
+     * fast_threshold_[n] the split threshold, and fast_child_[n] the
+     * index of the left child (right child at fast_child_[n] + 1).
+     * For leaves, fast_child_[n] is the offset of the class
+     * probabilities in fast_weights_, with the leaf weight stored
+     * directly before them (mirroring the parameters_ layout).
+     */
+    ArrayVector<TreeInt>  fast_column_;
+    ArrayVector<double>   fast_threshold_;
+    ArrayVector<TreeInt>  fast_child_;
+    ArrayVector<double>   fast_weights_;
+
+    /* quantized variant of the compiled representation built by
+     * compileQuantized(): same node layout, but split columns are
+     * stored as 16 bit integers and thresholds as 32 bit floats, which
+     * shrinks the per-node traversal data from 16 to 10 bytes so more
+     * of the forest stays cache-resident. Leaves still index into
+     * fast_weights_, which is kept in double precision. When these
+     * arrays are filled, the double precision traversal arrays are
+     * released.
+     */
+    ArrayVector<Int16>    quant_column_;
+    ArrayVector<float>    quant_threshold_;
+    ArrayVector<TreeInt>  quant_child_;
+
     ProblemSpec<> ext_param_;
     unsigned int classCount_;
 
@@ -108,6 +136,21 @@ class DecisionTree
             classCount_ = classCount;
         topology_.clear();
         parameters_.clear();
+        clearCompiled();
+    }
+
+    /* throw away the compiled representation (called whenever the
+     * tree changes)
+     */
+    void clearCompiled()
+    {
+        fast_column_.clear();
+        fast_threshold_.clear();
+        fast_child_.clear();
+        fast_weights_.clear();
+        quant_column_.clear();
+        quant_threshold_.clear();
+        quant_child_.clear();
     }
 
 
@@ -289,10 +332,221 @@ class DecisionTree
     }
 
 
+    /* flatten the tree into the struct-of-arrays layout used by the
+     * fast prediction path.
+     *
+     * A compiled prediction walks three small contiguous arrays (split
+     * column, threshold, child offset) instead of chasing node proxies
+     * through topology_, which removes most of the dependent loads of
+     * getToLeaf(). Only trees built from i_ThresholdNode splits and
+     * e_ConstProbNode leaves (the kinds the default split functors
+     * produce) can be compiled; any other node type leaves the tree
+     * uncompiled and predict() keeps using the proxy-based traversal.
+     * Returns whether compilation succeeded.
+     */
+    bool compile()
+    {
+        clearCompiled();
+        if(topology_.size() < 3)
+            return false;
+
+        // breadth-first traversal; both children of a split are
+        // allocated next to each other
+        std::vector<std::pair<TreeInt, TreeInt> > queue; // (topology addr, compiled index)
+        queue.push_back(std::make_pair(TreeInt(2), TreeInt(0)));
+        fast_column_.resize(1);
+        fast_threshold_.resize(1);
+        fast_child_.resize(1);
+        for(std::size_t head = 0; head < queue.size(); ++head)
+        {
+            TreeInt addr = queue[head].first;
+            TreeInt ci   = queue[head].second;
+            switch(topology_[addr])
+            {
+                case i_ThresholdNode:
+                {
+                    Node<i_ThresholdNode>
+                                node(topology_, parameters_, addr);
+                    TreeInt left = (TreeInt)fast_column_.size();
+                    fast_column_[ci]    = node.column();
+                    fast_threshold_[ci] = node.threshold();
+                    fast_child_[ci]     = left;
+                    fast_column_.resize(left + 2);
+                    fast_threshold_.resize(left + 2);
+                    fast_child_.resize(left + 2);
+                    queue.push_back(std::make_pair(TreeInt(node.child(0)), left));
+                    queue.push_back(std::make_pair(TreeInt(node.child(1)), TreeInt(left + 1)));
+                    break;
+                }
+                case e_ConstProbNode:
+                {
+                    Node<e_ConstProbNode>
+                                node(topology_, parameters_, addr);
+                    fast_column_[ci]    = -1;
+                    fast_threshold_[ci] = 0.0;
+                    fast_child_[ci]     = (TreeInt)fast_weights_.size() + 1;
+                    fast_weights_.push_back(node.weights());
+                    for(unsigned int l = 0; l < classCount_; ++l)
+                        fast_weights_.push_back(node.prob_begin()[l]);
+                    break;
+                }
+                default:
+                {
+                    clearCompiled();
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /* has compile() been called (and succeeded) since the last change
+     * of the tree?
+     */
+    bool isCompiled() const
+    {
+        return fast_column_.size() != 0;
+    }
+
+    /* build the quantized compiled representation.
+     *
+     * Compiles the tree (see compile()) and then shrinks the traversal
+     * data: split columns become 16 bit integers, thresholds 32 bit
+     * floats. This is an approximation - samples whose feature value
+     * falls within float rounding distance of a threshold may be
+     * routed differently than by the exact tree. Fails (returning
+     * false and leaving the exact compiled form intact if it exists)
+     * when the tree cannot be compiled or uses more than 32767 feature
+     * columns.
+     */
+    bool compileQuantized()
+    {
+        if(!isCompiled() && !compile())
+            return false;
+        for(unsigned int n = 0; n < fast_column_.size(); ++n)
+            if(fast_column_[n] > 0x7fff)
+                return false;
+        quant_column_.resize(fast_column_.size());
+        quant_threshold_.resize(fast_threshold_.size());
+        quant_child_.resize(fast_child_.size());
+        for(unsigned int n = 0; n < fast_column_.size(); ++n)
+        {
+            quant_column_[n]    = (Int16)fast_column_[n];
+            quant_threshold_[n] = (float)fast_threshold_[n];
+            quant_child_[n]     = fast_child_[n];
+        }
+        // release the exact traversal arrays - the leaf data in
+        // fast_weights_ is shared and stays
+        fast_column_.clear();
+        fast_threshold_.clear();
+        fast_child_.clear();
+        return true;
+    }
+
+    /* has compileQuantized() been called (and succeeded) since the
+     * last change of the tree?
+     */
+    bool isQuantized() const
+    {
+        return quant_column_.size() != 0;
+    }
+
+    /* largest sample count predictBatch() accepts */
+    enum { MaxPredictBatch = 8 };
+
+    /* compiled prediction for a small batch of samples.
+     *
+     * Walks the feature rows [row, row + count) through the compiled
+     * tree in lock-step: every round advances each pending traversal by
+     * one level, so several independent node lookups are in flight at
+     * once and their load latencies overlap. Samples whose skip flag is
+     * set are left untouched; for every other sample b, weights[b]
+     * receives the iterator predict() would return for that row.
+     * Requires isCompiled() and count <= MaxPredictBatch.
+     */
+    template <class U, class C>
+    void predictBatch(MultiArrayView<2, U, C> const & features,
+                      int row, int count, bool const * skip,
+                      ArrayVector<double>::const_iterator * weights) const
+    {
+        vigra_precondition((isCompiled() || isQuantized())
+                           && count <= (int)MaxPredictBatch,
+            "DecisionTree::predictBatch(): tree not compiled"
+            " or batch too large.");
+        TreeInt node[MaxPredictBatch];
+        for(int b = 0; b < count; ++b)
+            node[b] = skip[b] ? -1 : 0;
+        bool active = true;
+        if(isQuantized())
+        {
+            while(active)
+            {
+                active = false;
+                for(int b = 0; b < count; ++b)
+                {
+                    TreeInt n = node[b];
+                    if(n < 0 || quant_column_[n] < 0)
+                        continue;
+                    node[b] = quant_child_[n]
+                        + ((float)features(row + b, quant_column_[n])
+                              < quant_threshold_[n] ? 0 : 1);
+                    active = true;
+                }
+            }
+            for(int b = 0; b < count; ++b)
+                if(node[b] >= 0)
+                    weights[b] = fast_weights_.begin() + quant_child_[node[b]];
+            return;
+        }
+        while(active)
+        {
+            active = false;
+            for(int b = 0; b < count; ++b)
+            {
+                TreeInt n = node[b];
+                if(n < 0 || fast_column_[n] < 0)
+                    continue;
+                node[b] = fast_child_[n]
+                    + (features(row + b, fast_column_[n]) < fast_threshold_[n]
+                        ? 0 : 1);
+                active = true;
+            }
+        }
+        for(int b = 0; b < count; ++b)
+            if(node[b] >= 0)
+                weights[b] = fast_weights_.begin() + fast_child_[node[b]];
+    }
+
     template <class U, class C>
     ArrayVector<double>::iterator
     predict(MultiArrayView<2, U, C> const & features) const
     {
+        if(isQuantized())
+        {
+            TreeInt n = 0;
+            while(quant_column_[n] >= 0)
+            {
+                n = quant_child_[n]
+                    + ((float)features(0, quant_column_[n]) < quant_threshold_[n]
+                        ? 0 : 1);
+            }
+            return const_cast<ArrayVector<double> &>(fast_weights_).begin()
+                   + quant_child_[n];
+        }
+        if(isCompiled())
+        {
+            TreeInt n = 0;
+            while(fast_column_[n] >= 0)
+            {
+                n = fast_child_[n]
+                    + (features(0, fast_column_[n]) < fast_threshold_[n] ? 0 : 1);
+            }
+            // predict() returns a mutable iterator for historical
+            // reasons; the compiled arrays are never modified through it
+            return const_cast<ArrayVector<double> &>(fast_weights_).begin()
+                   + fast_child_[n];
+        }
+
         TreeInt nodeindex = getToLeaf(features);
         switch(topology_[nodeindex])
         {
@@ -367,6 +621,9 @@ void DecisionTree::continueLearn(   MultiArrayView<2, U, C> const       & featur
                             //an index to which the last created exterior node will be moved (because it is not used anymore)
                             int                                   garbaged_child)
 {
+    // any change to the tree invalidates the compiled representation
+    clearCompiled();
+
     std::vector<StackEntry_t> stack;
     stack.reserve(128);
     ArrayVector<StackEntry_t> child_stack_entry(2, stack_entry);
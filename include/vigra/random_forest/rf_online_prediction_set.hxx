@@ -1,4 +1,5 @@
 #include "../multi_array.hxx"
+#include "../error.hxx"
 #include <set>
 #include <vector>
 
@@ -73,5 +74,135 @@ public:
     MultiArray<2,T> features;
 };
 
+/** Growing training set for incremental random forest learning.
+ *
+ * RandomForest::onlineLearn() refines an existing forest with new
+ * labeled samples, but it requires the caller to keep the old and the
+ * new samples in one contiguous matrix and to remember where the new
+ * ones start. OnlineLearningSet takes over this bookkeeping: it owns a
+ * growing copy of all samples seen so far, and update() trains the
+ * forest on exactly the samples added since the last call - a full
+ * learn() on the first call, onlineLearn() on every later one.
+ *
+ * \code
+ * RandomForest<> rf(RandomForestOptions().prepare_online_learning(true));
+ * OnlineLearningSet<double> training_set(num_features);
+ * training_set.addSamples(initial_features, initial_labels);
+ * training_set.update(rf);                  // full training
+ * ...
+ * training_set.addSamples(new_features, new_labels);
+ * training_set.update(rf);                  // incremental refinement
+ * \endcode
+ */
+template<class T, class LabelType = double>
+class OnlineLearningSet
+{
+public:
+    typedef MultiArrayShape<2>::type Shape_t;
+
+    OnlineLearningSet(int feature_count)
+    : features_(Shape_t(0, feature_count)),
+      labels_(Shape_t(0, 1)),
+      size_(0),
+      trained_size_(0)
+    {}
+
+    /** append labeled samples (one sample per row, labels n x 1).
+     * The data is copied - the views need not stay alive.
+     */
+    template<class U, class C1, class U2, class C2>
+    void addSamples(MultiArrayView<2, U, C1> const & features,
+                    MultiArrayView<2, U2, C2> const & labels)
+    {
+        vigra_precondition(features.shape(1) == features_.shape(1),
+            "OnlineLearningSet::addSamples():"
+            " sample has wrong number of features.");
+        vigra_precondition(features.shape(0) == labels.shape(0),
+            "OnlineLearningSet::addSamples():"
+            " feature and label matrix size mismatch.");
+        reserve(size_ + (int)features.shape(0));
+        for(int i = 0; i < features.shape(0); ++i)
+        {
+            for(int j = 0; j < features.shape(1); ++j)
+                features_(size_ + i, j) = (T)features(i, j);
+            labels_(size_ + i, 0) = (LabelType)labels(i, 0);
+        }
+        size_ += (int)features.shape(0);
+    }
+
+    /** bring the forest up to date with the samples added since the
+     * last call.
+     *
+     * The first call performs the initial learn() on everything added
+     * so far; every later call passes only the new samples through
+     * RandomForest::onlineLearn(). The forest must have been created
+     * with RandomForestOptions::prepare_online_learning(true).
+     */
+    template<class RF>
+    void update(RF & rf, bool adjust_thresholds = false)
+    {
+        vigra_precondition(size_ > trained_size_,
+            "OnlineLearningSet::update():"
+            " no samples were added since the last update.");
+        vigra_precondition(rf.options().prepare_online_learning_,
+            "OnlineLearningSet::update():"
+            " forest was not created with prepare_online_learning(true).");
+        if(trained_size_ == 0)
+            rf.learn(current_features(), current_labels());
+        else
+            rf.onlineLearn(current_features(), current_labels(),
+                           trained_size_, adjust_thresholds);
+        trained_size_ = size_;
+    }
+
+    /** view of all samples added so far */
+    MultiArrayView<2, T> current_features()
+    {
+        return features_.subarray(Shape_t(0, 0),
+                                  Shape_t(size_, features_.shape(1)));
+    }
+
+    /** view of all labels added so far */
+    MultiArrayView<2, LabelType> current_labels()
+    {
+        return labels_.subarray(Shape_t(0, 0), Shape_t(size_, 1));
+    }
+
+    /** number of samples added so far */
+    int size() const
+    {
+        return size_;
+    }
+
+    /** number of samples the forest has not seen yet */
+    int unlearned_count() const
+    {
+        return size_ - trained_size_;
+    }
+
+private:
+    void reserve(int capacity)
+    {
+        if(capacity <= features_.shape(0))
+            return;
+        // grow geometrically so that repeated small additions stay cheap
+        int new_capacity = std::max<int>(capacity, 2 * (int)features_.shape(0));
+        MultiArray<2, T> new_features(Shape_t(new_capacity, features_.shape(1)));
+        MultiArray<2, LabelType> new_labels(Shape_t(new_capacity, 1));
+        new_features.subarray(Shape_t(0, 0),
+                              Shape_t(size_, features_.shape(1)))
+            = current_features();
+        new_labels.subarray(Shape_t(0, 0), Shape_t(size_, 1))
+            = current_labels();
+        new_features.swap(features_);
+        new_labels.swap(labels_);
+    }
+
+    MultiArray<2, T> features_;
+    MultiArray<2, LabelType> labels_;
+    int size_;
+    int trained_size_;
+};
+
 }
 
@@ -477,11 +477,14 @@ template <class DataSource, class Impurity= GiniCriterion>
 class ImpurityLoss
 {
 
-    DataSource  const &         labels_;
-    ArrayVector<double>        counts_;
-    ArrayVector<double> const  class_weights_;
-    double                      total_counts_;
-    Impurity                    impurity_;
+    // left/right loss objects are created afresh for every column a node
+    // looks at -- keep the class histograms in the inline buffer so that
+    // this costs no heap allocation for typical class counts
+    DataSource  const &              labels_;
+    SmallVector<double, 16>          counts_;
+    SmallVector<double, 16> const    class_weights_;
+    double                           total_counts_;
+    Impurity                         impurity_;
 
   public:
 
@@ -555,7 +558,7 @@ class ImpurityLoss
         return impurity_(counts_,class_weights_, total_counts_);
     }
     
-    ArrayVector<double> const & response()
+    SmallVector<double, 16> const & response()
     {
         return counts_;
     }
@@ -568,12 +571,12 @@ class ImpurityLoss
     {
     public:
         typedef MultiArrayShape<2>::type Shp;
-        DataSource const &      labels_;
-        ArrayVector <double>    mean_;
-        ArrayVector <double>    variance_;
-        ArrayVector <double>    tmp_;
-        size_t                  count_;
-        int*                    end_;
+        DataSource const &          labels_;
+        SmallVector<double, 16>     mean_;
+        SmallVector<double, 16>     variance_;
+        SmallVector<double, 16>     tmp_;
+        size_t                      count_;
+        int*                        end_;
         
         template<class T>
         RegressionForestCounter(DataSource const & labels, 
@@ -653,7 +656,7 @@ class ImpurityLoss
         }
         
         
-        ArrayVector<double> const & response()
+        SmallVector<double, 16> const & response()
         {
             return mean_;
         }
@@ -673,9 +676,9 @@ class RegressionForestCounter2
 public:
     typedef MultiArrayShape<2>::type Shp;
     DataSource const &      labels_;
-    ArrayVector <double>    mean_;
-    ArrayVector <double>    variance_;
-    ArrayVector <double>    tmp_;
+    SmallVector<double, 16> mean_;
+    SmallVector<double, 16> variance_;
+    SmallVector<double, 16> tmp_;
     size_t                  count_;
 
     template<class T>
@@ -788,7 +791,7 @@ public:
     }
     
 
-    ArrayVector<double> const & response()
+    SmallVector<double, 16> const & response()
     {
         return mean_;
     }
@@ -837,15 +840,22 @@ public:
     std::ptrdiff_t               min_index_;
     double                  min_threshold_;
     ProblemSpec<>           ext_param_;
+    /* when set, the caller guarantees that [begin, end) is already
+     * sorted by the column and the per-node sort is skipped (see
+     * PresortedThresholdSplit) */
+    bool                    assume_presorted_;
 
     BestGiniOfColumn()
+    :
+        assume_presorted_(false)
     {}
 
-    template<class T> 
+    template<class T>
     BestGiniOfColumn(ProblemSpec<T> const & ext)
     :
         class_weights_(ext.class_weights_),
-        ext_param_(ext)
+        ext_param_(ext),
+        assume_presorted_(false)
     {
         bestCurrentCounts[0].resize(ext.class_count_);
         bestCurrentCounts[1].resize(ext.class_count_);
@@ -895,16 +905,17 @@ public:
                     I_Iter                & end,
                     Array           const & region_response)
     {
-        std::sort(begin, end, 
-                  SortSamplesByDimensions<DataSourceF_t>(column, 0));
-        typedef typename 
+        if(!assume_presorted_)
+            std::sort(begin, end,
+                      SortSamplesByDimensions<DataSourceF_t>(column, 0));
+        typedef typename
             LossTraits<LineSearchLossTag, DataSource_t>::type LineSearchLoss;
         LineSearchLoss left(labels, ext_param_); //initialize left and right region
         LineSearchLoss right(labels, ext_param_);
 
-        
 
-        min_gini_ = right.init(begin, end, region_response);  
+
+        min_gini_ = right.init(begin, end, region_response);
         min_threshold_ = *begin;
         min_index_     = 0;  //the starting point where to split 
         DimensionNotEqual<DataSourceF_t> comp(column, 0); 
@@ -1125,9 +1136,186 @@ class ThresholdSplit: public SplitBase<Tag>
     }
 };
 
+/** ThresholdSplit variant that sorts every feature column only once per
+ * tree.
+ *
+ * ThresholdSplit lets the column functor re-sort the candidate samples
+ * at every node, which makes the per-node split search O(n log n). This
+ * functor instead sorts each feature column once at the root and then
+ * keeps one index array per feature that is partitioned alongside the
+ * node regions: a node obtains its samples in feature order with a
+ * simple copy, and after a split each per-feature array is stably
+ * partitioned in O(n). The split search itself therefore becomes O(n)
+ * per node and feature, at the cost of maintaining all feature orders
+ * on every split - worthwhile when mtry is a sizable fraction of the
+ * feature count or the trees are deep. The chosen splits are the same
+ * as with ThresholdSplit.
+ */
+template<class ColumnDecisionFunctor, class Tag = ClassificationTag>
+class PresortedThresholdSplit: public ThresholdSplit<ColumnDecisionFunctor, Tag>
+{
+  public:
+    typedef ThresholdSplit<ColumnDecisionFunctor, Tag> TS;
+    typedef SplitBase<Tag> SB;
+
+    /* one index array per feature column, each covering the root
+     * region sorted by that feature and partitioned in sync with the
+     * node regions */
+    ArrayVector<ArrayVector<Int32> > presorted_;
+    ArrayVector<Int32>               scratch_;
+    Int32 const *                    root_begin_;
+    std::ptrdiff_t                   root_size_;
+
+    PresortedThresholdSplit()
+    :
+        root_begin_(0),
+        root_size_(0)
+    {}
+
+    template<class T, class C, class T2, class C2, class Region, class Random>
+    int findBestSplit(MultiArrayView<2, T, C> features,
+                      MultiArrayView<2, T2, C2>  labels,
+                      Region & region,
+                      ArrayVector<Region>& childRegions,
+                      Random & randint)
+    {
+        typedef typename Region::IndexIterator IndexIterator;
+        if(region.size() == 0)
+        {
+           std::cerr << "SplitFunctor::findBestSplit(): stackentry with 0 examples encountered\n"
+                        "continuing learning process....";
+        }
+        detail::Correction<Tag>::exec(region, labels);
+
+        // a root call (re)sorts the feature orders for the tree's
+        // sample. Child regions always lie strictly inside the root
+        // range, so a region that covers the last presorted range
+        // again, or lies outside of it, starts a new tree.
+        Int32 const * region_begin = &*region.begin();
+        if(presorted_.size() == 0
+           || (region_begin == root_begin_
+               && (std::ptrdiff_t)region.size() == root_size_)
+           || region_begin < root_begin_
+           || region_begin >= root_begin_ + root_size_)
+            presort(features, region);
+
+        // Is the region pure already?
+        TS::region_gini_ = TS::bgfunc.loss_of_region(labels,
+                                                     region.begin(),
+                                                     region.end(),
+                                                     region.classCounts());
+        if(TS::region_gini_ <= SB::ext_param_.precision_)
+            return  this->makeTerminalNode(features, labels, region, randint);
+
+        // select columns  to be tried.
+        for(int ii = 0; ii < SB::ext_param_.actual_mtry_; ++ii)
+            std::swap(TS::splitColumns[ii],
+                      TS::splitColumns[ii+ randint(features.shape(1) - ii)]);
+
+        std::ptrdiff_t const off = &*region.begin() - root_begin_;
+
+        // find the best gini index
+        TS::bgfunc.assume_presorted_ = true;
+        TS::bestSplitIndex          = 0;
+        double  current_min_gini    = TS::region_gini_;
+        int     num2try             = features.shape(1);
+        for(int k=0; k<num2try; ++k)
+        {
+            // fetch the node's samples in feature order instead of
+            // sorting them
+            std::copy(presorted_[TS::splitColumns[k]].begin() + off,
+                      presorted_[TS::splitColumns[k]].begin() + off + region.size(),
+                      region.begin());
+            TS::bgfunc(columnVector(features, TS::splitColumns[k]),
+                       labels,
+                       region.begin(), region.end(),
+                       region.classCounts());
+            TS::min_gini_[k]            = TS::bgfunc.min_gini_;
+            TS::min_indices_[k]         = TS::bgfunc.min_index_;
+            TS::min_thresholds_[k]      = TS::bgfunc.min_threshold_;
+#ifdef CLASSIFIER_TEST
+            if(     TS::bgfunc.min_gini_ < current_min_gini
+               &&  !closeAtTolerance(TS::bgfunc.min_gini_, current_min_gini))
+#else
+            if(TS::bgfunc.min_gini_ < current_min_gini)
+#endif
+            {
+                current_min_gini = TS::bgfunc.min_gini_;
+                childRegions[0].classCounts() = TS::bgfunc.bestCurrentCounts[0];
+                childRegions[1].classCounts() = TS::bgfunc.bestCurrentCounts[1];
+                childRegions[0].classCountsIsValid = true;
+                childRegions[1].classCountsIsValid = true;
+
+                TS::bestSplitIndex   = k;
+                num2try = SB::ext_param_.actual_mtry_;
+            }
+        }
+        // did not find any suitable split
+        if(closeAtTolerance(current_min_gini, TS::region_gini_))
+            return  this->makeTerminalNode(features, labels, region, randint);
+
+        //create a Node for output
+        Node<i_ThresholdNode>   node(SB::t_data, SB::p_data);
+        SB::node_ = node;
+        node.threshold()    = TS::min_thresholds_[TS::bestSplitIndex];
+        node.column()       = TS::splitColumns[TS::bestSplitIndex];
+
+        // partition the range according to the best dimension
+        SortSamplesByDimensions<MultiArrayView<2, T, C> >
+            sorter(features, node.column(), node.threshold());
+        IndexIterator bestSplit =
+            std::partition(region.begin(), region.end(), sorter);
+
+        // keep every per-feature order aligned with the new child
+        // regions (stable partition preserves the sort within each side)
+        for(unsigned int c = 0; c < presorted_.size(); ++c)
+        {
+            Int32 * seg = presorted_[c].begin() + off;
+            scratch_.clear();
+            Int32 * left = seg;
+            for(std::ptrdiff_t i = 0; i < (std::ptrdiff_t)region.size(); ++i)
+            {
+                if(sorter(seg[i]))
+                    *left++ = seg[i];
+                else
+                    scratch_.push_back(seg[i]);
+            }
+            std::copy(scratch_.begin(), scratch_.end(), left);
+        }
+
+        // Save the ranges of the child stack entries.
+        childRegions[0].setRange(   region.begin()  , bestSplit       );
+        childRegions[0].rule = region.rule;
+        childRegions[0].rule.push_back(std::make_pair(1, 1.0));
+        childRegions[1].setRange(   bestSplit       , region.end()    );
+        childRegions[1].rule = region.rule;
+        childRegions[1].rule.push_back(std::make_pair(1, 1.0));
+
+        return i_ThresholdNode;
+    }
+
+  private:
+    template<class T, class C, class Region>
+    void presort(MultiArrayView<2, T, C> const & features, Region & region)
+    {
+        root_begin_ = &*region.begin();
+        root_size_  = region.size();
+        presorted_.resize(features.shape(1));
+        for(int c = 0; c < features.shape(1); ++c)
+        {
+            presorted_[c].resize(root_size_);
+            std::copy(region.begin(), region.end(), presorted_[c].begin());
+            std::sort(presorted_[c].begin(), presorted_[c].end(),
+                      SortSamplesByDimensions<MultiArrayView<2, T, C> >(features, c));
+        }
+        scratch_.reserve(root_size_);
+    }
+};
+
 typedef  ThresholdSplit<BestGiniOfColumn<GiniCriterion> >                      GiniSplit;
 typedef  ThresholdSplit<BestGiniOfColumn<EntropyCriterion> >                 EntropySplit;
 typedef  ThresholdSplit<BestGiniOfColumn<LSQLoss>, RegressionTag>              RegressionSplit;
+typedef  PresortedThresholdSplit<BestGiniOfColumn<GiniCriterion> >     PresortedGiniSplit;
 
 namespace rf
 {
@@ -1248,6 +1248,7 @@ class VariableImportanceVisitor : public VisitorBase
     MultiArray<2, double>       variable_importance_;
     int                         repetition_count_;
     bool                        in_place_;
+    int                         num_threads_;
 
 #ifdef HasHDF5
     void save(std::string filename, std::string prefix)
@@ -1260,13 +1261,18 @@ class VariableImportanceVisitor : public VisitorBase
 #endif
 
     /** Constructor
-     * \param rep_cnt (defautl: 10) how often should 
+     * \param rep_cnt (defautl: 10) how often should
      * the permutation take place. Set to 1 to make calculation faster (but
      * possibly more instable)
+     * \param num_threads (default: 1) number of threads used to permute
+     * and re-predict the features of each tree's OOB set. With more
+     * than one thread every feature uses its own random generator, so
+     * the importances differ (statistically insignificantly) from the
+     * single threaded result.
      */
-    VariableImportanceVisitor(int rep_cnt = 10) 
-    :   repetition_count_(rep_cnt)
-
+    VariableImportanceVisitor(int rep_cnt = 10, int num_threads = 1)
+    :   repetition_count_(rep_cnt),
+        num_threads_(num_threads)
     {}
 
     /** calculates impurity decrease based variable importance after every
@@ -1370,10 +1376,86 @@ class VariableImportanceVisitor : public VisitorBase
                 ++oob_right[class_count];
             }
         }
+#ifdef _OPENMP
+        if(num_threads_ > 1)
+        {
+            // a prediction reads the whole feature row, so every
+            // thread permutes on its own copy of the features; the
+            // importance rows written per feature are disjoint
+            UInt32 base_seed = randint(0xffffffffU);
+            std::string errorMessage;
+#pragma omp parallel num_threads(num_threads_)
+            {
+                FeatureArray thread_features(features);
+                MultiArray<2, double>
+                            thread_perm_right(Shp_t(1, class_count + 1));
+                ArrayVector<FeatureValue> thread_backup;
+#pragma omp for schedule(dynamic)
+                for(int ii = 0; ii < column_count; ++ii)
+                {
+                    try
+                    {
+                        // every feature gets its own generator so the
+                        // result does not depend on the schedule
+                        RandomMT19937 feature_random(base_seed + ii);
+                        UniformIntRandomFunctor<RandomMT19937>
+                                      feature_randint(feature_random);
+                        int const n = oob_indices.size();
+                        thread_perm_right.init(0.0);
+                        thread_backup.clear();
+                        for(int jj = 0; jj < n; ++jj)
+                            thread_backup.push_back(thread_features(oob_indices[jj], ii));
+                        for(int rr = 0; rr < repetition_count_; ++rr)
+                        {
+                            //permute dimension.
+                            for(int jj = 1; jj < n; ++jj)
+                                std::swap(thread_features(oob_indices[jj], ii),
+                                          thread_features(oob_indices[feature_randint(jj+1)], ii));
+
+                            //get the oob success rate after permuting
+                            for(int jj = 0; jj < n; ++jj)
+                            {
+                                if(rf.tree(index)
+                                        .predictLabel(rowVector(thread_features, oob_indices[jj]))
+                                    ==  pr.response()(oob_indices[jj], 0))
+                                {
+                                    //per class
+                                    ++thread_perm_right[pr.response()(oob_indices[jj], 0)];
+                                    //total
+                                    ++thread_perm_right[class_count];
+                                }
+                            }
+                        }
+                        //normalise and add to the variable_importance array.
+                        thread_perm_right /= repetition_count_;
+                        thread_perm_right -= oob_right;
+                        thread_perm_right *= -1;
+                        thread_perm_right /= oob_indices.size();
+                        variable_importance_
+                            .subarray(Shp_t(ii,0),
+                                      Shp_t(ii+1,class_count+1)) += thread_perm_right;
+                        //copy back permuted dimension
+                        for(int jj = 0; jj < n; ++jj)
+                            thread_features(oob_indices[jj], ii) = thread_backup[jj];
+                    }
+                    catch(std::exception & e)
+                    {
+#pragma omp critical(vigra_rf_varimp_error)
+                        if(errorMessage.empty())
+                            errorMessage = e.what();
+                    }
+                }
+            }
+            if(!errorMessage.empty())
+                vigra_fail("VariableImportanceVisitor: worker thread "
+                           "failed with:\n" + errorMessage);
+            return;
+        }
+#endif
         //get the oob rate after permuting the ii'th dimension.
         for(int ii = 0; ii < column_count; ++ii)
         {
-            perm_oob_right.init(0.0); 
+            perm_oob_right.init(0.0);
             //make backup of original column
             backup_column.clear();
             for(iter = oob_indices.begin(); 
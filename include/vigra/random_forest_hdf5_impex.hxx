@@ -53,6 +53,8 @@ static const char *const rf_hdf5_tree          = "Tree_";
 static const char *const rf_hdf5_version_group = ".";
 static const char *const rf_hdf5_version_tag   = "vigra_random_forest_version";
 static const double      rf_hdf5_version       =  0.1;
+static const char *const rf_hdf5_compact_group = "_compact_forest";
+static const char *const rf_hdf5_tree_offsets  = "tree_offsets";
 
 namespace detail
 {
@@ -224,6 +226,94 @@ void rf_export_HDF5(const RandomForest<T, Tag> & rf,
     rf_export_HDF5(rf, h5context, pathname);
 }
 
+/** \brief Save a random forest in compact single-blob form to an HDF5File
+           object into a specified HDF5 group.
+
+    Instead of one group with two datasets per tree (as written by
+    \ref rf_export_HDF5()), the topology and parameter arrays of all trees
+    are concatenated into two datasets, together with a small offset table
+    saying where each tree starts. A forest stored this way can be loaded
+    with three bulk reads regardless of the number of trees, which makes
+    \ref rf_import_compact_HDF5() much faster than rf_import_HDF5() for
+    forests with many trees. Options and external parameters are stored as
+    in rf_export_HDF5(), so both layouts are otherwise equivalent.
+
+    \param rf        Random forest object to be exported
+    \param h5context HDF5File object to use
+    \param pathname  If empty or not supplied, save the random forest to the
+                     current group of the HDF5File object. Otherwise, save to a
+                     new-created group specified by the path name, which may
+                     be either relative or absolute.
+*/
+template<class T, class Tag>
+void rf_export_compact_HDF5(const RandomForest<T, Tag> & rf,
+                            HDF5File & h5context,
+                            const std::string & pathname = "")
+{
+    std::string cwd;
+    if (pathname.size()) {
+        cwd = detail::get_cwd(h5context);
+        h5context.cd_mk(pathname);
+    }
+    // version attribute
+    h5context.writeAttribute(rf_hdf5_version_group, rf_hdf5_version_tag,
+                             rf_hdf5_version);
+    // save serialized options
+    detail::options_export_HDF5(h5context, rf.options(), rf_hdf5_options);
+    // save external parameters
+    detail::problemspec_export_HDF5(h5context, rf.ext_param(),
+                                    rf_hdf5_ext_param);
+    // concatenate all trees into two blobs plus an offset table:
+    // offsets[2*i] and offsets[2*i+1] are the start of tree i in the
+    // topology and parameter blob, the last pair holds the total sizes
+    int tree_count = rf.options_.tree_count_;
+    ArrayVector<Int32>  topology;
+    ArrayVector<double> parameters;
+    ArrayVector<Int32>  offsets(2 * (tree_count + 1));
+    for (int i = 0; i < tree_count; ++i)
+    {
+        offsets[2 * i]     = (Int32)topology.size();
+        offsets[2 * i + 1] = (Int32)parameters.size();
+        topology.insert(topology.end(), rf.tree(i).topology_.begin(),
+                                        rf.tree(i).topology_.end());
+        parameters.insert(parameters.end(), rf.tree(i).parameters_.begin(),
+                                            rf.tree(i).parameters_.end());
+    }
+    offsets[2 * tree_count]     = (Int32)topology.size();
+    offsets[2 * tree_count + 1] = (Int32)parameters.size();
+
+    h5context.cd_mk(rf_hdf5_compact_group);
+    h5context.write(rf_hdf5_topology, topology);
+    h5context.write(rf_hdf5_parameters, parameters);
+    h5context.write(rf_hdf5_tree_offsets, offsets);
+    h5context.cd_up();
+
+    if (pathname.size())
+        h5context.cd(cwd);
+}
+
+/** \brief Save a random forest in compact single-blob form to a named HDF5
+           file into a specified HDF5 group.
+
+    See \ref rf_export_compact_HDF5(const RandomForest<T, Tag> &, HDF5File &, const std::string &)
+    for a description of the storage layout.
+
+    \param rf       Random forest object to be exported
+    \param filename Name of an HDF5 file to open
+    \param pathname If empty or not supplied, save the random forest to the
+                    root group of the HDF5 file. Otherwise, save to a
+                    new-created group specified by the path name (relative
+                    to the root group).
+*/
+template<class T, class Tag>
+void rf_export_compact_HDF5(const RandomForest<T, Tag> & rf,
+                            const std::string & filename,
+                            const std::string & pathname = "")
+{
+    HDF5File h5context(filename , HDF5File::Open);
+    rf_export_compact_HDF5(rf, h5context, pathname);
+}
+
 /** \brief Read a random forest from an HDF5File object's specified group.
     
     The random forest is read from a certain HDF5 group (default: current group
@@ -293,13 +383,102 @@ bool rf_import_HDF5(RandomForest<T, Tag> & rf,
 */
 template<class T, class Tag>
 bool rf_import_HDF5(RandomForest<T, Tag> & rf,
-                    const std::string & filename, 
+                    const std::string & filename,
                     const std::string & pathname = "")
 {
     HDF5File h5context(filename, HDF5File::OpenReadOnly);
     return rf_import_HDF5(rf, h5context, pathname);
 }
 
+/** \brief Read a random forest in compact single-blob form from an HDF5File
+           object's specified group.
+
+    Counterpart of \ref rf_export_compact_HDF5(): the concatenated topology
+    and parameter blobs are loaded with three bulk reads and sliced into the
+    individual trees without any per-node parsing, so cold-starting from a
+    forest with many trees is much faster than with rf_import_HDF5().
+
+    \param rf        Random forest object to be imported
+    \param h5context HDF5File object to use
+    \param pathname  If empty or not supplied, read the random forest
+                     from the current group of the HDF5File object. Otherwise,
+                     use the group specified by the path name, which may
+                     be either relative or absolute.
+*/
+template<class T, class Tag>
+bool rf_import_compact_HDF5(RandomForest<T, Tag> & rf,
+                            HDF5File & h5context,
+                            const std::string & pathname = "")
+{
+    std::string cwd;
+    if (pathname.size()) {
+        cwd = detail::get_cwd(h5context);
+        h5context.cd(pathname);
+    }
+    // version attribute
+    if (h5context.existsAttribute(rf_hdf5_version_group, rf_hdf5_version_tag))
+    {
+        double read_version;
+        h5context.readAttribute(rf_hdf5_version_group, rf_hdf5_version_tag,
+                                read_version);
+        vigra_precondition(read_version <= rf_hdf5_version,
+                  "rf_import_compact_HDF5(): unexpected file format version.");
+    }
+    // get serialized options
+    detail::options_import_HDF5(h5context, rf.options_, rf_hdf5_options);
+    // get external parameters
+    detail::problemspec_import_HDF5(h5context, rf.ext_param_,
+                                    rf_hdf5_ext_param);
+    // bulk-read the concatenated trees and slice them up
+    ArrayVector<Int32>  topology;
+    ArrayVector<double> parameters;
+    ArrayVector<Int32>  offsets;
+    h5context.cd(rf_hdf5_compact_group);
+    h5context.readAndResize(rf_hdf5_topology, topology);
+    h5context.readAndResize(rf_hdf5_parameters, parameters);
+    h5context.readAndResize(rf_hdf5_tree_offsets, offsets);
+    h5context.cd_up();
+
+    vigra_precondition(offsets.size() >= 2 && offsets.size() % 2 == 0,
+          "rf_import_compact_HDF5(): corrupt tree offset table.");
+    int tree_count = (int)(offsets.size() / 2 - 1);
+    for (int i = 0; i < tree_count; ++i)
+    {
+        rf.trees_.push_back(detail::DecisionTree(rf.ext_param_));
+        detail::DecisionTree & tree = rf.trees_.back();
+        tree.topology_.insert(tree.topology_.end(),
+                              topology.begin() + offsets[2 * i],
+                              topology.begin() + offsets[2 * i + 2]);
+        tree.parameters_.insert(tree.parameters_.end(),
+                                parameters.begin() + offsets[2 * i + 1],
+                                parameters.begin() + offsets[2 * i + 3]);
+    }
+    if (pathname.size())
+        h5context.cd(cwd);
+    return true;
+}
+
+/** \brief Read a random forest in compact single-blob form from a named
+           HDF5 file's specified group.
+
+    See \ref rf_import_compact_HDF5(RandomForest<T, Tag> &, HDF5File &, const std::string &).
+
+    \param rf        Random forest object to be imported
+    \param filename  Name of an HDF5 file to open
+    \param pathname  If empty or not supplied, read the random forest
+                     from the current group of the HDF5 file. Otherwise,
+                     use the group specified by the path name, which may
+                     be either relative or absolute.
+*/
+template<class T, class Tag>
+bool rf_import_compact_HDF5(RandomForest<T, Tag> & rf,
+                            const std::string & filename,
+                            const std::string & pathname = "")
+{
+    HDF5File h5context(filename, HDF5File::OpenReadOnly);
+    return rf_import_compact_HDF5(rf, h5context, pathname);
+}
+
 } // namespace vigra
 
 #endif // VIGRA_RANDOM_FOREST_HDF5_IMPEX_HXX
@@ -44,9 +44,26 @@
 #include "imageiteratoradapter.hxx"
 #include "bordertreatment.hxx"
 #include "array_vector.hxx"
+#include "parallel_options.hxx"
 
 namespace vigra {
 
+/** \brief Filter implementation to be used by Gaussian smoothing functions.
+
+    <tt>GAUSSIAN_FIR</tt> (the default) convolves with a sampled Gaussian
+    kernel whose cost grows linearly with <tt>sigma</tt>.
+    <tt>GAUSSIAN_RECURSIVE</tt> selects the third-order recursive
+    approximation after Young and van Vliet (see
+    \ref recursiveGaussianFilterLine()), whose cost is independent of
+    <tt>sigma</tt> -- it is preferable for large smoothing scales, at the
+    price of a small approximation error near the image border.
+*/
+enum GaussianFilterMode
+{
+    GAUSSIAN_FIR = 0,
+    GAUSSIAN_RECURSIVE = 1
+};
+
 /********************************************************/
 /*                                                      */
 /*         Recursive convolution functions              */
@@ -171,7 +188,9 @@ void recursiveFilterLine(SrcIterator is, SrcIterator isend, SrcAccessor as,
     
     int x;
     
-    vigra_precondition(-1.0 < b && b < 1.0,
+    // repeated once per line by recursiveFilterX/Y(), which enforce the
+    // same condition at their API boundary
+    vigra_inner_precondition(-1.0 < b && b < 1.0,
                  "recursiveFilterLine(): -1 < factor < 1 required.\n");
                  
     // trivial case: b == 0.0 is an identity filter => simply copy the data and return
@@ -855,29 +874,54 @@ void recursiveSecondDerivativeLine(SrcIterator is, SrcIterator isend, SrcAccesso
 /** \brief Performs 1 dimensional recursive filtering (1st and 2nd order) in x direction.
 
     It calls \ref recursiveFilterLine() for every row of the
-    image. See \ref recursiveFilterLine() for more information about 
+    image. See \ref recursiveFilterLine() for more information about
     required interfaces and vigra_preconditions.
-    
+
+    The filter recurrence is inherently sequential along each row, but
+    the rows are independent of each other. The overloads taking a
+    \ref vigra::ParallelOptions argument therefore distribute the rows
+    over OpenMP threads (when more than one thread is requested and
+    VIGRA was compiled with OpenMP support). Each row is still filtered
+    by the unchanged \ref recursiveFilterLine(), so the parallel result
+    is bit-identical to the serial one.
+
     <b> Declarations:</b>
-    
+
     pass arguments explicitly:
     \code
     namespace vigra {
         // first order filter
         template <class SrcImageIterator, class SrcAccessor,
                   class DestImageIterator, class DestAccessor>
-        void recursiveFilterX(SrcImageIterator supperleft, 
+        void recursiveFilterX(SrcImageIterator supperleft,
                                SrcImageIterator slowerright, SrcAccessor as,
-                               DestImageIterator dupperleft, DestAccessor ad, 
+                               DestImageIterator dupperleft, DestAccessor ad,
                                double b, BorderTreatmentMode border);
 
         // second order filter
         template <class SrcImageIterator, class SrcAccessor,
                   class DestImageIterator, class DestAccessor>
-        void recursiveFilterX(SrcImageIterator supperleft, 
+        void recursiveFilterX(SrcImageIterator supperleft,
                                SrcImageIterator slowerright, SrcAccessor as,
-                               DestImageIterator dupperleft, DestAccessor ad, 
+                               DestImageIterator dupperleft, DestAccessor ad,
                                double b1, double b2);
+
+        // likewise, with the rows distributed over parallel threads
+        template <class SrcImageIterator, class SrcAccessor,
+                  class DestImageIterator, class DestAccessor>
+        void recursiveFilterX(SrcImageIterator supperleft,
+                               SrcImageIterator slowerright, SrcAccessor as,
+                               DestImageIterator dupperleft, DestAccessor ad,
+                               double b, BorderTreatmentMode border,
+                               ParallelOptions const & options);
+
+        template <class SrcImageIterator, class SrcAccessor,
+                  class DestImageIterator, class DestAccessor>
+        void recursiveFilterX(SrcImageIterator supperleft,
+                               SrcImageIterator slowerright, SrcAccessor as,
+                               DestImageIterator dupperleft, DestAccessor ad,
+                               double b1, double b2,
+                               ParallelOptions const & options);
     }
     \endcode
     
@@ -898,23 +942,30 @@ void recursiveSecondDerivativeLine(SrcIterator is, SrcIterator isend, SrcAccesso
                   class DestImageIterator, class DestAccessor>
         void recursiveFilterX(
                     triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
-                    pair<DestImageIterator, DestAccessor> dest, 
+                    pair<DestImageIterator, DestAccessor> dest,
                     double b1, double b2);
+
+        // both forms also accept a trailing ParallelOptions argument
             }
     \endcode
-    
+
     <b> Usage:</b>
-    
+
     <b>\#include</b> \<vigra/recursiveconvolution.hxx\><br>
     Namespace: vigra
-    
+
     \code
-    vigra::FImage src(w,h), dest(w,h);    
+    vigra::FImage src(w,h), dest(w,h);
     ...
-    
-    vigra::recursiveSmoothX(srcImageRange(src), destImage(dest), 
+
+    vigra::recursiveSmoothX(srcImageRange(src), destImage(dest),
            0.5, BORDER_TREATMENT_REFLECT);
-    
+
+    // filter the rows in parallel on 4 threads
+    vigra::recursiveFilterX(srcImageRange(src), destImage(dest),
+           0.5, vigra::BORDER_TREATMENT_REFLECT,
+           vigra::ParallelOptions().numThreads(4));
+
     \endcode
 
 */
@@ -927,18 +978,21 @@ void recursiveFilterX(SrcImageIterator supperleft,
                        DestImageIterator dupperleft, DestAccessor ad, 
                        double b, BorderTreatmentMode border)
 {
+    vigra_precondition(-1.0 < b && b < 1.0,
+                 "recursiveFilterX(): -1 < factor < 1 required.\n");
+
     int w = slowerright.x - supperleft.x;
     int h = slowerright.y - supperleft.y;
-    
+
     int y;
-    
+
     for(y=0; y<h; ++y, ++supperleft.y, ++dupperleft.y)
     {
         typename SrcImageIterator::row_iterator rs = supperleft.rowIterator();
         typename DestImageIterator::row_iterator rd = dupperleft.rowIterator();
 
-        recursiveFilterLine(rs, rs+w, as, 
-                             rd, ad, 
+        recursiveFilterLine(rs, rs+w, as,
+                             rd, ad,
                              b, border);
     }
 }
@@ -947,13 +1001,68 @@ template <class SrcImageIterator, class SrcAccessor,
           class DestImageIterator, class DestAccessor>
 inline void recursiveFilterX(
             triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
-            pair<DestImageIterator, DestAccessor> dest, 
+            pair<DestImageIterator, DestAccessor> dest,
             double b, BorderTreatmentMode border)
 {
     recursiveFilterX(src.first, src.second, src.third,
                       dest.first, dest.second, b, border);
 }
 
+template <class SrcImageIterator, class SrcAccessor,
+          class DestImageIterator, class DestAccessor>
+void recursiveFilterX(SrcImageIterator supperleft,
+                       SrcImageIterator slowerright, SrcAccessor as,
+                       DestImageIterator dupperleft, DestAccessor ad,
+                       double b, BorderTreatmentMode border,
+                       ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    if(options.getNumThreads() > 1)
+    {
+        vigra_precondition(-1.0 < b && b < 1.0,
+                     "recursiveFilterX(): -1 < factor < 1 required.\n");
+
+        int w = slowerright.x - supperleft.x;
+        int h = slowerright.y - supperleft.y;
+
+        // each row is still filtered sequentially, only the independent
+        // rows are distributed over the threads => same result as the
+        // serial version
+        #pragma omp parallel for schedule(static) num_threads(options.getNumThreads())
+        for(int y = 0; y < h; ++y)
+        {
+            SrcImageIterator s(supperleft);
+            DestImageIterator d(dupperleft);
+            s.y += y;
+            d.y += y;
+
+            typename SrcImageIterator::row_iterator rs = s.rowIterator();
+            typename DestImageIterator::row_iterator rd = d.rowIterator();
+
+            recursiveFilterLine(rs, rs+w, as,
+                                 rd, ad,
+                                 b, border);
+        }
+        return;
+    }
+#else
+    (void)options;
+#endif // _OPENMP
+    recursiveFilterX(supperleft, slowerright, as, dupperleft, ad, b, border);
+}
+
+template <class SrcImageIterator, class SrcAccessor,
+          class DestImageIterator, class DestAccessor>
+inline void recursiveFilterX(
+            triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
+            pair<DestImageIterator, DestAccessor> dest,
+            double b, BorderTreatmentMode border,
+            ParallelOptions const & options)
+{
+    recursiveFilterX(src.first, src.second, src.third,
+                      dest.first, dest.second, b, border, options);
+}
+
 /********************************************************/
 /*                                                      */
 /*            recursiveFilterX (2nd order)              */
@@ -987,13 +1096,62 @@ template <class SrcImageIterator, class SrcAccessor,
           class DestImageIterator, class DestAccessor>
 inline void recursiveFilterX(
             triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
-            pair<DestImageIterator, DestAccessor> dest, 
+            pair<DestImageIterator, DestAccessor> dest,
                        double b1, double b2)
 {
     recursiveFilterX(src.first, src.second, src.third,
                       dest.first, dest.second, b1, b2);
 }
-            
+
+template <class SrcImageIterator, class SrcAccessor,
+          class DestImageIterator, class DestAccessor>
+void recursiveFilterX(SrcImageIterator supperleft,
+                       SrcImageIterator slowerright, SrcAccessor as,
+                       DestImageIterator dupperleft, DestAccessor ad,
+                       double b1, double b2,
+                       ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    if(options.getNumThreads() > 1)
+    {
+        int w = slowerright.x - supperleft.x;
+        int h = slowerright.y - supperleft.y;
+
+        #pragma omp parallel for schedule(static) num_threads(options.getNumThreads())
+        for(int y = 0; y < h; ++y)
+        {
+            SrcImageIterator s(supperleft);
+            DestImageIterator d(dupperleft);
+            s.y += y;
+            d.y += y;
+
+            typename SrcImageIterator::row_iterator rs = s.rowIterator();
+            typename DestImageIterator::row_iterator rd = d.rowIterator();
+
+            recursiveFilterLine(rs, rs+w, as,
+                                 rd, ad,
+                                 b1, b2);
+        }
+        return;
+    }
+#else
+    (void)options;
+#endif // _OPENMP
+    recursiveFilterX(supperleft, slowerright, as, dupperleft, ad, b1, b2);
+}
+
+template <class SrcImageIterator, class SrcAccessor,
+          class DestImageIterator, class DestAccessor>
+inline void recursiveFilterX(
+            triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
+            pair<DestImageIterator, DestAccessor> dest,
+                       double b1, double b2,
+                       ParallelOptions const & options)
+{
+    recursiveFilterX(src.first, src.second, src.third,
+                      dest.first, dest.second, b1, b2, options);
+}
+
 
 
 /********************************************************/
@@ -1186,29 +1344,36 @@ inline void recursiveSmoothX(
 /** \brief Performs 1 dimensional recursive filtering (1st and 2nd order) in y direction.
 
     It calls \ref recursiveFilterLine() for every column of the
-    image. See \ref recursiveFilterLine() for more information about 
+    image. See \ref recursiveFilterLine() for more information about
     required interfaces and vigra_preconditions.
-    
+
+    Like \ref recursiveFilterX(), the overloads taking a
+    \ref vigra::ParallelOptions argument distribute the independent
+    columns over OpenMP threads and produce a result that is
+    bit-identical to the serial version.
+
     <b> Declarations:</b>
-    
+
     pass arguments explicitly:
     \code
     namespace vigra {
         // first order filter
         template <class SrcImageIterator, class SrcAccessor,
                   class DestImageIterator, class DestAccessor>
-        void recursiveFilterY(SrcImageIterator supperleft, 
+        void recursiveFilterY(SrcImageIterator supperleft,
                                SrcImageIterator slowerright, SrcAccessor as,
-                               DestImageIterator dupperleft, DestAccessor ad, 
+                               DestImageIterator dupperleft, DestAccessor ad,
                                double b, BorderTreatmentMode border);
 
         // second order filter
         template <class SrcImageIterator, class SrcAccessor,
                   class DestImageIterator, class DestAccessor>
-        void recursiveFilterY(SrcImageIterator supperleft, 
+        void recursiveFilterY(SrcImageIterator supperleft,
                                SrcImageIterator slowerright, SrcAccessor as,
-                               DestImageIterator dupperleft, DestAccessor ad, 
+                               DestImageIterator dupperleft, DestAccessor ad,
                                double b1, double b2);
+
+        // both forms also accept a trailing ParallelOptions argument
     }
     \endcode
     
@@ -1257,18 +1422,21 @@ void recursiveFilterY(SrcImageIterator supperleft,
                        DestImageIterator dupperleft, DestAccessor ad, 
                        double b, BorderTreatmentMode border)
 {
+    vigra_precondition(-1.0 < b && b < 1.0,
+                 "recursiveFilterY(): -1 < factor < 1 required.\n");
+
     int w = slowerright.x - supperleft.x;
     int h = slowerright.y - supperleft.y;
-    
+
     int x;
-    
+
     for(x=0; x<w; ++x, ++supperleft.x, ++dupperleft.x)
     {
         typename SrcImageIterator::column_iterator cs = supperleft.columnIterator();
         typename DestImageIterator::column_iterator cd = dupperleft.columnIterator();
 
-        recursiveFilterLine(cs, cs+h, as, 
-                            cd, ad, 
+        recursiveFilterLine(cs, cs+h, as,
+                            cd, ad,
                             b, border);
     }
 }
@@ -1277,13 +1445,68 @@ template <class SrcImageIterator, class SrcAccessor,
           class DestImageIterator, class DestAccessor>
 inline void recursiveFilterY(
             triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
-            pair<DestImageIterator, DestAccessor> dest, 
+            pair<DestImageIterator, DestAccessor> dest,
             double b, BorderTreatmentMode border)
 {
     recursiveFilterY(src.first, src.second, src.third,
                       dest.first, dest.second, b, border);
 }
 
+template <class SrcImageIterator, class SrcAccessor,
+          class DestImageIterator, class DestAccessor>
+void recursiveFilterY(SrcImageIterator supperleft,
+                       SrcImageIterator slowerright, SrcAccessor as,
+                       DestImageIterator dupperleft, DestAccessor ad,
+                       double b, BorderTreatmentMode border,
+                       ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    if(options.getNumThreads() > 1)
+    {
+        vigra_precondition(-1.0 < b && b < 1.0,
+                     "recursiveFilterY(): -1 < factor < 1 required.\n");
+
+        int w = slowerright.x - supperleft.x;
+        int h = slowerright.y - supperleft.y;
+
+        // each column is still filtered sequentially, only the
+        // independent columns are distributed over the threads => same
+        // result as the serial version
+        #pragma omp parallel for schedule(static) num_threads(options.getNumThreads())
+        for(int x = 0; x < w; ++x)
+        {
+            SrcImageIterator s(supperleft);
+            DestImageIterator d(dupperleft);
+            s.x += x;
+            d.x += x;
+
+            typename SrcImageIterator::column_iterator cs = s.columnIterator();
+            typename DestImageIterator::column_iterator cd = d.columnIterator();
+
+            recursiveFilterLine(cs, cs+h, as,
+                                cd, ad,
+                                b, border);
+        }
+        return;
+    }
+#else
+    (void)options;
+#endif // _OPENMP
+    recursiveFilterY(supperleft, slowerright, as, dupperleft, ad, b, border);
+}
+
+template <class SrcImageIterator, class SrcAccessor,
+          class DestImageIterator, class DestAccessor>
+inline void recursiveFilterY(
+            triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
+            pair<DestImageIterator, DestAccessor> dest,
+            double b, BorderTreatmentMode border,
+            ParallelOptions const & options)
+{
+    recursiveFilterY(src.first, src.second, src.third,
+                      dest.first, dest.second, b, border, options);
+}
+
 /********************************************************/
 /*                                                      */
 /*            recursiveFilterY (2nd order)              */
@@ -1317,13 +1540,62 @@ template <class SrcImageIterator, class SrcAccessor,
           class DestImageIterator, class DestAccessor>
 inline void recursiveFilterY(
             triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
-            pair<DestImageIterator, DestAccessor> dest, 
+            pair<DestImageIterator, DestAccessor> dest,
                        double b1, double b2)
 {
     recursiveFilterY(src.first, src.second, src.third,
                       dest.first, dest.second, b1, b2);
 }
-            
+
+template <class SrcImageIterator, class SrcAccessor,
+          class DestImageIterator, class DestAccessor>
+void recursiveFilterY(SrcImageIterator supperleft,
+                       SrcImageIterator slowerright, SrcAccessor as,
+                       DestImageIterator dupperleft, DestAccessor ad,
+                       double b1, double b2,
+                       ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    if(options.getNumThreads() > 1)
+    {
+        int w = slowerright.x - supperleft.x;
+        int h = slowerright.y - supperleft.y;
+
+        #pragma omp parallel for schedule(static) num_threads(options.getNumThreads())
+        for(int x = 0; x < w; ++x)
+        {
+            SrcImageIterator s(supperleft);
+            DestImageIterator d(dupperleft);
+            s.x += x;
+            d.x += x;
+
+            typename SrcImageIterator::column_iterator cs = s.columnIterator();
+            typename DestImageIterator::column_iterator cd = d.columnIterator();
+
+            recursiveFilterLine(cs, cs+h, as,
+                                cd, ad,
+                                b1, b2);
+        }
+        return;
+    }
+#else
+    (void)options;
+#endif // _OPENMP
+    recursiveFilterY(supperleft, slowerright, as, dupperleft, ad, b1, b2);
+}
+
+template <class SrcImageIterator, class SrcAccessor,
+          class DestImageIterator, class DestAccessor>
+inline void recursiveFilterY(
+            triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
+            pair<DestImageIterator, DestAccessor> dest,
+                       double b1, double b2,
+                       ParallelOptions const & options)
+{
+    recursiveFilterY(src.first, src.second, src.third,
+                      dest.first, dest.second, b1, b2, options);
+}
+
 
 /********************************************************/
 /*                                                      */
@@ -42,6 +42,7 @@
 #include "singular_value_decomposition.hxx"
 #include "numerictraits.hxx"
 #include "functorexpression.hxx"
+#include "parallel_options.hxx"
 
 
 namespace vigra
@@ -359,7 +360,8 @@ class LeastAngleRegressionOptions
     : max_solution_count(0),
       unconstrained_dimension_count(0),
       mode(LASSO),
-      least_squares_solutions(true)
+      least_squares_solutions(true),
+      parallel_options(ParallelOptions().numThreads(1))
     {}
 
         /** Maximum number of solutions to be computed.
@@ -442,13 +444,91 @@ class LeastAngleRegressionOptions
         return *this;
     }
 
+        /** Evaluate the candidate correlations in parallel.
+
+            In every iteration, the algorithm must correlate all variables
+            with the current residuals in order to select the next variable
+            entering the active set. When a \ref vigra::ParallelOptions
+            "ParallelOptions" object requesting more than one thread is
+            passed (and VIGRA was compiled with OpenMP support), this step
+            is distributed over the given number of threads. The default
+            (one thread) reproduces the sequential algorithm exactly.
+        */
+    LeastAngleRegressionOptions & parallelOptions(ParallelOptions const & opt)
+    {
+        parallel_options = opt;
+        return *this;
+    }
+
     int max_solution_count, unconstrained_dimension_count;
     Mode mode;
     bool least_squares_solutions;
+    ParallelOptions parallel_options;
 };
 
 namespace detail {
 
+    // correlate all columns of A with the LARS and LSQ residuals
+    // (the candidate selection step of leastAngleRegression())
+    //
+    // Every column is handled by exactly one thread, and the per-column
+    // summation order equals that of 'transpose(A) * residual', so the
+    // result is identical for any number of threads.
+template <class T, class C1>
+void larsCandidateCorrelations(MultiArrayView<2, T, C1> const & A,
+                               Matrix<T> const & larsResidual, Matrix<T> const & lsqResidual,
+                               Matrix<T> & cLARS, Matrix<T> & cLSQ,
+                               int num_threads)
+{
+    const MultiArrayIndex rows = rowCount(A);
+    const MultiArrayIndex cols = columnCount(A);
+
+#ifdef _OPENMP
+    if(num_threads > 1 && cols > 1)
+    {
+        std::string errorMessage;
+# pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(MultiArrayIndex j = 0; j < cols; ++j)
+        {
+            try
+            {
+                T clars = NumericTraits<T>::zero(),
+                  clsq  = NumericTraits<T>::zero();
+                for(MultiArrayIndex i = 0; i < rows; ++i)
+                {
+                    clars += A(i, j) * larsResidual(i, 0);
+                    clsq  += A(i, j) * lsqResidual(i, 0);
+                }
+                cLARS(j, 0) = clars;
+                cLSQ(j, 0)  = clsq;
+            }
+            catch(std::exception & e)
+            {
+# pragma omp critical(vigra_lars_correlation_error)
+                errorMessage = e.what();
+            }
+        }
+        if(!errorMessage.empty())
+            vigra_fail("leastAngleRegression(): worker thread failed with:\n" + errorMessage);
+    }
+    else
+#endif // _OPENMP
+    {
+        for(MultiArrayIndex j = 0; j < cols; ++j)
+        {
+            T clars = NumericTraits<T>::zero(),
+              clsq  = NumericTraits<T>::zero();
+            for(MultiArrayIndex i = 0; i < rows; ++i)
+            {
+                clars += A(i, j) * larsResidual(i, 0);
+                clsq  += A(i, j) * lsqResidual(i, 0);
+            }
+            cLARS(j, 0) = clars;
+            cLSQ(j, 0)  = clsq;
+        }
+    }
+}
+
 template <class T, class C1, class C2>
 struct LarsData
 {
@@ -525,8 +605,11 @@ leastAngleRegressionMainLoop(LarsData<T, C1, C2> & d,
         ColumnSet inactiveSet = d.columnPermutation.subarray((unsigned int)d.activeSetSize, (unsigned int)cols);
 
         // find next dimension to be activated
-        Matrix<T> cLARS = transpose(d.A) * (d.b - d.lars_prediction),      // correlation with LARS residual
-                  cLSQ  = transpose(d.A) * (d.b - d.next_lsq_prediction);  // correlation with LSQ residual
+        Matrix<T> larsResidual = d.b - d.lars_prediction,      // LARS residual
+                  lsqResidual  = d.b - d.next_lsq_prediction;  // LSQ residual
+        Matrix<T> cLARS(cols, 1), cLSQ(cols, 1);               // correlations with the residuals
+        detail::larsCandidateCorrelations(d.A, larsResidual, lsqResidual, cLARS, cLSQ,
+                                          options.parallel_options.getNumThreads());
 
         // In theory, all vectors in the active set should have the same correlation C, and
         // the correlation of all others should not exceed this. In practice, we may find the
@@ -822,6 +905,11 @@ leastAngleRegressionImpl(MultiArrayView<2, T, C1> const & A, MultiArrayView<2, T
                                \a lasso_solutions and \a lsq_solutions respectively).
         <DT><b>maxSolutionCount(unsigned int n)</b> (default: n = 0, i.e. compute all solutions)
                           <DD> Compute at most <tt>n</tt> solutions.
+        <DT><b>parallelOptions(ParallelOptions const &)</b> (default: one thread)
+                          <DD> Distribute the candidate correlation step of every iteration
+                               (the dominant cost for designs with many variables) over the
+                               given number of threads. Requires OpenMP support; the results
+                               are independent of the number of threads.
         </DL>
 
         <b>Usage:</b>
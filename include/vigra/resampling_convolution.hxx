@@ -44,6 +44,8 @@
 #include "functorexpression.hxx"
 #include "transformimage.hxx"
 #include "imagecontainer.hxx"
+#include "separableconvolution.hxx"
+#include "parallel_options.hxx"
 
 namespace vigra {
 
@@ -365,6 +367,217 @@ createResamplingKernels(Kernel const & kernel,
     }
 }
 
+#ifdef _OPENMP
+
+namespace resampling_detail
+{
+
+// Process the rows of a resampling convolution in parallel. Every row only
+// reads the precomputed kernel array, so the threads share it read-only and
+// each thread works on a contiguous band of rows. Results are identical to
+// the sequential loop. Must only be called with num_threads > 1.
+template <class SrcIter, class SrcAcc,
+          class DestIter, class DestAcc,
+          class KernelArray, class Functor>
+void
+resamplingConvolveXBands(SrcIter sul, SrcIter slr, SrcAcc src,
+                         DestIter dul, DestIter dlr, DestAcc dest,
+                         KernelArray const & kernels, Functor mapCoordinate,
+                         int num_threads)
+{
+    int wold = slr.x - sul.x;
+    int wnew = dlr.x - dul.x;
+    int h = slr.y - sul.y;
+
+    ArrayVector<int> bounds(num_threads+1);
+    for(int t = 0; t <= num_threads; ++t)
+        bounds[t] = (int)(((long long)h * t) / num_threads);
+
+    std::string errorMessage;
+
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+    for(int t = 0; t < num_threads; ++t)
+    {
+        try
+        {
+            SrcIter s(sul);
+            DestIter d(dul);
+            s.y += bounds[t];
+            d.y += bounds[t];
+            for(int y = bounds[t]; y < bounds[t+1]; ++y, ++s.y, ++d.y)
+            {
+                typename SrcIter::row_iterator sr = s.rowIterator();
+                typename DestIter::row_iterator dr = d.rowIterator();
+                resamplingConvolveLine(sr, sr+wold, src, dr, dr+wnew, dest,
+                                       kernels, mapCoordinate);
+            }
+        }
+        catch(std::exception & e)
+        {
+#pragma omp critical(vigra_resampling_convolve_error)
+            errorMessage = e.what();
+        }
+        catch(...)
+        {
+#pragma omp critical(vigra_resampling_convolve_error)
+            errorMessage = "unknown error";
+        }
+    }
+
+    if(errorMessage.size())
+        vigra_fail("resamplingConvolveX(): worker thread failed with:\n" + errorMessage);
+}
+
+// likewise for the columns of a y-direction resampling convolution
+template <class SrcIter, class SrcAcc,
+          class DestIter, class DestAcc,
+          class KernelArray, class Functor>
+void
+resamplingConvolveYBands(SrcIter sul, SrcIter slr, SrcAcc src,
+                         DestIter dul, DestIter dlr, DestAcc dest,
+                         KernelArray const & kernels, Functor mapCoordinate,
+                         int num_threads)
+{
+    int hold = slr.y - sul.y;
+    int hnew = dlr.y - dul.y;
+    int w = slr.x - sul.x;
+
+    ArrayVector<int> bounds(num_threads+1);
+    for(int t = 0; t <= num_threads; ++t)
+        bounds[t] = (int)(((long long)w * t) / num_threads);
+
+    std::string errorMessage;
+
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+    for(int t = 0; t < num_threads; ++t)
+    {
+        try
+        {
+            SrcIter s(sul);
+            DestIter d(dul);
+            s.x += bounds[t];
+            d.x += bounds[t];
+            for(int x = bounds[t]; x < bounds[t+1]; ++x, ++s.x, ++d.x)
+            {
+                typename SrcIter::column_iterator sc = s.columnIterator();
+                typename DestIter::column_iterator dc = d.columnIterator();
+                resamplingConvolveLine(sc, sc+hold, src, dc, dc+hnew, dest,
+                                       kernels, mapCoordinate);
+            }
+        }
+        catch(std::exception & e)
+        {
+#pragma omp critical(vigra_resampling_convolve_error)
+            errorMessage = e.what();
+        }
+        catch(...)
+        {
+#pragma omp critical(vigra_resampling_convolve_error)
+            errorMessage = "unknown error";
+        }
+    }
+
+    if(errorMessage.size())
+        vigra_fail("resamplingConvolveY(): worker thread failed with:\n" + errorMessage);
+}
+
+} // namespace resampling_detail
+
+#endif // _OPENMP
+
+/********************************************************/
+/*                                                      */
+/*               ResamplingKernelTable                  */
+/*                                                      */
+/********************************************************/
+
+/** \brief Precomputed weight table for resampling convolutions.
+
+    A resampling convolution uses a periodic sequence of sampled kernels
+    (one per phase of the rational sampling ratio, see
+    \ref createResamplingKernels()). When many lines -- or many
+    identically-sized images, e.g. the frames of a video sequence -- are
+    resampled with the same kernel, ratio, and offset, recomputing these
+    weights for every call is wasted work. A
+    <tt>ResamplingKernelTable</tt> computes them once and can then be
+    passed to \ref resamplingConvolveX(), \ref resamplingConvolveY(),
+    and \ref resamplingConvolveImage() in place of the kernel functor.
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/resampling_convolution.hxx\>
+
+    \code
+    Rational<int> ratio(1, 2), offset(0);
+    Gaussian<double> smooth(1.0);
+
+    // build the weight table once ...
+    ResamplingKernelTable table(smooth, ratio, offset);
+
+    // ... and reuse it for every frame
+    for(unsigned int frame = 0; frame < frames.size(); ++frame)
+        resamplingConvolveImage(srcImageRange(frames[frame]),
+                                destImageRange(smallFrames[frame]),
+                                table, table);
+    \endcode
+*/
+class ResamplingKernelTable
+{
+  public:
+    ResamplingKernelTable()
+    : mapCoordinate_(Rational<int>(1), Rational<int>(0))
+    {}
+
+        /** Compute the weights for the given kernel functor,
+            sampling ratio, and offset.
+        */
+    template <class Kernel>
+    ResamplingKernelTable(Kernel const & kernel,
+                          Rational<int> const & samplingRatio,
+                          Rational<int> const & offset)
+    : mapCoordinate_(samplingRatio, offset)
+    {
+        init(kernel, samplingRatio, offset);
+    }
+
+        /** (Re-)compute the weights for the given kernel functor,
+            sampling ratio, and offset.
+        */
+    template <class Kernel>
+    void init(Kernel const & kernel,
+              Rational<int> const & samplingRatio,
+              Rational<int> const & offset)
+    {
+        vigra_precondition(!samplingRatio.is_inf() && samplingRatio > 0,
+                    "ResamplingKernelTable::init(): sampling ratio must be > 0 and < infinity");
+        vigra_precondition(!offset.is_inf(),
+                    "ResamplingKernelTable::init(): offset must be < infinity");
+
+        mapCoordinate_ = resampling_detail::MapTargetToSourceCoordinate(samplingRatio, offset);
+        kernels_.resize(lcm(samplingRatio.numerator(), samplingRatio.denominator()));
+        createResamplingKernels(kernel, mapCoordinate_, kernels_);
+    }
+
+        /** The periodic kernel sequence (one kernel per phase).
+        */
+    ArrayVector<Kernel1D<double> > const & kernels() const
+    {
+        return kernels_;
+    }
+
+        /** The target-to-source coordinate mapping the table was
+            built for.
+        */
+    resampling_detail::MapTargetToSourceCoordinate const & mapCoordinate() const
+    {
+        return mapCoordinate_;
+    }
+
+  private:
+    ArrayVector<Kernel1D<double> > kernels_;
+    resampling_detail::MapTargetToSourceCoordinate mapCoordinate_;
+};
+
 /** \brief Apply a resampling filter in the x-direction.
 
     This function implements a convolution operation in x-direction
@@ -498,6 +711,133 @@ resamplingConvolveX(triple<SrcIter, SrcIter, SrcAcc> src,
                         kernel, samplingRatio, offset);
 }
 
+template <class SrcIter, class SrcAcc,
+          class DestIter, class DestAcc>
+void
+resamplingConvolveX(SrcIter sul, SrcIter slr, SrcAcc src,
+                    DestIter dul, DestIter dlr, DestAcc dest,
+                    ResamplingKernelTable const & table)
+{
+    int wold = slr.x - sul.x;
+    int wnew = dlr.x - dul.x;
+
+    vigra_precondition(table.kernels().size() > 0,
+                "resamplingConvolveX(): weight table is uninitialized");
+
+    for(; sul.y < slr.y; ++sul.y, ++dul.y)
+    {
+        typename SrcIter::row_iterator sr = sul.rowIterator();
+        typename DestIter::row_iterator dr = dul.rowIterator();
+        resamplingConvolveLine(sr, sr+wold, src, dr, dr+wnew, dest,
+                               table.kernels(), table.mapCoordinate());
+    }
+}
+
+template <class SrcIter, class SrcAcc,
+          class DestIter, class DestAcc>
+inline void
+resamplingConvolveX(triple<SrcIter, SrcIter, SrcAcc> src,
+                    triple<DestIter, DestIter, DestAcc> dest,
+                    ResamplingKernelTable const & table)
+{
+    resamplingConvolveX(src.first, src.second, src.third,
+                        dest.first, dest.second, dest.third,
+                        table);
+}
+
+template <class SrcIter, class SrcAcc,
+          class DestIter, class DestAcc,
+          class Kernel>
+void
+resamplingConvolveX(SrcIter sul, SrcIter slr, SrcAcc src,
+                    DestIter dul, DestIter dlr, DestAcc dest,
+                    Kernel const & kernel,
+                    Rational<int> const & samplingRatio, Rational<int> const & offset,
+                    ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    int num_threads = options.getNumThreads();
+    if(num_threads > slr.y - sul.y)
+        num_threads = slr.y - sul.y;
+    if(num_threads > 1)
+    {
+        vigra_precondition(!samplingRatio.is_inf() && samplingRatio > 0,
+                    "resamplingConvolveX(): sampling ratio must be > 0 and < infinity");
+        vigra_precondition(!offset.is_inf(),
+                    "resamplingConvolveX(): offset must be < infinity");
+
+        int period = lcm(samplingRatio.numerator(), samplingRatio.denominator());
+        resampling_detail::MapTargetToSourceCoordinate mapCoordinate(samplingRatio, offset);
+
+        ArrayVector<Kernel1D<double> > kernels(period);
+
+        createResamplingKernels(kernel, mapCoordinate, kernels);
+
+        resampling_detail::resamplingConvolveXBands(sul, slr, src, dul, dlr, dest,
+                                                    kernels, mapCoordinate, num_threads);
+        return;
+    }
+#endif // _OPENMP
+
+    resamplingConvolveX(sul, slr, src, dul, dlr, dest,
+                        kernel, samplingRatio, offset);
+}
+
+template <class SrcIter, class SrcAcc,
+          class DestIter, class DestAcc,
+          class Kernel>
+inline void
+resamplingConvolveX(triple<SrcIter, SrcIter, SrcAcc> src,
+                    triple<DestIter, DestIter, DestAcc> dest,
+                    Kernel const & kernel,
+                    Rational<int> const & samplingRatio, Rational<int> const & offset,
+                    ParallelOptions const & options)
+{
+    resamplingConvolveX(src.first, src.second, src.third,
+                        dest.first, dest.second, dest.third,
+                        kernel, samplingRatio, offset, options);
+}
+
+template <class SrcIter, class SrcAcc,
+          class DestIter, class DestAcc>
+void
+resamplingConvolveX(SrcIter sul, SrcIter slr, SrcAcc src,
+                    DestIter dul, DestIter dlr, DestAcc dest,
+                    ResamplingKernelTable const & table,
+                    ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    int num_threads = options.getNumThreads();
+    if(num_threads > slr.y - sul.y)
+        num_threads = slr.y - sul.y;
+    if(num_threads > 1)
+    {
+        vigra_precondition(table.kernels().size() > 0,
+                    "resamplingConvolveX(): weight table is uninitialized");
+
+        resampling_detail::resamplingConvolveXBands(sul, slr, src, dul, dlr, dest,
+                                                    table.kernels(), table.mapCoordinate(),
+                                                    num_threads);
+        return;
+    }
+#endif // _OPENMP
+
+    resamplingConvolveX(sul, slr, src, dul, dlr, dest, table);
+}
+
+template <class SrcIter, class SrcAcc,
+          class DestIter, class DestAcc>
+inline void
+resamplingConvolveX(triple<SrcIter, SrcIter, SrcAcc> src,
+                    triple<DestIter, DestIter, DestAcc> dest,
+                    ResamplingKernelTable const & table,
+                    ParallelOptions const & options)
+{
+    resamplingConvolveX(src.first, src.second, src.third,
+                        dest.first, dest.second, dest.third,
+                        table, options);
+}
+
 /********************************************************/
 /*                                                      */
 /*                  resamplingConvolveY                 */
@@ -638,6 +978,133 @@ resamplingConvolveY(triple<SrcIter, SrcIter, SrcAcc> src,
                         kernel, samplingRatio, offset);
 }
 
+template <class SrcIter, class SrcAcc,
+          class DestIter, class DestAcc>
+void
+resamplingConvolveY(SrcIter sul, SrcIter slr, SrcAcc src,
+                    DestIter dul, DestIter dlr, DestAcc dest,
+                    ResamplingKernelTable const & table)
+{
+    int hold = slr.y - sul.y;
+    int hnew = dlr.y - dul.y;
+
+    vigra_precondition(table.kernels().size() > 0,
+                "resamplingConvolveY(): weight table is uninitialized");
+
+    for(; sul.x < slr.x; ++sul.x, ++dul.x)
+    {
+        typename SrcIter::column_iterator sc = sul.columnIterator();
+        typename DestIter::column_iterator dc = dul.columnIterator();
+        resamplingConvolveLine(sc, sc+hold, src, dc, dc+hnew, dest,
+                               table.kernels(), table.mapCoordinate());
+    }
+}
+
+template <class SrcIter, class SrcAcc,
+          class DestIter, class DestAcc>
+inline void
+resamplingConvolveY(triple<SrcIter, SrcIter, SrcAcc> src,
+                    triple<DestIter, DestIter, DestAcc> dest,
+                    ResamplingKernelTable const & table)
+{
+    resamplingConvolveY(src.first, src.second, src.third,
+                        dest.first, dest.second, dest.third,
+                        table);
+}
+
+template <class SrcIter, class SrcAcc,
+          class DestIter, class DestAcc,
+          class Kernel>
+void
+resamplingConvolveY(SrcIter sul, SrcIter slr, SrcAcc src,
+                    DestIter dul, DestIter dlr, DestAcc dest,
+                    Kernel const & kernel,
+                    Rational<int> const & samplingRatio, Rational<int> const & offset,
+                    ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    int num_threads = options.getNumThreads();
+    if(num_threads > slr.x - sul.x)
+        num_threads = slr.x - sul.x;
+    if(num_threads > 1)
+    {
+        vigra_precondition(!samplingRatio.is_inf() && samplingRatio > 0,
+                    "resamplingConvolveY(): sampling ratio must be > 0 and < infinity");
+        vigra_precondition(!offset.is_inf(),
+                    "resamplingConvolveY(): offset must be < infinity");
+
+        int period = lcm(samplingRatio.numerator(), samplingRatio.denominator());
+        resampling_detail::MapTargetToSourceCoordinate mapCoordinate(samplingRatio, offset);
+
+        ArrayVector<Kernel1D<double> > kernels(period);
+
+        createResamplingKernels(kernel, mapCoordinate, kernels);
+
+        resampling_detail::resamplingConvolveYBands(sul, slr, src, dul, dlr, dest,
+                                                    kernels, mapCoordinate, num_threads);
+        return;
+    }
+#endif // _OPENMP
+
+    resamplingConvolveY(sul, slr, src, dul, dlr, dest,
+                        kernel, samplingRatio, offset);
+}
+
+template <class SrcIter, class SrcAcc,
+          class DestIter, class DestAcc,
+          class Kernel>
+inline void
+resamplingConvolveY(triple<SrcIter, SrcIter, SrcAcc> src,
+                    triple<DestIter, DestIter, DestAcc> dest,
+                    Kernel const & kernel,
+                    Rational<int> const & samplingRatio, Rational<int> const & offset,
+                    ParallelOptions const & options)
+{
+    resamplingConvolveY(src.first, src.second, src.third,
+                        dest.first, dest.second, dest.third,
+                        kernel, samplingRatio, offset, options);
+}
+
+template <class SrcIter, class SrcAcc,
+          class DestIter, class DestAcc>
+void
+resamplingConvolveY(SrcIter sul, SrcIter slr, SrcAcc src,
+                    DestIter dul, DestIter dlr, DestAcc dest,
+                    ResamplingKernelTable const & table,
+                    ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    int num_threads = options.getNumThreads();
+    if(num_threads > slr.x - sul.x)
+        num_threads = slr.x - sul.x;
+    if(num_threads > 1)
+    {
+        vigra_precondition(table.kernels().size() > 0,
+                    "resamplingConvolveY(): weight table is uninitialized");
+
+        resampling_detail::resamplingConvolveYBands(sul, slr, src, dul, dlr, dest,
+                                                    table.kernels(), table.mapCoordinate(),
+                                                    num_threads);
+        return;
+    }
+#endif // _OPENMP
+
+    resamplingConvolveY(sul, slr, src, dul, dlr, dest, table);
+}
+
+template <class SrcIter, class SrcAcc,
+          class DestIter, class DestAcc>
+inline void
+resamplingConvolveY(triple<SrcIter, SrcIter, SrcAcc> src,
+                    triple<DestIter, DestIter, DestAcc> dest,
+                    ResamplingKernelTable const & table,
+                    ParallelOptions const & options)
+{
+    resamplingConvolveY(src.first, src.second, src.third,
+                        dest.first, dest.second, dest.third,
+                        table, options);
+}
+
 /********************************************************/
 /*                                                      */
 /*               resamplingConvolveImage                */
@@ -651,6 +1118,13 @@ resamplingConvolveY(triple<SrcIter, SrcIter, SrcAcc> src,
     \ref resamplingConvolveX() and \ref resamplingConvolveY()
     with the given kernels. See there for detailed documentation.
 
+    When a \ref vigra::ParallelOptions object is passed as the last argument,
+    the rows of the x-pass and the columns of the y-pass are distributed over
+    the requested number of threads. The per-phase kernels are computed once
+    and shared read-only between the threads, and the result is identical to
+    the sequential version. Without OpenMP support, or when one thread is
+    requested, this simply calls the sequential algorithm.
+
     <b> Declarations:</b>
 
     pass arguments explicitly:
@@ -751,6 +1225,200 @@ resamplingConvolveImage(triple<SrcIterator, SrcIterator, SrcAccessor> src,
                             ky, samplingRatioY, offsetY);
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void resamplingConvolveImage(SrcIterator sul, SrcIterator slr, SrcAccessor src,
+                   DestIterator dul, DestIterator dlr, DestAccessor dest,
+                   ResamplingKernelTable const & tableX,
+                   ResamplingKernelTable const & tableY)
+{
+    typedef typename
+        NumericTraits<typename SrcAccessor::value_type>::RealPromote
+        TmpType;
+
+    BasicImage<TmpType> tmp(dlr.x - dul.x, slr.y - sul.y);
+
+    resamplingConvolveX(srcIterRange(sul, slr, src),
+                        destImageRange(tmp),
+                        tableX);
+    resamplingConvolveY(srcImageRange(tmp),
+                        destIterRange(dul, dlr, dest),
+                        tableY);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void
+resamplingConvolveImage(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                   triple<DestIterator, DestIterator, DestAccessor> dest,
+                   ResamplingKernelTable const & tableX,
+                   ResamplingKernelTable const & tableY)
+{
+    resamplingConvolveImage(src.first, src.second, src.third,
+                            dest.first, dest.second, dest.third,
+                            tableX, tableY);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor,
+          class KernelX, class KernelY>
+void resamplingConvolveImage(SrcIterator sul,SrcIterator slr, SrcAccessor src,
+                   DestIterator dul, DestIterator dlr, DestAccessor dest,
+                   KernelX const & kx,
+                   Rational<int> const & samplingRatioX, Rational<int> const & offsetX,
+                   KernelY const & ky,
+                   Rational<int> const & samplingRatioY, Rational<int> const & offsetY,
+                   ParallelOptions const & options)
+{
+    typedef typename
+        NumericTraits<typename SrcAccessor::value_type>::RealPromote
+        TmpType;
+
+    BasicImage<TmpType> tmp(dlr.x - dul.x, slr.y - sul.y);
+
+    resamplingConvolveX(srcIterRange(sul, slr, src),
+                        destImageRange(tmp),
+                        kx, samplingRatioX, offsetX, options);
+    resamplingConvolveY(srcImageRange(tmp),
+                        destIterRange(dul, dlr, dest),
+                        ky, samplingRatioY, offsetY, options);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor,
+          class KernelX, class KernelY>
+inline void
+resamplingConvolveImage(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                   triple<DestIterator, DestIterator, DestAccessor> dest,
+                   KernelX const & kx,
+                   Rational<int> const & samplingRatioX, Rational<int> const & offsetX,
+                   KernelY const & ky,
+                   Rational<int> const & samplingRatioY, Rational<int> const & offsetY,
+                   ParallelOptions const & options)
+{
+    resamplingConvolveImage(src.first, src.second, src.third,
+                            dest.first, dest.second, dest.third,
+                            kx, samplingRatioX, offsetX,
+                            ky, samplingRatioY, offsetY, options);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void resamplingConvolveImage(SrcIterator sul, SrcIterator slr, SrcAccessor src,
+                   DestIterator dul, DestIterator dlr, DestAccessor dest,
+                   ResamplingKernelTable const & tableX,
+                   ResamplingKernelTable const & tableY,
+                   ParallelOptions const & options)
+{
+    typedef typename
+        NumericTraits<typename SrcAccessor::value_type>::RealPromote
+        TmpType;
+
+    BasicImage<TmpType> tmp(dlr.x - dul.x, slr.y - sul.y);
+
+    resamplingConvolveX(srcIterRange(sul, slr, src),
+                        destImageRange(tmp),
+                        tableX, options);
+    resamplingConvolveY(srcImageRange(tmp),
+                        destIterRange(dul, dlr, dest),
+                        tableY, options);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline void
+resamplingConvolveImage(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                   triple<DestIterator, DestIterator, DestAccessor> dest,
+                   ResamplingKernelTable const & tableX,
+                   ResamplingKernelTable const & tableY,
+                   ParallelOptions const & options)
+{
+    resamplingConvolveImage(src.first, src.second, src.third,
+                            dest.first, dest.second, dest.third,
+                            tableX, tableY, options);
+}
+
+namespace resampling_detail
+{
+
+// One Burt reduction step with an externally provided scratch image. The
+// scratch image is only grown, never shrunk, so a caller that reduces
+// several levels in sequence (largest first) allocates it exactly once.
+// When num_threads > 1 and OpenMP is available, the rows of the x-pass
+// and the columns of the y-pass are distributed over the threads.
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor,
+          class TmpImage>
+void reduceBurtLevel(SrcIterator sul, SrcIterator slr, SrcAccessor src,
+                     DestIterator dul, DestIterator dlr, DestAccessor dest,
+                     ArrayVector<Kernel1D<double> > const & kernels,
+                     MapTargetToSourceCoordinate const & mapCoordinate,
+                     TmpImage & tmp, int num_threads)
+{
+    int wold = slr.x - sul.x;
+    int wnew = dlr.x - dul.x;
+    int hold = slr.y - sul.y;
+    int hnew = dlr.y - dul.y;
+
+    vigra_precondition(wnew == (wold + 1) / 2 && hnew == (hold + 1) / 2,
+       "pyramidReduceBurtFilter(): oldSize = ceil(newSize / 2) required.");
+
+    if(tmp.width() < wnew || tmp.height() < hold)
+        tmp.resize(std::max(tmp.width(), wnew), std::max(tmp.height(), hold));
+
+    typename TmpImage::traverser tul = tmp.upperLeft();
+
+#ifdef _OPENMP
+    int xthreads = std::min(num_threads, hold);
+    if(xthreads > 1)
+    {
+        resamplingConvolveXBands(sul, slr, src,
+                                 tul, tul + Diff2D(wnew, hold), tmp.accessor(),
+                                 kernels, mapCoordinate, xthreads);
+    }
+    else
+#endif // _OPENMP
+    {
+        typename TmpImage::traverser t = tul;
+        for(; sul.y < slr.y; ++sul.y, ++t.y)
+        {
+            typename SrcIterator::row_iterator sr = sul.rowIterator();
+            typename TmpImage::traverser::row_iterator tr = t.rowIterator();
+            resamplingConvolveLine(sr, sr+wold, src, tr, tr+wnew, tmp.accessor(),
+                                   kernels, mapCoordinate);
+        }
+    }
+
+#ifdef _OPENMP
+    int ythreads = std::min(num_threads, wnew);
+    if(ythreads > 1)
+    {
+        resamplingConvolveYBands(tul, tul + Diff2D(wnew, hold), tmp.accessor(),
+                                 dul, dlr, dest,
+                                 kernels, mapCoordinate, ythreads);
+    }
+    else
+#endif // _OPENMP
+    {
+        for(; dul.x < dlr.x; ++dul.x, ++tul.x)
+        {
+            typename DestIterator::column_iterator dc = dul.columnIterator();
+            typename TmpImage::traverser::column_iterator tc = tul.columnIterator();
+            resamplingConvolveLine(tc, tc+hold, tmp.accessor(), dc, dc+hnew, dest,
+                                   kernels, mapCoordinate);
+        }
+    }
+}
+
+inline void initBurtReduceKernels(double centerValue,
+                                  ArrayVector<Kernel1D<double> > & kernels)
+{
+    kernels.resize(1);
+    kernels[0].initExplicitly(-2, 2) = 0.25 - centerValue / 2.0, 0.25, centerValue, 0.25, 0.25 - centerValue / 2.0;
+}
+
+} // namespace resampling_detail
+
 /** \brief Two-fold down-sampling for image pyramid construction.
 
     Sorry, no \ref detailedDocumentation() available yet.
@@ -790,6 +1458,15 @@ resamplingConvolveImage(triple<SrcIterator, SrcIterator, SrcAccessor> src,
                                      double centerValue = 0.4);
     }
     \endcode
+
+    All three forms also accept a \ref vigra::ParallelOptions object after
+    <tt>centerValue</tt>. The pyramid form then computes the requested level
+    range with a single scratch image that is reused across levels, and the
+    rows (columns) of the horizontal (vertical) filter pass of every level
+    are distributed over the requested number of threads. Without OpenMP
+    support, or when one thread is requested, results are computed
+    sequentially; in all cases they are identical to the sequential
+    algorithm.
 */
 doxygen_overloaded_function(template <...> void pyramidReduceBurtFilter)
 
@@ -874,6 +1551,80 @@ void pyramidReduceBurtFilter(ImagePyramid<Image, Alloc> & pyramid, int fromLevel
         pyramidReduceBurtFilter(srcImageRange(pyramid[i-1]), destImageRange(pyramid[i]), centerValue);
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void pyramidReduceBurtFilter(SrcIterator sul, SrcIterator slr, SrcAccessor src,
+                             DestIterator dul, DestIterator dlr, DestAccessor dest,
+                             double centerValue, ParallelOptions const & options)
+{
+    vigra_precondition(0.25 <= centerValue && centerValue <= 0.5,
+             "pyramidReduceBurtFilter(): centerValue must be between 0.25 and 0.5.");
+
+    Rational<int> samplingRatio(1,2), offset(0);
+    resampling_detail::MapTargetToSourceCoordinate mapCoordinate(samplingRatio, offset);
+
+    ArrayVector<Kernel1D<double> > kernels;
+    resampling_detail::initBurtReduceKernels(centerValue, kernels);
+
+    typedef typename
+        NumericTraits<typename SrcAccessor::value_type>::RealPromote
+        TmpType;
+
+    BasicImage<TmpType> tmp;
+
+    resampling_detail::reduceBurtLevel(sul, slr, src, dul, dlr, dest,
+                                       kernels, mapCoordinate, tmp,
+                                       options.getNumThreads());
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline
+void pyramidReduceBurtFilter(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                             triple<DestIterator, DestIterator, DestAccessor> dest,
+                             double centerValue, ParallelOptions const & options)
+{
+    pyramidReduceBurtFilter(src.first, src.second, src.third,
+                            dest.first, dest.second, dest.third, centerValue, options);
+}
+
+template <class Image, class Alloc>
+void pyramidReduceBurtFilter(ImagePyramid<Image, Alloc> & pyramid, int fromLevel, int toLevel,
+                             double centerValue, ParallelOptions const & options)
+{
+    vigra_precondition(0.25 <= centerValue && centerValue <= 0.5,
+             "pyramidReduceBurtFilter(): centerValue must be between 0.25 and 0.5.");
+    vigra_precondition(fromLevel  < toLevel,
+       "pyramidReduceBurtFilter(): fromLevel must be smaller than toLevel.");
+    vigra_precondition(pyramid.lowestLevel() <= fromLevel && toLevel <= pyramid.highestLevel(),
+       "pyramidReduceBurtFilter(): fromLevel and toLevel must be between the lowest and highest pyramid levels (inclusive).");
+
+    Rational<int> samplingRatio(1,2), offset(0);
+    resampling_detail::MapTargetToSourceCoordinate mapCoordinate(samplingRatio, offset);
+
+    ArrayVector<Kernel1D<double> > kernels;
+    resampling_detail::initBurtReduceKernels(centerValue, kernels);
+
+    typedef typename
+        NumericTraits<typename Image::value_type>::RealPromote
+        TmpType;
+
+    // grown once for the first (largest) level, then reused
+    BasicImage<TmpType> tmp;
+
+    for(int i=fromLevel+1; i <= toLevel; ++i)
+    {
+        triple<typename Image::const_traverser, typename Image::const_traverser,
+               typename Image::ConstAccessor> s = srcImageRange(pyramid[i-1]);
+        triple<typename Image::traverser, typename Image::traverser,
+               typename Image::Accessor> d = destImageRange(pyramid[i]);
+        resampling_detail::reduceBurtLevel(s.first, s.second, s.third,
+                                           d.first, d.second, d.third,
+                                           kernels, mapCoordinate, tmp,
+                                           options.getNumThreads());
+    }
+}
+
 /** \brief Two-fold up-sampling for image pyramid reconstruction.
 
     Sorry, no \ref detailedDocumentation() available yet.
@@ -45,9 +45,36 @@
 #include "separableconvolution.hxx"
 #include "resampling_convolution.hxx"
 #include "splines.hxx"
+#include "parallel_options.hxx"
 
 namespace vigra {
 
+namespace detail {
+
+// Intermediate pixel type of the two resize passes. 8-bit sources get a
+// single-precision intermediate image, which halves the memory traffic of
+// the temporary image -- the final rounding to 8 bits loses far more
+// precision than the difference between a float and a double intermediate.
+template <class T>
+struct ResizeImageTmpType
+{
+    typedef typename NumericTraits<T>::RealPromote type;
+};
+
+template <>
+struct ResizeImageTmpType<UInt8>
+{
+    typedef float type;
+};
+
+template <>
+struct ResizeImageTmpType<RGBValue<UInt8> >
+{
+    typedef RGBValue<float> type;
+};
+
+} // namespace detail
+
 /*****************************************************************/
 /*                                                               */
 /*                         CoscotFunction                        */
@@ -584,6 +611,15 @@ resizeImageLinearInterpolation(triple<SrcIterator, SrcIterator, SrcAccessor> src
     real number and \ref NumericTraits "NumericTraits".
     The function uses accessors.
 
+    Both passes of the algorithm consist of independent column resp. row
+    computations. The overloads taking a \ref vigra::ParallelOptions
+    argument therefore distribute contiguous bands of columns resp. rows
+    over the requested number of threads, with results identical to the
+    sequential version. Without OpenMP support, or when one thread is
+    requested, this simply calls the sequential algorithm. For 8-bit
+    sources, the intermediate image is computed in single precision,
+    which halves its memory traffic.
+
     <b> Declarations:</b>
 
     pass arguments explicitly:
@@ -701,7 +737,7 @@ resizeImageSplineInterpolation(
     double const scale = 2.0;
 
     typedef typename SrcAccessor::value_type SRCVT;
-    typedef typename NumericTraits<SRCVT>::RealPromote TMPTYPE;
+    typedef typename detail::ResizeImageTmpType<SRCVT>::type TMPTYPE;
     typedef BasicImage<TMPTYPE> TmpImage;
     typedef typename TmpImage::traverser TmpImageIterator;
 
@@ -827,6 +863,248 @@ resizeImageSplineInterpolation(triple<SrcIterator, SrcIterator, SrcAccessor> src
                                    dest.first, dest.second, dest.third, spline);
 }
 
+// multi-threaded version: the prefilter and resampling passes consist of
+// independent column resp. row computations, so each thread handles one
+// contiguous band of columns (first pass) resp. rows (second pass) with
+// its own line buffer; the resampling kernels are shared read-only
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor,
+          class SPLINE>
+void
+resizeImageSplineInterpolation(
+    SrcIterator src_iter, SrcIterator src_iter_end, SrcAccessor src_acc,
+    DestIterator dest_iter, DestIterator dest_iter_end, DestAccessor dest_acc,
+    SPLINE const & spline, ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    int width_old = src_iter_end.x - src_iter.x;
+    int height_old = src_iter_end.y - src_iter.y;
+
+    int width_new = dest_iter_end.x - dest_iter.x;
+    int height_new = dest_iter_end.y - dest_iter.y;
+
+    int max_extent = (width_old < height_new) ? width_old : height_new;
+
+    int num_threads = options.getNumThreads();
+    if(num_threads > max_extent)
+        num_threads = max_extent;
+    if(num_threads > 1)
+    {
+        vigra_precondition((width_old > 1) && (height_old > 1),
+                     "resizeImageSplineInterpolation(): "
+                     "Source image too small.\n");
+
+        vigra_precondition((width_new > 1) && (height_new > 1),
+                     "resizeImageSplineInterpolation(): "
+                     "Destination image too small.\n");
+
+        Rational<int> xratio(width_new - 1, width_old - 1);
+        Rational<int> yratio(height_new - 1, height_old - 1);
+        Rational<int> offset(0);
+        resampling_detail::MapTargetToSourceCoordinate xmapCoordinate(xratio, offset);
+        resampling_detail::MapTargetToSourceCoordinate ymapCoordinate(yratio, offset);
+        int xperiod = lcm(xratio.numerator(), xratio.denominator());
+        int yperiod = lcm(yratio.numerator(), yratio.denominator());
+
+        double const scale = 2.0;
+
+        typedef typename SrcAccessor::value_type SRCVT;
+        typedef typename detail::ResizeImageTmpType<SRCVT>::type TMPTYPE;
+        typedef BasicImage<TMPTYPE> TmpImage;
+        typedef typename TmpImage::traverser TmpImageIterator;
+
+        BasicImage<TMPTYPE> tmp(width_old, height_new);
+
+        typename BasicImage<TMPTYPE>::Accessor tmp_acc = tmp.accessor();
+        ArrayVector<double> const & prefilterCoeffs = spline.prefilterCoefficients();
+
+        ArrayVector<Kernel1D<double> > ykernels(yperiod);
+        createResamplingKernels(spline, ymapCoordinate, ykernels);
+
+        ArrayVector<Kernel1D<double> > xkernels(xperiod);
+        createResamplingKernels(spline, xmapCoordinate, xkernels);
+
+        int line_size = (height_old > width_old) ? height_old : width_old;
+
+        std::string errorMessage;
+
+        // first pass: prefilter and resample the columns into tmp
+        ArrayVector<int> cbounds(num_threads+1);
+        for(int t = 0; t <= num_threads; ++t)
+            cbounds[t] = (int)(((long long)width_old * t) / num_threads);
+
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(int t = 0; t < num_threads; ++t)
+        {
+            try
+            {
+                BasicImage<TMPTYPE> line(line_size, 1);
+                typename TmpImageIterator::row_iterator line_tmp =
+                                          line.upperLeft().rowIterator();
+
+                SrcIterator xsrc(src_iter);
+                xsrc.x += cbounds[t];
+                typename BasicImage<TMPTYPE>::Iterator y_tmp = tmp.upperLeft();
+                y_tmp.x += cbounds[t];
+
+                for(int x = cbounds[t]; x < cbounds[t+1]; ++x, ++xsrc.x, ++y_tmp.x)
+                {
+                    typename SrcIterator::column_iterator c_src = xsrc.columnIterator();
+                    typename TmpImageIterator::column_iterator c_tmp = y_tmp.columnIterator();
+
+                    if(prefilterCoeffs.size() == 0)
+                    {
+                        if(height_new >= height_old)
+                        {
+                            resamplingConvolveLine(c_src, c_src + height_old, src_acc,
+                                                   c_tmp, c_tmp + height_new, tmp_acc,
+                                                   ykernels, ymapCoordinate);
+                        }
+                        else
+                        {
+                            recursiveSmoothLine(c_src, c_src + height_old, src_acc,
+                                 line_tmp, line.accessor(), (double)height_old/height_new/scale);
+                            resamplingConvolveLine(line_tmp, line_tmp + height_old, line.accessor(),
+                                                   c_tmp, c_tmp + height_new, tmp_acc,
+                                                   ykernels, ymapCoordinate);
+                        }
+                    }
+                    else
+                    {
+                        recursiveFilterLine(c_src, c_src + height_old, src_acc,
+                                            line_tmp, line.accessor(),
+                                            prefilterCoeffs[0], BORDER_TREATMENT_REFLECT);
+                        for(unsigned int b = 1; b < prefilterCoeffs.size(); ++b)
+                        {
+                            recursiveFilterLine(line_tmp, line_tmp + height_old, line.accessor(),
+                                                line_tmp, line.accessor(),
+                                                prefilterCoeffs[b], BORDER_TREATMENT_REFLECT);
+                        }
+                        if(height_new < height_old)
+                        {
+                            recursiveSmoothLine(line_tmp, line_tmp + height_old, line.accessor(),
+                                 line_tmp, line.accessor(), (double)height_old/height_new/scale);
+                        }
+                        resamplingConvolveLine(line_tmp, line_tmp + height_old, line.accessor(),
+                                               c_tmp, c_tmp + height_new, tmp_acc,
+                                               ykernels, ymapCoordinate);
+                    }
+                }
+            }
+            catch(std::exception & e)
+            {
+#pragma omp critical(vigra_resize_image_spline_error)
+                errorMessage = e.what();
+            }
+            catch(...)
+            {
+#pragma omp critical(vigra_resize_image_spline_error)
+                errorMessage = "unknown exception";
+            }
+        }
+
+        if(errorMessage.size())
+            vigra_fail("resizeImageSplineInterpolation(): worker thread failed with:\n" + errorMessage);
+
+        // second pass: prefilter and resample the rows of tmp into dest
+        ArrayVector<int> rbounds(num_threads+1);
+        for(int t = 0; t <= num_threads; ++t)
+            rbounds[t] = (int)(((long long)height_new * t) / num_threads);
+
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(int t = 0; t < num_threads; ++t)
+        {
+            try
+            {
+                BasicImage<TMPTYPE> line(line_size, 1);
+                typename TmpImageIterator::row_iterator line_tmp =
+                                          line.upperLeft().rowIterator();
+
+                DestIterator ydest(dest_iter);
+                ydest.y += rbounds[t];
+                typename BasicImage<TMPTYPE>::Iterator y_tmp = tmp.upperLeft();
+                y_tmp.y += rbounds[t];
+
+                for(int y = rbounds[t]; y < rbounds[t+1]; ++y, ++y_tmp.y, ++ydest.y)
+                {
+                    typename DestIterator::row_iterator r_dest = ydest.rowIterator();
+                    typename TmpImageIterator::row_iterator r_tmp = y_tmp.rowIterator();
+
+                    if(prefilterCoeffs.size() == 0)
+                    {
+                        if(width_new >= width_old)
+                        {
+                            resamplingConvolveLine(r_tmp, r_tmp + width_old, tmp.accessor(),
+                                                   r_dest, r_dest + width_new, dest_acc,
+                                                   xkernels, xmapCoordinate);
+                        }
+                        else
+                        {
+                            recursiveSmoothLine(r_tmp, r_tmp + width_old, tmp.accessor(),
+                                              line_tmp, line.accessor(), (double)width_old/width_new/scale);
+                            resamplingConvolveLine(line_tmp, line_tmp + width_old, line.accessor(),
+                                                   r_dest, r_dest + width_new, dest_acc,
+                                                   xkernels, xmapCoordinate);
+                        }
+                    }
+                    else
+                    {
+                        recursiveFilterLine(r_tmp, r_tmp + width_old, tmp.accessor(),
+                                            line_tmp, line.accessor(),
+                                            prefilterCoeffs[0], BORDER_TREATMENT_REFLECT);
+                        for(unsigned int b = 1; b < prefilterCoeffs.size(); ++b)
+                        {
+                            recursiveFilterLine(line_tmp, line_tmp + width_old, line.accessor(),
+                                                line_tmp, line.accessor(),
+                                                prefilterCoeffs[b], BORDER_TREATMENT_REFLECT);
+                        }
+                        if(width_new < width_old)
+                        {
+                            recursiveSmoothLine(line_tmp, line_tmp + width_old, line.accessor(),
+                                                line_tmp, line.accessor(), (double)width_old/width_new/scale);
+                        }
+                        resamplingConvolveLine(line_tmp, line_tmp + width_old, line.accessor(),
+                                               r_dest, r_dest + width_new, dest_acc,
+                                               xkernels, xmapCoordinate);
+                    }
+                }
+            }
+            catch(std::exception & e)
+            {
+#pragma omp critical(vigra_resize_image_spline_error)
+                errorMessage = e.what();
+            }
+            catch(...)
+            {
+#pragma omp critical(vigra_resize_image_spline_error)
+                errorMessage = "unknown exception";
+            }
+        }
+
+        if(errorMessage.size())
+            vigra_fail("resizeImageSplineInterpolation(): worker thread failed with:\n" + errorMessage);
+        return;
+    }
+#endif // _OPENMP
+
+    resizeImageSplineInterpolation(src_iter, src_iter_end, src_acc,
+                                   dest_iter, dest_iter_end, dest_acc, spline);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor,
+          class SPLINE>
+inline
+void
+resizeImageSplineInterpolation(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                      triple<DestIterator, DestIterator, DestAccessor> dest,
+                      SPLINE const & spline, ParallelOptions const & options)
+{
+    resizeImageSplineInterpolation(src.first, src.second, src.third,
+                                   dest.first, dest.second, dest.third,
+                                   spline, options);
+}
+
 template <class SrcIterator, class SrcAccessor,
           class DestIterator, class DestAccessor>
 void
@@ -261,6 +261,9 @@ class Sampler
     IndexArrayType        current_sample_;
     mutable IndexArrayType        current_oob_sample_;
     IsUsedArrayType       is_used_;
+    // a reference, so that the sampler shares (and advances) the state
+    // of the caller's generator; the caller must keep the generator
+    // alive, therefore the default argument is the global instance
     Random const & random_;
     SamplerOptions options_;
 
@@ -294,8 +297,8 @@ class Sampler
             indices according to the options passed. If no options are given, 
             <tt>totalCount</tt> indices will be drawn with replacement.
         */
-    Sampler(UInt32 totalCount, SamplerOptions const & opt = SamplerOptions(), 
-            Random const & rnd = Random(RandomSeed))
+    Sampler(UInt32 totalCount, SamplerOptions const & opt = SamplerOptions(),
+            Random const & rnd = Random::global())
     : total_count_(totalCount),
       sample_size_(opt.sample_size == 0
                          ? (int)(std::ceil(total_count_ * opt.sample_proportion))
@@ -333,8 +336,8 @@ class Sampler
             in which case the strata are ignored.
         */
     template <class Iterator>
-    Sampler(Iterator strataBegin, Iterator strataEnd, SamplerOptions const & opt = SamplerOptions(), 
-            Random const & rnd = Random(RandomSeed))
+    Sampler(Iterator strataBegin, Iterator strataEnd, SamplerOptions const & opt = SamplerOptions(),
+            Random const & rnd = Random::global())
     : total_count_(strataEnd - strataBegin),
       sample_size_(opt.sample_size == 0
                          ? (int)(std::ceil(total_count_ * opt.sample_proportion))
@@ -557,6 +560,241 @@ public:
     }
 };
 
+/************************************************************/
+/*                                                          */
+/*                      AliasSampler                        */
+/*                                                          */
+/************************************************************/
+
+/** \brief Draw indices from an arbitrary discrete weight distribution
+    in O(1) per draw.
+
+    The sampler is initialized with a sequence of non-negative weights
+    (they need not sum to one). Setup builds Walker's alias table in
+    O(n) using Vose's algorithm; afterwards every call to sample()
+    returns index <tt>i</tt> with probability
+    <tt>weight[i] / sum(weights)</tt> at the cost of one uniform
+    integer and one uniform double, independent of <tt>n</tt>.
+
+    <b>Usage:</b>
+
+    <b>\#include</b> \<vigra/sampling.hxx\><br>
+    Namespace: vigra
+
+    \code
+    ArrayVector<double> weights(totalCount);
+    ... // fill the weights
+    AliasSampler<> sampler(weights.begin(), weights.end());
+    for(int k=0; k<numberOfSamples; ++k)
+        processData(data[sampler.sample()]);
+    \endcode
+*/
+template<class Random = MersenneTwister >
+class AliasSampler
+{
+  public:
+        /** Internal type of the indices (same restriction as in Sampler).
+        */
+    typedef Int32 IndexType;
+
+        /** Build the alias table for the weight sequence
+            <tt>[weightsBegin, weightsEnd)</tt> in O(n).
+
+            All weights must be non-negative, and at least one must be
+            positive.
+        */
+    template <class Iterator>
+    AliasSampler(Iterator weightsBegin, Iterator weightsEnd,
+                 Random const & rnd = Random(RandomSeed))
+    : random_(rnd)
+    {
+        int n = weightsEnd - weightsBegin;
+        vigra_precondition(n > 0,
+            "AliasSampler(): Weight sequence must not be empty.");
+
+        ArrayVector<double> scaled(n);
+        double sum = 0.0;
+        for(int i = 0; i < n; ++i, ++weightsBegin)
+        {
+            vigra_precondition(*weightsBegin >= 0.0,
+                "AliasSampler(): Weights must not be negative.");
+            scaled[i] = *weightsBegin;
+            sum += scaled[i];
+        }
+        vigra_precondition(sum > 0.0,
+            "AliasSampler(): At least one weight must be positive.");
+
+        prob_.resize(n);
+        alias_.resize(n);
+        for(int i = 0; i < n; ++i)
+            scaled[i] *= n / sum;
+
+        // partition into indices with less resp. more than average weight
+        ArrayVector<IndexType> small, large;
+        for(int i = 0; i < n; ++i)
+            (scaled[i] < 1.0 ? small : large).push_back(i);
+
+        // each table slot pairs one light index with one heavy alias
+        while(!small.empty() && !large.empty())
+        {
+            IndexType s = small.back(), l = large.back();
+            small.pop_back();
+            prob_[s]  = scaled[s];
+            alias_[s] = l;
+            scaled[l] = (scaled[l] + scaled[s]) - 1.0;   // numerically stable
+            if(scaled[l] < 1.0)
+            {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+        // remaining indices have (up to round-off) exactly average weight
+        for(unsigned int k = 0; k < large.size(); ++k)
+            prob_[large[k]] = 1.0;
+        for(unsigned int k = 0; k < small.size(); ++k)
+            prob_[small[k]] = 1.0;
+    }
+
+        /** Draw one index according to the weight distribution (O(1)).
+        */
+    IndexType sample() const
+    {
+        IndexType k = (IndexType)random_.uniformInt(prob_.size());
+        return random_.uniform53() < prob_[k] ? k : alias_[k];
+    }
+
+        /** The number of weights the sampler was created with.
+        */
+    int totalCount() const
+    {
+        return prob_.size();
+    }
+
+  private:
+    ArrayVector<double>    prob_;
+    ArrayVector<IndexType> alias_;
+    Random                 random_;
+};
+
+/************************************************************/
+/*                                                          */
+/*                    ReservoirSampler                      */
+/*                                                          */
+/************************************************************/
+
+/** \brief Draw a uniform sample without replacement from a stream of
+    unknown length.
+
+    A reservoir sampler keeps a sample of (up to) <tt>sampleSize</tt>
+    items from the items passed to add() so far, without storing or
+    even knowing the length of the stream (algorithm R). After
+    <tt>t >= sampleSize</tt> calls to add(), each of the <tt>t</tt>
+    items is in the reservoir with equal probability
+    <tt>sampleSize / t</tt>. This allows sampling from data too large
+    to index, at the cost of one uniform integer per stream item.
+
+    <b>Usage:</b>
+
+    <b>\#include</b> \<vigra/sampling.hxx\><br>
+    Namespace: vigra
+
+    \code
+    ReservoirSampler<double> sampler(1000);
+    while(stream.hasMore())
+        sampler.add(stream.next());
+    // sampler.sample() now holds 1000 items drawn uniformly
+    // without replacement from the entire stream
+    \endcode
+*/
+template<class T, class Random = MersenneTwister >
+class ReservoirSampler
+{
+  public:
+    typedef ArrayVector<T>     SampleArrayType;
+    typedef ArrayVectorView<T> SampleArrayViewType;
+
+        /** Create a reservoir holding at most \a sampleSize items.
+        */
+    ReservoirSampler(unsigned int sampleSize,
+                     Random const & rnd = Random(RandomSeed))
+    : sample_size_(sampleSize),
+      seen_(0),
+      random_(rnd)
+    {
+        vigra_precondition(sampleSize > 0,
+            "ReservoirSampler(): Sample size must be positive.");
+        reservoir_.reserve(sampleSize);
+    }
+
+        /** Offer the next stream item to the sampler.
+        */
+    void add(T const & item)
+    {
+        if(seen_ < sample_size_)
+        {
+            reservoir_.push_back(item);
+        }
+        else
+        {
+            // item survives with probability sample_size_ / (seen_ + 1)
+            UInt32 j = random_.uniformInt(seen_ + 1);
+            if(j < sample_size_)
+                reservoir_[j] = item;
+        }
+        ++seen_;
+    }
+
+        /** The current sample (contains fewer than sampleSize() items
+            only when the stream was shorter than the reservoir).
+        */
+    SampleArrayViewType sample() const
+    {
+        return reservoir_;
+    }
+
+        /** The k-th item of the current sample.
+        */
+    T const & operator[](int k) const
+    {
+        return reservoir_[k];
+    }
+
+        /** Number of items currently in the reservoir.
+        */
+    int size() const
+    {
+        return reservoir_.size();
+    }
+
+        /** The maximum number of items the reservoir will hold.
+        */
+    int sampleSize() const
+    {
+        return sample_size_;
+    }
+
+        /** Number of stream items offered to add() so far.
+        */
+    UInt32 seenCount() const
+    {
+        return seen_;
+    }
+
+        /** Empty the reservoir to sample a new stream.
+        */
+    void reset()
+    {
+        reservoir_.clear();
+        seen_ = 0;
+    }
+
+  private:
+    unsigned int    sample_size_;
+    UInt32          seen_;
+    SampleArrayType reservoir_;
+    Random          random_;
+};
+
 //@}
 
 } // namespace vigra
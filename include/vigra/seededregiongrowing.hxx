@@ -44,6 +44,8 @@
 #include "stdimagefunctions.hxx"
 #include "pixelneighborhood.hxx"
 #include "bucket_queue.hxx"
+#include "array_vector.hxx"
+#include "parallel_options.hxx"
 
 namespace vigra {
 
@@ -116,30 +118,46 @@ public:
         }
     };
 
+    // Pooled allocator: pixels are carved out of larger chunks instead of
+    // being allocated individually, so the hot loop of seededRegionGrowing()
+    // never calls operator new for a single queue entry. Dismissed pixels
+    // are recycled via the freelist; all chunks are released at once when
+    // the allocator goes out of scope.
     struct Allocator
     {
+        enum { chunk_size = 1024 };
+
+        Allocator()
+        : chunk_fill_(chunk_size)
+        {}
+
         ~Allocator()
         {
-            while(!freelist_.empty())
-            {
-                delete freelist_.top();
-                freelist_.pop();
-            }
+            for(unsigned int i=0; i<chunks_.size(); ++i)
+                delete[] chunks_[i];
         }
 
         SeedRgPixel *
         create(Point2D const & location, Point2D const & nearest,
                COST const & cost, int const & count, int const & label)
         {
+            SeedRgPixel * res;
             if(!freelist_.empty())
             {
-                SeedRgPixel * res = freelist_.top();
+                res = freelist_.top();
                 freelist_.pop();
-                res->set(location, nearest, cost, count, label);
-                return res;
             }
-
-            return new SeedRgPixel(location, nearest, cost, count, label);
+            else
+            {
+                if(chunk_fill_ == (int)chunk_size)
+                {
+                    chunks_.push_back(new SeedRgPixel[chunk_size]);
+                    chunk_fill_ = 0;
+                }
+                res = chunks_.back() + chunk_fill_++;
+            }
+            res->set(location, nearest, cost, count, label);
+            return res;
         }
 
         void dismiss(SeedRgPixel * p)
@@ -148,6 +166,8 @@ public:
         }
 
         std::stack<SeedRgPixel<COST> *> freelist_;
+        std::vector<SeedRgPixel<COST> *> chunks_;
+        int chunk_fill_;
     };
 };
 
@@ -159,6 +179,45 @@ struct UnlabelWatersheds
     }
 };
 
+    // candidate entry for the bucket queue variant of seededRegionGrowing():
+    // the cost is stored implicitly as the bucket index, and ties are
+    // broken by insertion order, so neither cost_ nor nearest_/count_
+    // from SeedRgPixel are needed here
+struct SeedRgBucketEntry
+{
+    Point2D location_;
+    int label_;
+
+    SeedRgBucketEntry()
+    : location_(0,0), label_(0)
+    {}
+
+    SeedRgBucketEntry(Point2D const & location, int label)
+    : location_(location), label_(label)
+    {}
+};
+
+    // costs that are small unsigned integers can serve directly as bucket
+    // indices, so the corresponding seededRegionGrowing() instantiations
+    // replace the candidate heap with a bucket queue (O(1) push and pop)
+template <class COST>
+struct SeedRgUseBucketQueue
+{
+    typedef VigraFalseType type;
+};
+
+template <>
+struct SeedRgUseBucketQueue<unsigned char>
+{
+    typedef VigraTrueType type;
+};
+
+template <>
+struct SeedRgUseBucketQueue<unsigned short>
+{
+    typedef VigraTrueType type;
+};
+
 } // namespace detail
 
 /** \addtogroup SeededRegionGrowing Region Segmentation Algorithms
@@ -173,217 +232,31 @@ struct UnlabelWatersheds
 /********************************************************/
 
 /** Choose between different types of Region Growing */
-enum SRGType { 
-    CompleteGrow = 0, 
-    KeepContours = 1, 
-    StopAtThreshold = 2, 
-    SRGWatershedLabel = -1 
+enum SRGType {
+    CompleteGrow = 0,
+    KeepContours = 1,
+    StopAtThreshold = 2,
+    SRGWatershedLabel = -1
 };
 
-/** \brief Region Segmentation by means of Seeded Region Growing.
-
-    This algorithm implements seeded region growing as described in
-
-    R. Adams, L. Bischof: "<em> Seeded Region Growing</em>", IEEE Trans. on Pattern
-    Analysis and Maschine Intelligence, vol 16, no 6, 1994, and
-
-    Ullrich K&ouml;the:
-    <em><a href="http://hci.iwr.uni-heidelberg.de/people/ukoethe/papers/index.php#cite_primary_segmentation">Primary Image Segmentation</a></em>,
-    in: G. Sagerer, S.
-    Posch, F. Kummert (eds.): Mustererkennung 1995, Proc. 17. DAGM-Symposium,
-    Springer 1995
-
-    The seed image is a partly segmented image which contains uniquely
-    labeled regions (the seeds) and unlabeled pixels (the candidates, label 0).
-    The highest seed label found in the seed image is returned by the algorithm.
-    
-    Seed regions can be as large as you wish and as small as one pixel. If
-    there are no candidates, the algorithm will simply copy the seed image
-    into the output image. Otherwise it will aggregate the candidates into
-    the existing regions so that a cost function is minimized. 
-    Candidates are taken from the neighborhood of the already assigned pixels, 
-    where the type of neighborhood is determined by parameter <tt>neighborhood</tt>
-    which can take the values <tt>FourNeighborCode()</tt> (the default) 
-    or <tt>EightNeighborCode()</tt>. The algorithm basically works as follows 
-    (illustrated for 4-neighborhood, but 8-neighborhood works in the same way):
-
-    <ol>
-
-    <li> Find all candidate pixels that are 4-adjacent to a seed region.
-    Calculate the cost for aggregating each candidate into its adjacent region
-    and put the candidates into a priority queue.
-
-    <li> While( priority queue is not empty and termination criterion is not fulfilled)
-
-        <ol>
-
-        <li> Take the candidate with least cost from the queue. If it has not
-        already been merged, merge it with it's adjacent region.
-
-        <li> Put all candidates that are 4-adjacent to the pixel just processed
-        into the priority queue.
-
-        </ol>
-
-    </ol>
-
-    <tt>SRGType</tt> can take the following values:
-    
-    <DL>
-    <DT><tt>CompleteGrow</tt> <DD> produce a complete tesselation of the volume (default).
-    <DT><tt>KeepContours</tt> <DD> keep a 1-voxel wide unlabeled contour between all regions.
-    <DT><tt>StopAtThreshold</tt> <DD> stop when the boundary indicator values exceed the 
-                             threshold given by parameter <tt>max_cost</tt>.
-    <DT><tt>KeepContours | StopAtThreshold</tt> <DD> keep 1-voxel wide contour and stop at given <tt>max_cost</tt>.
-    </DL>
-
-    The cost is determined jointly by the source image and the
-    region statistics functor. The source image contains feature values for each
-    pixel which will be used by the region statistics functor to calculate and
-    update statistics for each region and to calculate the cost for each
-    candidate. The <TT>RegionStatisticsArray</TT> must be compatible to the
-    \ref ArrayOfRegionStatistics functor and contains an <em> array</em> of
-    statistics objects for each region. The indices must correspond to the
-    labels of the seed regions. The statistics for the initial regions must have
-    been calculated prior to calling <TT>seededRegionGrowing()</TT> (for example by
-    means of \ref inspectTwoImagesIf()).
-
-    For each candidate
-    <TT>x</TT> that is adjacent to region <TT>i</TT>, the algorithm will call
-    <TT>stats[i].cost(as(x))</TT> to get the cost (where <TT>x</TT> is a <TT>SrcIterator</TT>
-    and <TT>as</TT> is
-    the SrcAccessor). When a candidate has been merged with a region, the
-    statistics are updated by calling <TT>stats[i].operator()(as(x))</TT>. Since
-    the <TT>RegionStatisticsArray</TT> is passed by reference, this will overwrite
-    the original statistics.
-
-    If a candidate could be merged into more than one regions with identical
-    cost, the algorithm will favour the nearest region. If <tt>StopAtThreshold</tt> is active, 
-    and the cost of the current candidate at any point in the algorithm exceeds the optional 
-    <tt>max_cost</tt> value (which defaults to <tt>NumericTraits<double>::max()</tt>), 
-    region growing is aborted, and all voxels not yet assigned to a region remain unlabeled.
-
-    In some cases, the cost only depends on the feature value of the current
-    pixel. Then the update operation will simply be a no-op, and the <TT>cost()</TT>
-    function returns its argument. This behavior is implemented by the
-    \ref SeedRgDirectValueFunctor. With <tt>SRGType == KeepContours</tt>,
-    this is equivalent to the watershed algorithm.
-
-    <b> Declarations:</b>
-
-    pass arguments explicitly:
-    \code
-    namespace vigra {
-        template <class SrcIterator, class SrcAccessor,
-                  class SeedImageIterator, class SeedAccessor,
-                  class DestIterator, class DestAccessor,
-                  class RegionStatisticsArray, class Neighborhood>
-        typename SeedAccessor::value_type 
-        seededRegionGrowing(SrcIterator srcul, SrcIterator srclr, SrcAccessor as,
-                            SeedImageIterator seedsul, SeedAccessor aseeds,
-                            DestIterator destul, DestAccessor ad,
-                            RegionStatisticsArray & stats,
-                            SRGType srgType = CompleteGrow,
-                            Neighborhood neighborhood = FourNeighborCode(),
-                            double max_cost = NumericTraits<double>::max());
-    }
-    \endcode
-
-    use argument objects in conjunction with \ref ArgumentObjectFactories :
-    \code
-    namespace vigra {
-        template <class SrcIterator, class SrcAccessor,
-                  class SeedImageIterator, class SeedAccessor,
-                  class DestIterator, class DestAccessor,
-                  class RegionStatisticsArray, class Neighborhood>
-        typename SeedAccessor::value_type
-        seededRegionGrowing(triple<SrcIterator, SrcIterator, SrcAccessor> src,
-                            pair<SeedImageIterator, SeedAccessor> seeds,
-                            pair<DestIterator, DestAccessor> dest,
-                            RegionStatisticsArray & stats,
-                            SRGType srgType = CompleteGrow,
-                            Neighborhood neighborhood = FourNeighborCode(),
-                            double max_cost = NumericTraits<double>::max());
-    }
-    \endcode
-
-    <b> Usage:</b>
-
-    <b>\#include</b> \<vigra/seededregiongrowing.hxx\><br>
-    Namespace: vigra
-
-    Example: implementation of the voronoi tesselation
-
-    \code
-    vigra::BImage points(w,h);
-    vigra::FImage dist(x,y);
-
-    // empty edge image
-    points = 0;
-    dist = 0;
-
-    int max_region_label = 100;
-
-    // throw in some random points:
-    for(int i = 1; i <= max_region_label; ++i)
-           points(w * rand() / RAND_MAX , h * rand() / RAND_MAX) = i;
-
-    // calculate Euclidean distance transform
-    vigra::distanceTransform(srcImageRange(points), destImage(dist), 2);
-
-    // init statistics functor
-    vigra::ArrayOfRegionStatistics<vigra::SeedRgDirectValueFunctor<float> >
-                                              stats(max_region_label);
-
-    // find voronoi region of each point
-    vigra:: seededRegionGrowing(srcImageRange(dist), srcImage(points),
-                               destImage(points), stats);
-    \endcode
-
-    <b> Required Interface:</b>
-
-    \code
-    SrcIterator src_upperleft, src_lowerright;
-    SeedImageIterator seed_upperleft;
-    DestIterator dest_upperleft;
-
-    SrcAccessor src_accessor;
-    SeedAccessor seed_accessor;
-    DestAccessor dest_accessor;
-
-    RegionStatisticsArray stats;
-
-    // calculate costs
-    RegionStatisticsArray::value_type::cost_type cost =
-        stats[seed_accessor(seed_upperleft)].cost(src_accessor(src_upperleft));
-
-    // compare costs
-    cost < cost;
-
-    // update statistics
-    stats[seed_accessor(seed_upperleft)](src_accessor(src_upperleft));
-
-    // set result
-    dest_accessor.set(seed_accessor(seed_upperleft), dest_upperleft);
-    \endcode
-
-    Further requirements are determined by the <TT>RegionStatisticsArray</TT>.
-*/
-doxygen_overloaded_function(template <...> void seededRegionGrowing)
+namespace detail {
 
+    // generic variant: candidates are kept in a heap ordered by
+    // (cost, distance to seed, insertion order)
 template <class SrcIterator, class SrcAccessor,
           class SeedImageIterator, class SeedAccessor,
           class DestIterator, class DestAccessor,
           class RegionStatisticsArray, class Neighborhood>
 typename SeedAccessor::value_type
-seededRegionGrowing(SrcIterator srcul,
-                    SrcIterator srclr, SrcAccessor as,
-                    SeedImageIterator seedsul, SeedAccessor aseeds,
-                    DestIterator destul, DestAccessor ad,
-                    RegionStatisticsArray & stats,
-                    SRGType srgType,
-                    Neighborhood,
-                    double max_cost)
+seededRegionGrowingImpl(SrcIterator srcul,
+                        SrcIterator srclr, SrcAccessor as,
+                        SeedImageIterator seedsul, SeedAccessor aseeds,
+                        DestIterator destul, DestAccessor ad,
+                        RegionStatisticsArray & stats,
+                        SRGType srgType,
+                        Neighborhood,
+                        double max_cost,
+                        VigraFalseType /* useBucketQueue */)
 {
     int w = srclr.x - srcul.x;
     int h = srclr.y - srcul.y;
@@ -413,10 +286,10 @@ seededRegionGrowing(SrcIterator srcul,
 
     SeedRgPixelHeap pheap;
     int cneighbor, maxRegionLabel = 0;
-    
+
     typedef typename Neighborhood::Direction Direction;
     int directionCount = Neighborhood::DirectionCount;
-    
+
     Point2D pos(0,0);
     for(isy=srcul, iry=ir, pos.y=0; pos.y<h;
         ++pos.y, ++isy.y, ++iry.y)
@@ -450,7 +323,7 @@ seededRegionGrowing(SrcIterator srcul,
             }
         }
     }
-    
+
     // perform region growing
     while(pheap.size() != 0)
     {
@@ -508,7 +381,7 @@ seededRegionGrowing(SrcIterator srcul,
             }
         }
     }
-    
+
     // free temporary memory
     while(pheap.size() != 0)
     {
@@ -523,24 +396,386 @@ seededRegionGrowing(SrcIterator srcul,
     return (LabelType)maxRegionLabel;
 }
 
+    // variant for quantized costs: every cost value is a valid bucket
+    // index, so the heap is replaced by a bucket queue with O(1) push
+    // and pop; candidates with equal cost are processed in FIFO order
+    // instead of the heap's distance-to-seed ordering
 template <class SrcIterator, class SrcAccessor,
           class SeedImageIterator, class SeedAccessor,
           class DestIterator, class DestAccessor,
           class RegionStatisticsArray, class Neighborhood>
-inline typename SeedAccessor::value_type
-seededRegionGrowing(SrcIterator srcul,
-                    SrcIterator srclr, SrcAccessor as,
-                    SeedImageIterator seedsul, SeedAccessor aseeds,
-                    DestIterator destul, DestAccessor ad,
-                    RegionStatisticsArray & stats,
-                    SRGType srgType,
-                    Neighborhood n)
+typename SeedAccessor::value_type
+seededRegionGrowingImpl(SrcIterator srcul,
+                        SrcIterator srclr, SrcAccessor as,
+                        SeedImageIterator seedsul, SeedAccessor aseeds,
+                        DestIterator destul, DestAccessor ad,
+                        RegionStatisticsArray & stats,
+                        SRGType srgType,
+                        Neighborhood,
+                        double max_cost,
+                        VigraTrueType /* useBucketQueue */)
 {
-    return seededRegionGrowing(srcul, srclr, as,
-                                seedsul, aseeds,
-                                destul, ad,
-                                stats, srgType, n, NumericTraits<double>::max());
-}
+    int w = srclr.x - srcul.x;
+    int h = srclr.y - srcul.y;
+
+    SrcIterator isy = srcul, isx = srcul;  // iterators for the src image
+
+    typedef typename SeedAccessor::value_type LabelType;
+    typedef typename RegionStatisticsArray::value_type RegionStatistics;
+    typedef typename RegionStatistics::cost_type CostType;
+
+    // copy seed image in an image with border
+    IImage regions(w+2, h+2);
+    IImage::Iterator ir = regions.upperLeft() + Diff2D(1,1);
+    IImage::Iterator iry, irx;
+
+    initImageBorder(destImageRange(regions), 1, SRGWatershedLabel);
+    copyImage(seedsul, seedsul+Diff2D(w,h), aseeds, ir, regions.accessor());
+
+    // one bucket per representable cost value, and one preallocated
+    // queue slot per pixel, so that growing performs no memory
+    // allocations in the typical case
+    std::size_t bucket_count = (std::size_t)NumericTraits<CostType>::max() + 1;
+    PooledBucketQueue<detail::SeedRgBucketEntry, true> pqueue(bucket_count, (std::size_t)w*h);
+
+    int cneighbor, maxRegionLabel = 0;
+
+    typedef typename Neighborhood::Direction Direction;
+    int directionCount = Neighborhood::DirectionCount;
+
+    Point2D pos(0,0);
+    for(isy=srcul, iry=ir, pos.y=0; pos.y<h;
+        ++pos.y, ++isy.y, ++iry.y)
+    {
+        for(isx=isy, irx=iry, pos.x=0; pos.x<w;
+            ++pos.x, ++isx.x, ++irx.x)
+        {
+            if(*irx == 0)
+            {
+                // find candidate pixels for growing and fill the queue
+                for(int i=0; i<directionCount; i++)
+                {
+                    cneighbor = irx[Neighborhood::diff((Direction)i)];
+                    if(cneighbor > 0)
+                    {
+                        CostType cost = stats[cneighbor].cost(as(isx));
+
+                        pqueue.push(detail::SeedRgBucketEntry(pos, cneighbor), cost);
+                    }
+                }
+            }
+            else
+            {
+                vigra_precondition((LabelType)*irx <= stats.maxRegionLabel(),
+                    "seededRegionGrowing(): Largest label exceeds size of RegionStatisticsArray.");
+                if(maxRegionLabel < *irx)
+                    maxRegionLabel = *irx;
+            }
+        }
+    }
+
+    // perform region growing
+    while(!pqueue.empty())
+    {
+        CostType cost = (CostType)pqueue.topPriority();
+        Point2D pos = pqueue.top().location_;
+        int lab = pqueue.top().label_;
+        pqueue.pop();
+
+        if((srgType & StopAtThreshold) != 0 && cost > max_cost)
+            break;
+
+        irx = ir + pos;
+        isx = srcul + pos;
+
+        if(*irx) // already labelled region / watershed?
+            continue;
+
+        if((srgType & KeepContours) != 0)
+        {
+            for(int i=0; i<directionCount; i++)
+            {
+                cneighbor = irx[Neighborhood::diff((Direction)i)];
+                if((cneighbor>0) && (cneighbor != lab))
+                {
+                    lab = SRGWatershedLabel;
+                    break;
+                }
+            }
+        }
+
+        *irx = lab;
+
+        if((srgType & KeepContours) == 0 || lab > 0)
+        {
+            // update statistics
+            stats[*irx](as(isx));
+
+            // search neighborhood
+            // second pass: find new candidate pixels
+            for(int i=0; i<directionCount; i++)
+            {
+                if(irx[Neighborhood::diff((Direction)i)] == 0)
+                {
+                    CostType cost = stats[lab].cost(as(isx, Neighborhood::diff((Direction)i)));
+
+                    pqueue.push(detail::SeedRgBucketEntry(pos+Neighborhood::diff((Direction)i), lab), cost);
+                }
+            }
+        }
+    }
+
+    // write result
+    transformImage(ir, ir+Point2D(w,h), regions.accessor(), destul, ad,
+                   detail::UnlabelWatersheds());
+
+    return (LabelType)maxRegionLabel;
+}
+
+} // namespace detail
+
+/** \brief Region Segmentation by means of Seeded Region Growing.
+
+    This algorithm implements seeded region growing as described in
+
+    R. Adams, L. Bischof: "<em> Seeded Region Growing</em>", IEEE Trans. on Pattern
+    Analysis and Maschine Intelligence, vol 16, no 6, 1994, and
+
+    Ullrich K&ouml;the:
+    <em><a href="http://hci.iwr.uni-heidelberg.de/people/ukoethe/papers/index.php#cite_primary_segmentation">Primary Image Segmentation</a></em>,
+    in: G. Sagerer, S.
+    Posch, F. Kummert (eds.): Mustererkennung 1995, Proc. 17. DAGM-Symposium,
+    Springer 1995
+
+    The seed image is a partly segmented image which contains uniquely
+    labeled regions (the seeds) and unlabeled pixels (the candidates, label 0).
+    The highest seed label found in the seed image is returned by the algorithm.
+    
+    Seed regions can be as large as you wish and as small as one pixel. If
+    there are no candidates, the algorithm will simply copy the seed image
+    into the output image. Otherwise it will aggregate the candidates into
+    the existing regions so that a cost function is minimized. 
+    Candidates are taken from the neighborhood of the already assigned pixels, 
+    where the type of neighborhood is determined by parameter <tt>neighborhood</tt>
+    which can take the values <tt>FourNeighborCode()</tt> (the default) 
+    or <tt>EightNeighborCode()</tt>. The algorithm basically works as follows 
+    (illustrated for 4-neighborhood, but 8-neighborhood works in the same way):
+
+    <ol>
+
+    <li> Find all candidate pixels that are 4-adjacent to a seed region.
+    Calculate the cost for aggregating each candidate into its adjacent region
+    and put the candidates into a priority queue.
+
+    <li> While( priority queue is not empty and termination criterion is not fulfilled)
+
+        <ol>
+
+        <li> Take the candidate with least cost from the queue. If it has not
+        already been merged, merge it with it's adjacent region.
+
+        <li> Put all candidates that are 4-adjacent to the pixel just processed
+        into the priority queue.
+
+        </ol>
+
+    </ol>
+
+    <tt>SRGType</tt> can take the following values:
+    
+    <DL>
+    <DT><tt>CompleteGrow</tt> <DD> produce a complete tesselation of the volume (default).
+    <DT><tt>KeepContours</tt> <DD> keep a 1-voxel wide unlabeled contour between all regions.
+    <DT><tt>StopAtThreshold</tt> <DD> stop when the boundary indicator values exceed the 
+                             threshold given by parameter <tt>max_cost</tt>.
+    <DT><tt>KeepContours | StopAtThreshold</tt> <DD> keep 1-voxel wide contour and stop at given <tt>max_cost</tt>.
+    </DL>
+
+    The cost is determined jointly by the source image and the
+    region statistics functor. The source image contains feature values for each
+    pixel which will be used by the region statistics functor to calculate and
+    update statistics for each region and to calculate the cost for each
+    candidate. The <TT>RegionStatisticsArray</TT> must be compatible to the
+    \ref ArrayOfRegionStatistics functor and contains an <em> array</em> of
+    statistics objects for each region. The indices must correspond to the
+    labels of the seed regions. The statistics for the initial regions must have
+    been calculated prior to calling <TT>seededRegionGrowing()</TT> (for example by
+    means of \ref inspectTwoImagesIf()).
+
+    For each candidate
+    <TT>x</TT> that is adjacent to region <TT>i</TT>, the algorithm will call
+    <TT>stats[i].cost(as(x))</TT> to get the cost (where <TT>x</TT> is a <TT>SrcIterator</TT>
+    and <TT>as</TT> is
+    the SrcAccessor). When a candidate has been merged with a region, the
+    statistics are updated by calling <TT>stats[i].operator()(as(x))</TT>. Since
+    the <TT>RegionStatisticsArray</TT> is passed by reference, this will overwrite
+    the original statistics.
+
+    If a candidate could be merged into more than one regions with identical
+    cost, the algorithm will favour the nearest region. If <tt>StopAtThreshold</tt> is active,
+    and the cost of the current candidate at any point in the algorithm exceeds the optional
+    <tt>max_cost</tt> value (which defaults to <tt>NumericTraits<double>::max()</tt>),
+    region growing is aborted, and all voxels not yet assigned to a region remain unlabeled.
+
+    When the statistics functor declares an 8-bit or 16-bit unsigned integer
+    <tt>cost_type</tt> (for example <tt>SeedRgDirectValueFunctor<UInt8></tt>),
+    every cost value is a valid bucket index, and the candidate queue is
+    automatically implemented as a \ref vigra::PooledBucketQueue instead of a
+    heap, reducing push and pop to constant time. Candidates with identical
+    cost are then merged in FIFO order rather than into the nearest region,
+    so tie-breaking may differ from the floating-point version.
+
+    In some cases, the cost only depends on the feature value of the current
+    pixel. Then the update operation will simply be a no-op, and the <TT>cost()</TT>
+    function returns its argument. This behavior is implemented by the
+    \ref SeedRgDirectValueFunctor. With <tt>SRGType == KeepContours</tt>,
+    this is equivalent to the watershed algorithm.
+
+    <b> Declarations:</b>
+
+    pass arguments explicitly:
+    \code
+    namespace vigra {
+        template <class SrcIterator, class SrcAccessor,
+                  class SeedImageIterator, class SeedAccessor,
+                  class DestIterator, class DestAccessor,
+                  class RegionStatisticsArray, class Neighborhood>
+        typename SeedAccessor::value_type 
+        seededRegionGrowing(SrcIterator srcul, SrcIterator srclr, SrcAccessor as,
+                            SeedImageIterator seedsul, SeedAccessor aseeds,
+                            DestIterator destul, DestAccessor ad,
+                            RegionStatisticsArray & stats,
+                            SRGType srgType = CompleteGrow,
+                            Neighborhood neighborhood = FourNeighborCode(),
+                            double max_cost = NumericTraits<double>::max());
+    }
+    \endcode
+
+    use argument objects in conjunction with \ref ArgumentObjectFactories :
+    \code
+    namespace vigra {
+        template <class SrcIterator, class SrcAccessor,
+                  class SeedImageIterator, class SeedAccessor,
+                  class DestIterator, class DestAccessor,
+                  class RegionStatisticsArray, class Neighborhood>
+        typename SeedAccessor::value_type
+        seededRegionGrowing(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                            pair<SeedImageIterator, SeedAccessor> seeds,
+                            pair<DestIterator, DestAccessor> dest,
+                            RegionStatisticsArray & stats,
+                            SRGType srgType = CompleteGrow,
+                            Neighborhood neighborhood = FourNeighborCode(),
+                            double max_cost = NumericTraits<double>::max());
+    }
+    \endcode
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/seededregiongrowing.hxx\><br>
+    Namespace: vigra
+
+    Example: implementation of the voronoi tesselation
+
+    \code
+    vigra::BImage points(w,h);
+    vigra::FImage dist(x,y);
+
+    // empty edge image
+    points = 0;
+    dist = 0;
+
+    int max_region_label = 100;
+
+    // throw in some random points:
+    for(int i = 1; i <= max_region_label; ++i)
+           points(w * rand() / RAND_MAX , h * rand() / RAND_MAX) = i;
+
+    // calculate Euclidean distance transform
+    vigra::distanceTransform(srcImageRange(points), destImage(dist), 2);
+
+    // init statistics functor
+    vigra::ArrayOfRegionStatistics<vigra::SeedRgDirectValueFunctor<float> >
+                                              stats(max_region_label);
+
+    // find voronoi region of each point
+    vigra:: seededRegionGrowing(srcImageRange(dist), srcImage(points),
+                               destImage(points), stats);
+    \endcode
+
+    <b> Required Interface:</b>
+
+    \code
+    SrcIterator src_upperleft, src_lowerright;
+    SeedImageIterator seed_upperleft;
+    DestIterator dest_upperleft;
+
+    SrcAccessor src_accessor;
+    SeedAccessor seed_accessor;
+    DestAccessor dest_accessor;
+
+    RegionStatisticsArray stats;
+
+    // calculate costs
+    RegionStatisticsArray::value_type::cost_type cost =
+        stats[seed_accessor(seed_upperleft)].cost(src_accessor(src_upperleft));
+
+    // compare costs
+    cost < cost;
+
+    // update statistics
+    stats[seed_accessor(seed_upperleft)](src_accessor(src_upperleft));
+
+    // set result
+    dest_accessor.set(seed_accessor(seed_upperleft), dest_upperleft);
+    \endcode
+
+    Further requirements are determined by the <TT>RegionStatisticsArray</TT>.
+*/
+doxygen_overloaded_function(template <...> void seededRegionGrowing)
+
+template <class SrcIterator, class SrcAccessor,
+          class SeedImageIterator, class SeedAccessor,
+          class DestIterator, class DestAccessor,
+          class RegionStatisticsArray, class Neighborhood>
+inline typename SeedAccessor::value_type
+seededRegionGrowing(SrcIterator srcul,
+                    SrcIterator srclr, SrcAccessor as,
+                    SeedImageIterator seedsul, SeedAccessor aseeds,
+                    DestIterator destul, DestAccessor ad,
+                    RegionStatisticsArray & stats,
+                    SRGType srgType,
+                    Neighborhood n,
+                    double max_cost)
+{
+    typedef typename RegionStatisticsArray::value_type RegionStatistics;
+    typedef typename RegionStatistics::cost_type CostType;
+
+    // 8-bit and 16-bit unsigned costs select the bucket queue variant
+    typename detail::SeedRgUseBucketQueue<CostType>::type useBucketQueue;
+
+    return detail::seededRegionGrowingImpl(srcul, srclr, as, seedsul, aseeds,
+                                           destul, ad, stats, srgType, n,
+                                           max_cost, useBucketQueue);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class SeedImageIterator, class SeedAccessor,
+          class DestIterator, class DestAccessor,
+          class RegionStatisticsArray, class Neighborhood>
+inline typename SeedAccessor::value_type
+seededRegionGrowing(SrcIterator srcul,
+                    SrcIterator srclr, SrcAccessor as,
+                    SeedImageIterator seedsul, SeedAccessor aseeds,
+                    DestIterator destul, DestAccessor ad,
+                    RegionStatisticsArray & stats,
+                    SRGType srgType,
+                    Neighborhood n)
+{
+    return seededRegionGrowing(srcul, srclr, as,
+                                seedsul, aseeds,
+                                destul, ad,
+                                stats, srgType, n, NumericTraits<double>::max());
+}
 
 
 
@@ -649,10 +884,326 @@ seededRegionGrowing(triple<SrcIterator, SrcIterator, SrcAccessor> img1,
                             stats, CompleteGrow);
 }
 
+namespace detail {
+
+// Grow one horizontal strip [y0, y1) of the bordered region image with a
+// strip-local priority queue. Candidates entering the strip are taken from
+// 'inbox'; candidates leaving the strip across its upper or lower boundary
+// are recorded in 'outbox_up' and 'outbox_down' for the neighboring strips.
+// The strip only writes pixels in its own rows, so all strips can run
+// concurrently without synchronization.
+template <class SrcIterator, class SrcAccessor,
+          class RegionStatisticsArray, class Neighborhood, class COST>
+void seededRegionGrowingStrip(SrcIterator srcul, SrcAccessor as,
+                              IImage::Iterator ir,
+                              int w, int h, int y0, int y1,
+                              RegionStatisticsArray & stats,
+                              SRGType srgType, double max_cost, Neighborhood,
+                              std::vector<SeedRgPixel<COST> > const & inbox,
+                              std::vector<SeedRgPixel<COST> > & outbox_up,
+                              std::vector<SeedRgPixel<COST> > & outbox_down)
+{
+    typedef SeedRgPixel<COST> Pixel;
+    typedef typename Neighborhood::Direction Direction;
+
+    typename Pixel::Allocator allocator;
+    std::priority_queue<Pixel *, std::vector<Pixel *>,
+                        typename Pixel::Compare>  pheap;
+
+    // re-number the candidates locally so that FIFO tie-breaking
+    // is independent of the producing strip
+    int count = 0;
+    for(unsigned int k=0; k<inbox.size(); ++k)
+        pheap.push(allocator.create(inbox[k].location_, inbox[k].nearest_,
+                                    inbox[k].cost_, count++, inbox[k].label_));
+
+    int directionCount = Neighborhood::DirectionCount;
+
+    while(pheap.size() != 0)
+    {
+        Pixel * pixel = pheap.top();
+        pheap.pop();
+
+        Point2D pos = pixel->location_;
+        Point2D nearest = pixel->nearest_;
+        int lab = pixel->label_;
+        COST cost = pixel->cost_;
+
+        allocator.dismiss(pixel);
+
+        if((srgType & StopAtThreshold) != 0 && cost > max_cost)
+            break;
+
+        IImage::Iterator irx = ir + pos;
+        SrcIterator isx = srcul + pos;
+
+        if(*irx) // already labelled?
+            continue;
+
+        *irx = lab;
+
+        // find new candidate pixels
+        for(int i=0; i<directionCount; i++)
+        {
+            Diff2D diff = Neighborhood::diff((Direction)i);
+            int ny = pos.y + diff.y;
+            if(ny >= y0 && ny < y1)
+            {
+                if(irx[diff] == 0)
+                {
+                    COST ncost = stats[lab].cost(as(isx, diff));
+                    pheap.push(allocator.create(pos+diff, nearest, ncost,
+                                                count++, lab));
+                }
+            }
+            else if(ny >= 0 && ny < h &&
+                    pos.x + diff.x >= 0 && pos.x + diff.x < w)
+            {
+                // candidate belongs to a neighboring strip -- hand it over
+                // unconditionally, the owner re-checks whether it is still
+                // unlabeled before growing
+                COST ncost = stats[lab].cost(as(isx, diff));
+                Pixel c;
+                c.set(pos+diff, nearest, ncost, 0, lab);
+                if(ny < y0)
+                    outbox_up.push_back(c);
+                else
+                    outbox_down.push_back(c);
+            }
+        }
+    }
+}
+
+} // namespace detail
+
+/** \brief Multi-threaded variant of \ref seededRegionGrowing().
+
+    The image is divided into one horizontal strip per thread, and every
+    thread grows the regions inside its strip with a local priority queue.
+    Whenever a region reaches a strip boundary, the candidates beyond the
+    boundary are handed over to the neighboring strip, and the growing
+    rounds are repeated until no candidates are left anywhere.
+
+    Because each strip orders its candidates locally, ties between
+    equal-cost candidates may be resolved differently than in the
+    sequential algorithm, so region boundaries on cost plateaus can be
+    placed differently. The result is nevertheless a valid region growing
+    and deterministic for a fixed thread count.
+
+    This function requires <em>static</em> region statistics whose
+    <tt>cost()</tt> does not depend on values accumulated during growth
+    (e.g. \ref SeedRgDirectValueFunctor): in contrast to the sequential
+    algorithm, the statistics objects are <em>not</em> updated while the
+    regions grow. <tt>KeepContours</tt> is not supported;
+    <tt>StopAtThreshold</tt> works as usual.
+
+    \code
+    vigra::FImage dist(w,h);
+    vigra::IImage labels(w,h);
+
+    vigra::ArrayOfRegionStatistics<vigra::SeedRgDirectValueFunctor<float> >
+                                              stats(max_region_label);
+
+    vigra::seededRegionGrowing(srcImageRange(dist), srcImage(labels),
+                               destImage(labels), stats, CompleteGrow,
+                               FourNeighborCode(),
+                               NumericTraits<double>::max(),
+                               ParallelOptions().numThreads(4));
+    \endcode
+
+    Without OpenMP support, or when one thread is requested, this simply
+    calls the sequential algorithm.
+*/
+template <class SrcIterator, class SrcAccessor,
+          class SeedImageIterator, class SeedAccessor,
+          class DestIterator, class DestAccessor,
+          class RegionStatisticsArray, class Neighborhood>
+typename SeedAccessor::value_type
+seededRegionGrowing(SrcIterator srcul,
+                    SrcIterator srclr, SrcAccessor as,
+                    SeedImageIterator seedsul, SeedAccessor aseeds,
+                    DestIterator destul, DestAccessor ad,
+                    RegionStatisticsArray & stats,
+                    SRGType srgType,
+                    Neighborhood neighborhood,
+                    double max_cost,
+                    ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    typedef typename SeedAccessor::value_type LabelType;
+    typedef typename RegionStatisticsArray::value_type RegionStatistics;
+    typedef typename RegionStatistics::cost_type CostType;
+    typedef detail::SeedRgPixel<CostType> Pixel;
+    typedef typename Neighborhood::Direction Direction;
+
+    int w = srclr.x - srcul.x;
+    int h = srclr.y - srcul.y;
+    int num_threads = options.getNumThreads();
+    if(num_threads > h)
+        num_threads = h;
+    if(num_threads > 1 && w > 0)
+    {
+        vigra_precondition((srgType & KeepContours) == 0,
+            "seededRegionGrowing(): 'KeepContours' is not supported by the parallel version.");
+
+        // copy seed image in an image with border
+        IImage regions(w+2, h+2);
+        IImage::Iterator ir = regions.upperLeft() + Diff2D(1,1);
+        IImage::Iterator iry, irx;
+
+        initImageBorder(destImageRange(regions), 1, SRGWatershedLabel);
+        copyImage(seedsul, seedsul+Diff2D(w,h), aseeds, ir, regions.accessor());
+
+        ArrayVector<int> bounds((unsigned int)num_threads + 1);
+        for(int t = 0; t <= num_threads; ++t)
+            bounds[t] = (int)(((long long)h * t) / num_threads);
+
+        ArrayVector<std::vector<Pixel> > inbox((unsigned int)num_threads),
+                                         outbox_up((unsigned int)num_threads),
+                                         outbox_down((unsigned int)num_threads);
+
+        // find the initial candidates and assign them to their strips
+        int cneighbor, maxRegionLabel = 0;
+        int directionCount = Neighborhood::DirectionCount;
+        {
+            int t = 0;
+            SrcIterator isy = srcul, isx;
+            Point2D pos(0,0);
+            for(iry=ir, pos.y=0; pos.y<h; ++pos.y, ++isy.y, ++iry.y)
+            {
+                while(pos.y >= bounds[t+1])
+                    ++t;
+                for(isx=isy, irx=iry, pos.x=0; pos.x<w; ++pos.x, ++isx.x, ++irx.x)
+                {
+                    if(*irx == 0)
+                    {
+                        for(int i=0; i<directionCount; i++)
+                        {
+                            cneighbor = irx[Neighborhood::diff((Direction)i)];
+                            if(cneighbor > 0)
+                            {
+                                CostType cost = stats[cneighbor].cost(as(isx));
+
+                                Pixel c;
+                                c.set(pos, pos+Neighborhood::diff((Direction)i),
+                                      cost, 0, cneighbor);
+                                inbox[t].push_back(c);
+                            }
+                        }
+                    }
+                    else
+                    {
+                        vigra_precondition((LabelType)*irx <= stats.maxRegionLabel(),
+                            "seededRegionGrowing(): Largest label exceeds size of RegionStatisticsArray.");
+                        if(maxRegionLabel < *irx)
+                            maxRegionLabel = *irx;
+                    }
+                }
+            }
+        }
+
+        // alternate between parallel growing rounds and candidate exchange
+        // until all strips have run out of work
+        for(;;)
+        {
+            bool have_work = false;
+            for(int t = 0; t < num_threads; ++t)
+                if(!inbox[t].empty())
+                    have_work = true;
+            if(!have_work)
+                break;
+
+            std::string errorMessage;
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+            for(int t = 0; t < num_threads; ++t)
+            {
+                try
+                {
+                    detail::seededRegionGrowingStrip(srcul, as, ir, w, h,
+                                        bounds[t], bounds[t+1], stats,
+                                        srgType, max_cost, neighborhood,
+                                        inbox[t], outbox_up[t], outbox_down[t]);
+                }
+                catch(std::exception & e)
+                {
+#pragma omp critical(vigra_seeded_region_growing_error)
+                    errorMessage = e.what();
+                }
+            }
+            if(!errorMessage.empty())
+                vigra_fail("seededRegionGrowing(): worker thread failed with:\n" + errorMessage);
+
+            for(int t = 0; t < num_threads; ++t)
+                inbox[t].clear();
+            for(int t = 0; t < num_threads; ++t)
+            {
+                if(t > 0)
+                    inbox[t-1].insert(inbox[t-1].end(),
+                                      outbox_up[t].begin(), outbox_up[t].end());
+                if(t < num_threads-1)
+                    inbox[t+1].insert(inbox[t+1].end(),
+                                      outbox_down[t].begin(), outbox_down[t].end());
+                outbox_up[t].clear();
+                outbox_down[t].clear();
+            }
+        }
+
+        // write result
+        transformImage(ir, ir+Point2D(w,h), regions.accessor(), destul, ad,
+                       detail::UnlabelWatersheds());
+
+        return (LabelType)maxRegionLabel;
+    }
+#endif // _OPENMP
+
+    return seededRegionGrowing(srcul, srclr, as, seedsul, aseeds, destul, ad,
+                               stats, srgType, neighborhood, max_cost);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class SeedImageIterator, class SeedAccessor,
+          class DestIterator, class DestAccessor,
+          class RegionStatisticsArray, class Neighborhood>
+inline typename SeedAccessor::value_type
+seededRegionGrowing(triple<SrcIterator, SrcIterator, SrcAccessor> img1,
+                    pair<SeedImageIterator, SeedAccessor> img3,
+                    pair<DestIterator, DestAccessor> img4,
+                    RegionStatisticsArray & stats,
+                    SRGType srgType,
+                    Neighborhood n,
+                    double max_cost,
+                    ParallelOptions const & options)
+{
+    return seededRegionGrowing(img1.first, img1.second, img1.third,
+                                img3.first, img3.second,
+                                img4.first, img4.second,
+                                stats, srgType, n, max_cost, options);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class SeedImageIterator, class SeedAccessor,
+          class DestIterator, class DestAccessor,
+          class RegionStatisticsArray, class Neighborhood>
+inline typename SeedAccessor::value_type
+seededRegionGrowing(triple<SrcIterator, SrcIterator, SrcAccessor> img1,
+                    pair<SeedImageIterator, SeedAccessor> img3,
+                    pair<DestIterator, DestAccessor> img4,
+                    RegionStatisticsArray & stats,
+                    SRGType srgType,
+                    Neighborhood n,
+                    ParallelOptions const & options)
+{
+    return seededRegionGrowing(img1.first, img1.second, img1.third,
+                                img3.first, img3.second,
+                                img4.first, img4.second,
+                                stats, srgType, n,
+                                NumericTraits<double>::max(), options);
+}
+
 template <class SrcIterator, class SrcAccessor,
           class DestIterator, class DestAccessor,
           class RegionStatisticsArray, class Neighborhood>
-typename DestAccessor::value_type 
+typename DestAccessor::value_type
 fastSeededRegionGrowing(SrcIterator srcul, SrcIterator srclr, SrcAccessor as,
                         DestIterator destul, DestAccessor ad,
                         RegionStatisticsArray & stats,
@@ -672,7 +1223,9 @@ fastSeededRegionGrowing(SrcIterator srcul, SrcIterator srclr, SrcAccessor as,
     SrcIterator isy = srcul, isx = srcul;  // iterators for the src image
     DestIterator idy = destul, idx = destul;  // iterators for the dest image
 
-    BucketQueue<Point2D, true> pqueue(bucket_count);
+    // preallocate one arena slot per pixel, so that flooding
+    // performs no memory allocations
+    PooledBucketQueue<Point2D, true> pqueue(bucket_count, (std::size_t)w*h);
     LabelType maxRegionLabel = 0;
     
     Point2D pos(0,0);
@@ -41,6 +41,8 @@
 #include <stack>
 #include <queue>
 #include "utilities.hxx"
+#include "tinyvector.hxx"
+#include "sized_int.hxx"
 #include "stdimage.hxx"
 #include "stdimagefunctions.hxx"
 #include "seededregiongrowing.hxx"
@@ -55,38 +57,34 @@ template <class COST, class Diff_type>
 class SeedRgVoxel
 {
 public:
-    Diff_type location_, nearest_;
+    // store the coordinates as 32-bit integers (volume dimensions are
+    // ints anyway): the queue entries dominate the peak memory of
+    // seededRegionGrowing3D(), and this halves their footprint compared
+    // to a 64-bit Diff_type
+    typedef TinyVector<Int32, 3> CompactShape;
+
+    CompactShape location_, nearest_;
     COST cost_;
     int count_;
     int label_;
     int dist_;
 
     SeedRgVoxel()
-    //: location_(0,0,0), nearest_(0,0,0), cost_(0), count_(0), label_(0)
-    {
-        location_ = Diff_type(0,0,0);
-        nearest_ = Diff_type(0,0,0);
-        cost_ = 0;
-        count_ = 0;
-        label_ = 0;
-    }
+    : location_(0,0,0), nearest_(0,0,0),
+      cost_(0), count_(0), label_(0), dist_(0)
+    {}
 
     SeedRgVoxel(Diff_type const & location, Diff_type const & nearest,
                 COST const & cost, int const & count, int const & label)
-    : location_(location), nearest_(nearest),
-      cost_(cost), count_(count), label_(label)
     {
-        int dx = location_[0] - nearest_[0];
-        int dy = location_[1] - nearest_[1];
-        int dz = location_[2] - nearest_[2];
-        dist_ = dx * dx + dy * dy + dz * dz;
+        set(location, nearest, cost, count, label);
     }
 
     void set(Diff_type const & location, Diff_type const & nearest,
              COST const & cost, int const & count, int const & label)
     {
-        location_ = location;
-        nearest_ = nearest;
+        location_ = CompactShape(location);
+        nearest_ = CompactShape(nearest);
         cost_ = cost;
         count_ = count;
         label_ = label;
@@ -126,29 +124,43 @@ public:
         }
     };
 
+    // Arena-style allocator: voxels live in chunks that are freed en bloc
+    // by the destructor, so the flooding loop performs no per-voxel heap
+    // allocation, and recycled entries come from the freelist.
     struct Allocator
     {
+        enum { chunk_size = 1024 };
+
+        Allocator()
+        : chunk_fill_(chunk_size)
+        {}
+
         ~Allocator()
         {
-            while(!freelist_.empty())
-            {
-                delete freelist_.top();
-                freelist_.pop();
-            }
+            for(unsigned int i=0; i<chunks_.size(); ++i)
+                delete[] chunks_[i];
         }
 
         SeedRgVoxel * create(Diff_type const & location, Diff_type const & nearest,
                              COST const & cost, int const & count, int const & label)
         {
+            SeedRgVoxel * res;
             if(!freelist_.empty())
             {
-                SeedRgVoxel * res = freelist_.top();
+                res = freelist_.top();
                 freelist_.pop();
-                res->set(location, nearest, cost, count, label);
-                return res;
             }
-
-            return new SeedRgVoxel(location, nearest, cost, count, label);
+            else
+            {
+                if(chunk_fill_ == (int)chunk_size)
+                {
+                    chunks_.push_back(new SeedRgVoxel[chunk_size]);
+                    chunk_fill_ = 0;
+                }
+                res = chunks_.back() + chunk_fill_++;
+            }
+            res->set(location, nearest, cost, count, label);
+            return res;
         }
 
         void dismiss(SeedRgVoxel * p)
@@ -157,6 +169,8 @@ public:
         }
 
         std::stack<SeedRgVoxel<COST,Diff_type> *> freelist_;
+        std::vector<SeedRgVoxel<COST,Diff_type> *> chunks_;
+        int chunk_fill_;
     };
 };
 
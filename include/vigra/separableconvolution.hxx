@@ -38,12 +38,21 @@
 #define VIGRA_SEPARABLECONVOLUTION_HXX
 
 #include <cmath>
+#include <map>
 #include "utilities.hxx"
 #include "numerictraits.hxx"
 #include "imageiteratoradapter.hxx"
 #include "bordertreatment.hxx"
 #include "gaussians.hxx"
 #include "array_vector.hxx"
+#include "accessor.hxx"
+#include "metaprogramming.hxx"
+#include "sized_int.hxx"
+#include "fixedpoint.hxx"
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
 
 namespace vigra {
 
@@ -209,6 +218,224 @@ copyLineWithBorderTreatment(SrcIterator is, SrcIterator iend, SrcAccessor sa,
 
 } // namespace detail
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor,
+          class KernelIterator, class KernelAccessor>
+void convolveLine(SrcIterator is, SrcIterator iend, SrcAccessor sa,
+                  DestIterator id, DestAccessor da,
+                  KernelIterator ik, KernelAccessor ka,
+                  int kleft, int kright, BorderTreatmentMode border,
+                  int start = 0, int stop = 0);
+
+namespace detail {
+
+/********************************************************/
+/*                                                      */
+/*        vectorized fast path for convolveLine         */
+/*                                                      */
+/********************************************************/
+
+// The fast path applies when a line is stored contiguously (the iterators
+// are plain pointers) and the accessors just pass the values through. This
+// covers the most important users of convolveLine(): BasicImage rows
+// (separableConvolveX) and the temporary line buffers employed by
+// separableConvolveY and separableConvolveMultiArray().
+
+template <class Iterator, class Accessor>
+struct IsContiguousLine
+{
+    static const bool value = false;
+};
+
+#define VIGRA_CONTIGUOUS_LINE(ITERATOR, ACCESSOR) \
+template <class T> \
+struct IsContiguousLine<ITERATOR, ACCESSOR > \
+{ \
+    static const bool value = true; \
+};
+
+VIGRA_CONTIGUOUS_LINE(T *, StandardAccessor<T>)
+VIGRA_CONTIGUOUS_LINE(T *, StandardValueAccessor<T>)
+VIGRA_CONTIGUOUS_LINE(T *, StandardConstAccessor<T>)
+VIGRA_CONTIGUOUS_LINE(T *, StandardConstValueAccessor<T>)
+VIGRA_CONTIGUOUS_LINE(T const *, StandardConstAccessor<T>)
+VIGRA_CONTIGUOUS_LINE(T const *, StandardConstValueAccessor<T>)
+
+#undef VIGRA_CONTIGUOUS_LINE
+
+template <class T>
+struct IsVectorizableLineValue
+{
+    static const bool value = false;
+};
+
+template <>
+struct IsVectorizableLineValue<float>
+{
+    static const bool value = true;
+};
+
+template <>
+struct IsVectorizableLineValue<double>
+{
+    static const bool value = true;
+};
+
+// Inner product of a contiguous line with the (already reversed) kernel.
+// The loops are written such that the compiler can keep the taps in
+// registers and auto-vectorize; for float data, an explicit SSE2 version
+// computing four output pixels per iteration is provided.
+//
+// The kernel width is passed as template parameter KW as well: for the
+// common small filters it is instantiated with the width as a constant
+// (see the dispatch in convolveLineContiguous() below), so that the
+// compiler fully unrolls the tap loop and keeps the taps in registers.
+// KW == 0 selects the runtime-sized loop.
+template <int KW>
+inline void
+convolveLineContiguousImpl(float const * in, float * out, int n,
+                           float const * kernel, int runtimeKW)
+{
+    const int kw = KW ? KW : runtimeKW;
+    int x = 0;
+#if defined(__SSE2__)
+    for(; x <= n - 4; x += 4)
+    {
+        float const * pin = in + x;
+        __m128 sum = _mm_setzero_ps();
+        for(int j = 0; j < kw; ++j)
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(kernel[j]),
+                                             _mm_loadu_ps(pin + j)));
+        _mm_storeu_ps(out + x, sum);
+    }
+#endif
+    for(; x < n; ++x)
+    {
+        float const * pin = in + x;
+        float sum = 0.0f;
+        for(int j = 0; j < kw; ++j)
+            sum += kernel[j] * pin[j];
+        out[x] = sum;
+    }
+}
+
+template <int KW>
+inline void
+convolveLineContiguousImpl(double const * in, double * out, int n,
+                           double const * kernel, int runtimeKW)
+{
+    const int kw = KW ? KW : runtimeKW;
+#if defined(__SSE2__)
+    int x = 0;
+    for(; x <= n - 2; x += 2)
+    {
+        double const * pin = in + x;
+        __m128d sum = _mm_setzero_pd();
+        for(int j = 0; j < kw; ++j)
+            sum = _mm_add_pd(sum, _mm_mul_pd(_mm_set1_pd(kernel[j]),
+                                             _mm_loadu_pd(pin + j)));
+        _mm_storeu_pd(out + x, sum);
+    }
+#else
+    int x = 0;
+#endif
+    for(; x < n; ++x)
+    {
+        double const * pin = in + x;
+        double sum = 0.0;
+        for(int j = 0; j < kw; ++j)
+            sum += kernel[j] * pin[j];
+        out[x] = sum;
+    }
+}
+
+// dispatch the common 3-, 5-, and 7-tap filters to fully unrolled
+// instantiations
+template <class T>
+inline void
+convolveLineContiguous(T const * in, T * out, int n,
+                       T const * kernel, int kw)
+{
+    switch(kw)
+    {
+      case 3:
+        convolveLineContiguousImpl<3>(in, out, n, kernel, kw);
+        break;
+      case 5:
+        convolveLineContiguousImpl<5>(in, out, n, kernel, kw);
+        break;
+      case 7:
+        convolveLineContiguousImpl<7>(in, out, n, kernel, kw);
+        break;
+      default:
+        convolveLineContiguousImpl<0>(in, out, n, kernel, kw);
+    }
+}
+
+template <bool useFastPath>
+struct ConvolveLineFastDispatch
+{
+    template <class SrcIterator, class SrcAccessor,
+              class DestIterator, class DestAccessor,
+              class KernelIterator, class KernelAccessor>
+    static bool exec(SrcIterator, SrcIterator, SrcAccessor,
+                     DestIterator, DestAccessor,
+                     KernelIterator, KernelAccessor,
+                     int, int, BorderTreatmentMode)
+    {
+        return false;
+    }
+};
+
+template <>
+struct ConvolveLineFastDispatch<true>
+{
+    // Convolve the interior of the line (where the kernel fits entirely)
+    // with the vectorized inner product and delegate the borders to the
+    // generic border-treatment code via convolveLine()'s subrange mode.
+    template <class SrcIterator, class SrcAccessor,
+              class DestIterator, class DestAccessor,
+              class KernelIterator, class KernelAccessor>
+    static bool exec(SrcIterator is, SrcIterator iend, SrcAccessor sa,
+                     DestIterator id, DestAccessor da,
+                     KernelIterator ik, KernelAccessor ka,
+                     int kleft, int kright, BorderTreatmentMode border)
+    {
+        typedef typename SrcAccessor::value_type ValueType;
+
+        int w = (int)(iend - is);
+        int interiorStart = kright,
+            interiorStop  = w + kleft;
+        if(interiorStop - interiorStart < 1)
+            return false; // kernel never fits entirely => generic code
+
+        int kw = kright - kleft + 1;
+        SmallVector<ValueType, 16> reversedKernel(kw);
+        for(int j = 0; j < kw; ++j)
+            reversedKernel[j] = ka(ik + (kright - j));
+
+        // the iterators are plain pointers here by construction
+        ValueType const * in = is;
+        ValueType * out = id;
+
+        convolveLineContiguous(in + interiorStart - kright, out + interiorStart,
+                               interiorStop - interiorStart,
+                               reversedKernel.begin(), kw);
+
+        if(border == BORDER_TREATMENT_AVOID)
+            return true; // borders remain unchanged
+        if(interiorStart > 0)
+            convolveLine(is, iend, sa, id, da, ik, ka, kleft, kright, border,
+                         0, interiorStart);
+        if(interiorStop < w)
+            convolveLine(is, iend, sa, id + interiorStop, da, ik, ka, kleft, kright, border,
+                         interiorStop, w);
+        return true;
+    }
+};
+
+} // namespace detail
+
 /********************************************************/
 /*                                                      */
 /*                internalConvolveLineWrap              */
@@ -898,29 +1125,44 @@ void convolveLine(SrcIterator is, SrcIterator iend, SrcAccessor sa,
                   DestIterator id, DestAccessor da,
                   KernelIterator ik, KernelAccessor ka,
                   int kleft, int kright, BorderTreatmentMode border,
-                  int start = 0, int stop = 0)
+                  int start, int stop)
 {
     typedef typename KernelAccessor::value_type KernelValue;
 
-    vigra_precondition(kleft <= 0,
+    // repeated once per line by separableConvolveX/Y(), which enforce the
+    // same conditions at their API boundary
+    vigra_inner_precondition(kleft <= 0,
                  "convolveLine(): kleft must be <= 0.\n");
-    vigra_precondition(kright >= 0,
+    vigra_inner_precondition(kright >= 0,
                  "convolveLine(): kright must be >= 0.\n");
 
     //    int w = iend - is;
     int w = std::distance( is, iend );
 
-    vigra_precondition(w >= std::max(kright, -kleft) + 1,
+    vigra_inner_precondition(w >= std::max(kright, -kleft) + 1,
                  "convolveLine(): kernel longer than line.\n");
                  
     if(stop != 0)
         vigra_precondition(0 <= start && start < stop && stop <= w,
                         "convolveLine(): invalid subrange (start, stop).\n");
 
-    typedef typename PromoteTraits<
-            typename SrcAccessor::value_type,
-            typename KernelAccessor::value_type>::Promote SumType;
-    ArrayVector<SumType> a(iend - is); 
+    // dispatch contiguous float/double lines with identity accessors to the
+    // vectorized kernel (subranges keep using the generic code directly)
+    const bool useFastPath =
+           detail::IsContiguousLine<SrcIterator, SrcAccessor>::value &&
+           detail::IsContiguousLine<DestIterator, DestAccessor>::value &&
+           detail::IsContiguousLine<KernelIterator, KernelAccessor>::value &&
+           detail::IsVectorizableLineValue<typename SrcAccessor::value_type>::value &&
+           IsSameType<typename SrcAccessor::value_type,
+                      typename DestAccessor::value_type>::value &&
+           IsSameType<typename SrcAccessor::value_type,
+                      typename KernelAccessor::value_type>::value;
+
+    if(start == 0 && stop == 0 &&
+       detail::ConvolveLineFastDispatch<useFastPath>::exec(is, iend, sa, id, da, ik, ka,
+                                                           kleft, kright, border))
+        return;
+
     switch(border)
     {
       case BORDER_TREATMENT_WRAP:
@@ -988,6 +1230,92 @@ void convolveLine(triple<SrcIterator, SrcIterator, SrcAccessor> src,
                  kernel.third, kernel.fourth, kernel.fifth, start, stop);
 }
 
+/** \brief Convolve a line via a reusable padded staging buffer.
+
+    This overload materializes the border treatment once per line: the
+    (sub)range to be convolved is copied together with its left and right
+    margins into <tt>staging</tt> (which is enlarged as needed, but never
+    shrunk), and the convolution then runs branch-free over the padded copy.
+    Since the buffer's capacity is retained between calls, passing the same
+    <tt>staging</tt> object while processing a batch of lines avoids both the
+    per-pixel border conditionals and repeated allocations -- worthwhile when
+    the lines are short (small ROIs) and border pixels dominate.
+
+    <tt>TmpType</tt> should be the promote type of the source and kernel values
+    (i.e. <tt>PromoteTraits<SrcAccessor::value_type, KernelAccessor::value_type>::Promote</tt>).
+    <tt>BORDER_TREATMENT_CLIP</tt> (which renormalizes the kernel) and
+    <tt>BORDER_TREATMENT_AVOID</tt> (which writes no border pixels) cannot be
+    expressed as a padded copy; they are delegated to the standard
+    \ref convolveLine(). The results are identical to \ref convolveLine()
+    in all modes.
+*/
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor,
+          class KernelIterator, class KernelAccessor,
+          class TmpType, class Alloc>
+void convolveLine(SrcIterator is, SrcIterator iend, SrcAccessor sa,
+                  DestIterator id, DestAccessor da,
+                  KernelIterator ik, KernelAccessor ka,
+                  int kleft, int kright, BorderTreatmentMode border,
+                  ArrayVector<TmpType, Alloc> & staging,
+                  int start = 0, int stop = 0)
+{
+    // repeated once per line when processing a batch of lines with a
+    // shared staging buffer, hence compilable-out
+    vigra_inner_precondition(kleft <= 0,
+                 "convolveLine(): kleft must be <= 0.\n");
+    vigra_inner_precondition(kright >= 0,
+                 "convolveLine(): kright must be >= 0.\n");
+
+    int w = std::distance( is, iend );
+
+    vigra_inner_precondition(w >= std::max(kright, -kleft) + 1,
+                 "convolveLine(): kernel longer than line.\n");
+
+    if(stop != 0)
+        vigra_precondition(0 <= start && start < stop && stop <= w,
+                        "convolveLine(): invalid subrange (start, stop).\n");
+    else
+        stop = w;
+
+    if(border == BORDER_TREATMENT_CLIP || border == BORDER_TREATMENT_AVOID)
+    {
+        convolveLine(is, iend, sa, id, da, ik, ka, kleft, kright, border, start, stop);
+        return;
+    }
+
+    typedef typename AccessorTraits<TmpType>::default_accessor TmpAccessor;
+    typedef typename AccessorTraits<TmpType>::default_const_accessor ConstTmpAccessor;
+
+    int kw = kright - kleft + 1;
+    if((int)staging.size() < stop - start + kw - 1)
+        staging.resize(stop - start + kw - 1);
+
+    detail::copyLineWithBorderTreatment(is, iend, sa, staging.begin(), TmpAccessor(),
+                                        start, stop, kleft, kright, border);
+    internalConvolveLineOptimistic(staging.begin() + kright,
+                                   staging.begin() + kright + (stop - start),
+                                   ConstTmpAccessor(), id, da, ik, ka, kleft, kright);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor,
+          class KernelIterator, class KernelAccessor,
+          class TmpType, class Alloc>
+inline
+void convolveLine(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                  pair<DestIterator, DestAccessor> dest,
+                  tuple5<KernelIterator, KernelAccessor,
+                         int, int, BorderTreatmentMode> kernel,
+                  ArrayVector<TmpType, Alloc> & staging,
+                  int start = 0, int stop = 0)
+{
+    convolveLine(src.first, src.second, src.third,
+                 dest.first, dest.second,
+                 kernel.first, kernel.second,
+                 kernel.third, kernel.fourth, kernel.fifth, staging, start, stop);
+}
+
 /********************************************************/
 /*                                                      */
 /*                      separableConvolveX              */
@@ -2428,6 +2756,198 @@ Kernel1D<ARITHTYPE>::initSymmetricDifference(value_type norm)
     border_treatment_ = BORDER_TREATMENT_REFLECT;
 }
 
+/********************************************************/
+/*                                                      */
+/*                 GaussianKernelCache                  */
+/*                                                      */
+/********************************************************/
+
+/** \brief Thread-safe cache for sampled Gaussian kernels.
+
+    Scale-space code tends to request the same small set of Gaussian
+    (derivative) kernels over and over again, e.g. once per frame of a
+    video. \ref vigra::Kernel1D::initGaussian() and
+    \ref vigra::Kernel1D::initGaussianDerivative() recompute the kernel
+    from scratch on every call. This cache stores each kernel the first
+    time it is requested, keyed by standard deviation, derivative order,
+    and window ratio (the window ratio determines the kernel radius and
+    thereby the windowing accuracy, see initGaussian()), and returns a
+    copy of the immutable cached kernel on subsequent requests. All
+    cached kernels have norm 1 and are computed in double precision.
+
+    The Gaussian filter functions on multi-dimensional arrays
+    (\ref gaussianSmoothMultiArray(), \ref gaussianGradientMultiArray(),
+    \ref hessianOfGaussianMultiArray() etc.) consult the global cache
+    automatically whenever they construct their kernels in double
+    precision. Access to the cache is serialized in OpenMP builds, so
+    concurrent filter calls from parallel sections are safe.
+
+    <b> Usage:</b>
+
+        <b>\#include</b> \<vigra/separableconvolution.hxx\><br>
+        Namespace: vigra
+
+    \code
+    Kernel1D<double> smooth = GaussianKernelCache::global().gaussian(2.0);
+    Kernel1D<double> deriv  = GaussianKernelCache::global().gaussianDerivative(2.0, 1);
+    \endcode
+*/
+class GaussianKernelCache
+{
+  public:
+
+        /** Access the global cache instance used by the Gaussian
+            filter functions.
+        */
+    static GaussianKernelCache & global()
+    {
+        static GaussianKernelCache cache;
+        return cache;
+    }
+
+        /** Get a Gaussian smoothing kernel for the given standard
+            deviation and window ratio (equivalent to
+            <tt>initGaussian(sigma, 1.0, windowRatio)</tt>).
+        */
+    Kernel1D<double> gaussian(double sigma, double windowRatio = 0.0)
+    {
+        return lookup(Key(sigma, 0, windowRatio));
+    }
+
+        /** Get a Gaussian derivative kernel for the given standard
+            deviation, derivative order, and window ratio (equivalent to
+            <tt>initGaussianDerivative(sigma, order, 1.0, windowRatio)</tt>).
+        */
+    Kernel1D<double> gaussianDerivative(double sigma, int order,
+                                        double windowRatio = 0.0)
+    {
+        return lookup(Key(sigma, order, windowRatio));
+    }
+
+        /** Number of kernels currently stored in the cache.
+        */
+    std::size_t size() const
+    {
+        std::size_t res = 0;
+#ifdef _OPENMP
+        #pragma omp critical(vigra_gaussian_kernel_cache)
+#endif
+        res = kernels_.size();
+        return res;
+    }
+
+        /** Discard all cached kernels.
+        */
+    void clear()
+    {
+#ifdef _OPENMP
+        #pragma omp critical(vigra_gaussian_kernel_cache)
+#endif
+        kernels_.clear();
+    }
+
+  private:
+
+    struct Key
+    {
+        double sigma, windowRatio;
+        int order;
+
+        Key(double s, int o, double w)
+        : sigma(s), windowRatio(w), order(o)
+        {}
+
+        bool operator<(Key const & o) const
+        {
+            if(sigma != o.sigma)
+                return sigma < o.sigma;
+            if(order != o.order)
+                return order < o.order;
+            return windowRatio < o.windowRatio;
+        }
+    };
+
+    typedef std::map<Key, Kernel1D<double> > KernelMap;
+
+    GaussianKernelCache()
+    {}
+
+    GaussianKernelCache(GaussianKernelCache const &); // not implemented
+    GaussianKernelCache & operator=(GaussianKernelCache const &); // not implemented
+
+    Kernel1D<double> lookup(Key const & key)
+    {
+        Kernel1D<double> res;
+        bool found = false;
+#ifdef _OPENMP
+        #pragma omp critical(vigra_gaussian_kernel_cache)
+#endif
+        {
+            KernelMap::const_iterator it = kernels_.find(key);
+            if(it != kernels_.end())
+            {
+                res = it->second;
+                found = true;
+            }
+        }
+        if(!found)
+        {
+            // compute outside the critical section to keep the lock
+            // short; a concurrent duplicate computation is harmless
+            // since insert() keeps the first entry
+            res.initGaussianDerivative(key.sigma, key.order, 1.0, key.windowRatio);
+#ifdef _OPENMP
+            #pragma omp critical(vigra_gaussian_kernel_cache)
+#endif
+            kernels_.insert(std::make_pair(key, res));
+        }
+        return res;
+    }
+
+    KernelMap kernels_;
+};
+
+namespace detail {
+
+// Initialize 'k' as a Gaussian (derivative) kernel with norm 1, taking
+// it from the global GaussianKernelCache when the element type is
+// double. Kernels with other element types are computed directly
+// because converting a cached double kernel would change the result
+// bit-wise relative to the established behavior.
+
+template <class T>
+inline void
+initCachedGaussianDerivative(Kernel1D<T> & k, double sigma, int order,
+                             double windowRatio, VigraFalseType /* isDouble */)
+{
+    k.initGaussianDerivative(sigma, order, NumericTraits<T>::one(), windowRatio);
+}
+
+inline void
+initCachedGaussianDerivative(Kernel1D<double> & k, double sigma, int order,
+                             double windowRatio, VigraTrueType /* isDouble */)
+{
+    k = GaussianKernelCache::global().gaussianDerivative(sigma, order, windowRatio);
+}
+
+template <class T>
+inline void
+initCachedGaussianDerivative(Kernel1D<T> & k, double sigma, int order,
+                             double windowRatio)
+{
+    typedef typename IsSameType<T, double>::result isDouble;
+    initCachedGaussianDerivative(k, sigma, order, windowRatio, isDouble());
+}
+
+template <class T>
+inline void
+initCachedGaussian(Kernel1D<T> & k, double sigma, double windowRatio)
+{
+    initCachedGaussianDerivative(k, sigma, 0, windowRatio);
+}
+
+} // namespace detail
+
 /**************************************************************/
 /*                                                            */
 /*         Argument object factories for Kernel1D             */
@@ -2479,6 +2999,343 @@ kernel1d(Kernel1D<T> const & k, BorderTreatmentMode border)
                                      border);
 }
 
+/********************************************************/
+/*                                                      */
+/*         fixed-point convolution of 8-bit lines       */
+/*                                                      */
+/********************************************************/
+
+namespace detail {
+
+template <class T>
+inline double kernelTapAsDouble(T const & v)
+{
+    return static_cast<double>(v);
+}
+
+template <unsigned IntBits, unsigned FracBits>
+inline double kernelTapAsDouble(FixedPoint<IntBits, FracBits> const & v)
+{
+    return fixed_point_cast<double>(v);
+}
+
+// Quantize the kernel into reversed 16-bit fixed-point taps. The number
+// of fractional bits is chosen as large as possible (at most 14) such
+// that every tap fits into an Int16. Returns the number of fractional
+// bits.
+template <class T, class TapVector>
+int quantizeKernelFixedPoint(Kernel1D<T> const & kernel, TapVector & taps)
+{
+    int kleft = kernel.left(),
+        kright = kernel.right(),
+        kw = kright - kleft + 1;
+    double maxAbs = 0.0;
+    for(int i = kleft; i <= kright; ++i)
+        maxAbs = std::max(maxAbs, std::fabs(kernelTapAsDouble(kernel[i])));
+    int fracBits = 14;
+    while(fracBits > 0 && maxAbs * (double)(1 << fracBits) > 32767.0)
+        --fracBits;
+    vigra_precondition(maxAbs * (double)(1 << fracBits) <= 32767.0,
+        "convolveLineFixedPoint(): kernel values too large for 16-bit fixed point.\n");
+    taps.resize(kw);
+    for(int j = 0; j < kw; ++j)
+        taps[j] = (Int16)VIGRA_CSTD::floor(
+                      kernelTapAsDouble(kernel[kright - j]) * (double)(1 << fracBits) + 0.5);
+    return fracBits;
+}
+
+// Inner product of a contiguous uint8 line with the reversed fixed-point
+// taps: out[x] = clamp((sum_j taps[j]*in[x+j] + round) >> fracBits).
+// The products are accumulated in 32 bits and packed back to uint8 with
+// saturation; the SSE2 version computes eight output pixels at once and
+// produces exactly the same results as the scalar loop.
+inline void
+convolveLineFixedPointImpl(UInt8 const * in, UInt8 * out, int n,
+                           Int16 const * kernel, int kw, int fracBits)
+{
+    Int32 rounding = (fracBits > 0) ? (Int32)1 << (fracBits - 1) : 0;
+    int x = 0;
+#if defined(__SSE2__)
+    __m128i zero = _mm_setzero_si128();
+    __m128i round32 = _mm_set1_epi32(rounding);
+    for(; x <= n - 8; x += 8)
+    {
+        __m128i acclo = round32,
+                acchi = round32;
+        for(int j = 0; j < kw; ++j)
+        {
+            __m128i pix = _mm_unpacklo_epi8(
+                  _mm_loadl_epi64(reinterpret_cast<__m128i const *>(in + x + j)), zero);
+            __m128i coef = _mm_set1_epi16(kernel[j]);
+            __m128i lo = _mm_mullo_epi16(pix, coef);
+            __m128i hi = _mm_mulhi_epi16(pix, coef);
+            acclo = _mm_add_epi32(acclo, _mm_unpacklo_epi16(lo, hi));
+            acchi = _mm_add_epi32(acchi, _mm_unpackhi_epi16(lo, hi));
+        }
+        acclo = _mm_srai_epi32(acclo, fracBits);
+        acchi = _mm_srai_epi32(acchi, fracBits);
+        __m128i words = _mm_packs_epi32(acclo, acchi);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + x),
+                         _mm_packus_epi16(words, words));
+    }
+#endif
+    for(; x < n; ++x)
+    {
+        Int32 sum = rounding;
+        for(int j = 0; j < kw; ++j)
+            sum += (Int32)kernel[j] * (Int32)in[x + j];
+        sum >>= fracBits;
+        out[x] = (UInt8)(sum < 0 ? 0 : (sum > 255 ? 255 : sum));
+    }
+}
+
+// copy the line into a buffer with 'left' resp. 'right' border pixels
+// synthesized according to the given border treatment
+inline void
+copyLineFixedPointPadded(UInt8 const * in, int w, UInt8 * padded,
+                         int left, int right, BorderTreatmentMode border)
+{
+    UInt8 * center = padded + left;
+    std::copy(in, in + w, center);
+    switch(border)
+    {
+      case BORDER_TREATMENT_REPEAT:
+      {
+        for(int i = 1; i <= left; ++i)
+            center[-i] = in[0];
+        for(int i = 1; i <= right; ++i)
+            center[w-1+i] = in[w-1];
+        break;
+      }
+      case BORDER_TREATMENT_REFLECT:
+      {
+        for(int i = 1; i <= left; ++i)
+            center[-i] = in[i];
+        for(int i = 1; i <= right; ++i)
+            center[w-1+i] = in[w-1-i];
+        break;
+      }
+      case BORDER_TREATMENT_WRAP:
+      {
+        for(int i = 1; i <= left; ++i)
+            center[-i] = in[w-i];
+        for(int i = 1; i <= right; ++i)
+            center[w-1+i] = in[i-1];
+        break;
+      }
+      case BORDER_TREATMENT_ZEROPAD:
+      {
+        for(int i = 1; i <= left; ++i)
+            center[-i] = 0;
+        for(int i = 1; i <= right; ++i)
+            center[w-1+i] = 0;
+        break;
+      }
+      default:
+      {
+        vigra_precondition(false,
+            "convolveLineFixedPoint(): border treatment must be REPEAT, REFLECT, WRAP, ZEROPAD, or AVOID.\n");
+      }
+    }
+}
+
+} // namespace detail
+
+/** \brief Convolve a line of 8-bit pixels in 16-bit fixed-point arithmetic.
+
+    The kernel (given either with floating-point values or as
+    \ref vigra::FixedPoint values) is quantized to 16-bit fixed-point taps
+    with at most 14 fractional bits, the inner products are accumulated in
+    32 bits, and the results are rounded and packed back to <tt>UInt8</tt>
+    with saturation. This avoids the conversion of 8-bit data to float
+    entirely and is vectorized with SSE2 when available (with results
+    identical to the scalar code, since all arithmetic is integral). The
+    accuracy is about 1/2<sup>14</sup> per unit of kernel norm, i.e. off
+    by at most one gray level for normalized smoothing kernels.
+
+    The border treatment mode of the kernel must be REPEAT, REFLECT, WRAP,
+    ZEROPAD, or AVOID. <tt>BORDER_TREATMENT_CLIP</tt> is not supported
+    because the renormalization cannot be precomputed in fixed point.
+
+    <b> Declaration:</b>
+
+    \code
+    namespace vigra {
+        template <class T>
+        void convolveLineFixedPoint(UInt8 const * is, UInt8 const * iend, UInt8 * id,
+                                    Kernel1D<T> const & kernel);
+    }
+    \endcode
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/separableconvolution.hxx\>
+
+    \code
+    vigra::Kernel1D<double> gauss;
+    gauss.initGaussian(1.5);
+
+    vigra::convolveLineFixedPoint(src, src + w, dest, gauss);
+    \endcode
+*/
+template <class T>
+void convolveLineFixedPoint(UInt8 const * is, UInt8 const * iend, UInt8 * id,
+                            Kernel1D<T> const & kernel)
+{
+    int w = (int)(iend - is);
+    int kleft = kernel.left(),
+        kright = kernel.right(),
+        kw = kright - kleft + 1;
+
+    // repeated once per line by separableConvolveX/YFixedPoint(), which
+    // enforce the same conditions at their API boundary
+    vigra_inner_precondition(kleft <= 0,
+                 "convolveLineFixedPoint(): kleft must be <= 0.\n");
+    vigra_inner_precondition(kright >= 0,
+                 "convolveLineFixedPoint(): kright must be >= 0.\n");
+    vigra_inner_precondition(w >= std::max(kright, -kleft) + 1,
+                 "convolveLineFixedPoint(): kernel longer than line.\n");
+    vigra_inner_precondition(kw <= 255,
+                 "convolveLineFixedPoint(): kernel too long for 32-bit accumulation.\n");
+
+    SmallVector<Int16, 16> taps;
+    int fracBits = detail::quantizeKernelFixedPoint(kernel, taps);
+
+    if(kernel.borderTreatment() == BORDER_TREATMENT_AVOID)
+    {
+        int interior = w + kleft - kright;
+        if(interior > 0)
+            detail::convolveLineFixedPointImpl(is, id + kright, interior,
+                                               taps.begin(), kw, fracBits);
+    }
+    else
+    {
+        ArrayVector<UInt8> padded(w + kw - 1);
+        detail::copyLineFixedPointPadded(is, w, padded.begin(), kright, -kleft,
+                                         kernel.borderTreatment());
+        detail::convolveLineFixedPointImpl(padded.begin(), id, w,
+                                           taps.begin(), kw, fracBits);
+    }
+}
+
+/** \brief Performs a 1 dimensional fixed-point convolution in x direction.
+
+    Works like \ref separableConvolveX(), but the pixels are read as
+    <tt>UInt8</tt> and convolved entirely in 16-bit fixed-point arithmetic
+    (see \ref convolveLineFixedPoint() for the quantization and the
+    supported border treatment modes). Intended for 8-bit image pipelines
+    where the conversion to float dominates the running time.
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/separableconvolution.hxx\>
+
+    \code
+    vigra::BImage src(w,h), dest(w,h);
+
+    vigra::Kernel1D<double> kernel;
+    kernel.initGaussian(1.5);
+
+    vigra::separableConvolveXFixedPoint(srcImageRange(src), destImage(dest), kernel);
+    \endcode
+*/
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor, class T>
+void separableConvolveXFixedPoint(SrcIterator supperleft,
+                                  SrcIterator slowerright, SrcAccessor sa,
+                                  DestIterator dupperleft, DestAccessor da,
+                                  Kernel1D<T> const & kernel)
+{
+    int w = slowerright.x - supperleft.x;
+    int h = slowerright.y - supperleft.y;
+    int kleft = kernel.left(),
+        kright = kernel.right();
+
+    vigra_precondition(w >= std::max(kright, -kleft) + 1,
+                 "separableConvolveXFixedPoint(): kernel longer than line\n");
+    vigra_precondition(kright - kleft + 1 <= 255,
+                 "separableConvolveXFixedPoint(): kernel too long for 32-bit accumulation.\n");
+
+    bool avoid = (kernel.borderTreatment() == BORDER_TREATMENT_AVOID);
+    int writeStart = avoid ? kright : 0,
+        writeStop  = avoid ? w + kleft : w;
+
+    ArrayVector<UInt8> line(w), result(w);
+    for(int y=0; y<h; ++y, ++supperleft.y, ++dupperleft.y)
+    {
+        typename SrcIterator::row_iterator rs = supperleft.rowIterator();
+        typename DestIterator::row_iterator rd = dupperleft.rowIterator();
+
+        for(int x=0; x<w; ++x)
+            line[x] = detail::RequiresExplicitCast<UInt8>::cast(sa(rs, x));
+        convolveLineFixedPoint(line.begin(), line.begin() + w, result.begin(), kernel);
+        for(int x=writeStart; x<writeStop; ++x)
+            da.set(result[x], rd, x);
+    }
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor, class T>
+inline void
+separableConvolveXFixedPoint(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                             pair<DestIterator, DestAccessor> dest,
+                             Kernel1D<T> const & kernel)
+{
+    separableConvolveXFixedPoint(src.first, src.second, src.third,
+                                 dest.first, dest.second, kernel);
+}
+
+/** \brief Performs a 1 dimensional fixed-point convolution in y direction.
+
+    Works like \ref separableConvolveY(), but entirely in 16-bit
+    fixed-point arithmetic (see \ref convolveLineFixedPoint() and
+    \ref separableConvolveXFixedPoint()).
+*/
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor, class T>
+void separableConvolveYFixedPoint(SrcIterator supperleft,
+                                  SrcIterator slowerright, SrcAccessor sa,
+                                  DestIterator dupperleft, DestAccessor da,
+                                  Kernel1D<T> const & kernel)
+{
+    int w = slowerright.x - supperleft.x;
+    int h = slowerright.y - supperleft.y;
+    int kleft = kernel.left(),
+        kright = kernel.right();
+
+    vigra_precondition(h >= std::max(kright, -kleft) + 1,
+                 "separableConvolveYFixedPoint(): kernel longer than line\n");
+    vigra_precondition(kright - kleft + 1 <= 255,
+                 "separableConvolveYFixedPoint(): kernel too long for 32-bit accumulation.\n");
+
+    bool avoid = (kernel.borderTreatment() == BORDER_TREATMENT_AVOID);
+    int writeStart = avoid ? kright : 0,
+        writeStop  = avoid ? h + kleft : h;
+
+    ArrayVector<UInt8> line(h), result(h);
+    for(int x=0; x<w; ++x, ++supperleft.x, ++dupperleft.x)
+    {
+        typename SrcIterator::column_iterator cs = supperleft.columnIterator();
+        typename DestIterator::column_iterator cd = dupperleft.columnIterator();
+
+        for(int y=0; y<h; ++y)
+            line[y] = detail::RequiresExplicitCast<UInt8>::cast(sa(cs, y));
+        convolveLineFixedPoint(line.begin(), line.begin() + h, result.begin(), kernel);
+        for(int y=writeStart; y<writeStop; ++y)
+            da.set(result[y], cd, y);
+    }
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor, class T>
+inline void
+separableConvolveYFixedPoint(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                             pair<DestIterator, DestAccessor> dest,
+                             Kernel1D<T> const & kernel)
+{
+    separableConvolveYFixedPoint(src.first, src.second, src.third,
+                                 dest.first, dest.second, kernel);
+}
 
 } // namespace vigra
 
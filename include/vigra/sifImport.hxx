@@ -217,6 +217,93 @@ VIGRA_EXPORT void readSIF(const SIFImportInfo &info, MultiArrayView<3, float, Un
 */
 VIGRA_EXPORT void readSIFBlock(const SIFImportInfo &info, Shape3 offset, Shape3 shape, MultiArrayView<3, float, UnstridedArrayTag> array);
 
+/********************************************************/
+/*                                                      */
+/*                   SIFStreamReader                    */
+/*                                                      */
+/********************************************************/
+/** \brief Read the frames of an Andor SIF file on demand.
+
+While \ref readSIF() loads the entire dataset into memory at once, this
+class keeps the file open and decodes single frames or frame ranges when
+they are requested, so that the analysis of long acquisitions can start
+immediately and never needs the complete stack in memory. Since all
+frames have the same size, the file position of every frame is computed
+in constant time from the header offset (see frameOffset()). An optional
+read-ahead fetches the given number of subsequent frames with the same
+file access, which reduces the number of seeks during sequential scans.
+
+<b> Usage:</b>
+
+<b>\#include</b> \<vigra/sifImport.hxx\><br>
+Namespace: vigra
+
+\code
+SIFImportInfo info(filename);
+SIFStreamReader reader(info, 16);    // read ahead 16 frames
+
+MultiArray<2, float> frame(Shape2(info.width(), info.height()));
+for(int k = 0; k < reader.numFrames(); ++k)
+{
+    reader.readFrame(k, frame);
+    ... // process the frame
+}
+\endcode
+*/
+class SIFStreamReader
+{
+    public:
+        /** Construct a reader for the dataset represented by \a info.
+
+            The file stays open for the lifetime of the reader. When
+            \a readAheadFrames is positive, readFrame() fetches up to
+            that many subsequent frames together with the requested one
+            and serves them from memory.
+         */
+        VIGRA_EXPORT SIFStreamReader(const SIFImportInfo & info, int readAheadFrames = 0);
+
+        /** Get the width of the frames in pixels.
+         */
+        VIGRA_EXPORT int width() const;
+
+        /** Get the height of the frames in pixels.
+         */
+        VIGRA_EXPORT int height() const;
+
+        /** Get the number of frames in the file.
+         */
+        VIGRA_EXPORT int numFrames() const;
+
+        /** Get the position of the given frame in the file.
+         */
+        VIGRA_EXPORT std::ptrdiff_t frameOffset(int frame) const;
+
+        /** Read frame number \a frame (<tt>0...numFrames()-1</tt>).
+            The array must have shape (width() x height()).
+         */
+        VIGRA_EXPORT void readFrame(int frame, MultiArrayView<2, float, UnstridedArrayTag> array);
+
+        /** Read the frame range <tt>[beginFrame, endFrame)</tt> with a
+            single file access. The array must have shape
+            (width() x height() x (endFrame - beginFrame)).
+         */
+        VIGRA_EXPORT void readFrames(int beginFrame, int endFrame,
+                                     MultiArrayView<3, float, UnstridedArrayTag> array);
+
+    private:
+        // not copyable (owns an open file stream)
+        SIFStreamReader(SIFStreamReader const &);
+        SIFStreamReader & operator=(SIFStreamReader const &);
+
+        std::string m_filename;
+        int m_width, m_height, m_stacksize;
+        std::ptrdiff_t m_dataOffset;
+        int m_readAhead;
+        int m_bufferBegin, m_bufferEnd;   // frame range held in m_buffer
+        ArrayVector<float> m_buffer;
+        std::ifstream m_file;
+};
+
 VIGRA_EXPORT std::ostream& operator<<(std::ostream& os, const SIFImportInfo& info);
 
 //@}
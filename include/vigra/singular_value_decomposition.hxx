@@ -39,6 +39,7 @@
 
 #include "matrix.hxx"
 #include "array_vector.hxx"
+#include "parallel_options.hxx"
 
 
 namespace vigra
@@ -47,6 +48,16 @@ namespace vigra
 namespace linalg
 {
 
+namespace detail {
+
+template <class T, class C1, class C2, class C3, class C4>
+unsigned int
+singularValueDecompositionTallSkinny(MultiArrayView<2, T, C1> const & A,
+    MultiArrayView<2, T, C2> &U, MultiArrayView<2, T, C3> &S, MultiArrayView<2, T, C4> &V,
+    int num_threads);
+
+} // namespace detail
+
    /** Singular Value Decomposition.
        \ingroup MatrixAlgebra
 
@@ -66,6 +77,14 @@ namespace linalg
     (Adapted from JAMA, a Java Matrix Library, developed jointly
     by the Mathworks and NIST; see  http://math.nist.gov/javanumerics/jama).
 
+   Tall-skinny matrices (more than three times as many rows as columns) are
+   decomposed via an initial Householder QR factorization followed by an SVD
+   of the small triangular factor, which is much faster for these shapes.
+   A second overload accepts a \ref vigra::ParallelOptions object and applies
+   the QR reflectors to the trailing columns in parallel when the library is
+   compiled with OpenMP support; the result does not depend on the thread
+   count.
+
     <b>\#include</b> \<vigra/singular_value_decomposition.hxx\> or<br>
     <b>\#include</b> \<vigra/linear_algebra.hxx\><br>
         Namespaces: vigra and vigra::linalg
@@ -89,6 +108,9 @@ singularValueDecomposition(MultiArrayView<2, T, C1> const & A,
     vigra_precondition(rowCount(V) == cols && columnCount(V) == cols,
        "singularValueDecomposition(): Output matrix V must be square with n = columnCount(A).");
 
+    if(rows > 3*cols && cols > 1)
+        return detail::singularValueDecompositionTallSkinny(A, U, S, V, 1);
+
     MultiArrayIndex m = rows;
     MultiArrayIndex n = cols;
     MultiArrayIndex nu = n;
@@ -557,6 +579,142 @@ singularValueDecomposition(MultiArrayView<2, T, C1> const & A,
     return rank; // effective rank
 }
 
+namespace detail {
+
+// apply the Householder reflector stored in column k of 'house' to the
+// columns [jfirst, jend) of 'target', optionally distributed over threads
+template <class T, class C1, class C2>
+void applyHouseholderToColumns(MultiArrayView<2, T, C1> const & house,
+                               MultiArrayView<2, T, C2> & target,
+                               MultiArrayIndex k, MultiArrayIndex jfirst, MultiArrayIndex jend,
+                               int num_threads)
+{
+    const MultiArrayIndex m = rowCount(house);
+
+#ifdef _OPENMP
+    if(num_threads > 1 && jend - jfirst > 1)
+    {
+        std::string errorMessage;
+
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(int j = (int)jfirst; j < (int)jend; ++j)
+        {
+            try
+            {
+                T s = 0.0;
+                for(MultiArrayIndex i = k; i < m; ++i)
+                    s += house(i, k) * target(i, j);
+                s = -s / house(k, k);
+                for(MultiArrayIndex i = k; i < m; ++i)
+                    target(i, j) += s * house(i, k);
+            }
+            catch(std::exception & e)
+            {
+#pragma omp critical(vigra_svd_error)
+                errorMessage += e.what();
+            }
+        }
+
+        if(errorMessage.size())
+            vigra_fail("singularValueDecomposition(): worker thread failed with:\n" + errorMessage);
+    }
+    else
+#endif // _OPENMP
+    {
+        for(MultiArrayIndex j = jfirst; j < jend; ++j)
+        {
+            T s = 0.0;
+            for(MultiArrayIndex i = k; i < m; ++i)
+                s += house(i, k) * target(i, j);
+            s = -s / house(k, k);
+            for(MultiArrayIndex i = k; i < m; ++i)
+                target(i, j) += s * house(i, k);
+        }
+    }
+}
+
+// SVD of a tall-skinny matrix: Householder QR first, then SVD of the
+// small triangular factor, finally U = Q * U_R
+template <class T, class C1, class C2, class C3, class C4>
+unsigned int
+singularValueDecompositionTallSkinny(MultiArrayView<2, T, C1> const & A,
+    MultiArrayView<2, T, C2> &U, MultiArrayView<2, T, C3> &S, MultiArrayView<2, T, C4> &V,
+    int num_threads)
+{
+    typedef T Real;
+
+    const MultiArrayIndex m = rowCount(A);
+    const MultiArrayIndex n = columnCount(A);
+
+    // Householder QR factorization (JAMA style); reflector k is stored
+    // in column k of 'a' at and below the diagonal
+    Matrix<Real> a(A);
+    ArrayVector<Real> rdiag((unsigned int)n);
+    for(MultiArrayIndex k = 0; k < n; ++k)
+    {
+        Real nrm = 0.0;
+        for(MultiArrayIndex i = k; i < m; ++i)
+            nrm = hypot(nrm, a(i, k));
+        if(nrm != 0.0)
+        {
+            if(a(k, k) < 0.0)
+                nrm = -nrm;
+            for(MultiArrayIndex i = k; i < m; ++i)
+                a(i, k) /= nrm;
+            a(k, k) += 1.0;
+            applyHouseholderToColumns(a, a, k, k+1, n, num_threads);
+        }
+        rdiag[(unsigned int)k] = -nrm;
+    }
+
+    Matrix<Real> r(n, n);
+    for(MultiArrayIndex k = 0; k < n; ++k)
+    {
+        r(k, k) = rdiag[(unsigned int)k];
+        for(MultiArrayIndex j = k+1; j < n; ++j)
+            r(k, j) = a(k, j);
+    }
+
+    Matrix<Real> ur(n, n);
+    unsigned int rank = singularValueDecomposition(r, ur, S, V);
+
+    // U = Q * U_R, obtained by applying the reflectors in reverse order
+    U.init(0.0);
+    for(MultiArrayIndex k = 0; k < n; ++k)
+        for(MultiArrayIndex j = 0; j < n; ++j)
+            U(k, j) = ur(k, j);
+    for(MultiArrayIndex k = n-1; k >= 0; --k)
+        if(a(k, k) != 0.0)
+            applyHouseholderToColumns(a, U, k, 0, n, num_threads);
+
+    return rank;
+}
+
+} // namespace detail
+
+template <class T, class C1, class C2, class C3, class C4>
+inline unsigned int
+singularValueDecomposition(MultiArrayView<2, T, C1> const & A,
+    MultiArrayView<2, T, C2> &U, MultiArrayView<2, T, C3> &S, MultiArrayView<2, T, C4> &V,
+    ParallelOptions const & options)
+{
+    const MultiArrayIndex rows = rowCount(A);
+    const MultiArrayIndex cols = columnCount(A);
+    vigra_precondition(rows >= cols,
+       "singularValueDecomposition(): Input matrix A must be rectangular with rowCount >= columnCount.");
+    vigra_precondition(rowCount(S) == cols && columnCount(S) == 1,
+       "singularValueDecomposition(): Output S must be column vector with rowCount == columnCount(A).");
+    vigra_precondition(rowCount(U) == rows && columnCount(U) == cols,
+       "singularValueDecomposition(): Output matrix U must have the same dimensions as input matrix A.");
+    vigra_precondition(rowCount(V) == cols && columnCount(V) == cols,
+       "singularValueDecomposition(): Output matrix V must be square with n = columnCount(A).");
+
+    if(rows > 3*cols && cols > 1)
+        return detail::singularValueDecompositionTallSkinny(A, U, S, V, options.getNumThreads());
+
+    return singularValueDecomposition(A, U, S, V);
+}
+
 } // namespace linalg
 
 using linalg::singularValueDecomposition;
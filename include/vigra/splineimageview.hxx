@@ -48,6 +48,56 @@
 
 namespace vigra {
 
+/********************************************************/
+/*                                                      */
+/*                   LazyTileOptions                    */
+/*                                                      */
+/********************************************************/
+
+/** \brief Options object for lazy, tile-granular spline prefiltering.
+
+    Passing this object to the constructor of \ref vigra::SplineImageView
+    defers the computation of the spline coefficients: instead of
+    prefiltering the entire image up-front, coefficients are computed in
+    square tiles when a tile is touched for the first time. This makes
+    construction of a view over a large image cheap when only a small
+    (e.g. warped) region is subsequently sampled.
+
+    <b>Usage:</b>
+
+    \code
+    SplineImageView<3, double> view(srcImageRange(img), LazyTileOptions());
+
+    // use 128x128 coefficient tiles instead of the default 64x64
+    SplineImageView<3, double> view2(srcImageRange(img),
+                                     LazyTileOptions().tileSize(128));
+    \endcode
+*/
+class LazyTileOptions
+{
+  public:
+
+    LazyTileOptions()
+    : tile_size_(64)
+    {}
+
+        /** Set the tile edge length (default: 64 pixels).
+        */
+    LazyTileOptions & tileSize(unsigned int size)
+    {
+        tile_size_ = size;
+        return *this;
+    }
+
+    unsigned int getTileSize() const
+    {
+        return tile_size_;
+    }
+
+  private:
+    unsigned int tile_size_;
+};
+
 /********************************************************/
 /*                                                      */
 /*                    SplineImageView                   */
@@ -148,13 +198,41 @@ class SplineImageView
       x0_(kcenter_), x1_(w_ - kcenter_ - 2), y0_(kcenter_), y1_(h_ - kcenter_ - 2),
       image_(w_, h_),
       x_(-1.0), y_(-1.0),
-      u_(-1.0), v_(-1.0)
+      u_(-1.0), v_(-1.0),
+      lazy_(false),
+      tileSize_(0), tilesX_(0), tilesY_(0)
     {
         copyImage(srcIterRange(is, iend, sa), destImage(image_));
         if(!skipPrefiltering)
             init();
     }
 
+        /** Construct SplineImageView with lazy, tile-granular prefiltering.
+
+            The spline coefficients are not computed at construction.
+            Instead, square tiles of the coefficient image (tile size
+            given by <tt>options</tt>, default 64x64) are prefiltered on
+            first access. Each tile is computed from a source window
+            enlarged by a safety margin, so that the truncation of the
+            recursive prefilter is below machine precision, and the
+            result agrees with the eagerly computed coefficients.
+        */
+    template <class SrcIterator, class SrcAccessor>
+    SplineImageView(SrcIterator is, SrcIterator iend, SrcAccessor sa,
+                    LazyTileOptions const & options)
+    : w_(iend.x - is.x), h_(iend.y - is.y), w1_(w_-1), h1_(h_-1),
+      x0_(kcenter_), x1_(w_ - kcenter_ - 2), y0_(kcenter_), y1_(h_ - kcenter_ - 2),
+      image_(w_, h_),
+      x_(-1.0), y_(-1.0),
+      u_(-1.0), v_(-1.0),
+      original_(w_, h_),
+      lazy_(true),
+      tileSize_(0), tilesX_(0), tilesY_(0)
+    {
+        copyImage(srcIterRange(is, iend, sa), destImage(original_));
+        initLazyTiles(options.getTileSize());
+    }
+
         /** Construct SplineImageView for the given image.
 
             If <tt>skipPrefiltering = true</tt> (default: <tt>false</tt>), the recursive
@@ -168,13 +246,36 @@ class SplineImageView
       x0_(kcenter_), x1_(w_ - kcenter_ - 2), y0_(kcenter_), y1_(h_ - kcenter_ - 2),
       image_(w_, h_),
       x_(-1.0), y_(-1.0),
-      u_(-1.0), v_(-1.0)
+      u_(-1.0), v_(-1.0),
+      lazy_(false),
+      tileSize_(0), tilesX_(0), tilesY_(0)
     {
         copyImage(srcIterRange(s.first, s.second, s.third), destImage(image_));
         if(!skipPrefiltering)
             init();
     }
 
+        /** Construct SplineImageView with lazy, tile-granular prefiltering.
+
+            See the corresponding constructor with explicit iterator
+            arguments for details.
+        */
+    template <class SrcIterator, class SrcAccessor>
+    SplineImageView(triple<SrcIterator, SrcIterator, SrcAccessor> s,
+                    LazyTileOptions const & options)
+    : w_(s.second.x - s.first.x), h_(s.second.y - s.first.y), w1_(w_-1), h1_(h_-1),
+      x0_(kcenter_), x1_(w_ - kcenter_ - 2), y0_(kcenter_), y1_(h_ - kcenter_ - 2),
+      image_(w_, h_),
+      x_(-1.0), y_(-1.0),
+      u_(-1.0), v_(-1.0),
+      original_(w_, h_),
+      lazy_(true),
+      tileSize_(0), tilesX_(0), tilesY_(0)
+    {
+        copyImage(srcIterRange(s.first, s.second, s.third), destImage(original_));
+        initLazyTiles(options.getTileSize());
+    }
+
         /** Access interpolated function at real-valued coordinate <tt>(x, y)</tt>.
             If <tt>(x, y)</tt> is near the image border or outside the image, the value
             is calculated with reflective boundary conditions. An exception is thrown if the
@@ -399,9 +500,20 @@ class SplineImageView
         { return TinyVector<unsigned int, 2>(w_, h_); }
 
         /** The internal image holding the spline coefficients.
+
+            When the view was constructed with \ref vigra::LazyTileOptions,
+            all coefficient tiles that have not been touched yet are
+            computed before the image is returned.
         */
     InternalImage const & image() const
     {
+        if(lazy_)
+        {
+            for(unsigned int ty = 0; ty < tilesY_; ++ty)
+                for(unsigned int tx = 0; tx < tilesX_; ++tx)
+                    if(!tileValid_[ty*tilesX_ + tx])
+                        computeTile(tx, ty);
+        }
         return image_;
     }
 
@@ -497,18 +609,30 @@ class SplineImageView
   protected:
 
     void init();
+    void initLazyTiles(unsigned int tileSize);
+    void ensureTiles() const;
+    void computeTile(unsigned int tx, unsigned int ty) const;
     void calculateIndices(double x, double y) const;
     void coefficients(double t, double * const & c) const;
     void derivCoefficients(double t, unsigned int d, double * const & c) const;
     value_type convolve() const;
 
+        // safety margin around a lazily computed tile: the truncated
+        // tails of the recursive prefilter decay at least geometrically,
+        // so this margin pushes the truncation error below machine precision
+    enum { prefilterMargin_ = 48 };
+
     unsigned int w_, h_;
     int w1_, h1_;
     double x0_, x1_, y0_, y1_;
-    InternalImage image_;
+    mutable InternalImage image_;
     Spline k_;
     mutable double x_, y_, u_, v_, kx_[ksize_], ky_[ksize_];
     mutable int ix_[ksize_], iy_[ksize_];
+    InternalImage original_;
+    bool lazy_;
+    unsigned int tileSize_, tilesX_, tilesY_;
+    mutable ArrayVector<unsigned char> tileValid_;
 };
 
 template <int ORDER, class VALUETYPE>
@@ -523,6 +647,71 @@ void SplineImageView<ORDER, VALUETYPE>::init()
     }
 }
 
+template <int ORDER, class VALUETYPE>
+void SplineImageView<ORDER, VALUETYPE>::initLazyTiles(unsigned int tileSize)
+{
+    tileSize_ = (tileSize < (unsigned int)ksize_)
+                   ? (unsigned int)ksize_
+                   : tileSize;
+    tilesX_ = (w_ + tileSize_ - 1) / tileSize_;
+    tilesY_ = (h_ + tileSize_ - 1) / tileSize_;
+    tileValid_.resize(tilesX_*tilesY_, 0);
+}
+
+template <int ORDER, class VALUETYPE>
+void SplineImageView<ORDER, VALUETYPE>::ensureTiles() const
+{
+    int ixmin = ix_[0], ixmax = ix_[0], iymin = iy_[0], iymax = iy_[0];
+    for(int i=1; i<ksize_; ++i)
+    {
+        if(ix_[i] < ixmin) ixmin = ix_[i];
+        if(ix_[i] > ixmax) ixmax = ix_[i];
+        if(iy_[i] < iymin) iymin = iy_[i];
+        if(iy_[i] > iymax) iymax = iy_[i];
+    }
+    for(unsigned int ty = iymin / tileSize_; ty <= iymax / tileSize_; ++ty)
+        for(unsigned int tx = ixmin / tileSize_; tx <= ixmax / tileSize_; ++tx)
+            if(!tileValid_[ty*tilesX_ + tx])
+                computeTile(tx, ty);
+}
+
+template <int ORDER, class VALUETYPE>
+void SplineImageView<ORDER, VALUETYPE>::computeTile(unsigned int tx, unsigned int ty) const
+{
+    int x0 = tx * tileSize_;
+    int y0 = ty * tileSize_;
+    int x1 = (x0 + (int)tileSize_ < (int)w_) ? x0 + (int)tileSize_ : (int)w_;
+    int y1 = (y0 + (int)tileSize_ < (int)h_) ? y0 + (int)tileSize_ : (int)h_;
+
+    // enlarge the source window by the prefilter margin; where the window
+    // hits the image border, the reflective boundary treatment coincides
+    // with that of the full-image prefilter
+    int px0 = (x0 > prefilterMargin_) ? x0 - prefilterMargin_ : 0;
+    int py0 = (y0 > prefilterMargin_) ? y0 - prefilterMargin_ : 0;
+    int px1 = (x1 + prefilterMargin_ < (int)w_) ? x1 + prefilterMargin_ : (int)w_;
+    int py1 = (y1 + prefilterMargin_ < (int)h_) ? y1 + prefilterMargin_ : (int)h_;
+
+    InternalImage tmp(px1 - px0, py1 - py0);
+    copyImage(srcIterRange(original_.upperLeft() + Diff2D(px0, py0),
+                           original_.upperLeft() + Diff2D(px1, py1),
+                           original_.accessor()),
+              destImage(tmp));
+
+    ArrayVector<double> const & b = k_.prefilterCoefficients();
+    for(unsigned int i=0; i<b.size(); ++i)
+    {
+        recursiveFilterX(srcImageRange(tmp), destImage(tmp), b[i], BORDER_TREATMENT_REFLECT);
+        recursiveFilterY(srcImageRange(tmp), destImage(tmp), b[i], BORDER_TREATMENT_REFLECT);
+    }
+
+    copyImage(srcIterRange(tmp.upperLeft() + Diff2D(x0 - px0, y0 - py0),
+                           tmp.upperLeft() + Diff2D(x1 - px0, y1 - py0),
+                           tmp.accessor()),
+              destIter(image_.upperLeft() + Diff2D(x0, y0), image_.accessor()));
+
+    tileValid_[ty*tilesX_ + tx] = 1;
+}
+
 namespace detail
 {
 
@@ -625,6 +814,8 @@ SplineImageView<ORDER, VALUETYPE>::calculateIndices(double x, double y) const
     }
     x_ = x;
     y_ = y;
+    if(lazy_)
+        ensureTiles();
 }
 
 template <int ORDER, class VALUETYPE>
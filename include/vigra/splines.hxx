@@ -1282,6 +1282,123 @@ CatmullRomSpline<T>::operator()(argument_type x) const
     }
 }
 
+/********************************************************/
+/*                                                      */
+/*                  SplineWeightTable                   */
+/*                                                      */
+/********************************************************/
+
+/** Precomputed spline interpolation weights for quantized sub-pixel phases.
+
+    The spline functors evaluate piecewise polynomials with several
+    branches per call. When many samples must be interpolated (as in
+    \ref vigra::SplineImageView or warping code), these evaluations
+    dominate the per-sample cost although only the fractional part of
+    the coordinate ever changes. This class removes the polynomial
+    evaluation from the per-sample path: the constructor tabulates the
+    <tt>ORDER+1</tt> kernel weights of the given spline for
+    <tt>phaseCount + 1</tt> equidistant sub-pixel phases (1024 by
+    default), and lookup reduces to rounding the phase to the nearest
+    table row.
+
+    The phase convention matches \ref vigra::SplineImageView: for a
+    spline of order <i>n</i> the weight of tap <i>i</i>
+    (<i>i = 0 ... n</i>) at phase <i>t</i> is <i>B(t + n/2 - i)</i>
+    (integer division), where <i>t</i> runs over <tt>[0, 1]</tt> for
+    odd orders and over <tt>[-0.5, 0.5]</tt> for even orders. The
+    tabulated weights are exact at the quantized phases; between them,
+    nearest-phase lookup introduces an error bounded by half the phase
+    step times the maximal slope of the spline, so increase
+    <tt>phaseCount</tt> when more accuracy is needed.
+
+    The template argument can be any of the spline functors in this
+    file (e.g. <tt>BSpline<3, double></tt> or
+    <tt>CatmullRomSpline<double></tt>). Derivative weights are obtained
+    by passing a spline functor constructed with the desired derivative
+    order.
+
+    <b>\#include</b> \<vigra/splines.hxx\><br>
+    Namespace: vigra
+*/
+template <class SPLINE>
+class SplineWeightTable
+{
+  public:
+        /** the tabulated spline functor type
+        */
+    typedef SPLINE SplineFunctor;
+        /** the type of the tabulated weights
+        */
+    typedef typename SPLINE::result_type value_type;
+        /** the spline order and the number of weights per phase
+        */
+    enum StaticOrder { order = SPLINE::order, ksize = SPLINE::order + 1 };
+
+        /** Tabulate the weights of <tt>spline</tt> for
+            <tt>phaseCount + 1</tt> equidistant phases.
+        */
+    explicit SplineWeightTable(unsigned int phaseCount = 1024,
+                               SPLINE const & spline = SPLINE())
+    : phaseCount_(phaseCount),
+      tmin_((order % 2) ? 0.0 : -0.5),
+      table_((phaseCount + 1) * (unsigned int)ksize)
+    {
+        vigra_precondition(phaseCount > 0,
+            "SplineWeightTable(): phaseCount must be positive.");
+        const double kcenter = order / 2; // (note: integer division)
+        for(unsigned int p = 0; p <= phaseCount_; ++p)
+        {
+            double t = tmin_ + (double)p / phaseCount_ + kcenter;
+            value_type * c = table_.begin() + p * (unsigned int)ksize;
+            for(int i = 0; i < (int)ksize; ++i)
+                c[i] = spline(t - i);
+        }
+    }
+
+        /** Number of quantized phases (table has <tt>phaseCount() + 1</tt> rows).
+        */
+    unsigned int phaseCount() const
+        { return phaseCount_; }
+
+        /** Distance between two neighboring tabulated phases.
+        */
+    double phaseStep() const
+        { return 1.0 / phaseCount_; }
+
+        /** Round phase <tt>t</tt> to the nearest table row. <tt>t</tt>
+            must be in <tt>[0, 1]</tt> for odd and <tt>[-0.5, 0.5]</tt>
+            for even spline orders.
+        */
+    unsigned int phaseIndex(double t) const
+    {
+        vigra_precondition(t >= tmin_ && t <= tmin_ + 1.0,
+            "SplineWeightTable::phaseIndex(): phase out of range.");
+        return (unsigned int)((t - tmin_) * phaseCount_ + 0.5);
+    }
+
+        /** Get a pointer to the <tt>ksize</tt> weights of table row
+            <tt>phase</tt> (<tt>0 <= phase <= phaseCount()</tt>).
+        */
+    value_type const * weightsAtPhase(unsigned int phase) const
+    {
+        return table_.begin() + phase * (unsigned int)ksize;
+    }
+
+        /** Batch lookup: copy the <tt>ksize</tt> weights for the phase
+            nearest to <tt>t</tt> into the array <tt>c</tt>.
+        */
+    void weights(double t, value_type * c) const
+    {
+        value_type const * w = weightsAtPhase(phaseIndex(t));
+        for(int i = 0; i < (int)ksize; ++i)
+            c[i] = w[i];
+    }
+
+  private:
+    unsigned int phaseCount_;
+    double tmin_;
+    ArrayVector<value_type> table_;
+};
 
 //@}
 
@@ -40,6 +40,8 @@
 #include "numerictraits.hxx"
 #include "stdimage.hxx"
 #include "convolution.hxx"
+#include "array_vector.hxx"
+#include "parallel_options.hxx"
 
 namespace vigra {
 
@@ -78,6 +80,13 @@ namespace vigra {
         radialSymmetryTransform(SrcIterator sul, SrcIterator slr, SrcAccessor as,
                                 DestIterator dul, DestAccessor ad,
                                 double scale)
+
+        template <class SrcIterator, class SrcAccessor,
+                  class DestIterator, class DestAccessor>
+        void
+        radialSymmetryTransform(SrcIterator sul, SrcIterator slr, SrcAccessor as,
+                                DestIterator dul, DestAccessor ad,
+                                double scale, ParallelOptions const & options)
     }
     \endcode
 
@@ -91,9 +100,23 @@ namespace vigra {
                triple<SrcIterator, SrcIterator, SrcAccessor> src,
                pair<DestIterator, DestAccessor> dest,
                double scale)
+
+        template <class SrcIterator, class SrcAccessor,
+                  class DestIterator, class DestAccessor>
+        inline
+        void radialSymmetryTransform(
+               triple<SrcIterator, SrcIterator, SrcAccessor> src,
+               pair<DestIterator, DestAccessor> dest,
+               double scale, ParallelOptions const & options)
     }
     \endcode
 
+    The overloads taking a \ref vigra::ParallelOptions argument distribute the
+    voting step over horizontal image strips when OpenMP is enabled. Each strip
+    accumulates its votes into a private buffer, and the buffers are merged in
+    strip order, so the result is bit-identical to the serial function for any
+    thread count.
+
     <b> Usage:</b>
 
         <b>\#include</b> \<vigra/symmetry.hxx\><br>
@@ -256,6 +279,231 @@ void radialSymmetryTransform(
                 scale);
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+void
+radialSymmetryTransform(SrcIterator sul, SrcIterator slr, SrcAccessor as,
+               DestIterator dul, DestAccessor ad,
+        double scale, ParallelOptions const & options)
+{
+    vigra_precondition(scale > 0.0,
+                 "radialSymmetryTransform(): Scale must be > 0");
+
+    int w = slr.x - sul.x;
+    int h = slr.y - sul.y;
+
+    if(w <= 0 || h <= 0) return;
+
+    typedef typename
+        NumericTraits<typename SrcAccessor::value_type>::RealPromote TmpType;
+
+    typedef BasicImage<TmpType> TmpImage;
+
+    TmpImage gx(w,h);
+    TmpImage gy(w,h);
+    IImage   orientationCounter(w,h);
+    TmpImage magnitudeAccumulator(w,h);
+
+    gaussianGradient(srcIterRange(sul, slr, as),
+                     destImage(gx), destImage(gy),
+                     scale);
+
+    orientationCounter.init(0);
+    magnitudeAccumulator.init(NumericTraits<TmpType>::zero());
+
+    // votes travel at most this many pixels in each direction
+    int radius = (int)(scale + 0.5);
+    if(radius < 1)
+        radius = 1;
+
+    // each strip votes into a private buffer covering the strip plus the vote
+    // radius; the buffers are merged in strip order, which reproduces the scan
+    // order of the serial voting loop exactly for any thread count
+    int stripCount = std::min(h, 4 * options.getNumThreads());
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(options.getNumThreads())
+#endif
+    {
+#ifdef _OPENMP
+#pragma omp for ordered schedule(static)
+#endif
+        for(int s = 0; s < stripCount; ++s)
+        {
+            int ys = s * h / stripCount;
+            int ye = (s + 1) * h / stripCount;
+            int bs = std::max(0, ys - radius);
+            int be = std::min(h, ye + radius);
+
+            // rows in [lo, hi) receive votes from this strip only and can be
+            // merged in bulk; votes into the remaining boundary rows are
+            // recorded and replayed individually, so that every pixel
+            // accumulates its magnitudes in exactly the serial scan order
+            int lo = (ys == 0) ? 0 : ys + radius;
+            int hi = (ye == h) ? h : ye - radius;
+
+            IImage   stripCounter(w, be - bs);
+            TmpImage stripMagnitude(w, be - bs);
+            stripCounter.init(0);
+            stripMagnitude.init(NumericTraits<TmpType>::zero());
+
+            ArrayVector<int> replayX, replayY;
+            ArrayVector<TmpType> replayMagnitude;
+
+            for(int y = ys; y < ye; ++y)
+            {
+                TmpType const * gxr = gx[y];
+                TmpType const * gyr = gy[y];
+
+                for(int x = 0; x < w; ++x)
+                {
+                    double angle = VIGRA_CSTD::atan2(-gyr[x], gxr[x]);
+                    double magnitude = VIGRA_CSTD::sqrt(gxr[x] * gxr[x] + gyr[x] * gyr[x]);
+
+                    if(magnitude < NumericTraits<TmpType>::epsilon()*10.0)
+                        continue;
+
+                    int dx = NumericTraits<int>::fromRealPromote(scale * VIGRA_CSTD::cos(angle));
+                    int dy = NumericTraits<int>::fromRealPromote(scale * VIGRA_CSTD::sin(angle));
+
+                    int xx = x + dx;
+                    int yy = y - dy;
+
+                    if(xx >= 0 && xx < w && yy >= 0 && yy < h)
+                    {
+                        stripCounter(xx, yy - bs) += 1;
+                        if(yy >= lo && yy < hi)
+                        {
+                            stripMagnitude(xx, yy - bs) += detail::RequiresExplicitCast<TmpType>::cast(magnitude);
+                        }
+                        else
+                        {
+                            replayX.push_back(xx);
+                            replayY.push_back(yy);
+                            replayMagnitude.push_back(detail::RequiresExplicitCast<TmpType>::cast(magnitude));
+                        }
+                    }
+
+                    xx = x - dx;
+                    yy = y + dy;
+
+                    if(xx >= 0 && xx < w && yy >= 0 && yy < h)
+                    {
+                        stripCounter(xx, yy - bs) -= 1;
+                        if(yy >= lo && yy < hi)
+                        {
+                            stripMagnitude(xx, yy - bs) -= detail::RequiresExplicitCast<TmpType>::cast(magnitude);
+                        }
+                        else
+                        {
+                            replayX.push_back(xx);
+                            replayY.push_back(yy);
+                            replayMagnitude.push_back(-detail::RequiresExplicitCast<TmpType>::cast(magnitude));
+                        }
+                    }
+                }
+            }
+
+#ifdef _OPENMP
+#pragma omp ordered
+#endif
+            {
+                for(int y = bs; y < be; ++y)
+                {
+                    int * co = orientationCounter[y];
+                    int const * cs = stripCounter[y - bs];
+
+                    for(int x = 0; x < w; ++x)
+                        co[x] += cs[x];
+                }
+
+                for(int y = lo; y < hi; ++y)
+                {
+                    TmpType * mo = magnitudeAccumulator[y];
+                    TmpType const * ms = stripMagnitude[y - bs];
+
+                    for(int x = 0; x < w; ++x)
+                        mo[x] += ms[x];
+                }
+
+                for(unsigned int i = 0; i < replayMagnitude.size(); ++i)
+                    magnitudeAccumulator(replayX[i], replayY[i]) += replayMagnitude[i];
+            }
+        }
+    }
+
+    int maxOrientation = 0;
+    TmpType maxMagnitude = NumericTraits<TmpType>::zero();
+
+    ArrayVector<int> rowMaxOrientation(h, 0);
+    ArrayVector<TmpType> rowMaxMagnitude(h, NumericTraits<TmpType>::zero());
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(options.getNumThreads())
+#endif
+    {
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for(int y = 0; y < h; ++y)
+        {
+            for(int x = 0; x < w; ++x)
+            {
+                int o = VIGRA_CSTD::abs(orientationCounter(x,y));
+
+                if(o > rowMaxOrientation[y])
+                    rowMaxOrientation[y] = o;
+
+                TmpType m = VIGRA_CSTD::abs(magnitudeAccumulator(x,y));
+
+                if(m > rowMaxMagnitude[y])
+                    rowMaxMagnitude[y] = m;
+            }
+        }
+
+#ifdef _OPENMP
+#pragma omp single
+#endif
+        {
+            for(int y = 0; y < h; ++y)
+            {
+                if(rowMaxOrientation[y] > maxOrientation)
+                    maxOrientation = rowMaxOrientation[y];
+
+                if(rowMaxMagnitude[y] > maxMagnitude)
+                    maxMagnitude = rowMaxMagnitude[y];
+            }
+        }
+
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for(int y = 0; y < h; ++y)
+        {
+            for(int x = 0; x < w; ++x)
+            {
+                double o = (double)orientationCounter(x, y) / maxOrientation;
+                magnitudeAccumulator(x, y) = detail::RequiresExplicitCast<TmpType>::cast(o * o * magnitudeAccumulator(x, y) / maxMagnitude);
+            }
+        }
+    }
+
+    gaussianSmoothing(srcImageRange(magnitudeAccumulator), destIter(dul, ad), 0.25*scale);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline
+void radialSymmetryTransform(
+           triple<SrcIterator, SrcIterator, SrcAccessor> src,
+       pair<DestIterator, DestAccessor> dest,
+       double scale, ParallelOptions const & options)
+{
+    radialSymmetryTransform(src.first, src.second, src.third,
+                            dest.first, dest.second,
+                scale, options);
+}
+
 
 //@}
 
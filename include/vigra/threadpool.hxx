@@ -0,0 +1,430 @@
+/************************************************************************/
+/*                                                                      */
+/*               Copyright 2012 by Ullrich Koethe                       */
+/*                                                                      */
+/*    This file is part of the VIGRA computer vision library.           */
+/*    The VIGRA Website is                                              */
+/*        http://hci.iwr.uni-heidelberg.de/vigra/                       */
+/*    Please direct questions, bug reports, and contributions to        */
+/*        ullrich.koethe@iwr.uni-heidelberg.de    or                    */
+/*        vigra@informatik.uni-hamburg.de                               */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+#ifndef VIGRA_THREADPOOL_HXX
+#define VIGRA_THREADPOOL_HXX
+
+#include <cstddef>
+#include <string>
+#include "error.hxx"
+#include "tinyvector.hxx"
+#include "parallel_options.hxx"
+
+namespace vigra {
+
+/** \addtogroup ParallelProcessing Parallel Processing
+
+    Thread pool and parallel loops shared by all parallel algorithms.
+
+    The pool of worker threads is provided by the OpenMP runtime: its
+    thread team is created once and reused across parallel regions, and
+    its <tt>dynamic</tt> loop scheduler lets idle threads grab the
+    remaining work chunks, which serves the same load-balancing purpose
+    as work stealing. When the library is compiled without OpenMP, all
+    functions in this header degenerate to simple serial loops.
+
+    Nested parallel calls compose instead of oversubscribing: when a
+    parallel algorithm is invoked from inside a worker thread (i.e.
+    within an existing parallel region), it runs serially in that
+    thread. This rule is implemented centrally in
+    ParallelOptions::getNumThreads(), so every algorithm taking a
+    \ref vigra::ParallelOptions argument -- convolution, labeling,
+    distance transform, feature extraction etc. -- obeys it
+    automatically.
+*/
+//@{
+
+namespace detail {
+
+// Common engine of all parallel loops: execute f(threadIndex, i) for
+// all i in [0, count). Exceptions thrown by workers are caught in the
+// worker (they must not leave the parallel region) and rethrown as a
+// single error after the loop.
+template <class FUNCTOR>
+void parallelForeachImpl(std::ptrdiff_t count, FUNCTOR & f,
+                         ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    int nt = options.getNumThreads();
+    if((std::ptrdiff_t)nt > count)
+        nt = (int)count;
+    if(nt > 1)
+    {
+        int chunk = options.getBlockSize((int)count);
+        bool failed = false;
+        std::string errorMessage;
+#pragma omp parallel num_threads(nt)
+        {
+            int threadIndex = omp_get_thread_num();
+#pragma omp for schedule(dynamic, chunk)
+            for(std::ptrdiff_t i = 0; i < count; ++i)
+            {
+                if(failed)
+                    continue;
+                try
+                {
+                    f(threadIndex, i);
+                }
+                catch(std::exception & e)
+                {
+#pragma omp critical(vigra_parallel_foreach_error)
+                    if(!failed)
+                    {
+                        failed = true;
+                        errorMessage = e.what();
+                    }
+                }
+                catch(...)
+                {
+#pragma omp critical(vigra_parallel_foreach_error)
+                    if(!failed)
+                    {
+                        failed = true;
+                        errorMessage = "unknown exception";
+                    }
+                }
+            }
+        }
+        if(failed)
+            vigra_fail("parallel_foreach(): worker thread failed with:\n" + errorMessage);
+        return;
+    }
+#endif // _OPENMP
+    // serial execution reports errors in the same form as the
+    // parallel loop, so callers see one consistent behavior
+    try
+    {
+        for(std::ptrdiff_t i = 0; i < count; ++i)
+            f(0, i);
+    }
+    catch(std::exception & e)
+    {
+        vigra_fail(std::string("parallel_foreach(): worker thread failed with:\n") + e.what());
+    }
+    catch(...)
+    {
+        vigra_fail("parallel_foreach(): worker thread failed with:\nunknown exception");
+    }
+}
+
+template <class ITERATOR, class FUNCTOR>
+struct ParallelForeachIteratorFunctor
+{
+    ITERATOR begin_;
+    FUNCTOR & f_;
+
+    ParallelForeachIteratorFunctor(ITERATOR begin, FUNCTOR & f)
+    : begin_(begin),
+      f_(f)
+    {}
+
+    void operator()(int threadIndex, std::ptrdiff_t i) const
+    {
+        f_(threadIndex, begin_[i]);
+    }
+};
+
+template <class T, int N, class FUNCTOR>
+struct ParallelForeachBlockFunctor
+{
+    typedef TinyVector<T, N> Shape;
+
+    Shape shape_, blockShape_, blocks_;
+    FUNCTOR & f_;
+
+    ParallelForeachBlockFunctor(Shape const & shape, Shape const & blockShape,
+                                Shape const & blocks, FUNCTOR & f)
+    : shape_(shape),
+      blockShape_(blockShape),
+      blocks_(blocks),
+      f_(f)
+    {}
+
+    void operator()(int threadIndex, std::ptrdiff_t i) const
+    {
+        Shape start, end;
+        for(int k = 0; k < N; ++k)
+        {
+            T c = (T)(i % blocks_[k]);
+            i /= blocks_[k];
+            start[k] = c * blockShape_[k];
+            end[k] = std::min(start[k] + blockShape_[k], shape_[k]);
+        }
+        f_(threadIndex, start, end);
+    }
+};
+
+} // namespace detail
+
+/********************************************************/
+/*                                                      */
+/*                   parallel_foreach                   */
+/*                                                      */
+/********************************************************/
+
+/** \brief Execute a functor for every index in <tt>[0, count)</tt> in parallel.
+
+    The functor is called as <tt>f(threadIndex, i)</tt>, where
+    <tt>threadIndex</tt> lies in <tt>[0, numThreads)</tt> and can be
+    used to address per-thread scratch space. Indices are distributed
+    in chunks of ParallelOptions::getBlockSize() items which idle
+    threads obtain dynamically, so an uneven workload balances itself.
+    The order in which indices are processed is unspecified; calls with
+    different indices run concurrently, so the functor must only write
+    to locations owned by the respective index or thread.
+
+    When an exception escapes from the functor, the loop finishes early
+    and the error is rethrown as <tt>std::runtime_error</tt> in the
+    calling thread.
+
+    Without OpenMP support, inside an existing parallel region, or when
+    one thread is requested, the indices are processed serially in
+    increasing order.
+
+    <b>Usage:</b>
+
+    <b>\#include</b> \<vigra/threadpool.hxx\><br>
+    Namespace: vigra
+
+    \code
+    struct ProcessLine
+    {
+        MultiArrayView<2, float> data;
+
+        void operator()(int threadIndex, std::ptrdiff_t y) const
+        {
+            // process line y of data
+        }
+    };
+
+    ProcessLine f = { data };
+    parallel_foreach(data.shape(1), f, ParallelOptions().numThreads(4));
+    \endcode
+*/
+template <class FUNCTOR>
+inline void
+parallel_foreach(std::ptrdiff_t count, FUNCTOR f,
+                 ParallelOptions const & options)
+{
+    detail::parallelForeachImpl(count, f, options);
+}
+
+template <class FUNCTOR>
+inline void
+parallel_foreach(std::ptrdiff_t count, FUNCTOR f)
+{
+    detail::parallelForeachImpl(count, f, ParallelOptions());
+}
+
+/** \brief Execute a functor for every element of a random-access range in parallel.
+
+    The functor is called as <tt>f(threadIndex, element)</tt> for every
+    element in <tt>[begin, end)</tt>; see the index overload of
+    \ref parallel_foreach() for the execution rules.
+*/
+template <class ITERATOR, class FUNCTOR>
+inline void
+parallel_foreach(ITERATOR begin, ITERATOR end, FUNCTOR f,
+                 ParallelOptions const & options)
+{
+    detail::ParallelForeachIteratorFunctor<ITERATOR, FUNCTOR> impl(begin, f);
+    detail::parallelForeachImpl((std::ptrdiff_t)(end - begin), impl, options);
+}
+
+template <class ITERATOR, class FUNCTOR>
+inline void
+parallel_foreach(ITERATOR begin, ITERATOR end, FUNCTOR f)
+{
+    parallel_foreach(begin, end, f, ParallelOptions());
+}
+
+/** \brief Execute a functor for every block of a MultiArray shape in parallel.
+
+    The array domain <tt>[0, shape)</tt> is partitioned into rectangular
+    blocks of at most <tt>blockShape</tt> elements (blocks at the upper
+    border are clipped to the shape), and the functor is called as
+    <tt>f(threadIndex, blockStart, blockEnd)</tt> for every block; see
+    the index overload of \ref parallel_foreach() for the execution
+    rules. Typically, the functor applies an algorithm to
+    <tt>array.subarray(blockStart, blockEnd)</tt>.
+
+    \code
+    struct SmoothBlock
+    {
+        MultiArrayView<3, float> source, dest;
+
+        void operator()(int, Shape3 const & start, Shape3 const & stop) const
+        {
+            // process [start, stop) of source/dest
+        }
+    };
+
+    SmoothBlock f = { source, dest };
+    parallel_foreach_block(source.shape(), Shape3(64, 64, 64), f,
+                           ParallelOptions().numThreads(4));
+    \endcode
+*/
+template <class T, int N, class FUNCTOR>
+inline void
+parallel_foreach_block(TinyVector<T, N> const & shape,
+                       TinyVector<T, N> const & blockShape,
+                       FUNCTOR f,
+                       ParallelOptions const & options)
+{
+    std::ptrdiff_t count = 1;
+    TinyVector<T, N> blocks;
+    for(int k = 0; k < N; ++k)
+    {
+        vigra_precondition(blockShape[k] > 0,
+            "parallel_foreach_block(): block shape must be positive.");
+        blocks[k] = (shape[k] + blockShape[k] - 1) / blockShape[k];
+        count *= (std::ptrdiff_t)blocks[k];
+    }
+    detail::ParallelForeachBlockFunctor<T, N, FUNCTOR>
+        impl(shape, blockShape, blocks, f);
+    detail::parallelForeachImpl(count, impl, options);
+}
+
+template <class T, int N, class FUNCTOR>
+inline void
+parallel_foreach_block(TinyVector<T, N> const & shape,
+                       TinyVector<T, N> const & blockShape,
+                       FUNCTOR f)
+{
+    parallel_foreach_block(shape, blockShape, f, ParallelOptions());
+}
+
+/********************************************************/
+/*                                                      */
+/*                      ThreadPool                      */
+/*                                                      */
+/********************************************************/
+
+/** \brief Facade for a pool of worker threads.
+
+    A ThreadPool bundles a \ref vigra::ParallelOptions object with the
+    \ref parallel_foreach() loops, so that a thread count chosen once
+    can be reused for many loops. The worker threads themselves are
+    owned by the OpenMP runtime and shared between all pools (and all
+    parallel algorithms of the library) -- constructing a ThreadPool is
+    therefore cheap, and running a loop from within another loop's
+    worker executes serially instead of creating additional threads.
+
+    The global pool returned by globalThreadPool() determines the
+    default thread count of every parallel algorithm: a
+    default-constructed ParallelOptions resolves
+    <tt>ParallelOptions::Auto</tt> against the global pool's size,
+    which can be configured with setGlobalNumThreads().
+
+    <b>\#include</b> \<vigra/threadpool.hxx\><br>
+    Namespace: vigra
+*/
+class ThreadPool
+{
+  public:
+        /** Create a pool facade for the given number of threads
+            (<tt>ParallelOptions::Auto</tt>: use the global default).
+        */
+    explicit ThreadPool(int numThreads = ParallelOptions::Auto)
+    : options_(ParallelOptions().numThreads(numThreads))
+    {}
+
+        /** Create a pool facade with the given options.
+        */
+    explicit ThreadPool(ParallelOptions const & options)
+    : options_(options)
+    {}
+
+        /** Number of threads loops of this pool will use
+            (never more than one inside an existing parallel region).
+        */
+    int numThreads() const
+    {
+        return options_.getNumThreads();
+    }
+
+        /** The options applied to the loops of this pool.
+        */
+    ParallelOptions const & options() const
+    {
+        return options_;
+    }
+
+        /** Run <tt>f(threadIndex, i)</tt> for all <tt>i</tt> in
+            <tt>[0, count)</tt> on this pool (see \ref parallel_foreach()).
+        */
+    template <class FUNCTOR>
+    void foreach(std::ptrdiff_t count, FUNCTOR f) const
+    {
+        detail::parallelForeachImpl(count, f, options_);
+    }
+
+  private:
+    ParallelOptions options_;
+};
+
+    /** Access the global thread pool.
+    */
+inline ThreadPool & globalThreadPool()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+    /** Configure the size of the global thread pool, i.e. the number of
+        threads used by parallel algorithms whose options request
+        <tt>ParallelOptions::Auto</tt> threads (the initial setting uses
+        one thread per processor). Pass <tt>ParallelOptions::Auto</tt>
+        to restore the initial behavior.
+    */
+inline void setGlobalNumThreads(int numThreads)
+{
+    detail::globalNumThreadsSetting() = numThreads < 0
+                                            ? int(ParallelOptions::Auto)
+                                            : numThreads;
+}
+
+    /** Number of threads in the global thread pool.
+    */
+inline int globalNumThreads()
+{
+    return globalThreadPool().numThreads();
+}
+
+//@}
+
+} // namespace vigra
+
+#endif // VIGRA_THREADPOOL_HXX
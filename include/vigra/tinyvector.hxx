@@ -49,6 +49,10 @@
 #include "mathutil.hxx"
 #include "diff2d.hxx"
 
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+
 #ifdef VIGRA_CHECK_BOUNDS
 #define VIGRA_ASSERT_INSIDE(diff) \
   vigra_precondition(diff >= 0, "Index out of bounds");\
@@ -504,6 +508,210 @@ struct UnrollLoop<0>
     }
 };
 
+#if defined(__SSE2__)
+
+// Explicit SSE2 specializations of the arithmetic loops for the common
+// vector-valued pixel shapes (float x 2, 3, 4 and double x 2), which the
+// compiler does not reliably vectorize through the UnrollLoop recursion.
+// All operations are element-wise, and dot() and squaredNorm() sum their
+// products in the same order as the generic code, so the results are
+// bitwise identical to the unspecialized versions. TinyVector memory is
+// not guaranteed to be 16-byte aligned => unaligned loads/stores.
+
+    // load/store exactly 8 resp. 12 bytes (a full 16-byte access would
+    // read beyond the end of the vector); unused upper lanes are zero;
+    // the integer intrinsics are used because __m128i pointers may
+    // alias any type, unlike double pointers
+inline __m128 tinyLoad2(float const * p)
+{
+    return _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<__m128i const *>(p)));
+}
+
+inline void tinyStore2(float * p, __m128 v)
+{
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(p), _mm_castps_si128(v));
+}
+
+inline __m128 tinyLoad3(float const * p)
+{
+    return _mm_movelh_ps(tinyLoad2(p), _mm_load_ss(p+2));
+}
+
+inline void tinyStore3(float * p, __m128 v)
+{
+    tinyStore2(p, v);
+    _mm_store_ss(p+2, _mm_movehl_ps(v, v));
+}
+
+    // set the unused upper lanes to 1.0 so that a division does not
+    // compute 0/0 and raise a spurious invalid-operation flag
+inline __m128 tinyOneUpper2(__m128 v)
+{
+    return _mm_movelh_ps(v, _mm_set1_ps(1.0f));
+}
+
+inline __m128 tinyOneUpper3(__m128 v)
+{
+    return _mm_or_ps(v, _mm_castsi128_ps(_mm_set_epi32(0x3f800000, 0, 0, 0)));
+}
+
+#define VIGRA_SSE_FLOAT4_OP(NAME, INTRIN) \
+template <> template <> \
+inline void UnrollLoop<4>::NAME<float, float>(float * left, float const * right) \
+{ \
+    _mm_storeu_ps(left, INTRIN(_mm_loadu_ps(left), _mm_loadu_ps(right))); \
+}
+
+VIGRA_SSE_FLOAT4_OP(add, _mm_add_ps)
+VIGRA_SSE_FLOAT4_OP(sub, _mm_sub_ps)
+VIGRA_SSE_FLOAT4_OP(mul, _mm_mul_ps)
+VIGRA_SSE_FLOAT4_OP(div, _mm_div_ps)
+
+#undef VIGRA_SSE_FLOAT4_OP
+
+#define VIGRA_SSE_FLOAT3_OP(NAME, INTRIN, FIXUPPER) \
+template <> template <> \
+inline void UnrollLoop<3>::NAME<float, float>(float * left, float const * right) \
+{ \
+    tinyStore3(left, INTRIN(tinyLoad3(left), FIXUPPER(tinyLoad3(right)))); \
+}
+
+VIGRA_SSE_FLOAT3_OP(add, _mm_add_ps, )
+VIGRA_SSE_FLOAT3_OP(sub, _mm_sub_ps, )
+VIGRA_SSE_FLOAT3_OP(mul, _mm_mul_ps, )
+VIGRA_SSE_FLOAT3_OP(div, _mm_div_ps, tinyOneUpper3)
+
+#undef VIGRA_SSE_FLOAT3_OP
+
+#define VIGRA_SSE_FLOAT2_OP(NAME, INTRIN, FIXUPPER) \
+template <> template <> \
+inline void UnrollLoop<2>::NAME<float, float>(float * left, float const * right) \
+{ \
+    tinyStore2(left, INTRIN(tinyLoad2(left), FIXUPPER(tinyLoad2(right)))); \
+}
+
+VIGRA_SSE_FLOAT2_OP(add, _mm_add_ps, )
+VIGRA_SSE_FLOAT2_OP(sub, _mm_sub_ps, )
+VIGRA_SSE_FLOAT2_OP(mul, _mm_mul_ps, )
+VIGRA_SSE_FLOAT2_OP(div, _mm_div_ps, tinyOneUpper2)
+
+#undef VIGRA_SSE_FLOAT2_OP
+
+#define VIGRA_SSE_DOUBLE2_OP(NAME, INTRIN) \
+template <> template <> \
+inline void UnrollLoop<2>::NAME<double, double>(double * left, double const * right) \
+{ \
+    _mm_storeu_pd(left, INTRIN(_mm_loadu_pd(left), _mm_loadu_pd(right))); \
+}
+
+VIGRA_SSE_DOUBLE2_OP(add, _mm_add_pd)
+VIGRA_SSE_DOUBLE2_OP(sub, _mm_sub_pd)
+VIGRA_SSE_DOUBLE2_OP(mul, _mm_mul_pd)
+VIGRA_SSE_DOUBLE2_OP(div, _mm_div_pd)
+
+#undef VIGRA_SSE_DOUBLE2_OP
+
+    // the scalar operand arrives as 'double' (see operator*=(double));
+    // the generic code computes in double precision and casts back, so
+    // the float specializations must do the same to remain identical
+#define VIGRA_SSE_FLOAT4_SCALAR_OP(NAME, INTRIN) \
+template <> template <> \
+inline void UnrollLoop<4>::NAME<float, double>(float * left, double right) \
+{ \
+    __m128 v = _mm_loadu_ps(left); \
+    __m128d s = _mm_set1_pd(right); \
+    __m128d lo = INTRIN(_mm_cvtps_pd(v), s); \
+    __m128d hi = INTRIN(_mm_cvtps_pd(_mm_movehl_ps(v, v)), s); \
+    _mm_storeu_ps(left, _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi))); \
+}
+
+VIGRA_SSE_FLOAT4_SCALAR_OP(mulScalar, _mm_mul_pd)
+VIGRA_SSE_FLOAT4_SCALAR_OP(divScalar, _mm_div_pd)
+
+#undef VIGRA_SSE_FLOAT4_SCALAR_OP
+
+#define VIGRA_SSE_FLOAT3_SCALAR_OP(NAME, INTRIN, OPER) \
+template <> template <> \
+inline void UnrollLoop<3>::NAME<float, double>(float * left, double right) \
+{ \
+    __m128d lo = INTRIN(_mm_cvtps_pd(tinyLoad2(left)), _mm_set1_pd(right)); \
+    tinyStore2(left, _mm_cvtpd_ps(lo)); \
+    left[2] = static_cast<float>(left[2] OPER right); \
+}
+
+VIGRA_SSE_FLOAT3_SCALAR_OP(mulScalar, _mm_mul_pd, *)
+VIGRA_SSE_FLOAT3_SCALAR_OP(divScalar, _mm_div_pd, /)
+
+#undef VIGRA_SSE_FLOAT3_SCALAR_OP
+
+#define VIGRA_SSE_FLOAT2_SCALAR_OP(NAME, INTRIN) \
+template <> template <> \
+inline void UnrollLoop<2>::NAME<float, double>(float * left, double right) \
+{ \
+    __m128d lo = INTRIN(_mm_cvtps_pd(tinyLoad2(left)), _mm_set1_pd(right)); \
+    tinyStore2(left, _mm_cvtpd_ps(lo)); \
+}
+
+VIGRA_SSE_FLOAT2_SCALAR_OP(mulScalar, _mm_mul_pd)
+VIGRA_SSE_FLOAT2_SCALAR_OP(divScalar, _mm_div_pd)
+
+#undef VIGRA_SSE_FLOAT2_SCALAR_OP
+
+template <> template <>
+inline void UnrollLoop<2>::mulScalar<double, double>(double * left, double right)
+{
+    _mm_storeu_pd(left, _mm_mul_pd(_mm_loadu_pd(left), _mm_set1_pd(right)));
+}
+
+template <> template <>
+inline void UnrollLoop<2>::divScalar<double, double>(double * left, double right)
+{
+    _mm_storeu_pd(left, _mm_div_pd(_mm_loadu_pd(left), _mm_set1_pd(right)));
+}
+
+    // the products are computed in SIMD registers, but summed in the
+    // same (right-associated) order as the generic code so that the
+    // result does not change
+template <> template <>
+inline PromoteTraits<float, float>::Promote
+UnrollLoop<4>::dot<float, float>(float const * left, float const * right)
+{
+    float t[4];
+    _mm_storeu_ps(t, _mm_mul_ps(_mm_loadu_ps(left), _mm_loadu_ps(right)));
+    return t[0] + (t[1] + (t[2] + t[3]));
+}
+
+template <> template <>
+inline PromoteTraits<double, double>::Promote
+UnrollLoop<2>::dot<double, double>(double const * left, double const * right)
+{
+    double t[2];
+    _mm_storeu_pd(t, _mm_mul_pd(_mm_loadu_pd(left), _mm_loadu_pd(right)));
+    return t[0] + t[1];
+}
+
+template <> template <>
+inline NormTraits<float>::SquaredNormType
+UnrollLoop<4>::squaredNorm<float>(float const * d)
+{
+    __m128 v = _mm_loadu_ps(d);
+    float t[4];
+    _mm_storeu_ps(t, _mm_mul_ps(v, v));
+    return t[0] + (t[1] + (t[2] + t[3]));
+}
+
+template <> template <>
+inline NormTraits<double>::SquaredNormType
+UnrollLoop<2>::squaredNorm<double>(double const * d)
+{
+    __m128d v = _mm_loadu_pd(d);
+    double t[2];
+    _mm_storeu_pd(t, _mm_mul_pd(v, v));
+    return t[0] + t[1];
+}
+
+#endif // __SSE2__
+
 template <int SIZE>
 struct LoopType
 {
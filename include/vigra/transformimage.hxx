@@ -37,12 +37,15 @@
 #ifndef VIGRA_TRANSFORMIMAGE_HXX
 #define VIGRA_TRANSFORMIMAGE_HXX
 
+#include <algorithm>
 #include "utilities.hxx"
 #include "numerictraits.hxx"
 #include "iteratortraits.hxx"
 #include "rgbvalue.hxx"
 #include "functortraits.hxx"
 #include "inspectimage.hxx"
+#include "parallel_options.hxx"
+#include "array_vector.hxx"
 
 namespace vigra {
 
@@ -129,6 +132,14 @@ transformLineIf(SrcIterator s,
     }
     \endcode
 
+    Both variants also accept a \ref vigra::ParallelOptions argument after the
+    functor. The image rows are then partitioned among the requested number of
+    threads (provided the library is compiled with OpenMP support), and each
+    thread applies its own copy of the functor, so the functor must be
+    stateless or safely copyable. Small images fall through to the serial
+    code path automatically, because thread startup would outweigh the work.
+    The result is identical to the serial version.
+
     <b> Usage:</b>
 
     <b>\#include</b> \<vigra/transformimage.hxx\><br>
@@ -173,6 +184,18 @@ transformImage(SrcImageIterator src_upperleft,
                Functor const & f)
 {
     int w = src_lowerright.x - src_upperleft.x;
+    int h = src_lowerright.y - src_upperleft.y;
+
+    // when both images are contiguous in memory, process all pixels in
+    // a single fused transformLine() call instead of row by row
+    if(detail::contiguousImageRows(src_upperleft, w, h, src_upperleft.rowIterator()) &&
+       detail::contiguousImageRows(dest_upperleft, w, h, dest_upperleft.rowIterator()))
+    {
+        transformLine(src_upperleft.rowIterator(),
+                      src_upperleft.rowIterator() + std::ptrdiff_t(w)*h, sa,
+                      dest_upperleft.rowIterator(), da, f);
+        return;
+    }
 
     for(; src_upperleft.y < src_lowerright.y; ++src_upperleft.y, ++dest_upperleft.y)
     {
@@ -194,6 +217,65 @@ transformImage(triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
                    dest.first, dest.second, f);
 }
 
+template <class SrcImageIterator, class SrcAccessor,
+          class DestImageIterator, class DestAccessor, class Functor>
+void
+transformImage(SrcImageIterator src_upperleft,
+               SrcImageIterator src_lowerright, SrcAccessor sa,
+               DestImageIterator dest_upperleft, DestAccessor da,
+               Functor const & f, ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    int w = src_lowerright.x - src_upperleft.x;
+    int h = src_lowerright.y - src_upperleft.y;
+
+    // fall through to the serial version when the image is too small
+    // for thread startup to pay off
+    if(options.getNumThreads() > 1 && double(w)*double(h) >= 65536.0)
+    {
+        int stripHeight = options.getBlockSize(h);
+        int stripCount = (h + stripHeight - 1) / stripHeight;
+
+        #pragma omp parallel num_threads(options.getNumThreads())
+        {
+            Functor g(f);   // each thread applies its own functor copy
+
+            #pragma omp for schedule(dynamic)
+            for(int strip = 0; strip < stripCount; ++strip)
+            {
+                int y0 = strip * stripHeight,
+                    y1 = std::min(h, y0 + stripHeight);
+                SrcImageIterator s(src_upperleft);
+                DestImageIterator d(dest_upperleft);
+                s.y += y0;
+                d.y += y0;
+                for(int y = y0; y < y1; ++y, ++s.y, ++d.y)
+                {
+                    transformLine(s.rowIterator(), s.rowIterator() + w, sa,
+                                  d.rowIterator(), da, g);
+                }
+            }
+        }
+        return;
+    }
+#else
+    (void)options;
+#endif
+    transformImage(src_upperleft, src_lowerright, sa, dest_upperleft, da, f);
+}
+
+template <class SrcImageIterator, class SrcAccessor,
+      class DestImageIterator, class DestAccessor, class Functor>
+inline
+void
+transformImage(triple<SrcImageIterator, SrcImageIterator, SrcAccessor> src,
+               pair<DestImageIterator, DestAccessor> dest,
+               Functor const & f, ParallelOptions const & options)
+{
+    transformImage(src.first, src.second, src.third,
+                   dest.first, dest.second, f, options);
+}
+
 /********************************************************/
 /*                                                      */
 /*                   transformImageIf                   */
@@ -1428,6 +1510,119 @@ class GammaFunctor<RGBValue<unsigned char> >
 };
 
 
+/********************************************************/
+/*                                                      */
+/*                      LUTFunctor                      */
+/*                                                      */
+/********************************************************/
+
+/** \brief Compile an arbitrary intensity functor into a lookup table.
+
+    For 8- and 16-bit pixel types the argument domain is small enough to
+    evaluate an intensity functor (e.g. \ref vigra::GammaFunctor or
+    \ref vigra::BrightnessContrastFunctor instantiated for a floating-point
+    pixel type) once for every possible input value. This adapter does
+    exactly that: the constructor tabulates the given functor over the
+    full range of <tt>ArgumentType</tt>, and <tt>operator()</tt> reduces
+    to a single table lookup, so the per-pixel transcendental math
+    disappears from the inner loop of \ref transformImage(). The adapter
+    is itself a unary functor and can be passed anywhere the original
+    functor could, including the \ref vigra::ParallelOptions overloads of
+    transformImage(). (The <tt>unsigned char</tt> specializations of
+    GammaFunctor and BrightnessContrastFunctor hard-code this trick for
+    their own transformation; LUTFunctor makes it available for any
+    functor and for 16-bit data.)
+
+    <b> Traits defined:</b>
+
+    <tt>FunctorTraits::isUnaryFunctor</tt> is true (<tt>VigraTrueType</tt>)
+
+    <b> Usage:</b>
+
+        <b>\#include</b> \<vigra/transformimage.hxx\><br>
+        Namespace: vigra
+
+    \code
+    vigra::UInt16Image in(width, height), out(width, height);
+    ...
+    vigra::GammaFunctor<double> gamma(0.45, 0.0, 65535.0);
+
+    vigra::transformImage(srcImageRange(in), destImage(out),
+                          vigra::lutFunctor<vigra::UInt16>(gamma));
+    \endcode
+
+    <b> Required Interface:</b>
+
+    <tt>ArgumentType</tt> must be an integral type of at most 16 bits
+    (this is checked with a precondition); <tt>Functor</tt> must define
+    <tt>result_type</tt> and be callable with an <tt>ArgumentType</tt>
+    argument.
+*/
+template <class ArgumentType, class Functor>
+class LUTFunctor
+{
+  public:
+
+        /** the functor's argument type
+        */
+    typedef ArgumentType argument_type;
+
+        /** the functor's result type
+        */
+    typedef typename Functor::result_type result_type;
+
+        /** \deprecated use argument_type and result_type
+        */
+    typedef result_type value_type;
+
+        /** Tabulate <tt>f</tt> over the full range of <tt>ArgumentType</tt>.
+        */
+    explicit LUTFunctor(Functor const & f)
+    : min_(NumericTraits<ArgumentType>::min())
+    {
+        double size = (double)NumericTraits<ArgumentType>::max()
+                      - (double)min_ + 1.0;
+        vigra_precondition(size <= 65536.0,
+            "LUTFunctor(): argument domain too large "
+            "(only integral types of at most 16 bits are supported).");
+        lut_.resize((std::size_t)size);
+        for(std::size_t k = 0; k < lut_.size(); ++k)
+            lut_[k] = f(static_cast<ArgumentType>(
+                            (std::ptrdiff_t)min_ + (std::ptrdiff_t)k));
+    }
+
+        /** Look up the tabulated result
+        */
+    result_type operator()(argument_type v) const
+    {
+        return lut_[(std::size_t)((std::ptrdiff_t)v - (std::ptrdiff_t)min_)];
+    }
+
+  private:
+    ArrayVector<result_type> lut_;
+    ArgumentType min_;
+};
+
+template <class ArgumentType, class Functor>
+class FunctorTraits<LUTFunctor<ArgumentType, Functor> >
+: public FunctorTraitsBase<LUTFunctor<ArgumentType, Functor> >
+{
+  public:
+    typedef VigraTrueType isUnaryFunctor;
+};
+
+/** \brief Factory function for \ref vigra::LUTFunctor.
+
+    The argument type cannot be deduced and must be given explicitly,
+    e.g. <tt>lutFunctor<vigra::UInt8>(f)</tt>.
+*/
+template <class ArgumentType, class Functor>
+inline LUTFunctor<ArgumentType, Functor>
+lutFunctor(Functor const & f)
+{
+    return LUTFunctor<ArgumentType, Functor>(f);
+}
+
 /********************************************************/
 /*                                                      */
 /*                     VectorNormFunctor                */
@@ -48,6 +48,7 @@
 #include "convolution.hxx"
 #include "fixedpoint.hxx"
 #include "project2ellipse.hxx"
+#include "parallel_options.hxx"
 
 #ifndef VIGRA_MIXED_2ND_DERIVATIVES
 #define VIGRA_MIXED_2ND_DERIVATIVES 1
@@ -272,6 +273,269 @@ void totalVariationFilter(MultiArrayView<2,double,stride1> data,MultiArrayView<2
     }
   }
 }
+
+/********************************************************/
+/*                                                      */
+/*         totalVariationFilterAccelerated              */
+/*                                                      */
+/********************************************************/
+
+/** \brief Performs accelerated Total Variation Regularization
+
+This function minimizes the same functional as \ref totalVariationFilter(),
+but uses the accelerated primal-dual algorithm of Chambolle and Pock
+(Algorithm 2 in: A. Chambolle, T. Pock: <em>"A first-order primal-dual
+algorithm for convex problems with applications to imaging"</em>, J. Math.
+Imaging and Vision 40(1), 2011): since the data term is strongly convex,
+the primal and dual step sizes can be adapted in every iteration, which
+improves the convergence rate from \f$ O(1/N) \f$ to \f$ O(1/N^2) \f$, so
+that far fewer iterations are needed to reach a given primal-dual gap.
+The point-wise update and projection loops are additionally distributed
+over OpenMP threads according to the given \ref vigra::ParallelOptions
+(sequential without OpenMP).
+
+<b> Declarations:</b>
+
+\code
+namespace vigra {
+      template <class stride1,class stride2>
+      void totalVariationFilterAccelerated(MultiArrayView<2,double,stride1> data,
+                                MultiArrayView<2,double,stride2> out,
+                                double alpha,
+                                int steps,
+                                double eps=0,
+                                ParallelOptions const & options=ParallelOptions());
+      void totalVariationFilterAccelerated(MultiArrayView<2,double,stride1> data,
+                                MultiArrayView<2,double,stride2> weight,
+                                MultiArrayView<2,double,stride3> out,
+                                double alpha,
+                                int steps,
+                                double eps=0,
+                                ParallelOptions const & options=ParallelOptions());
+}
+\endcode
+
+Parameters as in \ref totalVariationFilter(); <em>steps</em> gives the maximal
+number of iterations, <em>eps</em> the primal-dual gap threshold.
+
+<b> Usage:</b>
+
+<b>\#include</b> \<vigra/tv_filter.hxx\>
+
+\code
+MultiArray<2,double> data(Shape2(width,height));  // to be initialized
+MultiArray<2,double> out(Shape2(width,height));
+
+totalVariationFilterAccelerated(data,out,alpha,steps,eps,
+                                ParallelOptions().numThreads(4));
+\endcode
+ */
+doxygen_overloaded_function(template <...> void totalVariationFilterAccelerated)
+
+template <class stride1,class stride2>
+void totalVariationFilterAccelerated(MultiArrayView<2,double,stride1> data,MultiArrayView<2,double,stride2> out,
+                                     double alpha, int steps, double eps=0,
+                                     ParallelOptions const & options=ParallelOptions()){
+
+  using namespace multi_math;
+
+  int w=data.shape(0),h=data.shape(1);
+
+  MultiArray<2,double> temp1(data.shape()),temp2(data.shape()),vx(data.shape()),vy(data.shape()),u_bar(data.shape());
+  Kernel1D<double> Lx,LTx;
+  Lx.initExplicitly(0,1)=1,-1;                       // = Right sided finite differences for d/dx and d/dy
+  Lx.setBorderTreatment(BORDER_TREATMENT_REFLECT);   //   with hom. Neumann boundary conditions
+  LTx.initExplicitly(-1,0)=-1,1;                     //  = Left sided finite differences for -d/dx  and -d/dy
+  LTx.setBorderTreatment(BORDER_TREATMENT_ZEROPAD);  //   with hom. Dirichlet b. c.
+
+  out=data;
+  u_bar=data;
+
+  // operator norm of the scaled gradient alpha*L is bounded by sqrt(8)*alpha,
+  // the step sizes must satisfy tau*sigma*8*alpha^2<=1
+  double tau=1.0 / std::sqrt(8.0) / std::max(alpha,1.);
+  double sigma=1.0 / (8.0*alpha*alpha*tau);
+  double gamma=1.0;                                  // strong convexity of the data term
+
+  for (int i=0;i<steps;i++){
+
+    separableConvolveX(srcImageRange(u_bar),destImage(temp1),kernel1d(Lx));
+    separableConvolveY(srcImageRange(u_bar),destImage(temp2),kernel1d(Lx));
+
+    // dual ascent and projection to the constraint set
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads(options.getNumThreads())
+#endif
+    for (int y=0;y<h;y++){
+      for (int x=0;x<w;x++){
+        double px=vx(x,y)+sigma*alpha*temp1(x,y);
+        double py=vy(x,y)+sigma*alpha*temp2(x,y);
+        double l=hypot(px,py);
+        if (l>1){
+          px/=l;
+          py/=l;
+        }
+        vx(x,y)=px;
+        vy(x,y)=py;
+      }
+    }
+
+    separableConvolveX(srcImageRange(vx),destImage(temp1),kernel1d(LTx));
+    separableConvolveY(srcImageRange(vy),destImage(temp2),kernel1d(LTx));
+
+    // proximal descent, extrapolation, and adaptive step sizes
+    double theta=1.0/std::sqrt(1.0+2.0*gamma*tau);
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads(options.getNumThreads())
+#endif
+    for (int y=0;y<h;y++){
+      for (int x=0;x<w;x++){
+        double u_old=out(x,y);
+        double u_new=(u_old-tau*alpha*(temp1(x,y)+temp2(x,y))+tau*data(x,y))/(1.0+tau);
+        out(x,y)=u_new;
+        u_bar(x,y)=u_new+theta*(u_new-u_old);
+      }
+    }
+    tau*=theta;
+    sigma/=theta;
+
+    //stopping criterion
+    if (eps>0){
+      separableConvolveX(srcImageRange(out),destImage(temp1),kernel1d(Lx));
+      separableConvolveY(srcImageRange(out),destImage(temp2),kernel1d(Lx));
+
+      double f_primal=0,f_dual=0;
+#ifdef _OPENMP
+      #pragma omp parallel for reduction(+:f_primal) num_threads(options.getNumThreads())
+#endif
+      for (int y=0;y<h;y++){
+        for (int x=0;x<w;x++){
+          f_primal+=.5*(out(x,y)-data(x,y))*(out(x,y)-data(x,y))+alpha*hypot(temp1(x,y),temp2(x,y));
+        }
+      }
+      separableConvolveX(srcImageRange(vx),destImage(temp1),kernel1d(LTx));
+      separableConvolveY(srcImageRange(vy),destImage(temp2),kernel1d(LTx));
+#ifdef _OPENMP
+      #pragma omp parallel for reduction(+:f_dual) num_threads(options.getNumThreads())
+#endif
+      for (int y=0;y<h;y++){
+        for (int x=0;x<w;x++){
+          double divv=temp1(x,y)+temp2(x,y);
+          f_dual+=-.5*alpha*alpha*(divv*divv)+alpha*data(x,y)*divv;
+        }
+      }
+      if (f_primal>0 && (f_primal-f_dual)/f_primal<eps){
+        break;
+      }
+    }
+  }
+}
+
+template <class stride1,class stride2, class stride3>
+void totalVariationFilterAccelerated(MultiArrayView<2,double,stride1> data,MultiArrayView<2,double,stride2> weight,
+                                     MultiArrayView<2,double,stride3> out,
+                                     double alpha, int steps, double eps=0,
+                                     ParallelOptions const & options=ParallelOptions()){
+
+  using namespace multi_math;
+
+  int w=data.shape(0),h=data.shape(1);
+
+  MultiArray<2,double> temp1(data.shape()),temp2(data.shape()),vx(data.shape()),vy(data.shape()),u_bar(data.shape());
+  Kernel1D<double> Lx,LTx;
+  Lx.initExplicitly(0,1)=1,-1;                       // = Right sided finite differences for d/dx and d/dy
+  Lx.setBorderTreatment(BORDER_TREATMENT_REFLECT);   //   with hom. Neumann boundary conditions
+  LTx.initExplicitly(-1,0)=-1,1;                     //  = Left sided finite differences for -d/dx  and -d/dy
+  LTx.setBorderTreatment(BORDER_TREATMENT_ZEROPAD);  //   with hom. Dirichlet b. c.
+
+  out=data;
+  u_bar=data;
+
+  double tau=1.0 / std::sqrt(8.0) / std::max(alpha,1.);
+  double sigma=1.0 / (8.0*alpha*alpha*tau);
+
+  // the weighted data term is only strongly convex with the smallest weight
+  double gamma=weight(0,0);
+  for (int y=0;y<h;y++){
+    for (int x=0;x<w;x++){
+      gamma=std::min(gamma,weight(x,y));
+    }
+  }
+
+  for (int i=0;i<steps;i++){
+
+    separableConvolveX(srcImageRange(u_bar),destImage(temp1),kernel1d(Lx));
+    separableConvolveY(srcImageRange(u_bar),destImage(temp2),kernel1d(Lx));
+
+    // dual ascent and projection to the constraint set
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads(options.getNumThreads())
+#endif
+    for (int y=0;y<h;y++){
+      for (int x=0;x<w;x++){
+        double px=vx(x,y)+sigma*alpha*temp1(x,y);
+        double py=vy(x,y)+sigma*alpha*temp2(x,y);
+        double l=hypot(px,py);
+        if (l>1){
+          px/=l;
+          py/=l;
+        }
+        vx(x,y)=px;
+        vy(x,y)=py;
+      }
+    }
+
+    separableConvolveX(srcImageRange(vx),destImage(temp1),kernel1d(LTx));
+    separableConvolveY(srcImageRange(vy),destImage(temp2),kernel1d(LTx));
+
+    // proximal descent, extrapolation, and adaptive step sizes
+    double theta=1.0/std::sqrt(1.0+2.0*gamma*tau);
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads(options.getNumThreads())
+#endif
+    for (int y=0;y<h;y++){
+      for (int x=0;x<w;x++){
+        double u_old=out(x,y);
+        double u_new=(u_old-tau*alpha*(temp1(x,y)+temp2(x,y))+tau*weight(x,y)*data(x,y))
+                     /(1.0+tau*weight(x,y));
+        out(x,y)=u_new;
+        u_bar(x,y)=u_new+theta*(u_new-u_old);
+      }
+    }
+    tau*=theta;
+    sigma/=theta;
+
+    //stopping criterion
+    if (eps>0){
+      separableConvolveX(srcImageRange(out),destImage(temp1),kernel1d(Lx));
+      separableConvolveY(srcImageRange(out),destImage(temp2),kernel1d(Lx));
+
+      double f_primal=0,f_dual=0;
+#ifdef _OPENMP
+      #pragma omp parallel for reduction(+:f_primal) num_threads(options.getNumThreads())
+#endif
+      for (int y=0;y<h;y++){
+        for (int x=0;x<w;x++){
+          f_primal+=.5*weight(x,y)*(out(x,y)-data(x,y))*(out(x,y)-data(x,y))+alpha*hypot(temp1(x,y),temp2(x,y));
+        }
+      }
+      separableConvolveX(srcImageRange(vx),destImage(temp1),kernel1d(LTx));
+      separableConvolveY(srcImageRange(vy),destImage(temp2),kernel1d(LTx));
+#ifdef _OPENMP
+      #pragma omp parallel for reduction(+:f_dual) num_threads(options.getNumThreads())
+#endif
+      for (int y=0;y<h;y++){
+        for (int x=0;x<w;x++){
+          double divv=temp1(x,y)+temp2(x,y);
+          f_dual+=-.5*alpha*alpha*(weight(x,y)*divv*divv)+alpha*data(x,y)*divv;
+        }
+      }
+      if (f_primal>0 && (f_primal-f_dual)/f_primal<eps){
+        break;
+      }
+    }
+  }
+}
 //<!--\f$ \alpha(x)=\beta(x)=\beta_{par}\f$ in homogeneous regions without edges,
 //and \f$ \alpha(x)=\alpha_{par}\f$ at edges.-->
 
@@ -471,15 +735,17 @@ void anisotropicTotalVariationFilter(MultiArrayView<2,double,stride1> data,Multi
   
   MultiArray<2,double> temp1(data.shape()),temp2(data.shape()),vx(data.shape()),vy(data.shape()),u_bar(data.shape());
   MultiArray<2,double> rx(data.shape()),ry(data.shape());
-  
+  ArrayVector<double> skp1(data.shape(0)),skp2(data.shape(0)),av(data.shape(0)),bv(data.shape(0)),
+                      ce(data.shape(0)),se(data.shape(0));  // row buffers for the batched projection
+
   Kernel1D<double> Lx,LTx;
   Lx.initExplicitly(0,1)=1,-1;                       // = Right sided finite differences for d/dx and d/dy
   Lx.setBorderTreatment(BORDER_TREATMENT_REFLECT);   //   with hom. Neumann boundary conditions
   LTx.initExplicitly(-1,0)=-1,1;                     //  = Left sided finite differences for -d/dx  and -d/dy
   LTx.setBorderTreatment(BORDER_TREATMENT_ZEROPAD);  //   with hom. Dirichlet b. c.
-  
+
   u_bar=out;
-  
+
   double m=0;
   for (int y=0;y<data.shape(1);y++){
     for (int x=0;x<data.shape(0);x++){
@@ -498,22 +764,27 @@ void anisotropicTotalVariationFilter(MultiArrayView<2,double,stride1> data,Multi
     separableConvolveY(srcImageRange(u_bar),destImage(temp1),kernel1d(Lx));
     vy+=(sigma*temp1);
     
-    //project to constraint set
+    //project to constraint set (one batched ellipse projection per row)
     for (int y=0;y<data.shape(1);y++){
       for (int x=0;x<data.shape(0);x++){
-        double e1,e2,skp1,skp2;
+        double e1,e2;
 
         e1=std::cos(phi(x,y));
         e2=std::sin(phi(x,y));
-        skp1=vx(x,y)*e1+vy(x,y)*e2;
-        skp2=vx(x,y)*(-e2)+vy(x,y)*e1;
-        vigra::detail::projectEllipse2D (skp1,skp2,alpha(x,y),beta(x,y),0.001,100);
-        
-        vx(x,y)=skp1*e1-skp2*e2;
-        vy(x,y)=skp1*e2+skp2*e1;
+        skp1[x]=vx(x,y)*e1+vy(x,y)*e2;
+        skp2[x]=vx(x,y)*(-e2)+vy(x,y)*e1;
+        av[x]=alpha(x,y);
+        bv[x]=beta(x,y);
+        ce[x]=e1;
+        se[x]=e2;
+      }
+      vigra::detail::projectEllipse2DBatch (skp1.begin(),skp2.begin(),av.begin(),bv.begin(),data.shape(0),0.001,100);
+      for (int x=0;x<data.shape(0);x++){
+        vx(x,y)=skp1[x]*ce[x]-skp2[x]*se[x];
+        vy(x,y)=skp1[x]*se[x]+skp2[x]*ce[x];
       }
     }
-    
+
     separableConvolveX(srcImageRange(vx),destImage(temp1),kernel1d(LTx));
     separableConvolveY(srcImageRange(vy),destImage(temp2),kernel1d(LTx));
     u_bar=out;
@@ -628,8 +899,10 @@ void secondOrderTotalVariationFilter(MultiArrayView<2,double,stride1> data,
   MultiArray<2,double> temp1(data.shape()),temp2(data.shape()),vx(data.shape()),vy(data.shape()),u_bar(data.shape());
   MultiArray<2,double> rx(data.shape()),ry(data.shape());
   MultiArray<2,double> wx(data.shape()),wy(data.shape()),wz(data.shape());
-  
-  
+  ArrayVector<double> skp1(data.shape(0)),skp2(data.shape(0)),av(data.shape(0)),bv(data.shape(0)),
+                      ce(data.shape(0)),se(data.shape(0));  // row buffers for the batched projection
+
+
   Kernel1D<double> Lx,LTx;
   Lx.initExplicitly(0,1)=1,-1;                       // = Right sided finite differences for d/dx and d/dy
   Lx.setBorderTreatment(BORDER_TREATMENT_REFLECT);   //   with hom. Neumann boundary conditions
@@ -685,25 +958,31 @@ void secondOrderTotalVariationFilter(MultiArrayView<2,double,stride1> data,
     #endif
     
     
-    //project to constraint sets
+    //project to constraint sets (one batched ellipse projection per row)
     for (int y=0;y<data.shape(1);y++){
       for (int x=0;x<data.shape(0);x++){
-        double e1,e2,skp1,skp2;
-        
-        //project v
+        double e1,e2;
+
         e1=std::cos(phi(x,y));
         e2=std::sin(phi(x,y));
-        skp1=vx(x,y)*e1+vy(x,y)*e2;
-        skp2=vx(x,y)*(-e2)+vy(x,y)*e1;
-        vigra::detail::projectEllipse2D (skp1,skp2,alpha(x,y),beta(x,y),0.001,100);
-        vx(x,y)=skp1*e1-skp2*e2;
-        vy(x,y)=skp1*e2+skp2*e1;
-        
+        skp1[x]=vx(x,y)*e1+vy(x,y)*e2;
+        skp2[x]=vx(x,y)*(-e2)+vy(x,y)*e1;
+        av[x]=alpha(x,y);
+        bv[x]=beta(x,y);
+        ce[x]=e1;
+        se[x]=e2;
+      }
+      //project v
+      vigra::detail::projectEllipse2DBatch (skp1.begin(),skp2.begin(),av.begin(),bv.begin(),data.shape(0),0.001,100);
+      for (int x=0;x<data.shape(0);x++){
+        vx(x,y)=skp1[x]*ce[x]-skp2[x]*se[x];
+        vy(x,y)=skp1[x]*se[x]+skp2[x]*ce[x];
+
         //project w
         double l=sqrt(wx(x,y)*wx(x,y)+wy(x,y)*wy(x,y)+wz(x,y)*wz(x,y));
         if (l>gamma(x,y)){
           wx(x,y)=gamma(x,y)*wx(x,y)/l;
-          wy(x,y)=gamma(x,y)*wy(x,y)/l;  
+          wy(x,y)=gamma(x,y)*wy(x,y)/l;
           #if (VIGRA_MIXED_2ND_DERIVATIVES)
           wz(x,y)=gamma(x,y)*wz(x,y)/l;
           #endif
@@ -40,6 +40,7 @@
 #include "config.hxx"
 #include "error.hxx"
 #include "array_vector.hxx"
+#include "sized_int.hxx"
 
 namespace vigra {
 
@@ -124,7 +125,7 @@ class UnionFindArray
     unsigned int makeContiguous()
     {
         // compress trees
-        unsigned int count = 0; 
+        unsigned int count = 0;
         for(IndexType i=0; i<(IndexType)(labels_.size()-1); ++i)
         {
             if(labels_[i] == i)
@@ -133,10 +134,32 @@ class UnionFindArray
             }
             else
             {
-                    labels_[i] = labels_[(IndexType)labels_[i]]; 
+                    labels_[i] = labels_[(IndexType)labels_[i]];
             }
         }
-        return count-1;   
+        return count-1;
+    }
+
+    // Non-destructive counterpart of makeContiguous(): fill 'lut' with
+    // the mapping from every label to consecutive final labels (in scan
+    // order of the roots) without modifying the union-find structure,
+    // so that further merges remain possible. Returns the same value as
+    // makeContiguous() would, i.e. the highest final label.
+    unsigned int buildCompactingLUT(ArrayVector<T> & lut) const
+    {
+        IndexType size = (IndexType)labels_.size() - 1;
+        lut.resize((typename ArrayVector<T>::size_type)size);
+        unsigned int count = 0;
+        for(IndexType i=0; i<size; ++i)
+        {
+            // parents always have smaller indices than their children,
+            // so lut[labels_[i]] has already received its final label
+            if(labels_[i] == i)
+                lut[i] = (T)count++;
+            else
+                lut[i] = lut[(IndexType)labels_[i]];
+        }
+        return count-1;
     }
     
     T operator[](T label) const
@@ -145,6 +168,141 @@ class UnionFindArray
     }
 };
 
+/** Compact union-find with union-by-rank and path halving.
+
+    In contrast to UnionFindArray, which attaches trees at the smaller
+    root to keep labels in scan order, this variant merges by rank and
+    shortens paths during find(), so both operations run in nearly
+    constant amortized time even for adversarial merge sequences. Each
+    element occupies a single word of the template type: non-roots store
+    the parent index, roots store their rank with the highest bit set.
+    T must be an unsigned integer type; use RankedUnionFindArray<UInt32>
+    (or the UnionFindArray32 shorthand) to halve the memory footprint
+    when 64-bit indices are not needed.
+
+    Elements are numbered 0 ... size()-1. After makeContiguous(), the
+    structure is frozen and operator[] maps every element to the final
+    label of its set (0 ... number of sets - 1, in index order of the
+    set's smallest-index root).
+*/
+template <class T = UInt32>
+class RankedUnionFindArray
+{
+    typedef typename ArrayVector<T>::difference_type IndexType;
+
+    static T rootFlag()
+    {
+        return T(1) << (8*sizeof(T) - 1);
+    }
+
+    mutable ArrayVector<T> entries_;
+
+  public:
+    RankedUnionFindArray(T size = 0)
+    : entries_((unsigned int)size, rootFlag())
+    {}
+
+    T size() const
+    {
+        return (T)entries_.size();
+    }
+
+    T makeNewLabel()
+    {
+        vigra_invariant(entries_.size() < (std::size_t)rootFlag(),
+                "RankedUnionFindArray: Need more labels than can be represented in the index type.");
+        entries_.push_back(rootFlag());
+        return (T)(entries_.size() - 1);
+    }
+
+    bool isRoot(T label) const
+    {
+        return (entries_[(IndexType)label] & rootFlag()) != 0;
+    }
+
+    T find(T label) const
+    {
+        for(;;)
+        {
+            T parent = entries_[(IndexType)label];
+            if(parent & rootFlag())
+                return label;
+            T grandparent = entries_[(IndexType)parent];
+            if(grandparent & rootFlag())
+                return parent;
+            // path halving: link every other node to its grandparent
+            entries_[(IndexType)label] = grandparent;
+            label = grandparent;
+        }
+    }
+
+    T makeUnion(T l1, T l2)
+    {
+        l1 = find(l1);
+        l2 = find(l2);
+        if(l1 == l2)
+            return l1;
+        T rank1 = entries_[(IndexType)l1] & ~rootFlag(),
+          rank2 = entries_[(IndexType)l2] & ~rootFlag();
+        if(rank1 < rank2)
+        {
+            entries_[(IndexType)l1] = l2;
+            return l2;
+        }
+        entries_[(IndexType)l2] = l1;
+        if(rank1 == rank2)
+            entries_[(IndexType)l1] = rootFlag() | (rank1 + 1);
+        return l1;
+    }
+
+    unsigned int makeContiguous()
+    {
+        IndexType size = (IndexType)entries_.size();
+        // link every element directly to its root
+        for(IndexType i = 0; i < size; ++i)
+            if(!isRoot((T)i))
+                entries_[i] = find((T)i);
+        // number the roots consecutively in index order
+        unsigned int count = 0;
+        for(IndexType i = 0; i < size; ++i)
+            if(isRoot((T)i))
+                entries_[i] = rootFlag() | (T)count++;
+        // propagate the root labels and clear the flags
+        for(IndexType i = 0; i < size; ++i)
+            if(!(entries_[i] & rootFlag()))
+                entries_[i] = entries_[(IndexType)entries_[i]] & ~rootFlag();
+        for(IndexType i = 0; i < size; ++i)
+            entries_[i] = entries_[i] & ~rootFlag();
+        return count;
+    }
+
+    // Non-destructive counterpart of makeContiguous(): fill 'lut' with
+    // the mapping from every element to the final label of its set
+    // (0 ... number of sets - 1, in index order of the sets' roots)
+    // without freezing the structure, so that further merges remain
+    // possible. Returns the number of sets.
+    unsigned int buildCompactingLUT(ArrayVector<T> & lut) const
+    {
+        IndexType size = (IndexType)entries_.size();
+        lut.resize((typename ArrayVector<T>::size_type)size);
+        unsigned int count = 0;
+        for(IndexType i = 0; i < size; ++i)
+            if(isRoot((T)i))
+                lut[i] = (T)count++;
+        for(IndexType i = 0; i < size; ++i)
+            if(!isRoot((T)i))
+                lut[i] = lut[(IndexType)find((T)i)];
+        return count;
+    }
+
+    T operator[](T label) const
+    {
+        return entries_[(IndexType)label];
+    }
+};
+
+typedef RankedUnionFindArray<UInt32> UnionFindArray32;
+
 } // namespace detail
 
 } // namespace vigra
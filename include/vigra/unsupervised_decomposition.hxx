@@ -42,6 +42,7 @@
 #include "matrix.hxx"
 #include "singular_value_decomposition.hxx"
 #include "random.hxx"
+#include "parallel_options.hxx"
 
 namespace vigra
 {
@@ -87,14 +88,27 @@ namespace vigra
 
         \code
         namespace vigra {
-        
+
             template <class U, class C1, class C2, class C3>
             void
             principleComponents(MultiArrayView<2, U, C1> const & features,
-                                MultiArrayView<2, U, C2> fz, 
+                                MultiArrayView<2, U, C2> fz,
                                 MultiArrayView<2, U, C3> zv);
+
+            // multi-threaded variant
+            template <class U, class C1, class C2, class C3>
+            void
+            principleComponents(MultiArrayView<2, U, C1> const & features,
+                                MultiArrayView<2, U, C2> fz,
+                                MultiArrayView<2, U, C3> zv,
+                                ParallelOptions const & options);
         }
         \endcode
+
+        The second variant forwards the given \ref vigra::ParallelOptions
+        "ParallelOptions" to the underlying \ref singularValueDecomposition(),
+        which distributes its work over the requested number of threads
+        (requires OpenMP support, results are independent of the thread count).
         
         <b>Usage:</b>
         \code
@@ -115,11 +129,14 @@ namespace vigra
         double meanSquaredError = squaredNorm(data - model) / numSamples;
         \endcode
    */
+doxygen_overloaded_function(template <...> void principleComponents)
+
 template <class T, class C1, class C2, class C3>
 void
 principleComponents(MultiArrayView<2, T, C1> const & features,
-                    MultiArrayView<2, T, C2> fz, 
-                    MultiArrayView<2, T, C3> zv)
+                    MultiArrayView<2, T, C2> fz,
+                    MultiArrayView<2, T, C3> zv,
+                    ParallelOptions const & parallel_options)
 {
     using namespace linalg; // activate matrix multiplication and arithmetic functions
 
@@ -136,8 +153,8 @@ principleComponents(MultiArrayView<2, T, C1> const & features,
       "principleComponents(): The output matrix zv has to be of dimension numComponents*numSamples.");
 
     Matrix<T> U(numSamples, numFeatures), S(numFeatures, 1), V(numFeatures, numFeatures);
-    singularValueDecomposition(features.transpose(), U, S, V);
-    
+    singularValueDecomposition(features.transpose(), U, S, V, parallel_options);
+
     for(int k=0; k<numComponents; ++k)
     {
         rowVector(zv, k) = columnVector(U, k).transpose() * S(k, 0);
@@ -145,6 +162,15 @@ principleComponents(MultiArrayView<2, T, C1> const & features,
     }
 }
 
+template <class T, class C1, class C2, class C3>
+inline void
+principleComponents(MultiArrayView<2, T, C1> const & features,
+                    MultiArrayView<2, T, C2> fz,
+                    MultiArrayView<2, T, C3> zv)
+{
+    principleComponents(features, fz, zv, ParallelOptions().numThreads(1));
+}
+
 /*****************************************************************/
 /*                                                               */
 /*         probabilistic latent semantic analysis (pLSA)         */
@@ -153,7 +179,116 @@ principleComponents(MultiArrayView<2, T, C1> const & features,
 /*                                                               */
 /*****************************************************************/
 
-   /** \brief Option object for the \ref pLSA algorithm. 
+namespace detail {
+
+    // one EM iteration of pLSA: compute the current model fzv = fz*zv and the
+    // ratio factor = features / (fzv + eps), then apply the multiplicative
+    // updates to zv and fz (in this order, since the fz update uses the new zv)
+    //
+    // The zv update is partitioned over the sample axis, the fz update over the
+    // feature axis. Every output element is computed by exactly one thread in
+    // the serial summation order, so the result is identical for any number
+    // of threads.
+template <class U, class C1, class C2, class C3>
+void plsaEMUpdate(MultiArrayView<2, U, C1> const & features,
+                  MultiArrayView<2, U, C2> fz, MultiArrayView<2, U, C3> zv,
+                  linalg::Matrix<U> & fzv, linalg::Matrix<U> & factor,
+                  double eps, int num_threads)
+{
+    const MultiArrayIndex numFeatures   = rowCount(features),
+                          numSamples    = columnCount(features),
+                          numComponents = columnCount(fz);
+
+#ifdef _OPENMP
+    if(num_threads > 1 && numSamples > 1)
+    {
+        std::string errorMessage;
+# pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(MultiArrayIndex j = 0; j < numSamples; ++j)
+        {
+            try
+            {
+                for(MultiArrayIndex i = 0; i < numFeatures; ++i)
+                {
+                    U m = NumericTraits<U>::zero();
+                    for(MultiArrayIndex k = 0; k < numComponents; ++k)
+                        m += fz(i,k)*zv(k,j);
+                    fzv(i,j) = m;
+                    factor(i,j) = features(i,j) / (fzv(i,j) + (U)eps);
+                }
+                for(MultiArrayIndex k = 0; k < numComponents; ++k)
+                {
+                    U s = NumericTraits<U>::zero();
+                    for(MultiArrayIndex i = 0; i < numFeatures; ++i)
+                        s += fz(i,k)*factor(i,j);
+                    zv(k,j) *= s;
+                }
+            }
+            catch(std::exception & e)
+            {
+# pragma omp critical(vigra_plsa_em_error)
+                errorMessage = e.what();
+            }
+        }
+# pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(MultiArrayIndex i = 0; i < numFeatures; ++i)
+        {
+            try
+            {
+                for(MultiArrayIndex k = 0; k < numComponents; ++k)
+                {
+                    U s = NumericTraits<U>::zero();
+                    for(MultiArrayIndex j = 0; j < numSamples; ++j)
+                        s += factor(i,j)*zv(k,j);
+                    fz(i,k) *= s;
+                }
+            }
+            catch(std::exception & e)
+            {
+# pragma omp critical(vigra_plsa_em_error)
+                errorMessage = e.what();
+            }
+        }
+        if(!errorMessage.empty())
+            vigra_fail("pLSA(): worker thread failed with:\n" + errorMessage);
+    }
+    else
+#endif // _OPENMP
+    {
+        for(MultiArrayIndex j = 0; j < numSamples; ++j)
+        {
+            for(MultiArrayIndex i = 0; i < numFeatures; ++i)
+            {
+                U m = NumericTraits<U>::zero();
+                for(MultiArrayIndex k = 0; k < numComponents; ++k)
+                    m += fz(i,k)*zv(k,j);
+                fzv(i,j) = m;
+                factor(i,j) = features(i,j) / (fzv(i,j) + (U)eps);
+            }
+            for(MultiArrayIndex k = 0; k < numComponents; ++k)
+            {
+                U s = NumericTraits<U>::zero();
+                for(MultiArrayIndex i = 0; i < numFeatures; ++i)
+                    s += fz(i,k)*factor(i,j);
+                zv(k,j) *= s;
+            }
+        }
+        for(MultiArrayIndex i = 0; i < numFeatures; ++i)
+        {
+            for(MultiArrayIndex k = 0; k < numComponents; ++k)
+            {
+                U s = NumericTraits<U>::zero();
+                for(MultiArrayIndex j = 0; j < numSamples; ++j)
+                    s += factor(i,j)*zv(k,j);
+                fz(i,k) *= s;
+            }
+        }
+    }
+}
+
+} // namespace detail
+
+   /** \brief Option object for the \ref pLSA algorithm.
    */
 class PLSAOptions
 {
@@ -163,7 +298,8 @@ class PLSAOptions
     PLSAOptions()
     : min_rel_gain(1e-4),
       max_iterations(50),
-      normalized_component_weights(true)
+      normalized_component_weights(true),
+      parallel_options(ParallelOptions().numThreads(1))
     {}
 
         /** Maximum number of iterations which is performed by the pLSA algorithm.
@@ -203,9 +339,24 @@ class PLSAOptions
         return *this;
     }
 
+        /** Perform the EM updates in parallel.
+
+            When a \ref vigra::ParallelOptions "ParallelOptions" object
+            requesting more than one thread is passed (and VIGRA was compiled
+            with OpenMP support), the E/M update of every iteration is
+            distributed over the given number of threads. The default
+            (one thread) reproduces the sequential algorithm exactly.
+        */
+    PLSAOptions & parallelOptions(ParallelOptions const & opt)
+    {
+        parallel_options = opt;
+        return *this;
+    }
+
     double min_rel_gain;
     int max_iterations;
     bool normalized_component_weights;
+    ParallelOptions parallel_options;
 };
 
    /** \brief Decompose a matrix according to the pLSA algorithm. 
@@ -326,20 +477,18 @@ pLSA(MultiArrayView<2, U, C1> const & features,
     Matrix<U> columnSums(1, numSamples);
     features.sum(columnSums);
     Matrix<U> expandedSums = ones<U>(numFeatures, 1) * columnSums;
-    
+
+    Matrix<U> fzv(numFeatures, numSamples), factor(numFeatures, numSamples);
     while(iteration < options.max_iterations && (lastChange > options.min_rel_gain))
     {
-        Matrix<U> fzv = fz*zv;
-        
         //if(iteration%25 == 0)
         //{
             //std::cout << "iteration: " << iteration << std::endl;
             //std::cout << "last relative change: " << lastChange << std::endl;
         //}
 
-        Matrix<U> factor = features / pointWise(fzv + (U)eps);
-        zv *= (fz.transpose() * factor);
-        fz *= (factor * zv.transpose());
+        vigra::detail::plsaEMUpdate(features, fz, zv, fzv, factor, eps,
+                             options.parallel_options.getNumThreads());
         prepareColumns(fz, fz, UnitSum);
         prepareColumns(zv, zv, UnitSum);
 
@@ -45,6 +45,7 @@
 #include "seededregiongrowing.hxx"
 #include "functorexpression.hxx"
 #include "union_find.hxx"
+#include "parallel_options.hxx"
 
 namespace vigra {
 
@@ -690,10 +691,184 @@ inline unsigned int
 watershedsUnionFind(triple<SrcIterator, SrcIterator, SrcAccessor> src,
            pair<DestIterator, DestAccessor> dest)
 {
-    return watershedsUnionFind(src.first, src.second, src.third, 
+    return watershedsUnionFind(src.first, src.second, src.third,
                                 dest.first, dest.second);
 }
 
+/** \brief Multi-threaded variant of \ref watershedsUnionFind().
+
+    The image is divided into one horizontal strip per thread. Every thread
+    computes the flow directions of its strip (with a one-row halo, so the
+    orientation of the strip's border rows is identical to the sequential
+    result) and labels the strip's basins with \ref watershedLabeling().
+    Basins crossing the strip seams are then merged with a global
+    union-find over the flow directions of the seam rows, and a parallel
+    relabeling pass maps all pixels to the merged, contiguous label range.
+    The result is identical to the sequential \ref watershedsUnionFind().
+
+    \code
+    vigra::FImage gradMag(w, h);
+    vigra::IImage labeling(w, h);
+
+    int max_region_label =
+        watershedsUnionFind(srcImageRange(gradMag), destImage(labeling),
+                            ParallelOptions().numThreads(8));
+    \endcode
+
+    Without OpenMP support, or when one thread is requested, this simply
+    calls the sequential algorithm.
+*/
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor,
+          class Neighborhood>
+unsigned int
+watershedsUnionFind(SrcIterator upperlefts, SrcIterator lowerrights, SrcAccessor sa,
+                    DestIterator upperleftd, DestAccessor da,
+                    Neighborhood neighborhood, ParallelOptions const & options)
+{
+#ifdef _OPENMP
+    typedef typename DestAccessor::value_type LabelType;
+
+    int w = lowerrights.x - upperlefts.x;
+    int h = lowerrights.y - upperlefts.y;
+    int num_threads = options.getNumThreads();
+    if(num_threads > h)
+        num_threads = h;
+    if(num_threads > 1 && w > 0)
+    {
+        // pass 1: per strip, compute the flow directions (with a one-row
+        // halo to get the sequential border treatment right) and label the
+        // strip's basins with strip-local labels 1...counts[t]
+        ArrayVector<int> bounds((unsigned int)num_threads + 1),
+                         halo_begin((unsigned int)num_threads);
+        for(int t = 0; t <= num_threads; ++t)
+            bounds[t] = (int)(((long long)h * t) / num_threads);
+        ArrayVector<unsigned int> counts((unsigned int)num_threads, 0u);
+        ArrayVector<SImage> orientation((unsigned int)num_threads);
+        std::string errorMessage;
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(int t = 0; t < num_threads; ++t)
+        {
+            try
+            {
+                halo_begin[t] = std::max(0, bounds[t] - 1);
+                int halo_end = std::min(h, bounds[t+1] + 1);
+                orientation[t].resize(w, halo_end - halo_begin[t]);
+                prepareWatersheds(upperlefts + Diff2D(0, halo_begin[t]),
+                                  upperlefts + Diff2D(w, halo_end), sa,
+                                  orientation[t].upperLeft(), orientation[t].accessor(),
+                                  neighborhood);
+                counts[t] = watershedLabeling(
+                                orientation[t].upperLeft() + Diff2D(0, bounds[t] - halo_begin[t]),
+                                orientation[t].upperLeft() + Diff2D(w, bounds[t+1] - halo_begin[t]),
+                                orientation[t].accessor(),
+                                upperleftd + Diff2D(0, bounds[t]), da, neighborhood);
+            }
+            catch(std::exception & e)
+            {
+#pragma omp critical(vigra_watersheds_error)
+                if(errorMessage.empty())
+                    errorMessage = e.what();
+            }
+        }
+        if(!errorMessage.empty())
+            vigra_fail("watershedsUnionFind(): worker thread failed with:\n" + errorMessage);
+
+        ArrayVector<unsigned int> offsets((unsigned int)num_threads + 1, 0u);
+        for(int t = 0; t < num_threads; ++t)
+            offsets[t+1] = offsets[t] + counts[t];
+        unsigned int total = offsets[num_threads];
+        vigra_invariant(total < (unsigned int)NumericTraits<LabelType>::max(),
+                "watershedsUnionFind(): Need more labels than can be represented in the destination type.");
+
+        // pass 2: merge basins crossing the strip seams
+        detail::UnionFindArray<LabelType> label((LabelType)(total + 1));
+        NeighborOffsetCirculator<Neighborhood> ncstart(Neighborhood::CausalFirst),
+                                               ncend(Neighborhood::CausalLast);
+        ++ncend;
+        for(int t = 1; t < num_threads; ++t)
+        {
+            int y = bounds[t];
+            SImage::const_traverser otop = orientation[t-1].upperLeft()
+                                               + Diff2D(0, (y-1) - halo_begin[t-1]),
+                                    obot = orientation[t].upperLeft()
+                                               + Diff2D(0, y - halo_begin[t]);
+            SImage::Accessor oa = orientation[t].accessor();
+            DestIterator dtop = upperleftd + Diff2D(0, y - 1),
+                         dbot = upperleftd + Diff2D(0, y);
+            for(int x = 0; x < w; ++x, ++otop.x, ++obot.x, ++dtop.x, ++dbot.x)
+            {
+                for(NeighborOffsetCirculator<Neighborhood> nc(ncstart); nc != ncend; ++nc)
+                {
+                    if((*nc).y == 0)            // western neighbor: already
+                        continue;               // handled inside the strip
+                    if(x + (*nc).x < 0 || x + (*nc).x >= w)
+                        continue;
+                    if((oa(obot) & nc.directionBit()) ||
+                       (oa(otop, Diff2D((*nc).x, 0)) & nc.oppositeDirectionBit()))
+                    {
+                        label.makeUnion(
+                            (LabelType)(da(dtop, Diff2D((*nc).x, 0)) + offsets[t-1]),
+                            (LabelType)(da(dbot) + offsets[t]));
+                    }
+                }
+            }
+        }
+        unsigned int count = label.makeContiguous();
+
+        // pass 3: map all pixels to the merged, contiguous label range
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(int t = 0; t < num_threads; ++t)
+        {
+            DestIterator yd = upperleftd + Diff2D(0, bounds[t]);
+            for(int y = bounds[t]; y < bounds[t+1]; ++y, ++yd.y)
+            {
+                typename DestIterator::row_iterator xd = yd.rowIterator();
+                for(int x = 0; x < w; ++x, ++xd)
+                    da.set(label[(LabelType)(da(xd) + offsets[t])], xd);
+            }
+        }
+        return count;
+    }
+#endif
+    return watershedsUnionFind(upperlefts, lowerrights, sa,
+                               upperleftd, da, neighborhood);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline unsigned int
+watershedsUnionFind(SrcIterator upperlefts, SrcIterator lowerrights, SrcAccessor sa,
+                    DestIterator upperleftd, DestAccessor da,
+                    ParallelOptions const & options)
+{
+    return watershedsUnionFind(upperlefts, lowerrights, sa,
+                               upperleftd, da, EightNeighborCode(), options);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor,
+          class Neighborhood>
+inline unsigned int
+watershedsUnionFind(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                    pair<DestIterator, DestAccessor> dest,
+                    Neighborhood neighborhood, ParallelOptions const & options)
+{
+    return watershedsUnionFind(src.first, src.second, src.third,
+                               dest.first, dest.second, neighborhood, options);
+}
+
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline unsigned int
+watershedsUnionFind(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                    pair<DestIterator, DestAccessor> dest,
+                    ParallelOptions const & options)
+{
+    return watershedsUnionFind(src.first, src.second, src.third,
+                               dest.first, dest.second, EightNeighborCode(), options);
+}
+
 /** \brief Options object for watershedsRegionGrowing().
 
     <b> Usage:</b>
@@ -1010,7 +1185,11 @@ class BiasedWatershedStatistics
          <tt>[0, ..., bucket_count-1]</tt>, where <tt>bucket_count</tt> is specified in
          the options object), it only supports complete growing (no contour between regions
          is possible), and it handles plateaus in a simplistic way. It also saves some
-         memory because it allocates less temporary storage.
+         memory because it allocates less temporary storage. When the boundary
+         indicator is an 8-bit unsigned integer image, all its values are valid
+         bucket indices, and the turbo algorithm is selected automatically
+         (unless contours are requested); flooding then runs in O(n) without
+         any heap operations.
     <li> Whether one region (label) is to be preferred or discouraged by biasing its cost 
          with a given factor (smaller than 1 for preference, larger than 1 for discouragement).
     </ul>
@@ -1199,22 +1378,37 @@ watershedsRegionGrowing(SrcIterator upperlefts, SrcIterator lowerrights, SrcAcce
         // create a statistics functor for region growing
         detail::WatershedStatistics<ValueType, LabelType> regionstats;
 
+        // 8-bit unsigned height maps can always be flooded through the
+        // bucket queue, because every pixel value is a valid bucket index;
+        // select the O(n) turbo algorithm automatically in that case
+        // (the biased branch above is excluded, since biasing can scale
+        // costs beyond the value range)
+        bool integral_heights =
+            IsSameType<typename NumericTraits<ValueType>::isIntegral,
+                       VigraTrueType>::value &&
+            sizeof(ValueType) == 1 &&
+            NumericTraits<ValueType>::min() == ValueType();
+
         // perform region growing, starting from the seeds computed above
-        if(options.bucket_count == 0)
+        if(options.bucket_count == 0 &&
+           (!integral_heights || (options.terminate & KeepContours) != 0))
         {
-            max_region_label = 
+            max_region_label =
             seededRegionGrowing(srcIterRange(upperlefts, lowerrights, sa),
                                 srcIter(upperleftd, da),
-                                destIter(upperleftd, da), 
+                                destIter(upperleftd, da),
                                 regionstats, options.terminate, neighborhood, options.max_cost);
         }
         else
         {
-            max_region_label = 
+            std::ptrdiff_t bucket_count = options.bucket_count == 0
+                       ? (std::ptrdiff_t)NumericTraits<ValueType>::max() + 1
+                       : (std::ptrdiff_t)options.bucket_count;
+            max_region_label =
             fastSeededRegionGrowing(srcIterRange(upperlefts, lowerrights, sa),
-                                    destIter(upperleftd, da), 
-                                    regionstats, options.terminate, 
-                                    neighborhood, options.max_cost, options.bucket_count);
+                                    destIter(upperleftd, da),
+                                    regionstats, options.terminate,
+                                    neighborhood, options.max_cost, bucket_count);
         }
     }
     
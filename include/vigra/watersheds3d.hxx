@@ -42,6 +42,8 @@
 #include "labelvolume.hxx"
 #include "seededregiongrowing3d.hxx"
 #include "watersheds.hxx"
+#include "array_vector.hxx"
+#include "parallel_options.hxx"
 
 namespace vigra
 {
@@ -237,6 +239,218 @@ unsigned int watershedLabeling3D( SrcIterator s_Iter, SrcShape srcShape, SrcAcce
     return count;
 }
 
+template <class SrcIterator, class SrcAccessor, class SrcShape,
+          class DestIterator, class DestAccessor, class Neighborhood3D>
+int preparewatersheds3D( SrcIterator s_Iter, SrcShape srcShape, SrcAccessor sa,
+                         int z0, int z1,
+                         DestIterator d_Iter, DestAccessor da, Neighborhood3D)
+{
+    //like preparewatersheds3D() above, but restricted to the slab of
+    //z-slices [z0, z1) -- border checks remain relative to the full volume,
+    //so neighbors across the slab boundaries are taken into account
+    int w = srcShape[0], h = srcShape[1], d = srcShape[2];
+    int x,y,z, local_min_count=0;
+
+    //declare and define Iterators for all three dims at src
+    SrcIterator zs = s_Iter;
+    SrcIterator ys(zs);
+    SrcIterator xs(ys);
+
+    //Declare Iterators for all three dims at dest
+    DestIterator zd = d_Iter;
+
+    for(z = 0; z != z0; ++z, ++zs.dim2(), ++zd.dim2())
+    {}
+
+    for(z = z0; z != z1; ++z, ++zs.dim2(), ++zd.dim2())
+    {
+        ys = zs;
+        DestIterator yd(zd);
+
+        for(y = 0; y != h; ++y, ++ys.dim1(), ++yd.dim1())
+        {
+            xs = ys;
+            DestIterator xd(yd);
+
+            for(x = 0; x != w; ++x, ++xs.dim0(), ++xd.dim0())
+            {
+                AtVolumeBorder atBorder = isAtVolumeBorder(x,y,z,w,h,d);
+                typename SrcAccessor::value_type v = sa(xs);
+                int o = 0; // means center is minimum
+                typename SrcAccessor::value_type my_v = v;
+                if(atBorder == NotAtBorder)
+                {
+                    NeighborhoodCirculator<SrcIterator, Neighborhood3D>  c(xs), cend(c);
+
+                    do {
+                        if(sa(c) < v)
+                        {
+                            v = sa(c);
+                            o = c.directionBit();
+                        }
+                        else if(sa(c) == my_v && my_v == v)
+                        {
+                            o =  o | c.directionBit();
+                        }
+                    }
+                    while(++c != cend);
+                }
+                else
+                {
+                    RestrictedNeighborhoodCirculator<SrcIterator, Neighborhood3D>  c(xs, atBorder), cend(c);
+                    do {
+                        if(sa(c) < v)
+                        {
+                            v = sa(c);
+                            o = c.directionBit();
+                        }
+                        else if(sa(c) == my_v && my_v == v)
+                        {
+                            o =  o | c.directionBit();
+                        }
+                    }
+                    while(++c != cend);
+                }
+                if (o==0) local_min_count++;
+                da.set(o, xd);
+            }//end x-iteration
+        }//end y-iteration
+    }//end z-iteration
+    return local_min_count;
+}
+
+template <class OrientationType,
+          class SrcIterator, class SrcAccessor, class SrcShape,
+          class DestIterator, class DestAccessor,
+          class Neighborhood3D>
+unsigned int watersheds3DBlockwise( SrcIterator s_Iter, SrcShape srcShape, SrcAccessor sa,
+                                    DestIterator d_Iter, DestAccessor da,
+                                    Neighborhood3D neighborhood3D,
+                                    ParallelOptions const & options)
+{
+    typedef typename DestAccessor::value_type LabelType;
+    typedef MultiArrayShape<3>::type Shape3;
+
+    int w = srcShape[0], h = srcShape[1], d = srcShape[2];
+
+    int block_depth = options.getBlockSize(d);
+    int block_count = (int)((d + block_depth - 1) / block_depth);
+
+    vigra::MultiArray<3, OrientationType> orientationVolume(Shape3(w, h, d));
+
+    // pass 1: compute the DAG of directions to minima slab by slab and
+    //         flood each slab independently with slab-local labels
+    //         1...counts[b] (the causal border treatment of
+    //         watershedLabeling3D() automatically confines the union-find
+    //         to the slab)
+    ArrayVector<unsigned int> counts(block_count, 0u);
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic) num_threads(options.getNumThreads())
+#endif
+    for(int b = 0; b < block_count; ++b)
+    {
+        int z0 = b * block_depth,
+            z1 = std::min(z0 + block_depth, d);
+
+        preparewatersheds3D( s_Iter, srcShape, sa, z0, z1,
+                             destMultiArray(orientationVolume).first, destMultiArray(orientationVolume).second,
+                             neighborhood3D);
+
+        MultiArrayView<3, OrientationType> slab =
+            orientationVolume.subarray(Shape3(0, 0, z0), Shape3(w, h, z1));
+
+        DestIterator zd = d_Iter;
+        for(int z = 0; z != z0; ++z)
+            ++zd.dim2();
+
+        counts[b] = watershedLabeling3D( srcMultiArray(slab).first, slab.shape(), srcMultiArray(slab).second,
+                                         zd, da,
+                                         neighborhood3D);
+    }
+
+    ArrayVector<unsigned int> offsets(block_count + 1, 0u);
+    for(int b = 0; b < block_count; ++b)
+        offsets[b+1] = offsets[b] + counts[b];
+    unsigned int total = offsets[block_count];
+    vigra_invariant(total < (unsigned int)NumericTraits<LabelType>::max(),
+            "watersheds3D(): Need more labels than can be represented in the destination type.");
+
+    // pass 2: merge regions crossing the slab boundaries through a global
+    //         union-find over the offset labels, using the same edge
+    //         criterion as watershedLabeling3D() restricted to the causal
+    //         directions that cross the seam plane
+    detail::UnionFindArray<LabelType> mergedLabels((LabelType)(total + 1));
+    {
+        DestIterator zd = d_Iter;
+        int z = 0;
+        for(int b = 1; b < block_count; ++b)
+        {
+            int z0 = b * block_depth;
+            for(; z != z0; ++z)
+                ++zd.dim2();
+
+            DestIterator yd(zd);
+            for(int y = 0; y != h; ++y, ++yd.dim1())
+            {
+                DestIterator xd(yd);
+                for(int x = 0; x != w; ++x, ++xd.dim0())
+                {
+                    NeighborOffsetCirculator<Neighborhood3D> nc(Neighborhood3D::CausalFirst);
+                    NeighborOffsetCirculator<Neighborhood3D> nce(Neighborhood3D::CausalLast);
+                    ++nce;
+                    do
+                    {
+                        if((*nc)[2] == -1 &&
+                           x + (*nc)[0] >= 0 && x + (*nc)[0] < w &&
+                           y + (*nc)[1] >= 0 && y + (*nc)[1] < h)
+                        {
+                            //   Direction of NTraversr       Neighbor's direction bit is pointing
+                            // = Direction of voxel           towards us?
+                            if((orientationVolume(x, y, z0) & nc.directionBit()) ||
+                               (orientationVolume(x + (*nc)[0], y + (*nc)[1], z0 - 1) & nc.oppositeDirectionBit()))
+                            {
+                                mergedLabels.makeUnion(
+                                    (LabelType)(da(xd, *nc) + offsets[b-1]),
+                                    (LabelType)(da(xd) + offsets[b]));
+                            }
+                        }
+                        ++nc;
+                    } while(nc != nce);
+                }
+            }
+        }
+    }
+    unsigned int count = mergedLabels.makeContiguous();
+
+    // pass 3: relabel each slab through the merged, contiguous mapping
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic) num_threads(options.getNumThreads())
+#endif
+    for(int b = 0; b < block_count; ++b)
+    {
+        int z0 = b * block_depth,
+            z1 = std::min(z0 + block_depth, d);
+
+        DestIterator zd = d_Iter;
+        for(int z = 0; z != z0; ++z)
+            ++zd.dim2();
+
+        for(int z = z0; z != z1; ++z, ++zd.dim2())
+        {
+            DestIterator yd(zd);
+            for(int y = 0; y != h; ++y, ++yd.dim1())
+            {
+                DestIterator xd(yd);
+                for(int x = 0; x != w; ++x, ++xd.dim0())
+                {
+                    da.set(mergedLabels[(LabelType)(da(xd) + offsets[b])], xd);
+                }
+            }
+        }
+    }
+    return count;
+}
+
 
 /** \addtogroup SeededRegionGrowing
 */
@@ -550,12 +764,109 @@ inline unsigned int watersheds3DSix( vigra::triple<SrcIterator, SrcShape, SrcAcc
 
 template <class SrcIterator, class SrcShape, class SrcAccessor,
           class DestIterator, class DestAccessor>
-inline unsigned int watersheds3DTwentySix( vigra::triple<SrcIterator, SrcShape, SrcAccessor> src, 
+inline unsigned int watersheds3DTwentySix( vigra::triple<SrcIterator, SrcShape, SrcAccessor> src,
                                            vigra::pair<DestIterator, DestAccessor> dest)
 {
     return watersheds3D(src.first, src.second, src.third, dest.first, dest.second, NeighborCode3DTwentySix());
 }
 
+/** \brief Block-parallel region segmentation by means of the watershed algorithm.
+
+    This overload of \ref watersheds3D() decomposes the volume into slabs of
+    z-slices whose depth is determined by \ref vigra::ParallelOptions::getBlockSize().
+    Every slab is flooded independently (in parallel when the library is
+    compiled with OpenMP and <tt>options.getNumThreads() > 1</tt>), regions
+    crossing the slab boundaries are merged through a global union-find over
+    the seam planes, and a final parallel pass maps the slab-local labels to
+    the merged, contiguous ones. The result is identical to the sequential
+    \ref watersheds3D(): regions are numbered 1, 2, ... in scan order of
+    their first voxel.
+
+    When <tt>options.getNumThreads() <= 1</tt> or the volume is too shallow
+    for a block decomposition, the function falls back to the sequential
+    algorithm.
+
+    <b> Declarations:</b>
+
+    \code
+    namespace vigra {
+        template <class SrcIterator, class SrcAccessor,class SrcShape,
+                  class DestIterator, class DestAccessor,
+                  class Neighborhood3D>
+        unsigned int watersheds3D(SrcIterator s_Iter, SrcShape srcShape, SrcAccessor sa,
+                                  DestIterator d_Iter, DestAccessor da,
+                                  Neighborhood3D neighborhood3D,
+                                  ParallelOptions const & options);
+
+        template <class SrcIterator, class SrcShape, class SrcAccessor,
+                  class DestIterator, class DestAccessor>
+        unsigned int watersheds3DSix(triple<SrcIterator, SrcShape, SrcAccessor> src,
+                                     pair<DestIterator, DestAccessor> dest,
+                                     ParallelOptions const & options);
+
+        template <class SrcIterator, class SrcShape, class SrcAccessor,
+                  class DestIterator, class DestAccessor>
+        unsigned int watersheds3DTwentySix(triple<SrcIterator, SrcShape, SrcAccessor> src,
+                                           pair<DestIterator, DestAccessor> dest,
+                                           ParallelOptions const & options);
+    }
+    \endcode
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/watersheds3D.hxx\><br>
+    Namespace: vigra
+
+    \code
+    // find 6-connected regions with (up to) 4 threads
+    int max_region_label = vigra::watersheds3DSix(srcMultiArrayRange(src), destMultiArray(dest),
+                                                  ParallelOptions().numThreads(4));
+    \endcode
+*/
+template <class SrcIterator, class SrcAccessor, class SrcShape,
+          class DestIterator, class DestAccessor,
+          class Neighborhood3D>
+unsigned int watersheds3D( SrcIterator s_Iter, SrcShape srcShape, SrcAccessor sa,
+                           DestIterator d_Iter, DestAccessor da, Neighborhood3D neighborhood3D,
+                           ParallelOptions const & options)
+{
+    int d = srcShape[2];
+
+    if(options.getNumThreads() <= 1 || options.getBlockSize(d) >= d)
+        return watersheds3D(s_Iter, srcShape, sa, d_Iter, da, neighborhood3D);
+
+    if ((int)Neighborhood3D::DirectionCount>7){  //If we have 3D-TwentySix Neighborhood
+
+        return watersheds3DBlockwise<int>(s_Iter, srcShape, sa, d_Iter, da,
+                                          neighborhood3D, options);
+    }
+    else{
+
+        return watersheds3DBlockwise<unsigned char>(s_Iter, srcShape, sa, d_Iter, da,
+                                                    neighborhood3D, options);
+    }
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline unsigned int watersheds3DSix( vigra::triple<SrcIterator, SrcShape, SrcAccessor> src,
+                                     vigra::pair<DestIterator, DestAccessor> dest,
+                                     ParallelOptions const & options)
+{
+    return watersheds3D(src.first, src.second, src.third, dest.first, dest.second,
+                        NeighborCode3DSix(), options);
+}
+
+template <class SrcIterator, class SrcShape, class SrcAccessor,
+          class DestIterator, class DestAccessor>
+inline unsigned int watersheds3DTwentySix( vigra::triple<SrcIterator, SrcShape, SrcAccessor> src,
+                                           vigra::pair<DestIterator, DestAccessor> dest,
+                                           ParallelOptions const & options)
+{
+    return watersheds3D(src.first, src.second, src.third, dest.first, dest.second,
+                        NeighborCode3DTwentySix(), options);
+}
+
 }//namespace vigra
 
 #endif //VIGRA_watersheds3D_HXX
@@ -52,7 +52,7 @@ namespace vigra {
     /*!
      *  \class WignerMatrix 
      *  \brief computation of Wigner D matrix + rotation functions 
-     *         in SH,VH and R�
+     *         in SH,VH and R�
      *
      * All rotations in Euler zyz' convention   
      *
@@ -286,8 +286,103 @@ WignerMatrix<Real>::compute_D(int l)
     }
 }
 
+    /*!
+     *  \class WignerMatrixCache
+     *  \brief persistent cache of Wigner D matrices (theta = pi/2)
+     *
+     * \ref WignerMatrix is not thread safe and recomputes its matrices per
+     * instance, which dominates the run time when rotation-invariant features
+     * are extracted at many voxels. This cache computes the D matrices for the
+     * fixed rotation theta = pi/2, phi = 0, psi = 0 (the building block of the
+     * usual zyz' factorization) once up to a configurable band limit, after
+     * which they can be read concurrently from any number of threads.
+     *
+     * Call ensureBandLimit() before entering a parallel region - it serializes
+     * internally and is a no-op when the requested band limit is already
+     * covered. Afterwards, get_D() only reads the precomputed matrices and is
+     * therefore safe for concurrent use.
+     *
+     * A process-wide instance is available via WignerMatrixCache::global().
+     */
+template <class Real>
+class WignerMatrixCache
+{
+  public:
+    typedef typename WignerMatrix<Real>::Complex Complex;
+
+         /*! \brief Create an empty cache (band limit 0).
+          */
+    WignerMatrixCache()
+    : wigner_(0),
+      band_limit_(0)
+    {}
+
+         /*! \brief Make sure all D matrices up to band \a l_max are available.
+          *
+          * Matrices are computed at most once - calls with a band limit that
+          * is already covered return immediately. This function must not be
+          * called concurrently with get_D() on the same cache.
+          */
+    void ensureBandLimit(int l_max)
+    {
+        vigra_precondition(l_max >= 1,
+            "WignerMatrixCache::ensureBandLimit(): band limit must be >= 1.");
+#ifdef _OPENMP
+#pragma omp critical(vigra_wigner_matrix_cache)
+#endif
+        {
+            if(l_max > band_limit_)
+            {
+                WignerMatrix<Real> wigner(l_max);
+                wigner.compute_D(l_max);
+                wigner_ = wigner;
+                band_limit_ = l_max;
+            }
+        }
+    }
+
+         /*! \brief Highest band for which D matrices have been computed.
+          */
+    int bandLimit() const
+    {
+        return band_limit_;
+    }
+
+         /*! \brief  Get the (n,m) entry of the cached D for band \a l.
+          */
+    Complex get_D(int l, int n, int m) const
+    {
+        vigra_precondition(l <= band_limit_,
+            "WignerMatrixCache::get_D(): band exceeds the cached band limit, "
+            "call ensureBandLimit() first.");
+        return wigner_.get_D(l, n, m);
+    }
+
+         /*! \brief Return the cached rotation matrix D for the lth band.
+          */
+    Matrix<Complex> const & get_D(int l) const
+    {
+        vigra_precondition(l <= band_limit_,
+            "WignerMatrixCache::get_D(): band exceeds the cached band limit, "
+            "call ensureBandLimit() first.");
+        return wigner_.get_D(l);
+    }
+
+         /*! \brief The process-wide cache instance.
+          */
+    static WignerMatrixCache & global()
+    {
+        static WignerMatrixCache cache;
+        return cache;
+    }
+
+  private:
+    WignerMatrix<Real> wigner_;
+    int band_limit_;
+};
+
 template <class Real>
-void 
+void
 WignerMatrix<Real>::rotatePH(NestedArray const & PH, Real phi, Real theta, Real psi,
                              NestedArray & PHresult)
 {
@@ -39,6 +39,7 @@
 #include "vigra/sized_int.hxx"
 #include "error.hxx"
 #include "void_vector.hxx"
+#include "mapped_file.hxx"
 #include "byteorder.hxx"
 #include "bmp.hxx"
 
@@ -230,6 +231,12 @@ struct BmpDecoderImpl
     void_vector< UInt8 > pixels;
     void_vector< UInt8 > map;
 
+    // memory-mapped data source; uncompressed true color files are
+    // served directly from the mapped pages (zero copy)
+    mapped_file mapping;
+    const UInt8 * map_base;
+    unsigned int map_line_size;
+
     int scanline;
 
     // this flag is figured out from the info header's bit_count
@@ -286,6 +293,24 @@ BmpDecoderImpl::BmpDecoderImpl( const std::string & filename )
         read_colormap ();
 
     data_read = false;
+
+    // try to map uncompressed true color files; the scanlines are then
+    // handed out bottom-up from the mapped pages, and the file's BGR
+    // component order is undone in currentScanlineOfBand()
+    map_base = 0;
+    map_line_size = 0;
+    if ( info_header.bit_count == 24 && info_header.compression == 0 ) {
+        const unsigned int line_size = 3 * info_header.width;
+        // lines are padded to a 32 bit boundary
+        map_line_size = line_size
+            + (( line_size % 4 ) ? 4 - ( line_size % 4 ) : 0);
+        const std::size_t data_size
+            = (std::size_t)map_line_size * info_header.height;
+        if ( mapping.open( filename ) &&
+             mapping.size() >= file_header.offset + data_size )
+            map_base = mapping.data() + file_header.offset
+                + (std::size_t)map_line_size * ( info_header.height - 1 );
+    }
 }
 
 void BmpDecoderImpl::read_data ()
@@ -830,8 +855,39 @@ unsigned int BmpDecoder::getOffset() const
     return pimpl->grayscale ? 1 : 3;
 }
 
+bool BmpDecoder::supportsDirectRead() const
+{
+    // direct reads deliver the bytes of the mapped file
+    return pimpl->map_base != 0;
+}
+
+void BmpDecoder::readDirect( unsigned char * dest, std::ptrdiff_t rowStride )
+{
+    vigra_precondition( pimpl->map_base != 0,
+        "BmpDecoder::readDirect(): file is not mapped." );
+
+    // the mapped rows are stored bottom-up; undo the file's BGR
+    // component order while copying
+    const int width = pimpl->info_header.width;
+    const int height = pimpl->info_header.height;
+    for ( int y = 0; y < height; ++y ) {
+        const UInt8 * src = pimpl->map_base
+            - (std::size_t)y * pimpl->map_line_size;
+        unsigned char * d = dest + y * rowStride;
+        for ( int x = 0; x < width; ++x, src += 3, d += 3 ) {
+            d[0] = src[2];
+            d[1] = src[1];
+            d[2] = src[0];
+        }
+    }
+}
+
 const void * BmpDecoder::currentScanlineOfBand( unsigned int band ) const
 {
+    if (pimpl->map_base != 0)
+        return pimpl->map_base
+            - (std::size_t)pimpl->scanline * pimpl->map_line_size
+            + ( 2 - band );
     if (!pimpl->data_read)
         pimpl->read_data ();
     return pimpl->pixels.data() + band
@@ -111,10 +111,15 @@ namespace vigra
         for( iter_type iter = ext.begin(); iter < ext.end(); ++iter )
             extensionMap[*iter] = desc.fileType;
 
-        // fill magic vector
+        // fill magic vector and the first-byte dispatch table
         for( VIGRA_CSTD::size_t i = 0; i < desc.magicStrings.size(); ++i )
+        {
             magicStrings.push_back( std::pair<std::vector<char>, std::string>
                                     ( desc.magicStrings[i],desc.fileType ) );
+            if( !desc.magicStrings[i].empty() )
+                magicTable[(unsigned char)desc.magicStrings[i][0]]
+                    .push_back( magicStrings.size() - 1 );
+        }
         // fill factory map
         factoryMap[desc.fileType] = cf;
     }
@@ -205,14 +210,39 @@ namespace vigra
         stream.read( fmagic, magiclen );
         stream.close();
 
-        // compare with the known magic strings
-        typedef std::vector< std::pair< std::vector<char>, std::string > >
-            magic_type;
-        for( magic_type::const_iterator iter = magicStrings.begin();
-             iter < magicStrings.end(); ++iter ) {
-            const std::vector<char> & magic = iter->first;
+        // only the codecs indexed under the first magic byte can match
+        const std::vector<std::size_t> & candidates
+            = magicTable[(unsigned char)fmagic[0]];
+        typedef std::vector<std::size_t>::const_iterator iter_type;
+        for( iter_type iter = candidates.begin();
+             iter < candidates.end(); ++iter ) {
+            const std::vector<char> & magic = magicStrings[*iter].first;
             if ( std::equal( magic.begin(), magic.end(), fmagic ) )
-                return iter->second;
+                return magicStrings[*iter].second;
+        }
+
+        // did not find a matching string
+        return std::string();
+    }
+
+    std::string
+    CodecManager::getFileTypeByMagicString( const unsigned char * data,
+                                            std::size_t size )
+        const
+    {
+        if( size == 0 )
+            return std::string();
+
+        // only the codecs indexed under the first magic byte can match
+        const std::vector<std::size_t> & candidates = magicTable[data[0]];
+        typedef std::vector<std::size_t>::const_iterator iter_type;
+        for( iter_type iter = candidates.begin();
+             iter < candidates.end(); ++iter ) {
+            const std::vector<char> & magic = magicStrings[*iter].first;
+            if ( magic.size() <= size &&
+                 std::equal( magic.begin(), magic.end(),
+                             reinterpret_cast<const char *>(data) ) )
+                return magicStrings[*iter].second;
         }
 
         // did not find a matching string
@@ -252,6 +282,35 @@ namespace vigra
         return dec;
     }
 
+    // look up decoder from the list, then initialize it
+    // from an in-memory byte buffer
+    VIGRA_UNIQUE_PTR<Decoder>
+    CodecManager::getDecoder( const unsigned char * data, std::size_t size,
+                              const std::string & filetype ) const
+    {
+        std::string fileType = filetype;
+
+        if ( fileType == "undefined" ) {
+
+            fileType = getFileTypeByMagicString(data, size);
+            vigra_precondition( !fileType.empty(),
+                                "did not find a matching file type." );
+        }
+
+        // return a codec factory by the file type
+        std::map< std::string, CodecFactory * >::const_iterator search
+            = factoryMap.find(fileType);
+        vigra_precondition( search != factoryMap.end(),
+        "did not find a matching codec for the given filetype" );
+
+        // okay, we can return a decoder
+        VIGRA_UNIQUE_PTR<Decoder> dec = search->second->getDecoder();
+        vigra_precondition( dec->supportsMemoryInit(),
+        "the codec for the given filetype does not support in-memory decoding" );
+        dec->initFromMemory(data, size);
+        return dec;
+    }
+
     // look up encoder from the list, then return it
     std::string
     CodecManager::getEncoderType( const std::string & filename,
@@ -303,6 +362,13 @@ namespace vigra
         return codecManager().getDecoder( filename, filetype, imageindex );
     }
 
+    // get a decoder for an in-memory byte buffer
+    VIGRA_UNIQUE_PTR<Decoder>
+    getDecoder( const unsigned char * data, std::size_t size, const std::string & filetype )
+    {
+        return codecManager().getDecoder( data, size, filetype );
+    }
+
     // get an encoder type
     std::string
     getEncoderType( const std::string & filename, const std::string & filetype )
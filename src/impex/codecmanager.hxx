@@ -52,6 +52,10 @@ namespace vigra
         std::map< std::string, std::string > extensionMap;
         std::map< std::string, CodecFactory * > factoryMap;
 
+        // index into magicStrings by the first magic byte, so that file
+        // type detection only inspects the codecs whose magic can match
+        std::vector<std::size_t> magicTable[256];
+
     public:
 
         // singleton pattern
@@ -81,6 +85,11 @@ namespace vigra
                     const std::string & fileType = "undefined",
                     unsigned int imageIndex = 0 ) const;
 
+        // as above, but decode from an in-memory byte buffer
+        VIGRA_UNIQUE_PTR<Decoder>
+        getDecoder( const unsigned char * data, std::size_t size,
+                    const std::string & fileType = "undefined" ) const;
+
         // look up encoder type from the list
         std::string
         getEncoderType( const std::string & fileName,
@@ -96,6 +105,10 @@ namespace vigra
         // try to figure out the correct file type
         std::string getFileTypeByMagicString( const std::string & filename ) const;
 
+        // as above, but inspect an in-memory byte buffer
+        std::string getFileTypeByMagicString( const unsigned char * data,
+                                              std::size_t size ) const;
+
     private:
 
         // this will only be called by the singleton pattern
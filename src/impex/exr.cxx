@@ -51,6 +51,9 @@
 #include <ImfStringAttribute.h>
 #include <ImfMatrixAttribute.h>
 #include <ImfArray.h>
+#include <ImfThreading.h>
+
+#include <algorithm>
 
 using namespace Imf;
 using namespace Imath;
@@ -119,7 +122,7 @@ namespace vigra {
         // auto_file file;
 
         // this is where libopenexr stores its state
-        RgbaInputFile file;
+        RgbaInputFile * file;
 
         // data container
         ArrayVector<Rgba> pixels;
@@ -138,36 +141,42 @@ namespace vigra {
 
         float x_resolution, y_resolution;
 
+        // number of IlmImf worker threads, and the scanline block
+        // read per readPixels() call (one line unless setNumThreads()
+        // requests parallel decoding)
+        int num_threads;
+        int blockheight, blocktop, blockend;
+
         // ctor, dtor
         ExrDecoderImpl( const std::string & filename );
         ~ExrDecoderImpl();
 
         // methods
         void init();
+        void setNumThreads( int numThreads );
         void nextScanline();
     };
 
     ExrDecoderImpl::ExrDecoderImpl( const std::string & filename )
-#ifdef VIGRA_NEED_BIN_STREAMS
-        : file( filename.c_str() ),
-#else
-        : file( filename.c_str() ),
-#endif
+        : filename(filename),
+          file( new RgbaInputFile( filename.c_str() ) ),
           bands(0),
           scanline(-1), width(0), height(0),
           components(4), extra_components(1),
-          x_resolution(0), y_resolution(0)
+          x_resolution(0), y_resolution(0),
+          num_threads(0), blockheight(1), blocktop(0), blockend(0)
     {
     }
 
     ExrDecoderImpl::~ExrDecoderImpl()
     {
+        delete file;
     }
 
     void ExrDecoderImpl::init()
     {
         // setup framebuffer
-        Box2i dw = file.header().dataWindow();
+        Box2i dw = file->header().dataWindow();
         width  = dw.max.x - dw.min.x + 1;
         height = dw.max.y - dw.min.y + 1;
 
@@ -175,28 +184,68 @@ namespace vigra {
         scanline = dw.min.y;
         position.y = dw.min.y;
 
-        dw = file.header().displayWindow();
+        // force a read on the first nextScanline()
+        blockend = scanline;
+
+        dw = file->header().displayWindow();
         canvasSize.x = dw.max.x+1;
         canvasSize.y = dw.max.y+1;
 
         // allocate data buffers
-        pixels.resize(width);
+        pixels.resize(width * blockheight);
         bands.resize(4*width);
     }
 
+    void ExrDecoderImpl::setNumThreads( int numThreads )
+    {
+        if (numThreads < 1)
+            numThreads = 1;
+        num_threads = numThreads;
+
+        // the global pool must be at least as big as the per-file request
+        int poolThreads = numThreads;
+        try {
+            if (globalThreadCount() < poolThreads)
+                setGlobalThreadCount(poolThreads);
+        }
+        catch (std::exception &) {
+            // the library was built without threading support
+            poolThreads = 0;
+        }
+
+        // reopen the file so that the new thread count takes effect
+        delete file;
+        file = 0;
+        file = new RgbaInputFile( filename.c_str(), poolThreads );
+
+        // read enough scanlines per readPixels() call to keep all threads
+        // busy (the compressed blocks are up to 32 scanlines high)
+        blockheight = std::min(32 * numThreads, height);
+        if (blockheight < 1)
+            blockheight = 1;
+        pixels.resize(width * blockheight);
+    }
+
     void ExrDecoderImpl::nextScanline()
     {
-        file.setFrameBuffer (pixels.data() - position.x - scanline * width, 1, width);
-        file.readPixels (scanline, scanline);
-        scanline++;
-        // convert scanline to float
+        if ( scanline >= blockend ) {
+            // read the next block of scanlines in a single call, so that
+            // the IlmImf thread pool decompresses its chunks in parallel
+            blocktop = scanline;
+            blockend = std::min(blocktop + blockheight, position.y + height);
+            file->setFrameBuffer (pixels.data() - position.x - blocktop * width, 1, width);
+            file->readPixels (blocktop, blockend - 1);
+        }
+        // convert the current scanline to float
+        const Rgba * src = pixels.data() + (scanline - blocktop) * width;
         float * dest = bands.begin();
         for (int i=0; i < width; i++) {
-            *dest++ = pixels[i].r;
-            *dest++ = pixels[i].g;
-            *dest++ = pixels[i].b;
-            *dest++ = pixels[i].a;
+            *dest++ = src[i].r;
+            *dest++ = src[i].g;
+            *dest++ = src[i].b;
+            *dest++ = src[i].a;
         }
+        scanline++;
     }
 
     void ExrDecoder::init( const std::string & filename )
@@ -265,6 +314,11 @@ namespace vigra {
         return pimpl->components;
     }
 
+    void ExrDecoder::setNumThreads( int numThreads )
+    {
+        pimpl->setNumThreads(numThreads);
+    }
+
     const void * ExrDecoder::currentScanlineOfBand( unsigned int band ) const
     {
         return pimpl->bands.begin() + band;
@@ -308,6 +362,12 @@ namespace vigra {
         // resolution
         float x_resolution, y_resolution;
 
+        // number of IlmImf worker threads, and the scanline block
+        // written per writePixels() call (one line unless
+        // setNumThreads() requests parallel encoding)
+        int num_threads;
+        int blockheight, blockfill;
+
         // ctor, dtor
         ExrEncoderImpl( const std::string & filename );
         ~ExrEncoderImpl();
@@ -316,13 +376,15 @@ namespace vigra {
         void nextScanline();
         void finalize();
         void setCompressionType( const std::string &, int );
+        void setNumThreads( int numThreads );
         void close();
     };
 
     ExrEncoderImpl::ExrEncoderImpl( const std::string & filename )
         : filename(filename), file(0), bands(0),
           exrcomp(PIZ_COMPRESSION), scanline(0), finalized(false),
-          x_resolution(0), y_resolution(0)
+          x_resolution(0), y_resolution(0),
+          num_threads(0), blockheight(1), blockfill(0)
     {
     }
 
@@ -334,9 +396,16 @@ namespace vigra {
 
     void ExrEncoderImpl::finalize()
     {
+        // write enough scanlines per writePixels() call to keep all
+        // threads busy (the compressed blocks are up to 32 scanlines high)
+        if (num_threads > 0)
+            blockheight = std::min(32 * num_threads, height);
+        if (blockheight < 1)
+            blockheight = 1;
+
         // prepare the bands
         bands.resize( 4 * width );
-        pixels.resize(width);
+        pixels.resize(width * blockheight);
 
         // set proper position
         Imath::Box2i displayWindow;
@@ -356,7 +425,7 @@ namespace vigra {
         Imath::Box2i dataWindow (Imath::V2i (position.x , position.y),
                                  Imath::V2i (width+position.x -1, height+position.y-1));
         Header header(displayWindow, dataWindow, 1, Imath::V2f(0, 0), 1, INCREASING_Y, exrcomp);
-        file = new RgbaOutputFile(filename.c_str(), header, WRITE_RGBA);
+        file = new RgbaOutputFile(filename.c_str(), header, WRITE_RGBA, num_threads);
         // enter finalized state
         finalized = true;
     }
@@ -366,15 +435,24 @@ namespace vigra {
         // check if there are scanlines left at all, eventually write one
         if ( scanline < height ) {
             float * src = bands.data();
+            Rgba * dest = pixels.data() + blockfill * width;
             for (int i=0; i < width; i++) {
                 // convert to half
-                pixels[i].r = *src++;
-                pixels[i].g = *src++;
-                pixels[i].b = *src++;
-                pixels[i].a = *src++;
+                dest[i].r = *src++;
+                dest[i].g = *src++;
+                dest[i].b = *src++;
+                dest[i].a = *src++;
+            }
+            blockfill++;
+
+            // write the buffered scanlines in a single call, so that the
+            // IlmImf thread pool compresses its chunks in parallel
+            if ( blockfill == blockheight || scanline == height - 1 ) {
+                int blocktop = scanline - blockfill + 1;
+                file->setFrameBuffer (pixels.begin() - position.x -(blocktop+position.y)*width, 1, width);
+                file->writePixels (blockfill);
+                blockfill = 0;
             }
-            file->setFrameBuffer (pixels.begin() - position.x -(scanline+position.y)*width, 1, width);
-            file->writePixels (1);
         }
         scanline++;
     }
@@ -398,6 +476,23 @@ namespace vigra {
 #endif
     }
 
+    void ExrEncoderImpl::setNumThreads( int numThreads )
+    {
+        if (numThreads < 1)
+            numThreads = 1;
+        num_threads = numThreads;
+
+        // the global pool must be at least as big as the per-file request
+        try {
+            if (globalThreadCount() < numThreads)
+                setGlobalThreadCount(numThreads);
+        }
+        catch (std::exception &) {
+            // the library was built without threading support
+            num_threads = 0;
+        }
+    }
+
     void ExrEncoderImpl::close()
     {
         delete file;
@@ -469,6 +564,12 @@ namespace vigra {
         pimpl->y_resolution = yres;
     }
 
+    void ExrEncoder::setNumThreads( int numThreads )
+    {
+        VIGRA_IMPEX_FINALIZED(pimpl->finalized);
+        pimpl->setNumThreads(numThreads);
+    }
+
     void ExrEncoder::setPixelType( const std::string & pixelType )
     {
         VIGRA_IMPEX_FINALIZED(pimpl->finalized);
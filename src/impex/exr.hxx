@@ -81,6 +81,8 @@ namespace vigra {
 
         unsigned int getOffset() const;
 
+        void setNumThreads( int );
+
         const void * currentScanlineOfBand( unsigned int ) const;
         void nextScanline();
     };
@@ -112,6 +114,7 @@ namespace vigra {
         void setCanvasSize( const Size2D & pos );
         void setXResolution( float xres );
         void setYResolution( float yres );
+        void setNumThreads( int );
 
         void finalizeSettings();
 
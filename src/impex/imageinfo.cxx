@@ -324,7 +324,8 @@ bool isImage(char const * filename)
 ImageExportInfo::ImageExportInfo( const char * filename, const char * mode )
     : m_filename(filename), m_mode(mode),
       m_x_res(0), m_y_res(0),
-      fromMin_(0.0), fromMax_(0.0), toMin_(0.0), toMax_(0.0)
+      fromMin_(0.0), fromMax_(0.0), toMin_(0.0), toMax_(0.0),
+      m_num_threads(0)
 {}
 
 ImageExportInfo::~ImageExportInfo()
@@ -471,6 +472,17 @@ ImageExportInfo & ImageExportInfo::setICCProfile(
     return *this;
 }
 
+ImageExportInfo & ImageExportInfo::setNumThreads( int numThreads )
+{
+    m_num_threads = numThreads;
+    return *this;
+}
+
+int ImageExportInfo::getNumThreads() const
+{
+    return m_num_threads;
+}
+
 // return an encoder for a given ImageExportInfo object
 VIGRA_UNIQUE_PTR<Encoder> encoder( const ImageExportInfo & info )
 {
@@ -540,13 +552,28 @@ VIGRA_UNIQUE_PTR<Encoder> encoder( const ImageExportInfo & info )
         enc->setICCProfile(info.getICCProfile());
     }
 
+    if ( info.getNumThreads() > 0 ) {
+        enc->setNumThreads(info.getNumThreads());
+    }
+
     return enc;
 }
 
 // class ImageImportInfo
 
 ImageImportInfo::ImageImportInfo( const char * filename, unsigned int imageIndex )
-    : m_filename(filename), m_image_index(imageIndex)
+    : m_filename(filename),
+      m_mem_data(0), m_mem_size(0),
+      m_image_index(imageIndex),
+      m_num_threads(0)
+{
+    readHeader_();
+}
+
+ImageImportInfo::ImageImportInfo( const void * data, std::size_t size )
+    : m_mem_data(data), m_mem_size(size),
+      m_image_index(0),
+      m_num_threads(0)
 {
     readHeader_();
 }
@@ -559,6 +586,16 @@ const char * ImageImportInfo::getFileName() const
     return m_filename.c_str();
 }
 
+const void * ImageImportInfo::getMemoryData() const
+{
+    return m_mem_data;
+}
+
+std::size_t ImageImportInfo::getMemorySize() const
+{
+    return m_mem_size;
+}
+
 const char * ImageImportInfo::getFileType() const
 {
     return m_filetype.c_str();
@@ -626,6 +663,17 @@ int ImageImportInfo::getImageIndex() const
     return m_image_index;
 }
 
+ImageImportInfo & ImageImportInfo::setNumThreads( int numThreads )
+{
+    m_num_threads = numThreads;
+    return *this;
+}
+
+int ImageImportInfo::getNumThreads() const
+{
+    return m_num_threads;
+}
+
 Size2D ImageImportInfo::size() const
 {
     return Size2D( m_width, m_height );
@@ -651,6 +699,11 @@ bool ImageImportInfo::isByte() const
     return m_pixeltype == "UINT8";
 }
 
+bool ImageImportInfo::supportsRegionRead() const
+{
+    return m_supports_region_read;
+}
+
 Diff2D ImageImportInfo::getPosition() const
 {
     return m_pos;
@@ -678,7 +731,11 @@ const ImageImportInfo::ICCProfile & ImageImportInfo::getICCProfile() const
 
 void ImageImportInfo::readHeader_()
 {
-    VIGRA_UNIQUE_PTR<Decoder> decoder = getDecoder(m_filename, "undefined", m_image_index);
+    VIGRA_UNIQUE_PTR<Decoder> decoder;
+    if ( m_mem_data != 0 )
+        decoder = getDecoder(static_cast<const unsigned char *>(m_mem_data), m_mem_size);
+    else
+        decoder = getDecoder(m_filename, "undefined", m_image_index);
     m_num_images = decoder->getNumImages();
 
     m_filetype = decoder->getFileType();
@@ -693,6 +750,7 @@ void ImageImportInfo::readHeader_()
     m_y_res = decoder->getYResolution();
 
     m_icc_profile = decoder->getICCProfile();
+    m_supports_region_read = decoder->supportsRegionRead();
 
     decoder->abort(); // there probably is no better way than this
 }
@@ -702,7 +760,17 @@ VIGRA_UNIQUE_PTR<Decoder> decoder( const ImageImportInfo & info )
 {
     std::string filetype = info.getFileType();
     validate_filetype(filetype);
-    return getDecoder( std::string( info.getFileName() ), filetype, info.getImageIndex() );
+    VIGRA_UNIQUE_PTR<Decoder> dec;
+    if ( info.getMemoryData() != 0 )
+        dec = getDecoder( static_cast<const unsigned char *>(info.getMemoryData()),
+                          info.getMemorySize(), filetype );
+    else
+        dec = getDecoder( std::string( info.getFileName() ), filetype, info.getImageIndex() );
+
+    if ( info.getNumThreads() > 0 )
+        dec->setNumThreads(info.getNumThreads());
+
+    return dec;
 }
 
 // class VolumeExportInfo
@@ -0,0 +1,157 @@
+/************************************************************************/
+/*                                                                      */
+/*               Copyright 2012 by Ullrich Koethe                       */
+/*                                                                      */
+/*    This file is part of the VIGRA computer vision library.           */
+/*    The VIGRA Website is                                              */
+/*        http://hci.iwr.uni-heidelberg.de/vigra/                       */
+/*    Please direct questions, bug reports, and contributions to        */
+/*        ullrich.koethe@iwr.uni-heidelberg.de    or                    */
+/*        vigra@informatik.uni-hamburg.de                               */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+#ifndef VIGRA_IMPEX_MAPPED_FILE_HXX
+#define VIGRA_IMPEX_MAPPED_FILE_HXX
+
+#include <cstddef>
+#include <string>
+
+#include "vigra/sized_int.hxx"
+
+#ifdef _WIN32
+#include "vigra/windows.h"
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace vigra {
+
+    // RAII wrapper around a read-only memory mapping of a whole file.
+    // Codecs use it to serve uncompressed pixel data directly from the
+    // mapped pages instead of copying through buffered streams. Failure
+    // to map is not an error: open() simply returns false, and the
+    // caller falls back to stream reads.
+    class mapped_file
+    {
+        const UInt8 * data_;
+        std::size_t size_;
+#ifdef _WIN32
+        HANDLE file_, mapping_;
+#endif
+
+        // mappings cannot be copied
+        mapped_file( const mapped_file & );
+        mapped_file & operator=( const mapped_file & );
+
+    public:
+
+        mapped_file()
+            : data_(0), size_(0)
+#ifdef _WIN32
+            , file_(INVALID_HANDLE_VALUE), mapping_(0)
+#endif
+        {}
+
+        ~mapped_file()
+        {
+#ifdef _WIN32
+            if ( data_ != 0 )
+                UnmapViewOfFile( (LPVOID)data_ );
+            if ( mapping_ != 0 )
+                CloseHandle( mapping_ );
+            if ( file_ != INVALID_HANDLE_VALUE )
+                CloseHandle( file_ );
+#else
+            if ( data_ != 0 )
+                ::munmap( const_cast< UInt8 * >(data_), size_ );
+#endif
+        }
+
+        // map the given file read-only; returns false if the file
+        // cannot be opened, is empty, or mapping is impossible
+        bool open( const std::string & filename )
+        {
+#ifdef _WIN32
+            file_ = CreateFileA( filename.c_str(), GENERIC_READ,
+                                 FILE_SHARE_READ, 0, OPEN_EXISTING,
+                                 FILE_ATTRIBUTE_NORMAL, 0 );
+            if ( file_ == INVALID_HANDLE_VALUE )
+                return false;
+            DWORD size_high = 0;
+            DWORD size_low = GetFileSize( file_, &size_high );
+            if ( size_low == INVALID_FILE_SIZE || size_high != 0 ||
+                 size_low == 0 )
+                return false;
+            mapping_ = CreateFileMappingA( file_, 0, PAGE_READONLY,
+                                           0, 0, 0 );
+            if ( mapping_ == 0 )
+                return false;
+            data_ = static_cast< const UInt8 * >(
+                        MapViewOfFile( mapping_, FILE_MAP_READ, 0, 0, 0 ) );
+            if ( data_ != 0 )
+                size_ = size_low;
+            return data_ != 0;
+#else
+            int fd = ::open( filename.c_str(), O_RDONLY );
+            if ( fd < 0 )
+                return false;
+            struct stat st;
+            if ( ::fstat( fd, &st ) == 0 && st.st_size > 0 ) {
+                void * p = ::mmap( 0, st.st_size, PROT_READ, MAP_SHARED,
+                                   fd, 0 );
+                if ( p != MAP_FAILED ) {
+                    data_ = static_cast< const UInt8 * >(p);
+                    size_ = st.st_size;
+                }
+            }
+            ::close( fd );
+            return data_ != 0;
+#endif
+        }
+
+        bool good() const
+        {
+            return data_ != 0;
+        }
+
+        const UInt8 * data() const
+        {
+            return data_;
+        }
+
+        std::size_t size() const
+        {
+            return size_;
+        }
+    };
+
+} // namespace vigra
+
+#endif // VIGRA_IMPEX_MAPPED_FILE_HXX
@@ -53,6 +53,7 @@
 #include "error.hxx"
 #include <stdexcept>
 #include <iostream>
+#include <cstring>
 
 extern "C"
 {
@@ -101,8 +102,11 @@ namespace vigra {
         desc.pixelTypes[1] = "UINT16";
 
         // init compression types
-        desc.compressionTypes.resize(1);
+        desc.compressionTypes.resize(4);
         desc.compressionTypes[0] = "LOSSLESS";
+        desc.compressionTypes[1] = "FAST";
+        desc.compressionTypes[2] = "BEST";
+        desc.compressionTypes[3] = "NONE";
 
         // init magic strings
         desc.magicStrings.resize(1);
@@ -137,8 +141,10 @@ namespace vigra {
 
     struct PngDecoderImpl
     {
-        // data source
-        auto_file file;
+        // data source: either a file or a caller-owned memory buffer
+        auto_file * file;
+        const unsigned char * mem_data;
+        std::size_t mem_size, mem_pos;
 
         // data container
         void_vector_base bands;
@@ -175,31 +181,26 @@ namespace vigra {
 
         // ctor, dtor
         PngDecoderImpl( const std::string & filename );
+        PngDecoderImpl( const unsigned char * data, std::size_t size );
         ~PngDecoderImpl();
 
         // methods
         void init();
         void nextScanline();
+
+    private:
+
+        // shared part of both constructors
+        void createReadStruct();
+
+        // read callback handing out bytes of the memory buffer
+        static void readMemory( png_structp png, png_bytep data,
+                                png_size_t length );
     };
 
-    PngDecoderImpl::PngDecoderImpl( const std::string & filename )
-#ifdef VIGRA_NEED_BIN_STREAMS
-        // Returns the layer
-        : file( filename.c_str(), "rb" ),
-#else
-        : file( filename.c_str(), "r" ),
-#endif
-          bands(0), iccProfileLength(0), iccProfilePtr(0),
-          scanline(-1), x_resolution(0), y_resolution(0),
-          n_interlace_passes(0), n_channels(0)
+    void PngDecoderImpl::createReadStruct()
     {
         png_error_message = "";
-        // check if the file is a png file
-        const unsigned int sig_size = 8;
-        png_byte sig[sig_size];
-        std::size_t readCount = std::fread( sig, sig_size, 1, file.get() );
-        const int no_png = png_sig_cmp( sig, 0, sig_size );
-        vigra_precondition( (readCount == 1) && !no_png, "given file is not a png file.");
 
         // create png read struct with user defined handlers
         png = png_create_read_struct( PNG_LIBPNG_VER_STRING, NULL,
@@ -213,13 +214,46 @@ namespace vigra {
         }
         info = png_create_info_struct(png);
         vigra_postcondition( info != 0, "could not create the info struct." );
+    }
+
+    void PngDecoderImpl::readMemory( png_structp png, png_bytep data,
+                                     png_size_t length )
+    {
+        PngDecoderImpl * impl
+            = static_cast<PngDecoderImpl *>(png_get_io_ptr(png));
+        if ( impl->mem_pos + length > impl->mem_size )
+            png_error( png, "read past the end of the memory buffer" );
+        std::memcpy( data, impl->mem_data + impl->mem_pos, length );
+        impl->mem_pos += length;
+    }
+
+    PngDecoderImpl::PngDecoderImpl( const std::string & filename )
+#ifdef VIGRA_NEED_BIN_STREAMS
+        // Returns the layer
+        : file( new auto_file( filename.c_str(), "rb" ) ),
+#else
+        : file( new auto_file( filename.c_str(), "r" ) ),
+#endif
+          mem_data(0), mem_size(0), mem_pos(0),
+          bands(0), iccProfileLength(0), iccProfilePtr(0),
+          scanline(-1), x_resolution(0), y_resolution(0),
+          n_interlace_passes(0), n_channels(0)
+    {
+        // check if the file is a png file
+        const unsigned int sig_size = 8;
+        png_byte sig[sig_size];
+        std::size_t readCount = std::fread( sig, sig_size, 1, file->get() );
+        const int no_png = png_sig_cmp( sig, 0, sig_size );
+        vigra_precondition( (readCount == 1) && !no_png, "given file is not a png file.");
+
+        createReadStruct();
 
         // init png i/o
         if (setjmp(png_jmpbuf(png))) {
             png_destroy_read_struct( &png, &info, NULL );
             vigra_postcondition( false, png_error_message.insert(0, "error in png_init_io(): ").c_str() );
         }
-        png_init_io( png, file.get() );
+        png_init_io( png, file->get() );
 
         // specify that the signature was already read
         if (setjmp(png_jmpbuf(png))) {
@@ -230,9 +264,36 @@ namespace vigra {
 
     }
 
+    PngDecoderImpl::PngDecoderImpl( const unsigned char * data,
+                                    std::size_t size )
+        : file(0),
+          mem_data(data), mem_size(size), mem_pos(0),
+          bands(0), iccProfileLength(0), iccProfilePtr(0),
+          scanline(-1), x_resolution(0), y_resolution(0),
+          n_interlace_passes(0), n_channels(0)
+    {
+        // check if the buffer holds a png stream
+        const unsigned int sig_size = 8;
+        const int no_png = size < sig_size ||
+            png_sig_cmp( const_cast<png_bytep>(data), 0, sig_size );
+        vigra_precondition( !no_png, "given buffer is not a png stream.");
+
+        createReadStruct();
+
+        // read from the memory buffer instead of a file; the
+        // signature is re-read through the callback, so it must
+        // not be skipped here
+        if (setjmp(png_jmpbuf(png))) {
+            png_destroy_read_struct( &png, &info, NULL );
+            vigra_postcondition( false, png_error_message.insert(0, "error in png_set_read_fn(): ").c_str() );
+        }
+        png_set_read_fn( png, this, &readMemory );
+    }
+
     PngDecoderImpl::~PngDecoderImpl()
     {
         png_destroy_read_struct( &png, &info, NULL );
+        delete file;
     }
 
     void PngDecoderImpl::init()
@@ -398,6 +459,25 @@ namespace vigra {
         }
     }
 
+    bool PngDecoder::supportsMemoryInit() const
+    {
+        return true;
+    }
+
+    void PngDecoder::initFromMemory( const unsigned char * data,
+                                     std::size_t size )
+    {
+        pimpl = new PngDecoderImpl(data, size);
+        pimpl->init();
+        if(pimpl->iccProfileLength)
+        {
+            Decoder::ICCProfile iccData(
+                pimpl->iccProfilePtr,
+                pimpl->iccProfilePtr + pimpl->iccProfileLength);
+            iccProfile_.swap(iccData);
+        }
+    }
+
     PngDecoder::~PngDecoder()
     {
         delete pimpl;
@@ -513,6 +593,12 @@ namespace vigra {
         // state
         bool finalized;
 
+        // speed/ratio tradeoff: zlib level 0-9, or -1 for the libpng default
+        int compression_level;
+
+        // disable the adaptive row filters (fast-store output)
+        bool no_filters;
+
         // image layer position
         Diff2D position;
 
@@ -536,6 +622,7 @@ namespace vigra {
 #endif
           bands(0),
           scanline(0), finalized(false),
+          compression_level(-1), no_filters(false),
           x_resolution(0), y_resolution(0)
     {
         png_error_message = "";
@@ -570,6 +657,14 @@ namespace vigra {
 
     void PngEncoderImpl::finalize()
     {
+        // apply the speed/ratio tradeoff before anything is written
+        if (setjmp(png_jmpbuf(png)))
+            vigra_postcondition( false, png_error_message.insert(0, "error in png_set_compression_level(): ").c_str() );
+        if ( compression_level >= 0 )
+            png_set_compression_level( png, compression_level );
+        if ( no_filters )
+            png_set_filter( png, PNG_FILTER_TYPE_BASE, PNG_FILTER_NONE );
+
         // write the IHDR
         if (setjmp(png_jmpbuf(png)))
             vigra_postcondition( false, png_error_message.insert(0, "error in png_set_IHDR(): ").c_str() );
@@ -689,9 +784,27 @@ namespace vigra {
         pimpl->components = bands;
     }
 
-    void PngEncoder::setCompressionType( const std::string & /* comp */, int /* quality */)
+    void PngEncoder::setCompressionType( const std::string & comp, int quality )
     {
-        // nothing is settable => do nothing
+        VIGRA_IMPEX_FINALIZED(pimpl->finalized);
+
+        // speed/ratio tradeoff: "FAST" stores with minimal deflate
+        // effort and no row filtering (for intermediate results),
+        // "BEST" spends maximal deflate effort, "NONE" stores the
+        // (filtered) raw data; a quality of 1...9 selects the zlib
+        // compression level directly, e.g. via "LOSSLESS QUALITY=2"
+        if ( comp == "FAST" ) {
+            pimpl->compression_level = 1;
+            pimpl->no_filters = true;
+        } else if ( comp == "BEST" ) {
+            pimpl->compression_level = 9;
+        } else if ( comp == "NONE" ) {
+            pimpl->compression_level = 0;
+            pimpl->no_filters = true;
+        } else if ( quality >= 1 && quality <= 9 ) {
+            pimpl->compression_level = quality;
+        }
+        // leave any other specification at the libpng defaults
     }
 
     void PngEncoder::setPosition( const Diff2D & pos )
@@ -73,6 +73,8 @@ namespace vigra {
         ~PngDecoder();
 
         void init( const std::string & );
+        bool supportsMemoryInit() const;
+        void initFromMemory( const unsigned char *, std::size_t );
         void close();
         void abort();
 
@@ -43,6 +43,7 @@
 #include "vigra/sized_int.hxx"
 #include "error.hxx"
 #include "void_vector.hxx"
+#include "mapped_file.hxx"
 #include "pnm.hxx"
 #include "byteorder.hxx"
 
@@ -117,6 +118,13 @@ namespace vigra {
         // data source
         std::ifstream stream;
 
+        // memory-mapped data source; raw 8-bit files are served
+        // directly from the mapped pages (zero copy), all other
+        // variants go through the stream
+        mapped_file map;
+        const UInt8 * mapped_current;
+        const UInt8 * mapped_next;
+
         // image container
         void_vector_base bands;
 
@@ -399,6 +407,16 @@ namespace vigra {
               stream.seekg( -static_cast<streamOffset>(seekOffset), std::ios::end );
           }
         }
+
+        // try to map raw 8-bit files; 16 and 32 bit data is big endian
+        // in the file and would need a conversion copy anyway
+        mapped_current = mapped_next = 0;
+        if ( raw && !bilevel && pixeltype == "UINT8" ) {
+            const std::size_t data_size
+                = (std::size_t)width * height * components;
+            if ( map.open( filename ) && map.size() >= data_size )
+                mapped_next = map.data() + map.size() - data_size;
+        }
     }
 
     void PnmDecoder::init( const std::string & filename )
@@ -441,8 +459,36 @@ namespace vigra {
         return pimpl->components;
     }
 
+    bool PnmDecoder::supportsDirectRead() const
+    {
+        // direct reads deliver the bytes of the mapped file
+        return pimpl->mapped_next != 0;
+    }
+
+    void PnmDecoder::readDirect( unsigned char * dest, std::ptrdiff_t rowStride )
+    {
+        vigra_precondition( pimpl->mapped_next != 0,
+            "PnmDecoder::readDirect(): file is not mapped." );
+
+        const UInt8 * src = pimpl->mapped_next;
+        const std::size_t line_size
+            = (std::size_t)pimpl->width * pimpl->components;
+
+        if ( rowStride == (std::ptrdiff_t)line_size ) {
+            // contiguous destination: one copy for the whole image
+            std::memcpy( dest, src, line_size * pimpl->height );
+        } else {
+            for ( int y = 0; y < pimpl->height; ++y )
+                std::memcpy( dest + y * rowStride,
+                             src + y * line_size, line_size );
+        }
+    }
+
     const void * PnmDecoder::currentScanlineOfBand( unsigned int band ) const
     {
+        if ( pimpl->mapped_current != 0 )
+            return pimpl->mapped_current + band;
+
         if ( pimpl->pixeltype == "UINT8" ) {
             typedef void_vector< UInt8 > bands_type;
             const bands_type & bands
@@ -465,6 +511,12 @@ namespace vigra {
 
     void PnmDecoder::nextScanline()
     {
+        if ( pimpl->mapped_next != 0 ) {
+            pimpl->mapped_current = pimpl->mapped_next;
+            pimpl->mapped_next += pimpl->width * pimpl->components;
+            return;
+        }
+
         if ( pimpl->raw ) {
             if ( pimpl->bilevel ) pimpl->read_bilevel_raw_scanline();
             else pimpl->read_raw_scanline();
@@ -74,6 +74,9 @@ namespace vigra {
         unsigned int getNumBands() const;
         unsigned int getOffset() const;
 
+        bool supportsDirectRead() const;
+        void readDirect( unsigned char *, std::ptrdiff_t );
+
         const void * currentScanlineOfBand( unsigned int ) const;
         void nextScanline();
     };
@@ -274,6 +274,95 @@ void readSIFBlock(const SIFImportInfo &info, Shape3 offset, Shape3 shape, MultiA
     return;
 }
 
+SIFStreamReader::SIFStreamReader(const SIFImportInfo & info, int readAheadFrames)
+: m_filename(info.getFileName()),
+  m_width(info.width()),
+  m_height(info.height()),
+  m_stacksize(info.stacksize()),
+  m_dataOffset(info.getOffset()),
+  m_readAhead(readAheadFrames > 0 ? readAheadFrames : 0),
+  m_bufferBegin(0),
+  m_bufferEnd(0),
+  m_file(info.getFileName(), std::ios::in|std::ios::binary)
+{
+    vigra_precondition(sizeof(float) == 4, "SIF files can only be read into MultiArrayView<float32>. On your machine a float has more than 4 bytes.");
+    vigra_precondition(m_file.is_open(), "Unable to open sif file");
+}
+
+int SIFStreamReader::width() const
+{
+    return m_width;
+}
+
+int SIFStreamReader::height() const
+{
+    return m_height;
+}
+
+int SIFStreamReader::numFrames() const
+{
+    return m_stacksize;
+}
+
+std::ptrdiff_t SIFStreamReader::frameOffset(int frame) const
+{
+    // all frames have the same size, so the file position is an affine
+    // function of the frame index
+    return m_dataOffset + (std::ptrdiff_t)frame * m_width * m_height * 4;
+}
+
+void SIFStreamReader::readFrame(int frame, MultiArrayView<2, float, UnstridedArrayTag> array)
+{
+    vigra_precondition(0 <= frame && frame < m_stacksize,
+            "SIFStreamReader::readFrame(): frame index out of range.");
+    vigra_precondition(array.shape() == Shape2(m_width, m_height),
+            "SIFStreamReader::readFrame(): array must have shape (width x height).");
+
+    size_t frameSize = (size_t)m_width * m_height;
+    byteorder bo = byteorder("little endian");  // SIF file is little-endian
+
+    if(m_readAhead == 0)
+    {
+        m_file.clear();
+        m_file.seekg(frameOffset(frame));
+        read_array( m_file, bo, array.data(), frameSize );
+        return;
+    }
+
+    if(frame < m_bufferBegin || frame >= m_bufferEnd)
+    {
+        // buffer miss: fetch the requested frame together with the
+        // following m_readAhead frames in one file access
+        int end = frame + m_readAhead + 1;
+        if(end > m_stacksize)
+            end = m_stacksize;
+        m_buffer.resize(frameSize * (end - frame));
+        m_file.clear();
+        m_file.seekg(frameOffset(frame));
+        read_array( m_file, bo, m_buffer.begin(), frameSize * (end - frame) );
+        m_bufferBegin = frame;
+        m_bufferEnd = end;
+    }
+    std::memcpy(array.data(), m_buffer.begin() + frameSize * (frame - m_bufferBegin),
+                frameSize * sizeof(float));
+}
+
+void SIFStreamReader::readFrames(int beginFrame, int endFrame, MultiArrayView<3, float, UnstridedArrayTag> array)
+{
+    vigra_precondition(0 <= beginFrame && beginFrame <= endFrame && endFrame <= m_stacksize,
+            "SIFStreamReader::readFrames(): invalid frame range.");
+    vigra_precondition(array.shape() == Shape3(m_width, m_height, endFrame - beginFrame),
+            "SIFStreamReader::readFrames(): array must have shape (width x height x number of frames).");
+    if(beginFrame == endFrame)
+        return;
+
+    byteorder bo = byteorder("little endian");  // SIF file is little-endian
+
+    m_file.clear();
+    m_file.seekg(frameOffset(beginFrame));
+    read_array( m_file, bo, array.data(), (size_t)m_width * m_height * (endFrame - beginFrame) );
+}
+
 std::ostream& operator<<(std::ostream& os, const SIFImportInfo& info)
 {
     // output
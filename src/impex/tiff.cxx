@@ -61,6 +61,8 @@
 #include "vigra/sized_int.hxx"
 #include "error.hxx"
 #include "tiff.hxx"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -218,9 +220,21 @@ namespace vigra {
 
         unsigned int scanline;
 
+        // rectangle delivered through the scanline interface
+        // (defaults to the whole image)
+        Rect2D region;
+
+        // tile organization; tiled files are decoded one tile row at a time
+        bool tiled;
+        uint32 tile_width, tile_height;
+        ArrayVector<UInt8> tilescratch;  // one decoded tile
+        ArrayVector<UInt8> tileblock;    // the region's columns of a tile row
+
         std::string get_pixeltype_by_sampleformat() const;
         std::string get_pixeltype_by_datatype() const;
 
+        void readTileBlock();
+
     public:
 
         TIFFDecoderImpl( const std::string & filename );
@@ -231,6 +245,9 @@ namespace vigra {
         void setImageIndex( unsigned int index );
         unsigned int getImageIndex();
 
+        bool supportsRegionRead() const;
+        void setRegion( const Rect2D & roi );
+
         const void * currentScanlineOfBand( unsigned int band ) const;
         void nextScanline();
     };
@@ -247,6 +264,8 @@ namespace vigra {
         }
 
         scanline = 0;
+        tiled = false;
+        tile_width = tile_height = 0;
     }
 
     std::string TIFFDecoderImpl::get_pixeltype_by_sampleformat() const
@@ -335,13 +354,9 @@ namespace vigra {
         TIFFGetField( tiff, TIFFTAG_IMAGEWIDTH, &width );
         TIFFGetField( tiff, TIFFTAG_IMAGELENGTH, &height );
 
-        // check for tiled TIFFs
-        uint32 tileWidth, tileHeight;
-        if( TIFFGetField( tiff, TIFFTAG_TILEWIDTH, &tileWidth ) &&
-            TIFFGetField( tiff, TIFFTAG_TILELENGTH, &tileHeight ) )
-            vigra_precondition( (tileWidth == width) && (tileHeight == height),
-                                "TIFFDecoderImpl::init(): "
-                                "Cannot read tiled TIFFs (not implemented)." );
+        // check for tiled TIFFs; these are decoded one tile row at a time
+        tiled = TIFFGetField( tiff, TIFFTAG_TILEWIDTH, &tile_width ) &&
+                TIFFGetField( tiff, TIFFTAG_TILELENGTH, &tile_height );
 
         // find out strip heights
         stripheight = 1; // now using scanline interface instead of strip interface
@@ -487,6 +502,18 @@ namespace vigra {
             samples_per_pixel = 3;
         }
 
+        // check the preconditions of the tile reader
+        if ( tiled ) {
+            vigra_precondition( planarconfig != PLANARCONFIG_SEPARATE,
+                                "TIFFDecoderImpl::init(): "
+                                "Cannot read tiled TIFFs with separate planes"
+                                " (not implemented)." );
+            vigra_precondition( bits_per_sample % 8 == 0,
+                                "TIFFDecoderImpl::init(): "
+                                "Cannot read tiled bilevel TIFFs"
+                                " (not implemented)." );
+        }
+
         // other fields
         uint16 u16value;
         uint32 u32value;
@@ -553,29 +580,108 @@ namespace vigra {
         }
 
         // allocate data buffers
-        const unsigned int stripsize = TIFFScanlineSize(tiff);
-        if ( planarconfig == PLANARCONFIG_SEPARATE ) {
-            stripbuffer = new tdata_t[samples_per_pixel];
-            for( unsigned int i = 0; i < samples_per_pixel; ++i ) {
-                stripbuffer[i] = 0;
-            }
-            for( unsigned int i = 0; i < samples_per_pixel; ++i ) {
-                stripbuffer[i] = _TIFFmalloc(stripsize);
-                if(stripbuffer[i] == 0)
+        if ( tiled ) {
+            // whole tiles are decoded into a scratch buffer; the requested
+            // columns are then assembled one tile row at a time
+            tilescratch.resize( TIFFTileSize(tiff) );
+            setRegion( Rect2D( Size2D( width, height ) ) );
+        } else {
+            const unsigned int stripsize = TIFFScanlineSize(tiff);
+            if ( planarconfig == PLANARCONFIG_SEPARATE ) {
+                stripbuffer = new tdata_t[samples_per_pixel];
+                for( unsigned int i = 0; i < samples_per_pixel; ++i ) {
+                    stripbuffer[i] = 0;
+                }
+                for( unsigned int i = 0; i < samples_per_pixel; ++i ) {
+                    stripbuffer[i] = _TIFFmalloc(stripsize);
+                    if(stripbuffer[i] == 0)
+                        throw std::bad_alloc();
+                }
+            } else {
+                stripbuffer = new tdata_t[1];
+                stripbuffer[0] = 0;
+                stripbuffer[0] = _TIFFmalloc(stripsize);
+                if(stripbuffer[0] == 0)
                     throw std::bad_alloc();
             }
-        } else {
-            stripbuffer = new tdata_t[1];
-            stripbuffer[0] = 0;
-            stripbuffer[0] = _TIFFmalloc(stripsize);
-            if(stripbuffer[0] == 0)
-                throw std::bad_alloc();
+
+            // deliver the whole image unless setRegion() is called
+            region = Rect2D( Size2D( width, height ) );
+            scanline = 0;
+
+            // let the codec read a new strip
+            stripindex = stripheight;
         }
+    }
+
+    bool TIFFDecoderImpl::supportsRegionRead() const
+    {
+        // bilevel data is bit-packed and not supported for region reads
+        return bits_per_sample % 8 == 0;
+    }
 
-        // let the codec read a new strip
+    void TIFFDecoderImpl::setRegion( const Rect2D & roi )
+    {
+        vigra_precondition( !roi.isEmpty() &&
+                            Rect2D( Size2D( width, height ) ).contains( roi ),
+                            "TIFFDecoderImpl::setRegion(): "
+                            "region must be non-empty and inside the image." );
+        vigra_precondition( supportsRegionRead(),
+                            "TIFFDecoderImpl::setRegion(): "
+                            "region reads are not supported for bilevel"
+                            " images." );
+
+        region = roi;
+        scanline = roi.top();
+
+        if ( tiled )
+            tileblock.resize( (std::size_t)roi.width() * tile_height *
+                              samples_per_pixel * ( bits_per_sample / 8 ) );
+
+        // let the codec read a new strip resp. tile row
+        stripheight = 1;
         stripindex = stripheight;
     }
 
+    void TIFFDecoderImpl::readTileBlock()
+    {
+        const unsigned int pixelbytes
+            = samples_per_pixel * ( bits_per_sample / 8 );
+
+        // assemble the region's columns of the rows [scanline, blockend)
+        // from the tile row containing the current scanline
+        const uint32 blocktop = ( scanline / tile_height ) * tile_height;
+        uint32 blockend = blocktop + tile_height;
+        if ( blockend > (uint32)region.bottom() )
+            blockend = region.bottom();
+        stripheight = blockend - scanline;
+
+        const uint32 x0 = region.left(), x1 = region.right();
+        for ( uint32 tx = ( x0 / tile_width ) * tile_width; tx < x1;
+              tx += tile_width )
+        {
+            if ( TIFFReadTile( tiff, tilescratch.begin(), tx, blocktop,
+                               0, 0 ) == -1 )
+                vigra_fail( "TIFFDecoderImpl::readTileBlock(): "
+                            "Unable to read TIFF tile." );
+
+            const uint32 cx0 = std::max( x0, tx ),
+                         cx1 = std::min( x1, tx + tile_width );
+            for ( uint32 y = scanline; y < blockend; ++y )
+            {
+                const UInt8 * src = tilescratch.begin() +
+                    ( ( y - blocktop ) * tile_width + ( cx0 - tx ) )
+                    * pixelbytes;
+                UInt8 * dst = tileblock.begin() +
+                    ( ( y - scanline ) * region.width() + ( cx0 - x0 ) )
+                    * pixelbytes;
+                std::memcpy( dst, src, ( cx1 - cx0 ) * pixelbytes );
+            }
+        }
+
+        scanline = blockend;
+    }
+
     const void *
     TIFFDecoderImpl::currentScanlineOfBand( unsigned int band ) const
     {
@@ -585,14 +691,22 @@ namespace vigra {
             // XXX probably wrong
             return buf + ( stripindex * width ) / 8;
         } else {
-            if ( planarconfig == PLANARCONFIG_SEPARATE ) {
+            if ( tiled ) {
+                // tileblock holds the region's columns of the current
+                // tile row
+                return tileblock.begin() +
+                    ( band + stripindex * region.width() * samples_per_pixel )
+                    * ( bits_per_sample / 8 );
+            } else if ( planarconfig == PLANARCONFIG_SEPARATE ) {
                 UInt8 * const buf
                     = static_cast< UInt8 * >(stripbuffer[band]);
-                return buf + ( stripindex * width ) * ( bits_per_sample / 8 );
+                return buf + ( stripindex * width + region.left() )
+                    * ( bits_per_sample / 8 );
             } else {
                 UInt8 * const buf
                     = static_cast< UInt8 * >(stripbuffer[0]);
-                return buf + ( band + stripindex * width * samples_per_pixel )
+                return buf + ( band + ( stripindex * width + region.left() )
+                               * samples_per_pixel )
                     * ( bits_per_sample / 8 );
             }
         }
@@ -600,11 +714,13 @@ namespace vigra {
 
     void TIFFDecoderImpl::nextScanline()
     {
-        // eventually read a new strip
+        // eventually read a new strip or tile row
         if ( ++stripindex >= stripheight ) {
             stripindex = 0;
 
-            if ( planarconfig == PLANARCONFIG_SEPARATE ) {
+            if ( tiled ) {
+                readTileBlock();
+            } else if ( planarconfig == PLANARCONFIG_SEPARATE ) {
                 const tsize_t size = TIFFScanlineSize(tiff);
                 for( unsigned int i = 0; i < samples_per_pixel; ++i )
                     TIFFReadScanline(tiff, stripbuffer[i], scanline++, size);
@@ -618,12 +734,21 @@ namespace vigra {
             if ( photometric == PHOTOMETRIC_MINISWHITE &&
                  samples_per_pixel == 1 && pixeltype == "UINT8" ) {
 
-                UInt8 * buf = static_cast< UInt8 * >(stripbuffer[0]);
-                const unsigned int n = TIFFScanlineSize(tiff);
+                if ( tiled ) {
+                    UInt8 * buf = tileblock.begin();
+                    const unsigned int n = stripheight * region.width();
 
-                // invert every pixel
-                for ( unsigned int i = 0; i < n; ++i, ++buf )
-                    *buf = 0xff - *buf;
+                    // invert every pixel of the assembled tile row
+                    for ( unsigned int i = 0; i < n; ++i, ++buf )
+                        *buf = 0xff - *buf;
+                } else {
+                    UInt8 * buf = static_cast< UInt8 * >(stripbuffer[0]);
+                    const unsigned int n = TIFFScanlineSize(tiff);
+
+                    // invert every pixel
+                    for ( unsigned int i = 0; i < n; ++i, ++buf )
+                        *buf = 0xff - *buf;
+                }
             }
         }
     }
@@ -734,6 +859,16 @@ namespace vigra {
         return TIFFCurrentDirectory(tiff);
     }
 
+    bool TIFFDecoder::supportsRegionRead() const
+    {
+        return pimpl->supportsRegionRead();
+    }
+
+    void TIFFDecoder::setRegion( const Rect2D & roi )
+    {
+        pimpl->setRegion(roi);
+    }
+
     const void * TIFFDecoder::currentScanlineOfBand( unsigned int band ) const
     {
         return pimpl->currentScanlineOfBand(band);
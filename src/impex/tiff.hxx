@@ -89,6 +89,9 @@ namespace vigra {
         float getXResolution() const;
         float getYResolution() const;
 
+        bool supportsRegionRead() const;
+        void setRegion( const Rect2D & );
+
         const void * currentScanlineOfBand( unsigned int ) const;
         void nextScanline();
 
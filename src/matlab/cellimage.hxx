@@ -38,6 +38,7 @@
 
 #include <vigra/basicimage.hxx>
 #include <vigra/pixelneighborhood.hxx>
+#include <vigra/array_vector.hxx>
 #include <functional>
 
 namespace vigra {
@@ -221,6 +222,132 @@ struct RelabelFunctor
     VALUETYPE oldValue_, newValue_;
 };
 
+// -------------------------------------------------------------------
+//                         CellStructureArena
+// -------------------------------------------------------------------
+// Collecting the per-cell geometry of a CellImage cell by cell rescans
+// the whole image once per cell and allocates each record individually.
+// CellStructureArena builds the records for all cells in two scan-order
+// passes instead, storing the cells of each kind (region, line, vertex)
+// in one contiguous array together with an index from cell label to
+// array position. This keeps the construction free of per-cell
+// allocations and gives the traversals that follow cache locality.
+struct CellInfo
+{
+    CellType type;
+    CellLabel label;
+    Point2D anchor;      // first pixel of the cell in scan order
+    Rect2D bounds;       // bounding rectangle of the cell's pixels
+    unsigned int size;   // number of pixels
+
+    CellInfo()
+    : type(CellTypeError), label(0), size(0)
+    {}
+};
+
+class CellStructureArena
+{
+public:
+    typedef ArrayVector<CellInfo> CellArray;
+
+    CellStructureArena()
+    {}
+
+    explicit CellStructureArena(CellImage const & image)
+    {
+        init(image);
+    }
+
+    void init(CellImage const & image)
+    {
+        int w = image.width();
+        int h = image.height();
+
+        // first pass: find the maximal label of each cell kind, so
+        // that each label index can be allocated in a single block
+        CellLabel maxLabel[3] = { 0, 0, 0 };
+        for(int y = 0; y < h; ++y)
+        {
+            CellPixel const * p = image[y];
+            for(int x = 0; x < w; ++x)
+            {
+                vigra_precondition(p[x].type() <= CellTypeVertex,
+                    "CellStructureArena::init(): corrupt cell image.");
+                if(maxLabel[p[x].type()] < p[x].label())
+                    maxLabel[p[x].type()] = p[x].label();
+            }
+        }
+
+        for(int t = 0; t < 3; ++t)
+        {
+            cells_[t].clear();
+            index_[t].clear();
+            index_[t].resize(maxLabel[t] + 1, invalidIndex);
+        }
+
+        // second pass: create the cell records in scan order of their
+        // anchor pixels and accumulate the cell geometry
+        for(int y = 0; y < h; ++y)
+        {
+            CellPixel const * p = image[y];
+            for(int x = 0; x < w; ++x)
+            {
+                CellType t = p[x].type();
+                CellLabel label = p[x].label();
+                unsigned int i = index_[t][label];
+                if(i == invalidIndex)
+                {
+                    index_[t][label] = cells_[t].size();
+                    cells_[t].push_back(CellInfo());
+
+                    CellInfo & cell = cells_[t].back();
+                    cell.type = t;
+                    cell.label = label;
+                    cell.anchor = Point2D(x, y);
+                    cell.bounds = Rect2D(Point2D(x, y), Size2D(1, 1));
+                    cell.size = 1;
+                }
+                else
+                {
+                    CellInfo & cell = cells_[t][i];
+                    cell.bounds |= Point2D(x, y);
+                    ++cell.size;
+                }
+            }
+        }
+    }
+
+    unsigned int cellCount(CellType type) const
+    {
+        return cells_[type].size();
+    }
+
+    bool hasCell(CellType type, CellLabel label) const
+    {
+        return label < index_[type].size() &&
+               index_[type][label] != invalidIndex;
+    }
+
+    CellInfo const & cell(CellType type, CellLabel label) const
+    {
+        vigra_precondition(hasCell(type, label),
+            "CellStructureArena::cell(): no cell with the given label.");
+        return cells_[type][index_[type][label]];
+    }
+
+    // the cells of one kind, contiguous, in scan order of their anchors
+    CellArray const & cells(CellType type) const
+    {
+        return cells_[type];
+    }
+
+private:
+    enum { invalidIndex = 0xffffffffu };
+
+    CellArray cells_[3];
+    ArrayVector<unsigned int> index_[3];
+};
+
 // -------------------------------------------------------------------
 //                              inspectCell
 // -------------------------------------------------------------------
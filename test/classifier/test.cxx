@@ -220,6 +220,26 @@ struct ClassifierTest
         rf::algorithms::VariableSelectionResult  result2;
         std::cerr << "backward_elimination()....\n";
         rf::algorithms::backward_elimination(data.features(ii), data.labels(ii), result2);
+
+        // parallel variants (fall through to the serial code without OpenMP);
+        // use small forests - this only checks that the overloads run
+        rf::algorithms::RFErrorCallback
+            cheap_callback(RandomForestOptions().tree_count(10));
+        ParallelOptions parallel = ParallelOptions().numThreads(2);
+        rf::algorithms::VariableSelectionResult  result3;
+        std::cerr << "forward_selection() (parallel)....\n";
+        rf::algorithms::forward_selection(data.features(ii), data.labels(ii),
+                                          result3, cheap_callback, parallel);
+        rf::algorithms::VariableSelectionResult  result4;
+        result4.init(data.features(ii), data.labels(ii), r.begin(), r.end(),
+                     cheap_callback);
+        std::cerr << "rank_selection() (parallel)....\n";
+        rf::algorithms::rank_selection(data.features(ii), data.labels(ii),
+                                       result4, cheap_callback, parallel);
+        rf::algorithms::VariableSelectionResult  result5;
+        std::cerr << "backward_elimination() (parallel)....\n";
+        rf::algorithms::backward_elimination(data.features(ii), data.labels(ii),
+                                             result5, cheap_callback, parallel);
         std::cerr << "DONE\n";
     }
     void RF_SpliceTest()
@@ -585,6 +605,234 @@ struct ClassifierTest
             std::cerr << "done!\n";
     }
 
+/**
+        ClassifierTest::RFparallelTest():
+    Learns two forests with identical random seeds but different thread
+    counts and checks that the resulting trees are identical - the
+    parallel learning mode seeds each tree deterministically from the
+    base generator, so the forest must not depend on the thread count.
+**/
+    void RFparallelTest()
+    {
+        std::cerr << "RFparallelTest(): Learning with 2 and 4 threads\n";
+        vigra::RandomForest<>
+            RF1(vigra::RandomForestOptions().tree_count(32).num_threads(4));
+        vigra::RandomForest<>
+            RF2(vigra::RandomForestOptions().tree_count(32).num_threads(2));
+
+        RF1.learn(  data.features(0),
+                    data.labels(0),
+                    rf_default(),
+                    rf_default(),
+                    rf_default(),
+                    vigra::RandomMT19937(1));
+
+        RF2.learn(  data.features(0),
+                    data.labels(0),
+                    rf_default(),
+                    rf_default(),
+                    rf_default(),
+                    vigra::RandomMT19937(1));
+
+        for(int ii = 0; ii < 32; ++ii)
+        {
+            shouldEqual(RF1.tree(ii).topology_, RF2.tree(ii).topology_);
+            shouldEqual(RF1.tree(ii).parameters_, RF2.tree(ii).parameters_);
+        }
+        std::cerr << "done!\n";
+    }
+
+
+/**
+        ClassifierTest::RFcompiledPredictTest():
+    Checks that compileTrees() does not change the prediction: a forest
+    is learnt, probabilities and labels are predicted once with the
+    generic node-proxy traversal and once with the compiled
+    struct-of-arrays layout, and both results must be identical.
+**/
+    void RFcompiledPredictTest()
+    {
+        typedef MultiArrayShape<2>::type Shp;
+        std::cerr << "RFcompiledPredictTest(): comparing compiled prediction\n";
+        vigra::RandomForest<>
+            RF(vigra::RandomForestOptions().tree_count(32));
+
+        RF.learn(   data.features(0),
+                    data.labels(0),
+                    rf_default(),
+                    rf_default(),
+                    rf_default(),
+                    vigra::RandomMT19937(1));
+
+        int n = data.features(0).shape(0);
+        MultiArray<2, double> prob1(Shp(n, RF.class_count()));
+        MultiArray<2, double> prob2(Shp(n, RF.class_count()));
+        MultiArray<2, double> labels1(Shp(n, 1));
+        MultiArray<2, double> labels2(Shp(n, 1));
+
+        RF.predictProbabilities(data.features(0), prob1);
+        RF.predictLabels(data.features(0), labels1);
+
+        RF.compileTrees();
+        for(int ii = 0; ii < 32; ++ii)
+            should(RF.tree(ii).isCompiled());
+
+        RF.predictProbabilities(data.features(0), prob2);
+        RF.predictLabels(data.features(0), labels2);
+
+        shouldEqualSequence(prob1.begin(), prob1.end(), prob2.begin());
+        shouldEqualSequence(labels1.begin(), labels1.end(), labels2.begin());
+        std::cerr << "done!\n";
+    }
+
+
+/**
+        ClassifierTest::RFpresortedSplitTest():
+    Learns two forests with identical random seeds, one with the
+    default GiniSplit and one with PresortedGiniSplit, and checks that
+    the resulting trees are identical - the presorted index mode is a
+    pure optimization and must choose the same splits.
+**/
+    void RFpresortedSplitTest()
+    {
+        std::cerr << "RFpresortedSplitTest(): comparing presorted split search\n";
+        vigra::RandomForest<>
+            RF1(vigra::RandomForestOptions().tree_count(16));
+        vigra::RandomForest<>
+            RF2(vigra::RandomForestOptions().tree_count(16));
+
+        RF1.learn(  data.features(0),
+                    data.labels(0),
+                    rf_default(),
+                    rf_default(),
+                    rf_default(),
+                    vigra::RandomMT19937(1));
+
+        RF2.learn(  data.features(0),
+                    data.labels(0),
+                    rf_default(),
+                    vigra::PresortedGiniSplit(),
+                    rf_default(),
+                    vigra::RandomMT19937(1));
+
+        for(int ii = 0; ii < 16; ++ii)
+        {
+            shouldEqual(RF1.tree(ii).topology_, RF2.tree(ii).topology_);
+            shouldEqual(RF1.tree(ii).parameters_, RF2.tree(ii).parameters_);
+        }
+        std::cerr << "done!\n";
+    }
+
+
+/**
+        ClassifierTest::RFquantizedPredictTest():
+    Checks the quantized compact tree encoding: after quantizeTrees()
+    the traversal data is stored as 16 bit columns and float
+    thresholds, which is a documented approximation - so we only
+    require that nearly all predicted labels agree with the exact
+    forest, not bitwise identical probabilities.
+**/
+    void RFquantizedPredictTest()
+    {
+        typedef MultiArrayShape<2>::type Shp;
+        std::cerr << "RFquantizedPredictTest(): comparing quantized prediction\n";
+        vigra::RandomForest<>
+            RF(vigra::RandomForestOptions().tree_count(32));
+
+        RF.learn(   data.features(0),
+                    data.labels(0),
+                    rf_default(),
+                    rf_default(),
+                    rf_default(),
+                    vigra::RandomMT19937(1));
+
+        int n = data.features(0).shape(0);
+        MultiArray<2, double> labels1(Shp(n, 1));
+        MultiArray<2, double> labels2(Shp(n, 1));
+
+        RF.predictLabels(data.features(0), labels1);
+
+        RF.quantizeTrees();
+        for(int ii = 0; ii < 32; ++ii)
+        {
+            should(RF.tree(ii).isQuantized());
+            // the exact traversal arrays are released
+            should(!RF.tree(ii).isCompiled());
+        }
+
+        RF.predictLabels(data.features(0), labels2);
+
+        int mismatch = 0;
+        for(int ii = 0; ii < n; ++ii)
+            if(labels1(ii, 0) != labels2(ii, 0))
+                ++mismatch;
+        // float thresholds may flip samples right at a split boundary,
+        // but that must remain a rare event
+        should(mismatch <= n / 50);
+        std::cerr << "done!\n";
+    }
+
+
+/**
+        ClassifierTest::RFparallelPredictTest():
+    Checks that multithreaded prediction gives exactly the serial
+    result: two identical forests are learnt sequentially with the same
+    seed, the thread count is raised on one of them only after learning,
+    and the probabilities and labels must match - both with the
+    node-proxy traversal and with the compiled batch traversal.
+**/
+    void RFparallelPredictTest()
+    {
+        typedef MultiArrayShape<2>::type Shp;
+        std::cerr << "RFparallelPredictTest(): predicting with 1 and 4 threads\n";
+        vigra::RandomForest<>
+            RFserial(vigra::RandomForestOptions().tree_count(32));
+        vigra::RandomForest<>
+            RFpar(vigra::RandomForestOptions().tree_count(32));
+
+        RFserial.learn( data.features(0),
+                        data.labels(0),
+                        rf_default(),
+                        rf_default(),
+                        rf_default(),
+                        vigra::RandomMT19937(1));
+
+        RFpar.learn(    data.features(0),
+                        data.labels(0),
+                        rf_default(),
+                        rf_default(),
+                        rf_default(),
+                        vigra::RandomMT19937(1));
+
+        // only now raise the thread count, so that both forests were
+        // learnt identically and prediction is the only parallel part
+        RFpar.set_options().num_threads(4);
+
+        int n = data.features(0).shape(0);
+        MultiArray<2, double> prob1(Shp(n, RFserial.class_count()));
+        MultiArray<2, double> prob2(Shp(n, RFpar.class_count()));
+        MultiArray<2, double> labels1(Shp(n, 1));
+        MultiArray<2, double> labels2(Shp(n, 1));
+
+        RFserial.predictProbabilities(data.features(0), prob1);
+        RFserial.predictLabels(data.features(0), labels1);
+
+        RFpar.predictProbabilities(data.features(0), prob2);
+        RFpar.predictLabels(data.features(0), labels2);
+
+        shouldEqualSequence(prob1.begin(), prob1.end(), prob2.begin());
+        shouldEqualSequence(labels1.begin(), labels1.end(), labels2.begin());
+
+        // same comparison with the compiled batch traversal
+        RFpar.compileTrees();
+        RFpar.predictProbabilities(data.features(0), prob2);
+        RFpar.predictLabels(data.features(0), labels2);
+
+        shouldEqualSequence(prob1.begin(), prob1.end(), prob2.begin());
+        shouldEqualSequence(labels1.begin(), labels1.end(), labels2.begin());
+        std::cerr << "done!\n";
+    }
+
 
 /**
         ClassifierTest::RFsetTest():
@@ -640,6 +888,47 @@ struct ClassifierTest
         std::cerr << "DONE!\n";
     }
 
+/**
+        ClassifierTest::RFonlineSetTest():
+    Checks the OnlineLearningSet convenience wrapper on the XOR problem:
+    the first update() trains the forest from scratch, a second
+    update() with additional samples refines it via onlineLearn(), and
+    the refined forest must still classify the training samples
+    correctly.
+**/
+    void RFonlineSetTest()
+    {
+        //xor dataset.
+        double features[] = {0, 0, 1, 1,
+                         0, 1, 0, 1};
+        int    labels[] = {1, 0, 0, 1};
+        MultiArrayView<2, double> feat(MultiArrayShape<2>::type(4,2), features);
+        MultiArrayView<2, int>    labl(MultiArrayShape<2>::type(4,1), labels);
+        std::cerr << "RFonlineSetTest(): incremental learning on XOR problem. ";
+
+        vigra::RandomForest<>
+            RF(vigra::RandomForestOptions().tree_count(255)
+                                           .prepare_online_learning(true));
+        vigra::OnlineLearningSet<double> training_set(2);
+
+        training_set.addSamples(feat, labl);
+        shouldEqual(training_set.size(), 4);
+        shouldEqual(training_set.unlearned_count(), 4);
+        training_set.update(RF);
+        shouldEqual(training_set.unlearned_count(), 0);
+
+        training_set.addSamples(feat, labl);
+        shouldEqual(training_set.size(), 8);
+        shouldEqual(training_set.unlearned_count(), 4);
+        training_set.update(RF);
+        shouldEqual(training_set.unlearned_count(), 0);
+
+        for(int ii = 0; ii < 4; ++ii)
+            shouldEqual(RF.predictLabel(rowVector(feat, ii)),
+                        double(labels[ii]));
+        std::cerr << "DONE!\n";
+    }
+
 /**
         ClassifierTest::RFnoiseTest():
     Learns The Refactored Random Forest with 100 Trees default options and random Seed for 64 dimensional
@@ -708,6 +997,45 @@ struct ClassifierTest
                 std::cerr << "] " << data.names(ii);
                 std::cerr << "\n";
             }
+
+            // multithreaded permutation importance: the per-feature
+            // generators make it statistically equivalent but not
+            // bitwise identical, so compare the deterministic parts
+            // and the ranking of the top feature
+            {
+                std::cerr << "RFvariableImportanceTest(): "
+                                "parallel importance computation\n";
+                vigra::rf::visitors::VariableImportanceVisitor var_imp_serial;
+                vigra::rf::visitors::VariableImportanceVisitor var_imp_par(10, 4);
+
+                vigra::RandomForest<>
+                    RF3(vigra::RandomForestOptions().tree_count(255));
+                RF3.learn(  data.features(ii),
+                            data.labels(ii),
+                            create_visitor(var_imp_serial, var_imp_par),
+                            rf_default(),
+                            rf_default(),
+                            vigra::RandomMT19937(1));
+
+                int class_count = RF3.class_count();
+                // gini decrease importance does not involve permutation
+                // and must agree exactly
+                for(int jj = 0; jj < p_imp.shape(0); ++jj)
+                    shouldEqual(var_imp_par.variable_importance_(jj, class_count + 1),
+                                var_imp_serial.variable_importance_(jj, class_count + 1));
+                // the most important feature must come out the same
+                int best_serial = 0, best_par = 0;
+                for(int jj = 1; jj < p_imp.shape(0); ++jj)
+                {
+                    if(var_imp_serial.variable_importance_(jj, class_count)
+                       > var_imp_serial.variable_importance_(best_serial, class_count))
+                        best_serial = jj;
+                    if(var_imp_par.variable_importance_(jj, class_count)
+                       > var_imp_par.variable_importance_(best_par, class_count))
+                        best_par = jj;
+                }
+                shouldEqual(best_serial, best_par);
+            }
         }
         std::cerr << std::endl;
         std::cerr << "DONE!\n\n";
@@ -800,6 +1128,34 @@ struct ClassifierTest
             }
             std::cerr << "done!\n";
     }
+
+    /** checks whether the compact single-blob hdf5 layout round-trips
+     */
+    void HDF5CompactImpexTest()
+    {
+            std::cerr << "Running HDF5 Compact Impex Test\n";
+            std::string filename = data.names(0) + "_compact_rf.hdf5";
+            std::remove(filename.c_str());
+            vigra::RandomForest<> RF(vigra::RandomForestOptions()
+                                         .tree_count(100));
+
+            RF.learn(data.features(0), data.labels(0));
+            rf_export_compact_HDF5(RF, filename);
+
+            vigra::RandomForest<> RF2;
+            rf_import_compact_HDF5(RF2, filename);
+            should_all(RF, RF2);
+
+            // both layouts can live in one file under different groups
+            rf_export_HDF5(RF, filename, "classic");
+            rf_export_compact_HDF5(RF, filename, "compact");
+
+            vigra::RandomForest<> RF3, RF4;
+            rf_import_HDF5(RF3, filename, "classic");
+            rf_import_compact_HDF5(RF4, filename, "compact");
+            should_all(RF3, RF4);
+            std::cerr << "done!\n";
+    }
 #endif
 //};
 
@@ -944,7 +1300,13 @@ struct ClassifierTestSuite
 #ifndef FAST
         add( testCase( &ClassifierTest::RFsetTest));
         add( testCase( &ClassifierTest::RFonlineTest));
+        add( testCase( &ClassifierTest::RFonlineSetTest));
         add( testCase( &ClassifierTest::RFoobTest));
+        add( testCase( &ClassifierTest::RFparallelTest));
+        add( testCase( &ClassifierTest::RFcompiledPredictTest));
+        add( testCase( &ClassifierTest::RFparallelPredictTest));
+        add( testCase( &ClassifierTest::RFquantizedPredictTest));
+        add( testCase( &ClassifierTest::RFpresortedSplitTest));
         add( testCase( &ClassifierTest::RFnoiseTest));
         add( testCase( &ClassifierTest::RFvariableImportanceTest));
         add( testCase( &ClassifierTest::RF_NanCheck));
@@ -958,6 +1320,7 @@ struct ClassifierTestSuite
         add( testCase( &ClassifierTest::RFSplitFunctorTest));
 #ifdef HasHDF5
         add( testCase( &ClassifierTest::HDF5ImpexTest));
+        add( testCase( &ClassifierTest::HDF5CompactImpexTest));
 #endif
          
     }
@@ -311,6 +311,42 @@ struct ColorConversionsTest
         should(equalColors(transformed[count-1], RGB(0.541569, -0.0735254, -0.165463)));
     }
     
+    void testBatchSpanConversions()
+    {
+        // the span functions must agree with the per-pixel functors
+        // up to the accuracy of the fast cube root
+        std::transform(original, original+count, transformed,
+                        vigra::RGB2LabFunctor<double>());
+        Color batch[count];
+        vigra::rgb2LabSpan(original, count, batch);
+        should(equalColors(transformed, transformed+count, batch, 1e-9));
+
+        std::transform(original, original+count, transformed,
+                        vigra::RGB2LuvFunctor<double>());
+        vigra::rgb2LuvSpan(original, count, batch);
+        should(equalColors(transformed, transformed+count, batch, 1e-9));
+
+        std::transform(original, original+count, transformed,
+                        vigra::RGBPrime2YPrimeCbCrFunctor<double>());
+        vigra::rgbPrime2YPrimeCbCrSpan(original, count, batch);
+        should(equalColors(transformed, transformed+count, batch, 1e-9));
+
+        // RGBValue input, float output, non-default maximum
+        vigra::RGBValue<float> frgb[3];
+        frgb[0] = vigra::RGBValue<float>(0.5f, 0.25f, 0.125f);
+        frgb[1] = vigra::RGBValue<float>(1.0f, 1.0f, 1.0f);
+        frgb[2] = vigra::RGBValue<float>(0.0f, 0.0f, 0.0f);
+        vigra::TinyVector<float, 3> flab[3];
+        vigra::rgb2LabSpan(frgb, 3, flab, 1.0);
+        vigra::RGB2LabFunctor<float> labFunctor(1.0f);
+        for(int k = 0; k < 3; ++k)
+        {
+            vigra::RGB2LabFunctor<float>::result_type ref = labFunctor(frgb[k]);
+            for(int i = 0; i < 3; ++i)
+                shouldEqualTolerance(flab[k][i], ref[i], 1e-5f);
+        }
+    }
+
     void testLabPolar()
     {
         std::transform(original, original+count, transformed, 
@@ -458,6 +494,7 @@ struct ColorConversionsTestSuite
         add( testCase(&ColorConversionsTest::testRGBPrime2YPrimeCbCr));
         add( testCase(&ColorConversionsTest::testRGBPrime2YPrimeIQ));
         add( testCase(&ColorConversionsTest::testRGBPrime2YPrimeUV));
+        add( testCase(&ColorConversionsTest::testBatchSpanConversions));
         add( testCase(&ColorConversionsTest::testLabPolar));
         add( testCase(&ColorConversionsTest::testLuvPolar));
         add( testCase(&ColorConversionsTest::testYPrimePbPrPolar));
@@ -756,6 +756,94 @@ struct ConvolutionTest
         }
     }
     
+    void fixedPointConvolutionTest()
+    {
+        int w = lenna.width(), h = lenna.height();
+        vigra::BImage src8(w, h), dest8(w, h);
+        Image refsrc(w, h), ref(w, h);
+        for(int y=0; y<h; ++y)
+        {
+            for(int x=0; x<w; ++x)
+            {
+                src8(x, y) = (unsigned char)(lenna(x, y) + 0.5);
+                refsrc(x, y) = src8(x, y);
+            }
+        }
+
+        vigra::Kernel1D<double> gauss;
+        gauss.initGaussian(1.5);
+
+        // the quantized taps have at least 14 fractional bits, so the
+        // result may differ from the rounded floating-point reference
+        // by at most one gray level
+        vigra::BorderTreatmentMode modes[4] =
+            { vigra::BORDER_TREATMENT_REPEAT, vigra::BORDER_TREATMENT_REFLECT,
+              vigra::BORDER_TREATMENT_WRAP, vigra::BORDER_TREATMENT_ZEROPAD };
+        for(int m = 0; m < 4; ++m)
+        {
+            gauss.setBorderTreatment(modes[m]);
+            separableConvolveXFixedPoint(srcImageRange(src8), destImage(dest8), gauss);
+            separableConvolveX(srcImageRange(refsrc), destImage(ref), kernel1d(gauss));
+            for(int y=0; y<h; ++y)
+            {
+                for(int x=0; x<w; ++x)
+                {
+                    int expected = (int)VIGRA_CSTD::floor(ref(x, y) + 0.5);
+                    should(std::abs((int)dest8(x, y) - expected) <= 1);
+                }
+            }
+
+            separableConvolveYFixedPoint(srcImageRange(src8), destImage(dest8), gauss);
+            separableConvolveY(srcImageRange(refsrc), destImage(ref), kernel1d(gauss));
+            for(int y=0; y<h; ++y)
+            {
+                for(int x=0; x<w; ++x)
+                {
+                    int expected = (int)VIGRA_CSTD::floor(ref(x, y) + 0.5);
+                    should(std::abs((int)dest8(x, y) - expected) <= 1);
+                }
+            }
+        }
+
+        // AVOID leaves the borders of the destination untouched
+        gauss.setBorderTreatment(vigra::BORDER_TREATMENT_AVOID);
+        dest8.init(7);
+        separableConvolveXFixedPoint(srcImageRange(src8), destImage(dest8), gauss);
+        int kr = gauss.right(), kl = gauss.left();
+        for(int y=0; y<h; ++y)
+        {
+            for(int x=0; x<kr; ++x)
+                shouldEqual(dest8(x, y), 7);
+            for(int x=w+kl; x<w; ++x)
+                shouldEqual(dest8(x, y), 7);
+        }
+        separableConvolveX(srcImageRange(refsrc), destImage(ref),
+                           kernel1d(gauss, vigra::BORDER_TREATMENT_AVOID));
+        for(int y=0; y<h; ++y)
+        {
+            for(int x=kr; x<w+kl; ++x)
+            {
+                int expected = (int)VIGRA_CSTD::floor(ref(x, y) + 0.5);
+                should(std::abs((int)dest8(x, y) - expected) <= 1);
+            }
+        }
+
+        // saturating pack: an unnormalized kernel must clip at 255
+        vigra::Kernel1D<double> big;
+        big.initExplicitly(-1, 1) = 1.0, 1.5, 1.0;
+        big.setBorderTreatment(vigra::BORDER_TREATMENT_REPEAT);
+        separableConvolveXFixedPoint(srcImageRange(src8), destImage(dest8), big);
+        separableConvolveX(srcImageRange(refsrc), destImage(ref), kernel1d(big));
+        for(int y=0; y<h; ++y)
+        {
+            for(int x=0; x<w; ++x)
+            {
+                double expected = std::min(255.0, VIGRA_CSTD::floor(ref(x, y) + 0.5));
+                should(std::abs((int)dest8(x, y) - expected) <= 1.0);
+            }
+        }
+    }
+
     void separableDerivativeRepeatTest()
     {
         vigra::Kernel1D<double> grad;
@@ -917,6 +1005,57 @@ struct ConvolutionTest
         should(acc(i1) == 2.75);
     }
     
+    void stagedConvolveLineTest()
+    {
+        vigra::Kernel1D<double> gauss;
+        gauss.initGaussian(1.5);
+
+        int w = lenna.width();
+        int h = lenna.height();
+        vigra::ArrayVector<double> line(w), out1(w), out2(w), staging;
+        vigra::StandardAccessor<double> acc;
+
+        static const vigra::BorderTreatmentMode modes[] = {
+            vigra::BORDER_TREATMENT_WRAP,
+            vigra::BORDER_TREATMENT_REFLECT,
+            vigra::BORDER_TREATMENT_REPEAT,
+            vigra::BORDER_TREATMENT_ZEROPAD,
+            vigra::BORDER_TREATMENT_CLIP,
+            vigra::BORDER_TREATMENT_AVOID };
+
+        for(unsigned int m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m)
+        {
+            // the staging buffer is reused for all rows of the batch
+            for(int y = 0; y < h; ++y)
+            {
+                for(int x = 0; x < w; ++x)
+                    line[x] = lenna(x, y);
+                for(int x = 0; x < w; ++x)
+                    out1[x] = out2[x] = 1000.0;
+
+                convolveLine(srcIterRange(line.begin(), line.end(), acc),
+                             destIter(out1.begin(), acc), kernel1d(gauss, modes[m]));
+                convolveLine(srcIterRange(line.begin(), line.end(), acc),
+                             destIter(out2.begin(), acc), kernel1d(gauss, modes[m]),
+                             staging);
+
+                shouldEqualSequence(out1.begin(), out1.end(), out2.begin());
+            }
+
+            // short subrange, as in ROI processing
+            for(int x = 0; x < w; ++x)
+                out1[x] = out2[x] = 1000.0;
+            convolveLine(srcIterRange(line.begin(), line.end(), acc),
+                         destIter(out1.begin(), acc), kernel1d(gauss, modes[m]),
+                         10, 74);
+            convolveLine(srcIterRange(line.begin(), line.end(), acc),
+                         destIter(out2.begin(), acc), kernel1d(gauss, modes[m]),
+                         staging, 10, 74);
+
+            shouldEqualSequence(out1.begin(), out1.begin() + 64, out2.begin());
+        }
+    }
+
     void gaussianSmoothingTest()
     {
         double scale = 1.0;
@@ -2070,7 +2209,88 @@ struct ConvolutionTest
             shouldEqualTolerance((*i1), (*i2), 1e-7);
         }
     }
-    
+
+    void gradientMagnitudeParallelTest()
+    {
+        Image ref(lenna.size()), res(lenna.size());
+
+        gaussianGradientMagnitude(srcImageRange(lenna), destImage(ref), 1.0);
+        gaussianGradientMagnitude(srcImageRange(lenna), destImage(res), 1.0,
+                                  vigra::ParallelOptions().numThreads(3));
+
+        shouldEqualSequence(res.begin(), res.end(), ref.begin());
+    }
+
+    void structureTensorParallelTest()
+    {
+        Image refxx(lenna.size()), refxy(lenna.size()), refyy(lenna.size());
+        Image resxx(lenna.size()), resxy(lenna.size()), resyy(lenna.size());
+
+        structureTensor(srcImageRange(lenna),
+            destImage(refxx), destImage(refxy), destImage(refyy), 1.0, 2.0);
+        structureTensor(srcImageRange(lenna),
+            destImage(resxx), destImage(resxy), destImage(resyy), 1.0, 2.0,
+            vigra::ParallelOptions().numThreads(3));
+
+        shouldEqualSequence(resxx.begin(), resxx.end(), refxx.begin());
+        shouldEqualSequence(resxy.begin(), resxy.end(), refxy.begin());
+        shouldEqualSequence(resyy.begin(), resyy.end(), refyy.begin());
+
+        typedef BasicImage<TinyVector<double, 3> > VectorImage;
+        VectorImage refst(lenna.size()), resst(lenna.size());
+
+        structureTensor(srcImageRange(lenna), destImage(refst), 1.0, 2.0);
+        structureTensor(srcImageRange(lenna), destImage(resst), 1.0, 2.0,
+                        vigra::ParallelOptions().numThreads(3));
+
+        shouldEqualSequence(resst.begin(), resst.end(), refst.begin());
+    }
+
+    void recursiveFilterParallelTest()
+    {
+        Image ref(lenna.size()), res(lenna.size());
+
+        // first order, rows
+        recursiveFilterX(srcImageRange(lenna), destImage(ref),
+                         VIGRA_CSTD::exp(-1.0), BORDER_TREATMENT_REFLECT);
+        recursiveFilterX(srcImageRange(lenna), destImage(res),
+                         VIGRA_CSTD::exp(-1.0), BORDER_TREATMENT_REFLECT,
+                         vigra::ParallelOptions().numThreads(3));
+        shouldEqualSequence(res.begin(), res.end(), ref.begin());
+
+        // first order, columns
+        recursiveFilterY(srcImageRange(lenna), destImage(ref),
+                         VIGRA_CSTD::exp(-1.0), BORDER_TREATMENT_WRAP);
+        recursiveFilterY(srcImageRange(lenna), destImage(res),
+                         VIGRA_CSTD::exp(-1.0), BORDER_TREATMENT_WRAP,
+                         vigra::ParallelOptions().numThreads(3));
+        shouldEqualSequence(res.begin(), res.end(), ref.begin());
+
+        // second order, rows and columns
+        recursiveFilterX(srcImageRange(lenna), destImage(ref), -0.6, -0.06);
+        recursiveFilterX(srcImageRange(lenna), destImage(res), -0.6, -0.06,
+                         vigra::ParallelOptions().numThreads(3));
+        shouldEqualSequence(res.begin(), res.end(), ref.begin());
+
+        recursiveFilterY(srcImageRange(lenna), destImage(ref), -0.6, -0.06);
+        recursiveFilterY(srcImageRange(lenna), destImage(res), -0.6, -0.06,
+                         vigra::ParallelOptions().numThreads(3));
+        shouldEqualSequence(res.begin(), res.end(), ref.begin());
+    }
+
+    void nonlinearDiffusionParallelTest()
+    {
+        Image ref(lenna.size()), res(lenna.size());
+
+        nonlinearDiffusion(srcImageRange(lenna), destImage(ref),
+                           vigra::DiffusivityFunctor<double>(4.0), 4.0);
+        nonlinearDiffusion(srcImageRange(lenna), destImage(res),
+                           vigra::DiffusivityFunctor<double>(4.0), 4.0,
+                           vigra::ParallelOptions().numThreads(3));
+
+        shouldEqualSequence(res.begin(), res.end(), ref.begin());
+    }
+
     Image constimg, lenna, rampimg, sym_image, unsym_image;
     vigra::Kernel2D<double> sym_kernel, unsym_kernel, line_kernel;
     
@@ -2200,6 +2420,71 @@ struct ResamplingConvolutionTest
         for(FImage::iterator i = res.begin(), j = ref.begin(); i < res.end(); ++i, ++j)
             shouldEqualTolerance(*i, *j, 1e-6);
     }
+
+    void testKernelTable()
+    {
+        Gaussian<double> gauss(0.7);
+        Rational<int> samplingRatio(2,1), offset(1,4);
+
+        ImageImportInfo info("lenna128.xv");
+        FImage img(info.size());
+        importImage(info, destImage(img));
+
+        int wnew = rational_cast<int>((info.width() - 1 - offset) * samplingRatio + 1);
+        int hnew = rational_cast<int>((info.height() - 1 - offset) * samplingRatio + 1);
+
+        FImage ref(wnew, hnew);
+        resamplingConvolveImage(srcImageRange(img), destImageRange(ref),
+             gauss, samplingRatio, offset, gauss, samplingRatio, offset);
+
+        // a precomputed weight table must give identical results,
+        // also when reused for a second call
+        ResamplingKernelTable table(gauss, samplingRatio, offset);
+        FImage res(wnew, hnew);
+        resamplingConvolveImage(srcImageRange(img), destImageRange(res),
+                                table, table);
+        for(FImage::iterator i = res.begin(), j = ref.begin(); i < res.end(); ++i, ++j)
+            shouldEqual(*i, *j);
+
+        res.init(0.0);
+        resamplingConvolveImage(srcImageRange(img), destImageRange(res),
+                                table, table);
+        for(FImage::iterator i = res.begin(), j = ref.begin(); i < res.end(); ++i, ++j)
+            shouldEqual(*i, *j);
+    }
+
+    void testParallel()
+    {
+        Gaussian<double> gauss(0.7);
+        Rational<int> samplingRatio(2,1), offset(1,4);
+
+        ImageImportInfo info("lenna128.xv");
+        FImage img(info.size());
+        importImage(info, destImage(img));
+
+        int wnew = rational_cast<int>((info.width() - 1 - offset) * samplingRatio + 1);
+        int hnew = rational_cast<int>((info.height() - 1 - offset) * samplingRatio + 1);
+
+        FImage ref(wnew, hnew);
+        resamplingConvolveImage(srcImageRange(img), destImageRange(ref),
+             gauss, samplingRatio, offset, gauss, samplingRatio, offset);
+
+        // multi-threaded execution must give identical results
+        FImage res(wnew, hnew);
+        resamplingConvolveImage(srcImageRange(img), destImageRange(res),
+             gauss, samplingRatio, offset, gauss, samplingRatio, offset,
+             ParallelOptions().numThreads(4));
+        for(FImage::iterator i = res.begin(), j = ref.begin(); i < res.end(); ++i, ++j)
+            shouldEqual(*i, *j);
+
+        // likewise with a precomputed weight table
+        ResamplingKernelTable table(gauss, samplingRatio, offset);
+        res.init(0.0);
+        resamplingConvolveImage(srcImageRange(img), destImageRange(res),
+                                table, table, ParallelOptions().numThreads(4));
+        for(FImage::iterator i = res.begin(), j = ref.begin(); i < res.end(); ++i, ++j)
+            shouldEqual(*i, *j);
+    }
 };
 
 struct ImagePyramidTest
@@ -2274,7 +2559,19 @@ struct ImagePyramidTest
             shouldEqualSequenceTolerance(pyramid[i].begin(), pyramid[i].end(), laplacian[i].begin(), 1e-14);
         }
     }
-    
+
+    void testParallelReduce()
+    {
+        vigra::ImagePyramid<Image> pyramid(0, 3, img), pyramidp(0, 3, img);
+
+        pyramidReduceBurtFilter(pyramid, 0, 3);
+        pyramidReduceBurtFilter(pyramidp, 0, 3, 0.4,
+                                ParallelOptions().numThreads(4));
+
+        for(int i=0; i<=3; ++i)
+            shouldEqualSequence(pyramid[i].begin(), pyramid[i].end(), pyramidp[i].begin());
+    }
+
 };
 
 struct TotalVariationTest{
@@ -2299,10 +2596,26 @@ struct TotalVariationTest{
     shouldEqualSequenceTolerance(out.begin(), out.end(), result_std_tv, 1e-12); 
   }
   void testWeightedTotalVariation(){
-   
+
     totalVariationFilter(data,weight,out,.5,1000,0.01);
     //exportImage(srcImageRange(out), vigra::ImageExportInfo("test_tvw.pgm"));
-    shouldEqualSequenceTolerance(out.begin(), out.end(), result_std_tv_weight, 1e-12); 
+    shouldEqualSequenceTolerance(out.begin(), out.end(), result_std_tv_weight, 1e-12);
+  }
+
+  void testAcceleratedTotalVariation(){
+
+    // the accelerated solver approaches the same minimizer as the
+    // standard one, but is not expected to match it exactly
+    totalVariationFilterAccelerated(data,out,0.5,1000,0);
+    shouldEqualSequenceTolerance(out.begin(), out.end(), result_std_tv, 1e-2);
+
+    MultiArray<2,double> out2(out.shape());
+    totalVariationFilterAccelerated(data,out2,0.5,1000,0,
+                                    ParallelOptions().numThreads(3));
+    shouldEqualSequence(out2.begin(), out2.end(), out.begin());
+
+    totalVariationFilterAccelerated(data,weight,out,0.5,1000,0);
+    shouldEqualSequenceTolerance(out.begin(), out.end(), result_std_tv_weight, 1e-2);
   }
   
   void testAnisotropicTotalVariation(){
@@ -2360,7 +2673,54 @@ struct TotalVariationTest{
       secondOrderTotalVariationFilter(data,weight,phi,alpha,beta,gamma,xedges,yedges,out,inner_steps);
     }
     //exportImage(srcImageRange(out), vigra::ImageExportInfo("test_htv.pgm"));
-    shouldEqualSequenceTolerance(out.begin(), out.end(), result_higher_order_tv,1e-12); 
+    shouldEqualSequenceTolerance(out.begin(), out.end(), result_higher_order_tv,1e-12);
+  }
+
+  void testProjectEllipse2DBatch(){
+
+    // the batched projection must reproduce the scalar one exactly,
+    // including the special cases (inside, circle, points on the axes,
+    // all reflections, swapped half-axes)
+    std::srand(54321);
+    int n=1000;
+    vigra::ArrayVector<double> vx(n),vy(n),a(n),b(n),rx(n),ry(n);
+    for (int k=0;k<n;k++){
+      switch(k%6){
+        case 0:  // generic exterior point
+          vx[k]=(std::rand()%2000-1000)/100.;
+          vy[k]=(std::rand()%2000-1000)/100.;
+          break;
+        case 1:  // interior point
+          vx[k]=(std::rand()%100-50)/1000.;
+          vy[k]=(std::rand()%100-50)/1000.;
+          break;
+        case 2:  // on or near the x axis
+          vx[k]=(std::rand()%2000-1000)/100.;
+          vy[k]=(std::rand()%3-1)*0.0005;
+          break;
+        case 3:  // on or near the y axis
+          vx[k]=(std::rand()%3-1)*0.0005;
+          vy[k]=(std::rand()%2000-1000)/100.;
+          break;
+        default:
+          vx[k]=(std::rand()%2000-1000)/10.;
+          vy[k]=(std::rand()%2000-1000)/10.;
+      }
+      a[k]=0.05+(std::rand()%100)/50.;
+      b[k]=(k%7 == 0)
+              ? a[k]                         // circle case
+              : 0.05+(std::rand()%100)/50.;
+      rx[k]=vx[k];
+      ry[k]=vy[k];
+    }
+
+    vigra::detail::projectEllipse2DBatch(vx.begin(),vy.begin(),a.begin(),b.begin(),n,0.001,100);
+
+    for (int k=0;k<n;k++){
+      vigra::detail::projectEllipse2D(rx[k],ry[k],a[k],b[k],0.001,100);
+      shouldEqual(vx[k],rx[k]);
+      shouldEqual(vy[k],ry[k]);
+    }
   }
 };
 
@@ -2390,12 +2750,14 @@ struct ConvolutionTestSuite
         add( testCase( &ConvolutionTest::stdConvolutionTestOfAllTreatmentsRelatively));
 
         add( testCase( &ConvolutionTest::separableConvolutionTest));
+        add( testCase( &ConvolutionTest::fixedPointConvolutionTest));
         add( testCase( &ConvolutionTest::separableDerivativeRepeatTest));
         add( testCase( &ConvolutionTest::separableDerivativeReflectTest));
         add( testCase( &ConvolutionTest::separableDerivativeAvoidTest));
         add( testCase( &ConvolutionTest::separableSmoothClipTest));
         add( testCase( &ConvolutionTest::separableSmoothZeropadTest));
         add( testCase( &ConvolutionTest::separableSmoothWrapTest));
+        add( testCase( &ConvolutionTest::stagedConvolveLineTest));
         add( testCase( &ConvolutionTest::gaussianSmoothingTest));
         add( testCase( &ConvolutionTest::optimalSmoothing3Test));
         add( testCase( &ConvolutionTest::optimalSmoothing5Test));
@@ -2424,19 +2786,28 @@ struct ConvolutionTestSuite
         add( testCase( &ConvolutionTest::recursiveGradientTest));
         add( testCase( &ConvolutionTest::recursiveSecondDerivativeTest));
         add( testCase( &ConvolutionTest::nonlinearDiffusionTest));
+        add( testCase( &ConvolutionTest::gradientMagnitudeParallelTest));
+        add( testCase( &ConvolutionTest::structureTensorParallelTest));
+        add( testCase( &ConvolutionTest::recursiveFilterParallelTest));
+        add( testCase( &ConvolutionTest::nonlinearDiffusionParallelTest));
 
         add( testCase( &ResamplingConvolutionTest::testKernelsSpline));
         add( testCase( &ResamplingConvolutionTest::testKernelsGauss));
         add( testCase( &ResamplingConvolutionTest::testOversamplingConstant));
         add( testCase( &ResamplingConvolutionTest::testOversamplingReal));
+        add( testCase( &ResamplingConvolutionTest::testKernelTable));
+        add( testCase( &ResamplingConvolutionTest::testParallel));
 
         add( testCase( &ImagePyramidTest::testPyramidConstruction));
         add( testCase( &ImagePyramidTest::testBurtReduceExpand));
+        add( testCase( &ImagePyramidTest::testParallelReduce));
     
         add( testCase( &TotalVariationTest::testTotalVariation));
         add( testCase( &TotalVariationTest::testWeightedTotalVariation));
+        add( testCase( &TotalVariationTest::testAcceleratedTotalVariation));
         add( testCase( &TotalVariationTest::testAnisotropicTotalVariation));
         add( testCase( &TotalVariationTest::testSecondOrderTotalVariation));
+        add( testCase( &TotalVariationTest::testProjectEllipse2DBatch));
 #endif
     }
 };
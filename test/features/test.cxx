@@ -146,6 +146,88 @@ struct InvariantFeaturesTest
         // FIXME: compute_D() with arbitrary angles, rot(), and rotatePH() are untested!
     }
 
+    void wignerMatrixCacheTest()
+    {
+        typedef MultiArrayShape<2>::type Shape;
+
+        int l_max = 8;
+        WignerMatrixCache<float> cache;
+        shouldEqual(cache.bandLimit(), 0);
+
+        cache.ensureBandLimit(l_max);
+        shouldEqual(cache.bandLimit(), l_max);
+
+        // the cached matrices must equal a freshly computed WignerMatrix exactly
+        WignerMatrix<float> wigner(l_max);
+        wigner.compute_D(l_max);
+        shouldEqual(cache.get_D(0, 0, 0), std::complex<float>(1.0f));
+        for(int l=1; l<=l_max; ++l)
+        {
+            shouldEqual(cache.get_D(l).shape(), Shape(2*l+1, 2*l+1));
+            for(int n=-l; n<=l; ++n)
+                for(int m=-l; m<=l; ++m)
+                    shouldEqual(cache.get_D(l, n, m), wigner.get_D(l, n, m));
+        }
+
+        // a smaller band limit must not shrink the cache
+        cache.ensureBandLimit(3);
+        shouldEqual(cache.bandLimit(), l_max);
+
+        try
+        {
+            cache.get_D(l_max + 1);
+            failTest("no exception thrown");
+        }
+        catch(vigra::PreconditionViolation &)
+        {}
+
+        WignerMatrixCache<float>::global().ensureBandLimit(2);
+        should(WignerMatrixCache<float>::global().bandLimit() >= 2);
+    }
+
+    void clebschGordanTableTest()
+    {
+        int l_max = 4;
+        ClebschGordanTable table;
+        shouldEqual(table.angularMomentumLimit(), -1);
+
+        table.ensureAngularMomentum(l_max);
+        shouldEqual(table.angularMomentumLimit(), l_max);
+
+        // every valid combination must match clebschGordan() exactly
+        for(int l1 = 0; l1 <= l_max; ++l1)
+            for(int l2 = 0; l2 <= l_max; ++l2)
+                for(int l3 = abs(l1-l2); l3 <= std::min(l1+l2, l_max); ++l3)
+                    for(int m1 = -l1; m1 <= l1; ++m1)
+                        for(int m2 = -l2; m2 <= l2; ++m2)
+                        {
+                            if(abs(m1 + m2) > l3)
+                                continue;
+                            shouldEqual(table(l1, m1, l2, m2, l3, m1 + m2),
+                                        clebschGordan(l1, m1, l2, m2, l3, m1 + m2));
+                        }
+
+        // violated m selection rule yields zero instead of an exception
+        shouldEqual(table(1, 1, 1, 1, 2, 0), 0.0);
+        // non-triangular momenta yield zero as well
+        shouldEqual(table(1, 0, 1, 0, 4, 0), 0.0);
+
+        // a smaller limit must not shrink the table
+        table.ensureAngularMomentum(2);
+        shouldEqual(table.angularMomentumLimit(), l_max);
+
+        try
+        {
+            table(l_max + 1, 0, 0, 0, 0, 0);
+            failTest("no exception thrown");
+        }
+        catch(vigra::PreconditionViolation &)
+        {}
+
+        ClebschGordanTable::global().ensureAngularMomentum(2);
+        should(ClebschGordanTable::global().angularMomentumLimit() >= 2);
+    }
+
 };
 
 struct FeaturesTestSuite
@@ -155,6 +237,8 @@ struct FeaturesTestSuite
     : vigra::test_suite("FeaturesTestSuite")
     {
         add( testCase( &InvariantFeaturesTest::wignerMatrixTest));
+        add( testCase( &InvariantFeaturesTest::wignerMatrixCacheTest));
+        add( testCase( &InvariantFeaturesTest::clebschGordanTableTest));
     }
 };
 
@@ -692,6 +692,33 @@ struct MultiFFTTest
         shouldEqualSequenceTolerance(out2.data(), out2.data()+out2.size(),
                                      out4.data(), 1e-15);
     }
+
+    void testConvolveImageDispatch()
+    {
+        ImageImportInfo info("ghouse.gif");
+        DImage in(info.size()), ref(info.size()), out(info.size());
+        importImage(info, destImage(in));
+
+        Kernel2D<double> gauss;
+        gauss.initGaussian(3.0);   // 19x19 => above the CONVOLVE_AUTO threshold
+        gauss.setBorderTreatment(BORDER_TREATMENT_REFLECT);
+
+        convolveImage(srcImageRange(in), destImage(ref), kernel2d(gauss));
+
+        convolveImage(srcImageRange(in), destImage(out), kernel2d(gauss),
+                      CONVOLVE_SPATIAL);
+        shouldEqualSequenceTolerance(out.begin(), out.end(), ref.begin(), 1e-14);
+
+        out.init(0.0);
+        convolveImage(srcImageRange(in), destImage(out), kernel2d(gauss),
+                      CONVOLVE_FFT);
+        shouldEqualSequenceTolerance(out.begin(), out.end(), ref.begin(), 1e-10);
+
+        out.init(0.0);
+        convolveImage(srcImageRange(in), destImage(out), kernel2d(gauss),
+                      CONVOLVE_AUTO);
+        shouldEqualSequenceTolerance(out.begin(), out.end(), ref.begin(), 1e-10);
+    }
 };
 
 struct FFTWTestSuite
@@ -716,6 +743,7 @@ struct FFTWTestSuite
         add( testCase(&MultiFFTTest::testConvolveFFT));
         add( testCase(&MultiFFTTest::testConvolveFFTComplex));
         add( testCase(&MultiFFTTest::testConvolveFourierKernel));
+        add( testCase(&MultiFFTTest::testConvolveImageDispatch));
     }
 };
 
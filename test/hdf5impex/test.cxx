@@ -832,6 +832,56 @@ public:
     }
 
 
+    // block processor for testHDF5FileBlockwiseAccess(): copies each block
+    // into the right position of the result array
+    struct BlockwiseAssembler
+    {
+        MultiArray< 3, double > & result;
+
+        BlockwiseAssembler(MultiArray< 3, double > & r)
+        : result(r)
+        {}
+
+        void operator()(MultiArrayShape<3>::type blockOffset,
+                        MultiArrayView<3, double, UnstridedArrayTag> const & block)
+        {
+            for (int i = 0; i < block.shape(0); ++i)
+                for (int j = 0; j < block.shape(1); ++j)
+                    for (int k = 0; k < block.shape(2); ++k)
+                        result(blockOffset[0]+i, blockOffset[1]+j, blockOffset[2]+k) = block(i,j,k);
+        }
+    };
+
+    void testHDF5FileBlockwiseAccess()
+    {
+        // Create 3D dataset
+        MultiArray< 3, double > out_data(MultiArrayShape<3>::type(30, 20, 10));
+        // ...initialize the array to the test data
+        for (int i = 0; i < 30; ++i)
+            for (int j = 0; j < 20; ++j)
+                for (int k = 0; k < 10; ++k)
+                    out_data (i,j,k) = 100*i+10*j+k;
+
+        std::string file_name( "testfile_HDF5File_blockwise_access.hdf5");
+
+        //create a file and write the data with chunks and compression
+        HDF5File file (file_name, HDF5File::New);
+        file.write("/dataset", out_data, MultiArrayShape<3>::type(8,8,8), 3);
+        file.flushToDisk();
+
+        // enlarge the chunk cache so that all chunks a block touches fit in
+        file.setChunkCache(1 << 22, 1009);
+
+        // stream the dataset block-by-block (the blocks cross chunk borders
+        // and the blocks at the upper borders are smaller)
+        MultiArray< 3, double > in_data(out_data.shape());
+        BlockwiseAssembler assembler(in_data);
+        file.readBlockwise<3, double>("/dataset", MultiArrayShape<3>::type(16,16,16), assembler);
+
+        should(in_data == out_data);
+    }
+
+
 
 
     void testHDF5FileChunks()
@@ -1298,6 +1348,7 @@ struct HDF5ImportExportTestSuite : public vigra::test_suite
         // HDF5File tests
         add(testCase(&HDF5ExportImportTest::testHDF5FileDataAccess));
         add(testCase(&HDF5ExportImportTest::testHDF5FileBlockAccess));
+        add(testCase(&HDF5ExportImportTest::testHDF5FileBlockwiseAccess));
         add(testCase(&HDF5ExportImportTest::testHDF5FileChunks));
         add(testCase(&HDF5ExportImportTest::testHDF5FileCompression));
         add(testCase(&HDF5ExportImportTest::testHDF5FileBrowsing));
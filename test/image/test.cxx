@@ -353,6 +353,28 @@ struct BasicImageTest
         shouldEqual(other.height(), 3);
         shouldEqual(other(2,2), this->data[8]);
     }
+
+#ifdef VIGRA_HAS_RVALUE_REFERENCES
+    void moveImage()
+    {
+        typename IMAGE::value_type * p = &this->img(0,0);
+
+        IMAGE other(static_cast<IMAGE &&>(this->img));
+
+        shouldEqual(&other(0,0), p);
+        shouldEqual(other.width(), 3);
+        shouldEqual(other(2,2), this->data[8]);
+        shouldEqual(this->img.width(), 0);
+        shouldEqual(this->img.height(), 0);
+
+        this->img = static_cast<IMAGE &&>(other);
+
+        shouldEqual(&this->img(0,0), p);
+        shouldEqual(this->img(2,2), this->data[8]);
+        shouldEqual(other.width(), 0);
+        shouldEqual(other.height(), 0);
+    }
+#endif
 };
 
 template <class IMAGE>
@@ -457,6 +479,9 @@ struct ImageTestSuite
         add( testCase( &BasicImageTest<BasicImage<unsigned char> >::testConstructor));
         add( testCase( &BasicImageTest<BasicImage<unsigned char> >::copyImage));
         add( testCase( &BasicImageTest<BasicImage<unsigned char> >::swapImage));
+#ifdef VIGRA_HAS_RVALUE_REFERENCES
+        add( testCase( &BasicImageTest<BasicImage<unsigned char> >::moveImage));
+#endif
         add( testCase( &BasicImageTest<BasicImage<double> >::testIterator));
         add( testCase( &BasicImageTest<BasicImage<double> >::testIndex));
         add( testCase( &BasicImageTest<BasicImage<double> >::testConstructor));
@@ -858,6 +883,69 @@ struct CrackContourCirculatorTest
         should(crackCirc == end);
     }
 
+    void testExtractContours()
+    {
+        vigra::ArrayVector<vigra::Point2D> points;
+        vigra::ArrayVector<unsigned int> contourOffsets;
+        vigra::ArrayVector<int> contourLabels;
+
+        unsigned int count = vigra::extractContours(srcImageRange(img),
+                                                    points, contourOffsets,
+                                                    contourLabels, 2);
+
+        // one outer contour per region plus one hole contour of the
+        // background around the 1-region
+        shouldEqual(count, 3u);
+        shouldEqual(contourOffsets.size(), 4u);
+        shouldEqual(contourOffsets[0], 0u);
+        shouldEqual(contourOffsets[count], (unsigned int)points.size());
+        shouldEqual(contourLabels[0], 0);
+        shouldEqual(contourLabels[1], 1);
+        shouldEqual(contourLabels[2], 0);
+
+        // the outer contour of the background runs along the image border
+        shouldEqual(contourOffsets[1] - contourOffsets[0], 32u);
+        shouldEqual(points[0], vigra::Point2D(0, 0));
+
+        // the contour of the 1-region equals the trace of testInit(),
+        // anchored at the upper left corner of the start pixel (1,1)
+        CrackCirc crackCirc(img.upperLeft() + vigra::Diff2D(1, 1));
+        for(unsigned int k = contourOffsets[1]; k < contourOffsets[2]; ++k, ++crackCirc)
+            shouldEqual(points[k], vigra::Point2D(1, 1) + crackCirc.pos());
+
+        // signed areas: each region's contour areas sum to its pixel count
+        double areas[3];
+        for(unsigned int i = 0; i < count; ++i)
+        {
+            unsigned int begin = contourOffsets[i], end = contourOffsets[i+1];
+            double area = 0.0;
+            for(unsigned int k = begin; k < end; ++k)
+            {
+                vigra::Point2D p = points[k],
+                               q = points[k+1 == end ? begin : k+1];
+                area += (q.x - p.x)*p.y - (q.y - p.y)*p.x;
+            }
+            areas[i] = area / 2.0;
+        }
+        shouldEqual(areas[1], 24.0);              // the 1-region has 24 pixels
+        shouldEqual(areas[0] + areas[2], 40.0);   // the background has 40 pixels
+
+        // a boundary label occurring on the image border must be refused
+        try
+        {
+            vigra::extractContours(srcImageRange(img),
+                                   points, contourOffsets, contourLabels, 0);
+            failTest("no exception thrown");
+        }
+        catch(vigra::ContractViolation & e)
+        {
+            std::string expected("\nPrecondition violation!\n"
+                 "extractContours(): boundaryLabel must differ from all labels on the image border.");
+            std::string message(e.what());
+            should(0 == expected.compare(message.substr(0, expected.size())));
+        }
+    }
+
 };
 
 struct NeighborhoodCirculatorTestSuite
@@ -886,6 +974,7 @@ struct CrackContourCirculatorTestSuite
     : vigra::test_suite("CrackContourCirculatorTestSuite")
     {
         add( testCase( &CrackContourCirculatorTest::testInit));
+        add( testCase( &CrackContourCirculatorTest::testExtractContours));
    }
 };
 
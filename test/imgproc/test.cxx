@@ -106,6 +106,90 @@ struct ImageFunctionsTest
 
     }
 
+    void copyImageFastPathTest()
+    {
+        // large scalar copy (memcpy rows + parallel strips)
+        int w = 300, h = 300;
+        Image src(w,h), dest(w,h), pdest(w,h);
+        for(int y=0; y<h; ++y)
+            for(int x=0; x<w; ++x)
+                src(x,y) = 0.5*x - 0.25*y + 0.125;
+
+        copyImage(srcImageRange(src), destImage(dest));
+        shouldEqualSequence(src.begin(), src.end(), dest.begin());
+
+        copyImage(srcImageRange(src), destImage(pdest),
+                  vigra::ParallelOptions().numThreads(3));
+        shouldEqualSequence(src.begin(), src.end(), pdest.begin());
+
+        // RGB copy with identical channel order
+        RGBImage rgbSrc(5,4), rgbDest(5,4);
+        for(int y=0; y<4; ++y)
+            for(int x=0; x<5; ++x)
+                rgbSrc(x,y) = RGBValue(x + 0.1, y + 0.2, x*y + 0.3);
+
+        copyImage(srcImageRange(rgbSrc), destImage(rgbDest));
+        shouldEqualSequence(rgbSrc.begin(), rgbSrc.end(), rgbDest.begin());
+
+        // small images fall through to the serial code path
+        Image small(3,3);
+        copyImage(srcImageRange(img), destImage(small),
+                  vigra::ParallelOptions().numThreads(3));
+        shouldEqualSequence(img.begin(), img.end(), small.begin());
+    }
+
+    void contiguousFastPathTest()
+    {
+        // full images are handled by the fused 1-D loop over contiguous
+        // memory, interior ROIs by the row-by-row fallback; both must
+        // produce the same results
+        int w = 37, h = 23;
+        Image src(w,h), dest(w,h), roi(w,h);
+        for(int y=0; y<h; ++y)
+            for(int x=0; x<w; ++x)
+                src(x,y) = 0.25*x + 0.5*y + 0.125;
+
+        copyImage(srcImageRange(src), destImage(dest));
+        shouldEqualSequence(src.begin(), src.end(), dest.begin());
+
+        roi = 42.0;
+        copyImage(src.upperLeft() + vigra::Diff2D(1,1), src.lowerRight() - vigra::Diff2D(1,1),
+                  src.accessor(), roi.upperLeft() + vigra::Diff2D(1,1), roi.accessor());
+        for(int y=0; y<h; ++y)
+            for(int x=0; x<w; ++x)
+                shouldEqual(roi(x,y),
+                    (x == 0 || y == 0 || x == w-1 || y == h-1) ? 42.0 : src(x,y));
+
+        transformImage(srcImageRange(src), destImage(dest),
+                       vigra::linearIntensityTransform(2.0, 1.0));
+        for(int y=0; y<h; ++y)
+            for(int x=0; x<w; ++x)
+                shouldEqualTolerance(dest(x,y), 2.0*(src(x,y) + 1.0), 1e-14);
+
+        double s = 0.0, sroi = 0.0;
+        for(int y=0; y<h; ++y)
+            for(int x=0; x<w; ++x)
+            {
+                s += src(x,y);
+                if(x > 0 && y > 0 && x < w-1 && y < h-1)
+                    sroi += src(x,y);
+            }
+
+        vigra::FindAverage<Image::value_type> average, averageROI;
+        inspectImage(srcImageRange(src), average);
+        shouldEqualTolerance(average(), s/(w*h), 1e-12);
+
+        inspectImage(src.upperLeft() + vigra::Diff2D(1,1), src.lowerRight() - vigra::Diff2D(1,1),
+                     src.accessor(), averageROI);
+        shouldEqualTolerance(averageROI(), sroi/((w-2)*(h-2)), 1e-12);
+
+        vigra::IImage labels(w,h);
+        labels = 0;
+        vigra::ArrayOfRegionStatistics<vigra::FindAverage<Image::value_type> > stats(0);
+        inspectTwoImages(srcImageRange(src), srcImage(labels), stats);
+        shouldEqualTolerance(stats[0](), s/(w*h), 1e-12);
+    }
+
     void copyImageIfTest()
     {
         Image img1(3,3);
@@ -772,6 +856,47 @@ struct ImageFunctionsTest
         should(col.blue() < rgbf(col).blue());
     }
 
+    void lutFunctorTest()
+    {
+        // the LUT-compiled functor must reproduce the wrapped functor exactly
+        vigra::GammaFunctor<double> gamma(0.45, 0.0, 255.0);
+        vigra::LUTFunctor<unsigned char, vigra::GammaFunctor<double> > lut(gamma);
+
+        for(int k = 0; k < 256; ++k)
+            shouldEqual(lut((unsigned char)k), gamma((unsigned char)k));
+
+        // signed 16-bit domain, negative arguments included
+        vigra::BrightnessContrastFunctor<double> bc(1.3, 1.1, -32768.0, 32767.0);
+        vigra::LUTFunctor<vigra::Int16, vigra::BrightnessContrastFunctor<double> > blut(bc);
+
+        for(int k = -32768; k < 32768; k += 257)
+            shouldEqual(blut((vigra::Int16)k), bc((vigra::Int16)k));
+
+        // application via transformImage
+        vigra::BImage bimg(3, 3), bres(3, 3), bref(3, 3);
+        for(int k = 0; k < 9; ++k)
+            bimg.begin()[k] = (unsigned char)(k * 28);
+
+        transformImage(srcImageRange(bimg), destImage(bres),
+                       vigra::lutFunctor<unsigned char>(gamma));
+        transformImage(srcImageRange(bimg), destImage(bref), gamma);
+
+        shouldEqualSequence(bres.begin(), bres.end(), bref.begin());
+
+        // domains larger than 16 bit are rejected
+        try
+        {
+            vigra::LUTFunctor<int, vigra::GammaFunctor<double> > toobig(gamma);
+            failTest("no exception thrown");
+        }
+        catch(vigra::ContractViolation & e)
+        {
+            std::string expected("\nPrecondition violation!\nLUTFunctor(): argument domain too large");
+            std::string message(e.what());
+            should(0 == expected.compare(message.substr(0, expected.size())));
+        }
+    }
+
     void gradientFunctionTest()
     {
         RGBImage in(3,3);
@@ -831,6 +956,84 @@ struct ImageFunctionsTest
 
     }
 
+    void parallelPointOperationsTest()
+    {
+        // large enough to take the parallel code path
+        int w = 300, h = 300;
+        Image src1(w,h), src2(w,h), serial(w,h), parallel(w,h);
+        for(int y=0; y<h; ++y)
+        {
+            for(int x=0; x<w; ++x)
+            {
+                src1(x,y) = 0.5*x + 0.25*y;
+                src2(x,y) = x - 2.0*y;
+            }
+        }
+
+        vigra::ParallelOptions options = vigra::ParallelOptions().numThreads(3);
+
+        transformImage(srcImageRange(src1), destImage(serial),
+                       vigra::linearIntensityTransform<Image::value_type>(2.0, -1.1));
+        transformImage(srcImageRange(src1), destImage(parallel),
+                       vigra::linearIntensityTransform<Image::value_type>(2.0, -1.1),
+                       options);
+        shouldEqualSequence(serial.begin(), serial.end(), parallel.begin());
+
+        std::plus<Image::value_type> add;
+        combineTwoImages(srcImageRange(src1), srcImage(src2), destImage(serial), add);
+        combineTwoImages(srcImageRange(src1), srcImage(src2), destImage(parallel), add,
+                         options);
+        shouldEqualSequence(serial.begin(), serial.end(), parallel.begin());
+
+        // small images fall through to the serial code path
+        Image small1(3,3), small2(3,3);
+        transformImage(srcImageRange(img), destImage(small1),
+                       vigra::linearIntensityTransform<Image::value_type>(2.0, -1.1),
+                       options);
+        transformImage(srcImageRange(img), destImage(small2),
+                       vigra::linearIntensityTransform<Image::value_type>(2.0, -1.1));
+        shouldEqualSequence(small2.begin(), small2.end(), small1.begin());
+
+        combineTwoImages(srcImageRange(img), srcImage(img), destImage(small1), add, options);
+        combineTwoImages(srcImageRange(img), srcImage(img), destImage(small2), add);
+        shouldEqualSequence(small2.begin(), small2.end(), small1.begin());
+    }
+
+    void parallelInspectImageTest()
+    {
+        // large enough to take the parallel code path
+        int w = 300, h = 300;
+        Image src(w,h);
+        for(int y=0; y<h; ++y)
+            for(int x=0; x<w; ++x)
+                src(x,y) = std::sin(0.1*x) + 0.25*y - 0.003*x*y;
+
+        vigra::ParallelOptions options = vigra::ParallelOptions().numThreads(3);
+
+        vigra::FindMinMax<Image::value_type> serialMinmax, parallelMinmax;
+        inspectImage(srcImageRange(src), serialMinmax);
+        inspectImage(srcImageRange(src), parallelMinmax, options);
+
+        shouldEqual(serialMinmax.count, parallelMinmax.count);
+        shouldEqual(serialMinmax.min, parallelMinmax.min);
+        shouldEqual(serialMinmax.max, parallelMinmax.max);
+
+        vigra::FindAverageAndVariance<Image::value_type> serialStats, parallelStats;
+        inspectImage(srcImageRange(src), serialStats);
+        inspectImage(srcImageRange(src), parallelStats, options);
+
+        shouldEqual(serialStats.count(), parallelStats.count());
+        shouldEqualTolerance(serialStats.average(), parallelStats.average(), 1e-12);
+        shouldEqualTolerance(serialStats.variance(), parallelStats.variance(), 1e-10);
+
+        // small images fall through to the serial code path
+        vigra::FindMinMax<Image::value_type> smallMinmax;
+        inspectImage(srcImageRange(img), smallMinmax, options);
+        should(smallMinmax.count == 9);
+        should(smallMinmax.max == 9.9);
+        should(smallMinmax.min == 1.1);
+    }
+
     void additionIfTest()
     {
         Image img1(3,3);
@@ -1087,6 +1290,31 @@ struct ResizeImageTest
         shouldEqualSequenceTolerance(img1.begin(), img1.end(), imgred.begin(), 1e-4f);
    }
 
+    void scalarParallel()
+    {
+        Image img1(289, 289), img2(289, 289);
+        resizeImageSplineInterpolation(srcImageRange(img), destImageRange(img1));
+        resizeImageSplineInterpolation(srcImageRange(img), destImageRange(img2),
+                                       BSpline<3, double>(),
+                                       ParallelOptions().numThreads(4));
+        shouldEqualSequence(img2.begin(), img2.end(), img1.begin());
+
+        Image img3(42, 42), img4(42, 42);
+        resizeImageSplineInterpolation(srcImageRange(img), destImageRange(img3));
+        resizeImageSplineInterpolation(srcImageRange(img), destImageRange(img4),
+                                       BSpline<3, double>(),
+                                       ParallelOptions().numThreads(4));
+        shouldEqualSequence(img4.begin(), img4.end(), img3.begin());
+
+        BImage b(img.width(), img.height()), b1(97, 123), b2(97, 123);
+        copyImage(srcImageRange(img), destImage(b));
+        resizeImageSplineInterpolation(srcImageRange(b), destImageRange(b1));
+        resizeImageSplineInterpolation(srcImageRange(b), destImageRange(b2),
+                                       BSpline<3, double>(),
+                                       ParallelOptions().numThreads(4));
+        shouldEqualSequence(b2.begin(), b2.end(), b1.begin());
+    }
+
     void rgbExpand()
     {
         ImageImportInfo info("lenna288rgbneu.xv");
@@ -1348,6 +1576,33 @@ struct SplineImageViewTest
         shouldEqualTolerance(f_x_y, view(x, y), 1e-12);
     }
 
+    void testLazyTiles()
+    {
+        SplineImageView<N, double> eager(srcImageRange(img));
+        SplineImageView<N, double> lazy(srcImageRange(img),
+                                        LazyTileOptions().tileSize(32));
+
+        // scattered samples, including points in the reflective border
+        for(double y = -3.3; y < img.height() + 3.0; y += 7.71)
+        {
+            for(double x = -2.7; x < img.width() + 3.0; x += 8.83)
+            {
+                shouldEqualTolerance(lazy(x, y), eager(x, y), 1e-12);
+                should(VIGRA_CSTD::fabs(lazy(x, y, 1, 0) - eager(x, y, 1, 0)) < 1e-9);
+                should(VIGRA_CSTD::fabs(lazy(x, y, 0, 1) - eager(x, y, 0, 1)) < 1e-9);
+            }
+        }
+
+        // requesting the full coefficient image computes the remaining tiles
+        typename SplineImageView<N, double>::InternalImage const & ec = eager.image();
+        typename SplineImageView<N, double>::InternalImage const & lc = lazy.image();
+        shouldEqual(lc.width(), ec.width());
+        shouldEqual(lc.height(), ec.height());
+        for(int y = 0; y < ec.height(); ++y)
+            for(int x = 0; x < ec.width(); ++x)
+                shouldEqualTolerance(lc(x, y), ec(x, y), 1e-12);
+    }
+
     void testImageResize()
     {
         char name[200];
@@ -1551,6 +1806,49 @@ struct GeometricTransformsTest
                 shouldEqual(img(x,y), res3(int(x*xfactor), int(y*yfactor)));
     }
 
+    void testBlockedTransposition()
+    {
+        Image res1(h, w), res2(h, w);
+
+        rotateImage(srcImageRange(img), destImage(res1), 90);
+        for(int y = 0; y < h; ++y)
+            for(int x = 0; x < w; ++x)
+                shouldEqual(img(x,y), res1(y, w-x-1));
+        rotateImage(srcImageRange(img), destImage(res2), 90,
+                    ParallelOptions().numThreads(4));
+        shouldEqualSequence(res2.begin(), res2.end(), res1.begin());
+
+        rotateImage(srcImageRange(img), destImage(res1), -90);
+        for(int y = 0; y < h; ++y)
+            for(int x = 0; x < w; ++x)
+                shouldEqual(img(x,y), res1(h-y-1, x));
+        rotateImage(srcImageRange(img), destImage(res2), -90,
+                    ParallelOptions().numThreads(4));
+        shouldEqualSequence(res2.begin(), res2.end(), res1.begin());
+
+        transposeImage(srcImageRange(img), destImage(res1), vigra::major);
+        for(int y = 0; y < h; ++y)
+            for(int x = 0; x < w; ++x)
+                shouldEqual(img(x,y), res1(y, x));
+        transposeImage(srcImageRange(img), destImage(res2), vigra::major,
+                       ParallelOptions().numThreads(4));
+        shouldEqualSequence(res2.begin(), res2.end(), res1.begin());
+
+        transposeImage(srcImageRange(img), destImage(res1), vigra::minor);
+        for(int y = 0; y < h; ++y)
+            for(int x = 0; x < w; ++x)
+                shouldEqual(img(x,y), res1(h-y-1, w-x-1));
+        transposeImage(srcImageRange(img), destImage(res2), vigra::minor,
+                       ParallelOptions().numThreads(4));
+        shouldEqualSequence(res2.begin(), res2.end(), res1.begin());
+
+        Image res3(img.size()), res4(img.size());
+        rotateImage(srcImageRange(img), destImage(res3), 180);
+        rotateImage(srcImageRange(img), destImage(res4), 180,
+                    ParallelOptions().numThreads(4));
+        shouldEqualSequence(res4.begin(), res4.end(), res3.begin());
+    }
+
     void testAffineMatrix()
     {
         typedef TinyVector<double, 2> Vector2;
@@ -1626,6 +1924,8 @@ struct ImageFunctionsTestSuite
     : vigra::test_suite("ImageFunctionsTestSuite")
     {
         add( testCase( &ImageFunctionsTest::copyImageTest));
+        add( testCase( &ImageFunctionsTest::copyImageFastPathTest));
+        add( testCase( &ImageFunctionsTest::contiguousFastPathTest));
         add( testCase( &ImageFunctionsTest::copyImageIfTest));
         add( testCase( &ImageFunctionsTest::copyRedBandTest));
         add( testCase( &ImageFunctionsTest::copyGreenBandTest));
@@ -1653,8 +1953,11 @@ struct ImageFunctionsTestSuite
         add( testCase( &ImageFunctionsTest::linearRangeMappingTest));
         add( testCase( &ImageFunctionsTest::thresholdTest));
         add( testCase( &ImageFunctionsTest::brightnessContrastTest));
+        add( testCase( &ImageFunctionsTest::lutFunctorTest));
         add( testCase( &ImageFunctionsTest::gradientFunctionTest));
         add( testCase( &ImageFunctionsTest::additionTest));
+        add( testCase( &ImageFunctionsTest::parallelPointOperationsTest));
+        add( testCase( &ImageFunctionsTest::parallelInspectImageTest));
         add( testCase( &ImageFunctionsTest::additionIfTest));
         add( testCase( &ImageFunctionsTest::resizeNoInterpolationTest));
         add( testCase( &ImageFunctionsTest::resizeLinearInterpolationTest));
@@ -1662,6 +1965,7 @@ struct ImageFunctionsTestSuite
         add( testCase( &ResizeImageTest::resizeLinearInterpolationReduceTest));
         add( testCase( &ResizeImageTest::scalarExpand));
         add( testCase( &ResizeImageTest::scalarReduce));
+        add( testCase( &ResizeImageTest::scalarParallel));
         add( testCase( &ResizeImageTest::rgbExpand));
         add( testCase( &ResizeImageTest::rgbReduce));
         add( testCase( &ResizeImageTest::testCatmullRomInterpolationExtensionWithLena));
@@ -1681,17 +1985,21 @@ struct ImageFunctionsTestSuite
         add( testCase( &SplineImageViewTest<2>::testCoefficientArray));
         add( testCase( &SplineImageViewTest<2>::testImageResize));
         add( testCase( &SplineImageViewTest<2>::testOutside));
+        add( testCase( &SplineImageViewTest<2>::testLazyTiles));
         add( testCase( &SplineImageViewTest<3>::testPSF));
         add( testCase( &SplineImageViewTest<3>::testCoefficientArray));
         add( testCase( &SplineImageViewTest<3>::testImageResize));
         add( testCase( &SplineImageViewTest<3>::testOutside));
+        add( testCase( &SplineImageViewTest<3>::testLazyTiles));
         add( testCase( &SplineImageViewTest<5>::testPSF));
         add( testCase( &SplineImageViewTest<5>::testCoefficientArray));
         add( testCase( &SplineImageViewTest<5>::testImageResize));
         add( testCase( &SplineImageViewTest<5>::testOutside));
+        add( testCase( &SplineImageViewTest<5>::testLazyTiles));
         add( testCase( &SplineImageViewTest<5>::testVectorSIV));
 
         add( testCase( &GeometricTransformsTest::testSimpleGeometry));
+        add( testCase( &GeometricTransformsTest::testBlockedTransposition));
         add( testCase( &GeometricTransformsTest::testAffineMatrix));
         add( testCase( &GeometricTransformsTest::testRotation));
         add( testCase( &GeometricTransformsTest::testScaling));
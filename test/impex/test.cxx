@@ -34,6 +34,7 @@
 /************************************************************************/
 
 #include <iostream>
+#include <fstream>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
@@ -250,6 +251,194 @@ public:
 #endif
     }
 
+    void testTIFFRegion()
+    {
+#if defined(HasTIFF)
+        exportImage (srcImageRange (img), vigra::ImageExportInfo ("res.tif"));
+
+        vigra::ImageImportInfo info ("res.tif");
+
+        should (info.supportsRegionRead ());
+
+        vigra::Rect2D roi (vigra::Point2D (11, 17),
+                           vigra::Size2D (img.width () / 2, img.height () / 3));
+        Image res (roi.width (), roi.height ());
+
+        importImageRegion (info, roi, destImage (res));
+
+        for (int y = 0; y < res.height (); ++y)
+            for (int x = 0; x < res.width (); ++x)
+                shouldEqual (res (x, y), img (x + roi.left (), y + roi.top ()));
+#endif
+    }
+
+    void testBatchImport ()
+    {
+        vigra::ArrayVector<std::string> filenames;
+        for (int i = 0; i < 5; ++i)
+        {
+            std::string filename = std::string ("resbatch") +
+                                   vigra::asString (i) + ".pgm";
+            exportImage (srcImageRange (img),
+                         vigra::ImageExportInfo (filename.c_str ()));
+            filenames.push_back (filename);
+        }
+
+        vigra::ArrayVector<Image> res;
+        importImageBatch (filenames.begin (), filenames.end (), res,
+                          vigra::ParallelOptions ().numThreads (3));
+
+        shouldEqual (res.size (), filenames.size ());
+        for (unsigned int i = 0; i < res.size (); ++i)
+        {
+            shouldEqual (res[i].width (), img.width ());
+            shouldEqual (res[i].height (), img.height ());
+            shouldEqualSequence (res[i].begin (), res[i].end (), img.begin ());
+        }
+
+        try
+        {
+            filenames.push_back ("no-such-image.pgm");
+            importImageBatch (filenames.begin (), filenames.end (), res);
+            failTest ("importImageBatch() failed to throw on missing file");
+        }
+        catch (vigra::ContractViolation &) {}
+    }
+
+    // frame processor for testPipelineImport(): compares every frame
+    // against the reference image
+    struct PipelineChecker
+    {
+        Image const & reference;
+        int framesSeen;
+
+        PipelineChecker (Image const & ref)
+        : reference (ref),
+          framesSeen (0)
+        {}
+
+        void operator() (int frameIndex, Image const & frame)
+        {
+            shouldEqual (frameIndex, framesSeen);
+            shouldEqualSequence (frame.begin (), frame.end (),
+                                 reference.begin ());
+            ++framesSeen;
+        }
+    };
+
+    void testPipelineImport ()
+    {
+        vigra::ArrayVector<std::string> filenames;
+        for (int i = 0; i < 5; ++i)
+        {
+            std::string filename = std::string ("respipeline") +
+                                   vigra::asString (i) + ".pgm";
+            exportImage (srcImageRange (img),
+                         vigra::ImageExportInfo (filename.c_str ()));
+            filenames.push_back (filename);
+        }
+
+        PipelineChecker checker (img);
+        vigra::importImagePipeline<Image> (filenames.begin (),
+                                           filenames.end (), checker);
+        shouldEqual (checker.framesSeen, 5);
+
+        try
+        {
+            filenames.push_back ("no-such-image.pgm");
+            PipelineChecker checker2 (img);
+            vigra::importImagePipeline<Image> (filenames.begin (),
+                                               filenames.end (), checker2);
+            failTest ("importImagePipeline() failed to throw on missing file");
+        }
+        catch (std::runtime_error &) {} // decode errors are re-raised via vigra_fail()
+    }
+
+    void testDirectImport ()
+    {
+        // raw PGM supports direct reads into the destination array
+        exportImage (srcImageRange (img),
+                     vigra::ImageExportInfo ("resdirect.pgm"));
+
+        vigra::ImageImportInfo info ("resdirect.pgm");
+        vigra::MultiArray<2, vigra::UInt8> res (info.shape ());
+
+        importImageDirect (info, res);
+        shouldEqualSequence (res.begin (), res.end (), img.begin ());
+
+        // ASCII PNM has no mapped representation => fallback path
+        vigra::ImageExportInfo asciiinfo ("resdirectascii.pgm");
+        asciiinfo.setCompression ("ASCII");
+        exportImage (srcImageRange (img), asciiinfo);
+
+        vigra::ImageImportInfo info2 ("resdirectascii.pgm");
+        vigra::MultiArray<2, vigra::UInt8> res2 (info2.shape ());
+
+        importImageDirect (info2, res2);
+        shouldEqualSequence (res2.begin (), res2.end (), img.begin ());
+    }
+
+    void testMemoryImport ()
+    {
+#if defined(HasPNG)
+        exportImage (srcImageRange (img), vigra::ImageExportInfo ("resmem.png"));
+
+        // slurp the encoded file into memory to emulate an image
+        // that arrived over the network
+        std::ifstream stream ("resmem.png", std::ios::binary);
+        std::vector<unsigned char> data ((std::istreambuf_iterator<char> (stream)),
+                                         std::istreambuf_iterator<char> ());
+        stream.close ();
+
+        vigra::ImageImportInfo info (&data[0], data.size ());
+
+        should (info.width () == img.width ());
+        should (info.height () == img.height ());
+        should (info.getFileType () == std::string ("PNG"));
+
+        Image res (info.width (), info.height ());
+        importImage (info, destImage (res));
+
+        shouldEqualSequence (res.begin (), res.end (), img.begin ());
+
+        // formats without in-memory support must be rejected
+        exportImage (srcImageRange (img), vigra::ImageExportInfo ("resmem.bmp"));
+
+        std::ifstream bmpstream ("resmem.bmp", std::ios::binary);
+        std::vector<unsigned char> bmpdata ((std::istreambuf_iterator<char> (bmpstream)),
+                                            std::istreambuf_iterator<char> ());
+        bmpstream.close ();
+
+        try
+        {
+            vigra::ImageImportInfo bmpinfo (&bmpdata[0], bmpdata.size ());
+            failTest ("ImageImportInfo() failed to throw on unsupported format");
+        }
+        catch (vigra::ContractViolation &) {}
+#endif
+    }
+
+    void testPNGCompressionOptions ()
+    {
+#if defined(HasPNG)
+        const char * compressions[] = { "FAST", "BEST", "LOSSLESS QUALITY=2" };
+
+        for (int i = 0; i < 3; ++i)
+        {
+            vigra::ImageExportInfo exportinfo ("res.png");
+            exportinfo.setCompression (compressions[i]);
+            exportImage (srcImageRange (img), exportinfo);
+
+            vigra::ImageImportInfo info ("res.png");
+            Image res (info.width (), info.height ());
+            importImage (info, destImage (res));
+
+            // the speed/ratio tradeoff must not change the pixels
+            shouldEqualSequence (res.begin (), res.end (), img.begin ());
+        }
+#endif
+    }
+
     void testBMP ()
     {
         testFile ("res.bmp");
@@ -479,6 +668,29 @@ public:
         testFile ("res.bmp");
     }
 
+    void testDirectImport ()
+    {
+        // 24-bit BMP supports direct reads (exercises the BGR swizzle)
+        exportImage (srcImageRange (img),
+                     vigra::ImageExportInfo ("resdirectrgb.bmp"));
+
+        vigra::ImageImportInfo info ("resdirectrgb.bmp");
+        vigra::MultiArray<2, vigra::RGBValue<vigra::UInt8> > res (info.shape ());
+
+        importImageDirect (info, res);
+        shouldEqualSequence (res.begin (), res.end (), img.begin ());
+
+        // SUN raster has no direct-read support => fallback path
+        exportImage (srcImageRange (img),
+                     vigra::ImageExportInfo ("resdirectrgb.ras"));
+
+        vigra::ImageImportInfo info2 ("resdirectrgb.ras");
+        vigra::MultiArray<2, vigra::RGBValue<vigra::UInt8> > res2 (info2.shape ());
+
+        importImageDirect (info2, res2);
+        shouldEqualSequence (res2.begin (), res2.end (), img.begin ());
+    }
+
     void testPPM ()
     {
         testFile ("res.ppm");
@@ -1649,6 +1861,12 @@ struct ImageImportExportTestSuite : public vigra::test_suite
         add(testCase(&ByteImageExportImportTest::testJPEG));
         add(testCase(&ByteImageExportImportTest::testTIFF));
         add(testCase(&ByteImageExportImportTest::testTIFFSequence));
+        add(testCase(&ByteImageExportImportTest::testTIFFRegion));
+        add(testCase(&ByteImageExportImportTest::testBatchImport));
+        add(testCase(&ByteImageExportImportTest::testPipelineImport));
+        add(testCase(&ByteImageExportImportTest::testDirectImport));
+        add(testCase(&ByteImageExportImportTest::testMemoryImport));
+        add(testCase(&ByteImageExportImportTest::testPNGCompressionOptions));
         add(testCase(&ByteImageExportImportTest::testBMP));
         add(testCase(&ByteImageExportImportTest::testPGM));
         add(testCase(&ByteImageExportImportTest::testPNM));
@@ -1663,6 +1881,7 @@ struct ImageImportExportTestSuite : public vigra::test_suite
         add(testCase(&ByteRGBImageExportImportTest::testJPEG));
         add(testCase(&ByteRGBImageExportImportTest::testTIFF));
         add(testCase(&ByteRGBImageExportImportTest::testBMP));
+        add(testCase(&ByteRGBImageExportImportTest::testDirectImport));
         add(testCase(&ByteRGBImageExportImportTest::testPPM));
         add(testCase(&ByteRGBImageExportImportTest::testPNM));
         add(testCase(&ByteRGBImageExportImportTest::testPNM2));
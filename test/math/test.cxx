@@ -208,6 +208,105 @@ struct HighOrderPolynomialTest
     }
 };
 
+struct LowOrderRealRootsTest
+{
+    void testRealRoots()
+    {
+        double epsilon = 1e-12;
+
+        {   // (x-2)(x-3)
+            double c[] = { 6.0, -5.0, 1.0 };
+            vigra::Polynomial<double> p(c, 2);
+            vigra::ArrayVector<double> r;
+            should(polynomialRealRoots(p, r));
+            shouldEqual(r.size(), 2u);
+            shouldEqualTolerance(r[0], 2.0, epsilon);
+            shouldEqualTolerance(r[1], 3.0, epsilon);
+        }
+        {   // (x-2)^2
+            double c[] = { 4.0, -4.0, 1.0 };
+            vigra::Polynomial<double> p(c, 2);
+            vigra::ArrayVector<double> r;
+            should(polynomialRealRoots(p, r));
+            shouldEqual(r.size(), 2u);
+            shouldEqualTolerance(r[0], 2.0, epsilon);
+            shouldEqualTolerance(r[1], 2.0, epsilon);
+        }
+        {   // x^2 + 1 has no real roots
+            double c[] = { 1.0, 0.0, 1.0 };
+            vigra::Polynomial<double> p(c, 2);
+            vigra::ArrayVector<double> r;
+            should(polynomialRealRoots(p, r));
+            shouldEqual(r.size(), 0u);
+        }
+        {   // (x-1)(x^2+1)
+            double c[] = { -1.0, 1.0, -1.0, 1.0 };
+            vigra::Polynomial<double> p(c, 3);
+            vigra::ArrayVector<double> r;
+            should(polynomialRealRoots(p, r));
+            shouldEqual(r.size(), 1u);
+            shouldEqualTolerance(r[0], 1.0, epsilon);
+        }
+        {   // x(x+1)(x-2)
+            double c[] = { 0.0, -2.0, -1.0, 1.0 };
+            vigra::Polynomial<double> p(c, 3);
+            vigra::ArrayVector<double> r;
+            should(polynomialRealRoots(p, r));
+            shouldEqual(r.size(), 3u);
+            shouldEqualTolerance(r[0], -1.0, epsilon);
+            shouldEqualTolerance(r[1] + 1.0, 1.0, epsilon);  // r[1] == 0
+            shouldEqualTolerance(r[2], 2.0, epsilon);
+        }
+        {   // (x^2-1)(x^2-4) -- biquadratic
+            double c[] = { 4.0, 0.0, -5.0, 0.0, 1.0 };
+            vigra::Polynomial<double> p(c, 4);
+            vigra::ArrayVector<double> r;
+            should(polynomialRealRoots(p, r));
+            shouldEqual(r.size(), 4u);
+            shouldEqualTolerance(r[0], -2.0, epsilon);
+            shouldEqualTolerance(r[1], -1.0, epsilon);
+            shouldEqualTolerance(r[2], 1.0, epsilon);
+            shouldEqualTolerance(r[3], 2.0, epsilon);
+        }
+        {   // (x-1)(x-2)(x-3)(x+4) -- general quartic
+            double c[] = { -24.0, 38.0, -13.0, -2.0, 1.0 };
+            vigra::Polynomial<double> p(c, 4);
+            vigra::ArrayVector<double> r;
+            should(polynomialRealRoots(p, r));
+            shouldEqual(r.size(), 4u);
+            shouldEqualTolerance(r[0], -4.0, epsilon);
+            shouldEqualTolerance(r[1], 1.0, epsilon);
+            shouldEqualTolerance(r[2], 2.0, epsilon);
+            shouldEqualTolerance(r[3], 3.0, epsilon);
+        }
+        {   // (x^2+1)(x-1)(x+2) -- two real, two complex roots
+            double c[] = { -2.0, 1.0, -1.0, 1.0, 1.0 };
+            vigra::Polynomial<double> p(c, 4);
+            vigra::ArrayVector<double> r;
+            should(polynomialRealRoots(p, r));
+            shouldEqual(r.size(), 2u);
+            shouldEqualTolerance(r[0], -2.0, epsilon);
+            shouldEqualTolerance(r[1], 1.0, epsilon);
+        }
+        {   // (x^2+1)(x^2+4) has no real roots
+            double c[] = { 4.0, 0.0, 5.0, 0.0, 1.0 };
+            vigra::Polynomial<double> p(c, 4);
+            vigra::ArrayVector<double> r;
+            should(polynomialRealRoots(p, r));
+            shouldEqual(r.size(), 0u);
+        }
+        {   // StaticPolynomial works the same way
+            double c[] = { 6.0, -5.0, 1.0 };
+            vigra::StaticPolynomial<2, double> p(c, 2);
+            vigra::ArrayVector<double> r;
+            should(polynomialRealRoots(p, r));
+            shouldEqual(r.size(), 2u);
+            shouldEqualTolerance(r[0], 2.0, epsilon);
+            shouldEqualTolerance(r[1], 3.0, epsilon);
+        }
+    }
+};
+
 template <int ORDER>
 struct SplineTest
 {
@@ -275,6 +374,53 @@ struct SplineTest
             for(int i = 0; i < n; ++i)
                 shouldEqualTolerance(ws[d][i], wsb[d][i], 1e-14);
     }
+
+    void testWeightTable()
+    {
+        typedef vigra::SplineWeightTable<BS> Table;
+        Table table(64);
+        double tmin = (ORDER % 2) ? 0.0 : -0.5;
+        double kcenter = ORDER / 2;
+
+        shouldEqual(table.phaseCount(), 64u);
+        shouldEqual((int)Table::ksize, ORDER + 1);
+
+        // tabulated phases reproduce the spline functor exactly,
+        // and the order-0 weights sum to one
+        for(unsigned int p = 0; p <= 64; ++p)
+        {
+            double t = tmin + p * table.phaseStep();
+            double const * c = table.weightsAtPhase(p);
+            double sum = 0.0;
+            for(int i = 0; i <= ORDER; ++i)
+            {
+                shouldEqual(c[i], spline(t + kcenter - i));
+                sum += c[i];
+            }
+            if(ORDER > 0 || p < 64)  // the box spline has half-open support
+                shouldEqualTolerance(sum, 1.0, 1e-14);
+        }
+
+        // nearest-phase batch lookup
+        double c[ORDER+1];
+        table.weights(tmin + 0.3751, c);
+        shouldEqual(table.phaseIndex(tmin + 0.3751), 24u);
+        for(int i = 0; i <= ORDER; ++i)
+            shouldEqual(c[i], table.weightsAtPhase(24)[i]);
+
+        // derivative weights via a spline with non-zero derivative order
+        if(ORDER > 1)
+        {
+            Table dtable(64, BS(1));
+            for(unsigned int p = 0; p <= 64; ++p)
+            {
+                double t = tmin + p * dtable.phaseStep();
+                double const * dc = dtable.weightsAtPhase(p);
+                for(int i = 0; i <= ORDER; ++i)
+                    shouldEqual(dc[i], spline(t + kcenter - i, 1));
+            }
+        }
+    }
 };
 
 struct FunctionsTest
@@ -537,6 +683,55 @@ struct FunctionsTest
         }
     }
 
+    void testSpanFunctions()
+    {
+        // erfSpan: symmetric, and within the documented 1.5e-7 of erf()
+        double x[101], r[101];
+        for(int k = 0; k <= 100; ++k)
+            x[k] = 0.1*(k - 50);  // exactly antisymmetric grid
+        vigra::erfSpan(x, 101, r);
+        for(int k = 0; k <= 100; ++k)
+            shouldEqualTolerance(r[k], vigra::erf(x[k]), 1.5e-7);
+        for(int k = 0; k < 50; ++k)
+            shouldEqual(r[k], -r[100-k]);
+
+        // Bessel spans match the scalar functions (up to constant folding)
+        double bx[7] = { 0.0, 0.5, 1.0, 2.5, 4.0, 6.0, 11.0 };
+        int orders[6] = { -2, -1, 0, 1, 2, 5 };
+        for(int i = 0; i < 6; ++i)
+        {
+            int n = orders[i];
+            double jr[7], yr[7];
+            vigra::besselJSpan(n, bx, 7, jr);
+            vigra::besselYSpan(n, bx, 7, yr);
+            for(int k = 0; k < 7; ++k)
+            {
+                shouldEqualTolerance(jr[k] - vigra::besselJ(n, bx[k]), 0.0, 1e-15);
+                if(bx[k] == 0.0)
+                    should(yr[k] == -std::numeric_limits<double>::infinity());
+                else
+                    shouldEqualTolerance(yr[k] - vigra::besselY(n, bx[k]), 0.0, 1e-15);
+            }
+        }
+
+        // negative arguments are rejected like in the scalar functions
+        double neg = -1.0, dummy;
+        try
+        {
+            vigra::besselJSpan(0, &neg, 1, &dummy);
+            failTest("no exception thrown");
+        }
+        catch(std::domain_error &)
+        {}
+        try
+        {
+            vigra::besselYSpan(0, &neg, 1, &dummy);
+            failTest("no exception thrown");
+        }
+        catch(std::domain_error &)
+        {}
+    }
+
     void closeAtToleranceTest()
     {
         double a = 0.0, b = vigra::NumericTraits<double>::epsilon(), c = 1000.0, d = 1000.1;
@@ -1101,6 +1296,113 @@ struct QuaternionTest
         shouldEqualTolerance(norm(q4), 1.0, 1e-15);
         shouldEqualTolerance(q4[0], 0.0, 1e-15);
     }
+
+    void testRotatePoints()
+    {
+        Q q(1.0, 2.0, 3.0, 4.0);
+        q /= norm(q);
+
+        vigra::MultiArray<2, double> points(vigra::Shape2(3, 5)), res(vigra::Shape2(3, 5));
+        for(int k = 0; k < 5; ++k)
+        {
+            points(0, k) = 0.5*k - 1.0;
+            points(1, k) = 0.25*k*k - 2.0;
+            points(2, k) = 3.0 - k;
+        }
+
+        rotatePoints(q, points, res);
+
+        // reference: rotate each point individually via q * p * conj(q)
+        for(int k = 0; k < 5; ++k)
+        {
+            Q p(0.0, V(points(0, k), points(1, k), points(2, k)));
+            Q r = q * p * conj(q);
+            shouldEqualTolerance(res(0, k), r.x(), 1e-14);
+            shouldEqualTolerance(res(1, k), r.y(), 1e-14);
+            shouldEqualTolerance(res(2, k), r.z(), 1e-14);
+        }
+
+        // in-place operation
+        vigra::MultiArray<2, double> inplace(points);
+        rotatePoints(q, inplace, inplace);
+        shouldEqualSequenceTolerance(inplace.begin(), inplace.end(), res.begin(), 1e-15);
+
+        // shape checks
+        vigra::MultiArray<2, double> wrong(vigra::Shape2(5, 3));
+        try
+        {
+            rotatePoints(q, wrong, wrong);
+            failTest("no exception thrown");
+        }
+        catch(vigra::ContractViolation & c)
+        {
+            std::string expected("\nPrecondition violation!\nrotatePoints(): points must have shape 3 x N.");
+            std::string message(c.what());
+            should(0 == expected.compare(message.substr(0, expected.size())));
+        }
+    }
+
+    static void checkQuaternion(Q const & q, Q const & ref, double epsilon)
+    {
+        for(int k = 0; k < 4; ++k)
+            shouldEqualTolerance(q[k], ref[k], epsilon);
+    }
+
+    void testSlerp()
+    {
+        V axis(1.0, 2.0, -1.0);
+        axis /= vigra::norm(axis);
+        double angle = 2.0;
+
+        Q q0 = Q::createRotation(0.3, axis),
+          q1 = q0 * Q::createRotation(angle, axis);
+
+        // endpoints are reproduced
+        checkQuaternion(slerp(q0, q1, 0.0), q0, 1e-15);
+        checkQuaternion(slerp(q0, q1, 1.0), q1, 1e-15);
+
+        // constant angular velocity: slerp(t) equals rotation by t*angle
+        for(int k = 0; k <= 10; ++k)
+        {
+            double t = 0.1*k;
+            Q ref = q0 * Q::createRotation(t*angle, axis),
+              s   = slerp(q0, q1, t);
+            shouldEqualTolerance(norm(s), 1.0, 1e-15);
+            checkQuaternion(s, ref, 1e-14);
+        }
+
+        // -q1 represents the same rotation => interpolation takes the short arc
+        checkQuaternion(slerp(q0, -q1, 0.5), slerp(q0, q1, 0.5), 1e-14);
+
+        // nearly identical rotations use the linear fallback
+        Q qeps = q0 * Q::createRotation(1e-7, axis),
+          s3   = slerp(q0, qeps, 0.5),
+          ref3 = q0 * Q::createRotation(0.5e-7, axis);
+        shouldEqualTolerance(norm(s3), 1.0, 1e-15);
+        checkQuaternion(s3, ref3, 1e-14);
+
+        // trajectory resampling with clamping outside the key frame range
+        vigra::ArrayVector<double> keyTimes, sampleTimes;
+        vigra::ArrayVector<Q> keys, res;
+        keyTimes.push_back(0.0);
+        keyTimes.push_back(1.0);
+        keyTimes.push_back(3.0);
+        keys.push_back(q0);
+        keys.push_back(q1);
+        keys.push_back(q0);
+        sampleTimes.push_back(-1.0);
+        sampleTimes.push_back(0.5);
+        sampleTimes.push_back(2.0);
+        sampleTimes.push_back(4.0);
+
+        slerpTrajectory(keyTimes, keys, sampleTimes, res);
+
+        shouldEqual(res.size(), 4u);
+        checkQuaternion(res[0], q0, 1e-15);
+        checkQuaternion(res[1], slerp(q0, q1, 0.5), 1e-15);
+        checkQuaternion(res[2], slerp(q1, q0, 0.5), 1e-15);
+        checkQuaternion(res[3], q0, 1e-15);
+    }
 };
 
 struct FixedPointTest
@@ -1833,7 +2135,47 @@ struct LinalgTest
         Matrix matColumnMean = Matrix(1, 2, columnMean);
         Matrix matRowMean = Matrix(3, 1, rowMean);
         shouldEqualSequence(matColumnMean.data(), matColumnMean.data()+2, a.mean(0).data());
-        shouldEqualSequence(matRowMean.data(), matRowMean.data()+3, a.mean(1).data());  
+        shouldEqualSequence(matRowMean.data(), matRowMean.data()+3, a.mean(1).data());
+    }
+
+    void testBlockedMultiply()
+    {
+        // odd sizes exercise the partial blocks of the cache-blocked kernel
+        unsigned int m = 97, k = 70, n = 65;
+        Matrix a = random_matrix(m, k), b = random_matrix(k, n), r(m, n);
+        mmul(a, b, r);
+        for(unsigned int j = 0; j < m; ++j)
+        {
+            for(unsigned int i = 0; i < n; ++i)
+            {
+                double ref = a(j, 0) * b(0, i);
+                for(unsigned int l = 1; l < k; ++l)
+                    ref += a(j, l) * b(l, i);
+                shouldEqual(r(j, i), ref);
+            }
+        }
+
+        // subarrays have contiguous columns but padded leading dimensions
+        Matrix rsub(m - 7, n - 5);
+        mmul(a.subarray(Shape(3, 2), Shape(m - 4, k - 1)),
+             b.subarray(Shape(2, 1), Shape(k - 1, n - 4)), rsub);
+        for(unsigned int j = 0; j < m - 7; ++j)
+        {
+            for(unsigned int i = 0; i < n - 5; ++i)
+            {
+                double ref = 0.0;
+                for(unsigned int l = 0; l < k - 3; ++l)
+                    ref += a(j + 3, l + 2) * b(l + 2, i + 1);
+                shouldEqual(rsub(j, i), ref);
+            }
+        }
+
+        // transposed views are strided and take the generic code path
+        Matrix rt(n, m);
+        mmul(transpose(b), transpose(a), rt);
+        for(unsigned int j = 0; j < m; ++j)
+            for(unsigned int i = 0; i < n; ++i)
+                shouldEqual(rt(i, j), r(j, i));
     }
 
     void testArgMinMax()
@@ -2092,6 +2434,35 @@ struct LinalgTest
         }
     }
 
+    void testBlockedCholesky()
+    {
+        // more than 64 columns triggers the blocked right-looking algorithm
+        unsigned int n = 150;
+        double epsilon = 1e-9;
+
+        Matrix a = random_matrix (n, n);
+        a = transpose(a) * a; // make a symmetric positive definite matrix
+        Matrix l(n, n), lp(n, n);
+
+        choleskyDecomposition (a, l);
+        Matrix ch = l * transpose(l);
+        shouldEqualSequenceTolerance(ch.data(), ch.data()+n*n, a.data(), epsilon);
+
+        // the parallel variant must reproduce the serial result exactly
+        choleskyDecomposition (a, lp, vigra::ParallelOptions().numThreads(4));
+        shouldEqualSequence(lp.data(), lp.data()+n*n, l.data());
+
+        Matrix b = random_matrix (n, 1), x(n, 1);
+        should(linearSolve (a, b, x, "Cholesky", vigra::ParallelOptions().numThreads(4)));
+        Matrix ax = a * x;
+        shouldEqualSequenceTolerance(ax.data(), ax.data()+n, b.data(), 1e-6);
+
+        // not positive definite => failure
+        Matrix s = vigra::identityMatrix<double>(n);
+        s(n-1, n-1) = -1.0;
+        should(!choleskyDecomposition (s, l, vigra::ParallelOptions().numThreads(4)));
+    }
+
     void testQR()
     {
         double epsilon = 1e-11;
@@ -2418,6 +2789,48 @@ struct LinalgTest
         }
     }
 
+    void testSymmetricEigensystemFixedSize()
+    {
+        double epsilon = 1e-10;
+
+        for(int size = 2; size <= 3; ++size)
+        {
+            Matrix idref = vigra::identityMatrix<double>(size);
+            for(unsigned int i = 0; i < 20; ++i)
+            {
+                Matrix a = random_symmetric_matrix (size);
+                Matrix ew(size, 1);
+                Matrix ev(size, size);
+                should(symmetricEigensystem(a, ew, ev));
+                for(int k = 1; k < size; ++k)
+                    should(ew(k-1,0) >= ew(k,0));
+                Matrix id = ev * transpose(ev);
+                shouldEqualSequenceTolerance(id.data(), id.data()+size*size, idref.data(), epsilon);
+                Matrix ae = ev * diagonalMatrix(ew) * transpose(ev);
+                shouldEqualSequenceTolerance(ae.data(), ae.data()+size*size, a.data(), epsilon);
+            }
+        }
+
+        // repeated eigenvalues take the iterative fallback
+        double ddata[] = {2.0, 0.0, 0.0,
+                          0.0, 1.0, 0.0,
+                          0.0, 0.0, 1.0};
+        Matrix d(3, 3, ddata), ew(3, 1), ev(3, 3);
+        should(symmetricEigensystem(d, ew, ev));
+        shouldEqualTolerance(ew(0,0), 2.0, epsilon);
+        shouldEqualTolerance(ew(1,0), 1.0, epsilon);
+        shouldEqualTolerance(ew(2,0), 1.0, epsilon);
+        Matrix dd = ev * diagonalMatrix(ew) * transpose(ev);
+        shouldEqualSequenceTolerance(dd.data(), dd.data()+9, d.data(), epsilon);
+
+        // multiples of the identity
+        Matrix s = 3.0 * vigra::identityMatrix<double>(2);
+        Matrix ew2(2, 1), ev2(2, 2);
+        should(symmetricEigensystem(s, ew2, ev2));
+        shouldEqual(ew2(0,0), 3.0);
+        shouldEqual(ew2(1,0), 3.0);
+    }
+
     void testNonsymmetricEigensystem()
     {
         double epsilon = 1e-8;
@@ -2493,6 +2906,41 @@ struct LinalgTest
         shouldEqualToleranceMessage(vigra::norm(vigra::identityMatrix<double>(4) - transpose(v)*v), 0.0, eps, VIGRA_TOLERANCE_MESSAGE);
         shouldEqualToleranceMessage(vigra::norm(vigra::identityMatrix<double>(4) - v*transpose(v)), 0.0, eps, VIGRA_TOLERANCE_MESSAGE);
     }
+
+    void testSVDTallSkinny()
+    {
+        // more than three times as many rows as columns takes the QR-based path
+        unsigned int m = 201, n = 7;
+        Matrix a = random_matrix(m, n);
+        Matrix u(m, n), up(m, n);
+        Matrix v(n, n), vp(n, n);
+        Matrix S(n, 1), Sp(n, 1);
+
+        unsigned int rank = singularValueDecomposition(a, u, S, v);
+        shouldEqual(rank, n);
+        for(unsigned int k = 1; k < n; ++k)
+            should(S(k-1, 0) >= S(k, 0));
+
+        double eps = 1e-10;
+
+        shouldEqualToleranceMessage(vigra::norm(a-u*diagonalMatrix(S)*transpose(v)), 0.0, eps, VIGRA_TOLERANCE_MESSAGE);
+        shouldEqualToleranceMessage(vigra::norm(vigra::identityMatrix<double>(n) - transpose(u)*u), 0.0, eps, VIGRA_TOLERANCE_MESSAGE);
+        shouldEqualToleranceMessage(vigra::norm(vigra::identityMatrix<double>(n) - transpose(v)*v), 0.0, eps, VIGRA_TOLERANCE_MESSAGE);
+
+        // the parallel overload must reproduce the serial result exactly
+        unsigned int rankp = singularValueDecomposition(a, up, Sp, vp,
+                                                        vigra::ParallelOptions().numThreads(4));
+        shouldEqual(rankp, rank);
+        shouldEqualSequence(Sp.data(), Sp.data()+n, S.data());
+        shouldEqualSequence(up.data(), up.data()+m*n, u.data());
+        shouldEqualSequence(vp.data(), vp.data()+n*n, v.data());
+
+        // rank deficiency is detected
+        columnVector(a, n-1) = columnVector(a, 0);
+        rank = singularValueDecomposition(a, u, S, v);
+        shouldEqual(rank, n-1);
+        shouldEqualToleranceMessage(vigra::norm(a-u*diagonalMatrix(S)*transpose(v)), 0.0, eps, VIGRA_TOLERANCE_MESSAGE);
+    }
 };
 
 struct RandomTest
@@ -2604,6 +3052,63 @@ struct RandomTest
             shouldEqual(randoma(), lasta[k]);
     }
 
+    void testPhilox()
+    {
+        const unsigned int n = 12;
+        // known-answer vector of Philox4x32-10 for key {0, 0}, counter zero
+        // (cf. the Random123 reference implementation), seed 0 == stream 0
+        unsigned int iref[n] = {
+            1713891541U, 3781805453U, 3159862348U, 2600524760U, 4175744164U,
+            1555169499U, 2980410603U,  159317863U,   83534633U, 1372009126U,
+             605361069U, 1167144420U };
+        unsigned int iref1[n] = {
+            4259200523U, 4202584246U,  864087110U, 3637861455U, 3438479210U,
+            1661400116U, 3198622053U, 3647988874U, 2671459428U, 1088638526U,
+            1658722418U, 1632231062U };
+
+        vigra::RandomPhilox random(0u);
+        for(unsigned int k=0; k<n; ++k)
+            shouldEqual(random(), iref[k]);
+
+        // the pair (seed, stream id) fully determines the sequence
+        vigra::RandomPhilox stream1(0u);
+        stream1.setStream(1);
+        shouldEqual(stream1.stream(), 1u);
+        for(unsigned int k=0; k<n; ++k)
+            shouldEqual(stream1(), iref1[k]);
+
+        // reseeding and re-splitting restarts the very same stream
+        vigra::RandomPhilox random2(0xDEADBEEF);
+        random2.setStream(3);
+        unsigned int first[n];
+        for(unsigned int k=0; k<n; ++k)
+            first[k] = random2();
+        for(unsigned int k=0; k<1000; ++k)
+            random2();
+        random2.seed(0xDEADBEEFu);
+        random2.setStream(3);
+        for(unsigned int k=0; k<n; ++k)
+            shouldEqual(random2(), first[k]);
+
+        // streams of the same seed are independent
+        vigra::RandomPhilox stream4(0xDEADBEEF), stream5(0xDEADBEEF);
+        stream4.setStream(4);
+        stream5.setStream(5);
+        unsigned int equal = 0;
+        for(unsigned int k=0; k<1000; ++k)
+            if(stream4() == stream5())
+                ++equal;
+        should(equal < 3);
+
+        for(unsigned int k=0; k<1000; ++k)
+            should(random2.uniformInt(31) < 31);
+        for(unsigned int k=0; k<1000; ++k)
+        {
+            double u = random2.uniform53();
+            should(0.0 <= u && u < 1.0);
+        }
+    }
+
     void testRandomFunctors()
     {
         const unsigned int n = 50;
@@ -2766,10 +3271,106 @@ struct PolygonTest
         hull.clear();
         
         vigra::convexHull(points, hull);
-        
+
         shouldEqual(17u, hull.size());
         shouldEqualSequence(convexHullReference, convexHullReference+17, hull.begin());
     }
+
+    void testTransformPoints()
+    {
+        vigra::ArrayVector<Point> points, transformed;
+        points.push_back(Point(1.0, 0.0));
+        points.push_back(Point(0.0, 1.0));
+        points.push_back(Point(-2.5, 3.5));
+        points.push_back(Point(4.0, -1.25));
+
+        // rotation by 90 degrees plus translation (3, 4)
+        vigra::Matrix<double> m(3, 3);
+        m(0,0) = 0.0; m(0,1) = -1.0; m(0,2) = 3.0;
+        m(1,0) = 1.0; m(1,1) =  0.0; m(1,2) = 4.0;
+        m(2,0) = 0.0; m(2,1) =  0.0; m(2,2) = 1.0;
+
+        vigra::transformPoints(points, m, transformed);
+
+        shouldEqual(points.size(), transformed.size());
+        for(unsigned int k = 0; k < points.size(); ++k)
+        {
+            shouldEqual(transformed[k][0], -points[k][1] + 3.0);
+            shouldEqual(transformed[k][1],  points[k][0] + 4.0);
+        }
+
+        // in-place transformation gives the same result
+        vigra::ArrayVector<Point> inplace(points);
+        vigra::transformPoints(inplace, m, inplace);
+        shouldEqualSequence(transformed.begin(), transformed.end(), inplace.begin());
+
+        try
+        {
+            vigra::Matrix<double> wrong(2, 2);
+            vigra::transformPoints(points, wrong, transformed);
+            failTest("no exception thrown");
+        }
+        catch(vigra::PreconditionViolation &)
+        {}
+    }
+
+    void testIncrementalConvexHull()
+    {
+        vigra::ArrayVector<Point> points, hull, reference;
+        points.push_back(Point(0.0, 0.0));
+        points.push_back(Point(2.0, 1.0));
+        points.push_back(Point(2.0, -1.0));
+        points.push_back(Point(0.0, 2.0));
+        points.push_back(Point(-2.0, 1.0));
+        points.push_back(Point(-2.0, -1.0));
+        points.push_back(Point(0.0, -2.0));
+
+        vigra::convexHull(points, reference);
+
+        vigra::IncrementalConvexHull<Point> incremental(points);
+        shouldEqual(6u, incremental.size());
+        incremental.hullPolygon(hull);
+        shouldEqual(7u, hull.size());
+        shouldEqualSequence(reference.begin(), reference.end(), hull.begin());
+
+        // interior point, hull vertex, and point on an edge leave the hull unchanged
+        should(!incremental.addPoint(Point(0.0, 0.0)));
+        should(!incremental.addPoint(Point(2.0, 1.0)));
+        should(!incremental.addPoint(Point(1.0, -1.5)));
+        shouldEqual(6u, incremental.size());
+
+        // an exterior point replaces the vertices that become interior
+        should(incremental.addPoint(Point(5.0, 0.0)));
+        hull.clear();
+        incremental.hullPolygon(hull);
+        reference.clear();
+        points.push_back(Point(5.0, 0.0));
+        vigra::convexHull(points, reference);
+        shouldEqual(reference.size(), hull.size());
+        shouldEqualSequence(reference.begin(), reference.end(), hull.begin());
+
+        // incremental insertion must reproduce the batch hull exactly
+        std::srand(12345);
+        for(int trial = 0; trial < 20; ++trial)
+        {
+            points.clear();
+            int n = 3 + std::rand() % 100;
+            for(int k = 0; k < n; ++k)
+                points.push_back(Point(std::rand() % 50, std::rand() % 50));
+
+            reference.clear();
+            vigra::convexHull(points, reference);
+
+            incremental.compute(vigra::ArrayVector<Point>(points.begin(), points.begin() + 2));
+            for(int k = 2; k < n; ++k)
+                incremental.addPoint(points[k]);
+
+            hull.clear();
+            incremental.hullPolygon(hull);
+            shouldEqual(reference.size(), hull.size());
+            shouldEqualSequence(reference.begin(), reference.end(), hull.begin());
+        }
+    }
 };
 
 
@@ -2803,6 +3404,7 @@ struct MathTestSuite
 
         add( testCase(&HighOrderPolynomialTest::testPolynomial));
         add( testCase(&HighOrderPolynomialTest::testPolynomialEigenvalueMethod));
+        add( testCase(&LowOrderRealRootsTest::testRealRoots));
 
         add( testCase(&SplineTest<0>::testValues));
         add( testCase(&SplineTest<1>::testValues));
@@ -2826,11 +3428,18 @@ struct MathTestSuite
         add( testCase(&SplineTest<3>::testWeightMatrix));
         add( testCase(&SplineTest<4>::testWeightMatrix));
         add( testCase(&SplineTest<5>::testWeightMatrix));
+        add( testCase(&SplineTest<0>::testWeightTable));
+        add( testCase(&SplineTest<1>::testWeightTable));
+        add( testCase(&SplineTest<2>::testWeightTable));
+        add( testCase(&SplineTest<3>::testWeightTable));
+        add( testCase(&SplineTest<4>::testWeightTable));
+        add( testCase(&SplineTest<5>::testWeightTable));
 
         add( testCase(&FunctionsTest::testGaussians));
         add( testCase(&FunctionsTest::testSpecialIntegerFunctions));
         add( testCase(&FunctionsTest::testSpecialFunctions));
         add( testCase(&FunctionsTest::testBessel));
+        add( testCase(&FunctionsTest::testSpanFunctions));
         add( testCase(&FunctionsTest::closeAtToleranceTest));
         add( testCase(&FunctionsTest::testArgMinMax));
         add( testCase(&FunctionsTest::testAlgorithms));
@@ -2848,13 +3457,17 @@ struct MathTestSuite
         add( testCase(&QuaternionTest::testStreamIO));
         add( testCase(&QuaternionTest::testOperators));
         add( testCase(&QuaternionTest::testRotation));
+        add( testCase(&QuaternionTest::testRotatePoints));
+        add( testCase(&QuaternionTest::testSlerp));
 
         add( testCase(&LinalgTest::testOStreamShifting));
         add( testCase(&LinalgTest::testMatrix));
+        add( testCase(&LinalgTest::testBlockedMultiply));
         add( testCase(&LinalgTest::testArgMinMax));
         add( testCase(&LinalgTest::testColumnAndRowStatistics));
         add( testCase(&LinalgTest::testColumnAndRowPreparation));
         add( testCase(&LinalgTest::testCholesky));
+        add( testCase(&LinalgTest::testBlockedCholesky));
         add( testCase(&LinalgTest::testQR));
         add( testCase(&LinalgTest::testLinearSolve));
         add( testCase(&LinalgTest::testUnderdetermined));
@@ -2864,8 +3477,10 @@ struct MathTestSuite
         add( testCase(&LinalgTest::testSymmetricEigensystem));
         add( testCase(&LinalgTest::testNonsymmetricEigensystem));
         add( testCase(&LinalgTest::testSymmetricEigensystemAnalytic));
+        add( testCase(&LinalgTest::testSymmetricEigensystemFixedSize));
         add( testCase(&LinalgTest::testDeterminant));
         add( testCase(&LinalgTest::testSVD));
+        add( testCase(&LinalgTest::testSVDTallSkinny));
 
         add( testCase(&FixedPointTest::testConstruction));
         add( testCase(&FixedPointTest::testComparison));
@@ -2876,9 +3491,12 @@ struct MathTestSuite
 
         add( testCase(&RandomTest::testTT800));
         add( testCase(&RandomTest::testMT19937));
+        add( testCase(&RandomTest::testPhilox));
         add( testCase(&RandomTest::testRandomFunctors));
 
         add( testCase(&PolygonTest::testConvexHull));
+        add( testCase(&PolygonTest::testTransformPoints));
+        add( testCase(&PolygonTest::testIncrementalConvexHull));
     }
 };
 
@@ -220,6 +220,27 @@ struct FlatMorphologyTest
         }
     }
     
+    void medianParallelTest()
+    {
+        Image res(img), resp(img);
+        res = 0;
+        resp = 0;
+
+        discMedian(srcImageRange(img), destImage(res), 2);
+        discMedian(srcImageRange(img), destImage(resp), 2,
+                   ParallelOptions().numThreads(4));
+
+        Image::ScanOrderIterator i1 = res.begin();
+        Image::ScanOrderIterator i1end = res.end();
+        Image::ScanOrderIterator i2 = resp.begin();
+        Image::Accessor acc = res.accessor();
+
+        for(; i1 != i1end; ++i1, ++i2)
+        {
+            should(acc(i1) == acc(i2));
+        }
+    }
+
     void medianWithMaskTest()
     {
         Image res(img);
@@ -263,6 +284,7 @@ struct MorphologyTestSuite
         add( testCase( &FlatMorphologyTest::dilationTest));
         add( testCase( &FlatMorphologyTest::dilationWithMaskTest));
         add( testCase( &FlatMorphologyTest::medianTest));
+        add( testCase( &FlatMorphologyTest::medianParallelTest));
         add( testCase( &FlatMorphologyTest::medianWithMaskTest));
     }
 };
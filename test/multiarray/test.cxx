@@ -936,6 +936,45 @@ public:
         shouldEqual(count, 15);
     }
 
+    void test_coupled_iterator_contiguous ()
+    {
+        // whole unstrided arrays qualify for the fused 1-D fast path
+        typedef CoupledIteratorType<3, scalar_type, scalar_type>::type Iterator;
+        array3_t b3(a3);
+
+        Iterator i = createCoupledIterator(a3, b3),
+                 ref = i,
+                 iend = i.getEndIterator();
+        should(i.isUnstrided());
+
+        // incrementContiguous() visits exactly the same positions,
+        // coordinates and scan-order indices as operator++()
+        for(; ref < iend; ++ref, i.incrementContiguous())
+        {
+            shouldEqual(i.scanOrderIndex(), ref.scanOrderIndex());
+            shouldEqual(i.point(), ref.point());
+            shouldEqual(&i.get<1>(), &ref.get<1>());
+            shouldEqual(&i.get<2>(), &ref.get<2>());
+        }
+        should(i == iend);
+
+        // transposed views are excluded
+        MultiArrayView<3, scalar_type, StridedArrayTag> at = a3.transpose();
+        should(!createCoupledIterator(at).isUnstrided());
+
+        // a subarray truncated in the outermost dimension remains a
+        // contiguous memory range, one truncated further inside does not
+        should(createCoupledIterator(
+                   a3.subarray(shape3_t(0,0,0), shape3_t(2,3,4))).isUnstrided());
+        should(!createCoupledIterator(
+                   a3.subarray(shape3_t(0,0,0), shape3_t(2,2,5))).isUnstrided());
+
+        // a strided array anywhere in the chain vetoes the fast path
+        should(!createCoupledIterator(
+                   a3.subarray(shape3_t(0,0,0), shape3_t(2,2,5)),
+                   b3.subarray(shape3_t(0,0,0), shape3_t(2,2,5))).isUnstrided());
+    }
+
     void test_traverser ()
     {
         // test hierarchical navigation and 
@@ -1113,7 +1152,15 @@ public:
         shouldEqual(a3(0,0), 1);
         a3.reshape(a3.shape());
         shouldEqual(a3(0,0), 0);
-    
+
+        // reshape to the same number of elements reuses the buffer
+        scalar_type * p = a3.data();
+        a3.reshape (shape3_t(5,3,2), 2);
+        shouldEqual (a3.shape (0), 5);
+        shouldEqual (a3.shape (2), 2);
+        shouldEqual (a3.data(), p);
+        shouldEqual (a3(0,0), 2);
+
         a3.reshape (shape3_t(20,30,50));
 
         shouldEqual (a3.shape (0), 20);
@@ -1121,7 +1168,43 @@ public:
         shouldEqual (a3.shape (2), 50);
         shouldEqual(a3(0,0), 0);
     }
-    
+
+    void test_release_adopt ()
+    {
+        array3_t a (s, 3);
+        scalar_type * p = a.data();
+        scalar_type * q = a.release();
+        shouldEqual (q, p);
+        should (!a.hasData());
+        shouldEqual (a.shape(0), 0);
+
+        a.adopt (q, s);
+        shouldEqual (a.data(), p);
+        shouldEqual (a.shape(), s);
+        shouldEqual (a(1,2,3), 3);
+    }
+
+#ifdef VIGRA_HAS_RVALUE_REFERENCES
+    void test_move ()
+    {
+        array3_t a (s, 3);
+        scalar_type * p = a.data();
+
+        array3_t b (static_cast<array3_t &&>(a));
+        shouldEqual (b.data(), p);
+        shouldEqual (b.shape(), s);
+        shouldEqual (b(1,2,3), 3);
+        should (!a.hasData());
+        shouldEqual (a.shape(0), 0);
+
+        array3_t c;
+        c = static_cast<array3_t &&>(b);
+        shouldEqual (c.data(), p);
+        shouldEqual (c(1,2,3), 3);
+        should (!b.hasData());
+    }
+#endif
+
     void test_copy_int_float()
     {
         MultiArray<2, float> a(MultiArrayShape<2>::type(2,2));
@@ -1309,6 +1392,55 @@ public:
         }
     }
 
+    void testLineRange ()
+    {
+        unsigned char expected[][24] =
+            {{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23},
+            {0, 4, 8, 1, 5, 9, 2, 6, 10, 3, 7, 11, 12, 16, 20, 13, 17, 21, 14, 18, 22, 15, 19, 23},
+            {0, 12, 1, 13, 2, 14, 3, 15, 4, 16, 5, 17, 6, 18, 7, 19, 8, 20, 9, 21, 10, 22, 11, 23}};
+        typedef MultiArrayLineRange<array3_type::traverser, 3> LineRange;
+        typedef MultiArrayNavigator<array3_type::traverser, 3> Navigator;
+        for(int d=0; d<3; ++d)
+        {
+            LineRange lines(array3.traverser_begin(), array3.shape(), d);
+            shouldEqual(lines.size()*lines.lineLength(), (MultiArrayIndex)array3.size());
+            shouldEqual(lines.lineLength(), array3.shape(d));
+
+            int k = 0;
+            Navigator nav(array3.traverser_begin(), array3.shape(), d);
+            for(MultiArrayIndex l = 0; l < lines.size(); ++l, ++nav)
+            {
+                // line l must be the l-th line a navigator visits
+                shouldEqual(lines.lineStart(l), nav.point());
+
+                LineRange::iterator i = lines.lineBegin(l), end = lines.lineEnd(l);
+                for(; i != end; ++i, ++k)
+                    shouldEqual(*i, expected[d][k]);
+            }
+            should(nav.atEnd());
+        }
+
+        Shape3 start(1, 1, 0), stop(3, 3, 2);
+        unsigned char sexpected[][8] =
+            {{5,  6,  9, 10, 17, 18, 21, 22},
+            {5,  9,  6, 10, 17, 21, 18, 22},
+            {5, 17,  6, 18,  9, 21, 10, 22}};
+        for(int d=0; d<3; ++d)
+        {
+            LineRange lines(array3.traverser_begin(), start, stop, d);
+            shouldEqual(lines.size(), (MultiArrayIndex)(8 / (stop[d] - start[d])));
+            shouldEqual(lines.lineLength(), stop[d] - start[d]);
+
+            int k = 0;
+            for(MultiArrayIndex l = 0; l < lines.size(); ++l)
+            {
+                LineRange::iterator i = lines.lineBegin(l), end = lines.lineEnd(l);
+                for(; i != end; ++i, ++k)
+                    shouldEqual(*i, sexpected[d][k]);
+            }
+        }
+    }
+
     void testCoordinateNavigator ()
     {
         unsigned char expected[][24] = 
@@ -1382,6 +1514,21 @@ struct MultiImpexTest
         shouldEqual(result(0,1,2), 3);
         shouldEqual(result(0,1,3), 4);
 
+        Array presult(import_info.shape());
+        importVolume(import_info, presult, ParallelOptions().numThreads(3));
+
+        shouldEqualSequence(presult.begin(), presult.end(), result.begin());
+
+        exportVolume(array, VolumeExportInfo("ptest", ext1),
+                     ParallelOptions().numThreads(3));
+
+        Array pexported;
+        VolumeImportInfo pimport_info("ptest", ext1);
+        pexported.reshape(pimport_info.shape());
+        importVolume(pimport_info, pexported);
+
+        shouldEqualSequence(pexported.begin(), pexported.end(), array.begin());
+
 #if defined(HasPNG)
         const char * ext2 = ".png";
 #else
@@ -1679,7 +1826,7 @@ struct MultiArrayPointoperatorsTest
         should(res.shape() == Size3(5,4,3));
 
         initMultiArray(destMultiArrayRange(res), ini);
-        
+
         int x,y,z;
         for(z=0; z<img.shape(2); ++z)
             for(y=0; y<img.shape(1); ++y)
@@ -1687,6 +1834,61 @@ struct MultiArrayPointoperatorsTest
                     shouldEqual(res(x,y,z), ini);
     }
 
+    void testInitFastPaths()
+    {
+        int x,y,z;
+
+        // zero fill (uniform byte pattern => memset) and non-uniform pattern
+        Image3D res(img.shape());
+        res.init(0.0f);
+        for(z=0; z<img.shape(2); ++z)
+            for(y=0; y<img.shape(1); ++y)
+                for(x=0; x<img.shape(0); ++x)
+                    shouldEqual(res(x,y,z), 0.0f);
+
+        res.init(1.1f);
+        for(z=0; z<img.shape(2); ++z)
+            for(y=0; y<img.shape(1); ++y)
+                for(x=0; x<img.shape(0); ++x)
+                    shouldEqual(res(x,y,z), 1.1f);
+
+        // init of a strided view must not touch the surrounding elements
+        res.init(0.0f);
+        View3D sub = res.subarray(Size3(1,1,1), Size3(4,3,2));
+        sub.init(2.5f);
+        for(z=0; z<img.shape(2); ++z)
+            for(y=0; y<img.shape(1); ++y)
+                for(x=0; x<img.shape(0); ++x)
+                    shouldEqual(res(x,y,z),
+                                (x>=1 && x<4 && y>=1 && y<3 && z==1)
+                                    ? 2.5f : 0.0f);
+
+        // init of an empty view (extent 0 along some axis) must not
+        // touch any memory
+        res.init(0.0f);
+        res.subarray(Size3(1,1,1), Size3(3,1,2)).init(7.0f);
+        for(z=0; z<img.shape(2); ++z)
+            for(y=0; y<img.shape(1); ++y)
+                for(x=0; x<img.shape(0); ++x)
+                    shouldEqual(res(x,y,z), 0.0f);
+
+        // a transposed view takes the strided branch
+        res.init(0.0f);
+        res.permuteDimensions(Size3(2,1,0)).init(3.5f);
+        for(z=0; z<img.shape(2); ++z)
+            for(y=0; y<img.shape(1); ++y)
+                for(x=0; x<img.shape(0); ++x)
+                    shouldEqual(res(x,y,z), 3.5f);
+
+        // parallel variant gives the same result (and falls through to
+        // the serial scan for such a small array)
+        Image3D serialRes(img.shape()), parallelRes(img.shape());
+        initMultiArray(destMultiArrayRange(serialRes), 4.25f);
+        initMultiArray(destMultiArrayRange(parallelRes), 4.25f,
+                       ParallelOptions().numThreads(3));
+        shouldEqualSequence(serialRes.begin(), serialRes.end(), parallelRes.begin());
+    }
+
     void testCopy()
     {
         Image3D res(img.shape());
@@ -1736,12 +1938,79 @@ struct MultiArrayPointoperatorsTest
                     shouldEqual(res(x,y,z), img(0,0,z));
     }
 
+    void testStrideOrderedCopy()
+    {
+        int x,y,z;
+        Size3 perm(2,1,0);
+        MultiArrayView<3, PixelType, StridedArrayTag> st = img.permuteDimensions(perm);
+
+        // copy between differently ordered views via the view-based overload
+        MultiArray<3, PixelType> tres(st.shape());
+        copyMultiArray(st, tres);
+        for(z=0; z<img.shape(2); ++z)
+            for(y=0; y<img.shape(1); ++y)
+                for(x=0; x<img.shape(0); ++x)
+                    shouldEqual(tres(z,y,x), img(x,y,z));
+
+        // identical layout (the memcpy fast path)
+        Image3D res(img.shape());
+        initMultiArray(destMultiArrayRange(res), 0.0);
+        copyMultiArray(img, res);
+        shouldEqualSequence(res.data(), res.data()+res.size(), img.data());
+
+        // type conversion must round exactly like the iterator-based version
+        MultiArray<3, unsigned short> usres(img.shape()), usref(img.shape());
+        copyMultiArray(srcMultiArrayRange(img), destMultiArray(usref));
+        copyMultiArray(img, usres);
+        shouldEqualSequence(usres.data(), usres.data()+usres.size(), usref.data());
+
+        // assignment between differently ordered views (operator= path)
+        MultiArray<3, PixelType> t2(st.shape());
+        MultiArrayView<3, PixelType, StridedArrayTag> t2v = t2.permuteDimensions(perm);
+        t2v = img;
+        for(z=0; z<img.shape(2); ++z)
+            for(y=0; y<img.shape(1); ++y)
+                for(x=0; x<img.shape(0); ++x)
+                    shouldEqual(t2(z,y,x), img(x,y,z));
+
+        // expanding mode still works through the view-based overload
+        View3D view = img.subarray(Size3(0,0,0), Size3(5,1,1));
+        initMultiArray(destMultiArrayRange(res), 0.0);
+        copyMultiArray(view, res);
+        for(z=0; z<img.shape(2); ++z)
+            for(y=0; y<img.shape(1); ++y)
+                for(x=0; x<img.shape(0); ++x)
+                    shouldEqual(res(x,y,z), img(x,0,0));
+
+        // transform between differently ordered views
+        MultiArray<3, PixelType> ttrans(st.shape()), ttref(st.shape());
+        transformMultiArray(srcMultiArrayRange(st), destMultiArrayRange(ttref),
+                            Arg1() + Arg1());
+        transformMultiArray(st, ttrans, Arg1() + Arg1());
+        shouldEqualSequence(ttrans.data(), ttrans.data()+ttrans.size(), ttref.data());
+
+        // copies into an empty view (extent 0 along some axis) must not
+        // touch any memory
+        Image3D guard(img.shape());
+        initMultiArray(destMultiArrayRange(guard), 5.0);
+        View3D empty = guard.subarray(Size3(1,1,1), Size3(3,1,2));
+        should(empty.size() == 0);
+        MultiArray<3, PixelType> emptySrc(empty.shape());
+        empty = emptySrc;
+        copyMultiArray(emptySrc, empty);
+        transformMultiArray(emptySrc, empty, Arg1() + Arg1());
+        for(z=0; z<img.shape(2); ++z)
+            for(y=0; y<img.shape(1); ++y)
+                for(x=0; x<img.shape(0); ++x)
+                    shouldEqual(guard(x,y,z), 5.0);
+    }
+
     void testTransform()
     {
         Image3D res(img.shape());
-        
+
         initMultiArray(destMultiArrayRange(res), 0.0);
-        
+
         transformMultiArray(srcMultiArrayRange(img), destMultiArray(res),
                             Arg1() + Arg1());
         
@@ -2118,6 +2387,76 @@ struct MultiArrayPointoperatorsTest
             shouldEqualTolerance(vector[k][1], rtensor[k][1], 1e-14);
         }
     }
+
+    void testFusedTensorAnalysis()
+    {
+        MultiArrayShape<3>::type shape(4,3,2);
+        int size = 24;
+
+        MultiArray<3, TinyVector<double, 6> > tensor(shape);
+        MultiArray<3, TinyVector<double, 3> > ev(shape), rev(shape);
+        MultiArray<3, double> trace(shape), rtrace(shape);
+        MultiArray<3, double> determinant(shape), rdet(shape);
+
+        for(int k=0; k<size; ++k)
+            for(int l=0; l<6; ++l)
+                tensor[k][l] = randomMT19937().uniform();
+
+        tensorEigenvaluesMultiArray(srcMultiArrayRange(tensor), destMultiArray(rev));
+        tensorTraceMultiArray(srcMultiArrayRange(tensor), destMultiArray(rtrace));
+        tensorDeterminantMultiArray(srcMultiArrayRange(tensor), destMultiArray(rdet));
+
+        // all outputs in a single pass
+        tensorAnalysisMultiArray(tensor, ev, trace, determinant);
+        shouldEqualSequence(ev.data(), ev.data()+size, rev.data());
+        shouldEqualSequence(trace.data(), trace.data()+size, rtrace.data());
+        shouldEqualSequence(determinant.data(), determinant.data()+size, rdet.data());
+
+        // empty views skip the corresponding output
+        ev.init(TinyVector<double, 3>());
+        trace.init(0.0);
+        determinant.init(0.0);
+        tensorAnalysisMultiArray(tensor, ev, trace,
+                                 MultiArrayView<3, double>());
+        shouldEqualSequence(ev.data(), ev.data()+size, rev.data());
+        shouldEqualSequence(trace.data(), trace.data()+size, rtrace.data());
+        shouldEqualTolerance(norm(determinant), 0.0, 1e-14);
+
+        // parallel overload gives identical results
+        ev.init(TinyVector<double, 3>());
+        trace.init(0.0);
+        tensorAnalysisMultiArray(tensor, ev, trace, determinant,
+                                 ParallelOptions().numThreads(2));
+        shouldEqualSequence(ev.data(), ev.data()+size, rev.data());
+        shouldEqualSequence(trace.data(), trace.data()+size, rtrace.data());
+        shouldEqualSequence(determinant.data(), determinant.data()+size, rdet.data());
+
+        // strided outputs are supported as well
+        MultiArray<3, double> big(MultiArrayShape<3>::type(8,3,2));
+        MultiArrayView<3, double, StridedArrayTag> strided(big.subarray(
+                 MultiArrayShape<3>::type(0,0,0), MultiArrayShape<3>::type(8,3,2)).stridearray(
+                 MultiArrayShape<3>::type(2,1,1)));
+        tensorAnalysisMultiArray(tensor, MultiArrayView<3, TinyVector<double, 3> >(),
+                                 strided, MultiArrayView<3, double>());
+        for(int z=0; z<2; ++z)
+            for(int y=0; y<3; ++y)
+                for(int x=0; x<4; ++x)
+                    shouldEqual(strided(x,y,z), rtrace(x,y,z));
+
+        try
+        {
+            MultiArray<3, double> wrong(MultiArrayShape<3>::type(2,3,4));
+            tensorAnalysisMultiArray(tensor, ev, wrong,
+                                     MultiArrayView<3, double>());
+            failTest("no exception thrown");
+        }
+        catch(ContractViolation & c)
+        {
+            std::string expected("\nPrecondition violation!\ntensorAnalysisMultiArray(): Shape mismatch between input and trace array.");
+            std::string message(c.what());
+            should(0 == expected.compare(message.substr(0, expected.size())));
+        }
+    }
 };
 
 class MultiMathTest
@@ -2394,6 +2733,70 @@ public:
         }
     }
 
+    void testFlatEvaluation()
+    {
+        using namespace vigra::multi_math;
+
+        // unstrided LHS and RHS => flat scan-order loop,
+        // transposed evaluation => general strided algorithm;
+        // both must produce identical results
+        r1 = b*c + d*b;
+        r2.transpose() = b.transpose()*c.transpose() + d.transpose()*b.transpose();
+        shouldEqualSequence(r1.begin(), r1.end(), r2.begin());
+
+        // a subarray operand is strided and must take the general code path
+        array3_type big(Shape3(5, 4, 3));
+        linearSequence(big.begin(), big.end());
+        view_type inner = big.subarray(Shape3(0,0,0), shape3);
+        r1 = inner*b;
+        for(int k=0; k<r2.size(); ++k)
+            r2[k] = inner[r2.scanOrderIndexToCoordinate(k)]*b[k];
+        shouldEqualSequence(r1.begin(), r1.end(), r2.begin());
+
+        // singleton expansion disables the flat path as well
+        array3_type line(Shape3(4, 1, 1));
+        linearSequence(line.begin(), line.end());
+        r1 = b + line;
+        for(int k=0; k<r2.size(); ++k)
+            r2[k] = b[k] + line(r2.scanOrderIndexToCoordinate(k)[0], 0, 0);
+        shouldEqualSequence(r1.begin(), r1.end(), r2.begin());
+
+        // reductions: flat and strided evaluation must agree exactly
+        shouldEqual(sum<double>(b*c), sum<double>(b.transpose()*c.transpose()));
+        shouldEqual(product<double>(sqrt(b)), product<double>(sqrt(b.transpose())));
+        should(all(b*c > 0.0));
+        should(any(d + c > 0.0));
+        should(!any(inner - inner != 0.0));
+    }
+
+    void testReductions()
+    {
+        using namespace vigra::multi_math;
+
+        // minimum/maximum of expressions and arrays,
+        // flat and strided evaluation
+        shouldEqual(minimum<double>(b), 0.5);
+        shouldEqual(maximum<double>(b), 23.5);
+        shouldEqual(minimum<double>(abs(d)), 1.0);
+        shouldEqual(maximum<double>(-sq(d)), -1.0);
+        shouldEqual(minimum<double>(b.transpose()*2.0), 1.0);
+        shouldEqual(maximum<double>(b.transpose()*2.0), 47.0);
+
+        // the parallel reductions agree with the serial ones (exactly in
+        // this test: minimum/maximum always do, and the sums and products
+        // below only involve exactly representable intermediate results)
+        ParallelOptions parallel = ParallelOptions().numThreads(3);
+        shouldEqual(sum<double>(b, parallel), sum<double>(b));
+        shouldEqual(sum<double>(abs(b - c), parallel), 2388.0);
+        shouldEqual(product<double>(c / c, parallel), 1.0);
+        shouldEqual(minimum<double>(b*c, parallel), minimum<double>(b*c));
+        shouldEqual(maximum<double>(b*c + d, parallel), maximum<double>(b*c + d));
+
+        // strided expressions fall back to the serial algorithm
+        shouldEqual(sum<double>(b.transpose(), parallel), sum<double>(b));
+        shouldEqual(maximum<double>(bv.transpose(), parallel), 23.5);
+    }
+
 #define VIGRA_TEST_UNARY_FUNCTION(FCT, RHS) \
         r1 = FCT(RHS); \
         for(int k=0; k<r2.size(); ++k) \
@@ -2501,6 +2904,66 @@ public:
         shouldEqualSequence(r1.begin(), r1.end(), r2.begin());
     }
 
+    void testCoordinateExpressions()
+    {
+        using namespace vigra::multi_math;
+
+        // the full coordinate grid evaluates to the element's own index
+        MultiArray<3, TinyVector<double, 3> > vgrid(shape3);
+        vgrid = meshGrid<3>();
+        for(int z=0; z<2; ++z)
+            for(int y=0; y<3; ++y)
+                for(int x=0; x<4; ++x)
+                    shouldEqual(vgrid(x,y,z), (TinyVector<double, 3>(x, y, z)));
+
+        // distance-from-center mask without materialized coordinate arrays
+        // (the coordinate grid has no shape of its own, so the LHS must
+        // already have the desired shape)
+        TinyVector<double, 3> center(1.5, 1.0, 0.5);
+        r2 = norm(meshGrid<3>() - center);
+        for(int z=0; z<2; ++z)
+            for(int y=0; y<3; ++y)
+                for(int x=0; x<4; ++x)
+                    shouldEqualTolerance(r2(x,y,z),
+                                         vigra::norm(TinyVector<double, 3>(x, y, z) - center), 1e-15);
+
+        // single-axis coordinates combine with array operands
+        r1 = b + coordinate<3>(0);
+        rv = bv * coordinate<3>(1);
+        for(int z=0; z<2; ++z)
+            for(int y=0; y<3; ++y)
+                for(int x=0; x<4; ++x)
+                {
+                    shouldEqual(r1(x,y,z), b(x,y,z) + x);
+                    shouldEqual(rv(x,y,z), b(x,y,z) * y);
+                }
+
+        // coordinates refer to the iteration space, which follows the LHS
+        r4.transpose() = b.transpose() + coordinate<3>(2);
+        for(int z=0; z<2; ++z)
+            for(int y=0; y<3; ++y)
+                for(int x=0; x<4; ++x)
+                    shouldEqual(r4(x,y,z), b(x,y,z) + x);
+
+        // reductions over coordinate expressions
+        shouldEqual(sum<double>(0.0*b + coordinate<3>(0)), 36.0);
+        shouldEqual(sum<double>(0.0*b + coordinate<3>(1)), 24.0);
+        should(any(0.0*b + coordinate<3>(2) == 1.0));
+        should(!all(0.0*b + coordinate<3>(2) == 1.0));
+
+        try
+        {
+            coordinate<3>(3);
+            failTest("no exception thrown");
+        }
+        catch(vigra::ContractViolation & c)
+        {
+            std::string expected("\nPrecondition violation!\ncoordinate(): axis out of range.");
+            std::string message(c.what());
+            should(0 == expected.compare(message.substr(0, expected.size())));
+        }
+    }
+
     void testComputedAssignment()
     {
         using namespace vigra::multi_math;
@@ -2688,6 +3151,7 @@ struct MultiArrayTestSuite
         add( testCase( &MultiArrayTest::test_iterator ) );
         add( testCase( &MultiArrayTest::test_const_iterator ) );
         add( testCase( &MultiArrayTest::test_coupled_iterator ) );
+        add( testCase( &MultiArrayTest::test_coupled_iterator_contiguous ) );
         add( testCase( &MultiArrayTest::test_traverser ) );
         add( testCase( &MultiArrayTest::test_const_traverser ) );
         add( testCase( &MultiArrayTest::test_bindOuter ) );
@@ -2696,6 +3160,10 @@ struct MultiArrayTestSuite
         add( testCase( &MultiArrayTest::test_bindAt ) );
         add( testCase( &MultiArrayTest::test_bind ) );
         add( testCase( &MultiArrayTest::test_reshape) );
+        add( testCase( &MultiArrayTest::test_release_adopt) );
+#ifdef VIGRA_HAS_RVALUE_REFERENCES
+        add( testCase( &MultiArrayTest::test_move) );
+#endif
         add( testCase( &MultiArrayTest::test_subarray ) );
         add( testCase( &MultiArrayTest::test_stridearray ) );
         add( testCase( &MultiArrayTest::test_copy_int_float ) );
@@ -2727,6 +3195,7 @@ struct MultiArrayDataTestSuite
         add( testCase( &MultiArrayDataTest::testScanOrderAccess ) );
         add( testCase( &MultiArrayDataTest::testAssignmentAndReset ) );
         add( testCase( &MultiArrayNavigatorTest::testNavigator ) );
+        add( testCase( &MultiArrayNavigatorTest::testLineRange ) );
         add( testCase( &MultiArrayNavigatorTest::testCoordinateNavigator ) );
     }
 };
@@ -2738,9 +3207,11 @@ struct MultiArrayPointOperatorsTestSuite
     : vigra::test_suite("MultiArrayPointOperatorsTestSuite")
     {
         add( testCase( &MultiArrayPointoperatorsTest::testInit ) );
+        add( testCase( &MultiArrayPointoperatorsTest::testInitFastPaths ) );
         add( testCase( &MultiArrayPointoperatorsTest::testCopy ) );
         add( testCase( &MultiArrayPointoperatorsTest::testCopyOuterExpansion ) );
         add( testCase( &MultiArrayPointoperatorsTest::testCopyInnerExpansion ) );
+        add( testCase( &MultiArrayPointoperatorsTest::testStrideOrderedCopy ) );
         add( testCase( &MultiArrayPointoperatorsTest::testTransform ) );
         add( testCase( &MultiArrayPointoperatorsTest::testTransformOuterExpand ) );
         add( testCase( &MultiArrayPointoperatorsTest::testTransformInnerExpand ) );
@@ -2754,14 +3225,18 @@ struct MultiArrayPointOperatorsTestSuite
         add( testCase( &MultiArrayPointoperatorsTest::testCombine3 ) );
         add( testCase( &MultiArrayPointoperatorsTest::testInitMultiArrayBorder ) );
         add( testCase( &MultiArrayPointoperatorsTest::testTensorUtilities ) );
+        add( testCase( &MultiArrayPointoperatorsTest::testFusedTensorAnalysis ) );
 
         add( testCase( &MultiMathTest::testSpeed ) );
         add( testCase( &MultiMathTest::testBasicArithmetic ) );
+        add( testCase( &MultiMathTest::testFlatEvaluation ) );
+        add( testCase( &MultiMathTest::testReductions ) );
         add( testCase( &MultiMathTest::testExpandMode ) );
         add( testCase( &MultiMathTest::testAllFunctions ) );
         add( testCase( &MultiMathTest::testComputedAssignment ) );
         add( testCase( &MultiMathTest::testNonscalarValues ) );
         add( testCase( &MultiMathTest::testMixedExpressions ) );
+        add( testCase( &MultiMathTest::testCoordinateExpressions ) );
         add( testCase( &MultiMathTest::testComplex ) );
     }
 }; // struct MultiArrayPointOperatorsTestSuite
@@ -60,6 +60,7 @@
 #include "vigra/multi_resize.hxx"
 #include "vigra/separableconvolution.hxx"
 #include "vigra/bordertreatment.hxx"
+#include "vigra/chunked_lazy_array.hxx"
 
 using namespace vigra;
 using namespace vigra::functor;
@@ -282,6 +283,33 @@ struct MultiArraySeparableConvolutionTest
     }
 
 
+    // - - - - - - - - - - - - - - - - - - - - - - - -
+
+    void test_parallelN( const Image3D &src, float ksize )
+    {
+        Image3D da( src.shape() );
+        Image3D db( src.shape() );
+
+        std::vector<vigra::Kernel1D<float> > kernels( 3 );
+        kernels[0].initGaussian( ksize );
+        kernels[1].initGaussianDerivative( ksize, 1 );
+
+        vigra::separableConvolveMultiArray( srcMultiArrayRange(src),
+                                            destMultiArray(da),
+                                            kernels.begin() );
+
+        vigra::separableConvolveMultiArray( srcMultiArrayRange(src),
+                                            destMultiArray(db),
+                                            kernels.begin(),
+                                            vigra::ParallelOptions()
+                                                .numThreads(3)
+                                                .blockSize(4) );
+
+        shouldEqualSequenceTolerance( da.begin(), da.end(),
+                                        db.begin(),
+                                        1e-5 );
+    }
+
     // - - - - - - - - - - - - - - - - - - - - - - - -
 
     void testSmoothing()
@@ -318,6 +346,57 @@ struct MultiArraySeparableConvolutionTest
         }
     }
 
+    void test_kernelCache()
+    {
+        GaussianKernelCache & cache = GaussianKernelCache::global();
+        cache.clear();
+        shouldEqual(cache.size(), 0u);
+
+        // cached kernels are identical to directly initialized ones
+        Kernel1D<double> direct, cached = cache.gaussian(2.0);
+        direct.initGaussian(2.0);
+        shouldEqual(cached.left(), direct.left());
+        shouldEqual(cached.right(), direct.right());
+        for(int i = direct.left(); i <= direct.right(); ++i)
+            shouldEqual(cached[i], direct[i]);
+
+        cached = cache.gaussianDerivative(2.0, 1);
+        direct.initGaussianDerivative(2.0, 1);
+        shouldEqual(cached.left(), direct.left());
+        shouldEqual(cached.right(), direct.right());
+        for(int i = direct.left(); i <= direct.right(); ++i)
+            shouldEqual(cached[i], direct[i]);
+        shouldEqual(cache.size(), 2u);
+
+        // repeated requests are served from the cache
+        cache.gaussian(2.0);
+        cache.gaussianDerivative(2.0, 1);
+        shouldEqual(cache.size(), 2u);
+
+        // a different window ratio is a distinct entry
+        cache.gaussian(2.0, 4.0);
+        shouldEqual(cache.size(), 3u);
+
+        // the Gaussian filter functions fill the cache automatically
+        // and produce the same result as hand-built kernels
+        cache.clear();
+        makeRandom(srcImage);
+
+        Image3D res(shape);
+        gaussianSmoothMultiArray(srcMultiArrayRange(srcImage), destMultiArray(res), 2.0);
+        shouldEqual(cache.size(), 1u);
+
+        ArrayVector<Kernel1D<double> > kernels(3);
+        for(int d = 0; d < 3; ++d)
+            kernels[d].initGaussian(2.0, 1.0);
+
+        Image3D ref(shape);
+        separableConvolveMultiArray(srcMultiArrayRange(srcImage), destMultiArray(ref),
+                                    kernels.begin());
+
+        shouldEqualSequence(res.begin(), res.end(), ref.begin());
+    }
+
     void test_inplaceness1( const Image3D &src, float ksize, bool useDerivative )
     {
         Image3D da( src.shape() );
@@ -388,6 +467,205 @@ struct MultiArraySeparableConvolutionTest
     }
 
 
+    void test_fusedGradient()
+    {
+        MultiArrayShape<3>::type shape(30,25,20);
+        int size = shape[0]*shape[1]*shape[2];
+
+        MultiArray<3, double> src(shape);
+        MultiArray<3, TinyVector<double, 3> > grad(shape), fused(shape);
+
+        makeRandom(src);
+
+        gaussianGradientMultiArray(srcMultiArrayRange(src), destMultiArray(grad), 1.5);
+        gaussianGradientMultiArrayFused(srcMultiArrayRange(src), destMultiArray(fused), 1.5);
+
+        // use an absolute tolerance -- at reflective borders the derivative
+        // is a cancellation sum whose exact value is zero
+        for(int k = 0; k < size; ++k)
+            for(int c = 0; c < 3; ++c)
+                should(std::fabs(fused.data()[k][c] - grad.data()[k][c]) < 1e-12);
+
+        // anisotropic step size must be handled identically
+        ConvolutionOptions<3> opt;
+        opt.stepSize(1.0, 1.3, 2.0);
+        gaussianGradientMultiArray(srcMultiArrayRange(src), destMultiArray(grad), 2.0, opt);
+        gaussianGradientMultiArrayFused(srcMultiArrayRange(src), destMultiArray(fused), 2.0, opt);
+
+        for(int k = 0; k < size; ++k)
+            for(int c = 0; c < 3; ++c)
+                should(std::fabs(fused.data()[k][c] - grad.data()[k][c]) < 1e-12);
+    }
+
+    struct TileSource
+    {
+        MultiArray<3, double> * array;
+
+        TileSource(MultiArray<3, double> & a)
+            : array(&a)
+        {}
+
+        void operator()(MultiArrayShape<3>::type const & start,
+                        MultiArrayShape<3>::type const & stop,
+                        MultiArrayView<3, double> & tile)
+        {
+            tile = array->subarray(start, stop);
+        }
+    };
+
+    struct TileSink
+    {
+        MultiArray<3, double> * array;
+
+        TileSink(MultiArray<3, double> & a)
+            : array(&a)
+        {}
+
+        void operator()(MultiArrayShape<3>::type const & start,
+                        MultiArrayShape<3>::type const & stop,
+                        MultiArrayView<3, double> const & tile)
+        {
+            array->subarray(start, stop) = tile;
+        }
+    };
+
+    void test_tiledConvolution()
+    {
+        typedef MultiArrayShape<3>::type Shape;
+
+        Shape shape(40, 31, 23);
+        MultiArray<3, double> src(shape), ref(shape), dest(shape);
+        int size = shape[0]*shape[1]*shape[2];
+
+        makeRandom(src);
+
+        ArrayVector<Kernel1D<double> > kernels(3);
+        kernels[0].initGaussian(1.7);
+        kernels[1].initGaussianDerivative(1.2, 1);
+        kernels[2].initAveraging(2);
+
+        separableConvolveMultiArray(srcMultiArrayRange(src), destMultiArray(ref),
+                                    kernels.begin());
+
+        TileSource reader(src);
+        TileSink writer(dest);
+
+        // uneven tile shapes, including one covering a whole axis
+        separableConvolveTiled<3, double>(shape, Shape(13, 9, 23),
+                                          reader, writer, kernels.begin());
+        shouldEqualSequence(dest.data(), dest.data()+size, ref.data());
+
+        dest.init(0.0);
+        separableConvolveTiled<3, double>(shape, Shape(64, 5, 7),
+                                          reader, writer, kernels.begin(),
+                                          ParallelOptions().numThreads(3));
+        shouldEqualSequence(dest.data(), dest.data()+size, ref.data());
+    }
+
+    struct PlusOne
+    {
+        double operator()(double v) const
+        {
+            return v + 1.0;
+        }
+    };
+
+    struct Difference
+    {
+        double operator()(double a, double b) const
+        {
+            return a - b;
+        }
+    };
+
+    void test_chunkedLazyArray()
+    {
+        typedef MultiArrayShape<3>::type Shape;
+
+        Shape shape(40, 31, 23);
+        MultiArray<3, double> src(shape), ref(shape), dest(shape);
+        int size = shape[0]*shape[1]*shape[2];
+
+        makeRandom(src);
+
+        ArrayVector<Kernel1D<double> > kernels(3);
+        kernels[0].initGaussian(1.7);
+        kernels[1].initGaussianDerivative(1.2, 1);
+        kernels[2].initAveraging(2);
+
+        separableConvolveMultiArray(srcMultiArrayRange(src), destMultiArray(ref),
+                                    kernels.begin());
+
+        ChunkedLazyArray<3, double> source = makeChunkedLazyArray(src, Shape(13, 9, 23));
+        ChunkedLazyArray<3, double> smoothed = source.convolved(kernels);
+
+        // whole-array read must match the monolithic convolution bit for bit
+        smoothed.readBlock(Shape(0,0,0), shape, MultiArrayView<3, double>(dest));
+        shouldEqualSequence(dest.data(), dest.data()+size, ref.data());
+
+        // chunk-straddling partial reads
+        MultiArray<3, double> block = smoothed.checkoutBlock(Shape(7, 5, 11), Shape(29, 23, 20));
+        shouldEqualSequence(block.data(), block.data()+block.size(),
+                            ref.subarray(Shape(7, 5, 11), Shape(29, 23, 20)).begin());
+
+        // a filter graph: (smoothed + 1) - smoothed == 1 everywhere
+        ChunkedLazyArray<3, double> diff =
+            smoothed.transformed(PlusOne()).combined(smoothed, Difference());
+        MultiArray<3, double> ones = diff.checkoutBlock(Shape(0,0,0), shape);
+        for(int k = 0; k < size; ++k)
+            shouldEqualTolerance(ones.data()[k], 1.0, 1e-14);
+
+        // the LRU cache respects its byte limit and can be disabled
+        should(smoothed.cachedBytes() > 0);
+        std::size_t limit = 2*13*9*23*sizeof(double);
+        smoothed.setCacheLimit(limit);
+        should(smoothed.cachedBytes() <= limit);
+        smoothed.setCacheLimit(0);
+        shouldEqual(smoothed.cachedBytes(), std::size_t(0));
+
+        // results remain correct without caching
+        dest.init(0.0);
+        smoothed.readBlock(Shape(0,0,0), shape, MultiArrayView<3, double>(dest));
+        shouldEqualSequence(dest.data(), dest.data()+size, ref.data());
+    }
+
+    void test_scaleSpacePass()
+    {
+        MultiArrayShape<3>::type shape(30,25,20);
+        int size = shape[0]*shape[1]*shape[2];
+
+        MultiArray<3, double> src(shape);
+        MultiArray<3, double> smoothed(shape), rsmoothed(shape);
+        MultiArray<3, TinyVector<double, 3> > grad(shape), rgrad(shape);
+        MultiArray<3, double> laplacian(shape), rlaplacian(shape);
+        MultiArray<3, TinyVector<double, 6> > hessian(shape), rhessian(shape);
+
+        makeRandom(src);
+
+        double sigma = 1.5;
+        gaussianSmoothMultiArray(srcMultiArrayRange(src), destMultiArray(rsmoothed), sigma);
+        gaussianGradientMultiArray(srcMultiArrayRange(src), destMultiArray(rgrad), sigma);
+        laplacianOfGaussianMultiArray(srcMultiArrayRange(src), destMultiArray(rlaplacian), sigma);
+        hessianOfGaussianMultiArray(srcMultiArrayRange(src), destMultiArray(rhessian), sigma);
+
+        gaussianScaleSpacePassMultiArray(srcMultiArrayRange(src),
+                                         destMultiArray(smoothed), destMultiArray(grad),
+                                         destMultiArray(laplacian), destMultiArray(hessian),
+                                         sigma);
+
+        // absolute tolerances -- derivative values at reflective borders
+        // are cancellation sums whose exact value is zero
+        for(int k = 0; k < size; ++k)
+        {
+            should(std::fabs(smoothed.data()[k] - rsmoothed.data()[k]) < 1e-12);
+            should(std::fabs(laplacian.data()[k] - rlaplacian.data()[k]) < 1e-12);
+            for(int c = 0; c < 3; ++c)
+                should(std::fabs(grad.data()[k][c] - rgrad.data()[k][c]) < 1e-12);
+            for(int c = 0; c < 6; ++c)
+                should(std::fabs(hessian.data()[k][c] - rhessian.data()[k][c]) < 1e-12);
+        }
+    }
+
     void test_gradient_magnitude()
     {
         using namespace functor;
@@ -505,17 +783,103 @@ struct MultiArraySeparableConvolutionTest
         test_inplacenessN( srcImage, kernelSize );
     }
 
-    void test_Inplace1() 
+    void test_Inplace1()
     {
         test_inplaceness1( srcImage, kernelSize, false );
         test_inplaceness1( srcImage, kernelSize, true );
     }
 
-    void test_gradient1() 
+    void test_ParallelN()
+    {
+        test_parallelN( srcImage, kernelSize );
+    }
+
+    void test_gradient1()
     {
         test_gradient1( srcImage, false );
         test_gradient1( srcImage, true );
     }
+
+    void test_streamingResize()
+    {
+        typedef MultiArray<3, double> Volume;
+        Volume src(Size3(15, 13, 140));
+        for(int z = 0; z < 140; ++z)
+            for(int y = 0; y < 13; ++y)
+                for(int x = 0; x < 15; ++x)
+                    src(x, y, z) = std::sin(0.05*z)*std::cos(0.4*x + 0.3*y)*100.0
+                                   + (x + 3*y + 11*z) % 29;
+
+        Volume ref(Size3(29, 25, 279)), res(ref.shape());
+        BSpline<3, double> spline;
+
+        resizeMultiArraySplineInterpolation(srcMultiArrayRange(src),
+                                            destMultiArrayRange(ref), spline);
+
+        // the slab-wise streaming algorithm must reproduce the default
+        // algorithm to machine precision
+        resizeMultiArraySplineInterpolation(srcMultiArrayRange(src),
+                                            destMultiArrayRange(res), spline, 10);
+        shouldEqualSequenceTolerance(res.data(), res.data() + res.size(),
+                                     ref.data(), 1e-12);
+    }
+
+    void test_memoryArena()
+    {
+        MultiArrayShape<2>::type shape(30,40);
+
+        MultiArray<2, double> src(shape), ref(shape), res(shape);
+        makeRandom(src);
+
+        MemoryArena arena;
+
+        // the results must not depend on where the temporaries live
+        gaussianSmoothMultiArray(srcMultiArrayRange(src), destMultiArray(ref), 2.0);
+        gaussianSmoothMultiArray(srcMultiArrayRange(src), destMultiArray(res), 2.0,
+                                 ConvolutionOptions<2>().memoryArena(arena));
+        shouldEqualSequence(res.data(), res.data()+res.size(), ref.data());
+
+        shouldEqual(arena.outstandingAllocations(), (std::size_t)0);
+        std::size_t capacity = arena.capacity();
+        should(capacity > 0);
+
+        // steady state: repeated identical calls reuse the arena's chunks
+        // instead of allocating new memory
+        for(int k = 0; k < 5; ++k)
+        {
+            gaussianSmoothMultiArray(srcMultiArrayRange(src), destMultiArray(res), 2.0,
+                                     ConvolutionOptions<2>().memoryArena(arena));
+            shouldEqual(arena.capacity(), capacity);
+        }
+        shouldEqualSequence(res.data(), res.data()+res.size(), ref.data());
+
+        // laplacian allocates an array-sized temporary from the arena
+        MultiArray<2, double> lref(shape), lres(shape);
+        laplacianOfGaussianMultiArray(srcMultiArrayRange(src), destMultiArray(lref), 2.0);
+        laplacianOfGaussianMultiArray(srcMultiArrayRange(src), destMultiArray(lres), 2.0,
+                                      ConvolutionOptions<2>().memoryArena(arena));
+        shouldEqualSequence(lres.data(), lres.data()+lres.size(), lref.data());
+        shouldEqual(arena.outstandingAllocations(), (std::size_t)0);
+
+        // ROI processing
+        MultiArrayShape<2>::type from(5,6), to(25,30);
+        MultiArray<2, double> roiRef(to-from), roiRes(to-from);
+        gaussianSmoothMultiArray(srcMultiArrayRange(src), destMultiArray(roiRef), 2.0,
+                                 ConvolutionOptions<2>().subarray(from, to));
+        gaussianSmoothMultiArray(srcMultiArrayRange(src), destMultiArray(roiRes), 2.0,
+                                 ConvolutionOptions<2>().subarray(from, to).memoryArena(arena));
+        shouldEqualSequence(roiRes.data(), roiRes.data()+roiRes.size(), roiRef.data());
+
+        // spline interpolation with arena temporaries
+        MultiArray<2, double> rref(MultiArrayShape<2>::type(45, 61)), rres(rref.shape());
+        resizeMultiArraySplineInterpolation(srcMultiArrayRange(src),
+                                            destMultiArrayRange(rref), BSpline<3, double>());
+        resizeMultiArraySplineInterpolation(srcMultiArrayRange(src),
+                                            destMultiArrayRange(rres), BSpline<3, double>(),
+                                            &arena);
+        shouldEqualSequence(rres.data(), rres.data()+rres.size(), rref.data());
+        shouldEqual(arena.outstandingAllocations(), (std::size_t)0);
+    }
 };                //-- struct MultiArraySeparableConvolutionTest
 
 //--------------------------------------------------------
@@ -531,12 +895,20 @@ struct MultiArraySeparableConvolutionTestSuite
                 add( testCase( &MultiArraySeparableConvolutionTest::test_Valid3 ) );
                 add( testCase( &MultiArraySeparableConvolutionTest::test_InplaceN ) );
                 add( testCase( &MultiArraySeparableConvolutionTest::test_Inplace1 ) );
+                add( testCase( &MultiArraySeparableConvolutionTest::test_ParallelN ) );
                 add( testCase( &MultiArraySeparableConvolutionTest::testSmoothing ) );
+                add( testCase( &MultiArraySeparableConvolutionTest::test_kernelCache ) );
                 add( testCase( &MultiArraySeparableConvolutionTest::test_gradient1 ) );
+                add( testCase( &MultiArraySeparableConvolutionTest::test_fusedGradient ) );
+                add( testCase( &MultiArraySeparableConvolutionTest::test_tiledConvolution ) );
+                add( testCase( &MultiArraySeparableConvolutionTest::test_chunkedLazyArray ) );
+                add( testCase( &MultiArraySeparableConvolutionTest::test_scaleSpacePass ) );
                 add( testCase( &MultiArraySeparableConvolutionTest::test_laplacian ) );
                 add( testCase( &MultiArraySeparableConvolutionTest::test_hessian ) );
                 add( testCase( &MultiArraySeparableConvolutionTest::test_structureTensor ) );
                 add( testCase( &MultiArraySeparableConvolutionTest::test_gradient_magnitude ) );
+                add( testCase( &MultiArraySeparableConvolutionTest::test_streamingResize ) );
+                add( testCase( &MultiArraySeparableConvolutionTest::test_memoryArena ) );
     }
 }; // struct MultiArraySeparableConvolutionTestSuite
 
@@ -1050,10 +1050,31 @@ struct MultiDistanceTest
         MultiArray<3, double> res(vol.shape());
 
         separableMultiDistSquared(srcMultiArrayRange(vol), destMultiArray(res), false);
-                
+
         shouldEqualSequence(res.data(), res.data()+res.elementCount(), ref_dist2);
     }
 
+    void testDistanceVolumesParallel()
+    {
+        // the parallel version must produce exactly the sequential result
+        typedef MultiArrayShape<3>::type Shape;
+        MultiArrayView<3, double> vol(Shape(12,10,35), volume_data);
+
+        MultiArray<3, double> res(vol.shape()), resp(vol.shape());
+
+        separableMultiDistSquared(srcMultiArrayRange(vol), destMultiArray(res), false);
+        separableMultiDistSquared(srcMultiArrayRange(vol), destMultiArray(resp), false,
+                                  vigra::ParallelOptions().numThreads(4));
+        shouldEqualSequence(resp.begin(), resp.end(), res.begin());
+
+        vigra::ArrayVector<double> pixelPitch(3, 1.0);
+        pixelPitch[1] = 1.5;
+        separableMultiDistance(srcMultiArrayRange(vol), destMultiArray(res), true, pixelPitch);
+        separableMultiDistance(srcMultiArrayRange(vol), destMultiArray(resp), true, pixelPitch,
+                               vigra::ParallelOptions().numThreads(3));
+        shouldEqualSequence(resp.begin(), resp.end(), res.begin());
+    }
+
     void testDistanceAxesPermutation()
     {
         typedef MultiArrayShape<3>::type Shape;
@@ -1162,6 +1183,7 @@ struct SimpleAnalysisTestSuite
     : vigra::test_suite("SimpleAnalysisTestSuite")
     {
         add( testCase( &MultiDistanceTest::testDistanceVolumes));
+        add( testCase( &MultiDistanceTest::testDistanceVolumesParallel));
         add( testCase( &MultiDistanceTest::testDistanceAxesPermutation));
         add( testCase( &MultiDistanceTest::testDistanceVolumesAnisoptopic));
         add( testCase( &MultiDistanceTest::distanceTransform2DCompare));
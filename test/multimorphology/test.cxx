@@ -273,6 +273,77 @@ struct MultiMorphologyTest
         shouldEqualSequence(di_res.begin(),di_res.end(), er_res.begin());
     }
 
+    void flatErosionDilationTest2D()
+    {
+        // compare the van Herk / Gil-Werman running extremum against a
+        // brute-force box extremum for several radii, including radii
+        // where the box is clipped everywhere
+        for(int radius = 0; radius < 5; ++radius)
+        {
+            IntImage er_res(img2), di_res(img2);
+            multiFlatErosion(srcMultiArrayRange(img2), destMultiArray(er_res), radius);
+            multiFlatDilation(srcMultiArrayRange(img2), destMultiArray(di_res), radius);
+
+            for(int y = 0; y < 7; ++y)
+            {
+                for(int x = 0; x < 7; ++x)
+                {
+                    int minimum = img2(x,y), maximum = img2(x,y);
+                    for(int dy = -radius; dy <= radius; ++dy)
+                    {
+                        for(int dx = -radius; dx <= radius; ++dx)
+                        {
+                            if(x+dx < 0 || x+dx > 6 || y+dy < 0 || y+dy > 6)
+                                continue;
+                            if(img2(x+dx, y+dy) < minimum)
+                                minimum = img2(x+dx, y+dy);
+                            if(img2(x+dx, y+dy) > maximum)
+                                maximum = img2(x+dx, y+dy);
+                        }
+                    }
+                    shouldEqual(er_res(x,y), minimum);
+                    shouldEqual(di_res(x,y), maximum);
+                }
+            }
+        }
+    }
+
+    void flatErosionDilationTest3D()
+    {
+        IntVolume er_res(vol), di_res(vol);
+        multiFlatErosion(srcMultiArrayRange(vol), destMultiArray(er_res), 1);
+        multiFlatDilation(srcMultiArrayRange(vol), destMultiArray(di_res), 1);
+
+        for(int z = 0; z < 5; ++z)
+        {
+            for(int y = 0; y < 5; ++y)
+            {
+                for(int x = 0; x < 5; ++x)
+                {
+                    int minimum = vol(x,y,z), maximum = vol(x,y,z);
+                    for(int dz = -1; dz <= 1; ++dz)
+                    {
+                        for(int dy = -1; dy <= 1; ++dy)
+                        {
+                            for(int dx = -1; dx <= 1; ++dx)
+                            {
+                                if(x+dx < 0 || x+dx > 4 || y+dy < 0 || y+dy > 4 ||
+                                   z+dz < 0 || z+dz > 4)
+                                    continue;
+                                if(vol(x+dx, y+dy, z+dz) < minimum)
+                                    minimum = vol(x+dx, y+dy, z+dz);
+                                if(vol(x+dx, y+dy, z+dz) > maximum)
+                                    maximum = vol(x+dx, y+dy, z+dz);
+                            }
+                        }
+                    }
+                    shouldEqual(er_res(x,y,z), minimum);
+                    shouldEqual(di_res(x,y,z), maximum);
+                }
+            }
+        }
+    }
+
     void grayClosingTest2D()
     {
         typedef vigra::MultiArray<2,UInt8> UInt8Image;
@@ -301,6 +372,8 @@ struct MorphologyTestSuite
         add( testCase( &MultiMorphologyTest::grayErosionTest2D));
         add( testCase( &MultiMorphologyTest::grayDilationTest2D));
         add( testCase( &MultiMorphologyTest::grayErosionAndDilationTest2D));
+        add( testCase( &MultiMorphologyTest::flatErosionDilationTest2D));
+        add( testCase( &MultiMorphologyTest::flatErosionDilationTest3D));
         add( testCase( &MultiMorphologyTest::grayClosingTest2D));
     }
 };
@@ -63,6 +63,8 @@
 //#include <vigra/random.hxx>
 //#include <vigra/convolution.hxx>
 #include <vigra/accumulator.hxx>
+#include <vigra/histogram.hxx>
+#include <vigra/random.hxx>
 
 namespace std {
 
@@ -83,6 +85,40 @@ using namespace vigra;
 #pragma warning( disable : 4503 )
 #endif
 
+typedef vigra::acc::AccumulatorChainSet<double,
+            vigra::acc::Select<vigra::acc::Mean, vigra::acc::Variance>,
+            vigra::acc::Select<vigra::acc::Mean, vigra::acc::Variance,
+                               vigra::acc::Skewness, vigra::acc::Kurtosis>,
+            vigra::acc::Select<vigra::acc::Mean, vigra::acc::Variance,
+                               vigra::acc::Minimum, vigra::acc::Maximum> >
+        ScalarChainSet;
+
+struct ChainSetExtraStatisticsVisitor
+{
+    double skewness, minimum, maximum;
+
+    ChainSetExtraStatisticsVisitor()
+    : skewness(0.0), minimum(0.0), maximum(0.0)
+    {}
+
+        // the functor is instantiated for every candidate chain, so the
+        // generic overload must compile for all of them
+    template <class Chain>
+    void operator()(Chain const &)
+    {}
+
+    void operator()(ScalarChainSet::Chain2 const & c)
+    {
+        skewness = vigra::acc::get<vigra::acc::Skewness>(c);
+    }
+
+    void operator()(ScalarChainSet::Chain3 const & c)
+    {
+        minimum = vigra::acc::get<vigra::acc::Minimum>(c);
+        maximum = vigra::acc::get<vigra::acc::Maximum>(c);
+    }
+};
+
 struct AccumulatorTest
 {
     AccumulatorTest()
@@ -527,23 +563,24 @@ struct AccumulatorTest
             shouldEqual(get<Covariance>(a).shape(), Shape2(3,3));
             shouldEqual(get<Covariance>(a), covariance);
             std::pair<W const &, Var const &> eigen = get<CovarianceEigensystem>(a);
-            W ew(1.8181423035878563, 0.87335382939336145, 0.24600386701878226); 
-            shouldEqualTolerance(ew, eigen.first, W(1e-15));
-            shouldEqualTolerance(ew, get<Principal<Variance> >(a), W(1e-15));
+            W ew(1.8181423035878563, 0.87335382939336145, 0.24600386701878226);
+            shouldEqualTolerance(ew, eigen.first, W(1e-14));
+            shouldEqualTolerance(ew, get<Principal<Variance> >(a), W(1e-14));
 
+            // column signs according to the closed-form 3x3 eigensolver
             double eigenvectorData[] = {
-                -0.38281255664062192, -0.19398130489891852, -0.90323075668844639,
-                -0.71942795069852928, -0.55075408575738086,  0.42319423528123123,
-                 0.57954979961344579,- 0.81181351945583191, -0.071280006991795777 };
+                -0.38281255664062192, -0.19398130489891852,  0.90323075668844639,
+                -0.71942795069852928, -0.55075408575738086, -0.42319423528123123,
+                 0.57954979961344579,- 0.81181351945583191,  0.071280006991795777 };
             Var ev(3,3, eigenvectorData),
                 eps(3, 3, 1e-14);
             shouldEqualTolerance(ev, eigen.second, eps);
             shouldEqualTolerance(ev, get<Principal<CoordinateSystem> >(a), eps);
 
             shouldEqualTolerance(get<Principal<Sum> >(a), W(0.0), W(1e-15));
-            shouldEqualTolerance(get<Principal<Minimum> >(a), W(-1.3739261246727945, -1.2230658133989472, -0.6526113546697957), W(1e-15));
-            shouldEqualTolerance(get<Principal<Maximum> >(a), W(1.4669637815066938,  1.1452966161690161, 0.60253363030808593), W(1e-15));
-            shouldEqualTolerance(get<Principal<Skewness> >(a), W(0.01148108748350361, -0.07581454384153662, -0.09140344434535799), W(1e-14));
+            shouldEqualTolerance(get<Principal<Minimum> >(a), W(-1.3739261246727945, -1.2230658133989472, -0.60253363030808593), W(1e-14));
+            shouldEqualTolerance(get<Principal<Maximum> >(a), W(1.4669637815066938,  1.1452966161690161, 0.6526113546697957), W(1e-14));
+            shouldEqualTolerance(get<Principal<Skewness> >(a), W(0.011481087483503575, -0.075814543841539211, 0.091403444345358034), W(1e-14));
             shouldEqualTolerance(get<Principal<Kurtosis> >(a), W(-1.9829394126459396, -1.6241963546875782, -1.6255854346698215), W(1e-14));
             shouldEqualTolerance(get<Principal<SumOfAbsDifferences> >(a), W(5.3819863149157, 3.5369487298822575, 1.8777415203686885), W(1e-14));
         }
@@ -651,34 +688,35 @@ struct AccumulatorTest
             V principalVariance(3.82921757948803698, 1.98425472772634914);
             shouldEqualTolerance(get<Principal<Variance> >(a), principalVariance, V(1e-15));
 
+            // column signs according to the closed-form 2x2 eigensolver
             double eigenvectorData[] = {
-                 0.82586108137035807,  0.56387363325286188,
-                 0.56387363325286188, -0.82586108137035807 };
+                 0.82586108137035807, -0.56387363325286188,
+                 0.56387363325286188,  0.82586108137035807 };
             Var ev(2,2, eigenvectorData);
             shouldEqualTolerance(ev, get<Principal<CoordinateSystem> >(a), eps);
 
                 // desired principal projection
             V principal[SIZE] = {
-                V(1.05777049122698186, -0.35614008909044692),
-                V(3.01778940082927427, -0.85387872117719943),
-                V(3.93984027140249449, 1.00107768000535380),
-                V(-0.35703922713407876, 1.90373529408056230),
-                V(-0.71270006734035740, 0.35306282845985459),
-                V(1.79134520751326742, -1.58852073379423842),
-                V(0.55333283753554596, -1.82461691686673699),
-                V(-1.51259720503357187, -2.04438366093898516),
-                V(0.42279656853422592, 0.07806099602999564),
-                V(-1.56250828510342998, -2.10913865877495876),
-                V(1.29107318397063953, 0.70414314950436341),
-                V(1.54530068874035664, 0.10667306729959503),
-                V(-3.30113701276602800, 1.81263639313852387),
-                V(1.77018064523347562, 0.72447404411252858),
-                V(-4.55176376662593363, -1.17927111226656489),
-                V(-0.95270625221923966, 1.47255899419368674),
-                V(-0.14972883129345838, -0.66605263830794725),
-                V(-0.36609398278207039, 0.01925692021370382),
-                V(-1.13427498157747753, 3.25766116941665018),
-                V(-0.78887968311061840, -0.81133800523773636)
+                V(1.05777049122698186, 0.35614008909044692),
+                V(3.01778940082927427, 0.85387872117719943),
+                V(3.93984027140249449, -1.00107768000535380),
+                V(-0.35703922713407876, -1.90373529408056230),
+                V(-0.71270006734035740, -0.35306282845985459),
+                V(1.79134520751326742, 1.58852073379423842),
+                V(0.55333283753554596, 1.82461691686673699),
+                V(-1.51259720503357187, 2.04438366093898516),
+                V(0.42279656853422592, -0.07806099602999564),
+                V(-1.56250828510342998, 2.10913865877495876),
+                V(1.29107318397063953, -0.70414314950436341),
+                V(1.54530068874035664, -0.10667306729959503),
+                V(-3.30113701276602800, -1.81263639313852387),
+                V(1.77018064523347562, -0.72447404411252858),
+                V(-4.55176376662593363, 1.17927111226656489),
+                V(-0.95270625221923966, -1.47255899419368674),
+                V(-0.14972883129345838, 0.66605263830794725),
+                V(-0.36609398278207039, -0.01925692021370382),
+                V(-1.13427498157747753, -3.25766116941665018),
+                V(-0.78887968311061840, 0.81133800523773636)
             };
 
             for(int k=0; k<SIZE; ++k)
@@ -1409,10 +1447,315 @@ struct AccumulatorTest
             shouldEqual(W(2, 0, 2), get<AutoRangeHistogram<3> >(c,1));
             shouldEqual(W(0, 0, 0), get<AutoRangeHistogram<3> >(c,2));
             shouldEqual(W(3, 0, 1), get<AutoRangeHistogram<3> >(c,3));
+
+            c.merge(3, 3);   // must leave the region unchanged
+
+            shouldEqual(get<Count>(c, 3), 4);
+            shouldEqual(W(3, 0, 1), get<AutoRangeHistogram<3> >(c,3));
+        }
+    }
+
+    void testExtractFeaturesParallel()
+    {
+        using namespace vigra::acc;
+
+        typedef CoupledIteratorType<2, double, int>::type Iterator;
+        typedef Iterator::value_type Handle;
+
+        typedef AccumulatorChainArray<Handle,
+                    Select<Count, Mean, Variance, Coord<Mean>,
+                           Global<Count>, Global<Mean>,
+                           DataArg<1>, LabelArg<2> > > A;
+
+        MultiArray<2, double> data(Shape2(50, 40));
+        MultiArray<2, int> labels(Shape2(50, 40));
+        for(int y = 0; y < 40; ++y)
+            for(int x = 0; x < 50; ++x)
+            {
+                data(x, y) = 0.01 * x + 0.5 * y;
+                labels(x, y) = (x / 10 + y / 10) % 5;
+            }
+
+        Iterator start = createCoupledIterator(data, labels),
+                 end   = start.getEndIterator();
+
+        A serial;
+        extractFeatures(start, end, serial);
+
+        A parallel;
+        extractFeatures(start, end, parallel, ParallelOptions().numThreads(4));
+
+        shouldEqual(serial.maxRegionLabel(), parallel.maxRegionLabel());
+        shouldEqual(get<Global<Count> >(serial), get<Global<Count> >(parallel));
+        shouldEqualTolerance(get<Global<Mean> >(serial),
+                             get<Global<Mean> >(parallel), 1e-13);
+        for(int l = 0; l <= serial.maxRegionLabel(); ++l)
+        {
+            shouldEqual(get<Count>(serial, l), get<Count>(parallel, l));
+            shouldEqualTolerance(get<Mean>(serial, l), get<Mean>(parallel, l), 1e-13);
+            shouldEqualTolerance(get<Variance>(serial, l),
+                                 get<Variance>(parallel, l), 1e-12);
+            shouldEqualSequenceTolerance(get<Coord<Mean> >(serial, l).begin(),
+                                         get<Coord<Mean> >(serial, l).end(),
+                                         get<Coord<Mean> >(parallel, l).begin(), 1e-13);
+        }
+
+        // ignoreLabel() set on the target chain must apply to all threads
+        A serial_ignore, parallel_ignore;
+        serial_ignore.ignoreLabel(0);
+        parallel_ignore.ignoreLabel(0);
+        extractFeatures(start, end, serial_ignore);
+        extractFeatures(start, end, parallel_ignore, ParallelOptions().numThreads(3));
+        shouldEqual(get<Count>(serial_ignore, 0), 0);
+        shouldEqual(get<Global<Count> >(serial_ignore),
+                    get<Global<Count> >(parallel_ignore));
+        for(int l = 1; l <= serial_ignore.maxRegionLabel(); ++l)
+            shouldEqualTolerance(get<Mean>(serial_ignore, l),
+                                 get<Mean>(parallel_ignore, l), 1e-13);
+    }
+
+    void testBlockUpdate()
+    {
+        using namespace vigra::acc;
+
+        typedef AccumulatorChain<double,
+                    Select<Count, Sum, Mean, Variance, Skewness,
+                           Minimum, Maximum> > A;
+
+        MultiArray<1, double> data(Shape1(1000));
+        for(int k = 0; k < 1000; ++k)
+            data(k) = std::sin(0.37 * k) + 0.001 * k;
+
+        A sample;
+        extractFeatures(data.begin(), data.end(), sample);
+
+        A block;
+        double const * raw = &data(0);
+        extractFeatures(raw, raw + data.size(), block);
+
+        shouldEqual(get<Count>(sample), get<Count>(block));
+        shouldEqualTolerance(get<Sum>(sample), get<Sum>(block), 1e-14);
+        shouldEqualTolerance(get<Mean>(sample), get<Mean>(block), 1e-14);
+        shouldEqualTolerance(get<Variance>(sample), get<Variance>(block), 1e-13);
+        shouldEqualTolerance(get<Skewness>(sample), get<Skewness>(block), 1e-13);
+        shouldEqual(get<Minimum>(sample), get<Minimum>(block));
+        shouldEqual(get<Maximum>(sample), get<Maximum>(block));
+
+        // block updates also work with dynamic chains
+        DynamicAccumulatorChain<double, Select<Count, Mean, Variance> > dynamic;
+        dynamic.activate<Mean>();
+        extractFeatures(raw, raw + data.size(), dynamic);
+        shouldEqualTolerance(get<Mean>(dynamic), get<Mean>(sample), 1e-14);
+    }
+
+    struct SubarrayChunkProvider
+    {
+        typedef MultiArrayView<1, double> chunk_type;
+
+        MultiArrayView<1, double> data_;
+        unsigned int chunk_size_;
+
+        SubarrayChunkProvider(MultiArrayView<1, double> data, unsigned int chunk_size)
+        : data_(data), chunk_size_(chunk_size)
+        {}
+
+        unsigned int chunkCount() const
+        {
+            return (unsigned int)((data_.size() + chunk_size_ - 1) / chunk_size_);
+        }
+
+        chunk_type chunk(unsigned int i) const
+        {
+            MultiArrayIndex begin = (MultiArrayIndex)(i * chunk_size_),
+                            end = std::min<MultiArrayIndex>(begin + chunk_size_,
+                                                            data_.size());
+            return data_.subarray(Shape1(begin), Shape1(end));
+        }
+    };
+
+    void testChunkedExtraction()
+    {
+        using namespace vigra::acc;
+
+        typedef AccumulatorChain<double,
+                    Select<Count, Mean, Variance, Minimum, Maximum,
+                           SumOfAbsDifferences> > A;
+
+        MultiArray<1, double> data(Shape1(777));
+        for(int k = 0; k < 777; ++k)
+            data(k) = std::cos(0.21 * k) + 0.002 * k;
+
+        A reference;
+        extractFeatures(data.begin(), data.end(), reference);
+        shouldEqual(reference.passesRequired(), 2u);
+
+        SubarrayChunkProvider chunks(data, 100);
+        shouldEqual(chunks.chunkCount(), 8u);
+
+        A chunked;
+        extractFeaturesChunked(chunks, chunked);
+
+        shouldEqual(get<Count>(chunked), get<Count>(reference));
+        shouldEqual(get<Minimum>(chunked), get<Minimum>(reference));
+        shouldEqual(get<Maximum>(chunked), get<Maximum>(reference));
+        shouldEqualTolerance(get<Mean>(chunked), get<Mean>(reference), 1e-15);
+        shouldEqualTolerance(get<Variance>(chunked), get<Variance>(reference), 1e-15);
+        shouldEqualTolerance(get<SumOfAbsDifferences>(chunked),
+                             get<SumOfAbsDifferences>(reference), 1e-15);
+
+        // checkpoint in the middle of pass 2 and resume in a fresh chain
+        A running;
+        ChunkedExtractionProgress progress;
+        for(int step = 0; step < 9; ++step)
+            should(extractFeaturesChunk(chunks, running, progress));
+
+        ArrayVector<char> snapshot(A::serializedSize());
+        running.serialize(snapshot.begin());
+
+        A resumed;
+        resumed.deserialize(snapshot.begin());
+        while(extractFeaturesChunk(chunks, resumed, progress))
+        {}
+
+        shouldEqual(get<Count>(resumed), get<Count>(reference));
+        shouldEqualTolerance(get<Mean>(resumed), get<Mean>(reference), 1e-15);
+        shouldEqualTolerance(get<Variance>(resumed), get<Variance>(reference), 1e-15);
+        shouldEqualTolerance(get<SumOfAbsDifferences>(resumed),
+                             get<SumOfAbsDifferences>(reference), 1e-15);
+    }
+
+    void testChainSet()
+    {
+        using namespace vigra::acc;
+
+        double data[] = { 1.0, 2.0, 3.0, 5.0 };
+
+        {
+            ScalarChainSet a;
+            shouldEqual(3u, ScalarChainSet::size());
+            shouldEqual(0u, a.selected());
+            shouldEqual(1u, a.passesRequired());
+
+            for(int k=0; k<4; ++k)
+                a(data[k]);
+
+            shouldEqual(a.get<Count>(), 4.0);
+            shouldEqual(a.get<Mean>(), 2.75);
+            shouldEqualTolerance(a.get<Variance>(), 2.1875, 1e-15);
+        }
+
+        {
+            ScalarChainSet a;
+            a.select(1);
+            shouldEqual(1u, a.selected());
+            shouldEqual(2u, a.passesRequired());
+
+            for(int k=0; k<4; ++k)
+                a(data[k]);
+            for(int k=0; k<4; ++k)
+                a.updatePassN(data[k], 2);
+
+            shouldEqual(a.get<Mean>(), 2.75);
+            shouldEqualTolerance(a.get<Variance>(), 2.1875, 1e-15);
+
+            ChainSetExtraStatisticsVisitor v;
+            a.applyToSelected(v);
+            shouldEqualTolerance(v.skewness, 0.43465075957466565, 1e-15);
+        }
+
+        {
+            ScalarChainSet a;
+            a.select(2);
+
+            for(int k=0; k<4; ++k)
+                a(data[k]);
+
+            shouldEqual(a.get<Mean>(), 2.75);
+
+            ChainSetExtraStatisticsVisitor v;
+            a.applyToSelected(v);
+            shouldEqual(v.minimum, 1.0);
+            shouldEqual(v.maximum, 5.0);
+
+            a.reset();
+            a.select(0);
+            for(int k=0; k<4; ++k)
+                a(data[k]);
+            shouldEqual(a.get<Count>(), 4.0);
+
+            try
+            {
+                a.select(3);
+                failTest("select() failed to throw exception");
+            }
+            catch(ContractViolation & c)
+            {
+                std::string expected("\nPrecondition violation!\nAccumulatorChainSet::select(): index out of range.");
+                std::string message(c.what());
+                should(0 == expected.compare(message.substr(0,expected.size())));
+            }
         }
     }
 };
 
+struct HistogramTest
+{
+    void testBulkFill()
+    {
+        using namespace vigra;
+
+        MersenneTwister random(1);
+        ArrayVector<double> data(10000);
+        for(unsigned int k=0; k<data.size(); ++k)
+            data[k] = random.uniform(-0.2, 1.2); // includes out-of-range values
+
+        Histogram<double, int> reference(0.0, 1.0, 37);
+        for(unsigned int k=0; k<data.size(); ++k)
+            reference.add(data[k]);
+
+        Histogram<double, int> bulk(0.0, 1.0, 37);
+        bulk.fill(data.begin(), data.end());
+
+        for(int k=0; k<reference.size(); ++k)
+            shouldEqual(bulk[k], reference[k]);
+    }
+
+    void testParallelFill()
+    {
+        using namespace vigra;
+
+        MersenneTwister random(2);
+        ArrayVector<double> data(10000);
+        for(unsigned int k=0; k<data.size(); ++k)
+            data[k] = random.uniform53();
+
+        Histogram<double, int> reference(0.0, 1.0, 64);
+        reference.fill(data.begin(), data.end());
+
+        Histogram<double, int> serial(0.0, 1.0, 64);
+        serial.fillParallel(data.begin(), data.end(),
+                            ParallelOptions().numThreads(1));
+        for(int k=0; k<reference.size(); ++k)
+            shouldEqual(serial[k], reference[k]);
+
+        Histogram<double, int> parallel(0.0, 1.0, 64);
+        parallel.fillParallel(data.begin(), data.end(),
+                              ParallelOptions().numThreads(4).blockSize(333));
+        for(int k=0; k<reference.size(); ++k)
+            shouldEqual(parallel[k], reference[k]);
+
+        // more threads than samples
+        ArrayVector<double> tiny(data.begin(), data.begin()+3);
+        Histogram<double, int> small(0.0, 1.0, 64);
+        small.fillParallel(tiny.begin(), tiny.end(),
+                           ParallelOptions().numThreads(8));
+        int total = 0;
+        for(int k=0; k<small.size(); ++k)
+            total += small[k];
+        shouldEqual(total, 3);
+    }
+};
+
 struct FeaturesTestSuite : public vigra::test_suite
 {
     FeaturesTestSuite()
@@ -1426,7 +1769,13 @@ struct FeaturesTestSuite : public vigra::test_suite
         add(testCase(&AccumulatorTest::testCoordAccess));
         add(testCase(&AccumulatorTest::testHistogram));
         add(testCase(&AccumulatorTest::testLabelDispatch));
+        add(testCase(&AccumulatorTest::testExtractFeaturesParallel));
+        add(testCase(&AccumulatorTest::testBlockUpdate));
+        add(testCase(&AccumulatorTest::testChunkedExtraction));
+        add(testCase(&AccumulatorTest::testChainSet));
         add(testCase(&AccumulatorTest::testIndexSpecifiers));
+        add(testCase(&HistogramTest::testBulkFill));
+        add(testCase(&HistogramTest::testParallelFill));
     }
 };
 
@@ -259,6 +259,43 @@ struct OptimizationTest {
         }
     }
 
+    void testLarsParallel()
+    {
+        // multi-threaded candidate evaluation must reproduce the reference solutions ...
+        LeastAngleRegressionOptions larsOptions;
+        larsOptions = larsOptions.lasso().leastSquaresSolutions(false)
+                                 .parallelOptions(ParallelOptions().numThreads(4));
+
+        for(int k=0; k<size; ++k)
+        {
+            std::ostringstream s;
+            s << "parallel lasso " << k;
+            VIGRA_TEST_LARS(larsOptions, k, lasso, s.str().c_str());
+        }
+
+        // ... and must in fact be identical to the single-threaded results
+        for(int k=0; k<size; ++k)
+        {
+            Matrix<double> X(x[k]), Y(y[k]);
+            prepareColumns(Y, Y, DataPreparationGoals(ZeroMean));
+            prepareColumns(X, X, DataPreparationGoals(ZeroMean|UnitVariance));
+
+            ArrayVector<Matrix<double> > serialResults, parallelResults;
+            ArrayVector<ArrayVector<MultiArrayIndex> > serialSets, parallelSets;
+
+            unsigned int serialCount = leastAngleRegression(X, Y, serialSets, serialResults),
+                         parallelCount = leastAngleRegression(X, Y, parallelSets, parallelResults,
+                                  LeastAngleRegressionOptions().parallelOptions(ParallelOptions().numThreads(4)));
+
+            shouldEqual(serialCount, parallelCount);
+            for(unsigned int j=0; j<serialCount; ++j)
+            {
+                shouldEqualSequence(serialSets[j].begin(), serialSets[j].end(), parallelSets[j].begin());
+                shouldEqualSequence(serialResults[j].begin(), serialResults[j].end(), parallelResults[j].begin());
+            }
+        }
+    }
+
     void testNNLSQ()
     {
         double epsilon = 1e-10;
@@ -390,6 +427,64 @@ struct OptimizationTest {
             shouldEqualSequenceTolerance(ref.data(), ref.data()+50, result.data(), epsilon);
         }
     }
+
+    void testQuadProgWarmStart()
+    {
+        double epsilon = 1e-12;
+
+        double Gdata[] = {13.0, 12.0, -2.0,
+                          12.0, 17.0,  6.0,
+                          -2.0,  6.0, 12.0};
+
+        double gdata[] = {-22.0, -14.5, 13.0};
+
+        double CIdata[] = { 1.0,  0.0,  0.0,
+                            0.0,  1.0,  0.0,
+                            0.0,  0.0,  1.0,
+                           -1.0,  0.0,  0.0,
+                            0.0, -1.0,  0.0,
+                            0.0,  0.0, -1.0};
+
+        double cidata[] = {-1.0, -1.0, -1.0, -1.0, -1.0, -1.0};
+
+        Matrix<double> G(3,3, Gdata),
+                       g(3,1, gdata),
+                       CE,
+                       ce,
+                       CI(6,3, CIdata),
+                       ci(6,1, cidata),
+                       xcold(3,1),
+                       xwarm(3,1);
+
+        // the first solve with an empty context must equal the cold solve exactly
+        QuadraticProgrammingContext<double> context;
+        double fcold = quadraticProgramming(G, g, CE, ce, CI, ci, xcold),
+               fwarm = quadraticProgramming(G, g, CE, ce, CI, ci, xwarm, context);
+        shouldEqual(fcold, fwarm);
+        shouldEqualSequence(xcold.data(), xcold.data()+3, xwarm.data());
+        should(context.activeSet().size() > 0);
+
+        // warm-started solves of perturbed problems must agree with cold solves
+        for(int k=1; k<=5; ++k)
+        {
+            Matrix<double> gk(g);
+            for(int i=0; i<3; ++i)
+                gk(i,0) += 0.05*k*(i+1);
+
+            fcold = quadraticProgramming(G, gk, CE, ce, CI, ci, xcold);
+            fwarm = quadraticProgramming(G, gk, CE, ce, CI, ci, xwarm, context);
+            shouldEqualTolerance(fcold, fwarm, epsilon);
+            shouldEqualSequenceTolerance(xcold.data(), xcold.data()+3, xwarm.data(), epsilon);
+        }
+
+        // after reset(), the context can be reused with a different matrix G
+        context.reset();
+        Matrix<double> G2 = 2.0*G;
+        fcold = quadraticProgramming(G2, g, CE, ce, CI, ci, xcold);
+        fwarm = quadraticProgramming(G2, g, CE, ce, CI, ci, xwarm, context);
+        shouldEqual(fcold, fwarm);
+        shouldEqualSequence(xcold.data(), xcold.data()+3, xwarm.data());
+    }
 };
 
 double OptimizationTest::w[100] =
@@ -420,8 +515,10 @@ struct OptimizationTestSuite : public vigra::test_suite {
         add( testCase(&OptimizationTest::testLassoLSQ));
         add( testCase(&OptimizationTest::testNNLasso));
         add( testCase(&OptimizationTest::testNNLassoLSQ));
+        add( testCase(&OptimizationTest::testLarsParallel));
         add( testCase(&OptimizationTest::testNNLSQ));
         add( testCase(&OptimizationTest::testQuadProg));
+        add( testCase(&OptimizationTest::testQuadProgWarmStart));
     }
 };
 
@@ -308,9 +308,10 @@ void SamplerTests::testSamplingWithoutReplacementChi2()
     // Use fixed random numbers so that the sampling is reproducible.
     int nsamples = 120000;
     int nclasses = 120;
-    Sampler<> sampler( 5, 
+    MersenneTwister random;  // named: the sampler keeps a reference
+    Sampler<> sampler( 5,
                 SamplerOptions().withoutReplacement().sampleSize(5),
-                MersenneTwister());
+                random);
     std::map<unsigned int, int> wierdmap;
     std::map<unsigned int , int>::iterator iter;
     for(int ii = 0; ii < 1000; ++ii)
@@ -367,9 +368,10 @@ void SamplerTests::testSamplingWithReplacementChi2()
            ratio = double(numOfSamples) / totalDataCount;
 
     {
-        Sampler<> sampler(totalDataCount, 
+        MersenneTwister random;  // named: the sampler keeps a reference
+        Sampler<> sampler(totalDataCount,
              SamplerOptions().withReplacement().sampleSize(numOfSamples),
-             MersenneTwister());
+             random);
 
         sampler.sample();
         for(int ii = 0; ii < numOfSamples; ++ii)
@@ -403,6 +405,101 @@ void SamplerTests::testSamplingWithReplacementChi2()
     }
 }
 
+struct AliasSamplerTests
+{
+    void testWeightedChi2()
+    {
+        // Check that indices are drawn proportionally to their weights
+        // (chi-square test as in the Sampler tests above).
+        // Use fixed random numbers so that the sampling is reproducible.
+        double weights[] = { 1.0, 2.0, 3.0, 4.0 };
+        double sum = 10.0;
+        int numOfSamples = 200000;
+
+        AliasSampler<> sampler(weights, weights + 4, MersenneTwister());
+        vigra::ArrayVector<int> observed(4);
+        observed.init(0);
+        for(int ii = 0; ii < numOfSamples; ++ii)
+        {
+            int index = sampler.sample();
+            should(0 <= index && index < 4);
+            ++observed[index];
+        }
+
+        double chi_squared = 0;
+        for(int ii = 0; ii < 4; ++ii)
+        {
+            double expected = numOfSamples * weights[ii] / sum;
+            chi_squared += sq(observed[ii] - expected) / expected;
+        }
+        shouldEqualTolerance(0, chi2CDF(3, chi_squared)-0.5, 0.4);
+    }
+
+    void testZeroWeights()
+    {
+        // indices with zero weight must never be drawn
+        double weights[] = { 0.0, 1.0, 0.0, 2.0 };
+        AliasSampler<> sampler(weights, weights + 4, MersenneTwister());
+        shouldEqual(sampler.totalCount(), 4);
+        for(int ii = 0; ii < 10000; ++ii)
+        {
+            int index = sampler.sample();
+            should(index == 1 || index == 3);
+        }
+    }
+};
+
+struct ReservoirSamplerTests
+{
+    void testShortStream()
+    {
+        // a stream shorter than the reservoir is kept completely
+        ReservoirSampler<int> sampler(10, MersenneTwister());
+        for(int ii = 0; ii < 5; ++ii)
+            sampler.add(ii);
+        shouldEqual(sampler.size(), 5);
+        shouldEqual(sampler.seenCount(), (UInt32)5);
+        for(int ii = 0; ii < 5; ++ii)
+            shouldEqual(sampler[ii], ii);
+    }
+
+    void testUniformity()
+    {
+        // Check that every stream item ends up in the reservoir with
+        // equal probability. (A plain chi-square test would be
+        // miscalibrated here because each run contributes exactly
+        // reservoirSize items, making the inclusion counts negatively
+        // correlated; we therefore bound each item's frequency
+        // individually at about five standard deviations.)
+        // Use fixed random numbers so that the sampling is reproducible.
+        int streamLength = 100, reservoirSize = 10, numOfRuns = 10000;
+        vigra::ArrayVector<int> observed(streamLength);
+        observed.init(0);
+
+        ReservoirSampler<int> sampler(reservoirSize, MersenneTwister());
+        for(int run = 0; run < numOfRuns; ++run)
+        {
+            sampler.reset();
+            for(int ii = 0; ii < streamLength; ++ii)
+                sampler.add(ii);
+            shouldEqual(sampler.size(), reservoirSize);
+
+            // the sample is without replacement: all items distinct
+            vigra::ArrayVector<int> items(sampler.sample().begin(), sampler.sample().end());
+            std::sort(items.begin(), items.end());
+            for(int ii = 1; ii < reservoirSize; ++ii)
+                should(items[ii-1] < items[ii]);
+
+            for(int ii = 0; ii < reservoirSize; ++ii)
+                ++observed[sampler[ii]];
+        }
+
+        double expected = double(numOfRuns) * reservoirSize / streamLength;
+        for(int ii = 0; ii < streamLength; ++ii)
+            shouldEqualTolerance(0, (observed[ii] - expected) / expected, 0.16);
+    }
+};
+
 struct SamplerTestSuite
 : public vigra::test_suite
 {
@@ -415,6 +512,10 @@ struct SamplerTestSuite
         add(testCase(&SamplerTests::testStratifiedSamplingWithReplacement));
         add(testCase(&SamplerTests::testSamplingWithoutReplacementChi2));
         add(testCase(&SamplerTests::testSamplingWithReplacementChi2));
+        add(testCase(&AliasSamplerTests::testWeightedChi2));
+        add(testCase(&AliasSamplerTests::testZeroWeights));
+        add(testCase(&ReservoirSamplerTests::testShortStream));
+        add(testCase(&ReservoirSamplerTests::testUniformity));
     }
 };
 
@@ -158,6 +158,68 @@ public:
         }
     }
 
+    void testStreamReader() {
+        char sifFile[] = "testSif_forBlocks_4_16_30001.sif";
+
+        SIFImportInfo infoSIF(sifFile);
+        should (infoSIF.stacksize() == 3);
+
+        // import whole volume to MultiArray as reference
+        MultiArray<3,float> in_data_volume(MultiArrayShape<3>::type(infoSIF.width(), infoSIF.height(), infoSIF.stacksize()));
+        readSIF(infoSIF, in_data_volume);
+
+        SIFStreamReader reader(infoSIF);
+        should (reader.width() == infoSIF.width());
+        should (reader.height() == infoSIF.height());
+        should (reader.numFrames() == infoSIF.stacksize());
+
+        // frame positions are computed from the header offset
+        for (int i=0; i<reader.numFrames(); ++i) {
+            should (reader.frameOffset(i) ==
+                    infoSIF.getOffset() + (std::ptrdiff_t)i*infoSIF.width()*infoSIF.height()*4);
+        }
+
+        // read single frames in random order to exercise seeking
+        MultiArray<2,float> frame(MultiArrayShape<2>::type(reader.width(), reader.height()));
+        const int frameOrder[] = { 2, 0, 1, 0, 2 };
+        for (unsigned int k=0; k<sizeof(frameOrder)/sizeof(int); ++k) {
+            int i = frameOrder[k];
+            reader.readFrame(i, frame);
+            should (frame == in_data_volume.bindOuter(i));
+        }
+
+        // sequential scan with read-ahead buffer
+        SIFStreamReader bufferedReader(infoSIF, 2);
+        for (int i=0; i<bufferedReader.numFrames(); ++i) {
+            bufferedReader.readFrame(i, frame);
+            should (frame == in_data_volume.bindOuter(i));
+        }
+        // random access must invalidate the buffer correctly
+        for (unsigned int k=0; k<sizeof(frameOrder)/sizeof(int); ++k) {
+            int i = frameOrder[k];
+            bufferedReader.readFrame(i, frame);
+            should (frame == in_data_volume.bindOuter(i));
+        }
+
+        // frame ranges are read with a single file access
+        MultiArray<3,float> frames(MultiArrayShape<3>::type(reader.width(), reader.height(), 2));
+        reader.readFrames(1, 3, frames);
+        should (frames == in_data_volume.subarray(Shape3(0,0,1), Shape3(4,5,3)));
+        reader.readFrames(0, 2, frames);
+        should (frames == in_data_volume.subarray(Shape3(0,0,0), Shape3(4,5,2)));
+
+        // invalid frame indices must be rejected
+        try {
+            reader.readFrame(reader.numFrames(), frame);
+            failTest("no exception thrown");
+        }
+        catch (vigra::ContractViolation & e) {
+            std::string expected("\nPrecondition violation!\nSIFStreamReader::readFrame(): frame index out of range.");
+            std::string message(e.what());
+            should (0 == expected.compare(message.substr(0, expected.size())));
+        }
+    }
+
 };
 
 
@@ -173,6 +235,7 @@ struct SifImportTestSuite : public vigra::test_suite
         add(testCase(&SifImportTest::testSifImport_4_6));
         add(testCase(&SifImportTest::testShapeOfDimension));
         add(testCase(&SifImportTest::testReadBlock));
+        add(testCase(&SifImportTest::testStreamReader));
  
     }
 };
@@ -137,6 +137,82 @@ struct LabelingTest
         }
     }
 
+    void labelingParallelTest()
+    {
+        int w = 123, h = 97;
+        Image img(w, h);
+        for(int y = 0; y < h; ++y)
+            for(int x = 0; x < w; ++x)
+                img(x, y) = ((x*x + 3*y + x*y / 7) / 5) % 2;
+
+        for(int conn = 0; conn <= 1; ++conn)
+        {
+            Image serial(w, h), parallel(w, h);
+            unsigned int serialCount =
+                labelImage(srcImageRange(img), destImage(serial), conn != 0);
+            unsigned int parallelCount =
+                labelImage(srcImageRange(img), destImage(parallel), conn != 0,
+                           ParallelOptions().numThreads(4));
+
+            shouldEqual(parallelCount, serialCount);
+            for(int y = 0; y < h; ++y)
+                for(int x = 0; x < w; ++x)
+                    shouldEqual(parallel(x, y), serial(x, y));
+        }
+    }
+
+    void applyLabelLUTTest()
+    {
+        int w = 123, h = 97;
+        Image img(w, h);
+        for(int y = 0; y < h; ++y)
+            for(int x = 0; x < w; ++x)
+                img(x, y) = ((x*x + 3*y + x*y / 7) / 5) % 2;
+
+        IImage labels(w, h);
+        unsigned int count =
+            labelImage(srcImageRange(img), destImage(labels), false);
+        should(count > 4);
+
+        // merge some of the regions and build a compacting LUT
+        vigra::detail::UnionFindArray<int> uf((int)count + 1);
+        for(int k = 2; k + 1 <= (int)count; k += 3)
+            uf.makeUnion(k, k + 1);
+        ArrayVector<int> lut;
+        int maxLabel = (int)uf.buildCompactingLUT(lut);
+        shouldEqual(lut.size(), (std::size_t)count + 1);
+
+        IImage expected(w, h);
+        for(int y = 0; y < h; ++y)
+            for(int x = 0; x < w; ++x)
+                expected(x, y) = lut[(std::size_t)labels(x, y)];
+
+        IImage res(w, h);
+        applyLabelLUT(srcImageRange(labels), destImage(res), lut);
+        int maxFound = 0;
+        for(int y = 0; y < h; ++y)
+            for(int x = 0; x < w; ++x)
+            {
+                shouldEqual(res(x, y), expected(x, y));
+                if(res(x, y) > maxFound)
+                    maxFound = res(x, y);
+            }
+        shouldEqual(maxFound, maxLabel);
+
+        IImage resParallel(w, h);
+        applyLabelLUT(srcImageRange(labels), destImage(resParallel), lut,
+                      ParallelOptions().numThreads(4));
+        for(int y = 0; y < h; ++y)
+            for(int x = 0; x < w; ++x)
+                shouldEqual(resParallel(x, y), expected(x, y));
+
+        // relabeling in-place is allowed
+        applyLabelLUT(srcImageRange(labels), destImage(labels), lut);
+        for(int y = 0; y < h; ++y)
+            for(int x = 0; x < w; ++x)
+                shouldEqual(labels(x, y), expected(x, y));
+    }
+
     void labelingFourTest1()
     {
         Image res(img1);
@@ -661,6 +737,51 @@ struct EdgeDetectionTest
         }
     }
 
+    void cannyParallelTest()
+    {
+        // the strip-parallel versions must reproduce the sequential
+        // results exactly, including the edgel order
+        std::vector<vigra::Edgel> serial, parallel;
+        cannyEdgelList(srcImageRange(imgCanny), serial, 1.0);
+        cannyEdgelList(srcImageRange(imgCanny), parallel, 1.0,
+                       vigra::ParallelOptions().numThreads(3));
+
+        shouldEqual(parallel.size(), serial.size());
+        for(unsigned int i=0; i<serial.size(); ++i)
+        {
+            shouldEqual(parallel[i].x, serial[i].x);
+            shouldEqual(parallel[i].y, serial[i].y);
+            shouldEqual(parallel[i].strength, serial[i].strength);
+            shouldEqual(parallel[i].orientation, serial[i].orientation);
+        }
+
+        double threshold = 1.25;
+        serial.clear();
+        parallel.clear();
+        cannyEdgelListThreshold(srcImageRange(imgCanny), serial, 1.0, threshold);
+        cannyEdgelListThreshold(srcImageRange(imgCanny), parallel, 1.0, threshold,
+                                vigra::ParallelOptions().numThreads(3));
+
+        shouldEqual(parallel.size(), serial.size());
+        for(unsigned int i=0; i<serial.size(); ++i)
+        {
+            shouldEqual(parallel[i].x, serial[i].x);
+            shouldEqual(parallel[i].y, serial[i].y);
+            shouldEqual(parallel[i].strength, serial[i].strength);
+        }
+
+        vigra::BImage result(40, 40), resultParallel(40, 40);
+        result = 0;
+        resultParallel = 0;
+        cannyEdgeImage(srcImageRange(imgCanny), destImage(result), 1.0, 0.1, 1);
+        cannyEdgeImage(srcImageRange(imgCanny), destImage(resultParallel), 1.0, 0.1, 1,
+                       vigra::ParallelOptions().numThreads(3));
+
+        for(int y=0; y<40; ++y)
+            for(int x=0; x<40; ++x)
+                shouldEqual(resultParallel(x,y), result(x,y));
+    }
+
     void cannyEdgeImageWithThinningTest()
     {
         vigra::BImage result(40, 40);
@@ -761,6 +882,40 @@ struct DistanceTransformTest
         }
     }
 
+    void chamferDistanceTransformTest()
+    {
+        Image res(img), resp(img);
+
+        chamferDistanceTransform(srcImageRange(img), destImage(res), 0.0);
+        chamferDistanceTransform(srcImageRange(img), destImage(resp), 0.0,
+                                 vigra::ParallelOptions().numThreads(4));
+
+        Image::Iterator i = res.upperLeft();
+        Image::Accessor acc = res.accessor();
+        int x,y;
+
+        for(y=0; y<7; ++y)
+        {
+            for(x=0; x<7; ++x)
+            {
+                double dist = acc(i, vigra::Diff2D(x,y));
+                double dist1 = VIGRA_CSTD::sqrt((2.0 - x)*(2.0 - x) +
+                                         (2.0 - y)*(2.0 - y));
+                double dist2 = VIGRA_CSTD::sqrt((5.0 - x)*(5.0 - x) +
+                                         (5.0 - y)*(5.0 - y));
+                double desired = (dist1 < dist2) ? dist1 : dist2;
+
+                // the chamfer metric overestimates the Euclidean
+                // distance by at most about 8%
+                should(dist >= desired - 1e-6);
+                should(dist <= desired * 1.083 + 1e-6);
+
+                // the parallel result may differ by rounding only
+                shouldEqualTolerance(resp(x,y), dist, 1e-6);
+            }
+        }
+    }
+
     void distanceTransformLInfTest()
     {
 
@@ -1030,6 +1185,35 @@ struct LocalMinMaxTest
         shouldEqualSequence(res.begin(), res.end(), desired);
     }
 
+    void localMinimumParallelTest()
+    {
+        // the parallel version must produce exactly the sequential result
+        Image res(img), resp(img);
+        for(int neigh = 4; neigh <= 8; neigh += 4)
+        {
+            for(int plateaus = 0; plateaus <= 1; ++plateaus)
+            {
+                LocalMinmaxOptions opt = LocalMinmaxOptions()
+                                          .neighborhood(neigh)
+                                          .allowPlateaus(plateaus != 0)
+                                          .allowAtBorder();
+                res.init(0);
+                resp.init(0);
+                localMinima(srcImageRange(img), destImage(res), opt);
+                localMinima(srcImageRange(img), destImage(resp), opt,
+                            vigra::ParallelOptions().numThreads(4));
+                shouldEqualSequence(resp.begin(), resp.end(), res.begin());
+
+                res.init(0);
+                resp.init(0);
+                localMaxima(srcImageRange(img), destImage(res), opt);
+                localMaxima(srcImageRange(img), destImage(resp), opt,
+                            vigra::ParallelOptions().numThreads(4));
+                shouldEqualSequence(resp.begin(), resp.end(), res.begin());
+            }
+        }
+    }
+
     void localMinimum4Test()
     {
         Image res(img);
@@ -1478,6 +1662,54 @@ struct WatershedsTest
 #endif /* #if 0 */
     }
 
+    void watershedsTurboUInt8Test()
+    {
+        BImage heights(img.size());
+        copyImage(srcImageRange(img), destImage(heights));
+
+        IImage automatic(img.size()), turbo(img.size());
+
+        // 8-bit heights must select the bucket-queue algorithm
+        // automatically and reproduce the explicit turbo result
+        int automaticCount =
+            watershedsRegionGrowing(srcImageRange(heights), destImage(automatic),
+                                WatershedOptions().seedOptions(SeedOptions().minima()));
+        int turboCount =
+            watershedsRegionGrowing(srcImageRange(heights), destImage(turbo),
+                                WatershedOptions().turboAlgorithm(256)
+                                    .seedOptions(SeedOptions().minima()));
+
+        shouldEqual(automaticCount, turboCount);
+        shouldEqualSequence(automatic.begin(), automatic.end(), turbo.begin());
+
+        // contours are unsupported by the turbo algorithm => the heap-based
+        // code must still be chosen for 8-bit data in that case
+        int contourCount =
+            watershedsRegionGrowing(srcImageRange(heights), destImage(automatic),
+                                WatershedOptions().keepContours()
+                                    .seedOptions(SeedOptions().minima()));
+        should(contourCount > 0);
+    }
+
+    void watershedsParallelTest()
+    {
+        IImage serial(img.size()), parallel(img.size());
+
+        int serialCount = watershedsUnionFind(srcImageRange(img), destImage(serial));
+        int parallelCount = watershedsUnionFind(srcImageRange(img), destImage(parallel),
+                                                ParallelOptions().numThreads(3));
+        shouldEqual(parallelCount, serialCount);
+        shouldEqualSequence(parallel.begin(), parallel.end(), serial.begin());
+
+        serialCount = watershedsUnionFind(srcImageRange(img), destImage(serial),
+                                          FourNeighborCode());
+        parallelCount = watershedsUnionFind(srcImageRange(img), destImage(parallel),
+                                            FourNeighborCode(),
+                                            ParallelOptions().numThreads(4));
+        shouldEqual(parallelCount, serialCount);
+        shouldEqualSequence(parallel.begin(), parallel.end(), serial.begin());
+    }
+
     void watersheds4Test()
     {
         IImage res(img.size());
@@ -1671,6 +1903,36 @@ struct RegionGrowingTest
         shouldEqualSequence(res.begin(), res.end(), wres.begin());
     }
 
+    void voronoiParallelTest()
+    {
+        Image res(img);
+
+        vigra::ArrayOfRegionStatistics<DirectCostFunctor> cost(2);
+        seededRegionGrowing(srcImageRange(img), srcImage(seeds),
+                            destImage(res), cost, CompleteGrow,
+                            vigra::FourNeighborCode(),
+                            vigra::NumericTraits<double>::max(),
+                            vigra::ParallelOptions().numThreads(4));
+
+        // plateau ties may be resolved differently than sequentially,
+        // so only check the invariants of a complete grow
+        Image::Iterator i = res.upperLeft();
+        Image::Accessor acc = res.accessor();
+        int x,y;
+
+        for(y=0; y<7; ++y)
+        {
+            for(x=0; x<7; ++x)
+            {
+                double label = acc(i, vigra::Diff2D(x,y));
+                should(label == 1.0 || label == 2.0);
+                double seed = seeds(x,y);
+                if(seed > 0.0)
+                    shouldEqual(label, seed);
+            }
+        }
+    }
+
     void voronoiWithBorderTest()
     {
         Image res(img);
@@ -1691,6 +1953,89 @@ struct RegionGrowingTest
         shouldEqualSequence(res.begin(), res.end(), reference);
     }
 
+    struct DirectUInt8CostFunctor
+    {
+        typedef vigra::UInt8 argument_type;
+        typedef vigra::UInt8 result_type;
+        typedef vigra::UInt8 cost_type;
+
+        void operator()(argument_type const &) {}
+
+        cost_type cost(argument_type const & v) const
+        {
+            return v;
+        }
+    };
+
+    void voronoiBucketQueueTest()
+    {
+        // an 8-bit cost_type must select the bucket queue variant of
+        // seededRegionGrowing(); quantization ties may be resolved
+        // differently than by the heap, so only check the invariants
+        // of a complete grow
+        vigra::BImage costimg(img.size());
+        copyImage(srcImageRange(img), destImage(costimg));
+
+        Image res(img.size());
+        vigra::ArrayOfRegionStatistics<DirectUInt8CostFunctor> cost(2);
+        seededRegionGrowing(srcImageRange(costimg), srcImage(seeds),
+                            destImage(res), cost);
+
+        int x, y;
+        for(y=0; y<7; ++y)
+        {
+            for(x=0; x<7; ++x)
+            {
+                double label = res(x,y);
+                should(label == 1.0 || label == 2.0);
+                if(seeds(x,y) > 0.0)
+                    shouldEqual(label, seeds(x,y));
+
+                // away from ties, the pixel must belong to the nearer seed
+                double dist1 = VIGRA_CSTD::sqrt((2.0 - x)*(2.0 - x) +
+                                                (2.0 - y)*(2.0 - y));
+                double dist2 = VIGRA_CSTD::sqrt((5.0 - x)*(5.0 - x) +
+                                                (5.0 - y)*(5.0 - y));
+                if(VIGRA_CSTD::fabs(dist1 - dist2) > 1.5)
+                    shouldEqual(label, (dist1 < dist2) ? 1.0 : 2.0);
+            }
+        }
+
+        // StopAtThreshold: exactly the pixels with cost <= max_cost
+        // are reachable in cost order, everything else stays unlabeled
+        res.init(0);
+        seededRegionGrowing(srcImageRange(costimg), srcImage(seeds),
+                            destImage(res), cost, StopAtThreshold,
+                            vigra::FourNeighborCode(), 1.0);
+
+        for(y=0; y<7; ++y)
+        {
+            for(x=0; x<7; ++x)
+            {
+                if(costimg(x,y) <= 1)
+                    should(res(x,y) == 1.0 || res(x,y) == 2.0);
+                else
+                    shouldEqual(res(x,y), 0.0);
+            }
+        }
+
+        // KeepContours: differing labels must be separated by contour pixels
+        res.init(0);
+        seededRegionGrowing(srcImageRange(costimg), srcImage(seeds),
+                            destImage(res), cost, KeepContours);
+
+        for(y=0; y<7; ++y)
+        {
+            for(x=0; x<6; ++x)
+            {
+                should(res(x,y) != 1.0 || res(x+1,y) != 2.0);
+                should(res(x,y) != 2.0 || res(x+1,y) != 1.0);
+                should(res(y,x) != 1.0 || res(y,x+1) != 2.0);
+                should(res(y,x) != 2.0 || res(y,x+1) != 1.0);
+            }
+        }
+    }
+
     Image img, seeds;
 };
 
@@ -1848,6 +2193,45 @@ struct InterestOperatorTest
         }
     }
 
+    void cornerDetectorStageTest()
+    {
+        typedef vigra::CornerDetectorStage<double> Stage;
+
+        Image harris(img), foerstner(img), rohr(img), beaudet(img);
+        cornerResponseFunction(srcImageRange(img), destImage(harris), 1.0);
+        foerstnerCornerDetector(srcImageRange(img), destImage(foerstner), 1.0);
+        rohrCornerDetector(srcImageRange(img), destImage(rohr), 1.0);
+        beaudetCornerDetector(srcImageRange(img), destImage(beaudet), 1.0);
+
+        // one shared stage must reproduce all four detectors exactly,
+        // sequentially as well as with parallel strips
+        for(int threads = 1; threads <= 3; threads += 2)
+        {
+            Stage corners(srcImageRange(img), 1.0,
+                          vigra::ParallelOptions().numThreads(threads),
+                          Stage::Both);
+
+            Image tmp(img);
+            corners.cornerResponseFunction(destImage(tmp));
+            shouldEqualSequence(tmp.begin(), tmp.end(), harris.begin());
+            corners.foerstnerCornerDetector(destImage(tmp));
+            shouldEqualSequence(tmp.begin(), tmp.end(), foerstner.begin());
+            corners.rohrCornerDetector(destImage(tmp));
+            shouldEqualSequence(tmp.begin(), tmp.end(), rohr.begin());
+            corners.beaudetCornerDetector(destImage(tmp));
+            shouldEqualSequence(tmp.begin(), tmp.end(), beaudet.begin());
+        }
+
+        // likewise for the parallel overloads of the free functions
+        Image tmp(img);
+        cornerResponseFunction(srcImageRange(img), destImage(tmp), 1.0,
+                               vigra::ParallelOptions().numThreads(3));
+        shouldEqualSequence(tmp.begin(), tmp.end(), harris.begin());
+        beaudetCornerDetector(srcImageRange(img), destImage(tmp), 1.0,
+                              vigra::ParallelOptions().numThreads(3));
+        shouldEqualSequence(tmp.begin(), tmp.end(), beaudet.begin());
+    }
+
     void radialSymmetryTest()
     {
         Image tmp(img);
@@ -1880,6 +2264,23 @@ struct InterestOperatorTest
         }
     }
 
+    void radialSymmetryParallelTest()
+    {
+        Image ref(img), res(img), res2(img);
+
+        radialSymmetryTransform(srcImageRange(img), destImage(ref), 1.0);
+
+        // the strip-parallel variant must reproduce the plain function
+        // bit for bit, independent of the thread count
+        radialSymmetryTransform(srcImageRange(img), destImage(res), 1.0,
+                                ParallelOptions());
+        radialSymmetryTransform(srcImageRange(img), destImage(res2), 1.0,
+                                ParallelOptions().numThreads(3));
+
+        shouldEqualSequence(res.begin(), res.end(), ref.begin());
+        shouldEqualSequence(res2.begin(), res2.end(), ref.begin());
+    }
+
     Image img;
 };
 
@@ -2003,7 +2404,7 @@ struct NoiseNormalizationTest
   
     void testNonparametricNoiseNormalizationRGB()
     {
-        RGBImage res(rgb.size());        
+        RGBImage res(rgb.size());
         nonparametricNoiseNormalization(srcImageRange(rgb), destImage(res));
         for(unsigned int band = 0; band < 3; ++band)
         {
@@ -2011,6 +2412,45 @@ struct NoiseNormalizationTest
             checkVariance(res.upperLeft(), dband, 0.1);
         }
     }
+
+    void testSubsampledNoiseEstimation()
+    {
+        typedef vigra::ArrayVector<vigra::TinyVector<double, 2> > NoiseList;
+
+        NoiseList full, subsampled, parallel;
+        noiseVarianceEstimation(srcImageRange(image), full);
+        noiseVarianceEstimation(srcImageRange(image), subsampled,
+                                vigra::NoiseNormalizationOptions().subsampleFraction(0.25));
+        noiseVarianceEstimation(srcImageRange(image), parallel,
+                                vigra::NoiseNormalizationOptions().parallelOptions(
+                                                     vigra::ParallelOptions().numThreads(4)));
+
+        // multi-threaded estimation must reproduce the sequential result exactly
+        shouldEqual(parallel.size(), full.size());
+        for(unsigned int k = 0; k < full.size(); ++k)
+            shouldEqual(parallel[k], full[k]);
+
+        // subsampling must select about the requested fraction of the windows ...
+        should(4*subsampled.size() >= 3*full.size()/4 && 4*subsampled.size() <= 5*full.size()/4);
+
+        // ... and the estimates must be an ordered subset of the full estimates
+        unsigned int j = 0;
+        for(unsigned int k = 0; k < subsampled.size(); ++k)
+        {
+            while(j < full.size() && !(full[j] == subsampled[k]))
+                ++j;
+            shouldMsg(j < full.size(),
+                "testSubsampledNoiseEstimation(): subsampled estimate not found in full result.");
+            ++j;
+        }
+
+        // the clustering based on subsampled estimates must still be usable
+        NoiseList clusters;
+        noiseVarianceClustering(srcImageRange(image), clusters,
+                                vigra::NoiseNormalizationOptions().subsampleFraction(0.25)
+                                    .clusterCount(10));
+        should(clusters.size() >= 10);
+    }
 };
 
 #ifdef HasFFTW3
@@ -2156,7 +2596,23 @@ struct AffineRegistrationTest
 
         Matrix<double> estimated = identityMatrix<double>(3);
         estimateAffineTransform(srcImageRange(image), srcImageRange(timg), estimated);
-        
+
+        for(int i=0; i<9; ++i)
+            shouldEqualTolerance(m.data()[i] - estimated.data()[i], 0.0, 1e-6);
+    }
+
+    void testParallelRegistration()
+    {
+        Matrix<double> m = translationMatrix2D(Vector2(5.0, 10.0)) *
+                             rotationMatrix2DDegrees(5.0)* scalingMatrix2D(1.0, 0.9);
+        Image timg(image.size());
+        affineWarpImage(SplineImageView<2, double>(srcImageRange(image)), destImageRange(timg), m);
+
+        Matrix<double> estimated = identityMatrix<double>(3);
+        estimateAffineTransform(srcImageRange(image), srcImageRange(timg), estimated,
+                            AffineMotionEstimationOptions<>().parallelOptions(
+                                                 ParallelOptions().numThreads(4)));
+
         for(int i=0; i<9; ++i)
             shouldEqualTolerance(m.data()[i] - estimated.data()[i], 0.0, 1e-6);
     }
@@ -2168,6 +2624,8 @@ struct SimpleAnalysisTestSuite
     SimpleAnalysisTestSuite()
     : vigra::test_suite("SimpleAnalysisTestSuite")
     {
+        add( testCase( &LabelingTest::labelingParallelTest));
+        add( testCase( &LabelingTest::applyLabelLUTTest));
         add( testCase( &LabelingTest::labelingFourTest1));
         add( testCase( &LabelingTest::labelingFourTest2));
         add( testCase( &LabelingTest::labelingFourTest3));
@@ -2186,12 +2644,15 @@ struct SimpleAnalysisTestSuite
         add( testCase( &EdgeDetectionTest::cannyEdgelListTest));
         add( testCase( &EdgeDetectionTest::cannyEdgelList3x3Test));
         add( testCase( &EdgeDetectionTest::cannyEdgeImageTest));
+        add( testCase( &EdgeDetectionTest::cannyParallelTest));
         add( testCase( &EdgeDetectionTest::cannyEdgeImageWithThinningTest));
         add( testCase( &DistanceTransformTest::distanceTransformL1Test));
+        add( testCase( &DistanceTransformTest::chamferDistanceTransformTest));
         add( testCase( &DistanceTransformTest::distanceTransformL2Test));
         add( testCase( &DistanceTransformTest::distanceTransformLInfTest));
 
         add( testCase( &LocalMinMaxTest::localMinimumTest));
+        add( testCase( &LocalMinMaxTest::localMinimumParallelTest));
         add( testCase( &LocalMinMaxTest::localMinimum4Test));
         add( testCase( &LocalMinMaxTest::localMinimumTestThr));
         add( testCase( &LocalMinMaxTest::localMaximumTest));
@@ -2211,24 +2672,32 @@ struct SimpleAnalysisTestSuite
 
         add( testCase( &LocalMinMaxTest::plateauWithHolesTest));
         add( testCase( &WatershedsTest::watershedsTest));
+        add( testCase( &WatershedsTest::watershedsParallelTest));
+        add( testCase( &WatershedsTest::watershedsTurboUInt8Test));
         add( testCase( &WatershedsTest::watersheds4Test));
         add( testCase( &RegionGrowingTest::voronoiTest));
+        add( testCase( &RegionGrowingTest::voronoiParallelTest));
         add( testCase( &RegionGrowingTest::voronoiWithBorderTest));
+        add( testCase( &RegionGrowingTest::voronoiBucketQueueTest));
         add( testCase( &InterestOperatorTest::cornerResponseFunctionTest));
         add( testCase( &InterestOperatorTest::foerstnerCornerTest));
         add( testCase( &InterestOperatorTest::rohrCornerTest));
         add( testCase( &InterestOperatorTest::beaudetCornerTest));
+        add( testCase( &InterestOperatorTest::cornerDetectorStageTest));
         add( testCase( &InterestOperatorTest::radialSymmetryTest));
+        add( testCase( &InterestOperatorTest::radialSymmetryParallelTest));
         add( testCase( &NoiseNormalizationTest::testParametricNoiseNormalization));
         add( testCase( &NoiseNormalizationTest::testNonparametricNoiseNormalization));
         add( testCase( &NoiseNormalizationTest::testParametricNoiseNormalizationU8));
         add( testCase( &NoiseNormalizationTest::testNonparametricNoiseNormalizationU8));
         add( testCase( &NoiseNormalizationTest::testParametricNoiseNormalizationRGB));
         add( testCase( &NoiseNormalizationTest::testNonparametricNoiseNormalizationRGB));
+        add( testCase( &NoiseNormalizationTest::testSubsampledNoiseEstimation));
         add( testCase( &AffineRegistrationTest::testCorrespondingPoints));
         add( testCase( &AffineRegistrationTest::testTranslationRegistration));
         add( testCase( &AffineRegistrationTest::testSimilarityRegistration));
         add( testCase( &AffineRegistrationTest::testAffineRegistration));
+        add( testCase( &AffineRegistrationTest::testParallelRegistration));
 #ifdef HasFFTW3
         add( testCase( &SlantedEdgeMTFTest::testSlantedEdgeMTF));
 #endif // HasFFTW3
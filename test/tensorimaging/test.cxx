@@ -224,6 +224,25 @@ struct EdgeJunctionTensorTest
         shouldEqualSequenceTolerance(res.begin(), res.end(), ref.begin(), 1e-12);
     }
 
+    void boundaryTensorParallelTest()
+    {
+        V3Image ref(img2.size()), res(img2.size());
+
+        boundaryTensor(srcImageRange(img2), destImage(ref), 2.0);
+        boundaryTensor(srcImageRange(img2), destImage(res), 2.0,
+                       ParallelOptions().numThreads(3));
+
+        for(V3Image::iterator i = res.begin(), j = ref.begin(); i < res.end(); ++i, ++j)
+            shouldEqualSequenceTolerance(i->begin(), i->end(), j->begin(), 1e-12);
+
+        boundaryTensor1(srcImageRange(img2), destImage(ref), 2.0);
+        boundaryTensor1(srcImageRange(img2), destImage(res), 2.0,
+                        ParallelOptions().numThreads(3));
+
+        for(V3Image::iterator i = res.begin(), j = ref.begin(); i < res.end(); ++i, ++j)
+            shouldEqualSequenceTolerance(i->begin(), i->end(), j->begin(), 1e-12);
+    }
+
     void boundaryTensorTest3()
     {
         // does not produce the correct result
@@ -259,6 +278,47 @@ struct EdgeJunctionTensorTest
         shouldEqualSequenceTolerance(res.begin(), res.end(), ref.begin(), 1e-12);
     }
 
+    void hourglassTableTest()
+    {
+        V2Image gradient(img2.size());
+        V3Image tensor(img2.size()), ref(img2.size()), res(img2.size()), res2(img2.size());
+
+        gaussianGradient(srcImageRange(img2), destImage(gradient), 0.7);
+        vectorToTensor(srcImageRange(gradient), destImage(tensor));
+        hourGlassFilter(srcImageRange(tensor), destImage(ref), 2.8, 0.4);
+
+        HourGlassKernelTable table(2.8, 0.4);
+        hourGlassFilter(srcImageRange(tensor), destImage(res), table);
+        hourGlassFilter(srcImageRange(tensor), destImage(res2), table,
+                        ParallelOptions().numThreads(3));
+
+        double vmax = 0.0;
+        V3Image::iterator i = res.begin(), i2 = res2.begin(), j = ref.begin();
+        for(; j < ref.end(); ++j)
+            for(int c = 0; c < 3; ++c)
+                vmax = std::max(vmax, VIGRA_CSTD::fabs((*j)[c]));
+
+        for(j = ref.begin(); i < res.end(); ++i, ++i2, ++j)
+        {
+            for(int c = 0; c < 3; ++c)
+            {
+                // quantized orientations (180 bins == 1 degree)
+                should(VIGRA_CSTD::fabs((*i)[c] - (*j)[c]) < 1e-2 * vmax);
+                // the thread count must not influence the result
+                shouldEqual((*i2)[c], (*i)[c]);
+            }
+        }
+
+        // a constant orientation that falls exactly onto a bin center
+        // must reproduce the plain filter
+        initImage(destImageRange(tensor), V3Image::value_type(2.0, 0.0, 0.5));
+        hourGlassFilter(srcImageRange(tensor), destImage(ref), 2.8, 0.4);
+        hourGlassFilter(srcImageRange(tensor), destImage(res), table);
+
+        for(i = res.begin(), j = ref.begin(); i < res.end(); ++i, ++j)
+            shouldEqualSequence(i->begin(), i->end(), j->begin());
+    }
+
     void energyTensorTest()
     {
         using namespace functor;
@@ -277,11 +337,35 @@ struct EdgeJunctionTensorTest
         combineTwoImages(srcImageRange(res), srcImage(ref), destImage(res),
                          Arg1() - Arg2());
 
-        Image::iterator i = res.begin(), end = res.end();        
+        Image::iterator i = res.begin(), end = res.end();
         for(; i != end; ++i)
             shouldEqualTolerance(*i, 0.0, 1e-12);
     }
 
+    void energyTensorParallelTest()
+    {
+        V3Image ref(img2.size()), res(img2.size()), res2(img2.size());
+
+        Kernel1D<double> smooth, grad;
+        smooth.initGaussian(1.0);
+        grad.initGaussianDerivative(1.0, 1);
+        gradientEnergyTensor(srcImageRange(img2), destImage(ref), grad, smooth);
+
+        // the parallel variant must reproduce the plain function bit for bit,
+        // independent of the thread count
+        gradientEnergyTensor(srcImageRange(img2), destImage(res), grad, smooth,
+                             ParallelOptions());
+        gradientEnergyTensor(srcImageRange(img2), destImage(res2), grad, smooth,
+                             ParallelOptions().numThreads(3));
+
+        V3Image::iterator i = res.begin(), i2 = res2.begin(), j = ref.begin();
+        for(; i < res.end(); ++i, ++i2, ++j)
+        {
+            shouldEqualSequence(i->begin(), i->end(), j->begin());
+            shouldEqualSequence(i2->begin(), i2->end(), j->begin());
+        }
+    }
+
     Image img1, img2;
 };
 
@@ -305,8 +389,11 @@ struct TensorTestSuite
         add( testCase( &EdgeJunctionTensorTest::boundaryTensorTest0));
         add( testCase( &EdgeJunctionTensorTest::boundaryTensorTest1));
         add( testCase( &EdgeJunctionTensorTest::boundaryTensorTest2));
+        add( testCase( &EdgeJunctionTensorTest::boundaryTensorParallelTest));
         add( testCase( &EdgeJunctionTensorTest::hourglassTest));
+        add( testCase( &EdgeJunctionTensorTest::hourglassTableTest));
         add( testCase( &EdgeJunctionTensorTest::energyTensorTest));
+        add( testCase( &EdgeJunctionTensorTest::energyTensorParallelTest));
     }
 };
 
@@ -157,7 +157,50 @@ public:
         char hdf5group_3[] = "ZV";
         writeHDF5(hdf5File_2, hdf5group_2, fz);
         writeHDF5(hdf5File_2, hdf5group_3, zv);
-#endif    
+#endif
+    }
+
+    void testParallelDecomposition()
+    {
+        unsigned int numComponents = 3;
+        unsigned int numFeatures = 159;
+        unsigned int numSamples = 1024;
+
+        Matrix<double> features(numFeatures, numSamples, plsaData, ColumnMajor);
+
+        // multi-threaded PCA must reproduce the serial result exactly
+        {
+            Matrix<double> data(features),
+                           fz(Shape2(numFeatures, numComponents)),
+                           zv(Shape2(numComponents, numSamples)),
+                           fzRef(Shape2(numFeatures, numComponents)),
+                           zvRef(Shape2(numComponents, numSamples));
+
+            prepareRows(data, data, ZeroMean);
+
+            principleComponents(data, fzRef, zvRef);
+            principleComponents(data, fz, zv, ParallelOptions().numThreads(4));
+
+            shouldEqualSequence(fzRef.data(), fzRef.data()+fzRef.size(), fz.data());
+            shouldEqualSequence(zvRef.data(), zvRef.data()+zvRef.size(), zv.data());
+        }
+
+        // multi-threaded pLSA must reproduce the serial result exactly
+        // (when started from the same random initialization)
+        {
+            Matrix<double> fz(Shape2(numFeatures, numComponents)),
+                           zv(Shape2(numComponents, numSamples)),
+                           fzRef(Shape2(numFeatures, numComponents)),
+                           zvRef(Shape2(numComponents, numSamples));
+
+            RandomNumberGenerator<> serialRNG(42), parallelRNG(42);
+            pLSA(features, fzRef, zvRef, serialRNG, PLSAOptions());
+            pLSA(features, fz, zv, parallelRNG,
+                 PLSAOptions().parallelOptions(ParallelOptions().numThreads(4)));
+
+            shouldEqualSequence(fzRef.data(), fzRef.data()+fzRef.size(), fz.data());
+            shouldEqualSequence(zvRef.data(), zvRef.data()+zvRef.size(), zv.data());
+        }
     }
 };
 
@@ -170,6 +213,7 @@ struct UnsupervisedDecompositionTestSuite : public vigra::test_suite
     {
         add(testCase(&UnsupervisedDecompositionTest::testPCADecomposition));
         add(testCase(&UnsupervisedDecompositionTest::testPLSADecomposition));
+        add(testCase(&UnsupervisedDecompositionTest::testParallelDecomposition));
     }
 };
 
@@ -35,6 +35,7 @@
 
 #include <cstddef>
 #include <iostream>
+#include <stdexcept>
 #include <iterator>
 #include <algorithm>
 #include <queue>
@@ -43,7 +44,15 @@
 #include "vigra/array_vector.hxx"
 #include "vigra/copyimage.hxx"
 #include "vigra/sized_int.hxx"
+#include "vigra/basicimage.hxx"
 #include "vigra/bucket_queue.hxx"
+#include "vigra/union_find.hxx"
+#include "vigra/bit_array.hxx"
+#include "vigra/memory.hxx"
+#include "vigra/threadpool.hxx"
+#define VIGRA_INSTRUMENTATION    // enable the counters for the test below
+#include "vigra/instrumentation.hxx"
+#include <sstream>
 
 using namespace vigra;
 
@@ -369,7 +378,102 @@ struct BucketQueueTest
         }
         
         shouldEqual(0u, bqueue.size());
-        shouldEqual(true, bqueue.empty());        
+        shouldEqual(true, bqueue.empty());
+    }
+
+    void testPooledDescending()
+    {
+        BucketQueue<int> queue;
+        PooledBucketQueue<int> pqueue(256, idata.size());
+
+        shouldEqual(idata.size(), pqueue.capacity());
+
+        for(unsigned int k=0; k<idata.size(); ++k)
+        {
+            queue.push(idata[k], idata[k]);
+            pqueue.push(idata[k], idata[k]);
+        }
+
+        shouldEqual(idata.size(), pqueue.size());
+        shouldEqual(false, pqueue.empty());
+        shouldEqual(queue.maxIndex(), pqueue.maxIndex());
+        shouldEqual(idata.size(), pqueue.capacity()); // no growth
+
+        for(unsigned int k=0; k<idata.size(); ++k)
+        {
+            shouldEqual(queue.top(), pqueue.top());
+            shouldEqual(queue.topPriority(), pqueue.topPriority());
+            queue.pop();
+            pqueue.pop();
+        }
+
+        shouldEqual(0u, pqueue.size());
+        shouldEqual(true, pqueue.empty());
+
+        // popped slots must be recycled via the free list
+        for(unsigned int k=0; k<idata.size(); ++k)
+        {
+            pqueue.push(idata[k], idata[k]);
+            pqueue.pop();
+        }
+        shouldEqual(idata.size(), pqueue.capacity()); // still no growth
+    }
+
+    void testPooledAscending()
+    {
+        BucketQueue<int, true> queue;
+        PooledBucketQueue<int, true> pqueue; // default: empty arena, grows on demand
+
+        for(unsigned int k=0; k<idata.size(); ++k)
+        {
+            queue.push(idata[k], idata[k]);
+            pqueue.push(idata[k], idata[k]);
+        }
+
+        shouldEqual(idata.size(), pqueue.size());
+        shouldEqual(false, pqueue.empty());
+
+        for(unsigned int k=0; k<idata.size(); ++k)
+        {
+            shouldEqual(queue.top(), pqueue.top());
+            shouldEqual(queue.topPriority(), pqueue.topPriority());
+            queue.pop();
+            pqueue.pop();
+        }
+
+        shouldEqual(0u, pqueue.size());
+        shouldEqual(true, pqueue.empty());
+    }
+
+    void testPooledMapped()
+    {
+        Priority priority;
+        MappedBucketQueue<double, Priority> queue;
+        MappedBucketQueue<double, Priority, false,
+                          PooledBucketQueue<double> > pqueue;
+        pqueue.reserve(data.size());
+
+        for(unsigned int k=0; k<data.size(); ++k)
+        {
+            queue.push(data[k]);
+            pqueue.push(data[k]);
+        }
+
+        shouldEqual(data.size(), pqueue.size());
+        shouldEqual(data.size(), pqueue.capacity()); // no growth
+
+        // equal priorities must come out in FIFO order, like in the
+        // deque-based queue
+        for(unsigned int k=0; k<data.size(); ++k)
+        {
+            shouldEqual(queue.top(), pqueue.top());
+            shouldEqual(priority(queue.top()), (int)pqueue.topPriority());
+            queue.pop();
+            pqueue.pop();
+        }
+
+        shouldEqual(0u, pqueue.size());
+        shouldEqual(true, pqueue.empty());
     }
 };
 
@@ -388,6 +492,106 @@ struct SizedIntTest
     }
 };
 
+struct UnionFindTest
+{
+    void testRankedUnionFind()
+    {
+        using vigra::detail::RankedUnionFindArray;
+
+        RankedUnionFindArray<UInt32> uf(8);
+        shouldEqual(uf.size(), 8u);
+        for(UInt32 k = 0; k < 8; ++k)
+        {
+            should(uf.isRoot(k));
+            shouldEqual(uf.find(k), k);
+        }
+        shouldEqual(uf.makeNewLabel(), 8u);
+        shouldEqual(uf.size(), 9u);
+
+        // merge {0,1,2,3} and {5,6}, leave 4, 7, 8 as singletons
+        UInt32 r1 = uf.makeUnion(0, 1);
+        r1 = uf.makeUnion(r1, uf.makeUnion(2, 3));
+        UInt32 r2 = uf.makeUnion(6, 5);
+        shouldEqual(uf.find(3), r1);
+        shouldEqual(uf.find(0), uf.find(2));
+        shouldEqual(uf.find(5), r2);
+        should(uf.find(4) != uf.find(3));
+        shouldEqual(uf.makeUnion(r1, r1), r1);
+
+        shouldEqual(uf.makeContiguous(), 5u);
+        shouldEqual(uf[0], uf[1]);
+        shouldEqual(uf[1], uf[2]);
+        shouldEqual(uf[2], uf[3]);
+        shouldEqual(uf[5], uf[6]);
+        should(uf[4] != uf[0]);
+        should(uf[4] != uf[5]);
+        should(uf[7] != uf[8]);
+        for(UInt32 k = 0; k < 9; ++k)
+            should(uf[k] < 5);
+
+        // a long chain must stay contiguous under rank merging
+        RankedUnionFindArray<UInt32> chain(1000);
+        for(UInt32 k = 1; k < 1000; ++k)
+            chain.makeUnion(k-1, k);
+        UInt32 root = chain.find(0);
+        for(UInt32 k = 0; k < 1000; ++k)
+            shouldEqual(chain.find(k), root);
+        shouldEqual(chain.makeContiguous(), 1u);
+        shouldEqual(chain[999], 0u);
+    }
+
+    void testCompactingLUT()
+    {
+        using vigra::detail::UnionFindArray;
+        using vigra::detail::RankedUnionFindArray;
+
+        // the LUT must equal what makeContiguous() writes into the
+        // structure, but without freezing it
+        UnionFindArray<UInt32> uf(6);
+        uf.makeUnion(1, 3);
+        uf.makeUnion(4, 5);
+
+        ArrayVector<UInt32> lut;
+        unsigned int maxLabel = uf.buildCompactingLUT(lut);
+        shouldEqual(lut.size(), 6u);
+        shouldEqual(maxLabel, 3u);
+
+        UnionFindArray<UInt32> frozen(uf);
+        shouldEqual(frozen.makeContiguous(), maxLabel);
+        for(UInt32 k = 0; k < 6; ++k)
+            shouldEqual(lut[k], frozen[k]);
+
+        // the original still accepts merges
+        uf.makeUnion(0, 2);
+        shouldEqual(uf.buildCompactingLUT(lut), 2u);
+        shouldEqual(lut[2], 0u);
+        shouldEqual(lut[3], lut[1]);
+
+        // same for the ranked variant
+        RankedUnionFindArray<UInt32> ruf(8);
+        ruf.makeUnion(0, 1);
+        ruf.makeUnion(2, 3);
+        ruf.makeUnion(1, 3);
+        ruf.makeUnion(5, 6);
+
+        ArrayVector<UInt32> rlut;
+        shouldEqual(ruf.buildCompactingLUT(rlut), 4u);
+        shouldEqual(rlut.size(), 8u);
+        shouldEqual(rlut[0], rlut[1]);
+        shouldEqual(rlut[1], rlut[2]);
+        shouldEqual(rlut[2], rlut[3]);
+        shouldEqual(rlut[5], rlut[6]);
+        should(rlut[4] != rlut[0]);
+        should(rlut[7] != rlut[5]);
+        for(UInt32 k = 0; k < 8; ++k)
+            should(rlut[k] < 4);
+
+        ruf.makeUnion(4, 7);
+        shouldEqual(ruf.buildCompactingLUT(rlut), 3u);
+        shouldEqual(rlut[4], rlut[7]);
+    }
+};
+
 struct MetaprogrammingTest
 {
     struct TrueResult {};
@@ -460,6 +664,538 @@ struct MetaprogrammingTest
     }
 };
 
+struct MemoryArenaTest
+{
+    void testArena()
+    {
+        vigra::MemoryArena arena(1024);
+        shouldEqual(arena.capacity(), (std::size_t)0);
+
+        void * p1 = arena.allocate(100);
+        void * p2 = arena.allocate(1);
+        void * p3 = arena.allocate(3000);   // exceeds the chunk => new chunk
+
+        // all addresses are 64-byte aligned, allocation is by pointer bumping
+        shouldEqual((std::size_t)p1 % vigra::MemoryArena::alignment, (std::size_t)0);
+        shouldEqual((std::size_t)p2 % vigra::MemoryArena::alignment, (std::size_t)0);
+        shouldEqual((std::size_t)p3 % vigra::MemoryArena::alignment, (std::size_t)0);
+        shouldEqual((char *)p2 - (char *)p1, (std::ptrdiff_t)128);
+        shouldEqual(arena.outstandingAllocations(), (std::size_t)3);
+
+        std::size_t capacity = arena.capacity();
+        should(capacity >= 4024);
+
+        // stack-like deallocation releases the block immediately
+        arena.deallocate(p3, 3000);
+        void * p4 = arena.allocate(3000);
+        shouldEqual(p3, p4);
+
+        // when the last block is returned, the arena rewinds,
+        // but keeps its chunks
+        arena.deallocate(p4, 3000);
+        arena.deallocate(p1, 100);          // out-of-order is allowed
+        arena.deallocate(p2, 1);
+        shouldEqual(arena.outstandingAllocations(), (std::size_t)0);
+        shouldEqual(arena.capacity(), capacity);
+
+        // steady state: an identical allocation pattern is served from
+        // the existing chunks and yields the same addresses
+        void * q1 = arena.allocate(100);
+        void * q2 = arena.allocate(1);
+        void * q3 = arena.allocate(3000);
+        shouldEqual(q1, p1);
+        shouldEqual(q2, p2);
+        shouldEqual(q3, p3);
+        shouldEqual(arena.capacity(), capacity);
+
+        arena.deallocate(q3, 3000);
+        arena.deallocate(q2, 1);
+        arena.deallocate(q1, 100);
+        arena.reset();
+        shouldEqual(arena.capacity(), capacity);
+
+        try
+        {
+            arena.deallocate(q1, 100);
+            failTest("no exception thrown");
+        }
+        catch(vigra::ContractViolation &) {}
+    }
+
+    void testAllocator()
+    {
+        // without an arena, the allocator falls back to aligned heap memory
+        vigra::ArenaAllocator<double> heap;
+        double * p = heap.allocate(10);
+        shouldEqual((std::size_t)p % vigra::MemoryArena::alignment, (std::size_t)0);
+        heap.deallocate(p, 10);
+
+        vigra::MemoryArena arena;
+        vigra::ArenaAllocator<double> alloc(arena);
+        should(alloc != heap);
+        should(alloc == vigra::ArenaAllocator<int>(arena));
+
+        {
+            vigra::ArrayVector<double, vigra::ArenaAllocator<double> > v(100, alloc);
+            shouldEqual((std::size_t)v.begin() % vigra::MemoryArena::alignment, (std::size_t)0);
+            should(arena.outstandingAllocations() > 0);
+        }
+        shouldEqual(arena.outstandingAllocations(), (std::size_t)0);
+
+        // repeated identical "frames" are served without heap allocation
+        std::size_t capacity = arena.capacity();
+        for(int k = 0; k < 10; ++k)
+        {
+            vigra::ArrayVector<double, vigra::ArenaAllocator<double> > a(1000, alloc),
+                                                                       b(500, alloc);
+            shouldEqual((std::size_t)a.begin() % vigra::MemoryArena::alignment, (std::size_t)0);
+            shouldEqual((std::size_t)b.begin() % vigra::MemoryArena::alignment, (std::size_t)0);
+            shouldEqual(arena.capacity(), capacity);
+        }
+        shouldEqual(arena.outstandingAllocations(), (std::size_t)0);
+    }
+};
+
+struct MemoryPoolTest
+{
+    void testPool()
+    {
+        vigra::MemoryPool pool;
+        shouldEqual(pool.cachedBytes(), (std::size_t)0);
+
+        void * p1 = pool.allocate(1000);
+        void * p2 = pool.allocate(1000);
+        void * p3 = pool.allocate(64);
+        shouldEqual((std::size_t)p1 % vigra::MemoryArena::alignment, (std::size_t)0);
+        shouldEqual(pool.outstandingAllocations(), (std::size_t)3);
+
+        // returned blocks are cached and reused for equal sizes,
+        // in arbitrary order
+        pool.deallocate(p2, 1000);
+        pool.deallocate(p1, 1000);
+        shouldEqual(pool.cachedBytes(), (std::size_t)2000);
+        void * q1 = pool.allocate(1000);
+        void * q2 = pool.allocate(1000);
+        shouldEqual(q1, p1);
+        shouldEqual(q2, p2);
+        shouldEqual(pool.cachedBytes(), (std::size_t)0);
+
+        // a different size does not touch the cache
+        pool.deallocate(p3, 64);
+        void * p4 = pool.allocate(128);
+        should(p4 != p3);
+        shouldEqual(pool.cachedBytes(), (std::size_t)64);
+
+        pool.deallocate(q1, 1000);
+        pool.deallocate(q2, 1000);
+        pool.deallocate(p4, 128);
+        shouldEqual(pool.outstandingAllocations(), (std::size_t)0);
+
+        pool.releaseUnusedMemory();
+        shouldEqual(pool.cachedBytes(), (std::size_t)0);
+
+        try
+        {
+            pool.deallocate(p1, 1000);
+            failTest("no exception thrown");
+        }
+        catch(vigra::ContractViolation &) {}
+    }
+
+    void testImageReuse()
+    {
+        typedef vigra::PoolAllocator<float> Allocator;
+        typedef vigra::BasicImage<float, Allocator> Image;
+
+        vigra::MemoryPool pool;
+        Allocator alloc(pool);
+
+        float * frameData = 0;
+        std::size_t capacity = 0;
+        for(int frame = 0; frame < 10; ++frame)
+        {
+            // after the first frame, every frame starts with the same
+            // set of cached buffers -- nothing is allocated any more
+            if(frame == 1)
+                capacity = pool.cachedBytes();
+            else if(frame > 1)
+                shouldEqual(pool.cachedBytes(), capacity);
+
+            Image tmp1(160, 120, alloc), tmp2(160, 120, alloc);
+            tmp1(0, 0) = (float)frame;
+            vigra::copyImage(srcImageRange(tmp1), destImage(tmp2));
+            shouldEqual(tmp2(0, 0), (float)frame);
+            if(frame == 0)
+                frameData = &tmp1(0, 0);
+            else
+                shouldEqual(&tmp1(0, 0), frameData);    // buffer is recycled
+
+            // resize to a recurring size is also served from the pool
+            tmp2.resize(80, 60);
+            tmp2.resize(160, 120);
+        }
+        shouldEqual(pool.outstandingAllocations(), (std::size_t)0);
+        should(pool.cachedBytes() >= capacity);
+    }
+};
+
+struct SmallVectorTest
+{
+    typedef vigra::SmallVector<int, 4> Vector;
+
+    void testInlineBuffer()
+    {
+        Vector v;
+        should(v.usesInlineBuffer());
+        shouldEqual(v.size(), (Vector::size_type)0);
+        shouldEqual(v.capacity(), (Vector::size_type)4);
+
+        // filling up to the inline capacity does not allocate
+        for(int k = 0; k < 4; ++k)
+            v.push_back(k);
+        should(v.usesInlineBuffer());
+        shouldEqual(v.size(), (Vector::size_type)4);
+        for(int k = 0; k < 4; ++k)
+            shouldEqual(v[k], k);
+
+        // exceeding the inline capacity spills to the heap,
+        // the capacity grows geometrically
+        v.push_back(4);
+        should(!v.usesInlineBuffer());
+        shouldEqual(v.capacity(), (Vector::size_type)8);
+        for(int k = 0; k < 5; ++k)
+            shouldEqual(v[k], k);
+
+        // shrinking does not move the data back
+        v.resize(2);
+        should(!v.usesInlineBuffer());
+        shouldEqual(v.size(), (Vector::size_type)2);
+
+        Vector w(3, 5);
+        should(w.usesInlineBuffer());
+        shouldEqual(w.size(), (Vector::size_type)3);
+        shouldEqual(w[2], 5);
+
+        Vector x(10);
+        should(!x.usesInlineBuffer());
+        shouldEqual(x.size(), (Vector::size_type)10);
+        shouldEqual(x[9], 0);
+    }
+
+    void testCopyAndAssignment()
+    {
+        Vector v;
+        for(int k = 0; k < 7; ++k)
+            v.push_back(k);
+
+        Vector inl(v);                    // too large for the inline buffer
+        should(!inl.usesInlineBuffer());
+        should(inl == v);
+
+        v.resize(3);
+        Vector small(v);
+        should(small.usesInlineBuffer());
+        should(small == v);
+
+        Vector w;
+        w = v;
+        should(w.usesInlineBuffer());
+        should(w == v);
+        w = inl;
+        should(w == inl);
+
+        // conversion from an ArrayVectorView
+        vigra::ArrayVector<int> av(5, 9);
+        Vector y(static_cast<vigra::ArrayVectorView<int> const &>(av));
+        shouldEqual(y.size(), (Vector::size_type)5);
+        shouldEqual(y[4], 9);
+
+        // swap copies when one of the vectors is inline
+        Vector a(2, 1), b(7, 2);
+        a.swap(b);
+        shouldEqual(a.size(), (Vector::size_type)7);
+        shouldEqual(a[0], 2);
+        shouldEqual(b.size(), (Vector::size_type)2);
+        shouldEqual(b[0], 1);
+    }
+
+    void testNonPOD()
+    {
+        vigra::SmallVector<std::string, 2> v;
+        v.push_back("a");
+        v.push_back("b");
+        should(v.usesInlineBuffer());
+        v.push_back("c");
+        should(!v.usesInlineBuffer());
+        shouldEqual(v[0], "a");
+        shouldEqual(v[2], "c");
+        v.pop_back();
+        v.clear();
+        shouldEqual(v.size(), (Vector::size_type)0);
+    }
+};
+
+struct BitArrayTest
+{
+    typedef vigra::BitArray<70> Array;   // spans three 32 bit words
+
+    void testCount()
+    {
+        Array x;
+        shouldEqual(x.count(), 0u);
+
+        unsigned positions[] = { 0, 3, 31, 32, 64, 69 };
+        for(unsigned k = 0; k < 6; ++k)
+            x.set(positions[k]);
+        shouldEqual(x.count(), 6u);
+
+        x.flip();
+        shouldEqual(x.count(), 64u);     // bits beyond size 70 stay clear
+
+        x.set();
+        shouldEqual(x.count(), 70u);
+    }
+
+    void testSetDifference()
+    {
+        Array x, y;
+        x.set(1);
+        x.set(33);
+        x.set(65);
+        y.set(33);
+        y.set(40);
+
+        Array d = x - y;
+        shouldEqual(d.count(), 2u);
+        should(d.test(1) && d.test(65) && !d.test(33) && !d.test(40));
+
+        x -= y;
+        should(x == d);
+    }
+
+    void testFindNextSet()
+    {
+        Array x;
+        shouldEqual(x.findNextSet(), 70u);   // empty mask
+
+        unsigned positions[] = { 0, 3, 31, 32, 64, 69 };
+        for(unsigned k = 0; k < 6; ++k)
+            x.set(positions[k]);
+
+        // scanning visits exactly the set bits, in order
+        unsigned k = 0;
+        for(unsigned i = x.findNextSet(); i < 70; i = x.findNextSet(i + 1), ++k)
+            shouldEqual(i, positions[k]);
+        shouldEqual(k, 6u);
+
+        shouldEqual(x.findNextSet(65), 69u);
+        shouldEqual(x.findNextSet(70), 70u);
+        shouldEqual(x.findNextSet(1000), 70u);
+    }
+};
+
+struct InstrumentationTest
+{
+    void testRegistry()
+    {
+        vigra::resetInstrumentation();
+        shouldEqual(vigra::instrumentationStats("never_ran").passes, (std::size_t)0);
+
+        {
+            VIGRA_INSTRUMENT_SCOPE("outer")
+            VIGRA_INSTRUMENT_ALLOCATION(100)
+            VIGRA_INSTRUMENT_PASS(1000)
+            {
+                // events in a nested scope are attributed to both scopes
+                VIGRA_INSTRUMENT_SCOPE("inner")
+                VIGRA_INSTRUMENT_PASS(500)
+            }
+        }
+
+        vigra::InstrumentationStats outer = vigra::instrumentationStats("outer");
+        shouldEqual(outer.allocations, (std::size_t)1);
+        shouldEqual(outer.allocatedBytes, (std::size_t)100);
+        shouldEqual(outer.passes, (std::size_t)2);
+        shouldEqual(outer.bytesMoved, (std::size_t)1500);
+
+        vigra::InstrumentationStats inner = vigra::instrumentationStats("inner");
+        shouldEqual(inner.allocations, (std::size_t)0);
+        shouldEqual(inner.passes, (std::size_t)1);
+        shouldEqual(inner.bytesMoved, (std::size_t)500);
+
+        // events outside any scope are dropped
+        VIGRA_INSTRUMENT_PASS(1)
+        shouldEqual(vigra::InstrumentationRegistry::instance().statsMap().size(),
+                    (std::size_t)2);
+
+        std::ostringstream report;
+        vigra::printInstrumentationReport(report);
+        should(report.str().find("outer,1,100,2,1500") != std::string::npos);
+
+        vigra::resetInstrumentation();
+        shouldEqual(vigra::instrumentationStats("outer").passes, (std::size_t)0);
+    }
+};
+
+struct ThreadPoolTest
+{
+    struct CountVisits
+    {
+        std::vector<int> * visits;
+
+        void operator()(int threadIndex, std::ptrdiff_t i) const
+        {
+            should(threadIndex >= 0);
+            ++(*visits)[(std::size_t)i];
+        }
+    };
+
+    struct CountElementVisits
+    {
+        std::vector<int> * visits;
+
+        void operator()(int, int element) const
+        {
+            ++(*visits)[(std::size_t)element];
+        }
+    };
+
+    struct CountBlockVisits
+    {
+        typedef vigra::TinyVector<std::ptrdiff_t, 2> Shape;
+
+        std::vector<int> * visits;
+        Shape shape;
+
+        void operator()(int, Shape const & start, Shape const & stop) const
+        {
+            should(start[0] >= 0 && start[1] >= 0);
+            should(stop[0] <= shape[0] && stop[1] <= shape[1]);
+            should(start[0] < stop[0] && start[1] < stop[1]);
+            for(std::ptrdiff_t y = start[1]; y < stop[1]; ++y)
+                for(std::ptrdiff_t x = start[0]; x < stop[0]; ++x)
+                    ++(*visits)[(std::size_t)(y * shape[0] + x)];
+        }
+    };
+
+    struct FailAtSeven
+    {
+        void operator()(int, std::ptrdiff_t i) const
+        {
+            if(i == 7)
+                throw std::runtime_error("seven is not allowed");
+        }
+    };
+
+    static bool allOnes(std::vector<int> const & visits)
+    {
+        for(std::size_t k = 0; k < visits.size(); ++k)
+            if(visits[k] != 1)
+                return false;
+        return true;
+    }
+
+    void testForeach()
+    {
+        // every index is visited exactly once, regardless of the
+        // thread count and granularity
+        std::vector<int> visits(1000, 0);
+        CountVisits f = { &visits };
+        vigra::parallel_foreach(1000, f);
+        should(allOnes(visits));
+
+        std::fill(visits.begin(), visits.end(), 0);
+        vigra::parallel_foreach(1000, f,
+                  vigra::ParallelOptions().numThreads(3).blockSize(7));
+        should(allOnes(visits));
+
+        // more threads than work items
+        std::fill(visits.begin(), visits.end(), 0);
+        vigra::parallel_foreach(5, f,
+                  vigra::ParallelOptions().numThreads(16));
+        for(int k = 0; k < 5; ++k)
+            shouldEqual(visits[k], 1);
+
+        vigra::parallel_foreach(0, f);   // empty range is a no-op
+
+        // iterator range version
+        std::vector<int> elements(100);
+        for(int k = 0; k < 100; ++k)
+            elements[k] = 99 - k;
+        std::fill(visits.begin(), visits.end(), 0);
+        CountElementVisits g = { &visits };
+        vigra::parallel_foreach(elements.begin(), elements.end(), g);
+        for(int k = 0; k < 100; ++k)
+            shouldEqual(visits[k], 1);
+    }
+
+    void testForeachBlock()
+    {
+        typedef vigra::TinyVector<std::ptrdiff_t, 2> Shape;
+
+        // the blocks must tile the shape exactly, including the
+        // clipped blocks at the upper border (50 % 8 != 0)
+        Shape shape(50, 30);
+        std::vector<int> visits((std::size_t)(shape[0] * shape[1]), 0);
+        CountBlockVisits f = { &visits, shape };
+        vigra::parallel_foreach_block(shape, Shape(8, 8), f,
+                  vigra::ParallelOptions().numThreads(2));
+        should(allOnes(visits));
+
+        // a single block covering everything
+        std::fill(visits.begin(), visits.end(), 0);
+        vigra::parallel_foreach_block(shape, Shape(64, 64), f);
+        should(allOnes(visits));
+
+        try
+        {
+            vigra::parallel_foreach_block(shape, Shape(8, 0), f);
+            failTest("no exception thrown");
+        }
+        catch(vigra::ContractViolation &) {}
+    }
+
+    void testExceptionPropagation()
+    {
+        try
+        {
+            vigra::parallel_foreach(20, FailAtSeven(),
+                      vigra::ParallelOptions().numThreads(4));
+            failTest("no exception thrown");
+        }
+        catch(std::runtime_error & e)
+        {
+            std::string message(e.what());
+            should(message.find("seven is not allowed") != std::string::npos);
+        }
+    }
+
+    void testGlobalPool()
+    {
+        shouldEqual(vigra::globalNumThreads(),
+                    vigra::ParallelOptions::maxThreads());
+
+        // the global setting becomes the default for Auto everywhere
+        vigra::setGlobalNumThreads(1);
+        shouldEqual(vigra::globalNumThreads(), 1);
+        shouldEqual(vigra::ParallelOptions().getNumThreads(), 1);
+
+        // explicit requests still win
+        shouldEqual(vigra::ParallelOptions().numThreads(3).getNumThreads(), 3);
+
+        vigra::setGlobalNumThreads(vigra::ParallelOptions::Auto);
+        shouldEqual(vigra::globalNumThreads(),
+                    vigra::ParallelOptions::maxThreads());
+
+        vigra::ThreadPool pool(2);
+        shouldEqual(pool.numThreads(), 2);
+        std::vector<int> visits(100, 0);
+        CountVisits f = { &visits };
+        pool.foreach(100, f);
+        should(allOnes(visits));
+    }
+};
+
 void stringTest()
 {
     std::string s;
@@ -487,10 +1223,30 @@ struct UtilitiesTestSuite
         add( testCase( &BucketQueueTest::testAscending));
         add( testCase( &BucketQueueTest::testDescendingMapped));
         add( testCase( &BucketQueueTest::testAscendingMapped));
+        add( testCase( &BucketQueueTest::testPooledDescending));
+        add( testCase( &BucketQueueTest::testPooledAscending));
+        add( testCase( &BucketQueueTest::testPooledMapped));
         add( testCase( &SizedIntTest::testSizedInt));
+        add( testCase( &UnionFindTest::testRankedUnionFind));
+        add( testCase( &UnionFindTest::testCompactingLUT));
         add( testCase( &MetaprogrammingTest::testInt));
         add( testCase( &MetaprogrammingTest::testLogic));
         add( testCase( &MetaprogrammingTest::testTypeTools));
+        add( testCase( &MemoryArenaTest::testArena));
+        add( testCase( &MemoryArenaTest::testAllocator));
+        add( testCase( &MemoryPoolTest::testPool));
+        add( testCase( &MemoryPoolTest::testImageReuse));
+        add( testCase( &SmallVectorTest::testInlineBuffer));
+        add( testCase( &SmallVectorTest::testCopyAndAssignment));
+        add( testCase( &SmallVectorTest::testNonPOD));
+        add( testCase( &ThreadPoolTest::testForeach));
+        add( testCase( &ThreadPoolTest::testForeachBlock));
+        add( testCase( &ThreadPoolTest::testExceptionPropagation));
+        add( testCase( &ThreadPoolTest::testGlobalPool));
+        add( testCase( &InstrumentationTest::testRegistry));
+        add( testCase( &BitArrayTest::testCount));
+        add( testCase( &BitArrayTest::testSetDifference));
+        add( testCase( &BitArrayTest::testFindNextSet));
         add( testCase( &stringTest));
     }
 };
@@ -383,6 +383,111 @@ struct VolumeLabelingTest
 
     }
 
+    struct InMemoryVolumeSource
+    {
+        typedef double value_type;
+        typedef double label_type;
+
+        DoubleVolume & src_;
+        DoubleVolume & labels_;
+
+        InMemoryVolumeSource(DoubleVolume & src, DoubleVolume & labels)
+        : src_(src), labels_(labels)
+        {}
+
+        DoubleVolume::difference_type shape() const
+        {
+            return src_.shape();
+        }
+
+        void read(DoubleVolume::difference_type const & offset,
+                  MultiArray<3, double> & block) const
+        {
+            block = src_.subarray(offset, offset + block.shape());
+        }
+
+        void readLabels(DoubleVolume::difference_type const & offset,
+                        MultiArray<3, double> & block) const
+        {
+            block = labels_.subarray(offset, offset + block.shape());
+        }
+
+        void writeLabels(DoubleVolume::difference_type const & offset,
+                         MultiArray<3, double> const & block)
+        {
+            labels_.subarray(offset, offset + block.shape()) = block;
+        }
+    };
+
+    void labelingBlockwiseTest()
+    {
+        typedef DoubleVolume::difference_type Shape;
+
+        int w = 13, h = 11, d = 17;
+        DoubleVolume vol(Shape(w, h, d));
+        for(int z = 0; z < d; ++z)
+            for(int y = 0; y < h; ++y)
+                for(int x = 0; x < w; ++x)
+                    vol(x, y, z) = ((x*x + 3*y + 2*z + x*y / 5) / 4) % 2;
+
+        DoubleVolume expected(vol.shape()), blockLabels(vol.shape());
+        InMemoryVolumeSource source(vol, blockLabels);
+
+        unsigned int expectedCount =
+            labelVolume(srcMultiArrayRange(vol), destMultiArray(expected), NeighborCode3DSix());
+        shouldEqual(labelVolumeBlockwise(source, 4, NeighborCode3DSix()), expectedCount);
+        shouldEqualSequence(blockLabels.begin(), blockLabels.end(), expected.begin());
+
+        expectedCount =
+            labelVolume(srcMultiArrayRange(vol), destMultiArray(expected), NeighborCode3DTwentySix());
+        shouldEqual(labelVolumeBlockwise(source, 5, NeighborCode3DTwentySix()), expectedCount);
+        shouldEqualSequence(blockLabels.begin(), blockLabels.end(), expected.begin());
+    }
+
+    void applyLabelLUTTest()
+    {
+        typedef IntVolume::difference_type Shape;
+
+        int w = 13, h = 11, d = 17;
+        IntVolume vol(Shape(w, h, d));
+        for(int z = 0; z < d; ++z)
+            for(int y = 0; y < h; ++y)
+                for(int x = 0; x < w; ++x)
+                    vol(x, y, z) = ((x*x + 3*y + 2*z + x*y / 5) / 4) % 2;
+
+        IntVolume labels(vol.shape());
+        unsigned int count =
+            labelVolume(srcMultiArrayRange(vol), destMultiArray(labels), NeighborCode3DSix());
+        should(count > 4);
+
+        // merge some of the regions and build a compacting LUT
+        vigra::detail::UnionFindArray<int> uf((int)count + 1);
+        for(int k = 2; k + 1 <= (int)count; k += 3)
+            uf.makeUnion(k, k + 1);
+        ArrayVector<int> lut;
+        uf.buildCompactingLUT(lut);
+        shouldEqual(lut.size(), (std::size_t)count + 1);
+
+        IntVolume expected(vol.shape());
+        for(int z = 0; z < d; ++z)
+            for(int y = 0; y < h; ++y)
+                for(int x = 0; x < w; ++x)
+                    expected(x, y, z) = lut[(std::size_t)labels(x, y, z)];
+
+        IntVolume res(vol.shape());
+        applyLabelLUT(srcMultiArrayRange(labels), destMultiArray(res), lut);
+        shouldEqualSequence(res.begin(), res.end(), expected.begin());
+
+        res.init(0);
+        applyLabelLUT(srcMultiArrayRange(labels), destMultiArray(res), lut,
+                      ParallelOptions().numThreads(3));
+        shouldEqualSequence(res.begin(), res.end(), expected.begin());
+
+        // relabeling in-place is allowed
+        applyLabelLUT(srcMultiArrayRange(labels), destMultiArray(labels), lut);
+        shouldEqualSequence(labels.begin(), labels.end(), expected.begin());
+    }
+
     IntVolume vol1, vol2, vol3;
     DoubleVolume vol4, vol5, vol6;
 };
@@ -405,6 +510,8 @@ struct VolumeLabelingTestSuite
         add( testCase( &VolumeLabelingTest::labelingTwentySixTest3));
         add( testCase( &VolumeLabelingTest::labelingTwentySixWithBackgroundTest1));
         add( testCase( &VolumeLabelingTest::labelingAllTest));
+        add( testCase( &VolumeLabelingTest::labelingBlockwiseTest));
+        add( testCase( &VolumeLabelingTest::applyLabelLUTTest));
     }
 };
 
@@ -2300,6 +2300,164 @@ struct RestrictedNeighborhoodCirculator3dTest
     }
 };
 
+struct NeighborOffsetTableTest
+{
+    enum { w=7, h=5, d=4 };
+
+    template <class NeighborCode>
+    void check2DTable()
+    {
+        vigra::NeighborOffsetTable<NeighborCode> table(w);
+        shouldEqual((int)table.size(), (int)NeighborCode::DirectionCount);
+        for(int k = 0; k < (int)NeighborCode::DirectionCount; ++k)
+        {
+            shouldEqual(table[k], NeighborCode::dX(k) + w*NeighborCode::dY(k));
+            shouldEqual(table[static_cast<typename NeighborCode::Direction>(k)], table[k]);
+            shouldEqual(table.oppositeOffset(static_cast<typename NeighborCode::Direction>(k)),
+                        -table[k]);
+        }
+
+        // the border variant must agree with the border tables of the code
+        for(int y = 0; y < h; ++y)
+        {
+            for(int x = 0; x < w; ++x)
+            {
+                vigra::AtImageBorder atBorder = vigra::isAtImageBorder(x, y, w, h);
+                shouldEqual(table.borderDirectionCount(atBorder),
+                            (int)NeighborCode::nearBorderDirectionCount(atBorder));
+                for(int j = 0; j < table.borderDirectionCount(atBorder); ++j)
+                {
+                    typename NeighborCode::Direction dir = table.borderDirection(atBorder, j);
+                    shouldEqual(dir, NeighborCode::nearBorderDirections(atBorder, j));
+                    shouldEqual(table.borderOffset(atBorder, j), table[dir]);
+
+                    // the offset must stay inside the image
+                    int flat = x + w*y + (int)table.borderOffset(atBorder, j);
+                    should(0 <= flat && flat < w*h);
+                }
+            }
+        }
+    }
+
+    template <class NeighborCode>
+    void check3DTable()
+    {
+        vigra::NeighborOffsetTable<NeighborCode> table(w, w*h);
+        shouldEqual((int)table.size(), (int)NeighborCode::DirectionCount);
+        for(int k = 0; k < (int)NeighborCode::DirectionCount; ++k)
+        {
+            shouldEqual(table[k],
+                        NeighborCode::dX(k) + w*NeighborCode::dY(k) + w*h*NeighborCode::dZ(k));
+            shouldEqual(table.oppositeOffset(static_cast<typename NeighborCode::Direction>(k)),
+                        -table[k]);
+        }
+
+        for(int z = 0; z < d; ++z)
+        {
+            for(int y = 0; y < h; ++y)
+            {
+                for(int x = 0; x < w; ++x)
+                {
+                    vigra::AtVolumeBorder atBorder = vigra::isAtVolumeBorder(x, y, z, w, h, d);
+                    shouldEqual(table.borderDirectionCount(atBorder),
+                                (int)NeighborCode::nearBorderDirectionCount(atBorder));
+                    for(int j = 0; j < table.borderDirectionCount(atBorder); ++j)
+                    {
+                        typename NeighborCode::Direction dir = table.borderDirection(atBorder, j);
+                        shouldEqual(dir, NeighborCode::nearBorderDirections(atBorder, j));
+                        shouldEqual(table.borderOffset(atBorder, j), table[dir]);
+
+                        int flat = x + w*y + w*h*z + (int)table.borderOffset(atBorder, j);
+                        should(0 <= flat && flat < w*h*d);
+                    }
+                }
+            }
+        }
+    }
+
+    void testFourNeighborCode()
+    {
+        check2DTable<vigra::FourNeighborCode>();
+    }
+
+    void testEightNeighborCode()
+    {
+        check2DTable<vigra::EightNeighborCode>();
+    }
+
+    void testNeighborCode3DSix()
+    {
+        check3DTable<vigra::NeighborCode3DSix>();
+    }
+
+    void testNeighborCode3DTwentySix()
+    {
+        check3DTable<vigra::NeighborCode3DTwentySix>();
+    }
+
+    void testFlatScan()
+    {
+        // compare an offset-table based neighbor scan with the circulator
+        typedef vigra::MultiArray<3,int> IntVolume;
+        IntVolume vol(IntVolume::difference_type(w, h, d));
+        for(int k = 0; k < (int)vol.size(); ++k)
+            vol[k] = (k*31) % 17;
+
+        vigra::NeighborOffsetTable<vigra::NeighborCode3DTwentySix> table(w, w*h);
+        int const * data = vol.data();
+
+        for(int z = 0; z < d; ++z)
+        {
+            for(int y = 0; y < h; ++y)
+            {
+                for(int x = 0; x < w; ++x)
+                {
+                    int sumTable = 0;
+                    int const * p = data + x + w*y + w*h*z;
+                    vigra::AtVolumeBorder atBorder = vigra::isAtVolumeBorder(x, y, z, w, h, d);
+                    if(atBorder == vigra::NotAtBorder)
+                    {
+                        for(int k = 0; k < (int)table.size(); ++k)
+                            sumTable += p[table[k]];
+                    }
+                    else
+                    {
+                        for(int j = 0; j < table.borderDirectionCount(atBorder); ++j)
+                            sumTable += p[table.borderOffset(atBorder, j)];
+                    }
+
+                    int sumCirc = 0;
+                    IntVolume::traverser center = vol.traverser_begin();
+                    center.dim0() += x;
+                    center.dim1() += y;
+                    center.dim2() += z;
+                    if(atBorder == vigra::NotAtBorder)
+                    {
+                        vigra::NeighborhoodCirculator<IntVolume::traverser, vigra::NeighborCode3DTwentySix>
+                            c(center), cend(c);
+                        do
+                        {
+                            sumCirc += *c;
+                        }
+                        while(++c != cend);
+                    }
+                    else
+                    {
+                        vigra::RestrictedNeighborhoodCirculator<IntVolume::traverser, vigra::NeighborCode3DTwentySix>
+                            c(center, atBorder), cend(c);
+                        do
+                        {
+                            sumCirc += *c;
+                        }
+                        while(++c != cend);
+                    }
+                    shouldEqual(sumTable, sumCirc);
+                }
+            }
+        }
+    }
+};
+
 struct NeighborhoodCirculator3dTestSuite
 : public vigra::test_suite
 {
@@ -2320,6 +2478,12 @@ struct NeighborhoodCirculator3dTestSuite
         add( testCase( &RestrictedNeighborhoodCirculator3dTest::testInit));
         add( testCase( &RestrictedNeighborhoodCirculator3dTest::testBordersSix));
         add( testCase( &RestrictedNeighborhoodCirculator3dTest::testBordersTwentySix));
+
+        add( testCase( &NeighborOffsetTableTest::testFourNeighborCode));
+        add( testCase( &NeighborOffsetTableTest::testEightNeighborCode));
+        add( testCase( &NeighborOffsetTableTest::testNeighborCode3DSix));
+        add( testCase( &NeighborOffsetTableTest::testNeighborCode3DTwentySix));
+        add( testCase( &NeighborOffsetTableTest::testFlatScan));
     }
 };
 
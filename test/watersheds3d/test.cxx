@@ -456,6 +456,54 @@ struct Watersheds3dTest
         }
     }
 
+    void testWatersheds3dBlockwise()
+    {
+        for(std::list<std::list<IntVec> >::iterator list_iter=pointslists.begin(); list_iter!=pointslists.end(); ++list_iter){
+            IntVec temp;
+            for(int z=0; z<DEPTH; ++z)
+                for(int y=0; y<HEIGHT; ++y)
+                    for(int x=0; x<WIDTH; ++x){
+                        temp = IntVec(x,y,z);
+                        int tempVal=10000000;
+                        for(std::list<IntVec>::iterator iter=(*list_iter).begin(); iter!=(*list_iter).end(); ++iter){
+                            if((temp-*iter).squaredMagnitude()<tempVal){
+                                tempVal = (temp-*iter).squaredMagnitude();
+                            }
+                        }
+                        volume(x,y,z)=tempVal;
+                    }
+
+            IntVolume labelVolume(IntVolume::difference_type(WIDTH,HEIGHT,DEPTH));
+            IntVolume labelVolumeBlock(IntVolume::difference_type(WIDTH,HEIGHT,DEPTH));
+            IntVolume labelVolume26(IntVolume::difference_type(WIDTH,HEIGHT,DEPTH));
+            IntVolume labelVolumeBlock26(IntVolume::difference_type(WIDTH,HEIGHT,DEPTH));
+
+            int max_region_label = vigra::watersheds3DSix( vigra::srcMultiArrayRange(volume),
+                                                           vigra::destMultiArray(labelVolume));
+            // blockSize(7) does not divide DEPTH, so the last slab is shallower
+            int max_region_label_block = vigra::watersheds3DSix( vigra::srcMultiArrayRange(volume),
+                                                                 vigra::destMultiArray(labelVolumeBlock),
+                                                                 ParallelOptions().numThreads(2).blockSize(7));
+            shouldEqual(max_region_label_block, max_region_label);
+            shouldEqualSequence(labelVolumeBlock.begin(), labelVolumeBlock.end(), labelVolume.begin());
+
+            int max_region_label26 = vigra::watersheds3DTwentySix( vigra::srcMultiArrayRange(volume),
+                                                                   vigra::destMultiArray(labelVolume26));
+            int max_region_label_block26 = vigra::watersheds3DTwentySix( vigra::srcMultiArrayRange(volume),
+                                                                         vigra::destMultiArray(labelVolumeBlock26),
+                                                                         ParallelOptions().numThreads(2));
+            shouldEqual(max_region_label_block26, max_region_label26);
+            shouldEqualSequence(labelVolumeBlock26.begin(), labelVolumeBlock26.end(), labelVolume26.begin());
+
+            // single-threaded options must fall back to the sequential algorithm
+            int max_region_label_serial = vigra::watersheds3DSix( vigra::srcMultiArrayRange(volume),
+                                                                  vigra::destMultiArray(labelVolumeBlock),
+                                                                  ParallelOptions().numThreads(1));
+            shouldEqual(max_region_label_serial, max_region_label);
+            shouldEqualSequence(labelVolumeBlock.begin(), labelVolumeBlock.end(), labelVolume.begin());
+        }
+    }
+
 
 };
 
@@ -472,6 +520,7 @@ struct SimpleAnalysisTestSuite
         add( testCase( &Watersheds3dTest::testWatersheds3dSix2));
         add( testCase( &Watersheds3dTest::testWatersheds3dGradient1));
         add( testCase( &Watersheds3dTest::testWatersheds3dGradient2));
+        add( testCase( &Watersheds3dTest::testWatersheds3dBlockwise));
     }
 };
 
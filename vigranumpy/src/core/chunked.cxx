@@ -0,0 +1,354 @@
+/************************************************************************/
+/*                                                                      */
+/*               Copyright 2012 by Ullrich Koethe                       */
+/*                                                                      */
+/*    This file is part of the VIGRA computer vision library.           */
+/*    The VIGRA Website is                                              */
+/*        http://hci.iwr.uni-heidelberg.de/vigra/                       */
+/*    Please direct questions, bug reports, and contributions to        */
+/*        ullrich.koethe@iwr.uni-heidelberg.de    or                    */
+/*        vigra@informatik.uni-hamburg.de                               */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+#define PY_ARRAY_UNIQUE_SYMBOL vigranumpychunked_PyArray_API
+//#define NO_IMPORT_ARRAY
+
+#include <string>
+#include <vigra/numpy_array.hxx>
+#include <vigra/numpy_array_converters.hxx>
+#include <vigra/chunked_lazy_array.hxx>
+#ifdef HasHDF5
+# include <vigra/chunked_lazy_hdf5.hxx>
+#endif
+
+namespace python = boost::python;
+
+namespace vigra
+{
+
+namespace detail
+{
+
+    // source node referencing a numpy array; holding the NumpyArray keeps
+    // the underlying ndarray alive for the lifetime of the graph
+template <unsigned int N>
+class ChunkedLazyNumpySource
+: public ChunkedLazyNode<N, float>
+{
+  public:
+    typedef ChunkedLazyNode<N, float> base_type;
+    typedef typename base_type::shape_type shape_type;
+
+    ChunkedLazyNumpySource(NumpyArray<N, Singleband<float> > const & array,
+                           shape_type const & chunkShape)
+    : base_type(array.shape(), chunkShape, 0),   // data already in memory => no cache
+      array_(array)
+    {}
+
+  protected:
+    virtual void computeChunk(shape_type const & start, shape_type const & stop,
+                              MultiArrayView<N, float> & chunk)
+    {
+        chunk.copy(array_.subarray(start, stop));
+    }
+
+  private:
+    NumpyArray<N, Singleband<float> > array_;
+};
+
+#ifdef HasHDF5
+
+    // source node that owns its HDF5File, so the Python user only has to
+    // keep the lazy array itself alive
+template <unsigned int N>
+class ChunkedLazyHDF5FileSource
+: public ChunkedLazyNode<N, float>
+{
+  public:
+    typedef ChunkedLazyNode<N, float> base_type;
+    typedef typename base_type::shape_type shape_type;
+
+    ChunkedLazyHDF5FileSource(std::string const & filename,
+                              std::string const & datasetName,
+                              shape_type const & shape, shape_type const & chunkShape,
+                              std::size_t cacheLimit)
+    : base_type(shape, chunkShape, cacheLimit),
+      file_(filename, HDF5File::OpenReadOnly),
+      datasetName_(datasetName)
+    {}
+
+  protected:
+    virtual void computeChunk(shape_type const & start, shape_type const & stop,
+                              MultiArrayView<N, float> & chunk)
+    {
+        file_.readBlock(datasetName_, start, stop - start, chunk);
+    }
+
+  private:
+    HDF5File file_;
+    std::string datasetName_;
+};
+
+#endif // HasHDF5
+
+struct LazyPlus
+{
+    float operator()(float a, float b) const { return a + b; }
+};
+
+struct LazyMinus
+{
+    float operator()(float a, float b) const { return a - b; }
+};
+
+struct LazyTimes
+{
+    float operator()(float a, float b) const { return a * b; }
+};
+
+struct LazyScale
+{
+    float factor;
+    LazyScale(float f) : factor(f) {}
+    float operator()(float v) const { return factor * v; }
+};
+
+struct LazyOffset
+{
+    float offset;
+    LazyOffset(float f) : offset(f) {}
+    float operator()(float v) const { return v + offset; }
+};
+
+} // namespace detail
+
+template <unsigned int N>
+ChunkedLazyArray<N, float>
+pythonChunkedLazyArray(NumpyArray<N, Singleband<float> > array,
+                       typename MultiArrayShape<N>::type chunkShape)
+{
+    return ChunkedLazyArray<N, float>(
+               new detail::ChunkedLazyNumpySource<N>(array, chunkShape));
+}
+
+#ifdef HasHDF5
+
+template <unsigned int N>
+ChunkedLazyArray<N, float>
+pythonChunkedLazyArrayHDF5(std::string const & filename,
+                           std::string const & datasetName,
+                           typename MultiArrayShape<N>::type chunkShape,
+                           std::size_t cacheLimit)
+{
+    typename MultiArrayShape<N>::type shape;
+    {
+        HDF5File file(filename, HDF5File::OpenReadOnly);
+        ArrayVector<hsize_t> dimshape = file.getDatasetShape(datasetName);
+        vigra_precondition(dimshape.size() == N,
+            "lazyArrayHDF5(): dataset dimension mismatch.");
+        for(unsigned int d = 0; d < N; ++d)
+            shape[d] = (MultiArrayIndex)dimshape[d];
+    }
+    return ChunkedLazyArray<N, float>(
+               new detail::ChunkedLazyHDF5FileSource<N>(filename, datasetName,
+                                                        shape, chunkShape, cacheLimit));
+}
+
+#endif // HasHDF5
+
+template <unsigned int N>
+NumpyAnyArray
+pythonLazyReadBlock(ChunkedLazyArray<N, float> const & array,
+                    typename MultiArrayShape<N>::type start,
+                    typename MultiArrayShape<N>::type stop,
+                    NumpyArray<N, Singleband<float> > res)
+{
+    res.reshapeIfEmpty(stop - start,
+            "ChunkedLazyArray::readBlock(): Output array has wrong shape.");
+    {
+        PyAllowThreads _pythread;
+        array.readBlock(start, stop, res);
+    }
+    return res;
+}
+
+template <unsigned int N>
+NumpyAnyArray
+pythonLazyCompute(ChunkedLazyArray<N, float> const & array,
+                  NumpyArray<N, Singleband<float> > res)
+{
+    typename MultiArrayShape<N>::type start;
+    res.reshapeIfEmpty(array.shape(),
+            "ChunkedLazyArray::compute(): Output array has wrong shape.");
+    {
+        PyAllowThreads _pythread;
+        array.readBlock(start, array.shape(), res);
+    }
+    return res;
+}
+
+template <unsigned int N>
+typename MultiArrayShape<N>::type
+pythonLazyShape(ChunkedLazyArray<N, float> const & array)
+{
+    return array.shape();
+}
+
+template <unsigned int N>
+typename MultiArrayShape<N>::type
+pythonLazyChunkShape(ChunkedLazyArray<N, float> const & array)
+{
+    return array.chunkShape();
+}
+
+template <unsigned int N>
+ChunkedLazyArray<N, float>
+pythonLazyAdd(ChunkedLazyArray<N, float> const & a, ChunkedLazyArray<N, float> const & b)
+{
+    return a.combined(b, detail::LazyPlus());
+}
+
+template <unsigned int N>
+ChunkedLazyArray<N, float>
+pythonLazySub(ChunkedLazyArray<N, float> const & a, ChunkedLazyArray<N, float> const & b)
+{
+    return a.combined(b, detail::LazyMinus());
+}
+
+template <unsigned int N>
+ChunkedLazyArray<N, float>
+pythonLazyMul(ChunkedLazyArray<N, float> const & a, ChunkedLazyArray<N, float> const & b)
+{
+    return a.combined(b, detail::LazyTimes());
+}
+
+template <unsigned int N>
+ChunkedLazyArray<N, float>
+pythonLazyScale(ChunkedLazyArray<N, float> const & a, float factor)
+{
+    return a.transformed(detail::LazyScale(factor));
+}
+
+template <unsigned int N>
+ChunkedLazyArray<N, float>
+pythonLazyOffset(ChunkedLazyArray<N, float> const & a, float offset)
+{
+    return a.transformed(detail::LazyOffset(offset));
+}
+
+template <unsigned int N>
+void defineChunkedLazyArray(char const * name)
+{
+    using namespace python;
+
+    typedef ChunkedLazyArray<N, float> Array;
+
+    class_<Array>(name,
+             "A chunked array whose contents are computed lazily, tile by tile,\n"
+             "when readBlock() or compute() is called. Filter operations return\n"
+             "new lazy arrays, so an entire filter graph over an out-of-core\n"
+             "dataset runs in bounded memory. Each node caches recently computed\n"
+             "chunks in an LRU cache (see setCacheLimit()).\n",
+             no_init)
+        .def("shape", registerConverters(&pythonLazyShape<N>),
+             "The shape of the (virtual) array.\n")
+        .def("chunkShape", registerConverters(&pythonLazyChunkShape<N>),
+             "The chunk shape used for lazy computation and caching.\n")
+        .def("readBlock", registerConverters(&pythonLazyReadBlock<N>),
+             (arg("start"), arg("stop"), arg("out") = python::object()),
+             "Compute the region [start, stop) and return it as an array.\n")
+        .def("compute", registerConverters(&pythonLazyCompute<N>),
+             (arg("out") = python::object()),
+             "Compute the entire array (it must fit into memory).\n")
+        .def("gaussianSmoothed", &Array::gaussianSmoothed,
+             (arg("sigma")),
+             "Lazy isotropic Gaussian smoothing at the given scale.\n")
+        .def("setCacheLimit", &Array::setCacheLimit,
+             (arg("bytes")),
+             "Limit this node's chunk cache to the given number of bytes\n"
+             "(0 disables caching).\n")
+        .def("cachedBytes", &Array::cachedBytes,
+             "The number of bytes currently held in this node's chunk cache.\n")
+        .def("clearCache", &Array::clearCache,
+             "Discard this node's cached chunks.\n")
+        .def("__add__", &pythonLazyAdd<N>)
+        .def("__sub__", &pythonLazySub<N>)
+        .def("__mul__", &pythonLazyMul<N>)
+        .def("__add__", &pythonLazyOffset<N>)
+        .def("__radd__", &pythonLazyOffset<N>)
+        .def("__mul__", &pythonLazyScale<N>)
+        .def("__rmul__", &pythonLazyScale<N>)
+        ;
+}
+
+void defineChunkedLazy()
+{
+    using namespace python;
+
+    docstring_options doc_options(true, true, false);
+
+    defineChunkedLazyArray<2>("ChunkedLazyArray2D");
+    defineChunkedLazyArray<3>("ChunkedLazyArray3D");
+
+    def("lazyArray", registerConverters(&pythonChunkedLazyArray<2>),
+        (arg("array"), arg("chunkShape")));
+    def("lazyArray", registerConverters(&pythonChunkedLazyArray<3>),
+        (arg("array"), arg("chunkShape")),
+        "Create a chunked lazy array that reads from the given numpy array::\n"
+        "\n"
+        "   lazyArray(array, chunkShape) -> ChunkedLazyArray\n"
+        "\n"
+        "The array is referenced, not copied. Use the methods of the returned\n"
+        ":class:`ChunkedLazyArray` (and the operators +, -, *) to build a\n"
+        "filter graph that is evaluated chunk-by-chunk on demand.\n");
+
+#ifdef HasHDF5
+    def("lazyArrayHDF5", registerConverters(&pythonChunkedLazyArrayHDF5<2>),
+        (arg("filename"), arg("dataset"), arg("chunkShape"),
+         arg("cacheLimit") = (std::size_t)ChunkedLazyNode<2, float>::defaultCacheLimit));
+    def("lazyArrayHDF5", registerConverters(&pythonChunkedLazyArrayHDF5<3>),
+        (arg("filename"), arg("dataset"), arg("chunkShape"),
+         arg("cacheLimit") = (std::size_t)ChunkedLazyNode<3, float>::defaultCacheLimit),
+        "Create a chunked lazy array backed by an HDF5 dataset::\n"
+        "\n"
+        "   lazyArrayHDF5(filename, dataset, chunkShape, cacheLimit=2**26) -> ChunkedLazyArray\n"
+        "\n"
+        "Chunks are read on demand with HDF5 partial I/O and kept in an LRU\n"
+        "cache of at most 'cacheLimit' bytes, so filter graphs over datasets\n"
+        "of arbitrary size run in bounded memory.\n");
+#endif // HasHDF5
+}
+
+} // namespace vigra
+
+using namespace vigra;
+using namespace boost::python;
+
+BOOST_PYTHON_MODULE_INIT(chunked)
+{
+    import_vigranumpy();
+    defineChunkedLazy();
+}
@@ -50,13 +50,15 @@ namespace vigra
 
 template < class Coordinate>
 NumpyAnyArray
-pyconvexHull(NumpyArray<1, TinyVector<Coordinate, 2>, UnstridedArrayTag > points)
+pyconvexHull(NumpyArray<1, TinyVector<Coordinate, 2> > points)
 {
     ArrayVector<TinyVector<Coordinate, 2> > hull;
     {
         PyAllowThreads _pythread;
-    
-        convexHull(ArrayVectorView<TinyVector<Coordinate, 2> >(points.shape(0), points.data()), hull);
+
+        // pass the (possibly strided) view directly - convexHull() only needs
+        // size(), operator[], and iterators, so no contiguous copy is required
+        convexHull(points, hull);
     }
 
     NumpyArray<1, TinyVector<Coordinate, 2> > result(MultiArrayShape<1>::type(hull.size()));
@@ -52,44 +52,88 @@ namespace vigra {
 
 namespace detail {
 
+// Bind 'res' to a caller-supplied 'out' array (validating dtype, axistags,
+// and shape) instead of allocating a fresh array per call. A new array in
+// the requested order is only created when no 'out' array was given.
+template <class ArrayType>
+void reuseOrAllocate(ArrayType & res, NumpyAnyArray const & out,
+                     typename ArrayType::difference_type const & shape,
+                     std::string const & order, char const * name)
+{
+    if(out.hasData())
+    {
+        vigra_precondition(res.makeReference(out),
+            std::string(name) + "(): 'out' array has incompatible dtype or axistags.");
+        vigra_precondition(res.shape() == shape,
+            std::string(name) + "(): 'out' array has wrong shape.");
+    }
+    else
+    {
+        res = ArrayType(shape, order);
+    }
+}
+
 template <class T>
-NumpyAnyArray readImageImpl(ImageImportInfo const & info, std::string order = "")
+NumpyAnyArray readImageImpl(ImageImportInfo const & info, std::string order,
+                            NumpyAnyArray out)
 {
-    typedef UnstridedArrayTag Stride;
-    
     if(order == "")
         order = detail::defaultOrder();
 
+    MultiArrayShape<2>::type shape(info.width(), info.height());
+
     switch(info.numBands())
     {
       case 1:
       {
-        NumpyArray<2, Singleband<T>, Stride> res(MultiArrayShape<2>::type(info.width(), info.height()), order);
-        importImage(info, destImage(res));
+        NumpyArray<2, Singleband<T> > res;
+        reuseOrAllocate(res, out, shape, order, "readImage");
+        {
+            PyAllowThreads _pythread;
+            importImage(info, destImage(res));
+        }
         return res;
       }
       case 2:
       {
-        NumpyArray<2, TinyVector<T, 2>, Stride> res(MultiArrayShape<2>::type(info.width(), info.height()), order);
-        importImage(info, destImage(res));
+        NumpyArray<2, TinyVector<T, 2> > res;
+        reuseOrAllocate(res, out, shape, order, "readImage");
+        {
+            PyAllowThreads _pythread;
+            importImage(info, destImage(res));
+        }
         return res;
       }
       case 3:
       {
-        NumpyArray<2, RGBValue<T>, Stride> res(MultiArrayShape<2>::type(info.width(), info.height()), order);
-        importImage(info, destImage(res));
+        NumpyArray<2, RGBValue<T> > res;
+        reuseOrAllocate(res, out, shape, order, "readImage");
+        {
+            PyAllowThreads _pythread;
+            importImage(info, destImage(res));
+        }
         return res;
       }
       case 4:
       {
-        NumpyArray<2, TinyVector<T, 4>, Stride> res(MultiArrayShape<2>::type(info.width(), info.height()), order);
-        importImage(info, destImage(res));
+        NumpyArray<2, TinyVector<T, 4> > res;
+        reuseOrAllocate(res, out, shape, order, "readImage");
+        {
+            PyAllowThreads _pythread;
+            importImage(info, destImage(res));
+        }
         return res;
       }
       default:
       {
-        NumpyArray<3, Multiband<T> > res(MultiArrayShape<3>::type(info.width(), info.height(), info.numBands()), order);
-        importImage(info, destImage(res));
+        NumpyArray<3, Multiband<T> > res;
+        reuseOrAllocate(res, out,
+                        MultiArrayShape<3>::type(info.width(), info.height(), info.numBands()),
+                        order, "readImage");
+        {
+            PyAllowThreads _pythread;
+            importImage(info, destImage(res));
+        }
         return res;
       }
     }
@@ -117,7 +161,8 @@ std::string numpyTypeIdToImpexString(NPY_TYPES typeID)
 } // namespace detail
 
 NumpyAnyArray 
-readImage(const char * filename, python::object import_type, unsigned int index, std::string order = "")
+readImage(const char * filename, python::object import_type, unsigned int index,
+          std::string order = "", NumpyAnyArray out = NumpyAnyArray())
 {
     ImageImportInfo info(filename, index);
     std::string importType(info.getPixelType());
@@ -137,19 +182,19 @@ readImage(const char * filename, python::object import_type, unsigned int index,
 
     // FIXME: support all types, at least via a type cast at the end?
     if(importType == "FLOAT")
-        return detail::readImageImpl<float>(info, order);
+        return detail::readImageImpl<float>(info, order, out);
     if(importType == "UINT8")
-        return detail::readImageImpl<UInt8>(info, order);
+        return detail::readImageImpl<UInt8>(info, order, out);
     if(importType == "INT16")
-        return detail::readImageImpl<Int16>(info, order);
+        return detail::readImageImpl<Int16>(info, order, out);
     if(importType == "UINT16")
-        return detail::readImageImpl<UInt16>(info, order);
+        return detail::readImageImpl<UInt16>(info, order, out);
     if(importType == "INT32")
-        return detail::readImageImpl<Int32>(info, order);
+        return detail::readImageImpl<Int32>(info, order, out);
     if(importType == "UINT32")
-        return detail::readImageImpl<UInt32>(info, order);
+        return detail::readImageImpl<UInt32>(info, order, out);
     if(importType == "DOUBLE")
-        return detail::readImageImpl<double>(info, order);
+        return detail::readImageImpl<double>(info, order, out);
     vigra_fail("readImage(filename, import_type, order): import_type specifies an unknown pixel type.");
     return NumpyAnyArray();
 }
@@ -190,7 +235,10 @@ void writeImage(NumpyArray<3, Multiband<T> > const & image,
         info.setCompression("RLE");
     else if(std::string(compression) != "")
         info.setCompression(compression);
-    exportImage(srcImageRange(image), info);
+    {
+        PyAllowThreads _pythread;
+        exportImage(srcImageRange(image), info);
+    }
 }
 
 unsigned int numberImages(const char * filename)
@@ -205,10 +253,9 @@ namespace detail {
 
 template <class T>
 NumpyAnyArray 
-readVolumeImpl(VolumeImportInfo const & info, std::string order = "")
+readVolumeImpl(VolumeImportInfo const & info, std::string order,
+               NumpyAnyArray out)
 {
-    typedef UnstridedArrayTag Stride;
-    
     if(order == "")
         order = detail::defaultOrder();
 
@@ -216,39 +263,62 @@ readVolumeImpl(VolumeImportInfo const & info, std::string order = "")
     {
       case 1:
       {
-        NumpyArray<3, Singleband<T> > volume(info.shape(), order);
-        importVolume(info, volume);
+        NumpyArray<3, Singleband<T> > volume;
+        reuseOrAllocate(volume, out, info.shape(), order, "readVolume");
+        {
+            PyAllowThreads _pythread;
+            importVolume(info, volume);
+        }
         return volume;
       }
       case 2:
       {
-        NumpyArray<3, TinyVector<T, 2> > volume(info.shape(), order);
-        importVolume(info, volume);
+        NumpyArray<3, TinyVector<T, 2> > volume;
+        reuseOrAllocate(volume, out, info.shape(), order, "readVolume");
+        {
+            PyAllowThreads _pythread;
+            importVolume(info, volume);
+        }
         return volume;
       }
       case 3:
       {
-        NumpyArray<3, RGBValue<T> > volume(info.shape(), order);
-        importVolume(info, volume);
+        NumpyArray<3, RGBValue<T> > volume;
+        reuseOrAllocate(volume, out, info.shape(), order, "readVolume");
+        {
+            PyAllowThreads _pythread;
+            importVolume(info, volume);
+        }
         return volume;
       }
       case 4:
       {
-        NumpyArray<3, TinyVector<T, 4> > volume(info.shape(), order);
-        importVolume(info, volume);
+        NumpyArray<3, TinyVector<T, 4> > volume;
+        reuseOrAllocate(volume, out, info.shape(), order, "readVolume");
+        {
+            PyAllowThreads _pythread;
+            importVolume(info, volume);
+        }
         return volume;
       }
       //FIXME not yet supported
       /*default:
       {
         NumpyArray<4, Multiband<T> > volume(MultiArrayShape<4>::type(info.width(), info.height(), info.depth(), info.numBands()));
-        importVolume(info, volume);
+        {
+            PyAllowThreads _pythread;
+            importVolume(info, volume);
+        }
         return volume;
       }*/
       default:
       {
-        NumpyArray<3, RGBValue<T> > volume(info.shape(), order);
-        importVolume(info, volume);
+        NumpyArray<3, RGBValue<T> > volume;
+        reuseOrAllocate(volume, out, info.shape(), order, "readVolume");
+        {
+            PyAllowThreads _pythread;
+            importVolume(info, volume);
+        }
         return volume;
       }
     }
@@ -257,7 +327,8 @@ readVolumeImpl(VolumeImportInfo const & info, std::string order = "")
 } // namespace detail
 
 NumpyAnyArray 
-readVolume(const char * filename, python::object import_type, std::string order = "")
+readVolume(const char * filename, python::object import_type,
+           std::string order = "", NumpyAnyArray out = NumpyAnyArray())
 {
     VolumeImportInfo info(filename);
     std::string importType(info.getPixelType());
@@ -276,19 +347,19 @@ readVolume(const char * filename, python::object import_type, std::string order
         vigra_precondition(false, "readVolume(filename, import_type, order): import_type must be a string or a numpy dtype.");
 
     if(importType == "FLOAT")
-        return detail::readVolumeImpl<float>(info, order);
+        return detail::readVolumeImpl<float>(info, order, out);
     if(importType == "UINT8")
-        return detail::readVolumeImpl<UInt8>(info, order);
+        return detail::readVolumeImpl<UInt8>(info, order, out);
     if(importType == "INT16")
-        return detail::readVolumeImpl<Int16>(info, order);
+        return detail::readVolumeImpl<Int16>(info, order, out);
     if(importType == "UINT16")
-        return detail::readVolumeImpl<UInt16>(info, order);
+        return detail::readVolumeImpl<UInt16>(info, order, out);
     if(importType == "INT32")
-        return detail::readVolumeImpl<Int32>(info, order);
+        return detail::readVolumeImpl<Int32>(info, order, out);
     if(importType == "UINT32")
-        return detail::readVolumeImpl<UInt32>(info, order);
+        return detail::readVolumeImpl<UInt32>(info, order, out);
     if(importType == "DOUBLE")
-        return detail::readVolumeImpl<double>(info, order);
+        return detail::readVolumeImpl<double>(info, order, out);
     vigra_fail("readVolume(filename, import_type, order): import_type specifies an unknown pixel type.");
     return NumpyAnyArray();
 }
@@ -326,7 +397,10 @@ void writeVolume(NumpyArray<3, Multiband<T> > const & volume,
         info.setCompression("RLE");
     else if(std::string(compression) != "")
         info.setCompression(compression);
-    exportVolume(volume, info);
+    {
+        PyAllowThreads _pythread;
+        exportVolume(volume, info);
+    }
 }
 
 VIGRA_PYTHON_MULTITYPE_FUNCTOR(pywriteVolume, writeVolume)
@@ -379,10 +453,12 @@ void defineImpexFunctions()
     ;
     
     // FIXME: add an order parameter to the import functions
-    def("readVolume", &readVolume, (arg("filename"), arg("dtype") = "FLOAT", arg("order") = ""),
+    def("readVolume", &readVolume,
+        (arg("filename"), arg("dtype") = "FLOAT", arg("order") = "",
+         arg("out") = python::object()),
         "Read a 3D volume from a directory::\n"
         "\n"
-        "   readVolume(filename, dtype='FLOAT', order='') -> Volume\n"
+        "   readVolume(filename, dtype='FLOAT', order='', out=None) -> Volume\n"
         "\n"
         "If the volume is stored in a by-slice manner (e.g. one image per\n"
         "slice), the 'filename' can refer to an arbitrary image from the set.\n"
@@ -418,6 +494,9 @@ void defineImpexFunctions()
         "(allowed values: 'C', 'F', 'V'). When order == '' (the default), " 
         "vigra.VigraArray.defaultOrder is used.\n"
         "\n"
+        "When a pre-allocated array of matching dtype and shape is passed as 'out',\n"
+        "the volume data are written into it in place and no new array is allocated.\n"
+        "\n"
         "For details see the help for :func:`readImage`.\n");
         
     multidef("writeVolume", pywriteVolume<Int8, UInt64, Int64, UInt16, Int16, UInt32, Int32, double, float, UInt8>(), 
@@ -429,10 +508,11 @@ void defineImpexFunctions()
        "Parameters 'dtype' and 'compression' will be handled as in :func:`writeImage`.\n\n");
     
     def("readImage", &readImage, 
-        (arg("filename"), arg("dtype") = "FLOAT", arg("index") = 0, arg("order") = ""),
+        (arg("filename"), arg("dtype") = "FLOAT", arg("index") = 0, arg("order") = "",
+         arg("out") = python::object()),
         "Read an image from a file::\n"
         "\n"
-        "   readImage(filename, dtype = 'FLOAT', index = 0, order='') -> Image\n"
+        "   readImage(filename, dtype = 'FLOAT', index = 0, order='', out=None) -> Image\n"
         "\n"
         "When import_type is 'UINT8', 'INT16', 'UINT16', 'INT32', 'UINT32',\n"
         "'FLOAT', 'DOUBLE', or one of the corresponding numpy dtypes (numpy.uint8\n"
@@ -451,6 +531,9 @@ void defineImpexFunctions()
         "(allowed values: 'C', 'F', 'V'). When order == '' (the default), \n" 
         "'vigra.VigraArray.defaultOrder' is used.\n"
         "\n"
+        "When a pre-allocated array of matching dtype and shape is passed as 'out',\n"
+        "the image data are written into it in place and no new array is allocated.\n"
+        "\n"
         "Supported file formats are listed by the function :func:`listFormats`.\n"
         "When filename does not refer to a recognized image file format, an\n"
         "exception is raised. The file can be checked beforehand with the function\n"
@@ -47,9 +47,11 @@ namespace vigra
 
 template <class T >
 NumpyAnyArray
-pythonLeastSquares(NumpyArray<2, T> A, NumpyArray<2, T> b)
+pythonLeastSquares(NumpyArray<2, T> A, NumpyArray<2, T> b,
+                   NumpyArray<2, T> res)
 {
-    NumpyArray<2, T, UnstridedArrayTag> res(Shape2(A.shape(1), 1));
+    res.reshapeIfEmpty(Shape2(A.shape(1), 1),
+            "leastSquares(): Output array has wrong shape.");
     
     {
         PyAllowThreads _pythread;
@@ -61,9 +63,11 @@ pythonLeastSquares(NumpyArray<2, T> A, NumpyArray<2, T> b)
 
 template <class T >
 NumpyAnyArray
-pythonNonnegativeLeastSquares(NumpyArray<2, T> A, NumpyArray<2, T> b)
+pythonNonnegativeLeastSquares(NumpyArray<2, T> A, NumpyArray<2, T> b,
+                   NumpyArray<2, T> res)
 {
-    NumpyArray<2, T, UnstridedArrayTag> res(Shape2(A.shape(1), 1));
+    res.reshapeIfEmpty(Shape2(A.shape(1), 1),
+            "nonnegativeLeastSquares(): Output array has wrong shape.");
     
     {
         PyAllowThreads _pythread;
@@ -75,9 +79,11 @@ pythonNonnegativeLeastSquares(NumpyArray<2, T> A, NumpyArray<2, T> b)
 
 template <class T >
 NumpyAnyArray
-pythonRidgeRegression(NumpyArray<2, T> A, NumpyArray<2, T> b, double lambda)
+pythonRidgeRegression(NumpyArray<2, T> A, NumpyArray<2, T> b, double lambda,
+                      NumpyArray<2, T> res)
 {
-    NumpyArray<2, T, UnstridedArrayTag> res(Shape2(A.shape(1), 1));
+    res.reshapeIfEmpty(Shape2(A.shape(1), 1),
+            "ridgeRegression(): Output array has wrong shape.");
     
     {
         PyAllowThreads _pythread;
@@ -176,19 +182,19 @@ void defineOptimization()
     NumpyArrayConverter<NumpyArray<2, double, UnstridedArrayTag> >();
 
     def("leastSquares", registerConverters(&pythonLeastSquares<double>),
-        (arg("A"), arg("b")),
+        (arg("A"), arg("b"), arg("out")=python::object()),
         "Perform plain linear regression.\n"
         "\n"
         "For details see leastSquares_ in the vigra C++ documentation.\n\n");
 
     def("nonnegativeLeastSquares", registerConverters(&pythonNonnegativeLeastSquares<double>),
-        (arg("A"), arg("b")),
+        (arg("A"), arg("b"), arg("out")=python::object()),
         "Perform linear regression where the solution is constrained to be non-negative.\n"
         "\n"
         "For details see nonnegativeLeastSquares_ in the vigra C++ documentation.\n\n");
 
     def("ridgeRegression", registerConverters(&pythonRidgeRegression<double>),
-        (arg("A"), arg("b"), arg("lambda")),
+        (arg("A"), arg("b"), arg("lambda"), arg("out")=python::object()),
         "Perform linear regression with L2 regularization.\n"
         "\n"
         "'lambda' is the regularization parameter - the larger it is, the more\n"
@@ -269,19 +269,22 @@ pythonLocalMinima3D(NumpyArray<3, Singleband<PixelType> > volume,
     res.reshapeIfEmpty(volume.taggedShape().setChannelDescription(description), 
             "localMinima(): Output array has wrong shape.");
             
-    switch (neighborhood)
     {
-        case 6:
-        {
-            localMinima3D(srcMultiArrayRange(volume), destMultiArray(res), marker,
-                    NeighborCode3DSix());
-            break;
-        }
-        case 26:
+        PyAllowThreads _pythread;
+        switch (neighborhood)
         {
-            localMinima3D(srcMultiArrayRange(volume), destMultiArray(res), marker,
-                    NeighborCode3DTwentySix());
-            break;
+            case 6:
+            {
+                localMinima3D(srcMultiArrayRange(volume), destMultiArray(res), marker,
+                        NeighborCode3DSix());
+                break;
+            }
+            case 26:
+            {
+                localMinima3D(srcMultiArrayRange(volume), destMultiArray(res), marker,
+                        NeighborCode3DTwentySix());
+                break;
+            }
         }
     }
 
@@ -342,19 +345,22 @@ pythonExtendedLocalMinima3D(NumpyArray<3, Singleband<PixelType> > volume,
     
     res.reshapeIfEmpty(volume.taggedShape().setChannelDescription(description), 
             "extendedLocalMinima(): Output array has wrong shape.");
-    switch (neighborhood)
     {
-        case 6:
-        {
-            extendedLocalMinima3D(srcMultiArrayRange(volume), destMultiArray(res),
-                marker, NeighborCode3DSix());
-            break;
-        }
-        case 26:
+        PyAllowThreads _pythread;
+        switch (neighborhood)
         {
-            extendedLocalMinima3D(srcMultiArrayRange(volume), destMultiArray(res),
-                marker, NeighborCode3DTwentySix());
-            break;
+            case 6:
+            {
+                extendedLocalMinima3D(srcMultiArrayRange(volume), destMultiArray(res),
+                    marker, NeighborCode3DSix());
+                break;
+            }
+            case 26:
+            {
+                extendedLocalMinima3D(srcMultiArrayRange(volume), destMultiArray(res),
+                    marker, NeighborCode3DTwentySix());
+                break;
+            }
         }
     }
 
@@ -416,19 +422,22 @@ pythonLocalMaxima3D(NumpyArray<3, Singleband<PixelType> > volume,
     
     res.reshapeIfEmpty(volume.taggedShape().setChannelDescription(description), 
             "localMaxima(): Output array has wrong shape.");
-    switch (neighborhood)
     {
-        case 6:
-        {
-            localMaxima3D(srcMultiArrayRange(volume), destMultiArray(res), marker,
-                NeighborCode3DSix());
-            break;
-        }
-        case 26:
+        PyAllowThreads _pythread;
+        switch (neighborhood)
         {
-            localMaxima3D(srcMultiArrayRange(volume), destMultiArray(res), marker,
-                NeighborCode3DTwentySix());
-            break;
+            case 6:
+            {
+                localMaxima3D(srcMultiArrayRange(volume), destMultiArray(res), marker,
+                    NeighborCode3DSix());
+                break;
+            }
+            case 26:
+            {
+                localMaxima3D(srcMultiArrayRange(volume), destMultiArray(res), marker,
+                    NeighborCode3DTwentySix());
+                break;
+            }
         }
     }
 
@@ -487,19 +496,22 @@ pythonExtendedLocalMaxima3D(NumpyArray<3, Singleband<PixelType> > volume,
     
     res.reshapeIfEmpty(volume.taggedShape().setChannelDescription(description), 
             "extendedLocalMaxima(): Output array has wrong shape.");
-    switch (neighborhood)
     {
-        case 6:
-        {
-            extendedLocalMaxima3D(srcMultiArrayRange(volume), destMultiArray(res),
-                                  marker, NeighborCode3DSix());
-            break;
-        }
-        case 26:
+        PyAllowThreads _pythread;
+        switch (neighborhood)
         {
-            extendedLocalMaxima3D(srcMultiArrayRange(volume), destMultiArray(res),
-                                  marker, NeighborCode3DTwentySix());
-            break;
+            case 6:
+            {
+                extendedLocalMaxima3D(srcMultiArrayRange(volume), destMultiArray(res),
+                                      marker, NeighborCode3DSix());
+                break;
+            }
+            case 26:
+            {
+                extendedLocalMaxima3D(srcMultiArrayRange(volume), destMultiArray(res),
+                                      marker, NeighborCode3DTwentySix());
+                break;
+            }
         }
     }
 